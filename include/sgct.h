@@ -448,6 +448,7 @@ License type: BSD\n
 	namespace Freetype = sgct_text;
 #endif
 #include "sgct/MessageHandler.h"
+#include "sgct/FrameTrace.h"
 #include "sgct/ShaderManager.h"
 #include "sgct/SGCTSettings.h"
 #include "sgct/SGCTVersion.h"
@@ -107,6 +107,9 @@ public:
     void setUseASCIIForExternalControl(bool useASCII);
     bool getUseASCIIForExternalControl();
 
+    void setExternalControlMaxClients(unsigned int count);
+    unsigned int getExternalControlMaxClients();
+
     void setUseIgnoreSync(bool state);
     bool getIgnoreSync();
 
@@ -154,6 +157,7 @@ private:
     std::string mMasterAddress;
     std::string mExternalControlPort;
     bool mUseASCIIForExternalControl;
+    unsigned int mExternalControlMaxClients;
 
     std::vector<SGCTUser*> mUsers;
     sgct::SGCTTrackingManager * mTrackingManager;
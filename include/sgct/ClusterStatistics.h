@@ -0,0 +1,116 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _CLUSTER_STATISTICS_H_
+#define _CLUSTER_STATISTICS_H_
+
+#include <stddef.h>
+#include <vector>
+#include <deque>
+#include <map>
+#include <string>
+#include <mutex>
+
+namespace sgct_core
+{
+
+/*!
+    Collects the frame statistics of all nodes on the master. Each slave sends a compact sample
+    of its last frame with the acknowledge of every sync frame. The master keeps a history per
+    node, calculates percentiles and records which node gated each frame, meaning the node
+    whose acknowledge the master waited for last.
+*/
+class ClusterStatistics
+{
+public:
+    enum Metric { FrameTime = 0, DrawTime, SyncTime, GpuTime, NumberOfMetrics };
+
+    /*!
+        Timings in seconds of one frame on one node. The gpu time is zero if it couldn't be measured.
+    */
+    struct Sample
+    {
+        int nodeId;
+        unsigned int frame;
+        float values[NumberOfMetrics];
+    };
+
+    //! size of a sample in the acknowledge message
+    static const std::size_t EncodedSampleSize = 2 * 4 + NumberOfMetrics * 4;
+
+    /*! Get the ClusterStatistics instance */
+    static ClusterStatistics * instance()
+    {
+        if( mInstance == NULL )
+        {
+            mInstance = new ClusterStatistics();
+        }
+
+        return mInstance;
+    }
+
+    /*! Destroy the ClusterStatistics */
+    static void destroy()
+    {
+        if( mInstance != NULL )
+        {
+            delete mInstance;
+            mInstance = NULL;
+        }
+    }
+
+    void setLocalSample(const Sample & sample);
+    void encodeLocalSample(char * buffer);
+    void decode(const char * receivedData, int receivedLength, int clientIndex);
+    void addSample(const Sample & sample);
+    void endFrame(double waitStartTime);
+
+    std::vector<int> getNodeIds();
+    bool getLatestSample(int nodeId, Sample & sample);
+    float getPercentile(int nodeId, Metric metric, float percentile);
+    unsigned int getGatingCount(int nodeId);
+    int getGatingNode();
+    bool saveCSV(const std::string & filename);
+    bool saveJSON(const std::string & filename);
+
+    static const char * getMetricName(Metric metric);
+
+private:
+    ClusterStatistics();
+
+    // Don't implement these, should give compile warning if used
+    ClusterStatistics( const ClusterStatistics & cs );
+    const ClusterStatistics & operator=(const ClusterStatistics & rhs );
+
+    struct HistoryEntry
+    {
+        Sample sample;
+        bool gating;
+    };
+
+    struct NodeHistory
+    {
+        std::deque<HistoryEntry> entries;
+        double lastArrival;
+        unsigned int gatingCount;
+    };
+
+    void addSampleLocked(const Sample & sample, double arrival);
+    float getPercentileLocked(const NodeHistory & history, Metric metric, float percentile);
+
+    static ClusterStatistics * mInstance;
+
+    std::mutex mMutex;
+    Sample mLocalSample;
+    std::map<int, NodeHistory> mNodes;
+    int mGatingNode;
+    std::size_t mHistoryLength;
+};
+
+}
+
+#endif
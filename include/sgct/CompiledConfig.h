@@ -0,0 +1,126 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _COMPILED_CONFIG_H_
+#define _COMPILED_CONFIG_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#ifndef SGCT_DONT_USE_EXTERNAL
+    #include <external/tinyxml2.h>
+#else
+    #include <tinyxml2.h>
+#endif
+
+namespace sgct_core
+{
+
+/*!
+    Flat binary representation of an XML configuration. It is compiled once from the XML and can
+    be memory mapped by all nodes, element and attribute names are interned in a string table so
+    nothing needs to be parsed when it is read.
+
+    Each top-level Node element is indexed so that a node can extract the shared parts of the
+    configuration and only its own node section instead of the whole cluster.
+
+    The file stores the size and a CRC-32 of the contents of the XML it was compiled from and is
+    rejected if they don't match the XML anymore. Unlike the modification time this also detects
+    edits made within the same second as the compilation.
+*/
+class CompiledConfig
+{
+public:
+    CompiledConfig();
+    ~CompiledConfig();
+
+    bool compile(const tinyxml2::XMLDocument & xmlDoc, uint64_t sourceSize, uint32_t sourceHash);
+    bool save(const std::string & filename);
+    bool open(const std::string & filename, const std::string & sourceFilename);
+    void close();
+
+    bool extractShared(tinyxml2::XMLDocument & xmlDoc);
+    bool extractNode(tinyxml2::XMLDocument & xmlDoc, unsigned int nodeIndex);
+
+    //! \returns true if a compiled configuration is loaded
+    inline bool isOpen() const { return mData != NULL; }
+    //! \returns the number of Node elements in the configuration
+    inline unsigned int getNumberOfNodes() const { return mHeader != NULL ? mHeader->numNodes : 0; }
+
+    static std::string getCacheFilename(const std::string & sourceFilename);
+    static bool getFileStamp(const std::string & filename, uint64_t & size, int64_t & time);
+    static bool readSource(const std::string & filename, std::string & contents, uint32_t & hash);
+    static bool getSourceHash(const std::string & filename, uint64_t & size, uint32_t & hash);
+
+private:
+    // Don't implement these, should give compile warning if used
+    CompiledConfig( const CompiledConfig & cc );
+    const CompiledConfig & operator=(const CompiledConfig & rhs );
+
+    static const uint32_t NoIndex = 0xFFFFFFFF;
+
+    struct Header
+    {
+        char magic[8];
+        uint64_t sourceSize;
+        uint32_t sourceHash;
+        uint32_t reserved;
+        uint32_t numElements;
+        uint32_t numAttributes;
+        uint32_t numNodes;
+        uint32_t stringsSize;
+        uint32_t elementsOffset;
+        uint32_t attributesOffset;
+        uint32_t nodesOffset;
+        uint32_t stringsOffset;
+    };
+
+    struct Element
+    {
+        uint32_t name;
+        uint32_t text;
+        uint32_t firstAttribute;
+        uint32_t numAttributes;
+        uint32_t firstChild;
+        uint32_t nextSibling;
+    };
+
+    struct Attribute
+    {
+        uint32_t name;
+        uint32_t value;
+    };
+
+    struct Builder;
+
+    static uint32_t addElement(const tinyxml2::XMLElement * element, Builder & builder);
+    static uint32_t addString(const char * str, Builder & builder);
+    tinyxml2::XMLElement * createElement(tinyxml2::XMLDocument & xmlDoc, uint32_t index, bool children);
+    tinyxml2::XMLElement * createRoot(tinyxml2::XMLDocument & xmlDoc);
+    bool setData(const char * data, size_t size);
+    bool validate();
+    void unmap();
+
+    inline const char * getString(uint32_t offset) const { return mStrings + offset; }
+
+    const char * mData;
+    size_t mSize;
+    std::vector<char> mBuffer;
+    void * mMapping;
+
+    const Header * mHeader;
+    const Element * mElements;
+    const Attribute * mAttributes;
+    const uint32_t * mNodes;
+    const char * mStrings;
+};
+
+}
+
+#endif
@@ -0,0 +1,143 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _CONFIG_DISTRIBUTOR_H_
+#define _CONFIG_DISTRIBUTOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+
+#ifndef SGCT_DONT_USE_EXTERNAL
+    #include <external/tinyxml2.h>
+#else
+    #include <tinyxml2.h>
+#endif
+
+namespace sgct_core
+{
+
+class ReadConfig;
+
+/*!
+    Distributes the node sections of the configuration and the files they reference (correction meshes,
+    masks, overlays and mpcdi files) from the master to the slaves over the data transfer connections.
+
+    The slaves still read the shared part of the configuration to be able to connect to the master, but
+    their windows, viewports and assets come from the master. Received files are stored in a local cache
+    directory named after their content hash and size, so a file is only transferred again when it changes.
+    The configuration file itself is also copied to the cache directory so that the slaves can be started
+    with a local copy of it.
+
+    The distribution packages use package ids starting at HelloId, they are never passed on to the data
+    transfer callbacks of the application.
+*/
+class ConfigDistributor
+{
+public:
+    enum PackageId { HelloId = 0x53474300, ManifestId, RequestId, FileId, CompleteId, LastId };
+
+    /*! Get the ConfigDistributor instance */
+    static ConfigDistributor * instance()
+    {
+        if( mInstance == NULL )
+        {
+            mInstance = new ConfigDistributor();
+        }
+
+        return mInstance;
+    }
+
+    /*! Destroy the ConfigDistributor */
+    static void destroy()
+    {
+        if( mInstance != NULL )
+        {
+            delete mInstance;
+            mInstance = NULL;
+        }
+    }
+
+    //! \returns true if the package id is used by the config distribution
+    static inline bool isPackageId(int packageId) { return packageId >= HelloId && packageId < LastId; }
+
+    void setCacheDirectory(const std::string & directory);
+    //! \returns true if distribution is enabled by setting a cache directory
+    inline bool isEnabled() const { return !mCacheDirectory.empty(); }
+
+    bool serve(ReadConfig & config);
+    bool receive(int nodeIndex, tinyxml2::XMLDocument & xmlDoc);
+    void decode(const char * receivedData, int receivedLength, int packageId, int clientId);
+
+private:
+    ConfigDistributor();
+
+    // Don't implement these, should give compile warning if used
+    ConfigDistributor( const ConfigDistributor & cd );
+    const ConfigDistributor & operator=(const ConfigDistributor & rhs );
+
+    struct Asset
+    {
+        uint64_t hash;
+        uint64_t size;
+        std::string path;
+    };
+
+    struct NodePackage
+    {
+        std::string xml;
+        std::vector<std::string> paths;
+    };
+
+    //master
+    void sendManifest(int nodeIndex, int clientId);
+    void sendFiles(const char * receivedData, int receivedLength, int clientId);
+    bool getAsset(const std::string & path, Asset & asset);
+    void send(const std::vector<char> & data, int packageId, int clientId);
+
+    //slave
+    void decodeManifest(const char * receivedData, int receivedLength);
+    void decodeFile(const char * receivedData, int receivedLength);
+    bool waitFor(std::unique_lock<std::mutex> & lock, const bool & condition);
+    std::string getCachePath(const Asset & asset);
+
+    static void collectAssets(tinyxml2::XMLElement * element, const std::string & configDirectory, std::vector<std::string> & paths);
+    static void replaceAssets(tinyxml2::XMLElement * element, const std::string & configDirectory, const std::map<std::string, std::string> & localPaths);
+    static std::string resolvePath(const char * attributeName, const char * value, const std::string & configDirectory);
+    static uint64_t getHash(const char * data, size_t size);
+    static bool readFile(const std::string & path, std::vector<char> & data);
+    static bool writeFile(const std::string & path, const char * data, size_t size);
+
+    static ConfigDistributor * mInstance;
+
+    std::mutex mMutex;
+    std::string mCacheDirectory;
+
+    //master
+    std::vector<NodePackage> mPackages;
+    std::map<std::string, Asset> mAssets;
+    std::map<int, int> mClientNodes;
+    std::map<int, std::vector<std::string> > mClientFiles;
+
+    //slave
+    std::condition_variable mCond;
+    std::string mManifestXml;
+    std::vector<Asset> mManifestAssets;
+    std::vector<std::string> mLocalPaths;
+    unsigned int mPendingFiles;
+    bool mHasManifest;
+    bool mHasFiles;
+    bool mFailed;
+};
+
+}
+
+#endif
@@ -9,6 +9,8 @@
 #define _CORRECTION_MESH_H_
 
 #include "ogl_headers.h"
+#include <string>
+#include <vector>
 
 namespace sgct_core
 {
@@ -32,6 +34,10 @@ namespace sgct_core
         unsigned int mNumberOfVertices;
         unsigned int mNumberOfIndices;
         unsigned int mMeshData[3];
+
+        //CPU side data waiting to be uploaded to the GPU
+        std::vector<CorrectionMeshVertex> mStagedVertices;
+        std::vector<unsigned int> mStagedIndices;
     };
     
     class Viewport;
@@ -48,7 +54,9 @@ namespace sgct_core
         
         CorrectionMesh();
         ~CorrectionMesh();
-        bool readAndGenerateMesh(std::string meshPath, Viewport * parent, MeshHint hint = NO_HINT);
+        bool readAndGenerateMesh(std::string meshPath, Viewport * parent, float windowAspectRatio, MeshHint hint = NO_HINT);
+        bool readMesh(std::string meshPath, Viewport * parent, float windowAspectRatio, MeshHint hint = NO_HINT);
+        void uploadMesh(Viewport * parent);
         void render(const MeshType & mt);
         static MeshHint parseHint(const std::string & hintStr);
         
@@ -60,7 +68,7 @@ namespace sgct_core
         bool readAndGenerateScissMesh(const std::string & meshPath, Viewport * parent);
         bool readAndGenerateSimCADMesh(const std::string & meshPath, Viewport * parent);
         bool readAndGenerateSkySkanMesh(const std::string & meshPath, Viewport * parent);
-        bool readAndGeneratePaulBourkeMesh(const std::string & meshPath, Viewport * parent);
+        bool readAndGeneratePaulBourkeMesh(const std::string & meshPath, Viewport * parent, float windowAspectRatio);
         bool readAndGenerateOBJMesh(const std::string & meshPath, Viewport * parent);
         bool readAndGenerateMpcdiMesh(const std::string & meshPath, Viewport* parent);
         bool readMeshBuffer(float* dest, unsigned int& idx, char* src,
@@ -68,6 +76,7 @@ namespace sgct_core
         void setupSimpleMesh(CorrectionMeshGeometry * geomPtr, Viewport * parent);
         void setupMaskMesh(Viewport * parent, bool flip_x, bool flip_y);
         void createMesh(CorrectionMeshGeometry * geomPtr);
+        void uploadGeometry(CorrectionMeshGeometry * geomPtr);
         void exportMesh(const std::string & exportMeshPath);
         void cleanUp();
         inline void clamp(float & val, const float max, const float min);
@@ -76,6 +85,7 @@ namespace sgct_core
         
         CorrectionMeshVertex * mTempVertices;
         unsigned int * mTempIndices;
+        bool mUpdateNonLinearGeometry;
         
         CorrectionMeshGeometry mGeometries[3];
     };
@@ -0,0 +1,87 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _CUBEMAP_CONVERTER_H_
+#define _CUBEMAP_CONVERTER_H_
+
+#include <glm/glm.hpp>
+#include <stddef.h>
+
+namespace sgct_core
+{
+
+class Image;
+
+/*!
+Converts cubemap images to fisheye or equirectangular images on the CPU. The direction of every output texel is
+computed with the same math as the getCubeSample functions of the fisheye shaders used by FisheyeProjection and
+SpoutOutputProjection, including the field of view, crop factors and offset of the fisheye and the rig orientation
+of the Spout output, and the cubemap is sampled as textureCube does it. This makes it usable both for offline
+conversion on machines without GPUs and as a reference to compare the output of the shaders against.
+
+The faces are given in the order of the OpenGL cubemap targets with the rows in the order they are uploaded, which is
+how sgct_core::Image loads them. Bilinear filtering clamps to the edge of each face, so texels within half a texel of
+a face edge can differ from seamless cubemap filtering. The bicubic filter is a Catmull-Rom spline over the texels of
+the face. RGBA faces are filtered with the four channels in SIMD lanes. The output is split into tiles that are converted
+in parallel. Doesn't make any OpenGL calls.
+*/
+class CubemapConverter
+{
+public:
+    enum Mapping { Fisheye = 0, Equirectangular };
+    enum Interpolation { Bilinear = 0, Bicubic };
+    //! The rotation from the sampled direction to the cubemap, the rig layouts are the ones the fisheye shaders use
+    enum FaceLayout { CubeLayout = 0, FourFaceRigLayout, FiveOrSixFaceRigLayout };
+    enum CubeFace { PositiveX = 0, NegativeX, PositiveY, NegativeY, PositiveZ, NegativeZ, NumberOfFaces };
+    enum CropSide { CropLeft = 0, CropRight, CropBottom, CropTop };
+
+    static const std::size_t TileSize = 64;
+
+    CubemapConverter();
+
+    void setMapping(Mapping mapping);
+    void setInterpolation(Interpolation interpolation);
+    void setFaceLayout(FaceLayout layout);
+    void setFOV(float angle);
+    void setTilt(float angle);
+    void setCropFactors(float left, float right, float bottom, float top);
+    void setOffset(const glm::vec3 & offset);
+    void setRigOrientation(const glm::vec3 & orientation);
+    void setBackgroundColor(const glm::vec4 & color);
+    void setNumberOfThreads(unsigned int numberOfThreads);
+
+    bool convert(Image ** faces, Image * output) const;
+    bool getSampleDirection(float s, float t, glm::vec3 & direction) const;
+    static CubeFace getCubeFace(const glm::vec3 & direction, float & s, float & t);
+
+    //! \returns the mapping of the output image
+    inline Mapping getMapping() const { return mMapping; }
+    //! \returns the rotation from the sampled direction to the cubemap
+    inline const glm::mat3 & getRotation() const { return mRotation; }
+
+private:
+    void updateRotation();
+    template <class T> void convertTile(Image ** faces, Image * output, std::size_t tile) const;
+    template <class T> void sampleBilinear(Image * face, float s, float t, float * result) const;
+    template <class T> void sampleBicubic(Image * face, float s, float t, float * result) const;
+
+    Mapping mMapping;
+    Interpolation mInterpolation;
+    FaceLayout mFaceLayout;
+    float mFOV;
+    float mTilt;
+    float mCropFactors[4];
+    glm::vec3 mOffset;
+    glm::vec3 mRigOrientation;
+    glm::vec4 mBackgroundColor;
+    glm::mat3 mRotation;
+    unsigned int mNumberOfThreads;
+};
+
+}
+
+#endif
@@ -13,7 +13,13 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include "SGCTMutexManager.h"
 #include "Statistics.h"
 #include "ReadConfig.h"
+#include "SGCTProjectionSolver.h"
+#include "FrustumCuller.h"
 #include "ShaderProgram.h"
+#include "PostFXGraph.h"
+#include "RenderGraph.h"
+#include "ResolutionScaler.h"
+#include "SharedDataTypes.h"
 #include "FisheyeProjection.h"
 #include "SphericalMirrorProjection.h"
 #include "SpoutOutputProjection.h"
@@ -37,6 +43,7 @@ The figure below illustrates when different callbacks (gray and blue boxes) are
 */
 class Engine
 {
+	friend class sgct_core::NonLinearProjection; //needs to access draw callbacks
 	friend class sgct_core::FisheyeProjection; //needs to access draw callbacks
 	friend class sgct_core::SphericalMirrorProjection; //needs to access draw callbacks
 	friend class sgct_core::SpoutOutputProjection; //needs to access draw callbacks
@@ -91,10 +98,11 @@ private:
     enum SyncStage { PreStage = 0, PostStage };
     enum BufferMode { BackBuffer = 0, BackBufferBlack, RenderToTexture };
     enum ViewportSpace { ScreenSpace = 0, FBOSpace };
-    enum ShaderIndexes { FBOQuadShader = 0, FXAAShader, OverlayShader };
+    enum ShaderIndexes { FBOQuadShader = 0, FXAAShader, OverlayShader, CompositorShader };
     enum ShaderLocIndexes { MonoTex = 0,
             OverlayTex,
-            SizeX, SizeY, FXAA_SUBPIX_TRIM, FXAA_SUBPIX_OFFSET, FXAA_Texture };
+            SizeX, SizeY, FXAA_SUBPIX_TRIM, FXAA_SUBPIX_OFFSET, FXAA_Texture,
+            CompositorViewportRect, CompositorUseMask, CompositorUseOverlay, CompositorUseColorCorrection, CompositorColorCorrection };
 
 public:
     Engine( int& argc, char**& argv );
@@ -140,6 +148,7 @@ public:
     void setExitKey(int key);
     void setExitWaitTime(double time);
     void updateFrustums();
+    bool reloadConfiguration();
     void addPostFX( PostFX & fx );
     unsigned int getCurrentDrawTexture();
     unsigned int getCurrentDepthTexture();
@@ -386,10 +395,14 @@ public:
     void getCurrentDrawBufferSize(int & x, int & y);
     void getDrawBufferSize(const std::size_t & index, int &x, int & y);
     std::size_t getNumberOfDrawBuffers();
+    float getResolutionScale();
     const std::size_t & getCurrentDrawBufferIndex();
     const RenderTarget & getCurrentRenderTarget();
+    bool isRenderingLayeredCubemap();
     sgct_core::OffScreenBuffer * getCurrentFBO();
     const int * getCurrentViewportPixelCoords();
+    void getCurrentFrustumCuller(FrustumCuller & culler, bool useModelMatrix = true);
+    void getCurrentCubemapFrustumCuller(FrustumCuller & culler, bool useModelMatrix = true);
 
     const bool & getWireframe() const;
 
@@ -406,10 +419,12 @@ private:
     bool initNetwork();
     bool initWindows();
     void initOGL();
+    void loadViewportData();
     void clean();
     void clearAllCallbacks();
 
     bool frameLock(SyncStage stage);
+    unsigned int getSyncFrameNumber();
     void calculateFPS(double timestamp);
     void parseArguments( std::vector<std::string>& arg );
     void renderDisplayInfo();
@@ -417,10 +432,18 @@ private:
     void enterCurrentViewport();
     void updateAAInfo(std::size_t winIndex);
     void updateDrawBufferResolutions();
+    void updateRenderGraph();
+    void updateResolutionScale();
+    void buildRenderGraph();
+    void aliasTransientTextures();
+    void renderPass(const sgct_core::RenderGraph::Pass & pass);
+    void updateTrackedFrustums();
+    void solveFrustums(sgct_core::SGCTProjectionSolver & solver, bool tracked);
 
     void draw();
     void drawOverlays();
     void renderFBOTexture();
+    void compositeViewports(TextureIndexes ti, sgct_core::CorrectionMesh::MeshType mt);
     void renderPostFX(TextureIndexes ti );
     void renderViewports(TextureIndexes ti);
     void render2D();
@@ -429,6 +452,7 @@ private:
     void drawOverlaysFixedPipeline();
     void renderFBOTextureFixedPipeline();
     void renderPostFXFixedPipeline(TextureIndexes finalTargetIndex );
+    unsigned int getPostFXBufferTexture(sgct_core::PostFXGraph::Buffer buffer, TextureIndexes finalTargetIndex);
 
     void prepareBuffer(TextureIndexes ti);
     void updateRenderingTargets(TextureIndexes ti);
@@ -509,9 +533,14 @@ private:
     float mClearColor[4];
 
     sgct_core::Frustum::FrustumMode mCurrentFrustumMode;
+    sgct_core::SGCTProjectionSolver mTrackedProjectionSolver;
     int mCurrentViewportCoords[4];
     std::vector<glm::ivec2> mDrawBufferResolutions;
     std::size_t mCurrentDrawBufferIndex;
+    sgct_core::RenderGraph mRenderGraph;
+    std::vector<int> mRenderGraphState; //window state the render graph was built for
+    sgct_core::ResolutionScaler mResolutionScaler; //only used on the master
+    SharedFloat mResolutionScale;
     std::size_t mCurrentViewportIndex[2];
     RenderTarget mCurrentRenderTarget;
     sgct_core::OffScreenBuffer * mCurrentOffScreenBuffer;
@@ -546,6 +575,12 @@ private:
 
     std::string configFilename;
     std::string mLogfilePath;
+    std::string mTracePath;
+    std::string mClusterStatsFilename;
+    bool mWatchConfig;
+    double mConfigCheckTime;
+    SharedUInt32 mConfigHash; //hash of the config file, set by the master when it changes
+    uint32_t mLoadedConfigHash;
     int mRunning;
     bool mInitialized;
     std::string mAAInfo;
@@ -0,0 +1,133 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _EXTERNAL_CONTROL_SERVER_H_
+#define _EXTERNAL_CONTROL_SERVER_H_
+
+#include "SGCTNetwork.h"
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace sgct_core
+{
+
+/*!
+External control endpoint on the master that several clients can connect to at the same time. A single thread
+waits for all clients with select on non-blocking sockets.
+
+Every message is either an ASCII line terminated by <CR><NL> (or <NL>), which is answered with OK as on the
+single client connection, or a binary frame that starts with FrameStart followed by the payload length as a
+32 bit big endian integer and the payload. Binary frames are not answered and their payload may contain any
+bytes. Both kinds can be mixed on a connection. A line that is logout, close, exit or quit, or a line that
+contains cancel (24) or escape (27), closes the connection.
+
+Browsers connect with WebSockets (RFC 6455) on the same port, a client whose first line is an HTTP GET request with
+a WebSocket upgrade gets the handshake reply instead of the greeting. Text and binary messages are passed to the
+decode callback, fragmented messages are reassembled and pings are answered. Messages to a WebSocket client are sent
+as text or binary frames depending on what the client last sent.
+
+Messages are passed to the decode callback on the server thread, unfragmented frames directly from the receive
+buffer. Replies and messages sent to the clients are queued per client, messages are framed for clients that have
+sent a binary frame. A client that doesn't read what is sent to it isn't read from until its queue has drained and
+is disconnected if the queue keeps growing.
+*/
+class ExternalControlServer
+{
+public:
+    static const char FrameStart = 0x02;
+    static const std::size_t FrameHeaderSize = 5;
+
+    ExternalControlServer();
+    ~ExternalControlServer();
+
+    bool init(const std::string & port);
+    void close();
+
+#ifdef __LOAD_CPP11_FUN__
+    void setDecodeFunction(sgct_cppxeleven::function<void (const char *, int, int)> callback);
+    void setUpdateFunction(sgct_cppxeleven::function<void (bool)> callback);
+#endif
+    void setMaxClients(unsigned int count);
+    void setMaxMessageSize(uint32_t size);
+    void setMaxQueuedSize(uint32_t size);
+
+    void sendData(const void * data, int length);
+    bool sendData(int clientId, const void * data, int length);
+
+    unsigned int getNumberOfClients();
+    bool isConnected();
+    //! \returns the port the server listens on
+    inline const std::string & getPort() const { return mPort; }
+
+private:
+    struct Client
+    {
+        SGCT_SOCKET socket;
+        int id;
+        bool identified; //the client has sent data or waited for the greeting so its protocol is known
+        std::chrono::steady_clock::time_point greetingTime;
+        bool binary; //the client has sent a binary frame so messages to it are framed
+        bool webSocket;
+        bool webSocketText; //the last message of the WebSocket client was text
+        unsigned char fragmentOpcode; //opcode of the fragmented WebSocket message being received, 0 if none
+        std::vector<char> fragments;
+        bool paused; //not read from until the output has drained
+        bool closing;
+        std::vector<char> input;
+        std::size_t scanOffset; //input before this offset is known to contain no line break
+        std::vector<char> output;
+        std::size_t outputOffset;
+    };
+
+    void run();
+    void acceptClients();
+    bool readClient(Client * client);
+    void parseInput(Client * client);
+    std::size_t parseStream(Client * client, std::size_t pos);
+    bool parseHandshake(Client * client, std::size_t & pos);
+    std::size_t parseWebSocket(Client * client, std::size_t pos);
+    void closeWebSocket(Client * client, unsigned short code);
+    void identify(Client * client);
+    void dispatch(Client * client, const char * data, std::size_t length, bool nullTerminate);
+    void queue(Client * client, const char * data, std::size_t length);
+    void queueMessage(Client * client, const char * data, std::size_t length);
+    void queueWebSocketFrame(Client * client, unsigned char opcode, const char * data, std::size_t length);
+    void flush(Client * client);
+    void removeClosedClients();
+    static bool isCloseCommand(const char * line, std::size_t length);
+    static bool setNonBlocking(SGCT_SOCKET s);
+    static void closeSocket(SGCT_SOCKET s);
+
+    // Don't implement these, should give compile warning if used
+    ExternalControlServer(const ExternalControlServer & rhs);
+    const ExternalControlServer & operator=(const ExternalControlServer & rhs);
+
+#ifdef __LOAD_CPP11_FUN__
+    sgct_cppxeleven::function< void(const char *, int, int) > mDecoderCallbackFn;
+    sgct_cppxeleven::function< void(bool) > mUpdateCallbackFn;
+#endif
+
+    std::string mPort;
+    SGCT_SOCKET mListenSocket;
+    std::vector<Client *> mClients; //added and removed by the server thread, guarded by mMutex
+    std::mutex mMutex;
+    std::thread * mThread;
+    std::atomic<bool> mTerminate;
+    std::atomic<unsigned int> mNumberOfClients;
+    unsigned int mMaxClients;
+    std::atomic<uint32_t> mMaxMessageSize;
+    std::atomic<uint32_t> mMaxQueuedSize;
+    int mNextId;
+};
+
+}
+
+#endif
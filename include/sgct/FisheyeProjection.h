@@ -10,6 +10,7 @@ For conditions of distribution and use, see copyright notice in sgct.h
 
 #include "NonLinearProjection.h"
 #include <glm/glm.hpp>
+#include <vector>
 
 namespace sgct_core
 {
@@ -38,9 +39,13 @@ namespace sgct_core
         void setOffset(float x, float y, float z = 0.0f);
         void setBaseOffset(const glm::vec3 & offset);
         void setIgnoreAspectRatio(bool state);
+        void setUseAdaptiveFaces(bool state);
 
         glm::vec3 getOffset() const;
 
+        static void calculateFaceCoverage(FisheyeMethod method, float fov, const float * cropFactors,
+            const glm::vec3 * offsets, std::size_t numberOfOffsets, int samples, glm::vec4 * faceRects);
+
     private:
         void initViewports();
         void initShaders();
@@ -53,6 +58,10 @@ namespace sgct_core
         void renderInternalFixedPipeline();
         void renderCubemapInternal(std::size_t * subViewPortIndex);
         void renderCubemapInternalFixedPipeline(std::size_t * subViewPortIndex);
+        void storeFaceLayout();
+        void updateOffset();
+        void addCoverageOffset(const glm::vec3 & offset);
+        void applyFaceCoverage();
 
         void(FisheyeProjection::*mInternalRenderFn)(void);
         void(FisheyeProjection::*mInternalRenderCubemapFn)(std::size_t *);
@@ -71,6 +80,22 @@ namespace sgct_core
 
         FisheyeMethod mMethod;
 
+        //the cube face layout set up by initViewports, used as the starting point of the adaptive faces
+        struct FaceLayout
+        {
+            bool enabled;
+            glm::vec2 pos;
+            glm::vec2 size;
+            glm::vec3 corners[3];
+        };
+        FaceLayout mFaceLayouts[6];
+        bool mAdaptiveFaces;
+        bool mCoverageValid; //the coverage has been calculated for the current cube face layout
+        glm::vec4 mCoverageRects[6]; //union of the face coverage of all offsets seen so far
+        std::vector<glm::vec3> mCoverageOffsets; //the most recent offsets included in the coverage
+        std::size_t mFixedCoverageOffsets; //the base and stereo eye offsets at the start of the list are never replaced
+        std::size_t mNextCoverageOffset;
+
         //shader locations
         int mCubemapLoc, mDepthCubemapLoc, mNormalCubemapLoc, mPositionCubemapLoc, mHalfFovLoc, mOffsetLoc, mSwapColorLoc, mSwapDepthLoc, mSwapNearLoc, mSwapFarLoc;
 
@@ -17,24 +17,49 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #endif
 
 #include <vector>
+#include <deque>
+#include <map>
 #include <string>
+#include <atomic>
+#include <mutex>
+#include <thread>
 #include <glm/gtc/type_ptr.hpp>
 #include "helpers/SGCTCPPEleven.h"
+#include "TextLayout.h"
+#include "GlyphAtlas.h"
 
 namespace sgct_text
 {
-class FontFaceData
+/*!
+Glyph metrics together with the freetype glyph. The texture is the atlas page of the glyph.
+*/
+class FontFaceData : public GlyphMetrics
 {
 public:
     FontFaceData();
     unsigned int mTexId;
-    float mDistToNextChar;
-	glm::vec2 mPos;
-	glm::vec2 mSize;
 	FT_Glyph mGlyph;
 	bool mInterpolated;
 };
 
+/*!
+A rasterized glyph with two channels per pixel. Glyphs from the warmup thread and the glyph cache file are
+passed to the font in this form and packed into the atlas without freetype.
+*/
+class RasterGlyph
+{
+public:
+	RasterGlyph();
+
+	wchar_t mChar;
+	bool mHasBitmap;
+	int mWidth;
+	int mHeight;
+	glm::vec2 mPos;
+	float mDistToNextChar;
+	std::vector<unsigned char> mPixels;
+};
+
 class GlyphData
 {
 public:
@@ -50,6 +75,14 @@ public:
 /*!
 Will ahandle font textures and rendering. Implementation is based on
 <a href="http://nehe.gamedev.net/tutorial/freetype_fonts_in_opengl/24001/">Nehe's font tutorial for freetype</a>.
+
+The glyphs are packed into a glyph atlas and a text is drawn with one draw call per atlas page. The laid out
+vertices of the most recently printed texts are cached, texts that are printed more than once also keep their
+vertex buffer so that static texts are not uploaded every frame.
+
+Glyphs are rasterized the first time they are used. To avoid hitches when a new string is printed a range of
+glyphs can be rasterized in advance on a worker thread using prewarm. If the font has a glyph cache file the
+rasterized glyphs are loaded from it when the font is created and new glyphs are written back when it's cleaned.
 */
 class Font
 {
@@ -57,22 +90,34 @@ public:
     Font( const std::string & fontName = std::string(), float height = 0.0f );
     ~Font();
 
-	void init(FT_Library lib, FT_Face face, const std::string & fontName, unsigned int h );
+	void init(FT_Library lib, FT_Face face, const std::string & fontName, unsigned int h, const std::string & path = std::string() );
 	std::size_t getNumberOfLoadedChars();
 	void clean();
 
+	void prewarm(wchar_t first, wchar_t last);
+	void prewarm(const std::wstring & characters);
+	bool isPrewarming();
+
+	bool loadGlyphCache(const std::string & filename);
+	bool saveGlyphCache();
+
 	/*! Get the font face data */
 	FontFaceData * getFontFaceData(wchar_t c);
 
-    /*! Get the vertex array id */
+	void drawText(const std::vector<std::wstring> & lines, TextAlignMode mode, bool interpolate);
+
+    /*! Get the vertex array id used for texts that are not cached */
     inline unsigned int getVAO() const { return mVAO; }
 
-    /*! Get the vertex buffer objects id */
+    /*! Get the vertex buffer objects id used for texts that are not cached */
     inline unsigned int getVBO() const { return mVBO; }
 
-	/*! Get the display list id */
+	/*! Get the display list id, not used since text is drawn from vertex arrays */
 	inline unsigned int getDisplayList() const { return mListId; }
 
+	/*! Get the glyph atlas */
+	inline const GlyphAtlas & getAtlas() const { return mAtlas; }
+
     /*! Get height of the font */
     inline float getHeight() const { return mHeight; }
 
@@ -90,11 +135,31 @@ public:
     { return mName.compare( rhs.mName ) == 0 && mHeight == rhs.mHeight; }
 
 private:
-	void createCharacter(wchar_t c);
-	bool createGlyph(wchar_t c, FontFaceData * FFDPtr);
-	unsigned int generateTexture(int width, int height, unsigned char * data);
+	struct CachedText
+	{
+		TextMesh mesh;
+		unsigned int vao;
+		unsigned int vbo;
+		unsigned int uses;
+		unsigned int lastUse;
+	};
 
-	bool getPixelData(FT_Face face, int & width, int & height, unsigned char ** pixels, GlyphData * gd);
+	static const std::size_t MaxCachedTexts = 128;
+
+	void createCharacter(wchar_t c);
+	bool rasterizeGlyph(FT_Library lib, FT_Face face, FT_Fixed strokeSize, wchar_t c, RasterGlyph & rg, FT_Glyph * glyph) const;
+	void addGlyph(const RasterGlyph & rg, FT_Glyph glyph);
+	void mergePrewarmedGlyphs();
+	void prewarmLoop(std::wstring characters, FT_Fixed strokeSize);
+	void stopPrewarm();
+	unsigned int generateTexture(int size);
+	void updateTextures();
+	void setupVertexArray(unsigned int vao, unsigned int vbo);
+	CachedText & getCachedText(const std::vector<std::wstring> & lines, TextAlignMode mode);
+	void deleteCachedText(CachedText & ct);
+	const GlyphMetrics * lookupGlyph(wchar_t c);
+
+	static bool getPixelData(FT_Library lib, FT_Fixed strokeSize, FT_Face face, int & width, int & height, unsigned char ** pixels, GlyphData * gd);
 	
     std::string mName;                // Holds the font name
     float mHeight;                    // Holds the height of the font.
@@ -104,7 +169,26 @@ private:
 	FT_Face	mFace;
 	FT_Library mFTLibrary;
 	FT_Fixed mStrokeSize;
-	sgct_cppxeleven::unordered_map<wchar_t, FontFaceData> mFontFaceDataMap;
+	std::deque<FontFaceData> mGlyphs;
+	sgct_cppxeleven::unordered_map<wchar_t, std::size_t> mGlyphIndices;
+	GlyphAtlas mAtlas;
+	std::vector<unsigned int> mPageTextures;
+	std::vector<bool> mPageInterpolated;
+	GlyphLookup mLookup;
+
+	std::map<std::wstring, CachedText> mTextCache;
+	unsigned int mUseCounter;
+
+	std::string mPath;
+	std::string mCacheFilename;
+	bool mCacheChanged;
+
+	std::thread * mPrewarmThread;
+	std::mutex mPrewarmMutex;
+	std::atomic<bool> mAbortPrewarm;
+	std::atomic<bool> mPrewarmRunning;
+	std::atomic<bool> mHasPrewarmedGlyphs;
+	std::vector<RasterGlyph> mPrewarmedGlyphs; //rasterized by the warmup thread, guarded by mPrewarmMutex
 };
 
 } // sgct
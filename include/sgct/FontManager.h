@@ -51,6 +51,14 @@ Non ASCII characters are supported as well:
 \code{.cpp}
 sgct_text::print(sgct_text::FontManager::instance()->getDefaultFont( 14 ), sgct_text::TOP_LEFT, 50, 50, L"Hall Vrlden!");
 \endcode
+\n
+Glyphs are rasterized the first time they are printed. Ranges that will be needed later can be rasterized in advance
+on a worker thread and the rasterized glyphs can be kept in a cache directory between runs (set before any font is created):
+\code{.cpp}
+sgct_text::FontManager::instance()->setGlyphCacheDirectory( "glyph_cache" );
+sgct_text::FontManager::instance()->addFont( "Special", "Special.ttf", sgct_text::FontManager::FontPath_Local );
+sgct_text::FontManager::instance()->prewarmFont( "Special", 14, 0x4E00, 0x9FFF ); //CJK unified ideographs
+\endcode
 */
 class FontManager
 {
@@ -63,14 +71,17 @@ public:
     bool addFont( const std::string & fontName, std::string path, FontPath fontPath = FontPath_Default );
     Font * getFont( const std::string & name, unsigned int height = mDefaultHeight );
     Font * getDefaultFont( unsigned int height = mDefaultHeight );
+    Font * prewarmFont( const std::string & fontName, unsigned int height, wchar_t first, wchar_t last );
 	
 	void setDefaultFontPath( const std::string & path );
     void setStrokeColor( glm::vec4 color );
     void setDrawInScreenSpace( bool state );
+    void setGlyphCacheDirectory( const std::string & path );
 
 	std::size_t getTotalNumberOfLoadedChars();
     inline glm::vec4 getStrokeColor() { return mStrokeColor; }
     inline bool getDrawInScreenSpace() { return mDrawInScreenSpace; }
+    inline const std::string & getGlyphCacheDirectory() { return mGlyphCacheDirectory; }
 
     sgct::ShaderProgram getShader() { return mShader; }
     inline unsigned int getMVPLoc() { return mMVPLoc; }
@@ -103,6 +114,7 @@ private:
 
 	/// Helper functions
 	Font * createFont( const std::string & fontName, unsigned int height );
+	std::string getGlyphCacheFilename( const std::string & path, unsigned int height );
 
     // Don't implement these, should give compile warning if used
     FontManager( const FontManager & fm );
@@ -114,6 +126,8 @@ private:
     static const FT_Short mDefaultHeight;    // Default height of font faces in pixels
 
     std::string mDefaultFontPath;            // The default font path from where to look for font files
+    std::string mGlyphCacheDirectory;        // Directory for rasterized glyphs, empty if glyphs are not cached
+    std::map<std::string, std::string> mFontHashes; // Hashes of the font files used to name the glyph caches
 
     FT_Library  mFTLibrary;                    // Freetype library
 	FT_Face mFace;
@@ -0,0 +1,125 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _FRAME_TRACE_H
+#define _FRAME_TRACE_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+namespace sgct
+{
+
+/*!
+    Records timed events of the render loop and streams them to a file in the Chrome trace
+    event format, which can be opened in chrome://tracing or the Perfetto UI.
+
+    Each thread records into its own lock-free ring and a background thread writes the
+    events to disk. Every event carries the sync frame number so that the files of all
+    nodes in a cluster can be put on a shared timeline using mergeFiles.
+
+    Event and argument names must be string literals or otherwise outlive the trace.
+*/
+class FrameTrace
+{
+public:
+    /*!
+        Records an event from construction to destruction if tracing is enabled.
+    */
+    class Scope
+    {
+    public:
+        explicit Scope(const char * name, const char * argName = NULL, int arg = 0);
+        ~Scope();
+
+    private:
+        const char * mName;
+        const char * mArgName;
+        int mArg;
+        double mStart;
+        bool mActive;
+    };
+
+    /*! Get the FrameTrace instance */
+    static FrameTrace * instance()
+    {
+        if( mInstance == NULL )
+        {
+            mInstance = new FrameTrace();
+        }
+
+        return mInstance;
+    }
+
+    /*! Destroy the FrameTrace, pending events are written and the file is closed */
+    static void destroy()
+    {
+        if( mInstance != NULL )
+        {
+            delete mInstance;
+            mInstance = NULL;
+        }
+    }
+
+    bool start(const std::string & filename, int nodeId);
+    void stop();
+    void setFrameNumber(unsigned int frame);
+    void addEvent(const char * name, double startTime, double duration, const char * argName = NULL, int arg = 0);
+
+    /*! \returns true if events are recorded */
+    inline bool isEnabled() const { return mEnabled.load(); }
+    /*! \returns the sync frame number that new events are tagged with */
+    inline unsigned int getFrameNumber() const { return mFrameNumber.load(); }
+
+    static double getTime();
+    static bool mergeFiles(const std::vector<std::string> & inputs, const std::string & output);
+
+private:
+    FrameTrace();
+    ~FrameTrace();
+
+    // Don't implement these, should give compile warning if used
+    FrameTrace( const FrameTrace & ft );
+    const FrameTrace & operator=(const FrameTrace & rhs );
+
+    struct Event;
+    struct EventRing;
+
+    void push(const Event & e);
+    std::shared_ptr<EventRing> getThreadRing();
+    void writeLoop();
+    void writeEvents();
+
+private:
+    static FrameTrace * mInstance;
+
+    std::atomic<bool> mEnabled;
+    std::atomic<bool> mRunning;
+    std::atomic<unsigned int> mFrameNumber;
+    unsigned int mGeneration;
+    int mNodeId;
+
+    std::thread * mWriterThread;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::vector< std::shared_ptr<EventRing> > mRings;
+    unsigned int mNumberOfThreads;
+
+    FILE * mFile;
+    std::string mLine;
+};
+
+}
+
+#endif
@@ -0,0 +1,64 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _FRUSTUM_CULLER_H
+#define _FRUSTUM_CULLER_H
+
+#include <vector>
+#include <stddef.h>
+#include <glm/glm.hpp>
+
+namespace sgct
+{
+
+/*!
+    Tests bounding volumes against one or more view frustums. The frustum planes are extracted
+    from (model) view projection matrices, typically the ones of the active viewport (see
+    sgct::Engine::getCurrentFrustumCuller). When several matrices are added, a volume is
+    visible if it intersects any of the frustums, which is useful to cull once for all
+    cube map faces of a non linear projection.
+
+    Arrays of volumes are tested four at a time using SSE when available and the result is
+    stored as a bitset with one bit per volume (see isVisible).
+*/
+class FrustumCuller
+{
+public:
+    FrustumCuller();
+
+    void clear();
+    void setMatrix(const glm::mat4 & mvp);
+    void addMatrix(const glm::mat4 & mvp);
+
+    bool isSphereVisible(const glm::vec3 & center, float radius) const;
+    bool isBoxVisible(const glm::vec3 & minCorner, const glm::vec3 & maxCorner) const;
+    std::size_t cullSpheres(const glm::vec4 * spheres, std::size_t count, std::vector<unsigned int> & visibility) const;
+    std::size_t cullBoxes(const glm::vec3 * minCorners, const glm::vec3 * maxCorners, std::size_t count, std::vector<unsigned int> & visibility) const;
+
+    /*!
+        \returns the number of frustums that are tested
+    */
+    inline std::size_t getNumberOfFrustums() const { return mPlanes.size() / PlaneDataSize; }
+
+    /*!
+        \returns true if the volume with the given index was marked visible by cullSpheres or cullBoxes
+    */
+    static inline bool isVisible(const std::vector<unsigned int> & visibility, std::size_t index)
+        { return ((visibility[index >> 5] >> (index & 31)) & 1u) != 0; }
+
+private:
+    enum PlaneComponent { NormalX = 0, NormalY, NormalZ, Distance, AbsNormalX, AbsNormalY, AbsNormalZ, NumberOfComponents };
+    static const std::size_t NumberOfPlanes = 6;
+    static const std::size_t PlaneDataSize = NumberOfPlanes * NumberOfComponents;
+
+    //planes are stored per frustum as [plane][component]
+    std::vector<float> mPlanes;
+};
+
+}
+
+#endif
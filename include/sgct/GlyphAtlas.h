@@ -0,0 +1,86 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _GLYPH_ATLAS_H_
+#define _GLYPH_ATLAS_H_
+
+#include <stddef.h>
+#include <vector>
+
+namespace sgct_text
+{
+
+/*!
+Packs glyph bitmaps into one or more pages using a skyline packer. The pixels of the pages are kept
+in memory with two channels per pixel, the area that changed since the last upload is tracked per page
+so that only new glyphs have to be copied to the textures. The atlas doesn't use OpenGL itself.
+*/
+class GlyphAtlas
+{
+public:
+    /*!
+    Location of a glyph in the atlas
+    */
+    struct Region
+    {
+        unsigned int page;
+        int x;
+        int y;
+        int width;
+        int height;
+    };
+
+    /*!
+    A page of the atlas. The rows between dirtyMinY and dirtyMaxY were changed since the last call to clearDirty.
+    */
+    struct Page
+    {
+        int size;
+        std::vector<unsigned char> pixels;
+        int dirtyMinY;
+        int dirtyMaxY;
+    };
+
+    static const int Channels = 2;
+
+    GlyphAtlas(int pageSize = 512, int padding = 1);
+
+    bool insert(int width, int height, const unsigned char * pixels, Region & region);
+    void clear();
+    void clearDirty(unsigned int page);
+
+    //! \returns true if the page has pixels that are not uploaded
+    inline bool isDirty(unsigned int page) const { return mPages[page].dirtyMaxY > mPages[page].dirtyMinY; }
+    //! \returns the number of pages
+    inline std::size_t getNumberOfPages() const { return mPages.size(); }
+    //! \returns a page of the atlas
+    inline const Page & getPage(unsigned int page) const { return mPages[page]; }
+    //! \returns the default width and height of the pages
+    inline int getPageSize() const { return mPageSize; }
+
+private:
+    struct SkylineNode
+    {
+        int x;
+        int y;
+        int width;
+    };
+
+    void addPage(int size);
+    bool findPosition(unsigned int page, int width, int height, int & x, int & y, std::size_t & index);
+    int fit(unsigned int page, std::size_t index, int width, int height);
+    void addSkylineLevel(unsigned int page, std::size_t index, int x, int y, int width, int height);
+
+    int mPageSize;
+    int mPadding;
+    std::vector<Page> mPages;
+    std::vector< std::vector<SkylineNode> > mSkylines;
+};
+
+}
+
+#endif
@@ -0,0 +1,32 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _MASK_COMBINER_H_
+#define _MASK_COMBINER_H_
+
+#include <glm/glm.hpp>
+
+namespace sgct_core
+{
+class Image;
+
+/*!
+Pre-multiplies the blend mask and the black level mask of a viewport into a single texture that the
+single pass compositor applies as Result = Color * Combined.rgb + Combined.a. This is the same result
+as the separate mask passes, Result = (Color * BlendMask) * (1 - BlackLevel) + BlackLevel * BlackLevel.a,
+except that the black level added is gray, the mean of the black level's color channels.
+*/
+namespace MaskCombiner
+{
+    glm::vec4 readSample(Image * img, float s, float t);
+    glm::vec4 combineSamples(const glm::vec4 & blend, const glm::vec4 & blackLevel);
+    Image * combine(Image * blendMask, Image * blackLevelMask);
+}
+
+}
+
+#endif
@@ -12,9 +12,16 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <stdarg.h>
 #include <vector>
 #include <string>
+#include <map>
+#include <set>
 #include "helpers/SGCTCPPEleven.h"
 
 #include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <stdio.h>
 
 #define TIME_BUFFER_SIZE 9
 #define LOG_FILENAME_BUFFER_SIZE 1024 //include path
@@ -29,6 +36,13 @@ public:
         Different notify levels for messages
     */
     enum NotifyLevel { NOTIFY_ERROR = 0, NOTIFY_IMPORTANT, NOTIFY_VERSION_INFO, NOTIFY_INFO, NOTIFY_WARNING, NOTIFY_DEBUG, NOTIFY_ALL };
+
+    /*!
+        What to do when the calling thread's log buffer is full in async mode.
+        DropMessages counts the dropped messages and reports the count in the log,
+        BlockUntilSpace waits for the log thread to make room.
+    */
+    enum OverflowPolicy { DropMessages = 0, BlockUntilSpace };
     
     /*! Get the MessageHandler instance */
     static MessageHandler * instance()
@@ -58,6 +72,9 @@ public:
     void printIndent(NotifyLevel nl, unsigned int indentation, const char* fmt, ...);
     void sendMessageToServer(const char *fmt);
     void setSendFeedbackToServer(bool state);
+    void setForwardRateLimit(unsigned int maxMessagesPerSecond);
+    void buildForwardBatch(int frame, std::size_t maxSize, const char * prefix = NULL, std::size_t prefixSize = 0);
+    void printForwardedMessages();
     void clearBuffer();
     void setNotifyLevel( NotifyLevel nl );
     NotifyLevel getNotifyLevel();
@@ -71,6 +88,11 @@ public:
 #ifdef __LOAD_CPP11_FUN__
     void setLogCallback(sgct_cppxeleven::function<void(const char *)> fn);
 #endif
+    void setLogAsync( bool state );
+    bool getLogAsync();
+    void setAsyncOverflowPolicy( OverflowPolicy policy );
+    void setLogFileRotation(std::size_t maxFileSize, unsigned int maxNumberOfFiles);
+    void flush();
     const char * getTimeOfDayStr();
     inline std::size_t getDataSize() { return mBuffer.size(); }
 
@@ -83,8 +105,19 @@ private:
     // Don't implement these, should give compile warning if used
     MessageHandler( const MessageHandler & tm );
     const MessageHandler & operator=(const MessageHandler & rhs );
-    void printv(const char *fmt, va_list ap);
+    void printv(NotifyLevel nl, const char *fmt, va_list ap);
     void logToFile(const char * buffer);
+    void forwardMessage(NotifyLevel nl, const char * fmt, const char * str);
+
+    struct AsyncRing;
+    struct AsyncRecord;
+    std::shared_ptr<AsyncRing> getThreadRing();
+    void pushAsync(const char * str, std::size_t length);
+    void asyncLoop();
+    void drainAsyncRings(std::vector<AsyncRecord> & records, unsigned int & dropped);
+    void writeAsyncRecords(std::vector<AsyncRecord> & records, unsigned int dropped);
+    void writeAsyncFile(const std::string & batch);
+    void closeAsyncFile();
 
 private:
 #ifdef __LOAD_CPP11_FUN__
@@ -114,6 +147,55 @@ private:
     std::string mFilename;
     size_t mMaxMessageSize;
     size_t mCombinedMessageSize;
+
+    //async logging, each thread writes to its own ring that is drained by mAsyncThread
+    std::thread * mAsyncThread;
+    std::mutex mAsyncMutex;
+    std::condition_variable mAsyncCondition;
+    std::condition_variable mAsyncDoneCondition;
+    std::vector< std::shared_ptr<AsyncRing> > mAsyncRings;
+    std::atomic<bool> mLogAsync;
+    std::atomic<bool> mAsyncRunning;
+    std::atomic<int> mOverflowPolicy;
+    std::atomic<unsigned long long> mAsyncSequence;
+    unsigned long long mAsyncPasses;
+    unsigned int mAsyncGeneration;
+    FILE * mAsyncFile;
+    std::string mAsyncFilename;
+    std::size_t mAsyncFileSize;
+    std::size_t mMaxLogFileSize;
+    unsigned int mMaxLogFiles;
+
+    //structured forwarding of slave messages to the master, protected by the DataSyncMutex
+    struct ForwardRecord
+    {
+        unsigned int messageId;
+        int level;
+        unsigned int frame;
+        unsigned int count;
+        std::string text;
+    };
+    struct ForwardRate
+    {
+        double windowStart;
+        unsigned int sent;
+        unsigned int suppressed;
+        int level;
+        std::string lastText;
+    };
+    struct ForwardAggregate
+    {
+        int level;
+        unsigned int firstFrame;
+        unsigned int count;
+        std::set<int> nodes;
+    };
+    std::vector<ForwardRecord> mForwardRecords;
+    std::map<unsigned int, ForwardRate> mForwardRates;
+    std::atomic<unsigned int> mForwardRateLimit;
+    unsigned int mForwardFrame;
+    std::vector<std::string> mAggregateOrder;
+    std::map<std::string, ForwardAggregate> mAggregates;
 };
 
 }
@@ -9,6 +9,7 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #define _NETWORK_MANAGER_H_
 
 #include "SGCTNetwork.h"
+#include "ExternalControlServer.h"
 #include "Statistics.h"
 #include <vector>
 #include <string>
@@ -47,6 +48,7 @@ public:
     bool isRunning();
     bool areAllNodesConnected();
     SGCTNetwork * getExternalControlPtr();
+    ExternalControlServer * getExternalControlServerPtr();
     void transferData(const void * data, int length, int packageId);
     void transferData(const void * data, int length, int packageId, std::size_t nodeIndex);
     void transferData(const void * data, int length, int packageId, SGCTNetwork * connection);
@@ -79,6 +81,7 @@ private:
     std::vector<SGCTNetwork*> mSyncConnections;
     std::vector<SGCTNetwork*> mDataTransferConnections;
     SGCTNetwork* mExternalControlConnection;
+    ExternalControlServer* mExternalControlServer;
 
     std::string mHostName; //stores this computers hostname
     std::vector<std::string> mDNSNames;
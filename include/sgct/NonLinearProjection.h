@@ -53,6 +53,8 @@ namespace sgct_core
         inline BaseViewport * getSubViewportPtr(std::size_t index) { return &mSubViewports[index]; }
         inline OffScreenBuffer * getOffScreenBuffer() { return mCubeMapFBO_Ptr; }
         inline const int * getViewportCoords() { return mVpCoords; }
+        //! Returns true if the cube map is rendered in a single layered pass, see sgct::SGCTSettings::setUseLayeredCubemapRendering
+        inline bool isLayered() const { return mLayered; }
 
     protected:
         enum TextureIndex { CubeMapColor, CubeMapDepth, CubeMapNormals, CubeMapPositions,
@@ -67,6 +69,8 @@ namespace sgct_core
         virtual void initShaders() = 0;
 
         void setupViewport(const std::size_t & face);
+        void initLayeredRendering();
+        void renderLayeredCubemap(std::size_t * subViewPortIndex);
         void generateMap(TextureIndex ti, int internalFormat, unsigned int format, unsigned int type);
         void generateCubeMap(TextureIndex ti, int internalFormat, unsigned int format, unsigned int type);
 
@@ -94,6 +98,17 @@ namespace sgct_core
         sgct::ShaderProgram mShader, mDepthCorrectionShader;
         OffScreenBuffer * mCubeMapFBO_Ptr;
         glm::vec4 mClearColor;
+
+        //! std140 layout of the CubeFaces uniform block used in layered rendering
+        struct CubeFacesBlock
+        {
+            glm::mat4 faceMVP[6];
+            glm::mat4 faceMV[6];
+            glm::ivec4 faceEnabled[6];
+        };
+
+        bool mLayered;
+        unsigned int mCubeFacesUBO;
     };
 
 }
@@ -27,6 +27,8 @@ public:
     void attachDepthTexture(unsigned int texId);
     void attachCubeMapTexture(unsigned int texId, unsigned int face, GLenum attachment = GL_COLOR_ATTACHMENT0);
     void attachCubeMapDepthTexture(unsigned int texId, unsigned int face);
+    void attachLayeredTexture(unsigned int texId, GLenum attachment = GL_COLOR_ATTACHMENT0);
+    void attachLayeredDepthTexture(unsigned int texId);
     void bind();
     void bind( GLsizei n, const GLenum *bufs );
     void bind( bool multisampled );
@@ -9,9 +9,11 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #define _POST_FX_H_
 
 #include "ShaderProgram.h"
+#include <vector>
 
 namespace sgct
 {
+class SGCTWindow;
 
 /*!
     Class that holds a post effect pass
@@ -21,11 +23,16 @@ class PostFX
 public:
     PostFX();
     bool init( const std::string & name, const std::string & vertShaderSrc, const std::string & fragShaderSrc, ShaderProgram::ShaderSourceType srcType = ShaderProgram::SHADER_SRC_FILE);
+    bool initPerPixel( const std::string & name, const std::string & effectSrc, ShaderProgram::ShaderSourceType srcType = ShaderProgram::SHADER_SRC_FILE);
     void destroy();
     void render();
+    void updateUniforms();
     void setUpdateUniformsFunction( void(*fnPtr)() );
     void setInputTexture( unsigned int inputTex );
     void setOutputTexture( unsigned int outputTex );
+    void setEnabled( bool state );
+    static ShaderProgram * getCurrentShaderProgram();
+    static void renderFused( ShaderProgram * program, SGCTWindow * win, const std::vector<std::size_t> & passes, unsigned int inputTex, unsigned int outputTex );
     
     /*!
         \returns the output texture
@@ -43,6 +50,18 @@ public:
         \returns name of this post effect pass
     */
     inline const std::string & getName() { return mName; }
+    /*!
+        \returns true if the pass is rendered
+    */
+    inline bool isEnabled() const { return mEnabled; }
+    /*!
+        \returns true if the pass was created with initPerPixel and can be fused with neighbouring per-pixel passes
+    */
+    inline bool isPerPixel() const { return mPerPixel; }
+    /*!
+        \returns the effect source of a per-pixel pass
+    */
+    inline const std::string & getEffectSource() const { return mEffectSrc; }
 
 private:
     void internalRender();
@@ -58,7 +77,11 @@ private:
     
     int mXSize, mYSize;
     std::string mName;
+    bool mEnabled;
+    bool mPerPixel;
+    std::string mEffectSrc;
     static bool mDeleted;
+    static ShaderProgram * mCurrentShaderProgram;
 };
 }
 
@@ -0,0 +1,75 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _POST_FX_GRAPH_H_
+#define _POST_FX_GRAPH_H_
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+namespace sgct_core
+{
+
+/*!
+Splits the post effect chain of a window into the stages that are rendered. Disabled passes are left out,
+consecutive per-pixel passes are fused into one stage and FXAA is the last stage. Every stage reads the output
+of the previous one, the first stage reads the rendered scene and the last stage writes to the window's target
+texture. The stages in between write to two pool buffers in turns so that no more than two intermediate textures
+are needed however long the chain is. Doesn't make any OpenGL calls.
+*/
+class PostFXGraph
+{
+public:
+    enum Buffer { SourceBuffer = 0, PoolBuffer0, PoolBuffer1, TargetBuffer };
+
+    struct Pass
+    {
+        bool enabled;
+        bool perPixel; //only reads the input pixel it writes so it can be fused with its neighbours
+    };
+
+    struct Stage
+    {
+        std::vector<std::size_t> passes; //indices of the passes, empty for FXAA and copy stages
+        bool fxaa;
+        Buffer input;
+        Buffer output;
+
+        //! \returns true if the stage renders several passes with one generated shader
+        inline bool isFused() const { return passes.size() > 1; }
+        //! \returns true if the stage only copies the source to the target because all passes are disabled
+        inline bool isCopy() const { return passes.empty() && !fxaa; }
+    };
+
+    PostFXGraph();
+
+    bool update(const std::vector<Pass> & passes, bool fxaa, bool fuse);
+    void clear();
+
+    //! \returns the stages in rendering order
+    inline const std::vector<Stage> & getStages() const { return mStages; }
+    //! \returns the number of pool buffers that the stages write to
+    inline unsigned int getNumberOfPoolBuffers() const { return mNumberOfPoolBuffers; }
+
+    static std::string getStageKey(const Stage & stage);
+    static std::string generateFragmentShader(const std::vector<std::string> & effects, bool fixedPipeline);
+
+private:
+    void build();
+
+    std::vector<Pass> mPasses;
+    bool mFXAA;
+    bool mFuse;
+    bool mValid;
+    std::vector<Stage> mStages;
+    unsigned int mNumberOfPoolBuffers;
+};
+
+}
+
+#endif
@@ -13,6 +13,7 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <glm/glm.hpp>
 #include "SGCTWindow.h"
 #include "SGCTNode.h"
+#include "CompiledConfig.h"
 
 #ifndef SGCT_DONT_USE_EXTERNAL
     #include <external/tinyxml2.h>
@@ -30,6 +31,17 @@ public:
     ~ReadConfig();
 
     bool isValid() { return valid; }
+    bool readNodeConfiguration(int nodeIndex);
+    bool readNodeConfiguration(int nodeIndex, tinyxml2::XMLDocument & xmlDoc);
+    bool getNodeDocuments(std::vector<tinyxml2::XMLDocument *> & xmlDocs);
+    //! \returns the name of the configuration file
+    inline const std::string & getFilename() const { return xmlFileName; }
+    bool reloadViewports(int nodeIndex);
+    bool reloadViewports(int nodeIndex, tinyxml2::XMLDocument & xmlDoc);
+    bool hasSourceChanged(uint32_t & hash);
+    //! \returns the CRC-32 of the config file when it was last read
+    inline uint32_t getSourceHash() const { return mSourceHash; }
+    static void setUseCache(bool state);
     static glm::quat parseOrientationNode(tinyxml2::XMLElement* element);
     static glm::quat parseMpcdiOrientationNode(const float yaw, const float pitch, const float roll);
 
@@ -38,12 +50,19 @@ private:
     bool readAndParseXMLFile();
     bool readAndParseXMLString();
     bool readAndParseXML(tinyxml2::XMLDocument& xmlDoc);
+    bool readAndParseNode(tinyxml2::XMLElement * nodeElement, SGCTNode & node);
+    bool loadCompiledConfig(CompiledConfig & config);
     sgct::SGCTWindow::StereoMode getStereoType( std::string type );
     sgct::SGCTWindow::ColorBitDepth getBufferColorBitDepth(std::string type);
 
     bool valid;
     std::string xmlFileName;
     std::string mErrorMsg;
+
+    CompiledConfig mCompiledConfig;
+    bool mNodesDeferred;
+    uint64_t mSourceSize;
+    uint32_t mSourceHash;
 };
 
 }
@@ -0,0 +1,97 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _RENDER_GRAPH_H_
+#define _RENDER_GRAPH_H_
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+namespace sgct_core
+{
+
+/*!
+Plans the passes that render a frame on this node. Every pass declares the resources it reads and writes and
+the graph works out the order they are executed in, culls the passes whose output isn't used by anything and
+lets transient resources whose lifetimes don't overlap share the same memory.
+
+A resource can be written by several passes, a pass that reads it depends on the last pass added before it that
+wrote it and a pass that writes it waits for the passes added before it that read it. Passes that write to
+something outside of the graph, like the screen, are never culled. Doesn't make any OpenGL calls.
+*/
+class RenderGraph
+{
+public:
+    enum PassType { CubemapPass = 0, ViewportPass, ScreenPass };
+
+    static const std::size_t NoSlot;
+
+    struct Resource
+    {
+        std::string name;
+        bool transient; //only used within the frame so its memory can be shared with other transient resources
+        int width;
+        int height;
+        int format;
+        std::size_t window;
+        int texture; //framebuffer texture index of the window, -1 if the window doesn't own it
+        std::size_t slot; //memory slot of a transient resource, NoSlot if it isn't used
+    };
+
+    struct Pass
+    {
+        PassType type;
+        std::size_t window;
+        std::size_t viewport;
+        bool rightEye;
+        std::size_t drawBufferIndex;
+        bool sideEffect; //writes to something outside of the graph so it's never culled
+        std::vector<std::size_t> reads;
+        std::vector<std::size_t> writes;
+    };
+
+    RenderGraph();
+
+    std::size_t addResource(const std::string & name, bool transient, int width, int height, int format, std::size_t window, int texture);
+    std::size_t addPass(PassType type, std::size_t window, std::size_t viewport, bool rightEye, std::size_t drawBufferIndex, bool sideEffect);
+    void read(std::size_t pass, std::size_t resource);
+    void write(std::size_t pass, std::size_t resource);
+    void compile();
+    void clear();
+
+    //! \returns the passes that are executed in execution order
+    inline const std::vector<std::size_t> & getOrder() const { return mOrder; }
+    inline const Pass & getPass(std::size_t index) const { return mPasses[index]; }
+    inline const Resource & getResource(std::size_t index) const { return mResources[index]; }
+    inline std::size_t getNumberOfPasses() const { return mPasses.size(); }
+    inline std::size_t getNumberOfResources() const { return mResources.size(); }
+    //! \returns the number of memory slots that the transient resources share
+    inline std::size_t getNumberOfSlots() const { return mSlotOwners.size(); }
+    //! \returns the first resource placed in the slot, the one that owns the memory
+    inline std::size_t getSlotOwner(std::size_t slot) const { return mSlotOwners[slot]; }
+    //! \returns true if the pass isn't executed because nothing uses what it writes
+    inline bool isCulled(std::size_t pass) const { return !mLive[pass]; }
+    //! \returns true if the graph has been compiled since it was last changed
+    inline bool isCompiled() const { return mCompiled; }
+
+private:
+    void cull();
+    void sort();
+    void assignSlots();
+
+    std::vector<Resource> mResources;
+    std::vector<Pass> mPasses;
+    std::vector<bool> mLive;
+    std::vector<std::size_t> mOrder;
+    std::vector<std::size_t> mSlotOwners;
+    bool mCompiled;
+};
+
+}
+
+#endif
@@ -0,0 +1,67 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _RESOLUTION_SCALER_H_
+#define _RESOLUTION_SCALER_H_
+
+namespace sgct_core
+{
+
+/*!
+Decides the scale of the render resolution from frame times. When the frame time has stayed above the upper
+threshold of the budget for a few frames in a row the scale is lowered so that the pixel count shrinks in proportion
+to the smallest overshoot of those frames, a single hitch doesn't change the scale. When the smoothed frame time
+has stayed below the lower threshold for a while the scale is raised one step, if the predicted frame time at the new
+scale still fits. The scale is quantized to steps and every change is followed by a cool down, so that the buffers
+aren't reallocated every frame and the timings of the new scale are measured before the next decision. Doesn't make
+any OpenGL calls so it can be run on recorded or simulated frame times.
+*/
+class ResolutionScaler
+{
+public:
+    static const unsigned int CoolDownFrames = 10;
+    static const unsigned int LowerFrames = 5;
+    static const unsigned int RaiseFrames = 60;
+
+    ResolutionScaler();
+
+    void setBudget(float seconds);
+    void setScaleLimits(float minScale, float maxScale);
+    void setThresholds(float lower, float upper);
+    void setStep(float step);
+    void reset();
+    bool update(float frameTime);
+
+    //! \returns the current scale of the render resolution
+    inline float getScale() const { return mScale; }
+    //! \returns the frame time budget in seconds
+    inline float getBudget() const { return mBudget; }
+    //! \returns the smoothed frame time in seconds
+    inline float getSmoothedFrameTime() const { return mSmoothedFrameTime; }
+
+private:
+    float quantize(float scale) const;
+    bool setScale(float scale);
+
+    float mBudget;
+    float mMinScale;
+    float mMaxScale;
+    float mLowerThreshold;
+    float mUpperThreshold;
+    float mStep;
+    float mScale;
+    float mSmoothedFrameTime;
+    bool mHasFrameTime;
+    unsigned int mCoolDown;
+    unsigned int mFramesBelow;
+    unsigned int mFramesAbove;
+    float mMinLoadAbove;
+};
+
+}
+
+#endif
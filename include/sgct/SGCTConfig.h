@@ -0,0 +1,13 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _SGCT_CONFIG_H_
+#define _SGCT_CONFIG_H_
+
+#define INCLUDE_SGCT_TEXT 1
+
+#endif
@@ -25,6 +25,7 @@ class SGCTProjection
 public:
     SGCTProjection();
     void calculateProjection(glm::vec3 base, SGCTProjectionPlane * projectionPlanePtr, float near_clipping_plane, float far_clipping_plane, glm::vec3 viewOffset = glm::vec3(0.0f, 0.0f, 0.0f));
+    void setMatrices(const glm::mat4 & viewMatrix, const glm::mat4 & projectionMatrix, const glm::mat4 & viewProjectionMatrix);
 
     inline Frustum * getFrustum() { return &mFrustum; }
     inline const glm::mat4 & getViewProjectionMatrix() { return mViewProjectionMatrix; }
@@ -0,0 +1,59 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _PROJECTION_SOLVER_H
+#define _PROJECTION_SOLVER_H
+
+#include <vector>
+#include <stddef.h>
+#include "Frustum.h"
+
+namespace sgct_core
+{
+
+class BaseViewport;
+class NonLinearProjection;
+class SGCTProjection;
+
+/*!
+    Calculates the projections of many viewports, eyes and cube faces in one batch.
+    The input is gathered into a struct-of-arrays layout and solved four projections
+    at a time using SSE when available. The result is identical to calling
+    SGCTProjection::calculateProjection for every projection.
+*/
+class SGCTProjectionSolver
+{
+public:
+    SGCTProjectionSolver();
+
+    void clear();
+    void addViewport(BaseViewport * vp, Frustum::FrustumMode frustumMode);
+    void addNonLinearViewport(BaseViewport * vp, Frustum::FrustumMode frustumMode);
+    void addNonLinearProjection(NonLinearProjection * nlp, Frustum::FrustumMode frustumMode);
+    void solve(float near_clipping_plane, float far_clipping_plane);
+
+    inline std::size_t getNumberOfProjections() const { return mTargets.size(); }
+
+private:
+    void add(SGCTProjection * target, BaseViewport * vp, Frustum::FrustumMode frustumMode, bool nonLinear);
+
+    enum InputIndex { EyeX = 0, EyeY, EyeZ, OffsetX, OffsetY, OffsetZ,
+        LowerLeftX, LowerLeftY, LowerLeftZ, UpperLeftX, UpperLeftY, UpperLeftZ, UpperRightX, UpperRightY, UpperRightZ,
+        NumberOfInputs };
+
+    enum OutputIndex { Left = 0, Right, Bottom, Top,
+        View00, View01, View02, View10, View11, View12, View20, View21, View22, ViewTX, ViewTY, ViewTZ,
+        NumberOfOutputs };
+
+    std::vector<SGCTProjection *> mTargets;
+    std::vector<float> mInput[NumberOfInputs];
+    std::vector<float> mOutput[NumberOfOutputs];
+};
+
+}
+
+#endif
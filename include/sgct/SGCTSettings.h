@@ -84,6 +84,13 @@ public:
     void setUseWarping(bool state);
     void setShowWarpingWireframe(bool state);
     void setTryMaintainAspectRatio(bool state);
+    void setUseLayeredCubemapRendering(bool state);
+    void setLayeredCubemapUniformBlockBinding(unsigned int binding);
+    void setUseSinglePassCompositor(bool state);
+    void setUseTextureAliasing(bool state);
+    void setUseDynamicResolution(bool state);
+    void setDynamicResolutionBudget(float seconds);
+    void setMinResolutionScale(float scale);
     
     // ----------- get functions ---------------- //
     const char *        getCapturePath(CapturePathIndex cpi = Mono) const;
@@ -102,6 +109,13 @@ public:
     const bool            getCaptureFromBackBuffer() const;
     const bool            getTryMaintainAspectRatio() const;
     const bool            getExportWarpingMeshes() const;
+    const bool            getUseLayeredCubemapRendering() const;
+    const unsigned int    getLayeredCubemapUniformBlockBinding() const;
+    const bool            getUseSinglePassCompositor() const;
+    const bool            getUseTextureAliasing() const;
+    const bool            getUseDynamicResolution() const;
+    const float            getDynamicResolutionBudget() const;
+    const float            getMinResolutionScale() const;
 
     // -- mutex protected get functions ---------- //
     const bool            getUseRLE();
@@ -165,6 +179,14 @@ private:
     bool mCaptureBackBuffer;
     bool mTryMaintainAspectRatio;
     bool mExportWarpingMeshes;
+    bool mUseLayeredCubemapRendering;
+    bool mUseSinglePassCompositor;
+    bool mUseTextureAliasing;
+    bool mUseDynamicResolution;
+    float mDynamicResolutionBudget;
+    float mMinResolutionScale;
+
+    unsigned int mLayeredCubemapUniformBlockBinding;
 
     float mOSDTextOffset[2];
     float mFXAASubPixTrim;
@@ -12,6 +12,7 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
 //#include <glm/gtx/quaternion.hpp>
+#include "helpers/SGCTSeqLock.h"
 
 typedef void * GLFWmutex;
 
@@ -25,6 +26,8 @@ class SGCTTrackingDevice
 {
 public:
     enum DataLoc { CURRENT = 0, PREVIOUS };
+    /*! Extrapolation of the sensor pose to a future time */
+    enum PredictionMode { NoPrediction = 0, ConstantVelocity, ConstantAcceleration };
 
     SGCTTrackingDevice(size_t parentIndex, std::string name);
     ~SGCTTrackingDevice();
@@ -33,9 +36,9 @@ public:
     void setSensorId(int id);
     void setNumberOfButtons(size_t numOfButtons);
     void setNumberOfAxes(size_t numOfAxes);
-    void setSensorTransform( glm::dvec3 vec, glm::dquat rot );
-    void setButtonVal(const bool val, size_t index);
-    void setAnalogVal(const double * array, size_t size);
+    void setSensorTransform( glm::dvec3 vec, glm::dquat rot, double time = -1.0 );
+    void setButtonVal(const bool val, size_t index, double time = -1.0);
+    void setAnalogVal(const double * array, size_t size, double time = -1.0);
     void setOrientation(float xRot, float yRot, float zRot);
     void setOrientation(float w, float x, float y, float z);
     void setOrientation(glm::quat q);
@@ -43,6 +46,8 @@ public:
     void setTransform(glm::mat4 mat);
 
     inline const std::string & getName() { return mName; }
+    //! \returns the index of the parent SGCTTracker
+    inline size_t getParentIndex() { return mParentIndex; }
     inline size_t getNumberOfButtons() { return mNumberOfButtons; }
     inline size_t getNumberOfAxes() { return mNumberOfAxes; }
     bool getButton(size_t index, DataLoc i = CURRENT);
@@ -59,6 +64,7 @@ public:
     glm::mat4 getWorldTransform(DataLoc i = CURRENT);
     glm::dquat getSensorRotation(DataLoc i = CURRENT);
     glm::dvec3 getSensorPosition(DataLoc i = CURRENT);
+    glm::mat4 getPredictedWorldTransform(double time, PredictionMode mode = ConstantVelocity);
 
     double getTrackerTimeStamp(DataLoc i = CURRENT);
     double getAnalogTimeStamp(DataLoc i = CURRENT);
@@ -69,10 +75,32 @@ public:
     double getButtonDeltaTime(size_t index);
 
 private:
+    /*!
+    Sensor sample with the transforms that were used to calculate its world transform
+    */
+    struct PoseSample
+    {
+        glm::dvec3 position;
+        glm::dquat rotation;
+        glm::mat4 systemTransform;
+        glm::mat4 deviceTransform;
+        double time;
+    };
+
+    /*!
+    The three latest sensor samples, newest first. Published lock-free by the sampling thread.
+    */
+    struct PoseHistory
+    {
+        PoseSample samples[3];
+        unsigned int count;
+    };
+
     void calculateTransform();
-    void setTrackerTimeStamp();
-    void setAnalogTimeStamp();
-    void setButtonTimeStamp(size_t index);
+    static glm::dvec3 getAngularVelocity(const glm::dquat & from, const glm::dquat & to, double dt);
+    void setTrackerTimeStamp(double time);
+    void setAnalogTimeStamp(double time);
+    void setButtonTimeStamp(size_t index, double time);
 
 private:
     bool mEnabled;
@@ -94,6 +122,8 @@ private:
     double * mButtonTime;
     bool * mButtons;
     double * mAxes;
+
+    sgct_helpers::SeqLockValue<PoseHistory> mPoseHistory;
 };
 
 }
@@ -13,6 +13,8 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <thread>
 #include "SGCTTracker.h"
 #include "SGCTUser.h"
+#include "SGCTTrackingRecorder.h"
+#include "SGCTTrackingPlayer.h"
 
 namespace sgct
 {
@@ -45,6 +47,30 @@ public:
     void setEnabled(bool state);
     void setSamplingTime(double t);
     double getSamplingTime();
+    void setEventDrivenSampling(bool state);
+    //! \returns true if the sampling thread waits for data from the VRPN connections instead of sleeping
+    inline bool isEventDrivenSampling() const { return mEventDrivenSampling; }
+    void setPrediction(SGCTTrackingDevice::PredictionMode mode, double extraLatency = 0.0);
+    //! \returns how the head pose is extrapolated to the expected swap time
+    inline SGCTTrackingDevice::PredictionMode getPredictionMode() const { return mPredictionMode; }
+    void setSwapTime(double t);
+    //! \returns the measured time from the head tracking update until the buffer swap in seconds
+    inline double getSwapLatency() const { return mSwapLatency; }
+
+    void setRecordFile(const std::string & filename);
+    bool setReplayFile(const std::string & filename);
+    void setReplayRealTime(bool state);
+    void setReplayLoop(bool state);
+    //! \returns true if tracking data is replayed from a recording instead of read from VRPN
+    inline bool isReplaying() const { return mPlayer.isOpen(); }
+    //! \returns true if the replay follows the recorded timing, otherwise records are played as fast as possible
+    inline bool isReplayRealTime() const { return mReplayRealTime; }
+    //! \returns true if the replay restarts when the end of the recording is reached
+    inline bool isReplayLooping() const { return mReplayLoop; }
+    //! \returns the recorder of the VRPN reports
+    inline SGCTTrackingRecorder * getRecorderPtr() { return &mRecorder; }
+    //! \returns the player used for replays
+    inline SGCTTrackingPlayer * getPlayerPtr() { return &mPlayer; }
 
     bool isRunning();
 
@@ -57,6 +83,18 @@ private:
     std::set< std::string > mAddresses;
     double mSamplingTime;
     bool mRunning;
+    bool mEventDrivenSampling;
+
+    SGCTTrackingDevice::PredictionMode mPredictionMode;
+    double mPredictionExtraLatency;
+    double mSwapLatency;
+    double mLastUpdateTime;
+
+    SGCTTrackingRecorder mRecorder;
+    SGCTTrackingPlayer mPlayer;
+    std::string mRecordFilename;
+    bool mReplayRealTime;
+    bool mReplayLoop;
 
     sgct_core::SGCTUser * mHeadUser;
     SGCTTrackingDevice * mHead;
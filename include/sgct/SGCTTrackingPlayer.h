@@ -0,0 +1,69 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _SGCT_TRACKING_PLAYER_H_
+#define _SGCT_TRACKING_PLAYER_H_
+
+#include <stdio.h>
+#include <string>
+#include "SGCTTrackingRecorder.h"
+
+namespace sgct
+{
+
+/*!
+Replays a recording made by the SGCTTrackingRecorder into the devices of the SGCTTrackingManager, in place of
+the VRPN remotes. The configuration must contain the same trackers and devices as when the recording was made.
+
+The SGCTTrackingManager uses a player in its sampling thread when a replay is set, either in real-time or as
+fast as possible. A player can also be driven directly without any window or network, calling playNext() and
+SGCTTrackingManager::updateTrackingDevices() in a loop to benchmark the tracking path deterministically.
+*/
+class SGCTTrackingPlayer
+{
+public:
+    SGCTTrackingPlayer();
+    ~SGCTTrackingPlayer();
+
+    bool open(const std::string & filename);
+    void close();
+    void rewind();
+
+    bool readRecord(SGCTTrackingRecorder::Record & record);
+    bool playNext();
+    size_t playUntil(double time);
+
+    /*!
+    Set the time that is added to the recorded time stamps when the reports are applied to the devices
+    */
+    inline void setTimeOffset(double offset) { mTimeOffset = offset; }
+    //! \returns true if a recording is open
+    inline bool isOpen() const { return mFile != NULL; }
+    //! \returns true if all records have been played
+    inline bool isAtEnd() const { return mFile == NULL || (!mHasPending && mEndOfFile); }
+    //! \returns the recorded time of the last played record
+    inline double getTime() const { return mTime; }
+
+private:
+    // Don't implement these, should give compile warning if used
+    SGCTTrackingPlayer( const SGCTTrackingPlayer & player );
+    const SGCTTrackingPlayer & operator=(const SGCTTrackingPlayer & rhs );
+
+    void apply(const SGCTTrackingRecorder::Record & record);
+
+    FILE * mFile;
+    std::string mFilename;
+    SGCTTrackingRecorder::Record mPending;
+    bool mHasPending;
+    bool mEndOfFile;
+    double mTimeOffset;
+    double mTime;
+};
+
+}
+
+#endif
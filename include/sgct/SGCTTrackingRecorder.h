@@ -0,0 +1,81 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _SGCT_TRACKING_RECORDER_H_
+#define _SGCT_TRACKING_RECORDER_H_
+
+#include <stdio.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+
+namespace sgct
+{
+
+/*!
+Records the raw VRPN reports of all tracking devices to a binary file so that a session can be replayed
+with the SGCTTrackingPlayer. Reports are recorded by the sampling thread with the time they arrived,
+relative to the start of the recording.
+
+The file starts with an 8 byte header, "SGCTTRK" followed by the format version. Each record starts with a
+24 byte header in host byte order: type (uint8), unused (uint8), tracker index (uint16), device (int32, the
+sensor id for sensor records otherwise the device index), number of values (uint32), unused (uint32) and
+the time in seconds (double), followed by the values as doubles. Sensors store the position and the rotation quaternion (x, y, z, w) as
+received from VRPN, buttons store the button index and state and analogs store all channels.
+*/
+class SGCTTrackingRecorder
+{
+public:
+    enum RecordType { SensorRecord = 0, ButtonRecord, AnalogRecord };
+
+    /*!
+    One report read from a recording
+    */
+    struct Record
+    {
+        RecordType type;
+        unsigned int tracker;
+        int device;
+        double time;
+        std::vector<double> values;
+    };
+
+    static const unsigned char FormatVersion = 1;
+    static const size_t HeaderSize = 8;
+    static const size_t RecordHeaderSize = 24;
+
+    SGCTTrackingRecorder();
+    ~SGCTTrackingRecorder();
+
+    bool start(const std::string & filename);
+    void stop();
+    //! \returns true if reports are recorded
+    inline bool isRecording() const { return mRecording.load(); }
+
+    void recordSensor(size_t trackerIndex, int sensorId, const double * pos, const double * quat, double time);
+    void recordButton(size_t trackerIndex, size_t deviceIndex, int button, int state, double time);
+    void recordAnalog(size_t trackerIndex, size_t deviceIndex, const double * values, size_t count, double time);
+
+private:
+    // Don't implement these, should give compile warning if used
+    SGCTTrackingRecorder( const SGCTTrackingRecorder & rec );
+    const SGCTTrackingRecorder & operator=(const SGCTTrackingRecorder & rhs );
+
+    void write(RecordType type, size_t trackerIndex, int device, const double * values, size_t count, double time);
+
+    std::atomic<bool> mRecording;
+    std::mutex mMutex;
+    FILE * mFile;
+    double mStartTime;
+    unsigned long long mNumberOfRecords;
+};
+
+}
+
+#endif
@@ -13,7 +13,9 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include "ScreenCapture.h"
 #include "Viewport.h"
 #include "PostFX.h"
+#include "PostFXGraph.h"
 #include <vector>
+#include <map>
 
 #define NUMBER_OF_TEXTURES 8
 
@@ -88,6 +90,7 @@ public:
     void setColorBitDepth(ColorBitDepth cbd);
     void setPreferBGR(bool state);
     void setAllowCapture(bool state);
+    void setResolutionScale(float scale);
 
     // -------------- is functions --------------- //
     const bool &        isFullScreen() const;
@@ -132,6 +135,7 @@ public:
     const float &                    getContrast() const;
     const float &                    getBrightness() const;
     ColorBitDepth                    getColorBitDepth() const;
+    bool                            usesSinglePassCompositor() const;
     const float &                    getHorizFieldOfViewDegrees();
     
     // ------------------ Inline functions ----------------------- //
@@ -177,6 +181,9 @@ public:
      */
     inline const float & getYScale() const { return mScale[1]; }
 
+    //! \returns the scale of the frame buffer resolution set by dynamic resolution scaling
+    inline const float & getResolutionScale() const { return mResolutionScale; }
+
     //! \returns the aspect ratio of the window 
     inline const float & getAspectRatio() const { return mAspectRatio; }
 
@@ -193,6 +200,12 @@ public:
 
     //------------- Other ------------------------- //
     void addPostFX( sgct::PostFX & fx );
+    const sgct_core::PostFXGraph & updatePostFXGraph();
+    sgct::ShaderProgram * getFusedPostFXProgram(std::size_t stageIndex);
+    void setFrameBufferTextureAlias(unsigned int index, unsigned int texture);
+    void releaseFrameBufferTextureAlias(unsigned int index);
+    /*! \returns true if the framebuffer texture is owned by another window */
+    inline bool isFrameBufferTextureAliased(unsigned int index) const { return mAliasedTextures[index]; }
     void addViewport(float left, float right, float bottom, float top);
     void addViewport(sgct_core::Viewport * vpPtr);
 
@@ -222,12 +235,14 @@ private:
     void deleteAllViewports();
     void createTextures();
     void generateTexture(unsigned int id, const int xSize, const int ySize, const TextureType type, const bool interpolate);
+    void deleteFrameBufferTexture(unsigned int index);
     void createFBOs();
     void resizeFBOs();
     void createVBOs();
     void loadShaders();
     void updateTransferCurve();
     void updateColorBufferData();
+    void setUnscaledFramebufferResolution(int x, int y);
 
 public:
     sgct_core::OffScreenBuffer * mFinalFBO_Ptr;
@@ -257,6 +272,9 @@ private:
     bool mDecorated;
     bool mAlpha;
     int mFramebufferResolution[2];
+    int mUnscaledFramebufferResolution[2];
+    float mResolutionScale;
+    bool mResolutionScaleChanged;
     int mWindowInitialRes[2];
     bool mHasPendingWindowRes;
     int mPendingWindowRes[2];
@@ -289,6 +307,7 @@ private:
 
     //FBO stuff
     unsigned int mFrameBufferTextures[NUMBER_OF_TEXTURES];
+    bool mAliasedTextures[NUMBER_OF_TEXTURES]; //the texture is owned by another window and shared through the render graph
 
     sgct_core::ScreenCapture * mScreenCapture[2];
 
@@ -313,6 +332,11 @@ private:
     sgct_core::BaseViewport * mCurrentViewport;
     std::vector<sgct_core::Viewport *> mViewports;
     std::vector<sgct::PostFX> mPostFXPasses;
+    sgct_core::PostFXGraph mPostFXGraph;
+    std::vector<sgct_core::PostFXGraph::Pass> mPostFXPassStates;
+    std::map<std::string, sgct::ShaderProgram> mFusedPostFXPrograms; //keyed by the passes they render
+    std::vector<sgct::ShaderProgram *> mPostFXStagePrograms; //fused program of each stage, resolved on first use
+    bool mFusePostFX;
 };
 }
 
@@ -30,10 +30,22 @@ namespace sgct //simple graphics cluster toolkit
 This class shares application data between nodes in a cluster where the master encodes and transmits the data and the slaves receives and decode the data.
 If a large number of strings are used for the synchronization then the data can be compressed using the setCompression function.
 The process of synchronization is serial which means that the order of encoding must be the same as in decoding.
+
+As an alternative to the encode and decode callbacks the shared objects can be registered once with a unique id using addField.
+Registered fields are encoded before the callback data in id order, fields that haven't changed since the last frame are skipped.
+Ids from ReservedFieldId and up are used by SGCT itself and can't be added or removed by the application.
 */
 class SharedData
 {
+    friend class Engine; //registers the fields with reserved ids
+
 public:
+    static const unsigned int ReservedFieldId = 0xFFFFFF00;
+    //! id of the render resolution scale decided by the master, see SGCTSettings::setUseDynamicResolution
+    static const unsigned int ResolutionScaleFieldId = ReservedFieldId;
+    //! id of the hash of the config file reloaded by the master, see the --Watch-Config argument
+    static const unsigned int ConfigHashFieldId = ReservedFieldId + 1;
+
     /*! Get the SharedData instance */
     static SharedData * instance()
     {
@@ -111,6 +123,32 @@ public:
     void setEncodeFunction( void(*fnPtr)(void) );
     void setDecodeFunction( void(*fnPtr)(void) );
 
+    void addField(unsigned int id, SharedFloat * sf);
+    void addField(unsigned int id, SharedDouble * sd);
+    void addField(unsigned int id, SharedInt64 * si);
+    void addField(unsigned int id, SharedInt32 * si);
+    void addField(unsigned int id, SharedInt16 * si);
+    void addField(unsigned int id, SharedInt8 * si);
+    void addField(unsigned int id, SharedUInt64 * si);
+    void addField(unsigned int id, SharedUInt32 * si);
+    void addField(unsigned int id, SharedUInt16 * si);
+    void addField(unsigned int id, SharedUInt8 * si);
+    void addField(unsigned int id, SharedUChar * suc);
+    void addField(unsigned int id, SharedBool * sb);
+    void addField(unsigned int id, SharedString * ss);
+    void addField(unsigned int id, SharedWString * ss);
+    template<class T>
+    void addField(unsigned int id, SharedObject<T> * sobj);
+    template<class T>
+    void addField(unsigned int id, SharedVector<T> * vector);
+    template<class T>
+    void addPODField(unsigned int id, T * data);
+    void removeField(unsigned int id);
+    void clearFields();
+    void setFieldDirtyTracking(bool state);
+    //! \returns the number of registered fields
+    inline std::size_t getNumberOfFields() const { return mFields.size(); }
+
     void encode();
     void decode(const char * receivedData, int receivedlength, int clientIndex);
 
@@ -133,11 +171,57 @@ private:
     void writeSize(uint32_t size);
     uint32_t readSize();
 
+    typedef void (*FieldAppendFn)(void * field, std::vector<unsigned char> & buffer);
+    typedef uint32_t (*FieldSetFn)(void * field, const unsigned char * data, uint32_t length);
+
+    /*!
+    Describes a registered field. Fixed size fields have a size in bytes, variable size fields
+    have size zero and encode their length first. PODs have no functions and are copied directly.
+    */
+    struct FieldDescriptor
+    {
+        unsigned int id;
+        void * field;
+        uint32_t size;
+        FieldAppendFn appendFn;
+        FieldSetFn setFn;
+        std::vector<unsigned char> lastValue;
+        bool hasLastValue;
+    };
+
+    void addFieldDescriptor(unsigned int id, void * field, uint32_t size, FieldAppendFn appendFn, FieldSetFn setFn);
+    void insertFieldDescriptor(unsigned int id, void * field, uint32_t size, FieldAppendFn appendFn, FieldSetFn setFn);
+    void addReservedField(unsigned int id, SharedFloat * sf);
+    void addReservedField(unsigned int id, SharedUInt32 * si);
+    void updateFieldSchema();
+    void encodeFields();
+    void decodeFields();
+
+    template<class S, class V>
+    static void appendFieldValue(void * field, std::vector<unsigned char> & buffer);
+    template<class S, class V>
+    static uint32_t setFieldValue(void * field, const unsigned char * data, uint32_t length);
+    template<class T>
+    static void appendFieldVector(void * field, std::vector<unsigned char> & buffer);
+    template<class T>
+    static uint32_t setFieldVector(void * field, const unsigned char * data, uint32_t length);
+    static void appendFieldString(void * field, std::vector<unsigned char> & buffer);
+    static uint32_t setFieldString(void * field, const unsigned char * data, uint32_t length);
+    static void appendFieldWString(void * field, std::vector<unsigned char> & buffer);
+    static uint32_t setFieldWString(void * field, const unsigned char * data, uint32_t length);
+
 private:
     //function pointers
     void (*mEncodeFn) (void);
     void (*mDecodeFn) (void);
 
+    std::vector<FieldDescriptor> mFields;
+    std::vector<uint32_t> mFieldOffsets;
+    std::vector<unsigned char> mFieldMask;
+    uint32_t mFieldSchemaHash;
+    bool mFieldDirtyTracking;
+    bool mFieldSchemaErrorReported;
+
     static SharedData * mInstance;
     std::vector<unsigned char> dataBlock;
     std::vector<unsigned char> dataBlockToCompress;
@@ -189,6 +273,86 @@ void SharedData::writeVector(SharedVector<T> * vector)
         writeUCharArray(p, element_size * vector_size);
 }
 
+/*!
+Registers a SharedObject that is synchronized without encode and decode callbacks, see addField.
+*/
+template<class T>
+void SharedData::addField(unsigned int id, SharedObject<T> * sobj)
+{
+    addFieldDescriptor(id, sobj, static_cast<uint32_t>(sizeof(T)), &SharedData::appendFieldValue<SharedObject<T>, T>, &SharedData::setFieldValue<SharedObject<T>, T>);
+}
+
+/*!
+Registers a SharedVector that is synchronized without encode and decode callbacks, see addField.
+*/
+template<class T>
+void SharedData::addField(unsigned int id, SharedVector<T> * vector)
+{
+    addFieldDescriptor(id, vector, 0, &SharedData::appendFieldVector<T>, &SharedData::setFieldVector<T>);
+}
+
+/*!
+Registers a plain struct or array that is copied as is. The data is not protected by a mutex so it should only be
+modified by the thread that calls the pre sync callback. PODs that are registered with consecutive ids and are
+adjacent in memory, like the members of a struct, are copied with a single memcpy.
+*/
+template<class T>
+void SharedData::addPODField(unsigned int id, T * data)
+{
+    addFieldDescriptor(id, data, static_cast<uint32_t>(sizeof(T)), NULL, NULL);
+}
+
+template<class S, class V>
+void SharedData::appendFieldValue(void * field, std::vector<unsigned char> & buffer)
+{
+    V val = static_cast<S *>(field)->getVal();
+    unsigned char *p = reinterpret_cast<unsigned char *>(&val);
+    buffer.insert(buffer.end(), p, p + sizeof(V));
+}
+
+template<class S, class V>
+uint32_t SharedData::setFieldValue(void * field, const unsigned char * data, uint32_t length)
+{
+    if (length < sizeof(V))
+        return 0;
+
+    V val;
+    memcpy(&val, data, sizeof(V));
+    static_cast<S *>(field)->setVal(val);
+    return static_cast<uint32_t>(sizeof(V));
+}
+
+template<class T>
+void SharedData::appendFieldVector(void * field, std::vector<unsigned char> & buffer)
+{
+    std::vector<T> tmpVec = static_cast<SharedVector<T> *>(field)->getVal();
+    uint32_t vector_size = static_cast<uint32_t>(tmpVec.size());
+    unsigned char *p = reinterpret_cast<unsigned char *>(&vector_size);
+    buffer.insert(buffer.end(), p, p + sizeof(uint32_t));
+    if (vector_size > 0)
+    {
+        p = reinterpret_cast<unsigned char *>(&tmpVec[0]);
+        buffer.insert(buffer.end(), p, p + vector_size * sizeof(T));
+    }
+}
+
+template<class T>
+uint32_t SharedData::setFieldVector(void * field, const unsigned char * data, uint32_t length)
+{
+    uint32_t vector_size;
+    if (length < sizeof(uint32_t))
+        return 0;
+    memcpy(&vector_size, data, sizeof(uint32_t));
+    if (static_cast<uint64_t>(vector_size) * sizeof(T) > length - sizeof(uint32_t))
+        return 0;
+
+    std::vector<T> tmpVec(vector_size);
+    if (vector_size > 0)
+        memcpy(&tmpVec[0], data + sizeof(uint32_t), vector_size * sizeof(T));
+    static_cast<SharedVector<T> *>(field)->setVal(tmpVec);
+    return static_cast<uint32_t>(sizeof(uint32_t) + vector_size * sizeof(T));
+}
+
 template<class T>
 void SharedData::readVector(SharedVector<T> * vector)
 {
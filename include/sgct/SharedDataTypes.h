@@ -9,14 +9,17 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #define _SHARED_DATA_TYPES
 
 #include <mutex>
+#include <atomic>
 #include <stdint.h>
 #include <string>
 #include <vector>
+#include <type_traits>
+#include "helpers/SGCTSeqLock.h"
 
 namespace sgct //simple graphics cluster toolkit
 {    
     /*!
-    Mutex protected float for multi-thread data sharing
+    Lock-free float for multi-thread data sharing
     */
     class SharedFloat
     {
@@ -50,12 +53,11 @@ namespace sgct //simple graphics cluster toolkit
         float operator/(const float & val);
 
     private:
-        float mVal;
-        std::mutex mMutex;
+        std::atomic<float> mVal;
     };
 
     /*!
-    Mutex protected double for multi-thread data sharing
+    Lock-free double for multi-thread data sharing
     */
     class SharedDouble
     {
@@ -89,12 +91,11 @@ namespace sgct //simple graphics cluster toolkit
         double operator/( const double & val );
         
     private:
-        double mVal;
-        std::mutex mMutex;
+        std::atomic<double> mVal;
     };
 
     /*!
-    Mutex protected long for multi-thread data sharing
+    Lock-free int64 for multi-thread data sharing
     */
     class SharedInt64
     {
@@ -128,12 +129,11 @@ namespace sgct //simple graphics cluster toolkit
         int64_t operator/(const int64_t & val);
 
     private:
-        int64_t mVal;
-        std::mutex mMutex;
+        std::atomic<int64_t> mVal;
     };
 
     /*!
-    Mutex protected int for multi-thread data sharing
+    Lock-free int for multi-thread data sharing
     */
     class SharedInt32
     {
@@ -167,12 +167,11 @@ namespace sgct //simple graphics cluster toolkit
         int32_t operator/(const int32_t & val);
 
     private:
-        int32_t mVal;
-        std::mutex mMutex;
+        std::atomic<int32_t> mVal;
     };
 
     /*!
-    Mutex protected short/int16 for multi-thread data sharing
+    Lock-free short/int16 for multi-thread data sharing
     */
     class SharedInt16
     {
@@ -206,12 +205,11 @@ namespace sgct //simple graphics cluster toolkit
         int16_t operator/(const int16_t & val);
 
     private:
-        int16_t mVal;
-        std::mutex mMutex;
+        std::atomic<int16_t> mVal;
     };
 
     /*!
-    Mutex protected int8 for multi-thread data sharing
+    Lock-free int8 for multi-thread data sharing
     */
     class SharedInt8
     {
@@ -245,12 +243,11 @@ namespace sgct //simple graphics cluster toolkit
         int8_t operator/(const int8_t & val);
 
     private:
-        int8_t mVal;
-        std::mutex mMutex;
+        std::atomic<int8_t> mVal;
     };
 
     /*!
-    Mutex protected unsigned long for multi-thread data sharing
+    Lock-free unsigned int64 for multi-thread data sharing
     */
     class SharedUInt64
     {
@@ -284,12 +281,11 @@ namespace sgct //simple graphics cluster toolkit
         uint64_t operator/(const uint64_t & val);
 
     private:
-        uint64_t mVal;
-        std::mutex mMutex;
+        std::atomic<uint64_t> mVal;
     };
 
     /*!
-    Mutex protected unsigned int for multi-thread data sharing
+    Lock-free unsigned int for multi-thread data sharing
     */
     class SharedUInt32
     {
@@ -323,12 +319,11 @@ namespace sgct //simple graphics cluster toolkit
         uint32_t operator/(const uint32_t & val);
 
     private:
-        uint32_t mVal;
-        std::mutex mMutex;
+        std::atomic<uint32_t> mVal;
     };
 
     /*!
-    Mutex protected unsigned short/uint16 for multi-thread data sharing
+    Lock-free unsigned short/uint16 for multi-thread data sharing
     */
     class SharedUInt16
     {
@@ -362,12 +357,11 @@ namespace sgct //simple graphics cluster toolkit
         uint16_t operator/(const uint16_t & val);
 
     private:
-        uint16_t mVal;
-        std::mutex mMutex;
+        std::atomic<uint16_t> mVal;
     };
 
     /*!
-    Mutex protected unsigned uint8 for multi-thread data sharing
+    Lock-free unsigned uint8 for multi-thread data sharing
     */
     class SharedUInt8
     {
@@ -401,8 +395,7 @@ namespace sgct //simple graphics cluster toolkit
         uint8_t operator/(const uint8_t & val);
 
     private:
-        uint8_t mVal;
-        std::mutex mMutex;
+        std::atomic<uint8_t> mVal;
     };
 
     //backwards compability
@@ -410,7 +403,7 @@ namespace sgct //simple graphics cluster toolkit
     typedef SharedInt32 SharedInt;
 
     /*!
-    Mutex protected unsigned char for multi-thread data sharing
+    Lock-free unsigned char for multi-thread data sharing
     */
     class SharedUChar
     {
@@ -423,12 +416,11 @@ namespace sgct //simple graphics cluster toolkit
     private:
         SharedUChar( const SharedUChar & suc );
         const SharedUChar & operator=(const SharedUChar & suc );
-        unsigned char mVal;
-        std::mutex mMutex;
+        std::atomic<unsigned char> mVal;
     };
 
     /*!
-    Mutex protected bool for multi-thread data sharing
+    Lock-free bool for multi-thread data sharing
     */
     class SharedBool
     {
@@ -447,8 +439,7 @@ namespace sgct //simple graphics cluster toolkit
         bool operator!=( const bool & val );
 
     private:
-        bool mVal;
-        std::mutex mMutex;
+        std::atomic<bool> mVal;
     };
 
     /*!
@@ -496,40 +487,36 @@ namespace sgct //simple graphics cluster toolkit
 	};
 
     /*!
-    Mutex protected template for multi-thread data sharing
+    Template for multi-thread data sharing. Trivially copyable types like glm matrices are protected
+    by a sequence lock so that reads never block, other types by a mutex.
     */
     template <class T>
     class SharedObject
     {
     public:
         SharedObject() {;}
-        SharedObject(T val) { mVal = val; }
+        SharedObject(T val) : mVal(val) {;}
 
         T getVal()
         {
-            T tmpT;
-            mMutex.lock();
-            tmpT = mVal;
-            mMutex.unlock();
-            return tmpT;
+            return mVal.get();
         }
 
         void setVal(T val)
         {
-            mMutex.lock();
-            mVal = val;
-            mMutex.unlock();
+            mVal.set(val);
         }
 
     private:
         SharedObject( const SharedObject & so );
         const SharedObject & operator=(const SharedObject & so );
-        T mVal;
-        std::mutex mMutex;
+        typename std::conditional<std::is_trivially_copyable<T>::value,
+            sgct_helpers::SeqLockValue<T>, sgct_helpers::LockedValue<T> >::type mVal;
     };
 
     /*!
-    Mutex protected std::vector template for multi-thread data sharing
+    std::vector template for multi-thread data sharing. Trivially copyable element types are protected
+    by a sequence lock so that reads never block, other types by a mutex.
     */
     template <class T>
     class SharedVector
@@ -540,64 +527,46 @@ namespace sgct //simple graphics cluster toolkit
 
         T getValAt(std::size_t index)
         {
-            T tmpT;
-            mMutex.lock();
-            tmpT = mVector[ index ];
-            mMutex.unlock();
-            return tmpT;
+            return mVector.getAt(index);
         }
 
         std::vector<T> getVal()
         {
             std::vector<T> mCopy;
-            mMutex.lock();
-            mCopy = mVector;
-            mMutex.unlock();
+            mVector.get(mCopy);
             return mCopy;
         }
 
         void setValAt(std::size_t index, T val)
         {
-            mMutex.lock();
-            mVector[ index ] = val;
-            mMutex.unlock();
+            mVector.setAt(index, val);
         }
 
         void addVal(T val)
         {
-            mMutex.lock();
-            mVector.push_back(val);
-            mMutex.unlock();
+            mVector.add(val);
         }
 
         void setVal( std::vector<T> mCopy )
         {
-            mMutex.lock();
-            mVector.assign(mCopy.begin(), mCopy.end());
-            mMutex.unlock();
+            mVector.set(mCopy.empty() ? NULL : &mCopy[0], mCopy.size());
         }
 
         void clear()
         {
-            mMutex.lock();
             mVector.clear();
-            mMutex.unlock();
         }
 
         std::size_t getSize()
         {
-            std::size_t size = 0;
-            mMutex.lock();
-            size = mVector.size();
-            mMutex.unlock();
-            return size;
+            return mVector.size();
         }
 
     private:
         SharedVector( const SharedVector & sv );
         const SharedVector & operator=(const SharedVector & sv );
-        std::vector<T> mVector;
-        std::mutex mMutex;
+        typename std::conditional<std::is_trivially_copyable<T>::value,
+            sgct_helpers::SeqLockVector<T>, sgct_helpers::LockedVector<T> >::type mVector;
     };
 }
 
@@ -0,0 +1,71 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _TEXT_LAYOUT_H_
+#define _TEXT_LAYOUT_H_
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "helpers/SGCTCPPEleven.h"
+
+namespace sgct_text
+{
+enum TextAlignMode { TOP_LEFT, TOP_CENTER, TOP_RIGHT};
+
+/*!
+Metrics of a glyph in pixels and its location in the glyph atlas.
+*/
+class GlyphMetrics
+{
+public:
+    GlyphMetrics();
+
+    static const unsigned int NoPage = 0xFFFFFFFF;
+
+    float mDistToNextChar;
+    glm::vec2 mPos;
+    glm::vec2 mSize;
+    unsigned int mPage;
+    glm::vec2 mTexCoordMin;
+    glm::vec2 mTexCoordMax;
+};
+
+/*!
+Range of vertices in a TextMesh that use the same atlas page.
+*/
+struct TextBatch
+{
+    unsigned int page;
+    unsigned int first;
+    unsigned int count;
+};
+
+/*!
+Triangles of a laid out text with four floats per vertex, the texture coordinate followed by the position.
+The vertices are sorted by atlas page so that each page is drawn with a single call.
+*/
+class TextMesh
+{
+public:
+    static const unsigned int FloatsPerVertex = 4;
+
+    std::vector<float> mVertices;
+    std::vector<TextBatch> mBatches;
+
+    //! \returns the number of vertices
+    inline unsigned int getNumberOfVertices() const { return static_cast<unsigned int>(mVertices.size() / FloatsPerVertex); }
+};
+
+typedef sgct_cppxeleven::function<const GlyphMetrics * (wchar_t)> GlyphLookup;
+
+float getLineWidth(const std::wstring & line, const GlyphLookup & lookup);
+void layoutText(const std::vector<std::wstring> & lines, TextAlignMode mode, float lineHeight, const GlyphLookup & lookup, TextMesh & mesh);
+}
+
+#endif
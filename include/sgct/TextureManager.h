@@ -86,6 +86,7 @@ public:
     bool loadTexture(const std::string name, const std::string filename, bool interpolate, int mipmapLevels = 8);
     bool loadTexture(const std::string name, sgct_core::Image * imgPtr, bool interpolate, int mipmapLevels = 8);
     bool loadUnManagedTexture(unsigned int & texID, const std::string filename, bool interpolate, int mipmapLevels = 8);
+    bool loadUnManagedTexture(unsigned int & texID, sgct_core::Image * imgPtr, bool interpolate, int mipmapLevels = 8);
 
 private:
     TextureManager();
@@ -27,6 +27,8 @@ For conditions of distribution and use, see copyright notice in sgct.h
 
 namespace sgct_core
 {
+class Image;
+
 struct FrustumData {
     enum elemIdx {
         down = 0,
@@ -59,6 +61,7 @@ public:
     ~Viewport();
 
     void configure(tinyxml2::XMLElement * element);
+    void reconfigure(tinyxml2::XMLElement * element);
     void configureMpcdi(tinyxml2::XMLElement * element[], const char* val[], int winResX, int winResY);
     void setOverlayTexture(const char * texturePath);
     void setBlendMaskTexture(const char * texturePath);
@@ -66,13 +69,15 @@ public:
     void setCorrectionMesh(const char * meshPath);
     void setMpcdiWarpMesh(const char* meshData, size_t size);
     void setTracked(bool state);
-    void loadData();
+    void loadCPUData(float windowAspectRatio);
+    void loadData(float windowAspectRatio);
 
     void renderMesh(CorrectionMesh::MeshType mt);
 
     inline bool hasOverlayTexture() { return mOverlayTextureIndex != GL_FALSE; }
     inline bool hasBlendMaskTexture() { return mBlendMaskTextureIndex != GL_FALSE; }
     inline bool hasBlackLevelMaskTexture() { return mBlackLevelMaskTextureIndex != GL_FALSE; }
+    inline bool hasCombinedMaskTexture() { return mCombinedMaskTextureIndex != GL_FALSE; }
     inline bool hasSubViewports() { return mNonLinearProjection != NULL; }
 
     inline const bool & hasCorrectionMesh() { return mCorrectionMesh; }
@@ -80,8 +85,12 @@ public:
     inline const unsigned int & getOverlayTextureIndex() { return mOverlayTextureIndex; }
     inline const unsigned int & getBlendMaskTextureIndex() { return mBlendMaskTextureIndex; }
     inline const unsigned int & getBlackLevelMaskTextureIndex() { return mBlackLevelMaskTextureIndex; }
+    //! \returns the blend and black level masks pre-multiplied for the single pass compositor (see MaskCombiner)
+    inline const unsigned int & getCombinedMaskTextureIndex() { return mCombinedMaskTextureIndex; }
     inline CorrectionMesh * getCorrectionMeshPtr() { return &mCM; }
     inline NonLinearProjection * getNonLinearProjectionPtr() { return mNonLinearProjection; }
+    inline const double & getImageLoadTime() { return mImageLoadTime; }
+    inline const double & getMeshLoadTime() { return mMeshLoadTime; }
 
     char* mMpcdiWarpMeshData = nullptr;
     size_t mMpcdiWarpMeshSize = 0;
@@ -96,6 +105,8 @@ private:
                                  float& target);
     bool parseFrustumElement(FrustumData& frustum, FrustumData::elemIdx elemIndex,
         tinyxml2::XMLElement* elem, const char* frustumTag);
+    Image * loadImage(const std::string & filename);
+    void uploadImage(unsigned int & texID, Image ** imgPtr);
 private:
     CorrectionMesh mCM;
     std::string mOverlayFilename;
@@ -109,6 +120,16 @@ private:
     unsigned int mOverlayTextureIndex;
     unsigned int mBlendMaskTextureIndex;
     unsigned int mBlackLevelMaskTextureIndex;
+    unsigned int mCombinedMaskTextureIndex;
+
+    //decoded by loadCPUData and uploaded by loadData
+    Image * mOverlayImage;
+    Image * mBlendMaskImage;
+    Image * mBlackLevelMaskImage;
+    Image * mCombinedMaskImage;
+    bool mCPUDataLoaded;
+    double mImageLoadTime;
+    double mMeshLoadTime;
 
     NonLinearProjection * mNonLinearProjection;
 };
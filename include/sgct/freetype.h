@@ -23,8 +23,6 @@ For conditions of distribution and use, see copyright notice in sgct.h
 
 namespace sgct_text
 {
-enum TextAlignMode { TOP_LEFT, TOP_CENTER, TOP_RIGHT};
-
 void print(sgct_text::Font * ft_font, TextAlignMode mode, float x, float y, const char * format, ...);
 void print(sgct_text::Font * ft_font, TextAlignMode mode, float x, float y, const wchar_t * format, ...);
 void print3d(sgct_text::Font * ft_font, TextAlignMode mode, glm::mat4 mvp, const char *format, ...);
@@ -0,0 +1,166 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _SGCT_SIMD
+#define _SGCT_SIMD
+
+#include <math.h>
+#include <string.h>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define SGCT_USE_SSE 1
+    #include <xmmintrin.h>
+#else
+    #define SGCT_USE_SSE 0
+#endif
+
+#if SGCT_USE_SSE && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #define SGCT_USE_SSE2 1
+    #include <emmintrin.h>
+#else
+    #define SGCT_USE_SSE2 0
+#endif
+
+namespace sgct_helpers
+{
+
+#if SGCT_USE_SSE
+/*!
+    Four lanes of floats processed in parallel using SSE.
+*/
+struct Lanes
+{
+    __m128 v;
+    Lanes() {}
+    Lanes(__m128 val) : v(val) {}
+    explicit Lanes(float val) : v(_mm_set1_ps(val)) {}
+    static Lanes load(const float * src) { return Lanes(_mm_loadu_ps(src)); }
+    void store(float * dst) const { _mm_storeu_ps(dst, v); }
+};
+
+inline Lanes operator+(const Lanes & a, const Lanes & b) { return Lanes(_mm_add_ps(a.v, b.v)); }
+inline Lanes operator-(const Lanes & a, const Lanes & b) { return Lanes(_mm_sub_ps(a.v, b.v)); }
+inline Lanes operator*(const Lanes & a, const Lanes & b) { return Lanes(_mm_mul_ps(a.v, b.v)); }
+inline Lanes operator/(const Lanes & a, const Lanes & b) { return Lanes(_mm_div_ps(a.v, b.v)); }
+inline Lanes lanesSqrt(const Lanes & a) { return Lanes(_mm_sqrt_ps(a.v)); }
+inline Lanes lanesAbs(const Lanes & a) { return Lanes(_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)); }
+//! Returns a bit per lane (lane 0 in bit 0) that is set where a >= b
+inline unsigned int lanesGreaterEqualMask(const Lanes & a, const Lanes & b) { return static_cast<unsigned int>(_mm_movemask_ps(_mm_cmpge_ps(a.v, b.v))); }
+//! Transposes four 4-component rows into four lanes
+inline void lanesTranspose(const float * r0, const float * r1, const float * r2, const float * r3, Lanes & x, Lanes & y, Lanes & z, Lanes & w)
+{
+    __m128 a = _mm_loadu_ps(r0);
+    __m128 b = _mm_loadu_ps(r1);
+    __m128 c = _mm_loadu_ps(r2);
+    __m128 d = _mm_loadu_ps(r3);
+    _MM_TRANSPOSE4_PS(a, b, c, d);
+    x.v = a; y.v = b; z.v = c; w.v = d;
+}
+#else
+/*!
+    Scalar fallback with the same interface as the SSE version.
+*/
+struct Lanes
+{
+    float v[4];
+    Lanes() {}
+    explicit Lanes(float val) { v[0] = v[1] = v[2] = v[3] = val; }
+    static Lanes load(const float * src) { Lanes l; for (int i = 0; i < 4; i++) l.v[i] = src[i]; return l; }
+    void store(float * dst) const { for (int i = 0; i < 4; i++) dst[i] = v[i]; }
+};
+
+inline Lanes operator+(const Lanes & a, const Lanes & b) { Lanes r; for (int i = 0; i < 4; i++) r.v[i] = a.v[i] + b.v[i]; return r; }
+inline Lanes operator-(const Lanes & a, const Lanes & b) { Lanes r; for (int i = 0; i < 4; i++) r.v[i] = a.v[i] - b.v[i]; return r; }
+inline Lanes operator*(const Lanes & a, const Lanes & b) { Lanes r; for (int i = 0; i < 4; i++) r.v[i] = a.v[i] * b.v[i]; return r; }
+inline Lanes operator/(const Lanes & a, const Lanes & b) { Lanes r; for (int i = 0; i < 4; i++) r.v[i] = a.v[i] / b.v[i]; return r; }
+inline Lanes lanesSqrt(const Lanes & a) { Lanes r; for (int i = 0; i < 4; i++) r.v[i] = sqrtf(a.v[i]); return r; }
+inline Lanes lanesAbs(const Lanes & a) { Lanes r; for (int i = 0; i < 4; i++) r.v[i] = fabsf(a.v[i]); return r; }
+//! Returns a bit per lane (lane 0 in bit 0) that is set where a >= b
+inline unsigned int lanesGreaterEqualMask(const Lanes & a, const Lanes & b)
+{
+    unsigned int mask = 0;
+    for (int i = 0; i < 4; i++)
+        if (a.v[i] >= b.v[i])
+            mask |= (1u << i);
+    return mask;
+}
+//! Transposes four 4-component rows into four lanes
+inline void lanesTranspose(const float * r0, const float * r1, const float * r2, const float * r3, Lanes & x, Lanes & y, Lanes & z, Lanes & w)
+{
+    const float * rows[4] = { r0, r1, r2, r3 };
+    for (int i = 0; i < 4; i++)
+    {
+        x.v[i] = rows[i][0];
+        y.v[i] = rows[i][1];
+        z.v[i] = rows[i][2];
+        w.v[i] = rows[i][3];
+    }
+}
+#endif
+
+#if SGCT_USE_SSE2
+//! Loads four unsigned bytes, for example an RGBA texel, as floats
+inline Lanes lanesLoad(const unsigned char * src)
+{
+    int packed;
+    memcpy(&packed, src, sizeof(int));
+    __m128i zero = _mm_setzero_si128();
+    __m128i val = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero), zero);
+    return Lanes(_mm_cvtepi32_ps(val));
+}
+
+//! Loads four unsigned shorts, for example a 16 bit RGBA texel, as floats
+inline Lanes lanesLoad(const unsigned short * src)
+{
+    __m128i val = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src)), _mm_setzero_si128());
+    return Lanes(_mm_cvtepi32_ps(val));
+}
+#else
+//! Loads four unsigned integers, for example an RGBA texel, as floats
+template <class T>
+inline Lanes lanesLoad(const T * src)
+{
+    float tmp[4] = { static_cast<float>(src[0]), static_cast<float>(src[1]), static_cast<float>(src[2]), static_cast<float>(src[3]) };
+    return Lanes::load(tmp);
+}
+#endif
+
+/*!
+    Three component vectors stored as four lanes per component.
+*/
+struct Vec3Lanes
+{
+    Lanes x, y, z;
+};
+
+inline Vec3Lanes sub(const Vec3Lanes & a, const Vec3Lanes & b)
+{
+    Vec3Lanes r = { a.x - b.x, a.y - b.y, a.z - b.z };
+    return r;
+}
+
+inline Lanes dot(const Vec3Lanes & a, const Vec3Lanes & b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+inline Vec3Lanes cross(const Vec3Lanes & a, const Vec3Lanes & b)
+{
+    Vec3Lanes r = { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+    return r;
+}
+
+inline Vec3Lanes normalize(const Vec3Lanes & a)
+{
+    Lanes invLength = Lanes(1.0f) / lanesSqrt(dot(a, a));
+    Vec3Lanes r = { a.x * invLength, a.y * invLength, a.z * invLength };
+    return r;
+}
+
+}
+
+#endif
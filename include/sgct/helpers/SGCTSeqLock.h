@@ -0,0 +1,355 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _SGCT_SEQ_LOCK
+#define _SGCT_SEQ_LOCK
+
+#include <stddef.h>
+#include <string.h>
+#include <new>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sgct_helpers
+{
+
+/*!
+    Sequence lock for data that is read much more often than it is written. Readers never
+    block writers and never write to shared memory, they copy the data and retry if a writer
+    was active during the copy. Writers are serialized with each other.
+
+    Only use it for trivially copyable data since readers may copy a half written value
+    before retrying.
+*/
+class SeqLock
+{
+public:
+    SeqLock() : mSequence(0) {}
+
+    //! Waits until no writer is active and returns the sequence to pass to readRetry
+    unsigned int readBegin() const
+    {
+        unsigned int seq;
+        unsigned int spins = 0;
+        while ((seq = mSequence.load(std::memory_order_acquire)) & 1u)
+            if (++spins % 64 == 0)
+                std::this_thread::yield();
+        return seq;
+    }
+
+    //! \returns true if a writer modified the data since readBegin and the read must be repeated
+    bool readRetry(unsigned int seq) const
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return mSequence.load(std::memory_order_relaxed) != seq;
+    }
+
+    void writeLock()
+    {
+        unsigned int spins = 0;
+        unsigned int seq = mSequence.load(std::memory_order_relaxed);
+        while ((seq & 1u) || !mSequence.compare_exchange_weak(seq, seq + 1u, std::memory_order_acquire, std::memory_order_relaxed))
+        {
+            if (++spins % 64 == 0)
+                std::this_thread::yield();
+            seq = mSequence.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void writeUnlock()
+    {
+        mSequence.fetch_add(1u, std::memory_order_release);
+    }
+
+private:
+    SeqLock(const SeqLock & sl);
+    const SeqLock & operator=(const SeqLock & sl);
+
+    std::atomic<unsigned int> mSequence;
+};
+
+/*!
+    Single value protected by a SeqLock, T must be trivially copyable.
+*/
+template <class T>
+class SeqLockValue
+{
+public:
+    SeqLockValue() {;}
+    SeqLockValue(const T & val) : mVal(val) {;}
+
+    T get() const
+    {
+        T tmpT;
+        unsigned int seq;
+        do
+        {
+            seq = mLock.readBegin();
+            memcpy(&tmpT, &mVal, sizeof(T));
+        } while (mLock.readRetry(seq));
+        return tmpT;
+    }
+
+    void set(const T & val)
+    {
+        mLock.writeLock();
+        memcpy(&mVal, &val, sizeof(T));
+        mLock.writeUnlock();
+    }
+
+private:
+    T mVal;
+    mutable SeqLock mLock;
+};
+
+/*!
+    Growable array protected by a SeqLock, T must be trivially copyable.
+
+    The capacity grows geometrically. Buffers that are replaced when the array grows are retired
+    instead of freed since a reader racing with the writer may still copy from them. Readers
+    register in a reader count while they copy, and a writer frees the retired buffers once it
+    sees no active readers, since every reader starting after that loads the current buffer.
+    Until then the retired buffers use less memory than the current one.
+*/
+template <class T>
+class SeqLockVector
+{
+public:
+    SeqLockVector() : mData(NULL), mSize(0), mCapacity(0), mReaders(0) {;}
+    ~SeqLockVector()
+    {
+        for (std::size_t i = 0; i < mRetired.size(); i++)
+            ::operator delete(mRetired[i]);
+        ::operator delete(mData.load(std::memory_order_relaxed));
+    }
+
+    //! \returns the number of replaced buffers that are waiting for readers to finish, only valid on the writer thread
+    std::size_t getNumberOfRetiredBuffers() const
+    {
+        return mRetired.size();
+    }
+
+    void reserve(std::size_t size)
+    {
+        mLock.writeLock();
+        grow(size);
+        reclaim();
+        mLock.writeUnlock();
+    }
+
+    T getAt(std::size_t index) const
+    {
+        T tmpT;
+        unsigned int seq;
+        mReaders.fetch_add(1u);
+        do
+        {
+            seq = mLock.readBegin();
+            memcpy(&tmpT, mData.load() + index, sizeof(T));
+        } while (mLock.readRetry(seq));
+        mReaders.fetch_sub(1u, std::memory_order_release);
+        return tmpT;
+    }
+
+    void get(std::vector<T> & copy) const
+    {
+        unsigned int seq;
+        mReaders.fetch_add(1u);
+        do
+        {
+            seq = mLock.readBegin();
+            std::size_t size = mSize.load(std::memory_order_acquire);
+            const T * data = mData.load();
+            copy.resize(size);
+            if (size > 0)
+                memcpy(&copy[0], data, size * sizeof(T));
+        } while (mLock.readRetry(seq));
+        mReaders.fetch_sub(1u, std::memory_order_release);
+    }
+
+    std::size_t size() const
+    {
+        return mSize.load(std::memory_order_acquire);
+    }
+
+    void setAt(std::size_t index, const T & val)
+    {
+        mLock.writeLock();
+        memcpy(mData.load(std::memory_order_relaxed) + index, &val, sizeof(T));
+        reclaim();
+        mLock.writeUnlock();
+    }
+
+    void add(const T & val)
+    {
+        mLock.writeLock();
+        std::size_t size = mSize.load(std::memory_order_relaxed);
+        if (size == mCapacity)
+            grow(size < 4 ? 4 : size + 1);
+        memcpy(mData.load(std::memory_order_relaxed) + size, &val, sizeof(T));
+        mSize.store(size + 1, std::memory_order_release);
+        reclaim();
+        mLock.writeUnlock();
+    }
+
+    void set(const T * data, std::size_t size)
+    {
+        mLock.writeLock();
+        if (size > mCapacity)
+            grow(size);
+        if (size > 0)
+            memcpy(mData.load(std::memory_order_relaxed), data, size * sizeof(T));
+        mSize.store(size, std::memory_order_release);
+        reclaim();
+        mLock.writeUnlock();
+    }
+
+    void clear()
+    {
+        mLock.writeLock();
+        mSize.store(0, std::memory_order_release);
+        reclaim();
+        mLock.writeUnlock();
+    }
+
+private:
+    SeqLockVector(const SeqLockVector & slv);
+    const SeqLockVector & operator=(const SeqLockVector & slv);
+
+    //must be called with the write lock held, grows to at least twice the current capacity
+    void grow(std::size_t capacity)
+    {
+        if (capacity <= mCapacity)
+            return;
+        if (capacity < mCapacity * 2)
+            capacity = mCapacity * 2;
+
+        T * oldData = mData.load(std::memory_order_relaxed);
+        T * newData = static_cast<T *>(::operator new(capacity * sizeof(T)));
+        std::size_t size = mSize.load(std::memory_order_relaxed);
+        if (size > 0)
+            memcpy(newData, oldData, size * sizeof(T));
+
+        mData.store(newData); //sequentially consistent with the reader count check in reclaim
+        if (oldData != NULL)
+            mRetired.push_back(oldData);
+        mCapacity = capacity;
+    }
+
+    //must be called with the write lock held
+    void reclaim()
+    {
+        //readers load the buffer after registering, so with no registered readers nobody can use a retired buffer
+        if (mRetired.empty() || mReaders.load() != 0)
+            return;
+
+        for (std::size_t i = 0; i < mRetired.size(); i++)
+            ::operator delete(mRetired[i]);
+        mRetired.clear();
+    }
+
+    std::atomic<T *> mData;
+    std::atomic<std::size_t> mSize;
+    std::size_t mCapacity;
+    std::vector<T *> mRetired;
+    mutable std::atomic<unsigned int> mReaders;
+    mutable SeqLock mLock;
+};
+
+/*!
+    Mutex protected value with the same interface as SeqLockValue for types that are not trivially copyable.
+*/
+template <class T>
+class LockedValue
+{
+public:
+    LockedValue() {;}
+    LockedValue(const T & val) : mVal(val) {;}
+
+    T get() const
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        return mVal;
+    }
+
+    void set(const T & val)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mVal = val;
+    }
+
+private:
+    T mVal;
+    mutable std::mutex mMutex;
+};
+
+/*!
+    Mutex protected array with the same interface as SeqLockVector for types that are not trivially copyable.
+*/
+template <class T>
+class LockedVector
+{
+public:
+    void reserve(std::size_t size)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mVector.reserve(size);
+    }
+
+    T getAt(std::size_t index) const
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        return mVector[index];
+    }
+
+    void get(std::vector<T> & copy) const
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        copy = mVector;
+    }
+
+    std::size_t size() const
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        return mVector.size();
+    }
+
+    void setAt(std::size_t index, const T & val)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mVector[index] = val;
+    }
+
+    void add(const T & val)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mVector.push_back(val);
+    }
+
+    void set(const T * data, std::size_t size)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mVector.assign(data, data + size);
+    }
+
+    void clear()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mVector.clear();
+    }
+
+private:
+    std::vector<T> mVector;
+    mutable std::mutex mMutex;
+};
+
+}
+
+#endif
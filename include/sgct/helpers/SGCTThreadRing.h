@@ -0,0 +1,145 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#ifndef _SGCT_THREAD_RING
+#define _SGCT_THREAD_RING
+
+#include <stddef.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace sgct_helpers
+{
+
+/*!
+    Single producer, single consumer ring buffer of T. One thread appends elements and one consumer thread reads
+    them, neither of them ever blocks. The positions are never wrapped, only the offsets into the data, so the
+    number of elements in the ring is always head - tail. The size must be a power of two.
+
+    The producer writes at getHead() and publishes the new head, the consumer reads from getTail() up to
+    getPublishedHead() and releases the elements it has read. Elements that don't fit are counted as dropped
+    by the producer and collected by the consumer.
+
+    A ring that is abandoned by its producer, for example because the thread has exited, can be released by the
+    consumer once it is drained, see ThreadRingOwner.
+*/
+template <class T>
+class ThreadRing
+{
+public:
+    ThreadRing(std::size_t size) : mData(size), mHead(0), mTail(0), mDropped(0), mAbandoned(false) {;}
+
+    //! \returns the number of elements the ring can hold
+    inline std::size_t getSize() const { return mData.size(); }
+
+    //producer
+
+    //! \returns the position of the next element to write, only valid on the producer thread
+    inline unsigned long long getHead() const { return mHead.load(std::memory_order_relaxed); }
+    //! \returns the number of elements that can be written at the head
+    inline std::size_t getFreeSpace() const
+    {
+        return mData.size() - static_cast<std::size_t>(mHead.load(std::memory_order_relaxed) - mTail.load(std::memory_order_acquire));
+    }
+    //! \returns the number of elements that are written but not yet read, an estimate on the producer thread
+    inline std::size_t getUsedSpace() const
+    {
+        return static_cast<std::size_t>(mHead.load(std::memory_order_relaxed) - mTail.load(std::memory_order_relaxed));
+    }
+
+    void write(unsigned long long pos, const T * src, std::size_t count)
+    {
+        std::size_t offset = static_cast<std::size_t>(pos & (mData.size() - 1));
+        std::size_t first = (std::min)(count, mData.size() - offset);
+        std::copy(src, src + first, mData.begin() + offset);
+        std::copy(src + first, src + count, mData.begin());
+    }
+
+    //! Makes the elements up to head visible to the consumer
+    inline void publish(unsigned long long head) { mHead.store(head, std::memory_order_release); }
+    inline void drop() { mDropped++; }
+
+    //consumer
+
+    //! \returns the position of the next element to read, only valid on the consumer thread
+    inline unsigned long long getTail() const { return mTail.load(std::memory_order_relaxed); }
+    //! \returns the end of the published elements
+    inline unsigned long long getPublishedHead() const { return mHead.load(std::memory_order_acquire); }
+
+    void read(unsigned long long pos, T * dst, std::size_t count) const
+    {
+        std::size_t offset = static_cast<std::size_t>(pos & (mData.size() - 1));
+        std::size_t first = (std::min)(count, mData.size() - offset);
+        std::copy(mData.begin() + offset, mData.begin() + offset + first, dst);
+        std::copy(mData.begin(), mData.begin() + (count - first), dst + first);
+    }
+
+    inline const T & at(unsigned long long pos) const { return mData[static_cast<std::size_t>(pos & (mData.size() - 1))]; }
+
+    //! Gives the elements up to tail back to the producer
+    inline void release(unsigned long long tail) { mTail.store(tail, std::memory_order_release); }
+    //! \returns the number of dropped elements since the last call
+    inline unsigned int takeDropped() { return mDropped.exchange(0); }
+
+    inline void abandon() { mAbandoned = true; }
+    //! Read before getPublishedHead so that no element is missed after the producer abandons the ring
+    inline bool isAbandoned() const { return mAbandoned.load(); }
+
+private:
+    ThreadRing(const ThreadRing & tr);
+    const ThreadRing & operator=(const ThreadRing & tr);
+
+    std::vector<T> mData;
+    std::atomic<unsigned long long> mHead; //written by the producer
+    std::atomic<unsigned long long> mTail; //written by the consumer
+    std::atomic<unsigned int> mDropped;
+    std::atomic<bool> mAbandoned;
+};
+
+/*!
+    Thread local handle to the ring of the calling thread, Ring is a ThreadRing or derived from one. The ring is
+    marked as abandoned when the thread exits or when a ring of a new generation replaces it, for example after
+    the consumer was restarted, so that the consumer can release it once it is drained.
+
+    Typical use is a function local static thread_local ThreadRingOwner.
+*/
+template <class Ring>
+class ThreadRingOwner
+{
+public:
+    ThreadRingOwner() : mGeneration(0) {;}
+    ~ThreadRingOwner()
+    {
+        if (mRing)
+            mRing->abandon();
+    }
+
+    //! \returns true if the thread has a ring of the given generation
+    inline bool hasRing(unsigned int generation) const { return mRing && mGeneration == generation; }
+    inline const std::shared_ptr<Ring> & getRing() const { return mRing; }
+
+    void setRing(const std::shared_ptr<Ring> & ring, unsigned int generation)
+    {
+        if (mRing)
+            mRing->abandon();
+        mRing = ring;
+        mGeneration = generation;
+    }
+
+private:
+    ThreadRingOwner(const ThreadRingOwner & tro);
+    const ThreadRingOwner & operator=(const ThreadRingOwner & tro);
+
+    std::shared_ptr<Ring> mRing;
+    unsigned int mGeneration;
+};
+
+}
+
+#endif
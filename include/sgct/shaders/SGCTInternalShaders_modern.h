@@ -76,6 +76,74 @@ namespace sgct_core
                 Color = texture(Tex, UV);\n\
             }\n";
 
+        /*
+            Single pass compositor, ViewportRect is x, y, 1/width and 1/height of the viewport in normalized window coordinates
+        */
+        const std::string Compositor_Vert_Shader = "\
+            **glsl_version**\n\
+            \n\
+            layout (location = 0) in vec2 Position;\n\
+            layout (location = 1) in vec2 TexCoords;\n\
+            layout (location = 2) in vec4 VertColor;\n\
+            \n\
+            uniform vec4 ViewportRect;\n\
+            \n\
+            out vec2 UV;\n\
+            out vec2 OverlayUV;\n\
+            out vec2 MaskUV;\n\
+            out vec4 Col;\n\
+            \n\
+            void main()\n\
+            {\n\
+               gl_Position = vec4(Position, 0.0, 1.0);\n\
+               UV = TexCoords;\n\
+               OverlayUV = (TexCoords - ViewportRect.xy) * ViewportRect.zw;\n\
+               MaskUV = (Position * 0.5 + 0.5 - ViewportRect.xy) * ViewportRect.zw;\n\
+               Col = VertColor;\n\
+            }\n";
+
+        const std::string Compositor_Frag_Shader = "\
+            **glsl_version**\n\
+            \n\
+            in vec2 UV;\n\
+            in vec2 OverlayUV;\n\
+            in vec2 MaskUV;\n\
+            in vec4 Col;\n\
+            out vec4 Color;\n\
+            \n\
+            uniform sampler2D Tex;\n\
+            uniform sampler2D MaskTex;\n\
+            uniform sampler2D OverlayTex;\n\
+            uniform int UseMask;\n\
+            uniform int UseOverlay;\n\
+            uniform int UseColorCorrection;\n\
+            uniform vec3 ColorCorrection;\n\
+            \n\
+            bool inside(vec2 uv)\n\
+            {\n\
+                return all(greaterThanEqual(uv, vec2(0.0))) && all(lessThanEqual(uv, vec2(1.0)));\n\
+            }\n\
+            \n\
+            void main()\n\
+            {\n\
+                Color = Col * texture(Tex, UV);\n\
+                if (UseOverlay != 0 && inside(OverlayUV))\n\
+                {\n\
+                    vec4 overlay = texture(OverlayTex, OverlayUV);\n\
+                    Color.rgb = mix(Color.rgb, overlay.rgb, overlay.a);\n\
+                }\n\
+                if (UseMask != 0 && inside(MaskUV))\n\
+                {\n\
+                    vec4 mask = texture(MaskTex, MaskUV);\n\
+                    Color.rgb = Color.rgb * mask.rgb + vec3(mask.a);\n\
+                }\n\
+                if (UseColorCorrection != 0)\n\
+                {\n\
+                    vec3 c = (Color.rgb - 0.5) * ColorCorrection.y + 0.5 + (ColorCorrection.z - 1.0);\n\
+                    Color.rgb = pow(clamp(c, 0.0, 1.0), vec3(ColorCorrection.x));\n\
+                }\n\
+            }\n";
+
         const std::string Anaglyph_Vert_Shader = "\
             **glsl_version**\n\
             \n\
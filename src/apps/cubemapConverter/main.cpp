@@ -0,0 +1,296 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <new>
+#include <system_error>
+#include "sgct.h"
+#include <sgct/Image.h>
+#include <sgct/CubemapConverter.h>
+
+/*
+Converts cubemap images to fisheye or equirectangular images without OpenGL.
+
+Example:
+cubemapConverter -faces right_%04d.png left_%04d.png top_%04d.png bottom_%04d.png front_%04d.png back_%04d.png
+    -seq 0 99 -out fisheye_%04d.png -res 2048 -fov 180
+
+The faces are given in the order +X, -X, +Y, -Y, +Z, -Z, use none for a face that isn't rendered.
+The paths are printf patterns that get the frame number when -seq is used.
+The next frame is loaded while the current frame is converted and saved.
+*/
+
+std::string facePatterns[6];
+std::string outputPattern;
+int startIndex = 0;
+int stopIndex = 0;
+std::size_t width = 2048;
+std::size_t height = 0;
+
+void printUsage();
+std::string getFramePath(const std::string & pattern, int frame);
+void loadFaces(int frame, sgct_core::Image ** faces, bool * result);
+void deleteFaces(sgct_core::Image ** faces);
+
+int main( int argc, char* argv[] )
+{
+    sgct_core::CubemapConverter converter;
+    bool hasFaces = false;
+
+    //parse arguments
+    for( int i = 1; i < argc; i++ )
+    {
+        if( strcmp(argv[i], "-faces") == 0 && argc > (i+6) )
+        {
+            for (int j = 0; j < 6; j++)
+                facePatterns[j] = std::string(argv[i + 1 + j]);
+            hasFaces = true;
+            i += 6;
+        }
+        else if( strcmp(argv[i], "-seq") == 0 && argc > (i+2) )
+        {
+            startIndex = atoi( argv[i+1] );
+            stopIndex = atoi( argv[i+2] );
+            i += 2;
+        }
+        else if (strcmp(argv[i], "-out") == 0 && argc > (i + 1))
+        {
+            outputPattern = std::string(argv[i + 1]);
+            i++;
+        }
+        else if (strcmp(argv[i], "-res") == 0 && argc > (i + 1))
+        {
+            width = static_cast<std::size_t>(atoi(argv[i + 1]));
+            i++;
+            if (argc > (i + 1) && argv[i + 1][0] != '-')
+            {
+                height = static_cast<std::size_t>(atoi(argv[i + 1]));
+                i++;
+            }
+        }
+        else if (strcmp(argv[i], "-mapping") == 0 && argc > (i + 1))
+        {
+            converter.setMapping(strcmp(argv[i + 1], "equirect") == 0 ? sgct_core::CubemapConverter::Equirectangular : sgct_core::CubemapConverter::Fisheye);
+            i++;
+        }
+        else if (strcmp(argv[i], "-fov") == 0 && argc > (i + 1))
+        {
+            converter.setFOV(static_cast<float>(atof(argv[i + 1])));
+            i++;
+        }
+        else if (strcmp(argv[i], "-tilt") == 0 && argc > (i + 1))
+        {
+            converter.setTilt(static_cast<float>(atof(argv[i + 1])));
+            i++;
+        }
+        else if (strcmp(argv[i], "-crop") == 0 && argc > (i + 4))
+        {
+            converter.setCropFactors(
+                static_cast<float>(atof(argv[i + 1])),
+                static_cast<float>(atof(argv[i + 2])),
+                static_cast<float>(atof(argv[i + 3])),
+                static_cast<float>(atof(argv[i + 4])));
+            i += 4;
+        }
+        else if (strcmp(argv[i], "-offset") == 0 && argc > (i + 3))
+        {
+            converter.setOffset(glm::vec3(
+                static_cast<float>(atof(argv[i + 1])),
+                static_cast<float>(atof(argv[i + 2])),
+                static_cast<float>(atof(argv[i + 3]))));
+            i += 3;
+        }
+        else if (strcmp(argv[i], "-orientation") == 0 && argc > (i + 3))
+        {
+            converter.setRigOrientation(glm::vec3(
+                static_cast<float>(atof(argv[i + 1])),
+                static_cast<float>(atof(argv[i + 2])),
+                static_cast<float>(atof(argv[i + 3]))));
+            i += 3;
+        }
+        else if (strcmp(argv[i], "-layout") == 0 && argc > (i + 1))
+        {
+            if (strcmp(argv[i + 1], "fourFace") == 0)
+                converter.setFaceLayout(sgct_core::CubemapConverter::FourFaceRigLayout);
+            else if (strcmp(argv[i + 1], "fiveSixFace") == 0)
+                converter.setFaceLayout(sgct_core::CubemapConverter::FiveOrSixFaceRigLayout);
+            else
+                converter.setFaceLayout(sgct_core::CubemapConverter::CubeLayout);
+            i++;
+        }
+        else if (strcmp(argv[i], "-cubic") == 0 && argc > (i + 1))
+        {
+            converter.setInterpolation(strcmp(argv[i + 1], "1") == 0 ? sgct_core::CubemapConverter::Bicubic : sgct_core::CubemapConverter::Bilinear);
+            i++;
+        }
+        else if (strcmp(argv[i], "-threads") == 0 && argc > (i + 1))
+        {
+            converter.setNumberOfThreads(static_cast<unsigned int>(atoi(argv[i + 1])));
+            i++;
+        }
+        else if (strcmp(argv[i], "-bg") == 0 && argc > (i + 4))
+        {
+            converter.setBackgroundColor(glm::vec4(
+                static_cast<float>(atof(argv[i + 1])),
+                static_cast<float>(atof(argv[i + 2])),
+                static_cast<float>(atof(argv[i + 3])),
+                static_cast<float>(atof(argv[i + 4]))));
+            i += 4;
+        }
+        else if (strcmp(argv[i], "-compression") == 0 && argc > (i + 1))
+        {
+            sgct::SGCTSettings::instance()->setPNGCompressionLevel(atoi(argv[i + 1]));
+            i++;
+        }
+        else
+        {
+            sgct::MessageHandler::instance()->print("Unknown argument: %s\n", argv[i]);
+            printUsage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!hasFaces || outputPattern.empty() || width == 0 || stopIndex < startIndex)
+    {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    //equirectangular images are twice as wide as high and fisheyes are square by default
+    if (height == 0)
+        height = converter.getMapping() == sgct_core::CubemapConverter::Equirectangular ? width / 2 : width;
+
+    sgct_core::Image * currentFaces[6] = { NULL, NULL, NULL, NULL, NULL, NULL };
+    sgct_core::Image * nextFaces[6] = { NULL, NULL, NULL, NULL, NULL, NULL };
+    bool currentLoaded = false;
+    bool nextLoaded = false;
+    int result = EXIT_SUCCESS;
+
+    loadFaces(startIndex, currentFaces, &currentLoaded);
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for (int frame = startIndex; frame <= stopIndex; frame++)
+    {
+        //decode the next frame while this one is converted and encoded
+        std::thread * prefetchThread = NULL;
+        if (frame < stopIndex)
+        {
+            try
+            {
+                prefetchThread = new (std::nothrow) std::thread(loadFaces, frame + 1, nextFaces, &nextLoaded);
+            }
+            catch (const std::system_error &)
+            {
+                prefetchThread = NULL; //loaded on this thread below
+            }
+        }
+
+        if (currentLoaded)
+        {
+            sgct_core::Image output;
+            output.setSize(width, height);
+            std::string outputPath = getFramePath(outputPattern, frame);
+            if (converter.convert(currentFaces, &output))
+            {
+                output.setFilename(outputPath);
+                if (output.save())
+                    sgct::MessageHandler::instance()->print("Saved frame %d to '%s'\n", frame, outputPath.c_str());
+                else
+                    result = EXIT_FAILURE;
+            }
+            else
+                result = EXIT_FAILURE;
+        }
+        else
+        {
+            sgct::MessageHandler::instance()->print("Failed to load the faces of frame %d!\n", frame);
+            result = EXIT_FAILURE;
+        }
+
+        if (prefetchThread != NULL)
+        {
+            prefetchThread->join();
+            delete prefetchThread;
+        }
+        else if (frame < stopIndex)
+            loadFaces(frame + 1, nextFaces, &nextLoaded);
+
+        deleteFaces(currentFaces);
+        for (int i = 0; i < 6; i++)
+        {
+            currentFaces[i] = nextFaces[i];
+            nextFaces[i] = NULL;
+        }
+        currentLoaded = nextLoaded;
+        nextLoaded = false;
+    }
+
+    deleteFaces(currentFaces);
+    sgct::MessageHandler::instance()->print("Converted %d frame(s) in %.2f s\n", stopIndex - startIndex + 1,
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+
+    sgct::SGCTSettings::destroy();
+    sgct::MessageHandler::destroy();
+
+    return result;
+}
+
+void printUsage()
+{
+    sgct::MessageHandler::instance()->print("Usage: cubemapConverter -faces <+X> <-X> <+Y> <-Y> <+Z> <-Z> -out <path> [options]\n");
+    sgct::MessageHandler::instance()->print("Options:\n");
+    sgct::MessageHandler::instance()->print("  -seq <start> <stop>         frame range, the paths are printf patterns like face_%%04d.png\n");
+    sgct::MessageHandler::instance()->print("  -res <width> [height]       output resolution\n");
+    sgct::MessageHandler::instance()->print("  -mapping <fisheye|equirect> output mapping\n");
+    sgct::MessageHandler::instance()->print("  -fov <degrees>              fisheye field of view\n");
+    sgct::MessageHandler::instance()->print("  -tilt <degrees>             rotation of the lookup about the x-axis\n");
+    sgct::MessageHandler::instance()->print("  -crop <l> <r> <b> <t>       fisheye crop factors\n");
+    sgct::MessageHandler::instance()->print("  -offset <x> <y> <z>         fisheye lens offset\n");
+    sgct::MessageHandler::instance()->print("  -orientation <p> <y> <r>    rig orientation in degrees\n");
+    sgct::MessageHandler::instance()->print("  -layout <cube|fourFace|fiveSixFace> face layout\n");
+    sgct::MessageHandler::instance()->print("  -cubic <0|1>                bicubic interpolation\n");
+    sgct::MessageHandler::instance()->print("  -threads <n>                number of threads, 0 uses all cores\n");
+    sgct::MessageHandler::instance()->print("  -bg <r> <g> <b> <a>         background color\n");
+    sgct::MessageHandler::instance()->print("  -compression <level>        PNG compression level\n");
+}
+
+std::string getFramePath(const std::string & pattern, int frame)
+{
+    char buffer[1024];
+#if (_MSC_VER >= 1400) //visual studio 2005 or later
+    _snprintf_s(buffer, 1024, _TRUNCATE, pattern.c_str(), frame);
+#else
+    snprintf(buffer, 1024, pattern.c_str(), frame);
+#endif
+    return std::string(buffer);
+}
+
+void loadFaces(int frame, sgct_core::Image ** faces, bool * result)
+{
+    *result = true;
+    for (int i = 0; i < 6; i++)
+    {
+        faces[i] = NULL;
+        if (facePatterns[i] == "none")
+            continue;
+
+        faces[i] = new sgct_core::Image();
+        if (!faces[i]->load(getFramePath(facePatterns[i], frame)))
+        {
+            delete faces[i];
+            faces[i] = NULL;
+            *result = false;
+        }
+    }
+}
+
+void deleteFaces(sgct_core::Image ** faces)
+{
+    for (int i = 0; i < 6; i++)
+    {
+        delete faces[i];
+        faces[i] = NULL;
+    }
+}
@@ -0,0 +1,384 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include "sgct.h"
+#include <sgct/Image.h>
+#include <sgct/CubemapConverter.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+/*
+Checks the CPU cubemap converter (sgct_core::CubemapConverter) against the GL path. The reference is the
+lookup of getCubeSample in the fisheye shaders with the rotVec of FisheyeProjection and SpoutOutputProjection
+and the face selection of textureCube from the OpenGL specification, written out with glm. The faces are
+labelled with their face index and linear ramps of the face texture coordinates, which both the bilinear
+and the bicubic filter reproduce exactly, so every converted texel can be compared against the face and the
+coordinate the shader would have sampled. The process returns EXIT_FAILURE if any check fails.
+*/
+
+const std::size_t FaceSize = 64;
+const float Tolerance = 8.0f; //in 16 bit units
+unsigned int numberOfFailures = 0;
+
+enum ReferenceLayout { SpoutRig = 0, FourFace, FiveOrSixFace };
+
+struct Setup
+{
+    const char * name;
+    sgct_core::CubemapConverter::Mapping mapping;
+    ReferenceLayout layout;
+    float fov;
+    float crop[4];
+    glm::vec3 offset;
+    glm::vec3 rigOrientation;
+    sgct_core::CubemapConverter::Interpolation interpolation;
+    std::size_t width;
+    std::size_t height;
+};
+
+void check(bool condition, const char * setup, const char * test)
+{
+    if (!condition)
+    {
+        sgct::MessageHandler::instance()->print("FAILED: %s: %s\n", setup, test);
+        numberOfFailures++;
+    }
+}
+
+/*!
+The direction that getCubeSample looks up, including the rotVec replacement of the projection.
+\returns false where the shader returns the background color
+*/
+bool getShaderDirection(const Setup & setup, float s, float t, glm::vec3 & rotVec)
+{
+    float x, y, z;
+    if (setup.mapping == sgct_core::CubemapConverter::Equirectangular)
+    {
+        //sample_latlon_fun
+        float phi = 3.14159265359f * (1.0f - t);
+        float theta = 6.28318530718f * (s - 0.5f);
+        x = sinf(phi) * sinf(theta);
+        y = sinf(phi) * cosf(theta);
+        z = cosf(phi);
+    }
+    else
+    {
+        //sample_offset_fun
+        s = 2.0f * (s - 0.5f);
+        t = 2.0f * (t - 0.5f);
+        float r2 = s*s + t*t;
+        if (r2 > 1.0f)
+            return false;
+
+        float halfFov = glm::radians(setup.fov) / 2.0f;
+        float phi = sqrtf(r2) * halfFov;
+        float theta = atan2f(s, t);
+        x = sinf(phi) * sinf(theta) - setup.offset.x;
+        y = -sinf(phi) * cosf(theta) - setup.offset.y;
+        z = cosf(phi) - setup.offset.z;
+    }
+
+    const float angle45Factor = 0.7071067812f;
+    if (setup.layout == FourFace)
+        rotVec = glm::vec3( angle45Factor*x + angle45Factor*z, y, -angle45Factor*x + angle45Factor*z);
+    else if (setup.layout == FiveOrSixFace)
+        rotVec = glm::vec3(angle45Factor*x - angle45Factor*y, angle45Factor*x + angle45Factor*y, z);
+    else
+    {
+        glm::mat4 pitchRot = glm::rotate(glm::mat4(1.0f), glm::radians(setup.rigOrientation.x), glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4 yawRot = glm::rotate(pitchRot, glm::radians(setup.rigOrientation.y), glm::vec3(1.0f, 0.0f, 0.0f));
+        glm::mat4 rollRot = glm::rotate(yawRot, glm::radians(setup.rigOrientation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+        rotVec = glm::vec3(
+            rollRot[0][0]*x + rollRot[0][1]*y + rollRot[0][2]*z,
+            rollRot[1][0]*x + rollRot[1][1]*y + rollRot[1][2]*z,
+            rollRot[2][0]*x + rollRot[2][1]*y + rollRot[2][2]*z);
+    }
+    return true;
+}
+
+/*!
+Cube map face selection, table 8.19 of the OpenGL 4.5 specification.
+*/
+int getTextureCubeFace(const glm::vec3 & r, float & s, float & t)
+{
+    float sc, tc, ma;
+    int face;
+    if (fabsf(r.x) >= fabsf(r.y) && fabsf(r.x) >= fabsf(r.z))
+    {
+        face = r.x >= 0.0f ? 0 : 1;
+        sc = r.x >= 0.0f ? -r.z : r.z;
+        tc = -r.y;
+        ma = r.x;
+    }
+    else if (fabsf(r.y) >= fabsf(r.z))
+    {
+        face = r.y >= 0.0f ? 2 : 3;
+        sc = r.x;
+        tc = r.y >= 0.0f ? r.z : -r.z;
+        ma = r.y;
+    }
+    else
+    {
+        face = r.z >= 0.0f ? 4 : 5;
+        sc = r.z >= 0.0f ? r.x : -r.x;
+        tc = -r.y;
+        ma = r.z;
+    }
+    s = 0.5f * (sc / fabsf(ma) + 1.0f);
+    t = 0.5f * (tc / fabsf(ma) + 1.0f);
+    return face;
+}
+
+/*!
+16 bit RGBA faces where red and green are ramps of the face texture coordinates and blue is the face index.
+*/
+void createLabelledFaces(std::vector<sgct_core::Image *> & faces)
+{
+    for (std::size_t i = 0; i < 6; i++)
+    {
+        sgct_core::Image * face = new sgct_core::Image();
+        face->setSize(FaceSize, FaceSize);
+        face->setChannels(4);
+        face->setBytesPerChannel(2);
+        face->allocateOrResizeData();
+
+        unsigned short * data = reinterpret_cast<unsigned short *>(face->getData());
+        for (std::size_t y = 0; y < FaceSize; y++)
+            for (std::size_t x = 0; x < FaceSize; x++)
+            {
+                unsigned short * texel = data + (y * FaceSize + x) * 4;
+                texel[0] = static_cast<unsigned short>((static_cast<float>(x) + 0.5f) / static_cast<float>(FaceSize) * 65535.0f + 0.5f);
+                texel[1] = static_cast<unsigned short>((static_cast<float>(y) + 0.5f) / static_cast<float>(FaceSize) * 65535.0f + 0.5f);
+                texel[2] = static_cast<unsigned short>(i * 8000 + 1000);
+                texel[3] = 65535;
+            }
+        faces.push_back(face);
+    }
+}
+
+/*!
+Converts the labelled faces and compares every texel with the face and coordinate that the shader samples.
+Texels that sample within a texel and a half of a face edge are skipped, the converter clamps to the edge of the
+face there while GL filters across the seam.
+*/
+void testAgainstShader(const Setup & setup, std::vector<sgct_core::Image *> & faces)
+{
+    sgct_core::CubemapConverter converter;
+    converter.setMapping(setup.mapping);
+    converter.setInterpolation(setup.interpolation);
+    converter.setFaceLayout(setup.layout == FourFace ? sgct_core::CubemapConverter::FourFaceRigLayout :
+        (setup.layout == FiveOrSixFace ? sgct_core::CubemapConverter::FiveOrSixFaceRigLayout : sgct_core::CubemapConverter::CubeLayout));
+    converter.setFOV(setup.fov);
+    converter.setCropFactors(setup.crop[0], setup.crop[1], setup.crop[2], setup.crop[3]);
+    converter.setOffset(setup.offset);
+    converter.setRigOrientation(setup.rigOrientation);
+    converter.setBackgroundColor(glm::vec4(0.0f, 0.0f, 0.0f, 0.0f));
+
+    sgct_core::Image output;
+    output.setSize(setup.width, setup.height);
+    if (!converter.convert(&faces[0], &output))
+    {
+        check(false, setup.name, "conversion");
+        return;
+    }
+
+    const float margin = 1.5f / static_cast<float>(FaceSize);
+    std::size_t compared = 0;
+    std::size_t wrongFace = 0;
+    std::size_t wrongBackground = 0;
+    float maxError = 0.0f;
+
+    const unsigned short * data = reinterpret_cast<const unsigned short *>(output.getData());
+    for (std::size_t y = 0; y < setup.height; y++)
+        for (std::size_t x = 0; x < setup.width; x++)
+        {
+            const unsigned short * texel = data + (y * setup.width + x) * 4;
+
+            //the texture coordinates of the fisheye quad, which covers the uncropped part
+            float s = (static_cast<float>(x) + 0.5f) / static_cast<float>(setup.width);
+            float t = (static_cast<float>(y) + 0.5f) / static_cast<float>(setup.height);
+            if (setup.mapping == sgct_core::CubemapConverter::Fisheye)
+            {
+                s = setup.crop[0] + (1.0f - setup.crop[0] - setup.crop[1]) * s;
+                t = setup.crop[2] + (1.0f - setup.crop[2] - setup.crop[3]) * t;
+            }
+
+            glm::vec3 rotVec;
+            if (!getShaderDirection(setup, s, t, rotVec))
+            {
+                if (texel[0] != 0 || texel[1] != 0 || texel[2] != 0 || texel[3] != 0)
+                    wrongBackground++;
+                continue;
+            }
+
+            float faceS, faceT;
+            int face = getTextureCubeFace(rotVec, faceS, faceT);
+            if (faceS < margin || faceS > 1.0f - margin || faceT < margin || faceT > 1.0f - margin)
+                continue;
+
+            compared++;
+            if (texel[2] != face * 8000 + 1000)
+            {
+                wrongFace++;
+                continue;
+            }
+            maxError = fmaxf(maxError, fabsf(static_cast<float>(texel[0]) - faceS * 65535.0f));
+            maxError = fmaxf(maxError, fabsf(static_cast<float>(texel[1]) - faceT * 65535.0f));
+        }
+
+    sgct::MessageHandler::instance()->print("%-40s compared: %6u  wrong face: %u  wrong background: %u  max error: %.1f / 65535\n",
+        setup.name, static_cast<unsigned int>(compared), static_cast<unsigned int>(wrongFace), static_cast<unsigned int>(wrongBackground), maxError);
+    check(compared > setup.width * setup.height / 4, setup.name, "enough texels compared");
+    check(wrongFace == 0, setup.name, "the texels sample the same face as textureCube");
+    check(wrongBackground == 0, setup.name, "the texels outside of the fisheye are the background");
+    check(maxError <= Tolerance, setup.name, "the texels sample the same coordinate as textureCube");
+}
+
+Setup makeSetup(const char * name, sgct_core::CubemapConverter::Mapping mapping, ReferenceLayout layout, std::size_t width, std::size_t height)
+{
+    Setup setup;
+    setup.name = name;
+    setup.mapping = mapping;
+    setup.layout = layout;
+    setup.fov = 180.0f;
+    for (int i = 0; i < 4; i++)
+        setup.crop[i] = 0.0f;
+    setup.offset = glm::vec3(0.0f);
+    setup.rigOrientation = glm::vec3(0.0f);
+    setup.interpolation = sgct_core::CubemapConverter::Bilinear;
+    setup.width = width;
+    setup.height = height;
+    return setup;
+}
+
+void testThreads(std::vector<sgct_core::Image *> & faces)
+{
+    sgct_core::CubemapConverter converter;
+    converter.setFaceLayout(sgct_core::CubemapConverter::FiveOrSixFaceRigLayout);
+    converter.setInterpolation(sgct_core::CubemapConverter::Bicubic);
+
+    sgct_core::Image single, multiple;
+    single.setSize(300, 300);
+    multiple.setSize(300, 300);
+    converter.setNumberOfThreads(1);
+    bool result = converter.convert(&faces[0], &single);
+    converter.setNumberOfThreads(4);
+    result = converter.convert(&faces[0], &multiple) && result;
+
+    check(result && memcmp(single.getData(), multiple.getData(), 300 * 300 * 4 * sizeof(unsigned short)) == 0,
+        "threads", "the output doesn't depend on the number of threads");
+}
+
+void test8BitRGB()
+{
+    //constant colored 8 bit RGB faces, a missing face is the background
+    std::vector<sgct_core::Image *> faces;
+    for (std::size_t i = 0; i < 6; i++)
+    {
+        sgct_core::Image * face = new sgct_core::Image();
+        face->setSize(FaceSize, FaceSize);
+        face->setChannels(3);
+        face->setBytesPerChannel(1);
+        face->allocateOrResizeData();
+        for (std::size_t j = 0; j < FaceSize * FaceSize; j++)
+        {
+            face->getData()[j * 3 + 0] = static_cast<unsigned char>(i * 40 + 10);
+            face->getData()[j * 3 + 1] = static_cast<unsigned char>(255 - i * 40);
+            face->getData()[j * 3 + 2] = static_cast<unsigned char>(i * 7);
+        }
+        faces.push_back(face);
+    }
+    delete faces[sgct_core::CubemapConverter::NegativeZ];
+    faces[sgct_core::CubemapConverter::NegativeZ] = NULL;
+
+    sgct_core::CubemapConverter converter;
+    converter.setMapping(sgct_core::CubemapConverter::Equirectangular);
+    converter.setBackgroundColor(glm::vec4(1.0f, 0.0f, 1.0f, 1.0f));
+    Setup setup = makeSetup("8 bit RGB equirectangular", sgct_core::CubemapConverter::Equirectangular, SpoutRig, 256, 128);
+
+    sgct_core::Image output;
+    output.setSize(setup.width, setup.height);
+    bool result = converter.convert(&faces[0], &output);
+    check(result && output.getChannels() == 3 && output.getBytesPerChannel() == 1, setup.name, "conversion");
+
+    std::size_t wrong = 0;
+    std::size_t background = 0;
+    for (std::size_t y = 0; result && y < setup.height; y++)
+        for (std::size_t x = 0; x < setup.width; x++)
+        {
+            glm::vec3 rotVec;
+            float faceS, faceT;
+            getShaderDirection(setup, (static_cast<float>(x) + 0.5f) / static_cast<float>(setup.width),
+                (static_cast<float>(y) + 0.5f) / static_cast<float>(setup.height), rotVec);
+            int face = getTextureCubeFace(rotVec, faceS, faceT);
+            if (faceS < 0.01f || faceS > 0.99f || faceT < 0.01f || faceT > 0.99f)
+                continue;
+
+            const unsigned char * texel = output.getData() + (y * setup.width + x) * 3;
+            if (face == sgct_core::CubemapConverter::NegativeZ)
+            {
+                background++;
+                wrong += (texel[0] == 255 && texel[1] == 0 && texel[2] == 255) ? 0 : 1;
+            }
+            else
+                wrong += (texel[0] == face * 40 + 10 && texel[1] == 255 - face * 40 && texel[2] == face * 7) ? 0 : 1;
+        }
+
+    check(background > 0 && wrong == 0, setup.name, "constant faces and the background of a missing face");
+
+    for (std::size_t i = 0; i < faces.size(); i++)
+        delete faces[i];
+}
+
+int main( int argc, char* argv[] )
+{
+    std::vector<sgct_core::Image *> faces;
+    createLabelledFaces(faces);
+
+    Setup setup = makeSetup("fisheye 180, five/six face rig", sgct_core::CubemapConverter::Fisheye, FiveOrSixFace, 256, 256);
+    testAgainstShader(setup, faces);
+
+    setup = makeSetup("fisheye 180, four face rig", sgct_core::CubemapConverter::Fisheye, FourFace, 256, 256);
+    testAgainstShader(setup, faces);
+
+    setup = makeSetup("fisheye 220, offset and crop", sgct_core::CubemapConverter::Fisheye, FiveOrSixFace, 256, 192);
+    setup.fov = 220.0f;
+    setup.crop[0] = 0.05f;
+    setup.crop[1] = 0.1f;
+    setup.crop[2] = 0.2f;
+    setup.crop[3] = 0.0f;
+    setup.offset = glm::vec3(0.1f, -0.2f, 0.3f);
+    testAgainstShader(setup, faces);
+
+    setup = makeSetup("fisheye 180, bicubic", sgct_core::CubemapConverter::Fisheye, FourFace, 256, 256);
+    setup.interpolation = sgct_core::CubemapConverter::Bicubic;
+    testAgainstShader(setup, faces);
+
+    setup = makeSetup("spout fisheye, rig orientation", sgct_core::CubemapConverter::Fisheye, SpoutRig, 256, 256);
+    setup.rigOrientation = glm::vec3(10.0f, 20.0f, 30.0f);
+    testAgainstShader(setup, faces);
+
+    setup = makeSetup("spout equirectangular, rig orientation", sgct_core::CubemapConverter::Equirectangular, SpoutRig, 512, 256);
+    setup.rigOrientation = glm::vec3(-35.0f, 80.0f, 5.0f);
+    testAgainstShader(setup, faces);
+
+    setup = makeSetup("spout equirectangular, bicubic", sgct_core::CubemapConverter::Equirectangular, SpoutRig, 512, 256);
+    setup.interpolation = sgct_core::CubemapConverter::Bicubic;
+    testAgainstShader(setup, faces);
+
+    testThreads(faces);
+    test8BitRGB();
+
+    for (std::size_t i = 0; i < faces.size(); i++)
+        delete faces[i];
+
+    if (numberOfFailures > 0)
+    {
+        sgct::MessageHandler::instance()->print("%u cubemap converter check(s) failed!\n", numberOfFailures);
+        return EXIT_FAILURE;
+    }
+
+    sgct::MessageHandler::instance()->print("All cubemap converter checks passed.\n");
+    return EXIT_SUCCESS;
+}
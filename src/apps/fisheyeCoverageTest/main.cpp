@@ -0,0 +1,302 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "sgct.h"
+#include <sgct/FisheyeProjection.h>
+
+/*
+Unit tests of the cube face coverage of the adaptive fisheye faces (FisheyeProjection::calculateFaceCoverage).
+The reference maps a dense, jittered grid over the cropped fisheye through the lookup of the fisheye shader and
+the face selection of textureCube from the OpenGL specification. Every reference sample must lie inside the
+rectangle of its face, even when the coverage is calculated with few samples, and the rectangles must not be
+much larger than the area that is actually sampled. Doesn't need OpenGL, the process returns EXIT_FAILURE if
+any test fails.
+*/
+
+typedef sgct_core::FisheyeProjection FP;
+
+const int ReferenceSamples = 1000;
+unsigned int numberOfFailures = 0;
+unsigned int randomState = 12345;
+
+struct Setup
+{
+    const char * name;
+    FP::FisheyeMethod method;
+    float fov;
+    float crop[4];
+    glm::vec3 offsets[2];
+    std::size_t numberOfOffsets;
+    //how much larger than the sampled area a rectangle may be in face coordinates, the padding grows
+    //with the field of view and with how close the lens offset brings the eye to the sphere
+    float slack;
+};
+
+void check(bool condition, const char * setup, const char * test)
+{
+    if (!condition)
+    {
+        sgct::MessageHandler::instance()->print("FAILED: %s: %s\n", setup, test);
+        numberOfFailures++;
+    }
+}
+
+//uniform random number in [0, 1), deterministic so that the runs are repeatable
+float random01()
+{
+    randomState = randomState * 1664525u + 1013904223u;
+    return static_cast<float>(randomState >> 8) / static_cast<float>(1 << 24);
+}
+
+bool isEmpty(const glm::vec4 & rect)
+{
+    return rect.z < rect.x;
+}
+
+//a thin strip along a face edge, added by the padding next to a sampled neighbour face
+bool isSliver(const glm::vec4 & rect, float slack)
+{
+    return isEmpty(rect) || rect.z - rect.x <= 2.0f * slack || rect.w - rect.y <= 2.0f * slack;
+}
+
+/*!
+Cube map face selection, table 8.19 of the OpenGL 4.5 specification.
+*/
+int getTextureCubeFace(const glm::vec3 & r, float & s, float & t)
+{
+    float sc, tc, ma;
+    int face;
+    if (fabsf(r.x) >= fabsf(r.y) && fabsf(r.x) >= fabsf(r.z))
+    {
+        face = r.x >= 0.0f ? 0 : 1;
+        sc = r.x >= 0.0f ? -r.z : r.z;
+        tc = -r.y;
+        ma = r.x;
+    }
+    else if (fabsf(r.y) >= fabsf(r.z))
+    {
+        face = r.y >= 0.0f ? 2 : 3;
+        sc = r.x;
+        tc = r.y >= 0.0f ? r.z : -r.z;
+        ma = r.y;
+    }
+    else
+    {
+        face = r.z >= 0.0f ? 4 : 5;
+        sc = r.z >= 0.0f ? r.x : -r.x;
+        tc = -r.y;
+        ma = r.z;
+    }
+    s = 0.5f * (sc / fabsf(ma) + 1.0f);
+    t = 0.5f * (tc / fabsf(ma) + 1.0f);
+    return face;
+}
+
+/*!
+The bounding rectangles of the face coordinates that the fisheye shader samples, from a jittered grid
+of ReferenceSamples x ReferenceSamples texture coordinates plus the edges of the cropped area.
+*/
+void calculateReference(const Setup & setup, glm::vec4 * faceRects)
+{
+    for (std::size_t i = 0; i < 6; i++)
+        faceRects[i] = glm::vec4(1.0f, 1.0f, 0.0f, 0.0f);
+
+    const float halfFov = glm::radians(setup.fov / 2.0f);
+    const float angle45Factor = 0.7071067812f;
+    float uMin = setup.crop[FP::CropLeft];
+    float uMax = 1.0f - setup.crop[FP::CropRight];
+    float vMin = setup.crop[FP::CropBottom];
+    float vMax = 1.0f - setup.crop[FP::CropTop];
+
+    for (int j = 0; j <= ReferenceSamples; j++)
+        for (int i = 0; i <= ReferenceSamples; i++)
+        {
+            //jitter the inner samples, keep the edges of the crop exact
+            float ju = (i == 0 || i == ReferenceSamples) ? 0.0f : random01() - 0.5f;
+            float jv = (j == 0 || j == ReferenceSamples) ? 0.0f : random01() - 0.5f;
+            float u = glm::mix(uMin, uMax, (static_cast<float>(i) + ju) / static_cast<float>(ReferenceSamples));
+            float v = glm::mix(vMin, vMax, (static_cast<float>(j) + jv) / static_cast<float>(ReferenceSamples));
+
+            //getCubeSample in the fisheye shaders
+            float s = 2.0f * (u - 0.5f);
+            float t = 2.0f * (v - 0.5f);
+            float r2 = s*s + t*t;
+            if (r2 > 1.0f)
+                continue;
+
+            float phi = sqrtf(r2) * halfFov;
+            float theta = atan2f(s, t);
+            for (std::size_t k = 0; k < setup.numberOfOffsets; k++)
+            {
+                float x = sinf(phi) * sinf(theta) - setup.offsets[k].x;
+                float y = -sinf(phi) * cosf(theta) - setup.offsets[k].y;
+                float z = cosf(phi) - setup.offsets[k].z;
+
+                //rotVec of FisheyeProjection::initShaders
+                glm::vec3 rotVec = (setup.method == FP::FourFaceCube) ?
+                    glm::vec3(angle45Factor*x + angle45Factor*z, y, -angle45Factor*x + angle45Factor*z) :
+                    glm::vec3(angle45Factor*x - angle45Factor*y, angle45Factor*x + angle45Factor*y, z);
+
+                float faceS, faceT;
+                int face = getTextureCubeFace(rotVec, faceS, faceT);
+                glm::vec4 & rect = faceRects[face];
+                rect.x = fminf(rect.x, faceS);
+                rect.y = fminf(rect.y, faceT);
+                rect.z = fmaxf(rect.z, faceS);
+                rect.w = fmaxf(rect.w, faceT);
+            }
+        }
+}
+
+bool contains(const glm::vec4 & outer, const glm::vec4 & inner)
+{
+    return isEmpty(inner) ||
+        (!isEmpty(outer) && outer.x <= inner.x && outer.y <= inner.y && outer.z >= inner.z && outer.w >= inner.w);
+}
+
+//the rectangle is at most slack larger than the sampled area or only a sliver
+bool isTight(const glm::vec4 & rect, const glm::vec4 & reference, float slack)
+{
+    if (isSliver(rect, slack))
+        return true;
+    if (isEmpty(reference))
+        return false;
+    return rect.x >= reference.x - slack && rect.y >= reference.y - slack &&
+        rect.z <= reference.z + slack && rect.w <= reference.w + slack;
+}
+
+void testSetup(const Setup & setup, glm::vec4 * faceRects)
+{
+    glm::vec4 reference[6];
+    calculateReference(setup, reference);
+
+    //few samples, the padding must still cover everything in between
+    glm::vec4 coarse[6];
+    FP::calculateFaceCoverage(setup.method, setup.fov, setup.crop, setup.offsets, setup.numberOfOffsets, 32, coarse);
+    //the number of samples that FisheyeProjection uses
+    FP::calculateFaceCoverage(setup.method, setup.fov, setup.crop, setup.offsets, setup.numberOfOffsets, 512, faceRects);
+
+    bool covered = true;
+    bool tight = true;
+    for (std::size_t i = 0; i < 6; i++)
+    {
+        covered = covered && contains(coarse[i], reference[i]) && contains(faceRects[i], reference[i]);
+        tight = tight && isTight(faceRects[i], reference[i], setup.slack);
+    }
+
+    sgct::MessageHandler::instance()->print("%-40s", setup.name);
+    for (std::size_t i = 0; i < 6; i++)
+    {
+        if (isEmpty(faceRects[i]))
+            sgct::MessageHandler::instance()->print("    unused ");
+        else
+            sgct::MessageHandler::instance()->print(" %5.1f%%/%3.0f%%", (faceRects[i].z - faceRects[i].x) * (faceRects[i].w - faceRects[i].y) * 100.0f,
+                isEmpty(reference[i]) ? 0.0f : (reference[i].z - reference[i].x) * (reference[i].w - reference[i].y) * 100.0f);
+    }
+    sgct::MessageHandler::instance()->print("\n");
+
+    check(covered, setup.name, "every sampled face coordinate is covered");
+    check(tight, setup.name, "the rectangles are close to the sampled area");
+}
+
+int main( int argc, char* argv[] )
+{
+    const glm::vec3 noOffset(0.0f);
+    const glm::vec3 leftEye(-0.035f, 0.0f, 0.0f);
+    const glm::vec3 rightEye(0.035f, 0.0f, 0.0f);
+
+    sgct::MessageHandler::instance()->print("%-40s %10s %10s %10s %10s %10s %10s\n", "used area / sampled area", "+X", "-X", "+Y", "-Y", "+Z", "-Z");
+
+    glm::vec4 rects[6];
+
+    {
+        Setup setup = { "four faces, 180 degrees", FP::FourFaceCube, 180.0f, { 0.0f, 0.0f, 0.0f, 0.0f }, { noOffset, noOffset }, 1, 0.02f };
+        testSetup(setup, rects);
+        check(!isEmpty(rects[0]) && !isEmpty(rects[4]), setup.name, "the two front faces are used");
+        check(isSliver(rects[1], setup.slack) && isSliver(rects[5], setup.slack), setup.name, "the back faces are at most slivers");
+    }
+
+    {
+        Setup setup = { "five faces, 180 degrees", FP::FiveFaceCube, 180.0f, { 0.0f, 0.0f, 0.0f, 0.0f }, { noOffset, noOffset }, 1, 0.02f };
+        testSetup(setup, rects);
+        check(isEmpty(rects[5]), setup.name, "the -Z face is unused");
+        check(rects[4] == glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), setup.name, "the +Z face is fully used");
+    }
+
+    {
+        //the dome cut at the horizon, only the top half of the fisheye is shown
+        Setup setup = { "five faces, 180 degrees, bottom cropped", FP::FiveFaceCube, 180.0f, { 0.0f, 0.0f, 0.5f, 0.0f }, { noOffset, noOffset }, 1, 0.02f };
+        testSetup(setup, rects);
+        check(isEmpty(rects[5]), setup.name, "the -Z face is unused");
+        check(isSliver(rects[1], setup.slack) && isSliver(rects[2], setup.slack), setup.name, "the two cropped side faces are at most slivers");
+        check(!isSliver(rects[0], setup.slack) && !isSliver(rects[3], setup.slack), setup.name, "the two other side faces are used");
+    }
+
+    {
+        //a quarter of the fisheye
+        Setup setup = { "five faces, 165 degrees, corner crop", FP::FiveFaceCube, 165.0f, { 0.5f, 0.0f, 0.5f, 0.0f }, { noOffset, noOffset }, 1, 0.02f };
+        testSetup(setup, rects);
+        std::size_t used = 0;
+        for (std::size_t i = 0; i < 6; i++)
+            used += isSliver(rects[i], setup.slack) ? 0 : 1;
+        check(used == 2, setup.name, "only two faces are more than slivers");
+        check(isEmpty(rects[1]) && isEmpty(rects[5]), setup.name, "the faces away from the corner are unused");
+    }
+
+    {
+        Setup setup = { "five faces, 220 degrees", FP::FiveFaceCube, 220.0f, { 0.0f, 0.0f, 0.0f, 0.0f }, { noOffset, noOffset }, 1, 0.03f };
+        testSetup(setup, rects);
+        check(isEmpty(rects[5]), setup.name, "the -Z face is unused");
+    }
+
+    {
+        Setup setup = { "six faces, 360 degrees", FP::SixFaceCube, 360.0f, { 0.0f, 0.0f, 0.0f, 0.0f }, { noOffset, noOffset }, 1, 0.02f };
+        testSetup(setup, rects);
+        bool allUsed = true;
+        for (std::size_t i = 0; i < 6; i++)
+            allUsed = allUsed && !isEmpty(rects[i]);
+        check(allUsed, setup.name, "all faces are used");
+    }
+
+    {
+        Setup setup = { "five faces, 180 degrees, stereo", FP::FiveFaceCube, 180.0f, { 0.0f, 0.0f, 0.5f, 0.0f }, { leftEye, rightEye }, 2, 0.02f };
+        testSetup(setup, rects);
+
+        //FisheyeProjection adds new offsets one at a time to the union of the rectangles
+        glm::vec4 left[6];
+        glm::vec4 right[6];
+        FP::calculateFaceCoverage(setup.method, setup.fov, setup.crop, &leftEye, 1, 512, left);
+        FP::calculateFaceCoverage(setup.method, setup.fov, setup.crop, &rightEye, 1, 512, right);
+        glm::vec4 reference[6];
+        calculateReference(setup, reference);
+        bool covered = true;
+        for (std::size_t i = 0; i < 6; i++)
+        {
+            glm::vec4 merged = isEmpty(left[i]) ? right[i] : (isEmpty(right[i]) ? left[i] :
+                glm::vec4(glm::min(left[i].x, right[i].x), glm::min(left[i].y, right[i].y), glm::max(left[i].z, right[i].z), glm::max(left[i].w, right[i].w)));
+            covered = covered && contains(merged, reference[i]);
+        }
+        check(covered, setup.name, "the union of the rectangles of each eye covers both eyes");
+    }
+
+    {
+        //a large lens offset towards the dome brings the eye close to the sphere
+        Setup setup = { "five faces, 180 degrees, offset", FP::FiveFaceCube, 180.0f, { 0.0f, 0.0f, 0.0f, 0.0f }, { glm::vec3(0.2f, -0.3f, 0.5f), noOffset }, 1, 0.08f };
+        testSetup(setup, rects);
+    }
+
+    {
+        Setup setup = { "four faces, 150 degrees, offset and crop", FP::FourFaceCube, 150.0f, { 0.1f, 0.2f, 0.3f, 0.0f }, { glm::vec3(0.0f, 0.0f, -0.4f), noOffset }, 1, 0.03f };
+        testSetup(setup, rects);
+    }
+
+    if (numberOfFailures > 0)
+    {
+        sgct::MessageHandler::instance()->print("%u fisheye coverage test(s) failed!\n", numberOfFailures);
+        return EXIT_FAILURE;
+    }
+
+    sgct::MessageHandler::instance()->print("All fisheye coverage tests passed.\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,226 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <string>
+#include "sgct.h"
+#include <sgct/GlyphAtlas.h>
+#include <sgct/TextLayout.h>
+
+/*
+Unit tests of the glyph atlas packer (sgct_text::GlyphAtlas) and the text layout (sgct_text::layoutText)
+of the freetype module. Doesn't need OpenGL, the process returns EXIT_FAILURE if any test fails.
+*/
+
+unsigned int numberOfFailures = 0;
+
+void check(bool condition, const char * test)
+{
+    if (!condition)
+    {
+        sgct::MessageHandler::instance()->print("FAILED: %s\n", test);
+        numberOfFailures++;
+    }
+}
+
+//a glyph bitmap where every pixel holds the glyph's label so that overwritten glyphs are found
+std::vector<unsigned char> createGlyph(int width, int height, unsigned char label)
+{
+    return std::vector<unsigned char>(static_cast<std::size_t>(width) * height * sgct_text::GlyphAtlas::Channels, label);
+}
+
+bool overlaps(const sgct_text::GlyphAtlas::Region & a, const sgct_text::GlyphAtlas::Region & b, int padding)
+{
+    //each glyph owns the padding to its left and above it
+    return a.page == b.page &&
+        a.x - padding < b.x + b.width && b.x - padding < a.x + a.width &&
+        a.y - padding < b.y + b.height && b.y - padding < a.y + a.height;
+}
+
+void testPacking()
+{
+    const int pageSize = 512;
+    const int padding = 1;
+    sgct_text::GlyphAtlas atlas(pageSize, padding);
+    std::vector<sgct_text::GlyphAtlas::Region> regions;
+
+    //glyph sizes of a few fonts and sizes
+    srand(1);
+    bool inserted = true;
+    std::size_t glyphArea = 0;
+    std::size_t paddedArea = 0;
+    for (int i = 0; i < 3000 && inserted; i++)
+    {
+        int width = 3 + rand() % 30;
+        int height = 5 + rand() % 40;
+        std::vector<unsigned char> pixels = createGlyph(width, height, static_cast<unsigned char>(1 + i % 250));
+        sgct_text::GlyphAtlas::Region region;
+        inserted = atlas.insert(width, height, &pixels[0], region);
+        regions.push_back(region);
+        glyphArea += static_cast<std::size_t>(width) * height;
+        paddedArea += static_cast<std::size_t>(width + padding) * (height + padding);
+    }
+    check(inserted, "all glyphs are inserted");
+
+    bool inside = true;
+    bool intact = true;
+    for (std::size_t i = 0; i < regions.size(); i++)
+    {
+        const sgct_text::GlyphAtlas::Region & r = regions[i];
+        inside = inside && r.page < atlas.getNumberOfPages() && r.x >= padding && r.y >= padding &&
+            r.x + r.width <= pageSize && r.y + r.height <= pageSize;
+        if (!inside)
+            break;
+
+        const sgct_text::GlyphAtlas::Page & page = atlas.getPage(r.page);
+        for (int y = 0; y < r.height; y++)
+            for (int x = 0; x < r.width; x++)
+                intact = intact && page.pixels[(static_cast<std::size_t>(r.y + y) * page.size + r.x + x) * sgct_text::GlyphAtlas::Channels] == static_cast<unsigned char>(1 + i % 250);
+    }
+    check(inside, "the glyphs are inside their pages");
+    check(intact, "no glyph is overwritten by another");
+
+    bool separate = true;
+    for (std::size_t i = 0; i < regions.size() && separate; i++)
+        for (std::size_t j = i + 1; j < regions.size() && separate; j++)
+            separate = !overlaps(regions[i], regions[j], padding);
+    check(separate, "the glyphs and their padding don't overlap");
+
+    //nothing is written outside the glyphs
+    std::size_t written = 0;
+    for (std::size_t p = 0; p < atlas.getNumberOfPages(); p++)
+        for (std::size_t i = 0; i < atlas.getPage(static_cast<unsigned int>(p)).pixels.size(); i += sgct_text::GlyphAtlas::Channels)
+            written += atlas.getPage(static_cast<unsigned int>(p)).pixels[i] != 0 ? 1 : 0;
+    check(written == glyphArea, "the padding is left empty");
+
+    double occupancy = static_cast<double>(paddedArea) / static_cast<double>(atlas.getNumberOfPages() * pageSize * pageSize);
+    sgct::MessageHandler::instance()->print("%u glyphs in %u pages of %dx%d, occupancy %.1f%%\n",
+        static_cast<unsigned int>(regions.size()), static_cast<unsigned int>(atlas.getNumberOfPages()), pageSize, pageSize, occupancy * 100.0);
+    //the last page is partially filled, all but the last page must be well packed
+    check(atlas.getNumberOfPages() <= static_cast<std::size_t>(paddedArea / (0.75 * pageSize * pageSize)) + 1, "the skyline packer uses at least 75% of the pages");
+}
+
+void testLargeAndEmptyGlyphs()
+{
+    sgct_text::GlyphAtlas atlas(64, 1);
+    sgct_text::GlyphAtlas::Region region;
+
+    //a space has no pixels
+    check(atlas.insert(0, 0, NULL, region) && region.width == 0 && region.height == 0, "empty glyphs are accepted");
+    check(!atlas.insert(-1, 4, NULL, region), "negative sizes are rejected");
+
+    std::vector<unsigned char> pixels = createGlyph(100, 20, 7);
+    check(atlas.insert(100, 20, &pixels[0], region), "a glyph larger than a page is inserted");
+    check(atlas.getPage(region.page).size == 128 && region.x + region.width <= 128, "a larger page is added for it");
+
+    pixels = createGlyph(10, 10, 9);
+    check(atlas.insert(10, 10, &pixels[0], region) && region.page == 0, "the first page is filled before the next");
+
+    atlas.clear();
+    check(atlas.getNumberOfPages() == 0, "clear removes all pages");
+}
+
+void testDirtyRows()
+{
+    sgct_text::GlyphAtlas atlas(128, 1);
+    sgct_text::GlyphAtlas::Region region;
+    std::vector<unsigned char> pixels = createGlyph(10, 12, 1);
+
+    atlas.insert(10, 12, &pixels[0], region);
+    check(atlas.isDirty(0) && atlas.getPage(0).dirtyMinY == 0 && atlas.getPage(0).dirtyMaxY == 128, "a new page is uploaded whole");
+
+    atlas.clearDirty(0);
+    check(!atlas.isDirty(0), "clearDirty marks the page as uploaded");
+
+    //fill the first row of glyphs so that the next one goes below
+    for (int i = 0; i < 12; i++)
+        atlas.insert(10, 12, &pixels[0], region);
+    check(atlas.isDirty(0) && atlas.getPage(0).dirtyMinY <= region.y && atlas.getPage(0).dirtyMaxY >= region.y + region.height, "the dirty rows cover new glyphs");
+    check(atlas.getPage(0).dirtyMaxY - atlas.getPage(0).dirtyMinY < 128, "only the changed rows are dirty");
+}
+
+void testLayout()
+{
+    //two pages, 'a' and 'c' on page 0, 'b' on page 1, a space without pixels
+    sgct_text::GlyphMetrics glyphs[4];
+    const wchar_t characters[] = { L'a', L'b', L'c', L' ' };
+    for (int i = 0; i < 3; i++)
+    {
+        glyphs[i].mDistToNextChar = 10.0f + static_cast<float>(i);
+        glyphs[i].mPos = glm::vec2(1.0f, -2.0f);
+        glyphs[i].mSize = glm::vec2(8.0f, 12.0f);
+        glyphs[i].mPage = i == 1 ? 1 : 0;
+        glyphs[i].mTexCoordMin = glm::vec2(0.1f * static_cast<float>(i), 0.2f);
+        glyphs[i].mTexCoordMax = glm::vec2(0.1f * static_cast<float>(i) + 0.05f, 0.3f);
+    }
+    glyphs[3].mDistToNextChar = 5.0f;
+
+    sgct_text::GlyphLookup lookup = [&glyphs, &characters](wchar_t c) -> const sgct_text::GlyphMetrics * {
+        for (int i = 0; i < 4; i++)
+            if (characters[i] == c)
+                return &glyphs[i];
+        return &glyphs[3];
+    };
+
+    check(sgct_text::getLineWidth(L"", lookup) == 0.0f, "an empty line has no width");
+    //advance of a, b and the space plus the width of c
+    check(sgct_text::getLineWidth(L"ab c", lookup) == 10.0f + 11.0f + 5.0f + 8.0f, "line width");
+
+    std::vector<std::wstring> lines;
+    lines.push_back(L"ab c");
+    lines.push_back(L"");
+    lines.push_back(L"ca");
+
+    sgct_text::TextMesh mesh;
+    sgct_text::layoutText(lines, sgct_text::TOP_LEFT, 20.0f, lookup, mesh);
+    check(mesh.getNumberOfVertices() == 5 * 6, "six vertices per visible glyph and none for spaces");
+    check(mesh.mBatches.size() == 2, "one batch per page");
+    if (mesh.mBatches.size() == 2)
+    {
+        check(mesh.mBatches[0].page == 0 && mesh.mBatches[0].first == 0 && mesh.mBatches[0].count == 4 * 6 &&
+            mesh.mBatches[1].page == 1 && mesh.mBatches[1].first == 4 * 6 && mesh.mBatches[1].count == 6, "batch ranges");
+    }
+
+    //the first quad is 'a' at the origin, the top left vertex uses the min texture coordinates
+    const float * v = &mesh.mVertices[0];
+    check(v[0] == glyphs[0].mTexCoordMin.x && v[1] == glyphs[0].mTexCoordMin.y && v[2] == 1.0f && v[3] == -2.0f + 12.0f, "top left vertex of the first glyph");
+    check(v[4] == glyphs[0].mTexCoordMin.x && v[5] == glyphs[0].mTexCoordMax.y && v[6] == 1.0f && v[7] == -2.0f, "bottom left vertex of the first glyph");
+
+    //'c' after "ab " and the first 'c' of the third line, 40 pixels down
+    const float * c0 = &mesh.mVertices[1 * 6 * sgct_text::TextMesh::FloatsPerVertex];
+    const float * c1 = &mesh.mVertices[2 * 6 * sgct_text::TextMesh::FloatsPerVertex];
+    check(c0[2] == 26.0f + 1.0f && c0[3] == 10.0f, "glyphs advance along the line");
+    check(c1[2] == 1.0f && c1[3] == -40.0f + 10.0f, "lines move down by the line height, empty lines included");
+
+    //alignment moves each line by its own width
+    sgct_text::TextMesh centered;
+    sgct_text::layoutText(lines, sgct_text::TOP_CENTER, 20.0f, lookup, centered);
+    sgct_text::TextMesh right;
+    sgct_text::layoutText(lines, sgct_text::TOP_RIGHT, 20.0f, lookup, right);
+    float width0 = sgct_text::getLineWidth(lines[0], lookup);
+    float width2 = sgct_text::getLineWidth(lines[2], lookup);
+    check(fabsf(centered.mVertices[2] - (1.0f - width0 / 2.0f)) < 1e-5f && fabsf(right.mVertices[2] - (1.0f - width0)) < 1e-5f, "center and right alignment of the first line");
+    check(fabsf(centered.mVertices[2 * 6 * sgct_text::TextMesh::FloatsPerVertex + 2] - (1.0f - width2 / 2.0f)) < 1e-5f, "each line is aligned by its own width");
+
+    //an empty text gives an empty mesh, also when the mesh is reused
+    sgct_text::layoutText(std::vector<std::wstring>(), sgct_text::TOP_LEFT, 20.0f, lookup, mesh);
+    check(mesh.mVertices.empty() && mesh.mBatches.empty(), "the mesh is cleared");
+}
+
+int main( int argc, char* argv[] )
+{
+    testPacking();
+    testLargeAndEmptyGlyphs();
+    testDirtyRows();
+    testLayout();
+
+    if (numberOfFailures > 0)
+    {
+        sgct::MessageHandler::instance()->print("%u glyph atlas test(s) failed!\n", numberOfFailures);
+        return EXIT_FAILURE;
+    }
+
+    sgct::MessageHandler::instance()->print("All glyph atlas tests passed.\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,154 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include "sgct.h"
+
+/*
+Benchmark of the per-call cost of MessageHandler::print in synchronous and asynchronous mode with the log
+written to a file, from one and from several threads. Every call is timed so that the tail latency, which is
+what stalls a frame, is reported next to the mean. The messages are counted in the log callback and the run
+fails if any message is lost, with the drop policy the messages reported as dropped are counted as well.
+
+Usage: loggerBenchmark [-messages n] [-threads n] [-path dir]
+*/
+
+int numberOfMessages = 20000;
+int numberOfThreads = 4;
+const char * logPath = ".";
+
+std::atomic<unsigned int> delivered(0);
+std::atomic<unsigned int> dropped(0);
+
+void logCallback(const char * msg)
+{
+    //the drop policy reports the number of dropped messages in a message of its own
+    const char * report = strstr(msg, "MessageHandler: ");
+    unsigned int count = 0;
+    if (report != NULL && sscanf(report, "MessageHandler: %u messages dropped", &count) == 1)
+        dropped += count;
+    else
+        delivered++;
+}
+
+//logs the messages and stores the time of every call in microseconds
+void logMessages(int thread, int count, sgct::MessageHandler::NotifyLevel level, double * times)
+{
+    for (int i = 0; i < count; i++)
+    {
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        sgct::MessageHandler::instance()->print(level, "Font: missing glyph %d in face '%s' [thread %d]\n", i, "Arial", thread);
+        std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+        times[i] = std::chrono::duration<double, std::micro>(t1 - t0).count();
+    }
+}
+
+bool runTest(const char * name, bool async, sgct::MessageHandler::OverflowPolicy policy, int threads, sgct::MessageHandler::NotifyLevel level)
+{
+    sgct::MessageHandler * mh = sgct::MessageHandler::instance();
+    mh->setLogAsync(async);
+    mh->setAsyncOverflowPolicy(policy);
+    delivered = 0;
+    dropped = 0;
+
+    std::vector<double> times(static_cast<std::size_t>(numberOfMessages) * threads);
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    if (threads == 1)
+        logMessages(0, numberOfMessages, level, &times[0]);
+    else
+    {
+        std::vector<std::thread> workers;
+        for (int i = 0; i < threads; i++)
+            workers.push_back(std::thread(logMessages, i, numberOfMessages, level, &times[static_cast<std::size_t>(i) * numberOfMessages]));
+        for (std::size_t i = 0; i < workers.size(); i++)
+            workers[i].join();
+    }
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    mh->flush();
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+
+    std::sort(times.begin(), times.end());
+    double mean = 0.0;
+    for (std::size_t i = 0; i < times.size(); i++)
+        mean += times[i];
+    mean /= static_cast<double>(times.size());
+
+    unsigned int expected = level <= mh->getNotifyLevel() ? static_cast<unsigned int>(times.size()) : 0;
+    unsigned int received = delivered + dropped;
+    mh->setLogAsync(false);
+
+    //the results are printed directly since the console output of the MessageHandler is disabled
+    printf("%-34s mean: %7.3f us  p99: %8.3f us  max: %9.1f us  total: %7.1f ms  flush: %6.1f ms  dropped: %u\n",
+        name, mean, times[times.size() * 99 / 100], times.back(),
+        std::chrono::duration<double, std::milli>(t1 - t0).count(), std::chrono::duration<double, std::milli>(t2 - t1).count(),
+        static_cast<unsigned int>(dropped));
+    fflush(stdout);
+
+    if (received != expected || (policy == sgct::MessageHandler::BlockUntilSpace && dropped > 0))
+    {
+        printf("%s: %u of %u messages were logged!\n", name, received, expected);
+        return false;
+    }
+    return true;
+}
+
+int main( int argc, char* argv[] )
+{
+    for( int i = 1; i < argc; i++ )
+    {
+        if( strcmp(argv[i], "-messages") == 0 && argc > (i+1) )
+        {
+            numberOfMessages = atoi(argv[i + 1]);
+            i++;
+        }
+        else if( strcmp(argv[i], "-threads") == 0 && argc > (i+1) )
+        {
+            numberOfThreads = atoi(argv[i + 1]);
+            i++;
+        }
+        else if( strcmp(argv[i], "-path") == 0 && argc > (i+1) )
+        {
+            logPath = argv[i + 1];
+            i++;
+        }
+    }
+
+    if (numberOfMessages <= 0 || numberOfThreads <= 0)
+        return EXIT_FAILURE;
+
+    printf("MessageHandler benchmark, %d messages per thread, log file in '%s'\n\n", numberOfMessages, logPath);
+
+    sgct::MessageHandler * mh = sgct::MessageHandler::instance();
+    mh->setNotifyLevel(sgct::MessageHandler::NOTIFY_WARNING);
+    mh->setShowTime(true);
+    mh->setLogToConsole(false);
+    mh->setLogPath(logPath);
+    mh->setLogToFile(true);
+    mh->setLogFileRotation(4 * 1024 * 1024, 2);
+    mh->setLogCallback(logCallback);
+    mh->setLogToCallback(true);
+
+    char name[64];
+    bool result = true;
+    result = runTest("sync", false, sgct::MessageHandler::BlockUntilSpace, 1, sgct::MessageHandler::NOTIFY_WARNING) && result;
+    result = runTest("async, block", true, sgct::MessageHandler::BlockUntilSpace, 1, sgct::MessageHandler::NOTIFY_WARNING) && result;
+    result = runTest("async, drop", true, sgct::MessageHandler::DropMessages, 1, sgct::MessageHandler::NOTIFY_WARNING) && result;
+    sprintf(name, "sync, %d threads", numberOfThreads);
+    result = runTest(name, false, sgct::MessageHandler::BlockUntilSpace, numberOfThreads, sgct::MessageHandler::NOTIFY_WARNING) && result;
+    sprintf(name, "async, block, %d threads", numberOfThreads);
+    result = runTest(name, true, sgct::MessageHandler::BlockUntilSpace, numberOfThreads, sgct::MessageHandler::NOTIFY_WARNING) && result;
+    sprintf(name, "async, drop, %d threads", numberOfThreads);
+    result = runTest(name, true, sgct::MessageHandler::DropMessages, numberOfThreads, sgct::MessageHandler::NOTIFY_WARNING) && result;
+    //messages below the notify level should cost next to nothing in both modes
+    result = runTest("sync, filtered", false, sgct::MessageHandler::BlockUntilSpace, 1, sgct::MessageHandler::NOTIFY_DEBUG) && result;
+    result = runTest("async, filtered", true, sgct::MessageHandler::BlockUntilSpace, 1, sgct::MessageHandler::NOTIFY_DEBUG) && result;
+
+    mh->setLogToCallback(false);
+    sgct::MessageHandler::destroy();
+
+    return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
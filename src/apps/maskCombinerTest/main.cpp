@@ -0,0 +1,196 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <set>
+#include "sgct.h"
+#include <sgct/Image.h>
+#include <sgct/MaskCombiner.h>
+
+/*
+Unit tests of the CPU side mask combination of the single pass compositor (sgct_core::MaskCombiner).
+Doesn't need OpenGL, the process returns EXIT_FAILURE if any test fails.
+*/
+
+unsigned int numberOfFailures = 0;
+
+void check(bool condition, const char * test)
+{
+    if (!condition)
+    {
+        sgct::MessageHandler::instance()->print("FAILED: %s\n", test);
+        numberOfFailures++;
+    }
+}
+
+//creates a gray mask with one channel where the value of a texel is given by fn(x, y) in [0, 1]
+template <class Fn>
+sgct_core::Image * createMask(std::size_t width, std::size_t height, std::size_t bpc, Fn fn)
+{
+    sgct_core::Image * img = new sgct_core::Image();
+    img->setSize(width, height);
+    img->setChannels(1);
+    img->setBytesPerChannel(bpc);
+    img->allocateOrResizeData();
+    for (std::size_t y = 0; y < height; y++)
+        for (std::size_t x = 0; x < width; x++)
+        {
+            float val = fn(x, y);
+            unsigned char * p = img->getSampleAt(x, y);
+            if (bpc == 2)
+            {
+                unsigned short tmp = static_cast<unsigned short>(val * 65535.0f + 0.5f);
+                memcpy(p, &tmp, sizeof(unsigned short));
+            }
+            else
+                p[0] = static_cast<unsigned char>(val * 255.0f + 0.5f);
+        }
+    return img;
+}
+
+//reads channel c (0 = b, 1 = g, 2 = r, 3 = a) of the combined BGRA image normalized to [0, 1]
+float readCombined(sgct_core::Image * img, std::size_t x, std::size_t y, std::size_t c)
+{
+    const unsigned char * p = img->getSampleAt(x, y) + c * img->getBytesPerChannel();
+    if (img->getBytesPerChannel() == 2)
+    {
+        unsigned short tmp;
+        memcpy(&tmp, p, sizeof(unsigned short));
+        return static_cast<float>(tmp) / 65535.0f;
+    }
+    return static_cast<float>(p[0]) / 255.0f;
+}
+
+void testNoMasks()
+{
+    check(sgct_core::MaskCombiner::combine(NULL, NULL) == NULL, "no masks gives no combined mask");
+}
+
+void testCombineSamples()
+{
+    //the combined mask must give the same result as the separate blend and black level passes for gray black levels
+    const float colors[] = { 0.0f, 0.25f, 1.0f };
+    const float blends[] = { 0.0f, 0.5f, 1.0f };
+    const float levels[] = { 0.0f, 0.1f, 0.3f };
+    const float alphas[] = { 0.0f, 0.5f, 1.0f };
+    for (int c = 0; c < 3; c++)
+        for (int b = 0; b < 3; b++)
+            for (int l = 0; l < 3; l++)
+                for (int a = 0; a < 3; a++)
+                {
+                    glm::vec4 blend(blends[b], blends[b], blends[b], 1.0f);
+                    glm::vec4 blackLevel(levels[l], levels[l], levels[l], alphas[a]);
+                    glm::vec4 combined = sgct_core::MaskCombiner::combineSamples(blend, blackLevel);
+
+                    float separate = (colors[c] * blends[b]) * (1.0f - levels[l]) + levels[l] * alphas[a];
+                    float single = colors[c] * combined.r + combined.a;
+                    check(fabsf(separate - single) < 1e-6f, "combined mask matches the separate passes");
+                }
+}
+
+void test8Bit()
+{
+    sgct_core::Image * blend = createMask(16, 8, 1, [](std::size_t x, std::size_t) { return static_cast<float>(x) / 15.0f; });
+    sgct_core::Image * blackLevel = createMask(16, 8, 1, [](std::size_t, std::size_t y) { return static_cast<float>(y) / 28.0f; });
+    sgct_core::Image * combined = sgct_core::MaskCombiner::combine(blend, blackLevel);
+
+    check(combined != NULL, "8 bit masks are combined");
+    if (combined != NULL)
+    {
+        check(combined->getBytesPerChannel() == 1, "8 bit masks give an 8 bit combined mask");
+        check(combined->getChannels() == 4 && combined->getWidth() == 16 && combined->getHeight() == 8, "combined mask has the blend mask size and four channels");
+
+        bool match = true;
+        for (std::size_t y = 0; y < 8; y++)
+            for (std::size_t x = 0; x < 16; x++)
+            {
+                float b = static_cast<float>(static_cast<int>(static_cast<float>(x) / 15.0f * 255.0f + 0.5f)) / 255.0f;
+                float l = static_cast<float>(static_cast<int>(static_cast<float>(y) / 28.0f * 255.0f + 0.5f)) / 255.0f;
+                float factor = b * (1.0f - l);
+                for (std::size_t c = 0; c < 3; c++)
+                    match = match && fabsf(readCombined(combined, x, y, c) - factor) <= 0.5f / 255.0f + 1e-6f;
+                match = match && fabsf(readCombined(combined, x, y, 3) - l) <= 0.5f / 255.0f + 1e-6f;
+            }
+        check(match, "8 bit combined mask values");
+    }
+
+    delete combined;
+    delete blend;
+    delete blackLevel;
+}
+
+void test16BitGradient()
+{
+    //a smooth 16 bit blend ramp over 4096 texels must keep more levels than 8 bits can hold
+    const std::size_t width = 4096;
+    sgct_core::Image * blend = createMask(width, 1, 2, [width](std::size_t x, std::size_t) { return static_cast<float>(x) / static_cast<float>(width - 1); });
+    sgct_core::Image * combined = sgct_core::MaskCombiner::combine(blend, NULL);
+
+    check(combined != NULL, "16 bit mask is combined");
+    if (combined != NULL)
+    {
+        check(combined->getBytesPerChannel() == 2, "16 bit mask gives a 16 bit combined mask");
+
+        std::set<unsigned short> levels;
+        float maxError = 0.0f;
+        for (std::size_t x = 0; x < width; x++)
+        {
+            unsigned short tmp;
+            memcpy(&tmp, combined->getSampleAt(x, 0), sizeof(unsigned short));
+            levels.insert(tmp);
+            maxError = fmaxf(maxError, fabsf(readCombined(combined, x, 0, 2) - static_cast<float>(x) / static_cast<float>(width - 1)));
+            check(readCombined(combined, x, 0, 3) == 0.0f, "missing black level mask adds no black level");
+        }
+        check(levels.size() > 256, "16 bit blend keeps more than 256 levels");
+        check(maxError <= 1.0f / 65535.0f + 1e-6f, "16 bit combined values");
+    }
+
+    delete combined;
+    delete blend;
+}
+
+void testMixedDepthAndResampling()
+{
+    //8 bit blend at full resolution and a 16 bit black level at half resolution
+    sgct_core::Image * blend = createMask(8, 8, 1, [](std::size_t, std::size_t) { return 1.0f; });
+    sgct_core::Image * blackLevel = createMask(4, 4, 2, [](std::size_t, std::size_t) { return 0.2f; });
+    sgct_core::Image * combined = sgct_core::MaskCombiner::combine(blend, blackLevel);
+
+    check(combined != NULL, "mixed depth masks are combined");
+    if (combined != NULL)
+    {
+        check(combined->getBytesPerChannel() == 2, "a 16 bit input gives a 16 bit combined mask");
+        check(combined->getWidth() == 8 && combined->getHeight() == 8, "the black level mask is resampled to the blend mask size");
+        check(fabsf(readCombined(combined, 3, 5, 2) - 0.8f) < 1e-4f && fabsf(readCombined(combined, 3, 5, 3) - 0.2f) < 1e-4f, "resampled black level values");
+    }
+    delete combined;
+
+    //only a black level mask, the blend is white
+    combined = sgct_core::MaskCombiner::combine(NULL, blackLevel);
+    check(combined != NULL && combined->getWidth() == 4 && fabsf(readCombined(combined, 1, 1, 0) - 0.8f) < 1e-4f, "missing blend mask is white");
+    delete combined;
+
+    glm::vec4 sample = sgct_core::MaskCombiner::readSample(blackLevel, 0.0f, 1.0f);
+    check(fabsf(sample.r - 0.2f) < 1e-4f && sample.a == 1.0f, "readSample clamps at the edges and luminance masks are opaque");
+
+    delete blend;
+    delete blackLevel;
+}
+
+int main( int argc, char* argv[] )
+{
+    testNoMasks();
+    testCombineSamples();
+    test8Bit();
+    test16BitGradient();
+    testMixedDepthAndResampling();
+
+    if (numberOfFailures > 0)
+    {
+        sgct::MessageHandler::instance()->print("%u mask combiner test(s) failed!\n", numberOfFailures);
+        return EXIT_FAILURE;
+    }
+
+    sgct::MessageHandler::instance()->print("All mask combiner tests passed.\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,243 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "sgct.h"
+#include <sgct/PostFXGraph.h>
+
+/*
+Unit tests of the post effect chain analysis (sgct_core::PostFXGraph): which passes are fused, where FXAA goes and
+which buffers the stages read and write. Hand written chains check the exact stages, random chains check that every
+enabled pass is rendered once and in order, that fusion is maximal and that no stage reads the buffer it writes.
+Doesn't need OpenGL, the process returns EXIT_FAILURE if any test fails.
+
+Usage: postFXGraphTest [-chains n]
+*/
+
+int numberOfChains = 10000;
+unsigned int numberOfFailures = 0;
+unsigned int randomState = 1;
+
+void check(bool condition, const char * test)
+{
+    if (!condition)
+    {
+        sgct::MessageHandler::instance()->print("FAILED: %s\n", test);
+        numberOfFailures++;
+    }
+}
+
+unsigned int nextRandom()
+{
+    randomState = randomState * 1664525u + 1013904223u;
+    return randomState >> 16;
+}
+
+/*!
+Creates a chain from a description with one character per pass: n is a pass that samples its neighbourhood,
+p is a per-pixel pass and - and _ are the disabled versions of them.
+*/
+std::vector<sgct_core::PostFXGraph::Pass> createChain(const char * description)
+{
+    std::vector<sgct_core::PostFXGraph::Pass> passes;
+    for (const char * c = description; *c != '\0'; c++)
+    {
+        sgct_core::PostFXGraph::Pass pass;
+        pass.enabled = *c == 'n' || *c == 'p';
+        pass.perPixel = *c == 'p' || *c == '_';
+        passes.push_back(pass);
+    }
+    return passes;
+}
+
+//the stages as a string with the passes of each stage, for example "0,1,2|3|fxaa"
+std::string describeStages(const sgct_core::PostFXGraph & graph)
+{
+    std::string description;
+    for (std::size_t i = 0; i < graph.getStages().size(); i++)
+    {
+        const sgct_core::PostFXGraph::Stage & stage = graph.getStages()[i];
+        description += i == 0 ? "" : "|";
+        description += stage.fxaa ? "fxaa" : (stage.isCopy() ? "copy" : sgct_core::PostFXGraph::getStageKey(stage));
+    }
+    return description;
+}
+
+//checks that the stages form a chain from the source to the target through the pool buffers
+bool isValidBufferChain(const sgct_core::PostFXGraph & graph)
+{
+    const std::vector<sgct_core::PostFXGraph::Stage> & stages = graph.getStages();
+    if (stages.empty() || stages.front().input != sgct_core::PostFXGraph::SourceBuffer || stages.back().output != sgct_core::PostFXGraph::TargetBuffer)
+        return false;
+
+    bool usedPool[2] = { false, false };
+    for (std::size_t i = 0; i < stages.size(); i++)
+    {
+        if (stages[i].input == stages[i].output)
+            return false;
+        if (i > 0 && stages[i].input != stages[i - 1].output)
+            return false;
+        if (i + 1 < stages.size())
+        {
+            if (stages[i].output != sgct_core::PostFXGraph::PoolBuffer0 && stages[i].output != sgct_core::PostFXGraph::PoolBuffer1)
+                return false;
+            usedPool[stages[i].output - sgct_core::PostFXGraph::PoolBuffer0] = true;
+        }
+    }
+
+    unsigned int poolBuffers = (usedPool[0] ? 1 : 0) + (usedPool[1] ? 1 : 0);
+    return poolBuffers == graph.getNumberOfPoolBuffers();
+}
+
+void testChains()
+{
+    sgct_core::PostFXGraph graph;
+
+    check(graph.update(createChain("nn"), false, true), "the first update builds the stages");
+    check(describeStages(graph) == "0|1", "passes that sample their neighbourhood get a stage each");
+    check(graph.getNumberOfPoolBuffers() == 1 && isValidBufferChain(graph), "two stages use one pool buffer");
+    check(!graph.update(createChain("nn"), false, true), "an unchanged chain isn't rebuilt");
+
+    check(graph.update(createChain("nn"), true, true), "enabling FXAA rebuilds the stages");
+    check(describeStages(graph) == "0|1|fxaa" && graph.getNumberOfPoolBuffers() == 2 && isValidBufferChain(graph), "FXAA is the last stage");
+
+    check(graph.update(createChain("n-"), true, true), "disabling a pass rebuilds the stages");
+    check(describeStages(graph) == "0|fxaa", "disabled passes are left out");
+
+    graph.update(createChain("pppnpp"), false, true);
+    check(describeStages(graph) == "0,1,2|3|4,5", "consecutive per-pixel passes are fused");
+    check(graph.getStages()[0].isFused() && !graph.getStages()[1].isFused(), "isFused");
+    check(isValidBufferChain(graph), "fused stages form a chain");
+
+    check(graph.update(createChain("pppnpp"), false, false), "disabling fusion rebuilds the stages");
+    check(describeStages(graph) == "0|1|2|3|4|5", "nothing is fused when fusion is off");
+
+    graph.update(createChain("p_p"), false, true);
+    check(describeStages(graph) == "0,2", "per-pixel passes are fused across disabled passes");
+    check(graph.getNumberOfPoolBuffers() == 0 && isValidBufferChain(graph), "a single stage renders from the source to the target");
+
+    graph.update(createChain("pnp"), true, true);
+    check(describeStages(graph) == "0|1|2|fxaa", "a pass that samples its neighbourhood ends the fusion");
+
+    graph.update(createChain("--"), false, true);
+    check(describeStages(graph) == "copy" && isValidBufferChain(graph), "a chain without enabled passes copies the source");
+
+    graph.update(createChain(""), true, true);
+    check(describeStages(graph) == "fxaa" && isValidBufferChain(graph), "FXAA alone");
+
+    graph.update(createChain("nnnnn"), false, true);
+    check(graph.getNumberOfPoolBuffers() == 2 && isValidBufferChain(graph), "long chains use two pool buffers in turns");
+
+    graph.clear();
+    check(graph.getStages().empty() && graph.getNumberOfPoolBuffers() == 0, "clear removes the stages");
+    check(graph.update(createChain("nnnnn"), false, true), "the stages are rebuilt after clear");
+}
+
+void testRandomChains()
+{
+    sgct_core::PostFXGraph graph;
+    std::size_t totalPasses = 0;
+    std::size_t totalStages = 0;
+    bool rendered = true;
+    bool maximal = true;
+    bool perPixelOnly = true;
+    bool fxaaLast = true;
+    bool buffers = true;
+
+    for (int c = 0; c < numberOfChains; c++)
+    {
+        std::vector<sgct_core::PostFXGraph::Pass> passes(nextRandom() % 13);
+        for (std::size_t i = 0; i < passes.size(); i++)
+        {
+            passes[i].enabled = nextRandom() % 4 != 0;
+            passes[i].perPixel = nextRandom() % 3 != 0;
+        }
+        bool fxaa = nextRandom() % 2 == 0;
+        bool fuse = nextRandom() % 4 != 0;
+        graph.update(passes, fxaa, fuse);
+
+        const std::vector<sgct_core::PostFXGraph::Stage> & stages = graph.getStages();
+        std::vector<std::size_t> order;
+        for (std::size_t s = 0; s < stages.size(); s++)
+        {
+            order.insert(order.end(), stages[s].passes.begin(), stages[s].passes.end());
+
+            fxaaLast = fxaaLast && stages[s].fxaa == (fxaa && s + 1 == stages.size()) && (!stages[s].fxaa || stages[s].passes.empty());
+            for (std::size_t i = 0; i < stages[s].passes.size() && stages[s].isFused(); i++)
+                perPixelOnly = perPixelOnly && fuse && passes[stages[s].passes[i]].perPixel;
+
+            //two neighbouring stages that both end and start with per-pixel passes should have been one
+            if (fuse && s > 0 && !stages[s - 1].passes.empty() && !stages[s].passes.empty())
+                maximal = maximal && !(passes[stages[s - 1].passes.back()].perPixel && passes[stages[s].passes.front()].perPixel);
+        }
+
+        std::vector<std::size_t> enabled;
+        for (std::size_t i = 0; i < passes.size(); i++)
+            if (passes[i].enabled)
+                enabled.push_back(i);
+
+        rendered = rendered && order == enabled;
+        buffers = buffers && isValidBufferChain(graph);
+
+        totalPasses += enabled.size() + (fxaa ? 1 : 0);
+        totalStages += stages.size();
+    }
+
+    check(rendered, "every enabled pass is rendered once and in order");
+    check(perPixelOnly, "only per-pixel passes are fused");
+    check(maximal, "all neighbouring per-pixel passes are fused");
+    check(fxaaLast, "FXAA is the last stage and only if enabled");
+    check(buffers, "no stage reads the buffer it writes");
+
+    sgct::MessageHandler::instance()->print("%d random chains: %u enabled passes, FXAA included, rendered in %u stages\n",
+        numberOfChains, static_cast<unsigned int>(totalPasses), static_cast<unsigned int>(totalStages));
+}
+
+void testShaderGeneration()
+{
+    std::vector<std::string> effects;
+    effects.push_back("uniform float gain;\nvec4 effect(vec4 color, vec2 uv) { return color * gain; }");
+    effects.push_back("vec4 effect(vec4 color, vec2 uv) { return vec4(1.0) - color; }");
+
+    std::string shader = sgct_core::PostFXGraph::generateFragmentShader(effects, false);
+    std::size_t define0 = shader.find("#define effect sgct_effect0\n");
+    std::size_t define1 = shader.find("#define effect sgct_effect1\n");
+    std::size_t call0 = shader.find("color = sgct_effect0(color, uv);");
+    std::size_t call1 = shader.find("color = sgct_effect1(color, uv);");
+    check(shader.compare(0, 18, "**glsl_version**\n\n") == 0, "the GLSL version is left to the shader loader");
+    check(define0 != std::string::npos && define1 != std::string::npos && define0 < define1, "each effect is renamed");
+    check(shader.find("#undef effect", define0) < define1, "the rename ends after each effect");
+    check(call0 != std::string::npos && call1 != std::string::npos && call0 < call1, "the effects are applied in order");
+    check(shader.find("uniform float gain;") != std::string::npos, "the uniforms of the effects are kept");
+    check(shader.find("texture(Tex, uv)") != std::string::npos && shader.find("Color = color;") != std::string::npos, "GLSL 3.3 input and output");
+
+    std::string fixed = sgct_core::PostFXGraph::generateFragmentShader(effects, true);
+    check(fixed.find("texture2D(Tex, uv)") != std::string::npos && fixed.find("gl_FragColor = color;") != std::string::npos, "GLSL 1.2 input and output");
+    check(fixed.find("in vec2 UV;") == std::string::npos, "no GLSL 3.3 declarations in the fixed pipeline shader");
+}
+
+int main( int argc, char* argv[] )
+{
+    for( int i = 1; i < argc; i++ )
+    {
+        if( strcmp(argv[i], "-chains") == 0 && argc > (i+1) )
+        {
+            numberOfChains = atoi(argv[i + 1]);
+            i++;
+        }
+    }
+
+    testChains();
+    testRandomChains();
+    testShaderGeneration();
+
+    if (numberOfFailures > 0)
+    {
+        sgct::MessageHandler::instance()->print("%u PostFX graph test(s) failed!\n", numberOfFailures);
+        return EXIT_FAILURE;
+    }
+
+    sgct::MessageHandler::instance()->print("All PostFX graph tests passed.\n");
+    return EXIT_SUCCESS;
+}
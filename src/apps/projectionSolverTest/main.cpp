@@ -0,0 +1,237 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <chrono>
+#include "sgct.h"
+#include <sgct/BaseViewport.h>
+#include <sgct/SGCTUser.h>
+#include <sgct/SGCTProjection.h>
+#include <sgct/SGCTProjectionSolver.h>
+
+/*
+Checks that the batched projection solver (sgct_core::SGCTProjectionSolver) gives the same frustums and
+matrices as BaseViewport::calculateFrustum and calculateNonLinearFrustum, for viewport counts that are
+and aren't multiples of the four SIMD lanes, and benchmarks the two for a stereo cubemap (six faces and
+two eyes) and a large number of viewports. The process returns EXIT_FAILURE if any result differs.
+
+Usage: projectionSolverTest [-iterations n]
+*/
+
+const float NearClippingPlane = 0.1f;
+const float FarClippingPlane = 100.0f;
+const float Tolerance = 1.0e-4f; //relative
+int iterations = 20000;
+unsigned int numberOfFailures = 0;
+
+float randomFloat(float min, float max)
+{
+    return min + (max - min) * static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
+}
+
+//the difference relative to the magnitude of the value
+float relativeDifference(float a, float b)
+{
+    return fabsf(a - b) / fmaxf(1.0f, fmaxf(fabsf(a), fabsf(b)));
+}
+
+float maxDifference(const glm::mat4 & a, const glm::mat4 & b)
+{
+    float diff = 0.0f;
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++)
+            diff = fmaxf(diff, relativeDifference(a[i][j], b[i][j]));
+    return diff;
+}
+
+struct Reference
+{
+    float frustum[4];
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 viewProjection;
+};
+
+Reference getResult(sgct_core::SGCTProjection * projection)
+{
+    Reference result;
+    result.frustum[0] = projection->getFrustum()->getLeft();
+    result.frustum[1] = projection->getFrustum()->getRight();
+    result.frustum[2] = projection->getFrustum()->getBottom();
+    result.frustum[3] = projection->getFrustum()->getTop();
+    result.view = projection->getViewMatrix();
+    result.projection = projection->getProjectionMatrix();
+    result.viewProjection = projection->getViewProjectionMatrix();
+    return result;
+}
+
+/*!
+Viewports with random field of views and orientations and a tracked user with random eye separation.
+*/
+void createViewports(std::size_t count, sgct_core::SGCTUser * user, std::vector<sgct_core::BaseViewport *> & viewports)
+{
+    for (std::size_t i = 0; i < count; i++)
+    {
+        sgct_core::BaseViewport * vp = new sgct_core::BaseViewport();
+        vp->setUser(user);
+        glm::quat rot = glm::normalize(glm::quat(randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f)));
+        vp->setViewPlaneCoordsUsingFOVs(randomFloat(10.0f, 60.0f), randomFloat(10.0f, 60.0f), randomFloat(10.0f, 60.0f), randomFloat(10.0f, 60.0f), rot, randomFloat(1.0f, 10.0f));
+        viewports.push_back(vp);
+    }
+}
+
+void deleteViewports(std::vector<sgct_core::BaseViewport *> & viewports)
+{
+    for (std::size_t i = 0; i < viewports.size(); i++)
+        delete viewports[i];
+    viewports.clear();
+}
+
+void testEquivalence(std::size_t count, bool nonLinear)
+{
+    char name[64];
+    sprintf(name, "%u %s viewport(s)", static_cast<unsigned int>(count), nonLinear ? "non linear" : "linear");
+
+    sgct_core::SGCTUser user("test");
+    user.setPos(randomFloat(-0.5f, 0.5f), randomFloat(1.0f, 2.0f), randomFloat(-0.5f, 0.5f));
+    user.setEyeSeparation(randomFloat(0.05f, 0.08f));
+    user.setOrientation(randomFloat(-30.0f, 30.0f), randomFloat(-90.0f, 90.0f), randomFloat(-10.0f, 10.0f));
+
+    std::vector<sgct_core::BaseViewport *> viewports;
+    createViewports(count, &user, viewports);
+
+    const sgct_core::Frustum::FrustumMode modes[] = { sgct_core::Frustum::MonoEye, sgct_core::Frustum::StereoLeftEye, sgct_core::Frustum::StereoRightEye };
+    std::vector<Reference> references;
+    sgct_core::SGCTProjectionSolver solver;
+    for (std::size_t m = 0; m < 3; m++)
+        for (std::size_t i = 0; i < count; i++)
+        {
+            if (nonLinear)
+            {
+                viewports[i]->calculateNonLinearFrustum(modes[m], NearClippingPlane, FarClippingPlane);
+                solver.addNonLinearViewport(viewports[i], modes[m]);
+            }
+            else
+            {
+                viewports[i]->calculateFrustum(modes[m], NearClippingPlane, FarClippingPlane);
+                solver.addViewport(viewports[i], modes[m]);
+            }
+            references.push_back(getResult(viewports[i]->getProjection(modes[m])));
+        }
+
+    //solve twice to check that the queue is kept
+    solver.solve(NearClippingPlane, FarClippingPlane);
+    solver.solve(NearClippingPlane, FarClippingPlane);
+
+    float maxError = 0.0f;
+    std::size_t index = 0;
+    for (std::size_t m = 0; m < 3; m++)
+        for (std::size_t i = 0; i < count; i++, index++)
+        {
+            Reference result = getResult(viewports[i]->getProjection(modes[m]));
+            for (int j = 0; j < 4; j++)
+                maxError = fmaxf(maxError, relativeDifference(result.frustum[j], references[index].frustum[j]));
+            maxError = fmaxf(maxError, maxDifference(result.view, references[index].view));
+            maxError = fmaxf(maxError, maxDifference(result.projection, references[index].projection));
+            maxError = fmaxf(maxError, maxDifference(result.viewProjection, references[index].viewProjection));
+        }
+
+    sgct::MessageHandler::instance()->print("%-32s projections: %4u  max relative difference: %g\n",
+        name, static_cast<unsigned int>(solver.getNumberOfProjections()), maxError);
+    if (solver.getNumberOfProjections() != 3 * count || maxError > Tolerance)
+    {
+        sgct::MessageHandler::instance()->print("FAILED: %s\n", name);
+        numberOfFailures++;
+    }
+
+    deleteViewports(viewports);
+}
+
+void benchmark(const char * name, std::size_t count, bool nonLinear)
+{
+    sgct_core::SGCTUser user("benchmark");
+    user.setPos(0.0f, 1.5f, 0.0f);
+    user.setEyeSeparation(0.065f);
+
+    std::vector<sgct_core::BaseViewport *> viewports;
+    createViewports(count, &user, viewports);
+
+    sgct_core::SGCTProjectionSolver solver;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        if (nonLinear)
+        {
+            solver.addNonLinearViewport(viewports[i], sgct_core::Frustum::StereoLeftEye);
+            solver.addNonLinearViewport(viewports[i], sgct_core::Frustum::StereoRightEye);
+        }
+        else
+        {
+            solver.addViewport(viewports[i], sgct_core::Frustum::StereoLeftEye);
+            solver.addViewport(viewports[i], sgct_core::Frustum::StereoRightEye);
+        }
+    }
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for (int n = 0; n < iterations; n++)
+        for (std::size_t i = 0; i < count; i++)
+        {
+            if (nonLinear)
+            {
+                viewports[i]->calculateNonLinearFrustum(sgct_core::Frustum::StereoLeftEye, NearClippingPlane, FarClippingPlane);
+                viewports[i]->calculateNonLinearFrustum(sgct_core::Frustum::StereoRightEye, NearClippingPlane, FarClippingPlane);
+            }
+            else
+            {
+                viewports[i]->calculateFrustum(sgct_core::Frustum::StereoLeftEye, NearClippingPlane, FarClippingPlane);
+                viewports[i]->calculateFrustum(sgct_core::Frustum::StereoRightEye, NearClippingPlane, FarClippingPlane);
+            }
+        }
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    for (int n = 0; n < iterations; n++)
+        solver.solve(NearClippingPlane, FarClippingPlane);
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+
+    double separate = std::chrono::duration<double>(t1 - t0).count() * 1e6 / iterations;
+    double batched = std::chrono::duration<double>(t2 - t1).count() * 1e6 / iterations;
+    sgct::MessageHandler::instance()->print("%-32s one at a time: %8.3f us   batched: %8.3f us   speedup: %.2fx\n",
+        name, separate, batched, separate / batched);
+
+    deleteViewports(viewports);
+}
+
+int main( int argc, char* argv[] )
+{
+    for( int i = 1; i < argc; i++ )
+    {
+        if( strcmp(argv[i], "-iterations") == 0 && argc > (i+1) )
+        {
+            iterations = atoi(argv[i + 1]);
+            i++;
+        }
+    }
+
+    srand(1);
+    const std::size_t counts[] = { 1, 3, 4, 6, 37 };
+    for (std::size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++)
+    {
+        testEquivalence(counts[i], false);
+        testEquivalence(counts[i], true);
+    }
+
+    if (iterations > 0)
+    {
+        sgct::MessageHandler::instance()->print("\nTime per frame, %d iterations:\n", iterations);
+        benchmark("stereo cubemap (6 faces)", 6, true);
+        benchmark("stereo, 64 viewports", 64, false);
+    }
+
+    if (numberOfFailures > 0)
+    {
+        sgct::MessageHandler::instance()->print("%u projection solver test(s) failed!\n", numberOfFailures);
+        return EXIT_FAILURE;
+    }
+
+    sgct::MessageHandler::instance()->print("All projection solver tests passed.\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,468 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include "sgct.h"
+#include <sgct/RenderGraph.h>
+
+/*
+Unit tests of the frame planning (sgct_core::RenderGraph): culling, pass ordering and the memory slots of
+transient resources. Hand written frames built the way Engine::buildRenderGraph builds them check the exact result,
+random graphs are checked against a reference: the live passes are the ones a side effect depends on, the order
+keeps every dependency and the number of slots is the smallest possible. Finally the time to build and compile the
+graph of a large node is measured. Doesn't need OpenGL, the process returns EXIT_FAILURE if any test fails.
+
+Usage: renderGraphTest [-graphs n] [-iterations n]
+*/
+
+int numberOfGraphs = 2000;
+int numberOfIterations = 1000;
+unsigned int numberOfFailures = 0;
+unsigned int randomState = 1;
+
+void check(bool condition, const char * test)
+{
+    if (!condition)
+    {
+        sgct::MessageHandler::instance()->print("FAILED: %s\n", test);
+        numberOfFailures++;
+    }
+}
+
+unsigned int nextRandom()
+{
+    randomState = randomState * 1664525u + 1013904223u;
+    return randomState >> 16;
+}
+
+//the window settings that the graph depends on
+struct WindowSetup
+{
+    int width;
+    int height;
+    bool visible;
+    bool renderingWhileHidden;
+    bool stereo;
+    bool splitStereo; //side-by-side or top-bottom, both eyes render to the left texture
+    int poolBuffers; //post effect pool buffers, -1 without post effects
+    std::vector<bool> cubemaps; //one per fisheye viewport, true if the viewport is enabled
+
+    WindowSetup()
+    {
+        width = 1920;
+        height = 1080;
+        visible = true;
+        renderingWhileHidden = false;
+        stereo = false;
+        splitStereo = false;
+        poolBuffers = -1;
+    }
+};
+
+struct WindowResources
+{
+    std::size_t left;
+    std::size_t right;
+    std::vector<std::size_t> transients;
+    std::vector<std::size_t> cubemaps;
+};
+
+//adds the resources and passes of the windows as Engine::buildRenderGraph does with FBOs and texture aliasing enabled
+std::vector<WindowResources> buildFrame(sgct_core::RenderGraph & graph, const std::vector<WindowSetup> & windows)
+{
+    std::vector<WindowResources> resources(windows.size());
+    std::vector<std::size_t> windowDrawBufferIndices;
+    std::size_t drawBufferIndex = 0;
+
+    for (std::size_t i = 0; i < windows.size(); i++)
+    {
+        const WindowSetup & win = windows[i];
+        WindowResources & res = resources[i];
+        bool sideEffect = !win.visible && win.renderingWhileHidden;
+
+        res.left = graph.addResource("leftEye", false, win.width, win.height, 0, i, 0);
+        res.right = win.stereo && !win.splitStereo ? graph.addResource("rightEye", false, win.width, win.height, 0, i, 1) : res.left;
+
+        const char * transientNames[] = { "postFXSource", "postFXPool0", "postFXPool1" };
+        for (int j = 0; j <= win.poolBuffers && j < 3; j++)
+            res.transients.push_back(graph.addResource(transientNames[j], true, win.width, win.height, 0, i, 2 + j));
+
+        for (std::size_t j = 0; j < win.cubemaps.size(); j++)
+            res.cubemaps.push_back(graph.addResource("cubemap", false, 1024, 1024, 0, i, -1));
+
+        std::size_t firstDrawBufferIndexInWindow = drawBufferIndex;
+        for (std::size_t eye = 0; eye < (win.stereo ? 2u : 1u); eye++)
+        {
+            bool rightEye = eye == 1;
+            drawBufferIndex = firstDrawBufferIndexInWindow;
+
+            for (std::size_t j = 0; j < win.cubemaps.size(); j++)
+                graph.write(graph.addPass(sgct_core::RenderGraph::CubemapPass, i, j, rightEye, drawBufferIndex++, false), res.cubemaps[j]);
+
+            std::size_t pass = graph.addPass(sgct_core::RenderGraph::ViewportPass, i, 0, rightEye, drawBufferIndex++, sideEffect);
+            for (std::size_t j = 0; j < win.cubemaps.size(); j++)
+                if (win.cubemaps[j])
+                    graph.read(pass, res.cubemaps[j]);
+
+            std::size_t target = rightEye ? res.right : res.left;
+            if (rightEye && target == res.left)
+                graph.read(pass, res.left);
+            graph.write(pass, target);
+
+            for (std::size_t j = 0; j < res.transients.size(); j++)
+            {
+                graph.read(pass, res.transients[j]);
+                graph.write(pass, res.transients[j]);
+            }
+        }
+
+        windowDrawBufferIndices.push_back(drawBufferIndex - 1);
+    }
+
+    for (std::size_t i = 0; i < windows.size(); i++)
+        if (windows[i].visible)
+        {
+            std::size_t pass = graph.addPass(sgct_core::RenderGraph::ScreenPass, i, 0, false, windowDrawBufferIndices[i], true);
+            graph.read(pass, resources[i].left);
+            if (resources[i].right != resources[i].left)
+                graph.read(pass, resources[i].right);
+            graph.write(pass, graph.addResource("backBuffer", false, 0, 0, 0, i, -1));
+        }
+
+    graph.compile();
+    return resources;
+}
+
+//the passes in execution order as a string of their types, for example "C0 V0 S0" for a cubemap, viewport and screen pass of window 0
+std::string describeOrder(const sgct_core::RenderGraph & graph)
+{
+    const char types[] = { 'C', 'V', 'S' };
+    std::string description;
+    for (std::size_t i = 0; i < graph.getOrder().size(); i++)
+    {
+        const sgct_core::RenderGraph::Pass & pass = graph.getPass(graph.getOrder()[i]);
+        char text[32];
+        sprintf(text, "%s%c%u%s", i == 0 ? "" : " ", types[pass.type], static_cast<unsigned int>(pass.window), pass.rightEye ? "R" : "");
+        description += text;
+    }
+    return description;
+}
+
+void testFrames()
+{
+    sgct_core::RenderGraph graph;
+    std::vector<WindowSetup> windows(1);
+    windows[0].poolBuffers = 2;
+
+    std::vector<WindowResources> res = buildFrame(graph, windows);
+    check(graph.isCompiled(), "compile");
+    check(describeOrder(graph) == "V0 S0", "a window renders its viewports and then to the screen");
+    check(graph.getNumberOfSlots() == 3, "the post effect textures of one window can't share memory");
+    check(graph.getResource(res[0].left).slot == sgct_core::RenderGraph::NoSlot, "the eye textures aren't transient");
+    check(graph.getPass(graph.getOrder()[1]).drawBufferIndex == 0, "the screen pass uses the window's draw buffer index");
+
+    graph.addPass(sgct_core::RenderGraph::ViewportPass, 0, 0, false, 0, false);
+    check(!graph.isCompiled(), "adding a pass invalidates the plan");
+    graph.clear();
+    check(graph.getNumberOfPasses() == 0 && graph.getNumberOfResources() == 0 && graph.getOrder().empty() && graph.getNumberOfSlots() == 0, "clear");
+
+    //windows of the same size share their post effect textures, others don't
+    windows.resize(3, windows[0]);
+    windows[2].width = 1280;
+    res = buildFrame(graph, windows);
+    check(describeOrder(graph) == "V0 V1 V2 S0 S1 S2", "the windows are rendered in order before the screen passes");
+    check(graph.getNumberOfSlots() == 6, "windows of the same size share the post effect textures");
+    bool shared = true;
+    for (std::size_t j = 0; j < 3; j++)
+        shared = shared && graph.getResource(res[1].transients[j]).slot == graph.getResource(res[0].transients[j]).slot &&
+            graph.getSlotOwner(graph.getResource(res[1].transients[j]).slot) == res[0].transients[j];
+    check(shared, "the first window owns the shared textures");
+    check(graph.getResource(res[2].transients[0]).slot >= 3, "a window of another size gets its own textures");
+
+    //cubemaps of disabled viewports and hidden windows are culled
+    graph.clear();
+    windows.assign(2, WindowSetup());
+    windows[0].cubemaps.push_back(true);
+    windows[0].cubemaps.push_back(false);
+    windows[0].cubemaps.push_back(true);
+    windows[1].visible = false;
+    windows[1].poolBuffers = 0;
+    windows[1].cubemaps.push_back(true);
+    res = buildFrame(graph, windows);
+    check(describeOrder(graph) == "C0 C0 V0 S0", "the passes of disabled viewports and hidden windows are culled");
+    check(graph.isCulled(1) && !graph.isCulled(0) && !graph.isCulled(2), "the cubemap of the disabled viewport is culled");
+    check(graph.getResource(res[1].transients[0]).slot == sgct_core::RenderGraph::NoSlot, "the textures of culled passes get no slot");
+
+    //unless the hidden window is rendered anyway
+    graph.clear();
+    windows[1].renderingWhileHidden = true;
+    buildFrame(graph, windows);
+    check(describeOrder(graph) == "C0 C0 V0 C1 V1 S0", "hidden windows that are rendered while hidden aren't culled");
+
+    //both eyes of split screen stereo render to the same texture in order
+    graph.clear();
+    windows.assign(1, WindowSetup());
+    windows[0].stereo = true;
+    windows[0].splitStereo = true;
+    windows[0].poolBuffers = 1;
+    windows[0].cubemaps.push_back(true);
+    buildFrame(graph, windows);
+    check(describeOrder(graph) == "C0 V0 C0R V0R S0", "split screen stereo");
+    check(graph.getNumberOfSlots() == 2, "both eyes use the same post effect textures");
+
+    //a write that is overwritten before it is read is culled
+    graph.clear();
+    std::size_t r = graph.addResource("r", false, 1, 1, 0, 0, -1);
+    std::size_t p0 = graph.addPass(sgct_core::RenderGraph::ViewportPass, 0, 0, false, 0, false);
+    std::size_t p1 = graph.addPass(sgct_core::RenderGraph::ViewportPass, 0, 0, false, 1, false);
+    std::size_t p2 = graph.addPass(sgct_core::RenderGraph::ScreenPass, 0, 0, false, 1, true);
+    std::size_t p3 = graph.addPass(sgct_core::RenderGraph::ViewportPass, 0, 0, false, 2, false);
+    graph.write(p0, r);
+    graph.write(p1, r);
+    graph.read(p2, r);
+    graph.write(p3, r);
+    graph.compile();
+    check(graph.isCulled(p0) && !graph.isCulled(p1) && !graph.isCulled(p2) && graph.isCulled(p3), "overwritten and unread writes are culled");
+}
+
+/*!
+Checks a compiled graph against a reference: a pass is live if it has side effects or if it is the last writer
+before a live pass of something the live pass reads, live passes that use a resource that one of them writes run
+in the order they were added and the transient resources of each size and format use as many slots as there are
+lifetimes overlapping at the same time.
+*/
+void checkGraph(const sgct_core::RenderGraph & graph, bool & culling, bool & ordering, bool & slots)
+{
+    std::size_t numberOfPasses = graph.getNumberOfPasses();
+    std::vector<bool> live(numberOfPasses, false);
+    for (std::size_t p = 0; p < numberOfPasses; p++)
+        live[p] = graph.getPass(p).sideEffect;
+
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (std::size_t q = 0; q < numberOfPasses; q++)
+        {
+            if (!live[q])
+                continue;
+            const std::vector<std::size_t> & reads = graph.getPass(q).reads;
+            for (std::size_t i = 0; i < reads.size(); i++)
+                for (std::size_t p = q; p-- > 0; )
+                {
+                    const std::vector<std::size_t> & writes = graph.getPass(p).writes;
+                    if (std::find(writes.begin(), writes.end(), reads[i]) != writes.end())
+                    {
+                        changed = changed || !live[p];
+                        live[p] = true;
+                        break;
+                    }
+                }
+        }
+    }
+
+    for (std::size_t p = 0; p < numberOfPasses; p++)
+        culling = culling && graph.isCulled(p) == !live[p];
+
+    //every live pass once and dependent passes in the order they were added
+    std::vector<std::size_t> position(numberOfPasses, numberOfPasses);
+    for (std::size_t i = 0; i < graph.getOrder().size(); i++)
+        position[graph.getOrder()[i]] = i;
+    for (std::size_t p = 0; p < numberOfPasses; p++)
+        ordering = ordering && (position[p] < numberOfPasses) == live[p];
+
+    for (std::size_t a = 0; a < numberOfPasses; a++)
+        for (std::size_t b = a + 1; b < numberOfPasses; b++)
+        {
+            if (!live[a] || !live[b])
+                continue;
+            const sgct_core::RenderGraph::Pass & pa = graph.getPass(a);
+            const sgct_core::RenderGraph::Pass & pb = graph.getPass(b);
+            bool conflict = false;
+            for (std::size_t i = 0; i < pa.writes.size() && !conflict; i++)
+                conflict = std::find(pb.reads.begin(), pb.reads.end(), pa.writes[i]) != pb.reads.end() ||
+                    std::find(pb.writes.begin(), pb.writes.end(), pa.writes[i]) != pb.writes.end();
+            for (std::size_t i = 0; i < pa.reads.size() && !conflict; i++)
+                conflict = std::find(pb.writes.begin(), pb.writes.end(), pa.reads[i]) != pb.writes.end();
+            if (conflict)
+                ordering = ordering && position[a] < position[b];
+        }
+
+    //lifetimes of the resources in execution order
+    std::size_t numberOfResources = graph.getNumberOfResources();
+    std::vector<std::size_t> firstUse(numberOfResources, graph.getOrder().size());
+    std::vector<std::size_t> lastUse(numberOfResources, 0);
+    for (std::size_t i = 0; i < graph.getOrder().size(); i++)
+    {
+        const sgct_core::RenderGraph::Pass & pass = graph.getPass(graph.getOrder()[i]);
+        std::vector<std::size_t> used(pass.reads);
+        used.insert(used.end(), pass.writes.begin(), pass.writes.end());
+        for (std::size_t j = 0; j < used.size(); j++)
+        {
+            firstUse[used[j]] = std::min(firstUse[used[j]], i);
+            lastUse[used[j]] = i;
+        }
+    }
+
+    std::map<std::string, std::size_t> maxOverlap;
+    std::map<std::string, std::size_t> slotsUsed;
+    std::vector<bool> counted(graph.getNumberOfSlots(), false);
+    for (std::size_t r = 0; r < numberOfResources; r++)
+    {
+        const sgct_core::RenderGraph::Resource & res = graph.getResource(r);
+        bool used = firstUse[r] < graph.getOrder().size();
+        if (!res.transient || !used)
+        {
+            slots = slots && res.slot == sgct_core::RenderGraph::NoSlot;
+            continue;
+        }
+        if (res.slot >= graph.getNumberOfSlots())
+        {
+            slots = false;
+            continue;
+        }
+
+        char key[64];
+        sprintf(key, "%dx%d:%d", res.width, res.height, res.format);
+        if (!counted[res.slot])
+        {
+            slotsUsed[key]++;
+            counted[res.slot] = true;
+        }
+
+        std::size_t overlapping = 0;
+        for (std::size_t s = 0; s < numberOfResources; s++)
+        {
+            const sgct_core::RenderGraph::Resource & other = graph.getResource(s);
+            if (!other.transient || firstUse[s] >= graph.getOrder().size() ||
+                other.width != res.width || other.height != res.height || other.format != res.format)
+                continue;
+
+            //resources in the same slot must never be used at the same time
+            bool overlap = firstUse[s] <= lastUse[r] && firstUse[r] <= lastUse[s];
+            if (s != r && other.slot == res.slot)
+                slots = slots && !overlap;
+            if (overlap && firstUse[s] <= firstUse[r])
+                overlapping++;
+        }
+        maxOverlap[key] = std::max(maxOverlap[key], overlapping);
+
+        //the owner is the first resource placed in the slot
+        std::size_t owner = graph.getSlotOwner(res.slot);
+        slots = slots && graph.getResource(owner).slot == res.slot && firstUse[owner] <= firstUse[r];
+    }
+
+    slots = slots && maxOverlap == slotsUsed;
+}
+
+void testRandomGraphs()
+{
+    bool culling = true;
+    bool ordering = true;
+    bool slots = true;
+    std::size_t totalTransients = 0;
+    std::size_t totalSlots = 0;
+
+    sgct_core::RenderGraph graph;
+    for (int g = 0; g < numberOfGraphs; g++)
+    {
+        graph.clear();
+        std::size_t numberOfResources = 1 + nextRandom() % 12;
+        for (std::size_t r = 0; r < numberOfResources; r++)
+        {
+            int size = 256 << (nextRandom() % 2);
+            graph.addResource("r", nextRandom() % 2 == 0, size, size, static_cast<int>(nextRandom() % 2), 0, -1);
+        }
+
+        std::size_t numberOfPasses = nextRandom() % 16;
+        for (std::size_t p = 0; p < numberOfPasses; p++)
+        {
+            graph.addPass(sgct_core::RenderGraph::ViewportPass, 0, 0, false, p, nextRandom() % 5 == 0);
+            std::size_t uses = nextRandom() % 4;
+            for (std::size_t i = 0; i < uses; i++)
+            {
+                std::size_t r = nextRandom() % numberOfResources;
+                if (nextRandom() % 2 == 0)
+                    graph.read(p, r);
+                else
+                    graph.write(p, r);
+            }
+        }
+
+        graph.compile();
+        checkGraph(graph, culling, ordering, slots);
+
+        for (std::size_t r = 0; r < graph.getNumberOfResources(); r++)
+            totalTransients += graph.getResource(r).slot != sgct_core::RenderGraph::NoSlot ? 1 : 0;
+        totalSlots += graph.getNumberOfSlots();
+    }
+
+    check(culling, "exactly the passes that nothing live depends on are culled");
+    check(ordering, "every live pass runs once and after the passes it depends on");
+    check(slots, "transient resources share slots without overlapping and use as few slots as possible");
+
+    sgct::MessageHandler::instance()->print("%d random graphs: %u transient resources placed in %u slots\n",
+        numberOfGraphs, static_cast<unsigned int>(totalTransients), static_cast<unsigned int>(totalSlots));
+}
+
+void benchmark()
+{
+    //a node with six stereo fisheye windows with post effects
+    std::vector<WindowSetup> windows(6);
+    for (std::size_t i = 0; i < windows.size(); i++)
+    {
+        windows[i].stereo = true;
+        windows[i].poolBuffers = 2;
+        windows[i].cubemaps.assign(6, true);
+    }
+
+    sgct_core::RenderGraph graph;
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < numberOfIterations; i++)
+    {
+        graph.clear();
+        buildFrame(graph, windows);
+    }
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+
+    sgct::MessageHandler::instance()->print("%u passes and %u resources built and compiled in %.2f us\n",
+        static_cast<unsigned int>(graph.getNumberOfPasses()), static_cast<unsigned int>(graph.getNumberOfResources()),
+        std::chrono::duration<double, std::micro>(t1 - t0).count() / numberOfIterations);
+}
+
+int main( int argc, char* argv[] )
+{
+    for( int i = 1; i < argc; i++ )
+    {
+        if( strcmp(argv[i], "-graphs") == 0 && argc > (i+1) )
+        {
+            numberOfGraphs = atoi(argv[i + 1]);
+            i++;
+        }
+        else if( strcmp(argv[i], "-iterations") == 0 && argc > (i+1) )
+        {
+            numberOfIterations = atoi(argv[i + 1]);
+            i++;
+        }
+    }
+
+    if (numberOfIterations <= 0)
+        return EXIT_FAILURE;
+
+    testFrames();
+    testRandomGraphs();
+    benchmark();
+
+    if (numberOfFailures > 0)
+    {
+        sgct::MessageHandler::instance()->print("%u render graph test(s) failed!\n", numberOfFailures);
+        return EXIT_FAILURE;
+    }
+
+    sgct::MessageHandler::instance()->print("All render graph tests passed.\n");
+    return EXIT_SUCCESS;
+}
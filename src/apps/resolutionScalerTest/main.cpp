@@ -0,0 +1,188 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "sgct.h"
+#include <sgct/ResolutionScaler.h>
+
+/*
+Simulation of the dynamic resolution scaling (sgct_core::ResolutionScaler). The frame time of a simulated
+cluster is a fixed cost plus a cost proportional to the number of pixels, the square of the scale, with
+some noise. Runs a few load scenarios and checks how the scale reacts, the process returns EXIT_FAILURE
+if any check fails.
+
+Usage: resolutionScalerTest [-verbose]
+*/
+
+const float Budget = 1.0f / 60.0f;
+bool verbose = false;
+unsigned int numberOfFailures = 0;
+unsigned int randomState = 12345;
+
+void check(bool condition, const char * scenario, const char * test)
+{
+    if (!condition)
+    {
+        sgct::MessageHandler::instance()->print("FAILED: %s: %s\n", scenario, test);
+        numberOfFailures++;
+    }
+}
+
+//uniform noise in [-1, 1], deterministic so that the runs are repeatable
+float noise()
+{
+    randomState = randomState * 1664525u + 1013904223u;
+    return static_cast<float>(randomState >> 8) / static_cast<float>(1 << 23) - 1.0f;
+}
+
+struct Result
+{
+    unsigned int changes;
+    unsigned int framesOverBudget;
+    float minScale;
+    float finalScale;
+    float finalFrameTime;
+};
+
+/*!
+Runs the scaler for a number of frames where the pixel cost at full resolution is given by loadFn(frame).
+Only the frames from startFrame are counted in the result.
+*/
+template <class LoadFn>
+Result simulate(sgct_core::ResolutionScaler & scaler, unsigned int frames, unsigned int startFrame, LoadFn loadFn)
+{
+    const float fixedCost = 0.002f;
+    Result result;
+    result.changes = 0;
+    result.framesOverBudget = 0;
+    result.minScale = scaler.getScale();
+    result.finalFrameTime = 0.0f;
+
+    for (unsigned int frame = 0; frame < frames; frame++)
+    {
+        float scale = scaler.getScale();
+        float frameTime = fixedCost + loadFn(frame) * scale * scale * (1.0f + 0.03f * noise());
+        bool changed = scaler.update(frameTime);
+
+        if (verbose && changed)
+            sgct::MessageHandler::instance()->print("  frame %5u: frame time %6.2f ms -> scale %.2f\n", frame, frameTime * 1000.0f, scaler.getScale());
+
+        if (frame >= startFrame)
+        {
+            result.changes += changed ? 1 : 0;
+            result.framesOverBudget += frameTime > Budget ? 1 : 0;
+        }
+        result.minScale = fminf(result.minScale, scaler.getScale());
+        result.finalFrameTime = frameTime;
+    }
+    result.finalScale = scaler.getScale();
+    return result;
+}
+
+void printResult(const char * scenario, const Result & result)
+{
+    sgct::MessageHandler::instance()->print("%-28s changes: %3u  over budget: %4u  min scale: %.2f  final scale: %.2f  final frame time: %5.2f ms\n",
+        scenario, result.changes, result.framesOverBudget, result.minScale, result.finalScale, result.finalFrameTime * 1000.0f);
+}
+
+int main( int argc, char* argv[] )
+{
+    for( int i = 1; i < argc; i++ )
+        if( strcmp(argv[i], "-verbose") == 0 )
+            verbose = true;
+
+    //a light scene stays at full resolution
+    {
+        const char * name = "light load";
+        sgct_core::ResolutionScaler scaler;
+        scaler.setBudget(Budget);
+        Result result = simulate(scaler, 1000, 0, [](unsigned int) { return 0.008f; });
+        printResult(name, result);
+        check(result.changes == 0 && result.finalScale == 1.0f, name, "the scale stays at the maximum");
+    }
+
+    //a heavy scene is scaled down once and then stays within the budget
+    {
+        const char * name = "heavy load";
+        sgct_core::ResolutionScaler scaler;
+        scaler.setBudget(Budget);
+        Result result = simulate(scaler, 1000, 100, [](unsigned int) { return 0.025f; });
+        printResult(name, result);
+        check(result.finalScale < 1.0f && result.finalScale >= 0.5f, name, "the scale is lowered");
+        check(result.finalFrameTime < 0.9f * Budget * 1.05f, name, "the frame time is below the upper threshold");
+        check(result.framesOverBudget == 0, name, "no frames over budget once settled");
+        check(result.changes <= 2, name, "the scale doesn't oscillate");
+    }
+
+    //the load goes up and back down, the scale follows and returns to the maximum
+    {
+        const char * name = "load step up and down";
+        sgct_core::ResolutionScaler scaler;
+        scaler.setBudget(Budget);
+        Result result = simulate(scaler, 3000, 0, [](unsigned int frame) { return frame >= 500 && frame < 1000 ? 0.022f : 0.009f; });
+        printResult(name, result);
+        check(result.minScale < 1.0f, name, "the scale is lowered while the load is high");
+        check(result.finalScale == 1.0f, name, "the scale returns to the maximum");
+    }
+
+    //a single frame just over the budget is smoothed away and doesn't change the scale
+    {
+        const char * name = "single slow frame";
+        sgct_core::ResolutionScaler scaler;
+        scaler.setBudget(Budget);
+        Result result = simulate(scaler, 1000, 0, [](unsigned int frame) { return frame == 500 ? 0.016f : 0.008f; });
+        printResult(name, result);
+        check(result.changes == 0, name, "the scale isn't changed by one slow frame");
+    }
+
+    //a large hitch, for example when loading, doesn't change the scale
+    {
+        const char * name = "single hitch";
+        sgct_core::ResolutionScaler scaler;
+        scaler.setBudget(Budget);
+        Result result = simulate(scaler, 1000, 0, [](unsigned int frame) { return frame == 500 ? 0.2f : 0.008f; });
+        printResult(name, result);
+        check(result.changes == 0, name, "the scale isn't changed by one hitch");
+    }
+
+    //a stall shorter than the frames needed to lower the scale doesn't change it either
+    {
+        const char * name = "short stall";
+        sgct_core::ResolutionScaler scaler;
+        scaler.setBudget(Budget);
+        Result result = simulate(scaler, 1000, 0, [](unsigned int frame) {
+            return frame >= 500 && frame < 500 + sgct_core::ResolutionScaler::LowerFrames - 1 ? 0.03f : 0.008f; });
+        printResult(name, result);
+        check(result.changes == 0, name, "the scale isn't changed by a short stall");
+    }
+
+    //the load is too high even at the minimum scale, the scale stays clamped at the minimum
+    {
+        const char * name = "overload";
+        sgct_core::ResolutionScaler scaler;
+        scaler.setBudget(Budget);
+        Result result = simulate(scaler, 1000, 200, [](unsigned int) { return 0.1f; });
+        printResult(name, result);
+        check(result.finalScale == 0.5f, name, "the scale is clamped to the minimum");
+        check(result.changes == 0, name, "the scale stays at the minimum");
+    }
+
+    //a load right between the thresholds settles without oscillating
+    {
+        const char * name = "load near the thresholds";
+        sgct_core::ResolutionScaler scaler;
+        scaler.setBudget(Budget);
+        Result result = simulate(scaler, 5000, 500, [](unsigned int) { return 0.0135f; });
+        printResult(name, result);
+        check(result.changes <= 1, name, "the scale doesn't oscillate");
+    }
+
+    if (numberOfFailures > 0)
+    {
+        sgct::MessageHandler::instance()->print("%u resolution scaler check(s) failed!\n", numberOfFailures);
+        return EXIT_FAILURE;
+    }
+
+    sgct::MessageHandler::instance()->print("All resolution scaler checks passed.\n");
+    return EXIT_SUCCESS;
+}
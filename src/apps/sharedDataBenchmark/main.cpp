@@ -0,0 +1,232 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <string>
+#include <chrono>
+#include "sgct.h"
+
+/*
+Benchmark of the SharedData field registry against hand-written encode and decode callbacks. The shared
+state is the one of clustertest and each frame is encoded and decoded in the same process, the decoded
+values are checked against the encoded ones. Reports the time per frame and the bytes sent per frame.
+
+Usage: sharedDataBenchmark [-frames n] [-extra]
+*/
+
+#define EXTENDED_SIZE 10000
+
+sgct::SharedDouble dt(0.0);
+sgct::SharedDouble curr_time(0.0);
+sgct::SharedWString sTimeOfDay;
+sgct::SharedBool showFPS(false);
+sgct::SharedBool extraPackages(false);
+sgct::SharedBool barrier(false);
+sgct::SharedBool resetCounter(false);
+sgct::SharedBool stats(false);
+sgct::SharedBool takeScreenshot(false);
+sgct::SharedBool slowRendering(false);
+sgct::SharedBool frametest(false);
+sgct::SharedFloat speed( 5.0f );
+sgct::SharedVector<float> extraData;
+
+int numberOfFrames = 10000;
+bool useExtraPackages = false;
+
+struct State
+{
+    double dt;
+    double time;
+    float speed;
+    bool flags[8];
+    std::wstring timeOfDay;
+};
+
+sgct::SharedBool * flagFields[8] = { &showFPS, &extraPackages, &barrier, &resetCounter, &stats, &takeScreenshot, &slowRendering, &frametest };
+
+//the clustertest callbacks
+void myEncodeFun()
+{
+    unsigned char flags = 0;
+    flags = showFPS.getVal()    ? flags | 1 : flags & ~1; //bit 1
+    flags = extraPackages.getVal() ? flags | 2 : flags & ~2; //bit 2
+    flags = barrier.getVal() ? flags | 4 : flags & ~4; //bit 3
+    flags = resetCounter.getVal() ? flags | 8 : flags & ~8; //bit 4
+    flags = stats.getVal() ? flags | 16 : flags & ~16; //bit 5
+    flags = takeScreenshot.getVal() ? flags | 32 : flags & ~32; //bit 6
+    flags = slowRendering.getVal() ? flags | 64 : flags & ~64; //bit 7
+    flags = frametest.getVal() ? flags | 128 : flags & ~128; //bit 8
+
+    sgct::SharedUChar sf(flags);
+
+    sgct::SharedData::instance()->writeDouble( &dt);
+    sgct::SharedData::instance()->writeDouble( &curr_time);
+    sgct::SharedData::instance()->writeFloat( &speed );
+    sgct::SharedData::instance()->writeUChar( &sf );
+    sgct::SharedData::instance()->writeWString( &sTimeOfDay );
+
+    if(extraPackages.getVal())
+        sgct::SharedData::instance()->writeVector( &extraData );
+}
+
+void myDecodeFun()
+{
+    sgct::SharedUChar sf;
+    sgct::SharedData::instance()->readDouble( &dt );
+    sgct::SharedData::instance()->readDouble( &curr_time );
+    sgct::SharedData::instance()->readFloat( &speed );
+    sgct::SharedData::instance()->readUChar( &sf );
+    sgct::SharedData::instance()->readWString( &sTimeOfDay );
+
+    unsigned char flags = sf.getVal();
+    showFPS.setVal(flags & 0x0001);
+    extraPackages.setVal((flags>>1) & 0x0001);
+    barrier.setVal((flags>>2) & 0x0001);
+    resetCounter.setVal((flags>>3) & 0x0001);
+    stats.setVal((flags>>4) & 0x0001);
+    takeScreenshot.setVal((flags>>5) & 0x0001);
+    slowRendering.setVal((flags>>6) & 0x0001);
+    frametest.setVal((flags>>7) & 0x0001);
+
+    if(extraPackages.getVal())
+        sgct::SharedData::instance()->readVector( &extraData );
+}
+
+//the state of the master in a frame, like clustertest only the time changes every frame
+State getState(int frame)
+{
+    State state;
+    state.dt = 1.0 / 60.0;
+    state.time = static_cast<double>(frame) / 60.0;
+    state.speed = 5.0f + static_cast<float>(frame / 600);
+    for (int i = 0; i < 8; i++)
+        state.flags[i] = false;
+    state.flags[1] = useExtraPackages;
+    state.flags[5] = (frame % 1000) == 999; //screenshot
+    char buffer[32];
+    sprintf(buffer, "%02d:%02d:%02d", (frame / 216000) % 24, (frame / 3600) % 60, (frame / 60) % 60);
+    state.timeOfDay = sgct_helpers::makeWideString(std::string(buffer));
+    return state;
+}
+
+void setState(const State & state)
+{
+    dt.setVal(state.dt);
+    curr_time.setVal(state.time);
+    speed.setVal(state.speed);
+    for (int i = 0; i < 8; i++)
+        flagFields[i]->setVal(state.flags[i]);
+    sTimeOfDay.setVal(state.timeOfDay);
+}
+
+bool isState(const State & state)
+{
+    bool result = dt.getVal() == state.dt && curr_time.getVal() == state.time && speed.getVal() == state.speed && sTimeOfDay.getVal() == state.timeOfDay;
+    for (int i = 0; i < 8; i++)
+        result = result && flagFields[i]->getVal() == state.flags[i];
+    return result && (!state.flags[1] || extraData.getSize() == EXTENDED_SIZE);
+}
+
+/*!
+Encodes and decodes all frames, before decoding the shared objects are set to the previous frame
+which is what a slave holds.
+*/
+bool runTest(const char * name)
+{
+    sgct::SharedData * sd = sgct::SharedData::instance();
+    std::vector<char> packet;
+    double encodeTime = 0.0;
+    double decodeTime = 0.0;
+    unsigned long long bytes = 0;
+    bool result = true;
+
+    State previous = getState(-1);
+    for (int frame = 0; frame < numberOfFrames && result; frame++)
+    {
+        State current = getState(frame);
+        setState(current);
+
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        sd->encode();
+        std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+
+        //decode replaces the data block so the received data must be copied first
+        std::size_t size = sd->getUserDataSize();
+        packet.assign(reinterpret_cast<const char *>(sd->getDataBlock()) + sgct_core::SGCTNetwork::mHeaderSize,
+            reinterpret_cast<const char *>(sd->getDataBlock()) + sgct_core::SGCTNetwork::mHeaderSize + size);
+        bytes += size;
+
+        setState(previous);
+        std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+        sd->decode(size > 0 ? &packet[0] : NULL, static_cast<int>(size), 0);
+        std::chrono::steady_clock::time_point t3 = std::chrono::steady_clock::now();
+
+        encodeTime += std::chrono::duration<double>(t1 - t0).count();
+        decodeTime += std::chrono::duration<double>(t3 - t2).count();
+
+        if (!isState(current))
+        {
+            sgct::MessageHandler::instance()->print("%s: decoded values of frame %d don't match!\n", name, frame);
+            result = false;
+        }
+        previous = current;
+    }
+
+    sgct::MessageHandler::instance()->print("%-36s encode: %8.3f us   decode: %8.3f us   bytes: %10.1f per frame\n",
+        name, encodeTime * 1e6 / numberOfFrames, decodeTime * 1e6 / numberOfFrames, static_cast<double>(bytes) / numberOfFrames);
+    return result;
+}
+
+int main( int argc, char* argv[] )
+{
+    for( int i = 1; i < argc; i++ )
+    {
+        if( strcmp(argv[i], "-frames") == 0 && argc > (i+1) )
+        {
+            numberOfFrames = atoi(argv[i + 1]);
+            i++;
+        }
+        else if( strcmp(argv[i], "-extra") == 0 )
+            useExtraPackages = true;
+    }
+
+    if (numberOfFrames <= 0)
+        return EXIT_FAILURE;
+
+    //allocate extra data
+    for(int i=0;i<EXTENDED_SIZE;i++)
+        extraData.addVal(static_cast<float>(rand()%500)/500.0f);
+
+    sgct::MessageHandler::instance()->print("SharedData benchmark, %d frames, extra packages %s\n\n", numberOfFrames, useExtraPackages ? "on" : "off");
+
+    sgct::SharedData * sd = sgct::SharedData::instance();
+    bool result = true;
+
+    sd->setEncodeFunction(myEncodeFun);
+    sd->setDecodeFunction(myDecodeFun);
+    result = runTest("encode/decode callbacks") && result;
+
+    //the same state as registered fields
+    sd->setEncodeFunction(NULL);
+    sd->setDecodeFunction(NULL);
+    sd->addField(0, &dt);
+    sd->addField(1, &curr_time);
+    sd->addField(2, &speed);
+    for (unsigned int i = 0; i < 8; i++)
+        sd->addField(3 + i, flagFields[i]);
+    sd->addField(11, &sTimeOfDay);
+    if (useExtraPackages)
+        sd->addField(12, &extraData);
+
+    sd->setFieldDirtyTracking(false);
+    result = runTest("field registry") && result;
+
+    sd->setFieldDirtyTracking(true);
+    result = runTest("field registry, dirty tracking") && result;
+
+    sd->clearFields();
+    sgct::SharedData::destroy();
+    sgct::MessageHandler::destroy();
+
+    return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
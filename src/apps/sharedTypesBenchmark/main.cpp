@@ -0,0 +1,181 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include "sgct.h"
+
+/*
+Contention benchmark of the shared data types. Each test runs one writer thread and a number of reader
+threads for a fixed time and reports the number of reads and writes per second. The mutex based
+LockedValue/LockedVector are the old implementation of the shared types and are compared against the
+atomic SharedFloat and the seqlock based SeqLockValue/SeqLockVector.
+
+Usage: sharedTypesBenchmark [-readers n] [-time ms]
+*/
+
+struct Pose
+{
+    float matrix[16];
+    double timestamp;
+};
+
+std::size_t numberOfReaders = 3;
+int testTime = 250; //ms
+
+struct alignas(64) Counter
+{
+    unsigned long long value;
+};
+
+template <class ReadFn, class WriteFn>
+void runTest(const char * name, ReadFn readFn, WriteFn writeFn)
+{
+    std::atomic<bool> running(true);
+    std::vector<Counter> reads(numberOfReaders);
+    Counter writes;
+    writes.value = 0;
+
+    std::vector<std::thread> readers;
+    for (std::size_t i = 0; i < numberOfReaders; i++)
+    {
+        reads[i].value = 0;
+        readers.push_back(std::thread([&readFn, &running, &reads, i]()
+        {
+            while (running.load(std::memory_order_relaxed))
+            {
+                readFn();
+                reads[i].value++;
+            }
+        }));
+    }
+
+    std::thread writer([&writeFn, &running, &writes]()
+    {
+        while (running.load(std::memory_order_relaxed))
+        {
+            writeFn(writes.value);
+            writes.value++;
+        }
+    });
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(testTime));
+    running = false;
+    writer.join();
+    for (std::size_t i = 0; i < readers.size(); i++)
+        readers[i].join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    unsigned long long totalReads = 0;
+    for (std::size_t i = 0; i < reads.size(); i++)
+        totalReads += reads[i].value;
+
+    sgct::MessageHandler::instance()->print("%-36s reads: %10.2f M/s   writes: %10.2f M/s\n",
+        name, static_cast<double>(totalReads) / seconds * 1e-6, static_cast<double>(writes.value) / seconds * 1e-6);
+}
+
+int main( int argc, char* argv[] )
+{
+    for( int i = 1; i < argc; i++ )
+    {
+        if( strcmp(argv[i], "-readers") == 0 && argc > (i+1) )
+        {
+            numberOfReaders = static_cast<std::size_t>(atoi(argv[i + 1]));
+            i++;
+        }
+        else if( strcmp(argv[i], "-time") == 0 && argc > (i+1) )
+        {
+            testTime = atoi(argv[i + 1]);
+            i++;
+        }
+    }
+
+    sgct::MessageHandler::instance()->print("Shared types contention benchmark, 1 writer and %u reader(s), %d ms per test\n\n",
+        static_cast<unsigned int>(numberOfReaders), testTime);
+
+    //scalars
+    {
+        sgct_helpers::LockedValue<float> locked(0.0f);
+        runTest("float, mutex (old SharedFloat)",
+            [&locked]() { volatile float f = locked.get(); (void)f; },
+            [&locked](unsigned long long i) { locked.set(static_cast<float>(i)); });
+
+        sgct::SharedFloat shared(0.0f);
+        runTest("float, atomic (SharedFloat)",
+            [&shared]() { volatile float f = shared.getVal(); (void)f; },
+            [&shared](unsigned long long i) { shared.setVal(static_cast<float>(i)); });
+    }
+
+    //larger POD, the type of SharedObject<T>
+    {
+        Pose pose;
+        memset(&pose, 0, sizeof(Pose));
+
+        sgct_helpers::LockedValue<Pose> locked(pose);
+        runTest("Pose (72 bytes), mutex",
+            [&locked]() { volatile double d = locked.get().timestamp; (void)d; },
+            [&locked, &pose](unsigned long long i) { pose.timestamp = static_cast<double>(i); locked.set(pose); });
+
+        sgct_helpers::SeqLockValue<Pose> seqLocked(pose);
+        runTest("Pose (72 bytes), seqlock",
+            [&seqLocked]() { volatile double d = seqLocked.get().timestamp; (void)d; },
+            [&seqLocked, &pose](unsigned long long i) { pose.timestamp = static_cast<double>(i); seqLocked.set(pose); });
+    }
+
+    //vectors, the type of SharedVector<T>
+    {
+        std::vector<float> data(256, 0.0f);
+
+        sgct_helpers::LockedVector<float> locked;
+        locked.set(&data[0], data.size());
+        runTest("vector<float>(256), mutex",
+            [&locked]() { std::vector<float> copy; locked.get(copy); },
+            [&locked](unsigned long long i) { locked.setAt(i % 256, static_cast<float>(i)); });
+
+        sgct_helpers::SeqLockVector<float> seqLocked;
+        seqLocked.set(&data[0], data.size());
+        runTest("vector<float>(256), seqlock",
+            [&seqLocked]() { std::vector<float> copy; seqLocked.get(copy); },
+            [&seqLocked](unsigned long long i) { seqLocked.setAt(i % 256, static_cast<float>(i)); });
+    }
+
+    //growth while reading, the retired buffers must be freed once the readers are done
+    {
+        sgct_helpers::SeqLockVector<float> seqLocked;
+        std::atomic<bool> running(true);
+        std::vector<std::thread> readers;
+        for (std::size_t i = 0; i < numberOfReaders; i++)
+            readers.push_back(std::thread([&seqLocked, &running]()
+            {
+                std::vector<float> copy;
+                while (running.load(std::memory_order_relaxed))
+                    seqLocked.get(copy);
+            }));
+
+        std::vector<float> data;
+        for (int i = 0; i < 4096; i++)
+        {
+            data.push_back(static_cast<float>(i));
+            seqLocked.set(&data[0], data.size());
+        }
+        running = false;
+        for (std::size_t i = 0; i < readers.size(); i++)
+            readers[i].join();
+        std::size_t retiredWhileReading = seqLocked.getNumberOfRetiredBuffers();
+        seqLocked.clear();
+
+        sgct::MessageHandler::instance()->print("\nGrowing a seqlock vector to 4096 elements one at a time: %u retired buffer(s) while reading, %u after the readers finished\n",
+            static_cast<unsigned int>(retiredWhileReading), static_cast<unsigned int>(seqLocked.getNumberOfRetiredBuffers()));
+
+        if (seqLocked.getNumberOfRetiredBuffers() != 0)
+        {
+            sgct::MessageHandler::instance()->print("Retired buffers were not freed!\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
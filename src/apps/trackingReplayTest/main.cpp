@@ -0,0 +1,369 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include <chrono>
+#include "sgct.h"
+#include <sgct/ClusterManager.h>
+#include <sgct/SGCTTrackingManager.h>
+#include <sgct/SGCTTrackingRecorder.h>
+#include <sgct/SGCTTrackingPlayer.h>
+#include <sgct/BaseViewport.h>
+#include <sgct/SGCTUser.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+/*
+Regression tests of the tracking recorder, the replay and the pose prediction filters of SGCTTrackingDevice,
+and a headless benchmark of the tracking to frustum path. A recording of three sensors moving along known
+trajectories (constant velocity, constant acceleration and constant angular velocity) is made at 120 Hz with
+jittered time stamps. It is read back and compared, then replayed into the tracking devices and the predicted
+poses are compared with the true poses. The benchmark replays the recording as fast as possible and for every
+frame predicts the head pose, updates the user and calculates the stereo frustums of six viewports.
+Doesn't need OpenGL or VRPN, the process returns EXIT_FAILURE if any test fails.
+
+Usage: trackingReplayTest [-frames n] [-file recording]
+*/
+
+const double SampleRate = 120.0;
+const int NumberOfSamples = 240;
+const double Latency = 0.02; //how far ahead the pose is predicted
+const float NearClippingPlane = 0.1f;
+const float FarClippingPlane = 100.0f;
+
+int numberOfFrames = 100000;
+std::string filename = "trackingReplayTest.trk";
+unsigned int numberOfFailures = 0;
+
+void check(bool condition, const char * test)
+{
+    if (!condition)
+    {
+        sgct::MessageHandler::instance()->print("FAILED: %s\n", test);
+        numberOfFailures++;
+    }
+}
+
+struct Trajectory
+{
+    const char * name;
+    int sensorId;
+    glm::dvec3 position;
+    glm::dvec3 velocity;
+    glm::dvec3 acceleration;
+    glm::dvec3 axis;
+    double angularVelocity; //radians per second
+};
+
+const Trajectory trajectories[] =
+{
+    { "constant velocity", 0, glm::dvec3(0.1, 1.6, -0.2), glm::dvec3(0.8, -0.1, 0.3), glm::dvec3(0.0), glm::dvec3(0.0, 1.0, 0.0), 0.0 },
+    { "constant acceleration", 1, glm::dvec3(-0.3, 1.5, 0.0), glm::dvec3(0.2, 0.0, -0.5), glm::dvec3(1.5, -0.5, 2.0), glm::dvec3(0.0, 1.0, 0.0), 0.0 },
+    { "constant angular velocity", 2, glm::dvec3(0.0, 1.7, 0.0), glm::dvec3(0.0), glm::dvec3(0.0), glm::normalize(glm::dvec3(0.2, 1.0, 0.1)), 2.5 }
+};
+const std::size_t NumberOfTrajectories = sizeof(trajectories) / sizeof(trajectories[0]);
+
+void getPose(const Trajectory & trajectory, double t, glm::dvec3 & position, glm::dquat & rotation)
+{
+    position = trajectory.position + trajectory.velocity * t + 0.5 * trajectory.acceleration * t * t;
+    rotation = glm::angleAxis(trajectory.angularVelocity * t, trajectory.axis) * glm::dquat(0.9238795, 0.0, 0.3826834, 0.0);
+}
+
+//the sample times, 120 Hz with up to half a millisecond of jitter as from a real tracking system
+double getSampleTime(int sample)
+{
+    static const double jitter[] = { 0.0, 0.3, -0.4, 0.1, 0.5, -0.2, -0.5, 0.2 };
+    return (static_cast<double>(sample) + 1.0) / SampleRate + jitter[sample % 8] * 0.001;
+}
+
+bool record()
+{
+    sgct::SGCTTrackingRecorder recorder;
+    if (!recorder.start(filename))
+        return false;
+
+    for (int i = 0; i < NumberOfSamples; i++)
+        for (std::size_t j = 0; j < NumberOfTrajectories; j++)
+        {
+            glm::dvec3 position;
+            glm::dquat rotation;
+            getPose(trajectories[j], getSampleTime(i), position, rotation);
+
+            double pos[] = { position.x, position.y, position.z };
+            double quat[] = { rotation.x, rotation.y, rotation.z, rotation.w };
+            recorder.recordSensor(0, trajectories[j].sensorId, pos, quat, getSampleTime(i));
+        }
+
+    //a button and an analog report to check the other record types
+    double axes[] = { 0.25, -0.75 };
+    recorder.recordButton(0, 0, 1, 1, getSampleTime(NumberOfSamples));
+    recorder.recordAnalog(0, 0, axes, 2, getSampleTime(NumberOfSamples));
+    recorder.stop();
+    return true;
+}
+
+void testRoundTrip()
+{
+    sgct::SGCTTrackingPlayer player;
+    check(player.open(filename), "the recording can be opened");
+
+    sgct::SGCTTrackingRecorder::Record record;
+    std::size_t count = 0;
+    bool match = true;
+    double timeOffset = 0.0; //the recorder stores the time since it was started
+    while (player.readRecord(record))
+    {
+        int i = static_cast<int>(count / NumberOfTrajectories);
+        if (count == 0)
+            timeOffset = getSampleTime(0) - record.time;
+
+        if (i < NumberOfSamples)
+        {
+            const Trajectory & trajectory = trajectories[count % NumberOfTrajectories];
+            glm::dvec3 position;
+            glm::dquat rotation;
+            getPose(trajectory, getSampleTime(i), position, rotation);
+
+            match = match && record.type == sgct::SGCTTrackingRecorder::SensorRecord && record.tracker == 0 &&
+                record.device == trajectory.sensorId && record.values.size() == 7 &&
+                record.values[0] == position.x && record.values[1] == position.y && record.values[2] == position.z &&
+                record.values[3] == rotation.x && record.values[4] == rotation.y && record.values[5] == rotation.z && record.values[6] == rotation.w &&
+                fabs(record.time + timeOffset - getSampleTime(i)) < 1e-9;
+        }
+        else if (count == NumberOfSamples * NumberOfTrajectories)
+            match = match && record.type == sgct::SGCTTrackingRecorder::ButtonRecord && record.values.size() == 2 &&
+                record.values[0] == 1.0 && record.values[1] == 1.0;
+        else
+            match = match && record.type == sgct::SGCTTrackingRecorder::AnalogRecord && record.values.size() == 2 &&
+                record.values[0] == 0.25 && record.values[1] == -0.75;
+        count++;
+    }
+
+    check(count == NumberOfSamples * NumberOfTrajectories + 2, "all records are read back");
+    check(match, "the records are read back unchanged");
+    check(player.isAtEnd(), "the player is at the end of the recording");
+}
+
+struct PredictionError
+{
+    double position; //meters
+    double rotation; //radians
+};
+
+PredictionError getError(const glm::mat4 & predicted, const Trajectory & trajectory, double t)
+{
+    glm::dvec3 position;
+    glm::dquat rotation;
+    getPose(trajectory, t, position, rotation);
+
+    //the angle of the rotation between the poses, asin is accurate for the small angles where acos isn't
+    glm::dquat delta = glm::normalize(glm::quat_cast(glm::dmat3(glm::mat3(predicted)))) * glm::conjugate(rotation);
+    PredictionError error;
+    error.position = glm::length(glm::dvec3(glm::vec3(predicted[3])) - position);
+    error.rotation = 2.0 * asin(glm::min(1.0, glm::length(glm::dvec3(delta.x, delta.y, delta.z))));
+    return error;
+}
+
+/*!
+Replays the recording into the devices and returns the largest error of the predicted poses for each trajectory.
+The first samples are skipped since the filters need a history.
+*/
+void replayPredictions(sgct::SGCTTrackingPlayer & player, sgct::SGCTTrackingDevice::PredictionMode mode, double latency,
+    PredictionError * errors, std::vector<glm::mat4> * transforms)
+{
+    sgct::SGCTTracker * tracker = sgct_core::ClusterManager::instance()->getTrackingManagerPtr()->getTrackerPtr(static_cast<size_t>(0));
+
+    for (std::size_t j = 0; j < NumberOfTrajectories; j++)
+    {
+        errors[j].position = 0.0;
+        errors[j].rotation = 0.0;
+    }
+
+    player.rewind();
+    for (int i = 0; i < NumberOfSamples; i++)
+    {
+        for (std::size_t j = 0; j < NumberOfTrajectories; j++)
+            player.playNext();
+
+        if (i < 3)
+            continue;
+
+        for (std::size_t j = 0; j < NumberOfTrajectories; j++)
+        {
+            sgct::SGCTTrackingDevice * device = tracker->getDevicePtrBySensorId(trajectories[j].sensorId);
+            glm::mat4 predicted = device->getPredictedWorldTransform(device->getTrackerTimeStamp() + latency, mode);
+            if (transforms != NULL)
+                transforms->push_back(predicted);
+
+            //the true pose at the predicted time, or at the sample time if the latency is too large to predict
+            PredictionError error = getError(predicted, trajectories[j], getSampleTime(i) + (latency < 0.1 ? latency : 0.0));
+            errors[j].position = glm::max(errors[j].position, error.position);
+            errors[j].rotation = glm::max(errors[j].rotation, error.rotation);
+        }
+    }
+}
+
+void printErrors(const char * name, const PredictionError * errors)
+{
+    char line[256];
+    int length = sprintf(line, "%-24s", name);
+    for (std::size_t j = 0; j < NumberOfTrajectories; j++)
+        length += sprintf(line + length, "  %9.3f mm %8.4f deg    ", errors[j].position * 1000.0, glm::degrees(errors[j].rotation));
+    sgct::MessageHandler::instance()->print("%s\n", line);
+}
+
+void testPrediction()
+{
+    sgct::SGCTTrackingPlayer player;
+    if (!player.open(filename))
+        return;
+
+    sgct::MessageHandler::instance()->print("\nMax error %.0f ms ahead   %-31s%-31s%-31s\n", Latency * 1000.0,
+        trajectories[0].name, trajectories[1].name, trajectories[2].name);
+
+    PredictionError none[NumberOfTrajectories];
+    PredictionError velocity[NumberOfTrajectories];
+    PredictionError acceleration[NumberOfTrajectories];
+    std::vector<glm::mat4> first;
+    std::vector<glm::mat4> second;
+    replayPredictions(player, sgct::SGCTTrackingDevice::NoPrediction, Latency, none, NULL);
+    replayPredictions(player, sgct::SGCTTrackingDevice::ConstantVelocity, Latency, velocity, NULL);
+    replayPredictions(player, sgct::SGCTTrackingDevice::ConstantAcceleration, Latency, acceleration, &first);
+    printErrors("no prediction", none);
+    printErrors("constant velocity", velocity);
+    printErrors("constant acceleration", acceleration);
+
+    //float precision of the world transform at about two meters
+    const double positionTolerance = 1.0e-5;
+    const double rotationTolerance = 1.0e-3;
+
+    double speed = glm::length(trajectories[0].velocity);
+    check(fabs(none[0].position - speed * Latency) < 1.0e-3, "without prediction the error is the distance moved");
+    check(none[2].rotation > 0.9 * trajectories[2].angularVelocity * Latency, "without prediction the rotation lags");
+
+    check(velocity[0].position < positionTolerance, "constant velocity prediction of linear motion");
+    check(velocity[2].rotation < rotationTolerance, "constant velocity prediction of a constant rotation");
+    check(velocity[1].position < none[1].position, "constant velocity prediction lowers the error of accelerating motion");
+
+    check(acceleration[0].position < positionTolerance, "constant acceleration prediction of linear motion");
+    check(acceleration[1].position < positionTolerance, "constant acceleration prediction of accelerating motion");
+    check(acceleration[2].rotation < rotationTolerance, "constant acceleration prediction of a constant rotation");
+
+    //too far ahead the pose isn't extrapolated
+    PredictionError tooFar[NumberOfTrajectories];
+    replayPredictions(player, sgct::SGCTTrackingDevice::ConstantAcceleration, 0.2, tooFar, NULL);
+    check(tooFar[0].position < positionTolerance && tooFar[1].position < positionTolerance && tooFar[2].rotation < rotationTolerance,
+        "poses aren't extrapolated beyond the max prediction time");
+
+    //a replay is deterministic
+    replayPredictions(player, sgct::SGCTTrackingDevice::ConstantAcceleration, Latency, acceleration, &second);
+    check(first.size() == second.size() && memcmp(&first[0], &second[0], first.size() * sizeof(glm::mat4)) == 0,
+        "two replays give identical predictions");
+}
+
+/*!
+The tracking path of a frame without any window: the reports since the last frame are applied to the devices,
+the head pose is predicted and the user and the stereo frustums of a cubemap are updated.
+*/
+void benchmark()
+{
+    sgct::SGCTTrackingPlayer player;
+    if (!player.open(filename))
+        return;
+
+    sgct::SGCTTrackingDevice * head = sgct_core::ClusterManager::instance()->getTrackingManagerPtr()->getTrackerPtr(static_cast<size_t>(0))->getDevicePtrBySensorId(2);
+    sgct_core::SGCTUser user("benchmark");
+    user.setEyeSeparation(0.065f);
+
+    std::vector<sgct_core::BaseViewport *> viewports;
+    const float yaw[] = { 0.0f, 90.0f, 180.0f, 270.0f, 0.0f, 0.0f };
+    const float pitch[] = { 0.0f, 0.0f, 0.0f, 0.0f, 90.0f, -90.0f };
+    for (std::size_t i = 0; i < 6; i++)
+    {
+        sgct_core::BaseViewport * vp = new sgct_core::BaseViewport();
+        vp->setUser(&user);
+        glm::quat rot = glm::angleAxis(glm::radians(yaw[i]), glm::vec3(0.0f, 1.0f, 0.0f)) * glm::angleAxis(glm::radians(pitch[i]), glm::vec3(1.0f, 0.0f, 0.0f));
+        vp->setViewPlaneCoordsUsingFOVs(45.0f, -45.0f, -45.0f, 45.0f, rot, 1.0f);
+        viewports.push_back(vp);
+    }
+
+    double replayTime = 0.0;
+    double updateTime = 0.0;
+    double frustumTime = 0.0;
+    float checksum = 0.0f;
+    for (int frame = 0; frame < numberOfFrames; frame++)
+    {
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        if (player.isAtEnd())
+            player.rewind();
+        for (std::size_t j = 0; j < NumberOfTrajectories; j++)
+            player.playNext();
+        std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+
+        user.setTransform(head->getPredictedWorldTransform(head->getTrackerTimeStamp() + Latency, sgct::SGCTTrackingDevice::ConstantAcceleration));
+        std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+
+        for (std::size_t i = 0; i < viewports.size(); i++)
+        {
+            viewports[i]->calculateFrustum(sgct_core::Frustum::StereoLeftEye, NearClippingPlane, FarClippingPlane);
+            viewports[i]->calculateFrustum(sgct_core::Frustum::StereoRightEye, NearClippingPlane, FarClippingPlane);
+        }
+        checksum += viewports[0]->getProjection(sgct_core::Frustum::StereoLeftEye)->getViewProjectionMatrix()[0][0];
+        std::chrono::steady_clock::time_point t3 = std::chrono::steady_clock::now();
+
+        replayTime += std::chrono::duration<double>(t1 - t0).count();
+        updateTime += std::chrono::duration<double>(t2 - t1).count();
+        frustumTime += std::chrono::duration<double>(t3 - t2).count();
+    }
+
+    sgct::MessageHandler::instance()->print("\nTime per frame, %d frames (checksum %g):\n", numberOfFrames, checksum);
+    sgct::MessageHandler::instance()->print("replay of %u reports         %8.3f us\n", static_cast<unsigned int>(NumberOfTrajectories), replayTime * 1e6 / numberOfFrames);
+    sgct::MessageHandler::instance()->print("head prediction and user     %8.3f us\n", updateTime * 1e6 / numberOfFrames);
+    sgct::MessageHandler::instance()->print("12 stereo frustums           %8.3f us\n", frustumTime * 1e6 / numberOfFrames);
+
+    for (std::size_t i = 0; i < viewports.size(); i++)
+        delete viewports[i];
+}
+
+int main( int argc, char* argv[] )
+{
+    for( int i = 1; i < argc; i++ )
+    {
+        if( strcmp(argv[i], "-frames") == 0 && argc > (i+1) )
+        {
+            numberOfFrames = atoi(argv[i + 1]);
+            i++;
+        }
+        else if( strcmp(argv[i], "-file") == 0 && argc > (i+1) )
+        {
+            filename = argv[i + 1];
+            i++;
+        }
+    }
+
+    //one tracker with a device per trajectory, no VRPN connections are made since no addresses are added
+    sgct::SGCTTrackingManager * tm = sgct_core::ClusterManager::instance()->getTrackingManagerPtr();
+    tm->addTracker("replay");
+    for (std::size_t j = 0; j < NumberOfTrajectories; j++)
+    {
+        tm->addDeviceToCurrentTracker(trajectories[j].name);
+        tm->getLastTrackerPtr()->getLastDevicePtr()->setSensorId(trajectories[j].sensorId);
+    }
+
+    check(record(), "the recording is written");
+    testRoundTrip();
+    testPrediction();
+    if (numberOfFrames > 0)
+        benchmark();
+
+    remove(filename.c_str());
+
+    if (numberOfFailures > 0)
+    {
+        sgct::MessageHandler::instance()->print("%u tracking replay test(s) failed!\n", numberOfFailures);
+        return EXIT_FAILURE;
+    }
+
+    sgct::MessageHandler::instance()->print("All tracking replay tests passed.\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,426 @@
+#if !(_MSC_VER >= 1400) //if not visual studio 2005 or later
+    #define _WIN32_WINNT 0x501
+#endif
+
+#ifdef __WIN32__
+    #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+#else //Use BSD sockets
+    #include <sys/types.h>
+    #include <sys/socket.h>
+    #include <sys/select.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
+    #include <netdb.h>
+    #include <unistd.h>
+    #define INVALID_SOCKET (SGCT_SOCKET)(~0)
+#endif
+
+#ifdef MSG_NOSIGNAL
+    #define SEND_FLAGS MSG_NOSIGNAL
+#else
+    #define SEND_FLAGS 0
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include "sgct.h"
+#include <sgct/ExternalControlServer.h>
+
+/*
+Loopback tests of the WebSocket transport of the external control server. A client connects to a server on
+localhost, does the handshake and sends masked frames split at arbitrary byte boundaries: text, binary,
+fragmented messages with a ping between the fragments and frames with 16 and 64 bit lengths. The replies are
+checked byte by byte: the handshake accept key, pongs, broadcast framing, close echo and the close codes for
+protocol errors and oversized messages, as well as the delayed greeting of telnet clients and the 400 reply to
+plain HTTP requests. Finally the time to receive a batch of small frames is measured.
+
+Usage: webSocketControlTest [-port n] [-messages n]
+*/
+
+const char * port = "20778";
+int numberOfMessages = 20000;
+unsigned int numberOfFailures = 0;
+
+struct Message
+{
+    std::string data;
+    bool terminated;
+};
+
+std::mutex messageMutex;
+std::vector<Message> messages;
+
+void check(bool condition, const char * test)
+{
+    if (!condition)
+    {
+        sgct::MessageHandler::instance()->print("FAILED: %s\n", test);
+        numberOfFailures++;
+    }
+}
+
+void decode(const char * data, int length, int clientId)
+{
+    Message message;
+    message.data.assign(data, static_cast<std::size_t>(length));
+    //the binary test messages start with a zero byte, text must be null terminated for the callback
+    message.terminated = length > 0 && data[0] != '\0' && data[length] == '\0';
+
+    std::unique_lock<std::mutex> lock(messageMutex);
+    messages.push_back(message);
+}
+
+std::size_t getNumberOfReceivedMessages()
+{
+    std::unique_lock<std::mutex> lock(messageMutex);
+    return messages.size();
+}
+
+//waits until the callback has received count messages in total
+bool waitForMessages(std::size_t count, int timeout)
+{
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    while (std::chrono::steady_clock::now() < end)
+    {
+        {
+            std::unique_lock<std::mutex> lock(messageMutex);
+            if (messages.size() >= count)
+                return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+void closeSocket(SGCT_SOCKET s)
+{
+#ifdef __WIN32__
+    closesocket(s);
+#else
+    close(s);
+#endif
+}
+
+SGCT_SOCKET connectClient()
+{
+    struct addrinfo *result = NULL, hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+
+    if (getaddrinfo("127.0.0.1", port, &hints, &result) != 0)
+        return INVALID_SOCKET;
+
+    SGCT_SOCKET s = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+    if (s != INVALID_SOCKET && connect(s, result->ai_addr, (int)result->ai_addrlen) != 0)
+    {
+        closeSocket(s);
+        s = INVALID_SOCKET;
+    }
+
+    freeaddrinfo(result);
+    return s;
+}
+
+void sendAll(SGCT_SOCKET s, const std::string & data)
+{
+    std::size_t offset = 0;
+    while (offset < data.size())
+    {
+        int sent = send(s, data.data() + offset, static_cast<int>(data.size() - offset), SEND_FLAGS);
+        if (sent <= 0)
+            return;
+        offset += static_cast<std::size_t>(sent);
+    }
+}
+
+/*!
+Receives until count bytes, or the terminator if not empty, have arrived, the connection is closed or the
+timeout in milliseconds has passed.
+*/
+std::string receive(SGCT_SOCKET s, std::size_t count, int timeout, const char * terminator = "")
+{
+    std::string data;
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    while (data.size() < count && (terminator[0] == '\0' || data.find(terminator) == std::string::npos))
+    {
+        long remaining = static_cast<long>(std::chrono::duration_cast<std::chrono::microseconds>(end - std::chrono::steady_clock::now()).count());
+        if (remaining <= 0)
+            break;
+
+        fd_set readSet;
+        FD_ZERO(&readSet);
+        FD_SET(s, &readSet);
+        struct timeval tv;
+        tv.tv_sec = remaining / 1000000;
+        tv.tv_usec = remaining % 1000000;
+        if (select(static_cast<int>(s) + 1, &readSet, NULL, NULL, &tv) <= 0)
+            continue;
+
+        char buffer[4096];
+        int received = recv(s, buffer, static_cast<int>(std::min(sizeof(buffer), count - data.size())), 0);
+        if (received <= 0)
+            break;
+        data.append(buffer, static_cast<std::size_t>(received));
+    }
+    return data;
+}
+
+//true if the server closes the connection within the timeout
+bool isClosed(SGCT_SOCKET s, int timeout)
+{
+    std::string rest = receive(s, 65536, timeout);
+    return rest.size() < 65536 && receive(s, 1, 0).empty();
+}
+
+//a frame as a browser sends it, masked unless told otherwise
+std::string createFrame(unsigned char opcode, const std::string & payload, bool fin = true, bool masked = true)
+{
+    std::string frame;
+    frame += static_cast<char>((fin ? 0x80 : 0x00) | opcode);
+
+    unsigned char maskBit = masked ? 0x80 : 0x00;
+    std::size_t length = payload.size();
+    if (length < 126)
+        frame += static_cast<char>(maskBit | length);
+    else if (length < 65536)
+    {
+        frame += static_cast<char>(maskBit | 126);
+        frame += static_cast<char>((length >> 8) & 0xFF);
+        frame += static_cast<char>(length & 0xFF);
+    }
+    else
+    {
+        frame += static_cast<char>(maskBit | 127);
+        for (int i = 7; i >= 0; i--)
+            frame += static_cast<char>((static_cast<uint64_t>(length) >> (i * 8)) & 0xFF);
+    }
+
+    if (!masked)
+        return frame + payload;
+
+    const char mask[4] = { 0x37, static_cast<char>(0xFA), 0x21, 0x3D };
+    frame.append(mask, 4);
+    for (std::size_t i = 0; i < length; i++)
+        frame += static_cast<char>(payload[i] ^ mask[i & 3]);
+    return frame;
+}
+
+//connects and does the handshake of the example in RFC 6455
+SGCT_SOCKET connectWebSocket(std::string * reply = NULL)
+{
+    SGCT_SOCKET s = connectClient();
+    if (s == INVALID_SOCKET)
+        return s;
+
+    sendAll(s, "GET /chat HTTP/1.1\r\nHost: localhost\r\nUpgrade: websocket\r\n");
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    sendAll(s, "Connection: keep-alive, Upgrade\r\nSec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n");
+
+    std::string response = receive(s, 4096, 1000, "\r\n\r\n");
+    if (reply != NULL)
+        *reply = response;
+    return s;
+}
+
+void testHandshake()
+{
+    std::string reply;
+    SGCT_SOCKET s = connectWebSocket(&reply);
+    check(s != INVALID_SOCKET, "connect");
+    check(reply.compare(0, 34, "HTTP/1.1 101 Switching Protocols\r\n") == 0, "handshake status line");
+    check(reply.find("\r\nSec-WebSocket-Accept: s3pPLMBiTxaQ9kYGzzhZRbK+xOo=\r\n") != std::string::npos, "handshake accept key");
+    closeSocket(s);
+}
+
+void testMessages(sgct_core::ExternalControlServer & server)
+{
+    SGCT_SOCKET s = connectWebSocket();
+    std::size_t first = getNumberOfReceivedMessages();
+
+    std::string medium(300, 'm');
+    std::string large(70000, 'l');
+    std::string frames = createFrame(0x1, "hello") +
+        createFrame(0x2, std::string("\0\x1b\x18", 3)) +
+        createFrame(0x1, "fra", false) + createFrame(0x0, "gm", false) + createFrame(0x9, "pp") + createFrame(0x0, "ent") +
+        createFrame(0x1, medium) +
+        createFrame(0x1, large);
+
+    //the first frames byte by byte so that every header and payload is split
+    for (std::size_t i = 0; i < 48; i++)
+    {
+        sendAll(s, frames.substr(i, 1));
+        if (i % 8 == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    sendAll(s, frames.substr(48));
+
+    check(waitForMessages(first + 5, 2000), "all messages are received");
+    check(receive(s, 4, 1000) == std::string("\x8a\x02pp", 4), "pings are answered with pongs");
+
+    {
+        std::unique_lock<std::mutex> lock(messageMutex);
+        if (messages.size() == first + 5)
+        {
+            check(messages[first].data == "hello" && messages[first].terminated, "text message");
+            check(messages[first + 1].data == std::string("\0\x1b\x18", 3), "binary message");
+            check(messages[first + 2].data == "fragment" && messages[first + 2].terminated, "fragmented message with a ping between the fragments");
+            check(messages[first + 3].data == medium && messages[first + 3].terminated, "16 bit length");
+            check(messages[first + 4].data == large && messages[first + 4].terminated, "64 bit length");
+        }
+    }
+
+    //messages are sent as text or binary depending on what the client last sent
+    server.sendData("status", 6);
+    check(receive(s, 8, 1000) == std::string("\x81\x06status", 8), "text broadcast");
+
+    sendAll(s, createFrame(0x2, std::string("\0", 1)));
+    waitForMessages(first + 6, 1000);
+    server.sendData("status", 6);
+    check(receive(s, 8, 1000) == std::string("\x82\x06status", 8), "binary broadcast");
+
+    sendAll(s, createFrame(0x8, std::string("\x03\xe8", 2)));
+    check(receive(s, 4, 1000) == std::string("\x88\x02\x03\xe8", 4), "close is echoed");
+    check(isClosed(s, 1000), "the connection is closed after the close frame");
+    closeSocket(s);
+}
+
+//sends the frames on a new connection and expects a close frame with the code
+void testError(const std::string & frames, const char * code, const char * test)
+{
+    SGCT_SOCKET s = connectWebSocket();
+    sendAll(s, frames);
+    bool closed = receive(s, 4, 1000) == std::string("\x88\x02", 2) + std::string(code, 2) && isClosed(s, 1000);
+    check(closed, test);
+    closeSocket(s);
+}
+
+void testErrors(sgct_core::ExternalControlServer & server)
+{
+    testError(createFrame(0x1, "unmasked", true, false), "\x03\xea", "unmasked frames are a protocol error");
+    testError(createFrame(0x3, "x"), "\x03\xea", "unknown opcodes are a protocol error");
+    testError(createFrame(0x9, "ping", false), "\x03\xea", "fragmented control frames are a protocol error");
+    testError(createFrame(0x0, "x"), "\x03\xea", "continuation without a message is a protocol error");
+    testError(createFrame(0x1, "a", false) + createFrame(0x1, "b"), "\x03\xea", "new message inside a fragmented one is a protocol error");
+
+    server.setMaxMessageSize(1024);
+    testError(createFrame(0x2, std::string(2000, 'x')), "\x03\xf1", "oversized frames are closed with 1009");
+    testError(createFrame(0x1, std::string(600, 'x'), false) + createFrame(0x0, std::string(600, 'x')), "\x03\xf1", "oversized fragmented messages are closed with 1009");
+    server.setMaxMessageSize(1024 * 1024);
+}
+
+void testOtherClients()
+{
+    //plain HTTP requests are refused
+    SGCT_SOCKET s = connectClient();
+    sendAll(s, "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    check(receive(s, 4096, 1000, "\r\n\r\n").compare(0, 12, "HTTP/1.1 400") == 0, "HTTP requests without an upgrade get 400");
+    check(isClosed(s, 1000), "the connection is closed after 400");
+    closeSocket(s);
+
+    //the greeting of telnet clients waits for a possible handshake
+    s = connectClient();
+    check(receive(s, 1, 50).empty(), "the greeting is held back");
+    check(receive(s, 20, 1000) == "Connected to SGCT!\r\n", "telnet clients get the greeting");
+    closeSocket(s);
+
+    //unless they send something first
+    s = connectClient();
+    sendAll(s, "hello\r\n");
+    check(receive(s, 24, 1000) == "Connected to SGCT!\r\nOK\r\n", "the greeting is sent when telnet clients send data");
+    closeSocket(s);
+}
+
+void benchmark()
+{
+    SGCT_SOCKET s = connectWebSocket();
+
+    std::string frames;
+    for (int i = 0; i < numberOfMessages; i++)
+    {
+        char text[64];
+        sprintf(text, "{\"speed\": %d, \"mode\": \"orbit\"}", i);
+        frames += createFrame(0x1, text);
+    }
+
+    std::size_t first = getNumberOfReceivedMessages();
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    sendAll(s, frames);
+    bool received = waitForMessages(first + static_cast<std::size_t>(numberOfMessages), 10000);
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    check(received, "all benchmark messages are received");
+
+    double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    sgct::MessageHandler::instance()->print("%d frames of %u bytes received in %.1f ms (%.2f us per message)\n",
+        numberOfMessages, static_cast<unsigned int>(frames.size() / numberOfMessages), ms, ms * 1000.0 / numberOfMessages);
+
+    closeSocket(s);
+}
+
+int main( int argc, char* argv[] )
+{
+    for( int i = 1; i < argc; i++ )
+    {
+        if( strcmp(argv[i], "-port") == 0 && argc > (i+1) )
+        {
+            port = argv[i + 1];
+            i++;
+        }
+        else if( strcmp(argv[i], "-messages") == 0 && argc > (i+1) )
+        {
+            numberOfMessages = atoi(argv[i + 1]);
+            i++;
+        }
+    }
+
+    if (numberOfMessages <= 0)
+        return EXIT_FAILURE;
+
+#ifdef __WIN32__
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+        return EXIT_FAILURE;
+#endif
+
+    //the server warns about the oversized messages that are sent on purpose
+    sgct::MessageHandler::instance()->setNotifyLevel(sgct::MessageHandler::NOTIFY_ERROR);
+
+    sgct_core::ExternalControlServer server;
+    server.setDecodeFunction(decode);
+    if (!server.init(port))
+        return EXIT_FAILURE;
+
+    testHandshake();
+    testMessages(server);
+    testErrors(server);
+    testOtherClients();
+    benchmark();
+
+    server.close();
+
+#ifdef __WIN32__
+    WSACleanup();
+#endif
+
+    if (numberOfFailures > 0)
+    {
+        sgct::MessageHandler::instance()->print("%u WebSocket test(s) failed!\n", numberOfFailures);
+        return EXIT_FAILURE;
+    }
+
+    sgct::MessageHandler::instance()->print("All WebSocket tests passed.\n");
+    return EXIT_SUCCESS;
+}
@@ -20,6 +20,7 @@ sgct_core::ClusterManager::ClusterManager(void)
     mFirmFrameLockSync = false;
     mIgnoreSync = false;
     mUseASCIIForExternalControl = true;
+    mExternalControlMaxClients = 0;
 
     SGCTUser * defaultUser = new SGCTUser("default");
     mUsers.push_back(defaultUser);
@@ -223,6 +224,24 @@ bool sgct_core::ClusterManager::getUseASCIIForExternalControl()
     return mUseASCIIForExternalControl;
 }
 
+/*!
+    Set the number of external control clients that can be connected at the same time. If set, the master uses
+    a multi-client server that accepts both ASCII lines and length-prefixed binary frames (see ExternalControlServer)
+    instead of the single connection. 0 uses the single connection.
+*/
+void sgct_core::ClusterManager::setExternalControlMaxClients(unsigned int count)
+{
+    mExternalControlMaxClients = count;
+}
+
+/*!
+    Get the number of external control clients that can be connected at the same time, 0 if the single connection is used.
+*/
+unsigned int sgct_core::ClusterManager::getExternalControlMaxClients()
+{
+    return mExternalControlMaxClients;
+}
+
 /*!
     Set the scene scale. This is set using the XML config file for easier transitions between different hardware setups.
 */
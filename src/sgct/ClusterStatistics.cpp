@@ -0,0 +1,308 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#include <sgct/ClusterStatistics.h>
+#include <sgct/Statistics.h>
+#include <sgct/MessageHandler.h>
+#include <sgct/Engine.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <fstream>
+
+sgct_core::ClusterStatistics * sgct_core::ClusterStatistics::mInstance = NULL;
+
+sgct_core::ClusterStatistics::ClusterStatistics()
+{
+    mLocalSample.nodeId = -1;
+    mLocalSample.frame = 0;
+    for (int i = 0; i < NumberOfMetrics; i++)
+        mLocalSample.values[i] = 0.0f;
+
+    mGatingNode = -1;
+    mHistoryLength = STATS_HISTORY_LENGTH;
+}
+
+/*!
+Set the sample of this node's last frame. On slaves it is sent with the next acknowledge, on the master it is added
+to the history in endFrame.
+*/
+void sgct_core::ClusterStatistics::setLocalSample(const Sample & sample)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mLocalSample = sample;
+}
+
+/*!
+Writes the local sample to a buffer of EncodedSampleSize bytes.
+*/
+void sgct_core::ClusterStatistics::encodeLocalSample(char * buffer)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    int32_t nodeId = static_cast<int32_t>(mLocalSample.nodeId);
+    uint32_t frame = static_cast<uint32_t>(mLocalSample.frame);
+    memcpy(buffer, &nodeId, 4);
+    memcpy(buffer + 4, &frame, 4);
+    memcpy(buffer + 8, mLocalSample.values, NumberOfMetrics * 4);
+}
+
+/*!
+Decodes an acknowledge message from a slave on the master. The message starts with the slave's sample and is followed
+by the slave's forwarded log messages that are passed on to the MessageHandler.
+*/
+void sgct_core::ClusterStatistics::decode(const char * receivedData, int receivedLength, int clientIndex)
+{
+    if (receivedLength < static_cast<int>(EncodedSampleSize))
+        return;
+
+    Sample sample;
+    int32_t nodeId;
+    uint32_t frame;
+    memcpy(&nodeId, receivedData, 4);
+    memcpy(&frame, receivedData + 4, 4);
+    memcpy(sample.values, receivedData + 8, NumberOfMetrics * 4);
+    sample.nodeId = nodeId;
+    sample.frame = frame;
+    addSample(sample);
+
+    if (receivedLength > static_cast<int>(EncodedSampleSize))
+        sgct::MessageHandler::instance()->decode(receivedData + EncodedSampleSize,
+            receivedLength - static_cast<int>(EncodedSampleSize), clientIndex);
+}
+
+/*!
+Adds a sample of a slave to the history. The arrival time is used to find the node that gates the frame.
+*/
+void sgct_core::ClusterStatistics::addSample(const Sample & sample)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    addSampleLocked(sample, sgct::Engine::getTime());
+}
+
+void sgct_core::ClusterStatistics::addSampleLocked(const Sample & sample, double arrival)
+{
+    NodeHistory & history = mNodes[sample.nodeId];
+    if (history.entries.empty())
+    {
+        history.lastArrival = 0.0;
+        history.gatingCount = 0;
+    }
+
+    HistoryEntry entry;
+    entry.sample = sample;
+    entry.gating = false;
+    history.entries.push_back(entry);
+    if (history.entries.size() > mHistoryLength)
+    {
+        //the count only covers the frames in the history
+        if (history.entries.front().gating)
+            history.gatingCount--;
+        history.entries.pop_front();
+    }
+
+    history.lastArrival = arrival;
+}
+
+/*!
+Called on the master when all slaves have acknowledged the frame. Adds the master's own sample and marks the node
+that gated the frame: the slave whose acknowledge arrived last if the master had to wait for it, otherwise the master.
+
+\param waitStartTime the time when the master started to wait for the slaves
+*/
+void sgct_core::ClusterStatistics::endFrame(double waitStartTime)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    int gatingNode = mLocalSample.nodeId;
+    double latestArrival = waitStartTime;
+    for (std::map<int, NodeHistory>::iterator it = mNodes.begin(); it != mNodes.end(); ++it)
+        if (it->first != mLocalSample.nodeId && it->second.lastArrival > latestArrival)
+        {
+            latestArrival = it->second.lastArrival;
+            gatingNode = it->first;
+        }
+
+    addSampleLocked(mLocalSample, waitStartTime);
+
+    //the count follows the marked entries so that it matches the history
+    NodeHistory & history = mNodes[gatingNode];
+    if (!history.entries.empty() && !history.entries.back().gating)
+    {
+        history.entries.back().gating = true;
+        history.gatingCount++;
+    }
+    mGatingNode = gatingNode;
+}
+
+/*!
+\returns the ids of all nodes that have reported statistics
+*/
+std::vector<int> sgct_core::ClusterStatistics::getNodeIds()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    std::vector<int> ids;
+    for (std::map<int, NodeHistory>::iterator it = mNodes.begin(); it != mNodes.end(); ++it)
+        ids.push_back(it->first);
+    return ids;
+}
+
+/*!
+\returns false if there is no sample of the node
+*/
+bool sgct_core::ClusterStatistics::getLatestSample(int nodeId, Sample & sample)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    std::map<int, NodeHistory>::iterator it = mNodes.find(nodeId);
+    if (it == mNodes.end() || it->second.entries.empty())
+        return false;
+
+    sample = it->second.entries.back().sample;
+    return true;
+}
+
+/*!
+\param percentile in the range [0, 100], for example 50 for the median or 99
+\returns the percentile of the metric over the node's history in seconds
+*/
+float sgct_core::ClusterStatistics::getPercentile(int nodeId, Metric metric, float percentile)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    std::map<int, NodeHistory>::iterator it = mNodes.find(nodeId);
+    if (it == mNodes.end())
+        return 0.0f;
+
+    return getPercentileLocked(it->second, metric, percentile);
+}
+
+float sgct_core::ClusterStatistics::getPercentileLocked(const NodeHistory & history, Metric metric, float percentile)
+{
+    if (history.entries.empty())
+        return 0.0f;
+
+    std::vector<float> values(history.entries.size());
+    for (std::size_t i = 0; i < values.size(); i++)
+        values[i] = history.entries[i].sample.values[metric];
+
+    //nearest rank
+    float p = percentile < 0.0f ? 0.0f : (percentile > 100.0f ? 100.0f : percentile);
+    std::size_t rank = static_cast<std::size_t>(p / 100.0f * static_cast<float>(values.size() - 1) + 0.5f);
+    std::nth_element(values.begin(), values.begin() + rank, values.end());
+    return values[rank];
+}
+
+/*!
+\returns the number of frames in the history that the node gated, the same frames that the percentiles are computed from
+*/
+unsigned int sgct_core::ClusterStatistics::getGatingCount(int nodeId)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    std::map<int, NodeHistory>::iterator it = mNodes.find(nodeId);
+    return it == mNodes.end() ? 0 : it->second.gatingCount;
+}
+
+/*!
+\returns the id of the node that gated the last frame or -1 if unknown
+*/
+int sgct_core::ClusterStatistics::getGatingNode()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    return mGatingNode;
+}
+
+/*!
+Saves the sample history of all nodes, one row per node and frame with the times in milliseconds.
+*/
+bool sgct_core::ClusterStatistics::saveCSV(const std::string & filename)
+{
+    std::ofstream file(filename.c_str());
+    if (!file.is_open())
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ClusterStatistics: Failed to create '%s'!\n", filename.c_str());
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    file << "node,frame";
+    for (int m = 0; m < NumberOfMetrics; m++)
+        file << "," << getMetricName(static_cast<Metric>(m)) << "_ms";
+    file << ",gating\n";
+
+    for (std::map<int, NodeHistory>::iterator it = mNodes.begin(); it != mNodes.end(); ++it)
+        for (std::size_t i = 0; i < it->second.entries.size(); i++)
+        {
+            const HistoryEntry & entry = it->second.entries[i];
+            file << it->first << "," << entry.sample.frame;
+            for (int m = 0; m < NumberOfMetrics; m++)
+                file << "," << entry.sample.values[m] * 1000.0f;
+            file << "," << (entry.gating ? 1 : 0) << "\n";
+        }
+
+    return true;
+}
+
+/*!
+Saves a summary with the median, 90th and 99th percentile and max of every metric per node in milliseconds.
+*/
+bool sgct_core::ClusterStatistics::saveJSON(const std::string & filename)
+{
+    std::ofstream file(filename.c_str());
+    if (!file.is_open())
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ClusterStatistics: Failed to create '%s'!\n", filename.c_str());
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    const float percentiles[] = { 50.0f, 90.0f, 99.0f, 100.0f };
+    const char * percentileNames[] = { "p50", "p90", "p99", "max" };
+
+    file << "{\n  \"nodes\": [";
+    for (std::map<int, NodeHistory>::iterator it = mNodes.begin(); it != mNodes.end(); ++it)
+    {
+        file << (it == mNodes.begin() ? "\n" : ",\n");
+        file << "    { \"node\": " << it->first
+            << ", \"frames\": " << it->second.entries.size()
+            << ", \"gating\": " << it->second.gatingCount;
+
+        for (int m = 0; m < NumberOfMetrics; m++)
+        {
+            file << ", \"" << getMetricName(static_cast<Metric>(m)) << "\": {";
+            for (int p = 0; p < 4; p++)
+                file << (p == 0 ? " " : ", ") << "\"" << percentileNames[p] << "\": "
+                    << getPercentileLocked(it->second, static_cast<Metric>(m), percentiles[p]) * 1000.0f;
+            file << " }";
+        }
+        file << " }";
+    }
+    file << "\n  ],\n  \"unit\": \"ms\"\n}\n";
+
+    return true;
+}
+
+const char * sgct_core::ClusterStatistics::getMetricName(Metric metric)
+{
+    switch (metric)
+    {
+    case FrameTime:
+        return "frame";
+    case DrawTime:
+        return "draw";
+    case SyncTime:
+        return "sync";
+    case GpuTime:
+        return "gpu";
+    default:
+        return "unknown";
+    }
+}
@@ -0,0 +1,502 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#include <sgct/CompiledConfig.h>
+#include <sgct/MessageHandler.h>
+#ifndef SGCT_DONT_USE_EXTERNAL
+#include "../include/external/zlib.h"
+#else
+#include <zlib.h>
+#endif
+#include <string.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <map>
+#include <chrono>
+#include <sstream>
+
+#ifdef __WIN32__
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#define COMPILED_CONFIG_VERSION 2
+
+const uint32_t sgct_core::CompiledConfig::NoIndex;
+
+struct sgct_core::CompiledConfig::Builder
+{
+    std::vector<Element> elements;
+    std::vector<Attribute> attributes;
+    std::vector<char> strings;
+    std::map<std::string, uint32_t> lookup;
+};
+
+sgct_core::CompiledConfig::CompiledConfig()
+{
+    mData = NULL;
+    mSize = 0;
+    mMapping = NULL;
+
+    mHeader = NULL;
+    mElements = NULL;
+    mAttributes = NULL;
+    mNodes = NULL;
+    mStrings = NULL;
+}
+
+sgct_core::CompiledConfig::~CompiledConfig()
+{
+    close();
+}
+
+/*!
+Compiles a parsed XML configuration. The Cluster element and everything below it is stored.
+
+\param sourceSize the size of the XML file that the document was parsed from
+\param sourceHash the CRC-32 of the XML file, see readSource. Stored with the size to detect changes.
+\returns false if the document has no Cluster element
+*/
+bool sgct_core::CompiledConfig::compile(const tinyxml2::XMLDocument & xmlDoc, uint64_t sourceSize, uint32_t sourceHash)
+{
+    close();
+
+    const tinyxml2::XMLElement * root = xmlDoc.FirstChildElement("Cluster");
+    if (root == NULL)
+        return false;
+
+    Builder builder;
+    addString("", builder);
+    addElement(root, builder);
+
+    std::vector<uint32_t> nodes;
+    for (uint32_t i = builder.elements[0].firstChild; i != NoIndex; i = builder.elements[i].nextSibling)
+        if (strcmp(&builder.strings[builder.elements[i].name], "Node") == 0)
+            nodes.push_back(i);
+
+    Header header;
+    memset(&header, 0, sizeof(Header));
+    memcpy(header.magic, "SGCTCFG", 7);
+    header.magic[7] = COMPILED_CONFIG_VERSION;
+    header.sourceSize = sourceSize;
+    header.sourceHash = sourceHash;
+
+    header.numElements = static_cast<uint32_t>(builder.elements.size());
+    header.numAttributes = static_cast<uint32_t>(builder.attributes.size());
+    header.numNodes = static_cast<uint32_t>(nodes.size());
+    header.stringsSize = static_cast<uint32_t>(builder.strings.size());
+
+    header.elementsOffset = static_cast<uint32_t>(sizeof(Header));
+    header.attributesOffset = header.elementsOffset + header.numElements * static_cast<uint32_t>(sizeof(Element));
+    header.nodesOffset = header.attributesOffset + header.numAttributes * static_cast<uint32_t>(sizeof(Attribute));
+    header.stringsOffset = header.nodesOffset + header.numNodes * static_cast<uint32_t>(sizeof(uint32_t));
+
+    std::vector<char> buffer(header.stringsOffset + header.stringsSize);
+    memcpy(&buffer[0], &header, sizeof(Header));
+    memcpy(&buffer[header.elementsOffset], &builder.elements[0], builder.elements.size() * sizeof(Element));
+    if (!builder.attributes.empty())
+        memcpy(&buffer[header.attributesOffset], &builder.attributes[0], builder.attributes.size() * sizeof(Attribute));
+    if (!nodes.empty())
+        memcpy(&buffer[header.nodesOffset], &nodes[0], nodes.size() * sizeof(uint32_t));
+    memcpy(&buffer[header.stringsOffset], &builder.strings[0], builder.strings.size());
+
+    mBuffer.swap(buffer);
+    return setData(&mBuffer[0], mBuffer.size());
+}
+
+/*!
+Writes the compiled configuration to a file. The file is written under a temporary name and then
+renamed so that nodes that compile the same configuration at the same time never read a partial file.
+*/
+bool sgct_core::CompiledConfig::save(const std::string & filename)
+{
+    if (mData == NULL)
+        return false;
+
+    std::stringstream ss;
+    ss << filename << "." << std::chrono::high_resolution_clock::now().time_since_epoch().count() << ".tmp";
+    std::string tmpFilename = ss.str();
+
+    FILE * file = NULL;
+#if (_MSC_VER >= 1400) //visual studio 2005 or later
+    if (fopen_s(&file, tmpFilename.c_str(), "wb") != 0)
+        file = NULL;
+#else
+    file = fopen(tmpFilename.c_str(), "wb");
+#endif
+    if (file == NULL)
+        return false;
+
+    bool success = fwrite(mData, 1, mSize, file) == mSize;
+    success = fclose(file) == 0 && success;
+
+    if (success && rename(tmpFilename.c_str(), filename.c_str()) != 0)
+    {
+        //rename doesn't replace existing files on windows
+        remove(filename.c_str());
+        success = rename(tmpFilename.c_str(), filename.c_str()) == 0;
+    }
+
+    if (!success)
+        remove(tmpFilename.c_str());
+
+    return success;
+}
+
+/*!
+Memory maps a compiled configuration.
+
+\param sourceFilename the XML file the configuration was compiled from, if not empty the file is rejected
+if the XML has changed since it was compiled
+\returns false if the file can't be opened, is corrupt or out of date
+*/
+bool sgct_core::CompiledConfig::open(const std::string & filename, const std::string & sourceFilename)
+{
+    close();
+
+    const char * data = NULL;
+    size_t size = 0;
+
+#ifdef __WIN32__
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL)
+        return false;
+
+    data = reinterpret_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (data == NULL)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    mMapping = mapping;
+    size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    void * mapped = mmap(NULL, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+        return false;
+
+    mMapping = mapped;
+    data = reinterpret_cast<const char *>(mapped);
+    size = static_cast<size_t>(st.st_size);
+#endif
+
+    if (!setData(data, size))
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "CompiledConfig: '%s' is corrupt or of an unsupported version.\n", filename.c_str());
+        close();
+        return false;
+    }
+
+    if (!sourceFilename.empty())
+    {
+        uint64_t sourceSize;
+        uint32_t sourceHash;
+        if (!getSourceHash(sourceFilename, sourceSize, sourceHash) ||
+            sourceSize != mHeader->sourceSize || sourceHash != mHeader->sourceHash)
+        {
+            close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void sgct_core::CompiledConfig::close()
+{
+    if (mMapping != NULL)
+        unmap();
+
+    mBuffer.clear();
+    mData = NULL;
+    mSize = 0;
+
+    mHeader = NULL;
+    mElements = NULL;
+    mAttributes = NULL;
+    mNodes = NULL;
+    mStrings = NULL;
+}
+
+/*!
+Creates a document with the Cluster element and all its children except the contents of the Node elements.
+The Node elements only get their attributes so that the cluster layout is known before this node is.
+*/
+bool sgct_core::CompiledConfig::extractShared(tinyxml2::XMLDocument & xmlDoc)
+{
+    if (mData == NULL)
+        return false;
+
+    tinyxml2::XMLElement * root = createRoot(xmlDoc);
+    for (uint32_t i = mElements[0].firstChild; i != NoIndex; i = mElements[i].nextSibling)
+        root->InsertEndChild(createElement(xmlDoc, i, strcmp(getString(mElements[i].name), "Node") != 0));
+
+    return true;
+}
+
+/*!
+Creates a document with an empty Cluster element and the complete Node element of the given node.
+*/
+bool sgct_core::CompiledConfig::extractNode(tinyxml2::XMLDocument & xmlDoc, unsigned int nodeIndex)
+{
+    if (mData == NULL || nodeIndex >= mHeader->numNodes)
+        return false;
+
+    tinyxml2::XMLElement * root = createRoot(xmlDoc);
+    root->InsertEndChild(createElement(xmlDoc, mNodes[nodeIndex], true));
+
+    return true;
+}
+
+/*!
+\returns the name of the compiled configuration that is cached next to an XML configuration
+*/
+std::string sgct_core::CompiledConfig::getCacheFilename(const std::string & sourceFilename)
+{
+    return sourceFilename + ".sgctc";
+}
+
+/*!
+Gets the size and modification time of a file.
+*/
+bool sgct_core::CompiledConfig::getFileStamp(const std::string & filename, uint64_t & size, int64_t & time)
+{
+    struct stat st;
+    if (stat(filename.c_str(), &st) != 0)
+        return false;
+
+    size = static_cast<uint64_t>(st.st_size);
+    time = static_cast<int64_t>(st.st_mtime);
+    return true;
+}
+
+/*!
+Reads a whole XML file and computes the CRC-32 of its contents. The compiled configuration is checked
+against the contents since the modification time only has a resolution of one second.
+*/
+bool sgct_core::CompiledConfig::readSource(const std::string & filename, std::string & contents, uint32_t & hash)
+{
+    FILE * file = NULL;
+#if (_MSC_VER >= 1400) //visual studio 2005 or later
+    if (fopen_s(&file, filename.c_str(), "rb") != 0)
+        file = NULL;
+#else
+    file = fopen(filename.c_str(), "rb");
+#endif
+    if (file == NULL)
+        return false;
+
+    contents.clear();
+    char buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        contents.append(buffer, read);
+    bool success = ferror(file) == 0;
+    fclose(file);
+    if (!success)
+        return false;
+
+    uLong crc = crc32(0L, Z_NULL, 0);
+    if (!contents.empty())
+        crc = crc32(crc, reinterpret_cast<const Bytef *>(contents.data()), static_cast<uInt>(contents.size()));
+    hash = static_cast<uint32_t>(crc);
+    return true;
+}
+
+/*!
+Gets the size and the CRC-32 of the contents of an XML file.
+*/
+bool sgct_core::CompiledConfig::getSourceHash(const std::string & filename, uint64_t & size, uint32_t & hash)
+{
+    std::string contents;
+    if (!readSource(filename, contents, hash))
+        return false;
+
+    size = static_cast<uint64_t>(contents.size());
+    return true;
+}
+
+uint32_t sgct_core::CompiledConfig::addElement(const tinyxml2::XMLElement * element, Builder & builder)
+{
+    uint32_t index = static_cast<uint32_t>(builder.elements.size());
+    builder.elements.push_back(Element());
+
+    Element e;
+    e.name = addString(element->Value(), builder);
+    e.text = element->GetText() != NULL ? addString(element->GetText(), builder) : NoIndex;
+    e.firstAttribute = static_cast<uint32_t>(builder.attributes.size());
+    e.numAttributes = 0;
+    e.firstChild = NoIndex;
+    e.nextSibling = NoIndex;
+
+    for (const tinyxml2::XMLAttribute * attr = element->FirstAttribute(); attr != NULL; attr = attr->Next())
+    {
+        Attribute a;
+        a.name = addString(attr->Name(), builder);
+        a.value = addString(attr->Value(), builder);
+        builder.attributes.push_back(a);
+        e.numAttributes++;
+    }
+    builder.elements[index] = e;
+
+    //children are stored after their parent and siblings after the subtree, in document order
+    uint32_t previous = NoIndex;
+    for (const tinyxml2::XMLElement * child = element->FirstChildElement(); child != NULL; child = child->NextSiblingElement())
+    {
+        uint32_t childIndex = addElement(child, builder);
+        if (previous == NoIndex)
+            builder.elements[index].firstChild = childIndex;
+        else
+            builder.elements[previous].nextSibling = childIndex;
+        previous = childIndex;
+    }
+
+    return index;
+}
+
+uint32_t sgct_core::CompiledConfig::addString(const char * str, Builder & builder)
+{
+    std::string key(str);
+    std::map<std::string, uint32_t>::iterator it = builder.lookup.find(key);
+    if (it != builder.lookup.end())
+        return it->second;
+
+    uint32_t offset = static_cast<uint32_t>(builder.strings.size());
+    builder.strings.insert(builder.strings.end(), key.begin(), key.end());
+    builder.strings.push_back('\0');
+    builder.lookup[key] = offset;
+    return offset;
+}
+
+tinyxml2::XMLElement * sgct_core::CompiledConfig::createElement(tinyxml2::XMLDocument & xmlDoc, uint32_t index, bool children)
+{
+    const Element & e = mElements[index];
+    tinyxml2::XMLElement * element = xmlDoc.NewElement(getString(e.name));
+
+    for (uint32_t i = e.firstAttribute; i < e.firstAttribute + e.numAttributes; i++)
+        element->SetAttribute(getString(mAttributes[i].name), getString(mAttributes[i].value));
+
+    if (e.text != NoIndex)
+        element->SetText(getString(e.text));
+
+    if (children)
+        for (uint32_t i = e.firstChild; i != NoIndex; i = mElements[i].nextSibling)
+            element->InsertEndChild(createElement(xmlDoc, i, true));
+
+    return element;
+}
+
+tinyxml2::XMLElement * sgct_core::CompiledConfig::createRoot(tinyxml2::XMLDocument & xmlDoc)
+{
+    tinyxml2::XMLElement * root = createElement(xmlDoc, 0, false);
+    xmlDoc.InsertEndChild(root);
+    return root;
+}
+
+bool sgct_core::CompiledConfig::setData(const char * data, size_t size)
+{
+    mData = data;
+    mSize = size;
+
+    if (!validate())
+    {
+        mHeader = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+/*
+    Checks that all offsets and indices are in range. Children and siblings must come after their
+    element, which also guarantees that walking the tree terminates.
+*/
+bool sgct_core::CompiledConfig::validate()
+{
+    if (mSize < sizeof(Header))
+        return false;
+
+    mHeader = reinterpret_cast<const Header *>(mData);
+    if (memcmp(mHeader->magic, "SGCTCFG", 7) != 0 || mHeader->magic[7] != COMPILED_CONFIG_VERSION)
+        return false;
+
+    if (mHeader->numElements == 0 || mHeader->stringsSize == 0 ||
+        mHeader->elementsOffset % 4 != 0 || mHeader->attributesOffset % 4 != 0 || mHeader->nodesOffset % 4 != 0 ||
+        static_cast<uint64_t>(mHeader->elementsOffset) + static_cast<uint64_t>(mHeader->numElements) * sizeof(Element) > mSize ||
+        static_cast<uint64_t>(mHeader->attributesOffset) + static_cast<uint64_t>(mHeader->numAttributes) * sizeof(Attribute) > mSize ||
+        static_cast<uint64_t>(mHeader->nodesOffset) + static_cast<uint64_t>(mHeader->numNodes) * sizeof(uint32_t) > mSize ||
+        static_cast<uint64_t>(mHeader->stringsOffset) + static_cast<uint64_t>(mHeader->stringsSize) > mSize)
+        return false;
+
+    mElements = reinterpret_cast<const Element *>(mData + mHeader->elementsOffset);
+    mAttributes = reinterpret_cast<const Attribute *>(mData + mHeader->attributesOffset);
+    mNodes = reinterpret_cast<const uint32_t *>(mData + mHeader->nodesOffset);
+    mStrings = mData + mHeader->stringsOffset;
+
+    if (mStrings[mHeader->stringsSize - 1] != '\0')
+        return false;
+
+    for (uint32_t i = 0; i < mHeader->numElements; i++)
+    {
+        const Element & e = mElements[i];
+        if (e.name >= mHeader->stringsSize ||
+            (e.text != NoIndex && e.text >= mHeader->stringsSize) ||
+            static_cast<uint64_t>(e.firstAttribute) + e.numAttributes > mHeader->numAttributes ||
+            (e.firstChild != NoIndex && (e.firstChild <= i || e.firstChild >= mHeader->numElements)) ||
+            (e.nextSibling != NoIndex && (e.nextSibling <= i || e.nextSibling >= mHeader->numElements)))
+            return false;
+    }
+
+    for (uint32_t i = 0; i < mHeader->numAttributes; i++)
+        if (mAttributes[i].name >= mHeader->stringsSize || mAttributes[i].value >= mHeader->stringsSize)
+            return false;
+
+    for (uint32_t i = 0; i < mHeader->numNodes; i++)
+        if (mNodes[i] >= mHeader->numElements)
+            return false;
+
+    return true;
+}
+
+void sgct_core::CompiledConfig::unmap()
+{
+#ifdef __WIN32__
+    UnmapViewOfFile(mData);
+    CloseHandle(reinterpret_cast<HANDLE>(mMapping));
+#else
+    munmap(mMapping, mSize);
+#endif
+    mMapping = NULL;
+}
@@ -0,0 +1,704 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#include <sgct/ConfigDistributor.h>
+#include <sgct/ReadConfig.h>
+#include <sgct/CompiledConfig.h>
+#include <sgct/ClusterManager.h>
+#include <sgct/NetworkManager.h>
+#include <sgct/MessageHandler.h>
+#include <string.h>
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <sstream>
+#include <iomanip>
+
+#ifdef __WIN32__
+    #include <direct.h>
+#else
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+//seconds to wait for the master before giving up
+#define CONFIG_DISTRIBUTION_TIMEOUT 60
+
+sgct_core::ConfigDistributor * sgct_core::ConfigDistributor::mInstance = NULL;
+
+namespace
+{
+    //attributes that reference files, mpcdi is set on windows and the others on viewports
+    const char * AssetAttributes[] = { "mpcdi", "overlay", "mask", "BlendMask", "BlackLevelMask", "mesh" };
+    const std::size_t NumberOfAssetAttributes = sizeof(AssetAttributes) / sizeof(AssetAttributes[0]);
+
+    bool isAssetAttribute(const char * elementName, const char * attributeName)
+    {
+        bool mpcdi = strcmp(attributeName, "mpcdi") == 0;
+        if (strcmp(elementName, "Window") == 0)
+            return mpcdi;
+        if (strcmp(elementName, "Viewport") != 0 || mpcdi)
+            return false;
+
+        for (std::size_t i = 1; i < NumberOfAssetAttributes; i++)
+            if (strcmp(attributeName, AssetAttributes[i]) == 0)
+                return true;
+        return false;
+    }
+
+    void writeUInt32(std::vector<char> & buffer, uint32_t value)
+    {
+        const char * p = reinterpret_cast<const char *>(&value);
+        buffer.insert(buffer.end(), p, p + 4);
+    }
+
+    void writeUInt64(std::vector<char> & buffer, uint64_t value)
+    {
+        const char * p = reinterpret_cast<const char *>(&value);
+        buffer.insert(buffer.end(), p, p + 8);
+    }
+
+    void writeString(std::vector<char> & buffer, const std::string & str)
+    {
+        writeUInt32(buffer, static_cast<uint32_t>(str.size()));
+        buffer.insert(buffer.end(), str.begin(), str.end());
+    }
+
+    bool readUInt32(const char * data, int length, int & offset, uint32_t & value)
+    {
+        if (offset + 4 > length)
+            return false;
+        memcpy(&value, data + offset, 4);
+        offset += 4;
+        return true;
+    }
+
+    bool readUInt64(const char * data, int length, int & offset, uint64_t & value)
+    {
+        if (offset + 8 > length)
+            return false;
+        memcpy(&value, data + offset, 8);
+        offset += 8;
+        return true;
+    }
+
+    bool readString(const char * data, int length, int & offset, std::string & str)
+    {
+        uint32_t size;
+        if (!readUInt32(data, length, offset, size) || size > static_cast<uint32_t>(length - offset))
+            return false;
+        str.assign(data + offset, size);
+        offset += static_cast<int>(size);
+        return true;
+    }
+
+    std::string getDirectory(const std::string & path)
+    {
+        std::size_t lastSlashPos = path.find_last_of("/");
+        return lastSlashPos != std::string::npos ? path.substr(0, lastSlashPos + 1) : std::string();
+    }
+}
+
+sgct_core::ConfigDistributor::ConfigDistributor()
+{
+    mPendingFiles = 0;
+    mHasManifest = false;
+    mHasFiles = false;
+    mFailed = false;
+}
+
+/*!
+Enables distribution of the configuration, must be set on all nodes. The directory is created if it doesn't exist
+and is only used by the slaves.
+*/
+void sgct_core::ConfigDistributor::setCacheDirectory(const std::string & directory)
+{
+    std::string dir(directory);
+    dir.erase(std::remove(dir.begin(), dir.end(), '\"'), dir.end());
+    std::replace(dir.begin(), dir.end(), '\\', '/');
+    while (dir.size() > 1 && dir[dir.size() - 1] == '/')
+        dir.erase(dir.size() - 1);
+
+    if (dir.empty())
+    {
+        mCacheDirectory.clear();
+        return;
+    }
+
+    //the cached paths replace the paths in the configuration so they must not depend on the config location
+    bool absolutePath = dir[0] == '/' || (dir.size() > 1 && dir[1] == ':');
+    if (!absolutePath)
+    {
+        char cwd[1024];
+#ifdef __WIN32__
+        if (_getcwd(cwd, sizeof(cwd)) != NULL)
+#else
+        if (getcwd(cwd, sizeof(cwd)) != NULL)
+#endif
+        {
+            std::string cwdStr(cwd);
+            std::replace(cwdStr.begin(), cwdStr.end(), '\\', '/');
+            dir = cwdStr + "/" + dir;
+        }
+    }
+
+#ifdef __WIN32__
+    _mkdir(dir.c_str());
+#else
+    mkdir(dir.c_str(), 0755);
+#endif
+
+    mCacheDirectory = dir;
+}
+
+/*!
+Packages the section of every node of the configuration on the master. The referenced files are hashed when a
+slave asks for its configuration. Called again when the configuration is reloaded, the files are hashed again then.
+*/
+bool sgct_core::ConfigDistributor::serve(ReadConfig & config)
+{
+    std::string configDirectory = getDirectory(config.getFilename());
+    std::vector<NodePackage> packages(ClusterManager::instance()->getNumberOfNodes());
+
+    std::vector<tinyxml2::XMLDocument *> xmlDocs(packages.size());
+    for (std::size_t i = 0; i < xmlDocs.size(); i++)
+        xmlDocs[i] = new tinyxml2::XMLDocument();
+
+    //the configuration is loaded once and every node is extracted from it
+    bool success = config.getNodeDocuments(xmlDocs);
+    for (std::size_t i = 0; success && i < packages.size(); i++)
+    {
+        if (xmlDocs[i]->FirstChildElement("Cluster") == NULL)
+        {
+            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ConfigDistributor: Failed to read node %u from '%s'!\n", static_cast<unsigned int>(i), config.getFilename().c_str());
+            success = false;
+            break;
+        }
+
+        packages[i].paths.push_back(config.getFilename());
+        collectAssets(xmlDocs[i]->FirstChildElement("Cluster"), configDirectory, packages[i].paths);
+
+        tinyxml2::XMLPrinter printer;
+        xmlDocs[i]->Print(&printer);
+        packages[i].xml.assign(printer.CStr());
+    }
+
+    for (std::size_t i = 0; i < xmlDocs.size(); i++)
+        delete xmlDocs[i];
+
+    if (!success)
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ConfigDistributor: Failed to read the node configurations from '%s'!\n", config.getFilename().c_str());
+        return false;
+    }
+
+    mMutex.lock();
+    mPackages.swap(packages);
+    mAssets.clear();
+    mMutex.unlock();
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "ConfigDistributor: Serving the configuration of %u nodes.\n", static_cast<unsigned int>(mPackages.size()));
+    return true;
+}
+
+/*!
+Requests the section of this node from the master and waits until it and all files that are not in the cache
+directory are received. Also used to get the new section when the master reloads the configuration. The paths of the files in the section are replaced by their paths in the cache directory.
+
+\param nodeIndex the index of this node
+\param xmlDoc is set to a document with a Cluster root and the Node element of this node
+*/
+bool sgct_core::ConfigDistributor::receive(int nodeIndex, tinyxml2::XMLDocument & xmlDoc)
+{
+    NetworkManager * nm = NetworkManager::instance();
+
+    //the data transfer connection to the master is established asynchronously
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(CONFIG_DISTRIBUTION_TIMEOUT);
+    while (nm->getActiveDataTransferConnectionsCount() == 0)
+    {
+        if (!nm->isRunning() || std::chrono::steady_clock::now() > deadline)
+        {
+            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ConfigDistributor: No data transfer connection to the master, make sure that dataTransferPort is set for the node!\n");
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    mMutex.lock();
+    mHasManifest = false;
+    mHasFiles = false;
+    mFailed = false;
+    mMutex.unlock();
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "ConfigDistributor: Requesting the configuration of node %d from the master...\n", nodeIndex);
+
+    std::vector<char> hello;
+    writeUInt32(hello, static_cast<uint32_t>(nodeIndex));
+    send(hello, HelloId, -1);
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (!waitFor(lock, mHasManifest))
+    {
+        lock.unlock();
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ConfigDistributor: The master didn't send the configuration, make sure that it is started with -distributeConfig too!\n");
+        return false;
+    }
+
+    //request the files that are not cached
+    std::vector<char> request;
+    std::vector<uint32_t> missing;
+    mLocalPaths.resize(mManifestAssets.size());
+    for (std::size_t i = 0; i < mManifestAssets.size(); i++)
+    {
+        mLocalPaths[i] = getCachePath(mManifestAssets[i]);
+
+        uint64_t size;
+        int64_t time;
+        if (!CompiledConfig::getFileStamp(mLocalPaths[i], size, time) || size != mManifestAssets[i].size)
+            missing.push_back(static_cast<uint32_t>(i));
+    }
+
+    writeUInt32(request, static_cast<uint32_t>(missing.size()));
+    for (std::size_t i = 0; i < missing.size(); i++)
+        writeUInt32(request, missing[i]);
+
+    mPendingFiles = static_cast<unsigned int>(missing.size());
+    mHasFiles = mPendingFiles == 0;
+    std::size_t numberOfAssets = mManifestAssets.size();
+    lock.unlock();
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "ConfigDistributor: %u of %u files are cached, requesting %u files.\n",
+        static_cast<unsigned int>(numberOfAssets - missing.size()), static_cast<unsigned int>(numberOfAssets), static_cast<unsigned int>(missing.size()));
+    send(request, RequestId, -1);
+
+    lock.lock();
+    bool received = waitFor(lock, mHasFiles) && !mFailed;
+    lock.unlock();
+    if (!received)
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ConfigDistributor: Failed to receive the configuration files from the master!\n");
+        return false;
+    }
+
+    //the first file is the configuration itself
+    std::string configDirectory = getDirectory(mManifestAssets[0].path);
+    std::map<std::string, std::string> localPaths;
+    for (std::size_t i = 1; i < mManifestAssets.size(); i++)
+        localPaths[mManifestAssets[i].path] = mLocalPaths[i];
+
+    if (xmlDoc.Parse(mManifestXml.c_str(), mManifestXml.size()) != tinyxml2::XML_NO_ERROR || xmlDoc.FirstChildElement("Cluster") == NULL)
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ConfigDistributor: Failed to parse the configuration received from the master!\n");
+        return false;
+    }
+    replaceAssets(xmlDoc.FirstChildElement("Cluster"), configDirectory, localPaths);
+
+    std::vector<char> configData;
+    std::string configName = mManifestAssets[0].path.substr(configDirectory.size());
+    if (!readFile(mLocalPaths[0], configData) || !writeFile(mCacheDirectory + "/" + configName, configData.empty() ? "" : &configData[0], configData.size()))
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "ConfigDistributor: Failed to store a copy of '%s' in '%s'.\n", configName.c_str(), mCacheDirectory.c_str());
+
+    std::vector<char> complete;
+    writeUInt32(complete, static_cast<uint32_t>(missing.size()));
+    send(complete, CompleteId, -1);
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "ConfigDistributor: Received the configuration of node %d.\n", nodeIndex);
+    return true;
+}
+
+/*!
+Handles a distribution package from the data transfer connection with the id clientId.
+*/
+void sgct_core::ConfigDistributor::decode(const char * receivedData, int receivedLength, int packageId, int clientId)
+{
+    switch (packageId)
+    {
+    case HelloId:
+        {
+            int offset = 0;
+            uint32_t nodeIndex;
+            if (readUInt32(receivedData, receivedLength, offset, nodeIndex))
+            {
+                mMutex.lock();
+                mClientNodes[clientId] = static_cast<int>(nodeIndex);
+                mMutex.unlock();
+                sendManifest(static_cast<int>(nodeIndex), clientId);
+            }
+        }
+        break;
+
+    case ManifestId:
+        decodeManifest(receivedData, receivedLength);
+        break;
+
+    case RequestId:
+        sendFiles(receivedData, receivedLength, clientId);
+        break;
+
+    case FileId:
+        decodeFile(receivedData, receivedLength);
+        break;
+
+    case CompleteId:
+        {
+            int offset = 0;
+            uint32_t numberOfFiles = 0;
+            readUInt32(receivedData, receivedLength, offset, numberOfFiles);
+
+            mMutex.lock();
+            int nodeIndex = mClientNodes.count(clientId) > 0 ? mClientNodes[clientId] : -1;
+            mMutex.unlock();
+            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "ConfigDistributor: Node %d received its configuration (%u files transferred).\n", nodeIndex, numberOfFiles);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+void sgct_core::ConfigDistributor::sendManifest(int nodeIndex, int clientId)
+{
+    std::vector<char> buffer;
+    std::vector<std::string> missing;
+
+    mMutex.lock();
+    if (nodeIndex < 0 || nodeIndex >= static_cast<int>(mPackages.size()))
+    {
+        mMutex.unlock();
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ConfigDistributor: Node %d requested its configuration but it is not distributed!\n", nodeIndex);
+        return;
+    }
+
+    const NodePackage & package = mPackages[nodeIndex];
+    std::vector<Asset> assets;
+    for (std::size_t i = 0; i < package.paths.size(); i++)
+    {
+        Asset asset;
+        if (getAsset(package.paths[i], asset))
+            assets.push_back(asset);
+        else
+            missing.push_back(package.paths[i]);
+    }
+
+    //the slave requests files by their index in the manifest
+    std::vector<std::string> & files = mClientFiles[clientId];
+    files.clear();
+
+    writeString(buffer, package.xml);
+    writeUInt32(buffer, static_cast<uint32_t>(assets.size()));
+    for (std::size_t i = 0; i < assets.size(); i++)
+    {
+        writeUInt64(buffer, assets[i].hash);
+        writeUInt64(buffer, assets[i].size);
+        writeString(buffer, assets[i].path);
+        files.push_back(assets[i].path);
+    }
+    mMutex.unlock();
+
+    //files that are missing on the master are left for the slave to find itself
+    for (std::size_t i = 0; i < missing.size(); i++)
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "ConfigDistributor: Failed to read '%s' for node %d!\n", missing[i].c_str(), nodeIndex);
+
+    send(buffer, ManifestId, clientId);
+}
+
+void sgct_core::ConfigDistributor::sendFiles(const char * receivedData, int receivedLength, int clientId)
+{
+    int offset = 0;
+    uint32_t count;
+    if (!readUInt32(receivedData, receivedLength, offset, count))
+        return;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t index;
+        if (!readUInt32(receivedData, receivedLength, offset, index))
+            return;
+
+        std::string path;
+        mMutex.lock();
+        std::map<int, std::vector<std::string> >::iterator it = mClientFiles.find(clientId);
+        if (it != mClientFiles.end() && index < it->second.size())
+            path = it->second[index];
+        mMutex.unlock();
+
+        std::vector<char> buffer;
+        writeUInt32(buffer, index);
+        std::size_t headerSize = buffer.size();
+        if (path.empty() || !readFile(path, buffer) || buffer.size() - headerSize > static_cast<std::size_t>(0x7FFFFFFF - 64))
+        {
+            //an empty file package tells the slave that the file is not available
+            buffer.resize(headerSize);
+            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ConfigDistributor: Failed to send file %u to connection %d!\n", index, clientId);
+        }
+
+        send(buffer, FileId, clientId);
+    }
+}
+
+/*!
+Must be called with the mutex locked. Files are only hashed once.
+*/
+bool sgct_core::ConfigDistributor::getAsset(const std::string & path, Asset & asset)
+{
+    std::map<std::string, Asset>::iterator it = mAssets.find(path);
+    if (it != mAssets.end())
+    {
+        asset = it->second;
+        return true;
+    }
+
+    std::vector<char> data;
+    if (!readFile(path, data))
+        return false;
+
+    asset.hash = getHash(data.empty() ? NULL : &data[0], data.size());
+    asset.size = static_cast<uint64_t>(data.size());
+    asset.path = path;
+    mAssets[path] = asset;
+    return true;
+}
+
+/*!
+Sends a package to the data transfer connection with the id clientId or to the master if clientId is negative.
+*/
+void sgct_core::ConfigDistributor::send(const std::vector<char> & data, int packageId, int clientId)
+{
+    NetworkManager * nm = NetworkManager::instance();
+    if (nm == NULL || data.empty())
+        return;
+
+    if (clientId < 0)
+    {
+        nm->transferData(&data[0], static_cast<int>(data.size()), packageId);
+        return;
+    }
+
+    unsigned int numberOfConnections = nm->getConnectionsCount();
+    for (unsigned int i = 0; i < numberOfConnections; i++)
+        if (nm->getConnectionByIndex(i)->getId() == clientId)
+        {
+            nm->transferData(&data[0], static_cast<int>(data.size()), packageId, nm->getConnectionByIndex(i));
+            break;
+        }
+}
+
+void sgct_core::ConfigDistributor::decodeManifest(const char * receivedData, int receivedLength)
+{
+    int offset = 0;
+    std::string xml;
+    uint32_t count = 0;
+    bool valid = readString(receivedData, receivedLength, offset, xml) && readUInt32(receivedData, receivedLength, offset, count);
+
+    std::vector<Asset> assets;
+    for (uint32_t i = 0; valid && i < count; i++)
+    {
+        Asset asset;
+        valid = readUInt64(receivedData, receivedLength, offset, asset.hash) &&
+            readUInt64(receivedData, receivedLength, offset, asset.size) &&
+            readString(receivedData, receivedLength, offset, asset.path);
+        assets.push_back(asset);
+    }
+
+    //the configuration is always the first file
+    if (!valid || assets.empty())
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ConfigDistributor: Invalid configuration received from the master!\n");
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mManifestXml.swap(xml);
+    mManifestAssets.swap(assets);
+    mHasManifest = true;
+    mCond.notify_all();
+}
+
+void sgct_core::ConfigDistributor::decodeFile(const char * receivedData, int receivedLength)
+{
+    int offset = 0;
+    uint32_t index;
+    if (!readUInt32(receivedData, receivedLength, offset, index))
+        return;
+
+    mMutex.lock();
+    bool valid = index < mManifestAssets.size() && index < mLocalPaths.size();
+    Asset asset;
+    std::string localPath;
+    if (valid)
+    {
+        asset = mManifestAssets[index];
+        localPath = mLocalPaths[index];
+    }
+    mMutex.unlock();
+
+    const char * data = receivedData + offset;
+    std::size_t size = static_cast<std::size_t>(receivedLength - offset);
+    bool success = valid &&
+        size == asset.size &&
+        getHash(data, size) == asset.hash &&
+        writeFile(localPath, data, size);
+
+    if (!success)
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ConfigDistributor: Failed to receive '%s'!\n", valid ? asset.path.c_str() : "unknown file");
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (!success)
+        mFailed = true;
+    if (mPendingFiles > 0)
+        mPendingFiles--;
+    mHasFiles = mPendingFiles == 0;
+    mCond.notify_all();
+}
+
+/*!
+Waits until the condition is true. Gives up if nothing is received from the master for CONFIG_DISTRIBUTION_TIMEOUT seconds.
+*/
+bool sgct_core::ConfigDistributor::waitFor(std::unique_lock<std::mutex> & lock, const bool & condition)
+{
+    while (!condition)
+        if (mCond.wait_for(lock, std::chrono::seconds(CONFIG_DISTRIBUTION_TIMEOUT)) == std::cv_status::timeout && !condition)
+            return false;
+    return true;
+}
+
+/*!
+\returns the path of the file in the cache directory, it is named after the hash and size of the content and keeps its extension
+*/
+std::string sgct_core::ConfigDistributor::getCachePath(const Asset & asset)
+{
+    std::stringstream ss;
+    ss << mCacheDirectory << "/" << std::hex << std::setw(16) << std::setfill('0') << asset.hash << std::dec << "_" << asset.size;
+
+    std::size_t extPos = asset.path.find_last_of('.');
+    std::size_t lastSlashPos = asset.path.find_last_of('/');
+    if (extPos != std::string::npos && (lastSlashPos == std::string::npos || extPos > lastSlashPos))
+        ss << asset.path.substr(extPos);
+
+    return ss.str();
+}
+
+void sgct_core::ConfigDistributor::collectAssets(tinyxml2::XMLElement * element, const std::string & configDirectory, std::vector<std::string> & paths)
+{
+    for (const tinyxml2::XMLAttribute * attr = element->FirstAttribute(); attr != NULL; attr = attr->Next())
+        if (isAssetAttribute(element->Value(), attr->Name()))
+        {
+            std::string path = resolvePath(attr->Name(), attr->Value(), configDirectory);
+            if (std::find(paths.begin(), paths.end(), path) == paths.end())
+                paths.push_back(path);
+        }
+
+    for (tinyxml2::XMLElement * child = element->FirstChildElement(); child != NULL; child = child->NextSiblingElement())
+        collectAssets(child, configDirectory, paths);
+}
+
+void sgct_core::ConfigDistributor::replaceAssets(tinyxml2::XMLElement * element, const std::string & configDirectory, const std::map<std::string, std::string> & localPaths)
+{
+    for (const tinyxml2::XMLAttribute * attr = element->FirstAttribute(); attr != NULL; attr = attr->Next())
+        if (isAssetAttribute(element->Value(), attr->Name()))
+        {
+            std::map<std::string, std::string>::const_iterator it = localPaths.find(resolvePath(attr->Name(), attr->Value(), configDirectory));
+            if (it != localPaths.end())
+                element->SetAttribute(attr->Name(), it->second.c_str());
+        }
+
+    for (tinyxml2::XMLElement * child = element->FirstChildElement(); child != NULL; child = child->NextSiblingElement())
+        replaceAssets(child, configDirectory, localPaths);
+}
+
+/*!
+\returns the path of a referenced file the same way as ReadConfig and Viewport resolve it, mpcdi files are relative to
+the configuration and other files to the working directory
+*/
+std::string sgct_core::ConfigDistributor::resolvePath(const char * attributeName, const char * value, const std::string & configDirectory)
+{
+    std::string path(value);
+    bool absolutePath = value[0] == '/' || value[0] == '\\' || (value[0] != '\0' && value[1] == ':');
+    if (strcmp(attributeName, "mpcdi") == 0 && !absolutePath)
+        path = configDirectory + path;
+
+    std::replace(path.begin(), path.end(), '\\', '/');
+    return path;
+}
+
+//FNV-1a
+uint64_t sgct_core::ConfigDistributor::getHash(const char * data, size_t size)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    const unsigned char * p = reinterpret_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= p[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/*!
+Appends the content of a file to data.
+*/
+bool sgct_core::ConfigDistributor::readFile(const std::string & path, std::vector<char> & data)
+{
+    FILE * file = NULL;
+#if (_MSC_VER >= 1400) //visual studio 2005 or later
+    if (fopen_s(&file, path.c_str(), "rb") != 0)
+        file = NULL;
+#else
+    file = fopen(path.c_str(), "rb");
+#endif
+    if (file == NULL)
+        return false;
+
+    bool success = fseek(file, 0, SEEK_END) == 0;
+    long size = success ? ftell(file) : -1;
+    success = size >= 0 && fseek(file, 0, SEEK_SET) == 0;
+
+    if (success && size > 0)
+    {
+        std::size_t offset = data.size();
+        data.resize(offset + static_cast<std::size_t>(size));
+        success = fread(&data[offset], 1, static_cast<std::size_t>(size), file) == static_cast<std::size_t>(size);
+    }
+
+    fclose(file);
+    return success;
+}
+
+/*!
+Writes a file under a temporary name and renames it so that an interrupted transfer never leaves a partial file in the cache.
+*/
+bool sgct_core::ConfigDistributor::writeFile(const std::string & path, const char * data, size_t size)
+{
+    std::string tmpFilename = path + ".tmp";
+
+    FILE * file = NULL;
+#if (_MSC_VER >= 1400) //visual studio 2005 or later
+    if (fopen_s(&file, tmpFilename.c_str(), "wb") != 0)
+        file = NULL;
+#else
+    file = fopen(tmpFilename.c_str(), "wb");
+#endif
+    if (file == NULL)
+        return false;
+
+    bool success = size == 0 || fwrite(data, 1, size, file) == size;
+    success = fclose(file) == 0 && success;
+
+    if (success && rename(tmpFilename.c_str(), path.c_str()) != 0)
+    {
+        //rename doesn't replace existing files on windows
+        remove(path.c_str());
+        success = rename(tmpFilename.c_str(), path.c_str()) == 0;
+    }
+
+    if (!success)
+        remove(tmpFilename.c_str());
+
+    return success;
+}
@@ -25,6 +25,7 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <cstring>
 #include <algorithm>
 #include <sstream>
+#include <mutex>
 
 #if (_MSC_VER >= 1400) //visual studio 2005 or later
     #define _sscanf sscanf_s
@@ -58,6 +59,9 @@ struct SCISSViewData
 
 enum SCISSDistortionType { MESHTYPE_PLANAR, MESHTYPE_CUBE };
 
+//meshes can be read in parallel, this protects the user and frustum data shared between viewports
+static std::mutex gViewDataMutex;
+
 sgct_core::CorrectionMeshGeometry::CorrectionMeshGeometry()
 {
     mMeshData[0] = GL_FALSE;
@@ -97,6 +101,7 @@ sgct_core::CorrectionMesh::CorrectionMesh()
 {
     mTempVertices = NULL;
     mTempIndices = NULL;
+    mUpdateNonLinearGeometry = false;
 
     for (int i = 0; i < LAST_MESH; i++)
     {
@@ -111,35 +116,42 @@ sgct_core::CorrectionMesh::~CorrectionMesh()
 }
 
 /*!
-This function finds a suitible parser for warping meshes and loads them into memory.
+This function finds a suitible parser for warping meshes, loads them into memory and uploads them to the GPU.
 
 @param meshPath the path to the mesh data
 @param meshHint a hint to pass to the parser selector
 @param parent the pointer to parent viewport
+@param windowAspectRatio the aspect ratio of the window that the parent viewport belongs to
 @return true if mesh found and loaded successfully
 */
 bool sgct_core::CorrectionMesh::readAndGenerateMesh(std::string meshPath, sgct_core::Viewport * parent,
-		                                            MeshHint hint)
-{    
+		                                            float windowAspectRatio, MeshHint hint)
+{
+    bool loadStatus = readMesh(meshPath, parent, windowAspectRatio, hint);
+    uploadMesh(parent);
+    return loadStatus;
+}
+
+/*!
+This function finds a suitible parser for warping meshes and loads them into memory without any OpenGL calls.
+It can therefore be called from a worker thread. Call uploadMesh from the context thread to create the OpenGL objects.
+
+@param meshPath the path to the mesh data
+@param meshHint a hint to pass to the parser selector
+@param parent the pointer to parent viewport
+@param windowAspectRatio the aspect ratio of the window that the parent viewport belongs to, the current window
+can't be used since it differs between the worker threads
+@return true if mesh found and loaded successfully
+*/
+bool sgct_core::CorrectionMesh::readMesh(std::string meshPath, sgct_core::Viewport * parent,
+                                         float windowAspectRatio, MeshHint hint)
+{
+    mUpdateNonLinearGeometry = false;
+    
     //generate unwarped mask
     setupSimpleMesh(&mGeometries[QUAD_MESH], parent);
     createMesh(&mGeometries[QUAD_MESH]);
     cleanUp();
-    
-    //generate unwarped mesh for mask
-    if(parent->hasBlendMaskTexture() || parent->hasBlackLevelMaskTexture())
-    {
-        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "CorrectionMesh: Creating mask mesh\n");
-        
-        bool flip_x = false;
-        bool flip_y = false;
-        //if (hint == DOMEPROJECTION_HINT)
-        //    flip_x = true;
-
-        setupMaskMesh(parent, flip_x, flip_y);
-        createMesh(&mGeometries[MASK_MESH]);
-        cleanUp();
-    }
 
     //fallback if no mesh is provided
     if ( meshPath.empty())
@@ -220,7 +232,7 @@ bool sgct_core::CorrectionMesh::readAndGenerateMesh(std::string meshPath, sgct_c
         break;
 
     case PAULBOURKE_FMT:
-        loadStatus = readAndGeneratePaulBourkeMesh(meshPath, parent);
+        loadStatus = readAndGeneratePaulBourkeMesh(meshPath, parent, windowAspectRatio);
         break;
 
     case OBJ_FMT:
@@ -260,6 +272,41 @@ bool sgct_core::CorrectionMesh::readAndGenerateMesh(std::string meshPath, sgct_c
     return true;
 }
 
+/*!
+Creates the OpenGL objects for the meshes read by readMesh. Must be called with a valid OpenGL context.
+
+@param parent the pointer to parent viewport
+*/
+void sgct_core::CorrectionMesh::uploadMesh(sgct_core::Viewport * parent)
+{
+    //generate unwarped mesh for mask
+    if(parent->hasBlendMaskTexture() || parent->hasBlackLevelMaskTexture())
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "CorrectionMesh: Creating mask mesh\n");
+        
+        bool flip_x = false;
+        bool flip_y = false;
+        //if (hint == DOMEPROJECTION_HINT)
+        //    flip_x = true;
+
+        setupMaskMesh(parent, flip_x, flip_y);
+        createMesh(&mGeometries[MASK_MESH]);
+        cleanUp();
+    }
+
+    for (int i = 0; i < LAST_MESH; i++)
+        if (!mGeometries[i].mStagedVertices.empty())
+            uploadGeometry(&mGeometries[i]);
+
+    //force regeneration of dome render quad
+    if (mUpdateNonLinearGeometry)
+    {
+        if (FisheyeProjection* fishPrj = dynamic_cast<FisheyeProjection*>(parent->getNonLinearProjectionPtr()))
+            fishPrj->update(1.0f, 1.0f);
+        mUpdateNonLinearGeometry = false;
+    }
+}
+
 /*!
 Parse data from domeprojection's camera based calibration system. Domeprojection.com
 */
@@ -775,6 +822,7 @@ bool sgct_core::CorrectionMesh::readAndGenerateScissMesh(const std::string & mes
 
     fclose(meshFile);
 
+    gViewDataMutex.lock();
     parent->getUser()->setPos(
         viewData.x, viewData.y, viewData.z);
 
@@ -787,6 +835,7 @@ bool sgct_core::CorrectionMesh::readAndGenerateScissMesh(const std::string & mes
         );
 
     sgct::Engine::instance()->updateFrustums();
+    gViewDataMutex.unlock();
 
     CorrectionMeshVertex * vertexPtr;
     SCISSTexturedVertex * scissVertexPtr;
@@ -1458,6 +1507,7 @@ bool sgct_core::CorrectionMesh::readAndGenerateSkySkanMesh(const std::string & m
     rotQuat = glm::rotate(rotQuat, glm::radians(-azimuth), glm::vec3(0.0f, 1.0f, 0.0f));
     rotQuat = glm::rotate(rotQuat, glm::radians(elevation), glm::vec3(1.0f, 0.0f, 0.0f));
 
+    gViewDataMutex.lock();
     parent->getUser()->setPos(0.0f, 0.0f, 0.0f);
     parent->setViewPlaneCoordsUsingFOVs(
         vertical_fov / 2.0f,
@@ -1468,6 +1518,7 @@ bool sgct_core::CorrectionMesh::readAndGenerateSkySkanMesh(const std::string & m
         );
     
     sgct::Engine::instance()->updateFrustums();
+    gViewDataMutex.unlock();
 
     std::vector<unsigned int> indices;
     unsigned int i0, i1, i2, i3;
@@ -1565,7 +1616,7 @@ bool sgct_core::CorrectionMesh::readAndGenerateSkySkanMesh(const std::string & m
     return true;
 }
 
-bool sgct_core::CorrectionMesh::readAndGeneratePaulBourkeMesh(const std::string & meshPath, Viewport * parent)
+bool sgct_core::CorrectionMesh::readAndGeneratePaulBourkeMesh(const std::string & meshPath, Viewport * parent, float windowAspectRatio)
 {
     sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO,
         "CorrectionMesh: Reading Paul Bourke spherical mirror mesh data from '%s'.\n", meshPath.c_str());
@@ -1680,8 +1731,7 @@ bool sgct_core::CorrectionMesh::readAndGeneratePaulBourkeMesh(const std::string
             indices.push_back(i3);
         }
 
-    float aspect = sgct::Engine::instance()->getCurrentWindowPtr()->getAspectRatio() * 
-        (parent->getXSize() / parent->getYSize());
+    float aspect = windowAspectRatio * (parent->getXSize() / parent->getYSize());
     
     for (unsigned int i = 0; i < mGeometries[WARP_MESH].mNumberOfVertices; i++)
     {
@@ -1707,11 +1757,11 @@ bool sgct_core::CorrectionMesh::readAndGeneratePaulBourkeMesh(const std::string
     mGeometries[WARP_MESH].mGeometryType = GL_TRIANGLES;
     createMesh(&mGeometries[WARP_MESH]);
 
-    //force regeneration of dome render quad
+    //force regeneration of dome render quad (done in uploadMesh since it requires a context)
     if (FisheyeProjection* fishPrj = dynamic_cast<FisheyeProjection*>(parent->getNonLinearProjectionPtr()))
     {
         fishPrj->setIgnoreAspectRatio(true);
-        fishPrj->update(1.0f, 1.0f);
+        mUpdateNonLinearGeometry = true;
     }
 
     sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "CorrectionMesh: Correction mesh read successfully! Vertices=%u, Indices=%u.\n", mGeometries[WARP_MESH].mNumberOfVertices, mGeometries[WARP_MESH].mNumberOfIndices);
@@ -2222,8 +2272,20 @@ void sgct_core::CorrectionMesh::setupMaskMesh(Viewport * parent, bool flip_x, bo
     mTempVertices[3].y = 2.0f*(1.0f * parent->getYSize() + parent->getY()) - 1.0f;
 }
 
+/*!
+Copies the temporary mesh data to the geometry's staging buffers. The OpenGL objects are created later by uploadGeometry.
+*/
 void sgct_core::CorrectionMesh::createMesh(sgct_core::CorrectionMeshGeometry * geomPtr)
 {
+    geomPtr->mStagedVertices.assign(mTempVertices, mTempVertices + geomPtr->mNumberOfVertices);
+    geomPtr->mStagedIndices.assign(mTempIndices, mTempIndices + geomPtr->mNumberOfIndices);
+}
+
+void sgct_core::CorrectionMesh::uploadGeometry(sgct_core::CorrectionMeshGeometry * geomPtr)
+{
+    const CorrectionMeshVertex * vertices = geomPtr->mStagedVertices.data();
+    const unsigned int * indices = geomPtr->mStagedIndices.data();
+
     /*sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "Uploading mesh data (type=%d)...\n",
         ClusterManager::instance()->getMeshImplementation());*/
     
@@ -2241,7 +2303,7 @@ void sgct_core::CorrectionMesh::createMesh(sgct_core::CorrectionMeshGeometry * g
         sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "CorrectionMesh: Generating VBOs: %d %d\n", geomPtr->mMeshData[0], geomPtr->mMeshData[1]);
 
         glBindBuffer(GL_ARRAY_BUFFER, geomPtr->mMeshData[Vertex]);
-        glBufferData(GL_ARRAY_BUFFER, geomPtr->mNumberOfVertices * sizeof(CorrectionMeshVertex), &mTempVertices[0], GL_STATIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, geomPtr->mNumberOfVertices * sizeof(CorrectionMeshVertex), vertices, GL_STATIC_DRAW);
 
         if(!sgct::Engine::instance()->isOGLPipelineFixed())
         {
@@ -2277,7 +2339,7 @@ void sgct_core::CorrectionMesh::createMesh(sgct_core::CorrectionMeshGeometry * g
         }
 
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, geomPtr->mMeshData[Index]);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, geomPtr->mNumberOfIndices * sizeof(unsigned int), &mTempIndices[0], GL_STATIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, geomPtr->mNumberOfIndices * sizeof(unsigned int), indices, GL_STATIC_DRAW);
 
         //unbind
         if(!sgct::Engine::instance()->isOGLPipelineFixed())
@@ -2296,7 +2358,7 @@ void sgct_core::CorrectionMesh::createMesh(sgct_core::CorrectionMeshGeometry * g
         
         for (unsigned int i = 0; i < geomPtr->mNumberOfIndices; i++)
         {
-            vertex = mTempVertices[mTempIndices[i]];
+            vertex = vertices[indices[i]];
 
             glColor4f(vertex.r, vertex.g, vertex.b, vertex.a);
             glTexCoord2f(vertex.s, vertex.t);
@@ -2308,6 +2370,10 @@ void sgct_core::CorrectionMesh::createMesh(sgct_core::CorrectionMeshGeometry * g
         
         sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "CorrectionMesh: Generating display list: %d\n", geomPtr->mMeshData[Vertex]);
     }
+
+    //free staged data
+    std::vector<CorrectionMeshVertex>().swap(geomPtr->mStagedVertices);
+    std::vector<unsigned int>().swap(geomPtr->mStagedIndices);
 }
 
 void sgct_core::CorrectionMesh::exportMesh(const std::string & exportMeshPath)
@@ -0,0 +1,489 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#include <sgct/CubemapConverter.h>
+#include <sgct/Image.h>
+#include <sgct/MessageHandler.h>
+#include <sgct/helpers/SGCTSIMD.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <math.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+const std::size_t sgct_core::CubemapConverter::TileSize;
+
+sgct_core::CubemapConverter::CubemapConverter()
+{
+    mMapping = Fisheye;
+    mInterpolation = Bilinear;
+    mFaceLayout = CubeLayout;
+    mFOV = 180.0f;
+    mTilt = 0.0f;
+    mCropFactors[CropLeft] = 0.0f;
+    mCropFactors[CropRight] = 0.0f;
+    mCropFactors[CropBottom] = 0.0f;
+    mCropFactors[CropTop] = 0.0f;
+    mOffset = glm::vec3(0.0f);
+    mRigOrientation = glm::vec3(0.0f);
+    mBackgroundColor = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    mNumberOfThreads = 0;
+
+    updateRotation();
+}
+
+/*!
+Set the mapping of the output image, fisheye is the default.
+*/
+void sgct_core::CubemapConverter::setMapping(Mapping mapping)
+{
+    mMapping = mapping;
+}
+
+/*!
+Set the filter used to sample the cubemap faces, bilinear is the default.
+*/
+void sgct_core::CubemapConverter::setInterpolation(Interpolation interpolation)
+{
+    mInterpolation = interpolation;
+}
+
+/*!
+Set the layout of the cubemap. The rig layouts are the rotations that FisheyeProjection uses for its four and five/six face rigs.
+*/
+void sgct_core::CubemapConverter::setFaceLayout(FaceLayout layout)
+{
+    mFaceLayout = layout;
+    updateRotation();
+}
+
+/*!
+Set the fisheye field of view in degrees, only used by the fisheye mapping.
+*/
+void sgct_core::CubemapConverter::setFOV(float angle)
+{
+    mFOV = angle;
+}
+
+/*!
+Set the tilt in degrees, it rotates the sampled directions about the x-axis. FisheyeProjection applies the tilt to the
+cube cameras instead, so keep it at zero when comparing against faces rendered by sgct.
+*/
+void sgct_core::CubemapConverter::setTilt(float angle)
+{
+    mTilt = angle;
+    updateRotation();
+}
+
+/*!
+Set the fisheye crop factors in the range [0, 1], the same as FisheyeProjection::setCropFactors. Only used by the fisheye mapping.
+*/
+void sgct_core::CubemapConverter::setCropFactors(float left, float right, float bottom, float top)
+{
+    mCropFactors[CropLeft] = (left < 1.0f && left > 0.0f) ? left : 0.0f;
+    mCropFactors[CropRight] = (right < 1.0f && right > 0.0f) ? right : 0.0f;
+    mCropFactors[CropBottom] = (bottom < 1.0f && bottom > 0.0f) ? bottom : 0.0f;
+    mCropFactors[CropTop] = (top < 1.0f && top > 0.0f) ? top : 0.0f;
+}
+
+/*!
+Set the fisheye lens offset, the sum of the base offset and the offset of FisheyeProjection. Only used by the fisheye mapping.
+*/
+void sgct_core::CubemapConverter::setOffset(const glm::vec3 & offset)
+{
+    mOffset = offset;
+}
+
+/*!
+Set the rig orientation in degrees (pitch, yaw, roll), the same as SpoutOutputProjection::setSpoutRigOrientation.
+*/
+void sgct_core::CubemapConverter::setRigOrientation(const glm::vec3 & orientation)
+{
+    mRigOrientation = orientation;
+    updateRotation();
+}
+
+/*!
+Set the color of the output texels that are outside the fisheye or sample a missing face, in the range [0, 1].
+*/
+void sgct_core::CubemapConverter::setBackgroundColor(const glm::vec4 & color)
+{
+    mBackgroundColor = color;
+}
+
+/*!
+Set the number of threads that convert tiles, zero uses one thread per core.
+*/
+void sgct_core::CubemapConverter::setNumberOfThreads(unsigned int numberOfThreads)
+{
+    mNumberOfThreads = numberOfThreads;
+}
+
+/*!
+Converts the cubemap to the output image. The size of the output image must be set, the number of channels and bytes per
+channel are taken from the faces and the data is allocated if needed.
+
+@param faces the six faces in the order of CubeFace, a NULL face is sampled as the background color
+@param output the image to write the result to
+\returns false if the faces don't match each other or the output can't be allocated
+*/
+bool sgct_core::CubemapConverter::convert(Image ** faces, Image * output) const
+{
+    if (faces == NULL || output == NULL || output->getWidth() == 0 || output->getHeight() == 0)
+        return false;
+
+    Image * reference = NULL;
+    for (std::size_t i = 0; i < NumberOfFaces; i++)
+    {
+        if (faces[i] == NULL)
+            continue;
+
+        if (faces[i]->getData() == NULL || faces[i]->getWidth() == 0 || faces[i]->getWidth() != faces[i]->getHeight())
+        {
+            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "CubemapConverter: Face %u is empty or not square!\n", static_cast<unsigned int>(i));
+            return false;
+        }
+
+        if (reference == NULL)
+            reference = faces[i];
+        else if (faces[i]->getChannels() != reference->getChannels() ||
+            faces[i]->getBytesPerChannel() != reference->getBytesPerChannel())
+        {
+            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "CubemapConverter: Face %u has a different pixel format than the other faces!\n", static_cast<unsigned int>(i));
+            return false;
+        }
+    }
+
+    if (reference == NULL)
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "CubemapConverter: No faces to convert!\n");
+        return false;
+    }
+
+    std::size_t bpc = reference->getBytesPerChannel();
+    if (bpc != 1 && bpc != 2)
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "CubemapConverter: %u bytes per channel is not supported!\n", static_cast<unsigned int>(bpc));
+        return false;
+    }
+
+    output->setChannels(reference->getChannels());
+    output->setBytesPerChannel(bpc);
+    if (!output->allocateOrResizeData())
+        return false;
+
+    std::size_t tilesX = (output->getWidth() + TileSize - 1) / TileSize;
+    std::size_t tilesY = (output->getHeight() + TileSize - 1) / TileSize;
+    std::size_t numberOfTiles = tilesX * tilesY;
+
+    std::size_t numberOfThreads = mNumberOfThreads > 0 ? mNumberOfThreads : static_cast<std::size_t>(std::thread::hardware_concurrency());
+    if (numberOfThreads == 0)
+        numberOfThreads = 1;
+    if (numberOfThreads > numberOfTiles)
+        numberOfThreads = numberOfTiles;
+
+    std::atomic<std::size_t> nextTile(0);
+    auto worker = [this, faces, output, bpc, numberOfTiles, &nextTile]()
+    {
+        std::size_t tile;
+        while ((tile = nextTile++) < numberOfTiles)
+        {
+            if (bpc == 1)
+                convertTile<unsigned char>(faces, output, tile);
+            else
+                convertTile<unsigned short>(faces, output, tile);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < numberOfThreads; i++)
+        threads.push_back(std::thread(worker));
+    worker(); //this thread takes part as well
+    for (std::size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+
+    return true;
+}
+
+/*!
+Computes the direction that the fisheye shaders look up for a texture coordinate of the output, before the rotation
+to the cubemap. The fisheye texture coordinate includes the crop, the same as the fisheye quad.
+
+\returns false if the coordinate is outside of the fisheye circle
+*/
+bool sgct_core::CubemapConverter::getSampleDirection(float s, float t, glm::vec3 & direction) const
+{
+    if (mMapping == Equirectangular)
+    {
+        float phi = 3.14159265359f * (1.0f - t);
+        float theta = 6.28318530718f * (s - 0.5f);
+        direction.x = sinf(phi) * sinf(theta);
+        direction.y = sinf(phi) * cosf(theta);
+        direction.z = cosf(phi);
+        return true;
+    }
+
+    s = 2.0f * (s - 0.5f);
+    t = 2.0f * (t - 0.5f);
+    float r2 = s*s + t*t;
+    if (r2 > 1.0f)
+        return false;
+
+    //sin and cos of theta = atan(s, t) are s/r and t/r, which saves three trigonometric calls per texel
+    float r = sqrtf(r2);
+    float phi = r * glm::radians(mFOV / 2.0f);
+    float sinTheta = r > 0.0f ? s / r : 0.0f;
+    float cosTheta = r > 0.0f ? t / r : 1.0f;
+    float sinPhi = sinf(phi);
+    direction.x = sinPhi * sinTheta - mOffset.x;
+    direction.y = -sinPhi * cosTheta - mOffset.y;
+    direction.z = cosf(phi) - mOffset.z;
+    return true;
+}
+
+/*!
+Selects the cubemap face and the face texture coordinate for a direction the same way as textureCube does.
+Ties of the major axis are resolved in the order x, y, z.
+*/
+sgct_core::CubemapConverter::CubeFace sgct_core::CubemapConverter::getCubeFace(const glm::vec3 & direction, float & s, float & t)
+{
+    float ax = fabsf(direction.x);
+    float ay = fabsf(direction.y);
+    float az = fabsf(direction.z);
+
+    CubeFace face;
+    float sc, tc, ma;
+    if (ax >= ay && ax >= az)
+    {
+        ma = ax;
+        face = direction.x >= 0.0f ? PositiveX : NegativeX;
+        sc = direction.x >= 0.0f ? -direction.z : direction.z;
+        tc = -direction.y;
+    }
+    else if (ay >= az)
+    {
+        ma = ay;
+        face = direction.y >= 0.0f ? PositiveY : NegativeY;
+        sc = direction.x;
+        tc = direction.y >= 0.0f ? direction.z : -direction.z;
+    }
+    else
+    {
+        ma = az;
+        face = direction.z >= 0.0f ? PositiveZ : NegativeZ;
+        sc = direction.z >= 0.0f ? direction.x : -direction.x;
+        tc = -direction.y;
+    }
+
+    if (ma <= 0.0f)
+    {
+        s = 0.5f;
+        t = 0.5f;
+        return PositiveX;
+    }
+
+    s = 0.5f * (sc / ma + 1.0f);
+    t = 0.5f * (tc / ma + 1.0f);
+    return face;
+}
+
+/*!
+The rotation applied to the sampled direction, the rotVec of the shaders followed by the tilt.
+*/
+void sgct_core::CubemapConverter::updateRotation()
+{
+    const float a = 0.7071067812f; //angle45Factor
+    glm::mat3 layout(1.0f);
+    switch (mFaceLayout)
+    {
+    case FourFaceRigLayout: //vec3( a*x + a*z, y, -a*x + a*z)
+        layout = glm::mat3(a, 0.0f, -a, 0.0f, 1.0f, 0.0f, a, 0.0f, a);
+        break;
+
+    case FiveOrSixFaceRigLayout: //vec3(a*x - a*y, a*x + a*y, z)
+        layout = glm::mat3(a, a, 0.0f, -a, a, 0.0f, 0.0f, 0.0f, 1.0f);
+        break;
+
+    default:
+        break;
+    }
+
+    //the rig rotation of SpoutOutputProjection, its rotVec multiplies with the transpose
+    glm::mat4 pitchRot = glm::rotate(glm::mat4(1.0f), glm::radians(mRigOrientation.x), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 yawRot = glm::rotate(pitchRot, glm::radians(mRigOrientation.y), glm::vec3(1.0f, 0.0f, 0.0f));
+    glm::mat4 rollRot = glm::rotate(yawRot, glm::radians(mRigOrientation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+
+    glm::mat4 tiltRot = glm::rotate(glm::mat4(1.0f), glm::radians(mTilt), glm::vec3(1.0f, 0.0f, 0.0f));
+
+    mRotation = layout * glm::transpose(glm::mat3(rollRot)) * glm::mat3(tiltRot);
+}
+
+template <class T> void sgct_core::CubemapConverter::convertTile(Image ** faces, Image * output, std::size_t tile) const
+{
+    const std::size_t width = output->getWidth();
+    const std::size_t height = output->getHeight();
+    const std::size_t channels = output->getChannels();
+    const std::size_t tilesX = (width + TileSize - 1) / TileSize;
+    const float maxValue = static_cast<float>(static_cast<T>(~0));
+
+    const std::size_t x0 = (tile % tilesX) * TileSize;
+    const std::size_t y0 = (tile / tilesX) * TileSize;
+    const std::size_t x1 = std::min(x0 + TileSize, width);
+    const std::size_t y1 = std::min(y0 + TileSize, height);
+
+    //the fisheye quad only covers the uncropped part of the fisheye
+    float sMin = 0.0f, sRange = 1.0f, tMin = 0.0f, tRange = 1.0f;
+    if (mMapping == Fisheye)
+    {
+        sMin = mCropFactors[CropLeft];
+        sRange = 1.0f - mCropFactors[CropLeft] - mCropFactors[CropRight];
+        tMin = mCropFactors[CropBottom];
+        tRange = 1.0f - mCropFactors[CropBottom] - mCropFactors[CropTop];
+    }
+
+    T background[4];
+    for (std::size_t c = 0; c < 4; c++)
+        background[c] = static_cast<T>(glm::clamp(mBackgroundColor[static_cast<glm::length_t>(c)], 0.0f, 1.0f) * maxValue + 0.5f);
+
+    float sample[4];
+    T * data = reinterpret_cast<T *>(output->getData());
+    for (std::size_t y = y0; y < y1; y++)
+    {
+        float t = tMin + tRange * (static_cast<float>(y) + 0.5f) / static_cast<float>(height);
+        T * texel = data + (y * width + x0) * channels;
+        for (std::size_t x = x0; x < x1; x++, texel += channels)
+        {
+            float s = sMin + sRange * (static_cast<float>(x) + 0.5f) / static_cast<float>(width);
+
+            glm::vec3 direction;
+            Image * face = NULL;
+            float faceS = 0.0f, faceT = 0.0f;
+            if (getSampleDirection(s, t, direction))
+                face = faces[getCubeFace(mRotation * direction, faceS, faceT)];
+
+            if (face == NULL)
+            {
+                for (std::size_t c = 0; c < channels; c++)
+                    texel[c] = background[c];
+                continue;
+            }
+
+            if (mInterpolation == Bicubic)
+                sampleBicubic<T>(face, faceS, faceT, sample);
+            else
+                sampleBilinear<T>(face, faceS, faceT, sample);
+
+            for (std::size_t c = 0; c < channels; c++)
+                texel[c] = static_cast<T>(glm::clamp(sample[c], 0.0f, maxValue) + 0.5f);
+        }
+    }
+}
+
+template <class T> void sgct_core::CubemapConverter::sampleBilinear(Image * face, float s, float t, float * result) const
+{
+    const std::size_t size = face->getWidth();
+    const std::size_t channels = face->getChannels();
+    const float maxCoord = static_cast<float>(size - 1);
+    const T * data = reinterpret_cast<const T *>(face->getData());
+
+    //clamp to edge, the same as GL_LINEAR with GL_CLAMP_TO_EDGE
+    float u = glm::clamp(s * static_cast<float>(size) - 0.5f, 0.0f, maxCoord);
+    float v = glm::clamp(t * static_cast<float>(size) - 0.5f, 0.0f, maxCoord);
+    std::size_t i0 = static_cast<std::size_t>(u);
+    std::size_t j0 = static_cast<std::size_t>(v);
+    std::size_t i1 = std::min(i0 + 1, size - 1);
+    std::size_t j1 = std::min(j0 + 1, size - 1);
+    float fu = u - static_cast<float>(i0);
+    float fv = v - static_cast<float>(j0);
+
+    const T * p00 = data + (j0 * size + i0) * channels;
+    const T * p10 = data + (j0 * size + i1) * channels;
+    const T * p01 = data + (j1 * size + i0) * channels;
+    const T * p11 = data + (j1 * size + i1) * channels;
+
+    float w00 = (1.0f - fu) * (1.0f - fv);
+    float w10 = fu * (1.0f - fv);
+    float w01 = (1.0f - fu) * fv;
+    float w11 = fu * fv;
+
+    //RGBA texels are filtered with the four channels in the lanes
+    if (channels == 4)
+    {
+        sgct_helpers::Lanes sum =
+            sgct_helpers::Lanes(w00) * sgct_helpers::lanesLoad(p00) + sgct_helpers::Lanes(w10) * sgct_helpers::lanesLoad(p10) +
+            sgct_helpers::Lanes(w01) * sgct_helpers::lanesLoad(p01) + sgct_helpers::Lanes(w11) * sgct_helpers::lanesLoad(p11);
+        sum.store(result);
+        return;
+    }
+
+    for (std::size_t c = 0; c < channels; c++)
+        result[c] = w00 * p00[c] + w10 * p10[c] + w01 * p01[c] + w11 * p11[c];
+}
+
+template <class T> void sgct_core::CubemapConverter::sampleBicubic(Image * face, float s, float t, float * result) const
+{
+    const std::size_t size = face->getWidth();
+    const std::size_t channels = face->getChannels();
+    const int maxIndex = static_cast<int>(size) - 1;
+    const T * data = reinterpret_cast<const T *>(face->getData());
+
+    float u = s * static_cast<float>(size) - 0.5f;
+    float v = t * static_cast<float>(size) - 0.5f;
+    float fu = u - floorf(u);
+    float fv = v - floorf(v);
+    int i = static_cast<int>(floorf(u));
+    int j = static_cast<int>(floorf(v));
+
+    //Catmull-Rom weights
+    float wu[4], wv[4];
+    wu[0] = 0.5f * (-fu*fu*fu + 2.0f*fu*fu - fu);
+    wu[1] = 0.5f * (3.0f*fu*fu*fu - 5.0f*fu*fu + 2.0f);
+    wu[2] = 0.5f * (-3.0f*fu*fu*fu + 4.0f*fu*fu + fu);
+    wu[3] = 0.5f * (fu*fu*fu - fu*fu);
+    wv[0] = 0.5f * (-fv*fv*fv + 2.0f*fv*fv - fv);
+    wv[1] = 0.5f * (3.0f*fv*fv*fv - 5.0f*fv*fv + 2.0f);
+    wv[2] = 0.5f * (-3.0f*fv*fv*fv + 4.0f*fv*fv + fv);
+    wv[3] = 0.5f * (fv*fv*fv - fv*fv);
+
+    std::size_t cols[4];
+    for (int m = 0; m < 4; m++)
+        cols[m] = static_cast<std::size_t>(glm::clamp(i + m - 1, 0, maxIndex)) * channels;
+
+    //RGBA texels are filtered with the four channels in the lanes, one row at a time
+    if (channels == 4)
+    {
+        sgct_helpers::Lanes sum(0.0f);
+        for (int n = 0; n < 4; n++)
+        {
+            const T * row = data + static_cast<std::size_t>(glm::clamp(j + n - 1, 0, maxIndex)) * size * channels;
+            sgct_helpers::Lanes rowSum =
+                sgct_helpers::Lanes(wu[0]) * sgct_helpers::lanesLoad(row + cols[0]) +
+                sgct_helpers::Lanes(wu[1]) * sgct_helpers::lanesLoad(row + cols[1]) +
+                sgct_helpers::Lanes(wu[2]) * sgct_helpers::lanesLoad(row + cols[2]) +
+                sgct_helpers::Lanes(wu[3]) * sgct_helpers::lanesLoad(row + cols[3]);
+            sum = sum + sgct_helpers::Lanes(wv[n]) * rowSum;
+        }
+        sum.store(result);
+        return;
+    }
+
+    for (std::size_t c = 0; c < channels; c++)
+        result[c] = 0.0f;
+
+    for (int n = 0; n < 4; n++)
+    {
+        const T * row = data + static_cast<std::size_t>(glm::clamp(j + n - 1, 0, maxIndex)) * size * channels;
+        for (int m = 0; m < 4; m++)
+        {
+            const T * p = row + cols[m];
+            float w = wu[m] * wv[n];
+            for (std::size_t c = 0; c < channels; c++)
+                result[c] += w * p[c];
+        }
+    }
+}
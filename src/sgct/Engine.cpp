@@ -18,6 +18,9 @@ For conditions of distribution and use, see copyright notice in sgct.h
     #include <sgct/FontManager.h>
 #endif
 #include <sgct/MessageHandler.h>
+#include <sgct/FrameTrace.h>
+#include <sgct/ClusterStatistics.h>
+#include <sgct/ConfigDistributor.h>
 #include <sgct/TextureManager.h>
 #include <sgct/SharedData.h>
 #include <sgct/shaders/SGCTInternalShaders.h>
@@ -34,6 +37,8 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <iostream>
 #include <sstream>
 #include <deque>
+#include <thread>
+#include <atomic>
 
 //#define __SGCT_RENDER_LOOP_DEBUG__
 
@@ -82,7 +87,16 @@ Note that parameter with one '\-' are followed by arguments but parameters with
 Parameter     | Description
 ------------- | -------------
 -config <filename> | set xml confiuration file
+--Ignore-Config-Cache | always parse the xml config instead of using the compiled config cache
+--Watch-Config | reload the viewports on all nodes when the master's config file changes (set on the master)
+-distributeConfig <directory> | slaves receive their windows, viewports and the files they reference from the master and cache the files in the directory (set on all nodes)
 -logPath <filepath> | set log file path
+-trace <filepath> | record frame timings to a Chrome trace file in the given directory
+-clusterStats <filename> | save the frame statistics of all nodes on exit (master only, .csv for the history, otherwise a json summary)
+-trackingRecord <filename> | record all tracking reports to a binary file (master only)
+-trackingReplay <filename> | replay tracking data from a recording instead of connecting to VRPN
+--Tracking-Replay-Fast | replay the tracking recording as fast as possible instead of in real-time
+--Tracking-Replay-Loop | restart the tracking replay when the end of the recording is reached
 --help | display help message and exit
 -local <integer> | set which node in configuration that is the localhost (index starts at 0)
 --client | run the application as client (only available when running as local)
@@ -166,6 +180,9 @@ sgct::Engine::Engine( int& argc, char**& argv )
     mShowInfo = false;
     mShowGraph = false;
     mShowWireframe = false;
+    mWatchConfig = false;
+    mConfigCheckTime = 0.0;
+    mLoadedConfigHash = 0;
     mTakeScreenshot = false;
     mCurrentFrustumMode = sgct_core::Frustum::MonoEye;
     mFrameCounter = 0;
@@ -277,6 +294,9 @@ sgct::Engine::Engine(std::vector<std::string>& arg) {
     mShowInfo = false;
     mShowGraph = false;
     mShowWireframe = false;
+    mWatchConfig = false;
+    mConfigCheckTime = 0.0;
+    mLoadedConfigHash = 0;
     mTakeScreenshot = false;
     mCurrentFrustumMode = sgct_core::Frustum::MonoEye;
     mFrameCounter = 0;
@@ -330,6 +350,12 @@ bool sgct::Engine::init(RunMode rm)
 
     MessageHandler::instance()->print(MessageHandler::NOTIFY_VERSION_INFO, "%s\n", getSGCTVersion().c_str() );
 
+    if (mRunMode <= OpenGL_Compablity_Profile && SGCTSettings::instance()->getUseSinglePassCompositor())
+    {
+        MessageHandler::instance()->print(MessageHandler::NOTIFY_WARNING, "Engine: The single pass compositor requires the programmable pipeline, using separate mask passes.\n");
+        SGCTSettings::instance()->setUseSinglePassCompositor(false);
+    }
+
     if(mHelpMode)
         return false;
 
@@ -350,6 +376,22 @@ bool sgct::Engine::init(RunMode rm)
         return false;
     }
 
+    //the resolution scale is decided by the master, the field is registered on all nodes even if it isn't used
+    mResolutionScale.setVal(1.0f);
+    SharedData::instance()->addReservedField(SharedData::ResolutionScaleFieldId, &mResolutionScale);
+    //the master sets the hash of the config file when it changes, see --Watch-Config
+    mConfigHash.setVal(0);
+    SharedData::instance()->addReservedField(SharedData::ConfigHashFieldId, &mConfigHash);
+    if (SGCTSettings::instance()->getUseDynamicResolution())
+    {
+        float budget = SGCTSettings::instance()->getDynamicResolutionBudget();
+        if (budget <= 0.0f)
+            budget = 1.0f / static_cast<float>(SGCTSettings::instance()->getRefreshRateHint() > 0 ? SGCTSettings::instance()->getRefreshRateHint() : 60);
+        mResolutionScaler.setBudget(budget);
+        mResolutionScaler.setScaleLimits(SGCTSettings::instance()->getMinResolutionScale(), 1.0f);
+        mResolutionScaler.reset();
+    }
+
     if( !initNetwork() )
     {
         MessageHandler::instance()->print(MessageHandler::NOTIFY_ERROR, "Network init error. Application will close in 5 seconds.\n");
@@ -454,6 +496,24 @@ bool sgct::Engine::initNetwork()
         mNetworkConnections->close();
         return false;
     }
+
+    //only the windows and viewports of this node are read from the configuration,
+    //slaves receive them from the master when the configuration is distributed
+    bool distributeConfig = sgct_core::ConfigDistributor::instance()->isEnabled() &&
+        sgct_core::ClusterManager::instance()->getNumberOfNodes() > 1;
+    bool receiveConfig = distributeConfig && !mNetworkConnections->isComputerServer();
+    if( !receiveConfig && !mConfig->readNodeConfiguration(sgct_core::ClusterManager::instance()->getThisNodeId()) )
+    {
+        mNetworkConnections->close();
+        return false;
+    }
+
+    //package before the connections are opened so that the slaves' requests can be answered right away
+    if( distributeConfig && !receiveConfig && !sgct_core::ConfigDistributor::instance()->serve(*mConfig) )
+    {
+        mNetworkConnections->close();
+        return false;
+    }
     
     //set logfile path
     if( !mLogfilePath.empty() )
@@ -462,12 +522,31 @@ bool sgct::Engine::initNetwork()
         MessageHandler::instance()->setLogToFile(true);
     }
 
+    //start frame timing trace
+    if( !mTracePath.empty() )
+    {
+        std::stringstream ss;
+        ss << mTracePath << "/SGCT_trace_node" << sgct_core::ClusterManager::instance()->getThisNodeId() << ".json";
+        FrameTrace::instance()->start(ss.str(), sgct_core::ClusterManager::instance()->getThisNodeId());
+    }
+
     //Set message handler to send messages or not
     //MessageHandler::instance()->setSendFeedbackToServer( !mNetworkConnections->isComputerServer() );
 
     if(!mNetworkConnections->init())
         return false;
 
+    if( receiveConfig )
+    {
+        tinyxml2::XMLDocument xmlDoc;
+        if( !sgct_core::ConfigDistributor::instance()->receive(sgct_core::ClusterManager::instance()->getThisNodeId(), xmlDoc) ||
+            !mConfig->readNodeConfiguration(sgct_core::ClusterManager::instance()->getThisNodeId(), xmlDoc) )
+        {
+            mNetworkConnections->close();
+            return false;
+        }
+    }
+
     return true;
 }
 
@@ -888,6 +967,9 @@ void sgct::Engine::initOGL()
             winPtr->getViewport(i)->linkUserName();
     }
 
+    //decode masks and parse correction meshes for all viewports in parallel
+    loadViewportData();
+
     updateFrustums();
 
     //
@@ -911,6 +993,7 @@ void sgct::Engine::initOGL()
     SGCTWindow::setBarrier(true);
     SGCTWindow::resetSwapGroupFrameNumber();
 
+    double uploadStartTime = getTime();
     for(size_t i=0; i < mThisNode->getNumberOfWindows(); i++)
     {
         mThisNode->setCurrentWindowIndex(i);
@@ -918,6 +1001,8 @@ void sgct::Engine::initOGL()
         //generate mesh (VAO and VBO)
         getCurrentWindowPtr()->initContextSpecificOGL();
     }
+    MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Viewport data uploaded to GPU in %.2f ms.\n",
+        (getTime() - uploadStartTime) * 1000.0);
 
     //check for errors
     checkForOGLErrors();
@@ -925,6 +1010,63 @@ void sgct::Engine::initOGL()
     MessageHandler::instance()->print(MessageHandler::NOTIFY_IMPORTANT, "\nReady to render!\n");
 }
 
+/*!
+Reads the CPU side data (overlay/mask images and correction meshes) of all viewports in all windows
+using a pool of worker threads. The OpenGL objects are created afterwards in SGCTWindow::initContextSpecificOGL.
+*/
+void sgct::Engine::loadViewportData()
+{
+    std::vector<sgct_core::Viewport *> viewports;
+    std::vector<float> aspectRatios; //of the parent windows, the workers can't use the current window
+    for (size_t w = 0; w < mThisNode->getNumberOfWindows(); w++)
+    {
+        SGCTWindow * winPtr = mThisNode->getWindowPtr(w);
+        for (unsigned int i = 0; i < winPtr->getNumberOfViewports(); i++)
+        {
+            viewports.push_back(winPtr->getViewport(i));
+            aspectRatios.push_back(winPtr->getAspectRatio());
+        }
+    }
+
+    if (viewports.empty())
+        return;
+
+    std::size_t numberOfThreads = static_cast<std::size_t>(std::thread::hardware_concurrency());
+    if (numberOfThreads == 0)
+        numberOfThreads = 1;
+    if (numberOfThreads > viewports.size())
+        numberOfThreads = viewports.size();
+
+    double startTime = getTime();
+    std::atomic<std::size_t> nextViewport(0);
+    auto worker = [&viewports, &aspectRatios, &nextViewport]()
+    {
+        std::size_t index;
+        while ((index = nextViewport++) < viewports.size())
+            viewports[index]->loadCPUData(aspectRatios[index]);
+    };
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < numberOfThreads; i++)
+        threads.push_back(std::thread(worker));
+    worker(); //this thread takes part as well
+    for (std::size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+
+    double imageTime = 0.0;
+    double meshTime = 0.0;
+    for (std::size_t i = 0; i < viewports.size(); i++)
+    {
+        imageTime += viewports[i]->getImageLoadTime();
+        meshTime += viewports[i]->getMeshLoadTime();
+    }
+
+    MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO,
+        "Viewport data for %u viewports loaded in %.2f ms using %u threads (image decoding: %.2f ms, mesh parsing: %.2f ms accumulated).\n",
+        static_cast<unsigned int>(viewports.size()), (getTime() - startTime) * 1000.0, static_cast<unsigned int>(numberOfThreads),
+        imageTime * 1000.0, meshTime * 1000.0);
+}
+
 /*!
 Clean up all resources and release memory.
 */
@@ -974,6 +1116,18 @@ void sgct::Engine::clean()
         mNetworkConnections = NULL;
     }
 
+    //save the statistics of all nodes
+    if( !mClusterStatsFilename.empty() && isMaster() )
+    {
+        std::size_t extPos = mClusterStatsFilename.find_last_of('.');
+        if( extPos != std::string::npos && mClusterStatsFilename.compare(extPos, std::string::npos, ".csv") == 0 )
+            sgct_core::ClusterStatistics::instance()->saveCSV( mClusterStatsFilename );
+        else
+            sgct_core::ClusterStatistics::instance()->saveJSON( mClusterStatsFilename );
+    }
+    sgct_core::ClusterStatistics::destroy();
+    sgct_core::ConfigDistributor::destroy();
+
     if( mConfig != NULL )
     {
         delete mConfig;
@@ -1017,6 +1171,9 @@ void sgct::Engine::clean()
     MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Destroying settings...\n");
     SGCTSettings::destroy();
 
+    MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Destroying frame trace...\n");
+    FrameTrace::destroy();
+
     MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Destroying message handler...\n");
     MessageHandler::destroy();
 
@@ -1211,6 +1368,20 @@ bool sgct::Engine::frameLock(sgct::Engine::SyncStage stage)
     return true;
 }
 
+/*!
+    \returns the frame number sent by the master in the last sync, which is the same on all nodes
+*/
+unsigned int sgct::Engine::getSyncFrameNumber()
+{
+    if (mNetworkConnections->getSyncConnectionsCount() == 0)
+        return mFrameCounter;
+
+    sgct_core::SGCTNetwork * conn = mNetworkConnections->getSyncConnectionByIndex(0);
+    return static_cast<unsigned int>(mNetworkConnections->isComputerServer() ?
+        conn->getSendFrame() :
+        conn->getRecvFrame(sgct_core::SGCTNetwork::Current));
+}
+
 /*!
     This is SGCT's renderloop where rendeing & synchronization takes place.
 */
@@ -1227,6 +1398,8 @@ void sgct::Engine::render()
 
     //create openGL query objects for opengl 3.3+
     GLuint time_queries[2];
+    bool gpuQueriesIssued = false;
+    double gpuTime = 0.0;
     if (!mFixedOGLPipeline)
     {
         getCurrentWindowPtr()->makeOpenGLContextCurrent(SGCTWindow::Shared_Context);
@@ -1237,25 +1410,50 @@ void sgct::Engine::render()
     {
         mRenderingOffScreen = false;
 
+        //the master checks once per second if the config file was edited and sends its hash to all nodes
+        if( mWatchConfig && mNetworkConnections->isComputerServer() && getTime() - mConfigCheckTime > 1.0 )
+        {
+            mConfigCheckTime = getTime();
+            uint32_t configHash;
+            if( mConfig->hasSourceChanged(configHash) && configHash != mConfigHash.getVal() )
+            {
+                //the slaves that receive their configuration request the new one when they get the hash
+                bool distributeConfig = sgct_core::ConfigDistributor::instance()->isEnabled() &&
+                    sgct_core::ClusterManager::instance()->getNumberOfNodes() > 1;
+                if( !distributeConfig || sgct_core::ConfigDistributor::instance()->serve(*mConfig) )
+                    mConfigHash.setVal(configHash);
+            }
+        }
+
 #ifdef __SGCT_RENDER_LOOP_DEBUG__
         MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Render-Loop: Updating tracking devices.\n");
 #endif
 
         //update tracking data
         if( isMaster() )
+        {
+            FrameTrace::Scope scope("updateTracking");
             sgct_core::ClusterManager::instance()->getTrackingManagerPtr()->updateTrackingDevices();
+        }
 
 #ifdef __SGCT_RENDER_LOOP_DEBUG__
         MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Render-Loop: Running pre-sync.\n");
 #endif
         if (mPreSyncFnPtr != SGCT_NULL_PTR)
+        {
+            FrameTrace::Scope scope("preSync");
             mPreSyncFnPtr();
+        }
 
         if( mNetworkConnections->isComputerServer() )
         {
+            if (SGCTSettings::instance()->getUseDynamicResolution())
+                updateResolutionScale();
+
 #ifdef __SGCT_RENDER_LOOP_DEBUG__
             MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Render-Loop: Encoding data.\n");
 #endif
+            FrameTrace::Scope scope("encode");
             SharedData::instance()->encode();
         }
         else
@@ -1270,13 +1468,37 @@ void sgct::Engine::render()
 #ifdef __SGCT_RENDER_LOOP_DEBUG__
         MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Render-Loop: Sync/framelock\n");
 #endif
-        if( !frameLock(PreStage) )
-            break;
+        {
+            FrameTrace::Scope scope("frameLockPre");
+            if( !frameLock(PreStage) )
+                break;
+        }
+
+        //tag the trace with the frame number sent by the master, which is the same on all nodes
+        if( FrameTrace::instance()->isEnabled() )
+            FrameTrace::instance()->setFrameNumber(getSyncFrameNumber());
 
 #ifdef __SGCT_RENDER_LOOP_DEBUG__
         MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Render-Loop: running post-sync-pre-draw\n");
 #endif
 
+        //the master has seen the config file change, all nodes reload it in this frame
+        if( mConfigHash.getVal() != mLoadedConfigHash )
+        {
+            mLoadedConfigHash = mConfigHash.getVal();
+            bool reloaded = reloadConfiguration();
+
+            //nodes that read their own copy of the config file should have the same file as the master
+            bool ownCopy = mNetworkConnections->isComputerServer() || !sgct_core::ConfigDistributor::instance()->isEnabled();
+            if( reloaded && ownCopy && mConfig->getSourceHash() != mLoadedConfigHash )
+                MessageHandler::instance()->print(MessageHandler::NOTIFY_WARNING, "The config file of this node differs from the master's.\n");
+        }
+
+        //the scale decided by the master has been synchronized, the FBOs are resized below if it changed
+        if (SGCTSettings::instance()->getUseDynamicResolution() && SGCTSettings::instance()->useFBO())
+            for (size_t i = 0; i < mThisNode->getNumberOfWindows(); i++)
+                mThisNode->getWindowPtr(i)->setResolutionScale(mResolutionScale.getVal());
+
         //check if re-size needed of VBO and PBO
         //context switching may occur if multiple windows are used
         bool buffersNeedUpdate = false;
@@ -1293,167 +1515,50 @@ void sgct::Engine::render()
         if( mRenderingOffScreen )
             getCurrentWindowPtr()->makeOpenGLContextCurrent( SGCTWindow::Shared_Context );
 
+        //re-plan the passes if windows were resized, shown, hidden or changed stereo mode
+        updateRenderGraph();
+
         //Make sure correct context is current
         if (mPostSyncPreDrawFnPtr != SGCT_NULL_PTR)
+        {
+            FrameTrace::Scope scope("postSyncPreDraw");
             mPostSyncPreDrawFnPtr();
+        }
+
+        //update the projections of all tracked viewports, eyes and cube faces
+        updateTrackedFrustums();
 
         double startFrameTime = glfwGetTime();
         calculateFPS(startFrameTime); //measures time between calls
 
-        if (!mFixedOGLPipeline && mShowGraph)
-            glQueryCounter(time_queries[0], GL_TIMESTAMP);
-
-        //--------------------------------------------------------------
-        //     RENDER VIEWPORTS / DRAW
-        //--------------------------------------------------------------
-        mCurrentDrawBufferIndex = 0;
-        std::size_t firstDrawBufferIndexInWindow = 0;
-
-        for(size_t i=0; i < mThisNode->getNumberOfWindows(); i++)
-        if (mThisNode->getWindowPtr(i)->isVisible() || mThisNode->getWindowPtr(i)->isRenderingWhileHidden())
+        if (!mFixedOGLPipeline)
         {
-            //store the first buffer index for each window
-            firstDrawBufferIndexInWindow = mCurrentDrawBufferIndex;
-            
-            mThisNode->setCurrentWindowIndex(i);
-            SGCTWindow * win = getCurrentWindowPtr();
-
-            if( !mRenderingOffScreen )
-                win->makeOpenGLContextCurrent( SGCTWindow::Window_Context );
-
-            SGCTWindow::StereoMode sm = win->getStereoMode();
-
-            //--------------------------------------------------------------
-            //     RENDER LEFT/MONO NON LINEAR PROJECTION VIEWPORTS TO CUBEMAP
-            //--------------------------------------------------------------
-            mCurrentRenderTarget = NonLinearBuffer;
-            sgct_core::NonLinearProjection * nonLinearProjPtr;
-            for (std::size_t j = 0; j < win->getNumberOfViewports(); j++)
+            //without the graph the gpu time of the previous frame is used if it's available so that the cpu never waits
+            if (!mShowGraph && gpuQueriesIssued)
             {
-                mCurrentViewportIndex[MainViewport] = j;
-                
-                if (win->getViewport(j)->hasSubViewports())
+                GLint available = GL_FALSE;
+                glGetQueryObjectiv(time_queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+                gpuTime = 0.0;
+                if (available)
                 {
-#ifdef __SGCT_RENDER_LOOP_DEBUG__
-                    MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Render-Loop: Rendering sub-viewports\n");
-#endif
-                    nonLinearProjPtr = win->getViewport(j)->getNonLinearProjectionPtr();
-                    mCurrentOffScreenBuffer = nonLinearProjPtr->getOffScreenBuffer();
-
-                    nonLinearProjPtr->setAlpha(getCurrentWindowPtr()->getAlpha() ? 0.0f : 1.0f);
-                    if (sm == static_cast<int>(SGCTWindow::No_Stereo))
-                    {
-                        //for mono viewports frustum mode can be selected by user or xml
-                        mCurrentFrustumMode = win->getViewport(j)->getEye();
-                        nonLinearProjPtr->renderCubemap(&mCurrentViewportIndex[SubViewport]);
-                    }
-                    else
-                    {
-                        mCurrentFrustumMode = sgct_core::Frustum::StereoLeftEye;
-                        nonLinearProjPtr->renderCubemap(&mCurrentViewportIndex[SubViewport]);
-                    }
-
-                    //FBO index, every window and every non-linear projection has it's own FBO
-                    mCurrentDrawBufferIndex++;
-                }
-            }
-
-            //--------------------------------------------------------------
-            //     RENDER LEFT/MONO REGULAR VIEWPORTS TO FBO
-            //--------------------------------------------------------------
-            mCurrentRenderTarget = WindowBuffer;
-            mCurrentOffScreenBuffer = win->getFBOPtr();
-
-#ifdef __SGCT_RENDER_LOOP_DEBUG__
-            MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Render-Loop: Rendering\n");
-#endif
-            //if any stereo type (except passive) then set frustum mode to left eye
-            if( sm == static_cast<int>(SGCTWindow::No_Stereo))
-            {
-                mCurrentFrustumMode = sgct_core::Frustum::MonoEye;
-                renderViewports(LeftEye);
-            }
-            else
-            {
-                mCurrentFrustumMode = sgct_core::Frustum::StereoLeftEye;
-                renderViewports(LeftEye);
-            }
-
-            //FBO index, every window and every non-linear projection has it's own FBO
-            mCurrentDrawBufferIndex++;
-
-            //if stereo
-            if (sm != static_cast<int>(SGCTWindow::No_Stereo))
-            {
-                //jump back counter to the first buffer index for current window
-                mCurrentDrawBufferIndex = firstDrawBufferIndexInWindow;
-                
-                //--------------------------------------------------------------
-                //     RENDER RIGHT NON LINEAR PROJECTION VIEWPORTS TO CUBEMAP
-                //--------------------------------------------------------------
-                mCurrentRenderTarget = NonLinearBuffer;
-                sgct_core::NonLinearProjection * nonLinearProjPtr;
-                for (std::size_t j = 0; j < win->getNumberOfViewports(); j++)
-                {
-                    mCurrentViewportIndex[MainViewport] = j;
-
-                    if (win->getViewport(j)->hasSubViewports())
-                    {
-#ifdef __SGCT_RENDER_LOOP_DEBUG__
-                        MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Render-Loop: Rendering sub-viewports\n");
-#endif
-                        nonLinearProjPtr = win->getViewport(j)->getNonLinearProjectionPtr();
-                        mCurrentOffScreenBuffer = nonLinearProjPtr->getOffScreenBuffer();
-
-                        nonLinearProjPtr->setAlpha(getCurrentWindowPtr()->getAlpha() ? 0.0f : 1.0f);
-                        mCurrentFrustumMode = sgct_core::Frustum::StereoRightEye;
-                        nonLinearProjPtr->renderCubemap(&mCurrentViewportIndex[SubViewport]);
-                        
-                        //FBO index, every window and every non-linear projection has it's own FBO
-                        mCurrentDrawBufferIndex++;
-                    }
+                    GLuint64 timerStart;
+                    GLuint64 timerEnd;
+                    glGetQueryObjectui64v(time_queries[0], GL_QUERY_RESULT, &timerStart);
+                    glGetQueryObjectui64v(time_queries[1], GL_QUERY_RESULT, &timerEnd);
+                    gpuTime = static_cast<double>(timerEnd - timerStart) / 1000000000.0;
                 }
-
-                //--------------------------------------------------------------
-                //     RENDER RIGHT REGULAR VIEWPORTS TO FBO
-                //--------------------------------------------------------------
-                mCurrentRenderTarget = WindowBuffer;
-                mCurrentOffScreenBuffer = win->getFBOPtr();
-
-#ifdef __SGCT_RENDER_LOOP_DEBUG__
-                MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Render-Loop: Rendering\n");
-#endif
-                mCurrentFrustumMode = sgct_core::Frustum::StereoRightEye;
-                //use a single texture for side-by-side and top-bottom stereo modes
-                sm >= SGCTWindow::Side_By_Side_Stereo ?
-                    renderViewports(LeftEye) :
-                    renderViewports(RightEye);
-
-                //FBO index, every window and every non-linear projection has it's own FBO
-                mCurrentDrawBufferIndex++;
             }
 
-            //--------------------------------------------------------------
-            //           DONE RENDERING VIEWPORTS TO FBO
-            //--------------------------------------------------------------
-
-#ifdef __SGCT_RENDER_LOOP_DEBUG__
-            MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Render-Loop: Rendering FBO quad\n");
-#endif
-        }//end window loop
+            glQueryCounter(time_queries[0], GL_TIMESTAMP);
+        }
 
         //--------------------------------------------------------------
-        //           RENDER TO SCREEN
+        //     RENDER VIEWPORTS / DRAW AND RENDER TO SCREEN
         //--------------------------------------------------------------
-        for(size_t i=0; i < mThisNode->getNumberOfWindows(); i++)
-            if( mThisNode->getWindowPtr(i)->isVisible() )
-            {
-                mThisNode->setCurrentWindowIndex(i);
-
-                mRenderingOffScreen = false;
-                if( SGCTSettings::instance()->useFBO() )
-                    (this->*mInternalRenderFBOFn)();
-            }
+        //the passes are planned by the render graph, see updateRenderGraph
+        const std::vector<std::size_t> & passOrder = mRenderGraph.getOrder();
+        for (std::size_t i = 0; i < passOrder.size(); i++)
+            renderPass(mRenderGraph.getPass(passOrder[i]));
 
 #ifdef __SGCT_RENDER_LOOP_DEBUG__
         MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Render-Loop: Running post-sync\n");
@@ -1478,15 +1583,21 @@ void sgct::Engine::render()
         MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Render-Loop: swap and update data\n");
 #endif
         
-        if (!mFixedOGLPipeline && mShowGraph)
+        if (!mFixedOGLPipeline)
+        {
             glQueryCounter(time_queries[1], GL_TIMESTAMP);
+            gpuQueriesIssued = true;
+        }
 
         double endFrameTime = glfwGetTime();
         updateTimers( endFrameTime );
 
         //run post frame actions
         if (mPostDrawFnPtr != SGCT_NULL_PTR)
+        {
+            FrameTrace::Scope scope("postDraw");
             mPostDrawFnPtr();
+        }
 
         //update stats
         if (mFixedOGLPipeline)
@@ -1518,9 +1629,20 @@ void sgct::Engine::render()
 
                 double elapsedTime = static_cast<double>(timerEnd - timerStart) / 1000000000.0;
                 mStatistics->setDrawTime(static_cast<float>(elapsedTime));
+                gpuTime = elapsedTime;
             }
         }
 
+        //share the timings of this frame with the master
+        sgct_core::ClusterStatistics::Sample statsSample;
+        statsSample.nodeId = sgct_core::ClusterManager::instance()->getThisNodeId();
+        statsSample.frame = getSyncFrameNumber();
+        statsSample.values[sgct_core::ClusterStatistics::FrameTime] = mStatistics->getFrameTime();
+        statsSample.values[sgct_core::ClusterStatistics::DrawTime] = static_cast<float>(endFrameTime - startFrameTime);
+        statsSample.values[sgct_core::ClusterStatistics::SyncTime] = mStatistics->getSyncTime();
+        statsSample.values[sgct_core::ClusterStatistics::GpuTime] = static_cast<float>(gpuTime);
+        sgct_core::ClusterStatistics::instance()->setLocalSample(statsSample);
+
         if (mShowGraph)
         {
 #ifdef __SGCT_RENDER_LOOP_DEBUG__
@@ -1533,8 +1655,19 @@ void sgct::Engine::render()
         MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Render-Loop: lock\n");
 #endif
         //master will wait for nodes render before swapping
-        if( !frameLock(PostStage) )
-            break;
+        double postLockStartTime = getTime();
+        {
+            FrameTrace::Scope scope("frameLockPost");
+            if( !frameLock(PostStage) )
+                break;
+        }
+
+        if( mNetworkConnections->isComputerServer() )
+            sgct_core::ClusterStatistics::instance()->endFrame(postLockStartTime);
+
+        //all slaves have acknowledged the frame so their messages can be aggregated
+        if( mNetworkConnections->isComputerServer() )
+            MessageHandler::instance()->printForwardedMessages();
 
 #ifdef __SGCT_RENDER_LOOP_DEBUG__
         MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Render-Loop: Swap buffers\n");
@@ -1542,11 +1675,19 @@ void sgct::Engine::render()
         // Swap front and back rendering buffers
         for(size_t i=0; i < mThisNode->getNumberOfWindows(); i++)
         {
+            FrameTrace::Scope scope("swap", "window", static_cast<int>(i));
             mThisNode->setCurrentWindowIndex(i);
             getCurrentWindowPtr()->swap(mTakeScreenshot);
         }
 
-        glfwPollEvents();
+        //measure the tracking to swap latency for the head pose prediction
+        if( isMaster() )
+            sgct_core::ClusterManager::instance()->getTrackingManagerPtr()->setSwapTime( getTime() );
+
+        {
+            FrameTrace::Scope scope("pollEvents");
+            glfwPollEvents();
+        }
         for (size_t i = 0; i < mThisNode->getNumberOfWindows(); i++)
         {
             mThisNode->setCurrentWindowIndex(i);
@@ -1716,6 +1857,50 @@ void sgct::Engine::renderDisplayInfo()
                 glm::vec4(0.8f,0.8f,0.8f,1.0f),
                 "Stereo type: %s\nCurrent eye:          Right", getCurrentWindowPtr()->getStereoModeStr().c_str() );
         }
+
+        //per node timings of the cluster, the node that gated the last frame is shown in red
+        if( isMaster() && sgct_core::ClusterManager::instance()->getNumberOfNodes() > 1 )
+        {
+            sgct_core::ClusterStatistics * clusterStats = sgct_core::ClusterStatistics::instance();
+            std::vector<int> nodeIds = clusterStats->getNodeIds();
+            int gatingNode = clusterStats->getGatingNode();
+
+            float line = 10.0f + static_cast<float>(nodeIds.size());
+            sgct_text::print(font,
+                sgct_text::TOP_LEFT,
+                xPos,
+                lineHeight * line + yPos,
+                glm::vec4(0.8f,0.8f,0.8f,1.0f),
+                "Node: frame / draw / gpu / sync ms (last, p50, p99)");
+
+            for( std::size_t i = 0; i < nodeIds.size(); i++ )
+            {
+                sgct_core::ClusterStatistics::Sample sample;
+                if( !clusterStats->getLatestSample(nodeIds[i], sample) )
+                    continue;
+
+                line -= 1.0f;
+                sgct_text::print(font,
+                    sgct_text::TOP_LEFT,
+                    xPos,
+                    lineHeight * line + yPos,
+                    nodeIds[i] == gatingNode ? glm::vec4(0.9f,0.2f,0.2f,1.0f) : glm::vec4(0.8f,0.8f,0.8f,1.0f),
+                    "%d: %.2f %.2f %.2f / %.2f %.2f %.2f / %.2f %.2f %.2f / %.2f %.2f %.2f",
+                    nodeIds[i],
+                    sample.values[sgct_core::ClusterStatistics::FrameTime]*1000.0f,
+                    clusterStats->getPercentile(nodeIds[i], sgct_core::ClusterStatistics::FrameTime, 50.0f)*1000.0f,
+                    clusterStats->getPercentile(nodeIds[i], sgct_core::ClusterStatistics::FrameTime, 99.0f)*1000.0f,
+                    sample.values[sgct_core::ClusterStatistics::DrawTime]*1000.0f,
+                    clusterStats->getPercentile(nodeIds[i], sgct_core::ClusterStatistics::DrawTime, 50.0f)*1000.0f,
+                    clusterStats->getPercentile(nodeIds[i], sgct_core::ClusterStatistics::DrawTime, 99.0f)*1000.0f,
+                    sample.values[sgct_core::ClusterStatistics::GpuTime]*1000.0f,
+                    clusterStats->getPercentile(nodeIds[i], sgct_core::ClusterStatistics::GpuTime, 50.0f)*1000.0f,
+                    clusterStats->getPercentile(nodeIds[i], sgct_core::ClusterStatistics::GpuTime, 99.0f)*1000.0f,
+                    sample.values[sgct_core::ClusterStatistics::SyncTime]*1000.0f,
+                    clusterStats->getPercentile(nodeIds[i], sgct_core::ClusterStatistics::SyncTime, 50.0f)*1000.0f,
+                    clusterStats->getPercentile(nodeIds[i], sgct_core::ClusterStatistics::SyncTime, 99.0f)*1000.0f);
+            }
+        }
     }
 
     //reset
@@ -1793,6 +1978,10 @@ void sgct::Engine::drawFixedPipeline()
 */
 void sgct::Engine::drawOverlays()
 {
+    //the compositor blends the overlays when the framebuffer texture is drawn to the window
+    if (getCurrentWindowPtr()->usesSinglePassCompositor())
+        return;
+
     for(std::size_t i=0; i < getCurrentWindowPtr()->getNumberOfViewports(); i++)
     {
         getCurrentWindowPtr()->setCurrentViewport(i);
@@ -1960,6 +2149,7 @@ void sgct::Engine::renderFBOTexture()
         sgct_core::CorrectionMesh::WARP_MESH : sgct_core::CorrectionMesh::QUAD_MESH;
 
     SGCTWindow::StereoMode sm = win->getStereoMode();
+    bool composite = win->usesSinglePassCompositor();
     if( sm > SGCTWindow::Active_Stereo && sm < SGCTWindow::Side_By_Side_Stereo )
     {
         glActiveTexture(GL_TEXTURE0);
@@ -1976,6 +2166,22 @@ void sgct::Engine::renderFBOTexture()
         for(std::size_t i=0; i<win->getNumberOfViewports(); i++)
             win->getViewport(i)->renderMesh( mt );
     }
+    else if (composite)
+    {
+        compositeViewports(LeftEye, mt);
+
+        //render right eye in active stereo mode
+        if (sm == SGCTWindow::Active_Stereo)
+        {
+            glViewport(0, 0, xSize, ySize);
+
+            //clear buffers
+            mCurrentFrustumMode = sgct_core::Frustum::StereoRightEye;
+            setAndClearBuffer(BackBufferBlack);
+
+            compositeViewports(RightEye, mt);
+        }
+    }
     else
     {
         glActiveTexture(GL_TEXTURE0); //Open Scene Graph or the user may have changed the active texture
@@ -2004,7 +2210,7 @@ void sgct::Engine::renderFBOTexture()
     }
 
     //render mask (mono)
-    if (win->hasAnyMasks())
+    if (win->hasAnyMasks() && !composite)
     {
         if (!maskShaderSet)
         {
@@ -2060,6 +2266,50 @@ void sgct::Engine::renderFBOTexture()
     glDisable(GL_BLEND);
 }
 
+/*!
+    Draws the warp mesh of every viewport with the single pass compositor, which applies the overlay,
+    the combined blend and black level mask and the window's color correction in the same pass.
+*/
+void sgct::Engine::compositeViewports(TextureIndexes ti, sgct_core::CorrectionMesh::MeshType mt)
+{
+    SGCTWindow * win = getCurrentWindowPtr();
+
+    glActiveTexture(GL_TEXTURE0); //Open Scene Graph or the user may have changed the active texture
+    glBindTexture(GL_TEXTURE_2D, win->getFrameBufferTexture(ti));
+
+    mShaders[CompositorShader].bind();
+
+    bool colorCorrection = win->getGamma() != 1.0f || win->getContrast() != 1.0f || win->getBrightness() != 1.0f;
+    glUniform1i(mShaderLocs[CompositorUseColorCorrection], colorCorrection ? 1 : 0);
+    glUniform3f(mShaderLocs[CompositorColorCorrection], 1.0f / win->getGamma(), win->getContrast(), win->getBrightness());
+
+    for (std::size_t i = 0; i < win->getNumberOfViewports(); i++)
+    {
+        sgct_core::Viewport * vpPtr = win->getViewport(i);
+        if (!vpPtr->isEnabled())
+            continue;
+
+        glUniform4f(mShaderLocs[CompositorViewportRect], vpPtr->getX(), vpPtr->getY(), 1.0f / vpPtr->getXSize(), 1.0f / vpPtr->getYSize());
+
+        glUniform1i(mShaderLocs[CompositorUseMask], vpPtr->hasCombinedMaskTexture() ? 1 : 0);
+        if (vpPtr->hasCombinedMaskTexture())
+        {
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, vpPtr->getCombinedMaskTextureIndex());
+        }
+
+        glUniform1i(mShaderLocs[CompositorUseOverlay], vpPtr->hasOverlayTexture() ? 1 : 0);
+        if (vpPtr->hasOverlayTexture())
+        {
+            glActiveTexture(GL_TEXTURE2);
+            glBindTexture(GL_TEXTURE_2D, vpPtr->getOverlayTextureIndex());
+        }
+
+        glActiveTexture(GL_TEXTURE0);
+        vpPtr->renderMesh(mt);
+    }
+}
+
 
 /*!
     Draw geometry and bind FBO as texture in screenspace (ortho mode).
@@ -2225,29 +2475,20 @@ void sgct::Engine::renderViewports(TextureIndexes ti)
 
         if( vp->isEnabled() )
         {
+            FrameTrace::Scope scope("drawViewport", "viewport", static_cast<int>(i));
+
             //if passive stereo or mono
             if( sm == SGCTWindow::No_Stereo )
                 mCurrentFrustumMode = vp->getEye();
 
+            //tracked frustums are updated in updateTrackedFrustums
             if (vp->hasSubViewports())
             {
-                if (vp->isTracked())
-                    vp->getNonLinearProjectionPtr()->updateFrustums(
-                        mCurrentFrustumMode,
-                        mNearClippingPlaneDist,
-                        mFarClippingPlaneDist);
-
                 if (getCurrentWindowPtr()->getCallDraw3DFunction())
                     vp->getNonLinearProjectionPtr()->render();
             }
             else //no subviewports
             {
-                if (vp->isTracked())
-                    vp->calculateFrustum(
-                        mCurrentFrustumMode,
-                        mNearClippingPlaneDist,
-                        mFarClippingPlaneDist);
-
                 //check if we want to copy the previos window into this one before we go ahead with anyting else
                 if (getCurrentWindowPtr()->getCopyPreviousWindowToCurrentWindow())
                     copyPreviousWindowViewportToCurrentWindowViewport(mCurrentFrustumMode);
@@ -2278,7 +2519,10 @@ void sgct::Engine::renderViewports(TextureIndexes ti)
             //blit buffers
             updateRenderingTargets(ti); //only used if multisampled FBOs
 
-            (this->*mInternalRenderPostFXFn)(ti);
+            {
+                FrameTrace::Scope scope("postFX", "window", static_cast<int>(getCurrentWindowIndex()));
+                (this->*mInternalRenderPostFXFn)(ti);
+            }
 
             render2D();
             if(split_screen_stereo)
@@ -2312,6 +2556,8 @@ void sgct::Engine::renderViewports(TextureIndexes ti)
 */
 void sgct::Engine::render2D()
 {
+    FrameTrace::Scope scope("render2D");
+
     //draw viewport overlays if any
     (this->*mInternalDrawOverlaysFn)();
 
@@ -2352,120 +2598,115 @@ void sgct::Engine::render2D()
 }
 
 /*!
-    This function combines a texture and a shader into a new texture
+    This function renders the post effect chain of the current window, see sgct_core::PostFXGraph for how the passes are
+    split into stages. Consecutive per-pixel passes are rendered with one fused shader.
 */
 void sgct::Engine::renderPostFX(TextureIndexes finalTargetIndex)
 {
     glDrawBuffer( GL_COLOR_ATTACHMENT0 );
 
-    PostFX * fx = NULL;
-    PostFX * fxPrevious = NULL;
+    SGCTWindow * win = getCurrentWindowPtr();
+    const sgct_core::PostFXGraph & graph = win->updatePostFXGraph();
 
-    std::size_t numberOfPasses = getCurrentWindowPtr()->getNumberOfPostFXs();
-    for( std::size_t i = 0; i<numberOfPasses; i++ )
+    for( std::size_t i = 0; i < graph.getStages().size(); i++ )
     {
-        fx = getCurrentWindowPtr()->getPostFXPtr( i );
+        const sgct_core::PostFXGraph::Stage & stage = graph.getStages()[i];
+        unsigned int input = getPostFXBufferTexture( stage.input, finalTargetIndex );
+        unsigned int output = getPostFXBufferTexture( stage.output, finalTargetIndex );
 
-        //set output
-        if( i == (numberOfPasses-1) && !getCurrentWindowPtr()->useFXAA() ) //if last
-            fx->setOutputTexture( getCurrentWindowPtr()->getFrameBufferTexture( finalTargetIndex ) );
-        else
-            fx->setOutputTexture( getCurrentWindowPtr()->getFrameBufferTexture( (i%2 == 0) ? FX1 : FX2 ) ); //ping pong between the two FX buffers
+        if( stage.isFused() )
+        {
+            ShaderProgram * program = win->getFusedPostFXProgram( i );
+            if( program == NULL )
+            {
+                //fusion has been disabled for the window, start over with the passes rendered one at a time
+                win->updatePostFXGraph();
+                i = static_cast<std::size_t>(-1);
+                continue;
+            }
 
-        //set input (dependent on output)
-        if( i == 0 )
-            fx->setInputTexture( getCurrentWindowPtr()->getFrameBufferTexture( Intermediate ) );
-        else
+            PostFX::renderFused( program, win, stage.passes, input, output );
+        }
+        else if( !stage.passes.empty() )
         {
-            fxPrevious = getCurrentWindowPtr()->getPostFXPtr( i-1 );
-            fx->setInputTexture( fxPrevious->getOutputTexture() );
+            PostFX * fx = win->getPostFXPtr( stage.passes[0] );
+            fx->setInputTexture( input );
+            fx->setOutputTexture( output );
+            fx->render();
         }
+        else
+        {
+            //bind target FBO
+            win->mFinalFBO_Ptr->attachColorTexture( output );
 
-        fx->render();
-    }
-    if( getCurrentWindowPtr()->useFXAA() )
-    {
-        //bind target FBO
-        getCurrentWindowPtr()->mFinalFBO_Ptr->attachColorTexture( getCurrentWindowPtr()->getFrameBufferTexture( finalTargetIndex ) );
-
-        //if for some reson the active texture has been reset
-        glViewport(0, 0, getCurrentWindowPtr()->getXFramebufferResolution(), getCurrentWindowPtr()->getYFramebufferResolution());
-        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-
-        glActiveTexture(GL_TEXTURE0);
+            //if for some reson the active texture has been reset
+            glViewport(0, 0, win->getXFramebufferResolution(), win->getYFramebufferResolution());
+            glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
 
-        if( fx != NULL )
-            glBindTexture(GL_TEXTURE_2D, fx->getOutputTexture() );
-        else
-            glBindTexture(GL_TEXTURE_2D, getCurrentWindowPtr()->getFrameBufferTexture( Intermediate ) );
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, input );
 
-        mShaders[FXAAShader].bind();
-        glUniform1f( mShaderLocs[SizeX], static_cast<float>(getCurrentWindowPtr()->getXFramebufferResolution()) );
-        glUniform1f( mShaderLocs[SizeY], static_cast<float>(getCurrentWindowPtr()->getYFramebufferResolution()) );
-        glUniform1i( mShaderLocs[FXAA_Texture], 0 );
-        glUniform1f( mShaderLocs[FXAA_SUBPIX_TRIM], SGCTSettings::instance()->getFXAASubPixTrim() );
-        glUniform1f( mShaderLocs[FXAA_SUBPIX_OFFSET], SGCTSettings::instance()->getFXAASubPixOffset() );
+            if( stage.fxaa )
+            {
+                mShaders[FXAAShader].bind();
+                glUniform1f( mShaderLocs[SizeX], static_cast<float>(win->getXFramebufferResolution()) );
+                glUniform1f( mShaderLocs[SizeY], static_cast<float>(win->getYFramebufferResolution()) );
+                glUniform1i( mShaderLocs[FXAA_Texture], 0 );
+                glUniform1f( mShaderLocs[FXAA_SUBPIX_TRIM], SGCTSettings::instance()->getFXAASubPixTrim() );
+                glUniform1f( mShaderLocs[FXAA_SUBPIX_OFFSET], SGCTSettings::instance()->getFXAASubPixOffset() );
+            }
+            else //all passes are disabled so just copy
+            {
+                mShaders[OverlayShader].bind();
+                glUniform1i( mShaderLocs[OverlayTex], 0 );
+            }
 
-        getCurrentWindowPtr()->bindVAO();
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-        getCurrentWindowPtr()->unbindVAO();
+            win->bindVAO();
+            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+            win->unbindVAO();
 
-        //unbind FXAA
-        ShaderProgram::unbind();
+            ShaderProgram::unbind();
+        }
     }
 }
 
 /*!
-    This function combines a texture and a shader into a new texture
+    This function renders the post effect chain of the current window in the fixed pipeline. Per-pixel passes aren't fused.
 */
 void sgct::Engine::renderPostFXFixedPipeline(TextureIndexes finalTargetIndex)
 {
     glDrawBuffer( GL_COLOR_ATTACHMENT0 );
 
-    PostFX * fx = NULL;
-    PostFX * fxPrevious = NULL;
-
-    std::size_t numberOfPasses = getCurrentWindowPtr()->getNumberOfPostFXs();
-    if( numberOfPasses > 0 )
-    {
-        glPushAttrib(GL_ALL_ATTRIB_BITS);
-        glEnable(GL_TEXTURE_2D);
-        glDisable(GL_CULL_FACE);
-        glDisable(GL_LIGHTING);
-        glDisable(GL_DEPTH_TEST);
-        glEnable(GL_BLEND);
-    }
+    SGCTWindow * win = getCurrentWindowPtr();
+    const sgct_core::PostFXGraph & graph = win->updatePostFXGraph();
 
-    for( std::size_t i = 0; i<numberOfPasses; i++ )
+    for( std::size_t i = 0; i < graph.getStages().size(); i++ )
     {
-        fx = getCurrentWindowPtr()->getPostFXPtr( i );
+        const sgct_core::PostFXGraph::Stage & stage = graph.getStages()[i];
+        unsigned int input = getPostFXBufferTexture( stage.input, finalTargetIndex );
+        unsigned int output = getPostFXBufferTexture( stage.output, finalTargetIndex );
 
-        //set output
-        if( i == (numberOfPasses-1) && !getCurrentWindowPtr()->useFXAA() ) //if last
-            fx->setOutputTexture( getCurrentWindowPtr()->getFrameBufferTexture( finalTargetIndex ) );
-        else
-            fx->setOutputTexture( getCurrentWindowPtr()->getFrameBufferTexture( (i%2 == 0) ? FX1 : FX2 ) ); //ping pong between the two FX buffers
-
-        //set input (dependent on output)
-        if( i == 0 )
-            fx->setInputTexture( getCurrentWindowPtr()->getFrameBufferTexture( Intermediate ) );
-        else
+        if( !stage.passes.empty() )
         {
-            fxPrevious = getCurrentWindowPtr()->getPostFXPtr( i-1 );
-            fx->setInputTexture( fxPrevious->getOutputTexture() );
-        }
+            glPushAttrib(GL_ALL_ATTRIB_BITS);
+            glEnable(GL_TEXTURE_2D);
+            glDisable(GL_CULL_FACE);
+            glDisable(GL_LIGHTING);
+            glDisable(GL_DEPTH_TEST);
+            glEnable(GL_BLEND);
 
-        fx->render();
-    }
+            PostFX * fx = win->getPostFXPtr( stage.passes[0] );
+            fx->setInputTexture( input );
+            fx->setOutputTexture( output );
+            fx->render();
 
-    if( numberOfPasses > 0 )
-        glPopAttrib();
+            glPopAttrib();
+            continue;
+        }
 
-    if( getCurrentWindowPtr()->useFXAA() )
-    {
         //bind target FBO
-        getCurrentWindowPtr()->mFinalFBO_Ptr->attachColorTexture( getCurrentWindowPtr()->getFrameBufferTexture( finalTargetIndex ) );
+        win->mFinalFBO_Ptr->attachColorTexture( output );
 
         //if for some reson the active texture has been reset
         glActiveTexture(GL_TEXTURE0); //Open Scene Graph or the user may have changed the active texture
@@ -2473,7 +2714,7 @@ void sgct::Engine::renderPostFXFixedPipeline(TextureIndexes finalTargetIndex)
         glLoadIdentity();
 
         glMatrixMode(GL_MODELVIEW); //restore
-        glViewport(0, 0, getCurrentWindowPtr()->getXFramebufferResolution(), getCurrentWindowPtr()->getYFramebufferResolution());
+        glViewport(0, 0, win->getXFramebufferResolution(), win->getYFramebufferResolution());
         
         glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
         glClear(GL_COLOR_BUFFER_BIT);
@@ -2481,26 +2722,28 @@ void sgct::Engine::renderPostFXFixedPipeline(TextureIndexes finalTargetIndex)
         glPushAttrib(GL_ALL_ATTRIB_BITS);
 
         glEnable(GL_TEXTURE_2D);
-        if( fx != NULL )
-            glBindTexture(GL_TEXTURE_2D, fx->getOutputTexture() );
-        else
-            glBindTexture(GL_TEXTURE_2D, getCurrentWindowPtr()->getFrameBufferTexture( Intermediate ) );
+        glBindTexture(GL_TEXTURE_2D, input );
 
         glDisable(GL_CULL_FACE);
         glDisable(GL_LIGHTING);
         glDisable(GL_DEPTH_TEST);
         glDisable(GL_BLEND);
 
-        mShaders[FXAAShader].bind();
-        glUniform1f( mShaderLocs[SizeX], static_cast<float>(getCurrentWindowPtr()->getXFramebufferResolution()) );
-        glUniform1f( mShaderLocs[SizeY], static_cast<float>(getCurrentWindowPtr()->getYFramebufferResolution()) );
-        glUniform1i( mShaderLocs[FXAA_Texture], 0 );
-        glUniform1f( mShaderLocs[FXAA_SUBPIX_TRIM], SGCTSettings::instance()->getFXAASubPixTrim() );
-        glUniform1f( mShaderLocs[FXAA_SUBPIX_OFFSET], SGCTSettings::instance()->getFXAASubPixOffset() );
+        if( stage.fxaa )
+        {
+            mShaders[FXAAShader].bind();
+            glUniform1f( mShaderLocs[SizeX], static_cast<float>(win->getXFramebufferResolution()) );
+            glUniform1f( mShaderLocs[SizeY], static_cast<float>(win->getYFramebufferResolution()) );
+            glUniform1i( mShaderLocs[FXAA_Texture], 0 );
+            glUniform1f( mShaderLocs[FXAA_SUBPIX_TRIM], SGCTSettings::instance()->getFXAASubPixTrim() );
+            glUniform1f( mShaderLocs[FXAA_SUBPIX_OFFSET], SGCTSettings::instance()->getFXAASubPixOffset() );
+        }
+        else //all passes are disabled so just copy with fixed function texturing
+            glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
 
         glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
 
-        getCurrentWindowPtr()->bindVBO();
+        win->bindVBO();
         glClientActiveTexture(GL_TEXTURE0);
 
         glEnableClientState(GL_TEXTURE_COORD_ARRAY);
@@ -2510,7 +2753,7 @@ void sgct::Engine::renderPostFXFixedPipeline(TextureIndexes finalTargetIndex)
         glVertexPointer(3, GL_FLOAT, 5*sizeof(float), reinterpret_cast<void*>(8));
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
-        getCurrentWindowPtr()->unbindVBO();
+        win->unbindVBO();
 
         ShaderProgram::unbind();
 
@@ -2519,6 +2762,24 @@ void sgct::Engine::renderPostFXFixedPipeline(TextureIndexes finalTargetIndex)
     }
 }
 
+/*!
+    \returns the texture of a post effect buffer, the scene is rendered to the source buffer and the pool buffers ping-pong between the FX textures
+*/
+unsigned int sgct::Engine::getPostFXBufferTexture(sgct_core::PostFXGraph::Buffer buffer, TextureIndexes finalTargetIndex)
+{
+    switch( buffer )
+    {
+    case sgct_core::PostFXGraph::SourceBuffer:
+        return getCurrentWindowPtr()->getFrameBufferTexture( Intermediate );
+    case sgct_core::PostFXGraph::PoolBuffer0:
+        return getCurrentWindowPtr()->getFrameBufferTexture( FX1 );
+    case sgct_core::PostFXGraph::PoolBuffer1:
+        return getCurrentWindowPtr()->getFrameBufferTexture( FX2 );
+    default:
+        return getCurrentWindowPtr()->getFrameBufferTexture( finalTargetIndex );
+    }
+}
+
 /*!
     This function updates the renderingtargets.
 */
@@ -2664,6 +2925,33 @@ void sgct::Engine::loadShaders()
         mShaderLocs[OverlayTex] = mShaders[OverlayShader].getUniformLocation( "Tex" );
         glUniform1i( mShaderLocs[OverlayTex], 0 );
         ShaderProgram::unbind();
+
+        if (SGCTSettings::instance()->getUseSinglePassCompositor())
+        {
+            std::string Compositor_vert_shader = sgct_core::shaders_modern::Compositor_Vert_Shader;
+            std::string Compositor_frag_shader = sgct_core::shaders_modern::Compositor_Frag_Shader;
+
+            //replace glsl version
+            sgct_helpers::findAndReplace(Compositor_vert_shader, "**glsl_version**", Engine::instance()->getGLSLVersion());
+            sgct_helpers::findAndReplace(Compositor_frag_shader, "**glsl_version**", Engine::instance()->getGLSLVersion());
+
+            mShaders[CompositorShader].setName("CompositorShader");
+            if (!mShaders[CompositorShader].addShaderSrc(Compositor_vert_shader, GL_VERTEX_SHADER, ShaderProgram::SHADER_SRC_STRING))
+                MessageHandler::instance()->print(MessageHandler::NOTIFY_ERROR, "Failed to load compositor vertex shader\n");
+            if (!mShaders[CompositorShader].addShaderSrc(Compositor_frag_shader, GL_FRAGMENT_SHADER, ShaderProgram::SHADER_SRC_STRING))
+                MessageHandler::instance()->print(MessageHandler::NOTIFY_ERROR, "Failed to load compositor fragment shader\n");
+            mShaders[CompositorShader].createAndLinkProgram();
+            mShaders[CompositorShader].bind();
+            glUniform1i(mShaders[CompositorShader].getUniformLocation("Tex"), 0);
+            glUniform1i(mShaders[CompositorShader].getUniformLocation("MaskTex"), 1);
+            glUniform1i(mShaders[CompositorShader].getUniformLocation("OverlayTex"), 2);
+            mShaderLocs[CompositorViewportRect] = mShaders[CompositorShader].getUniformLocation("ViewportRect");
+            mShaderLocs[CompositorUseMask] = mShaders[CompositorShader].getUniformLocation("UseMask");
+            mShaderLocs[CompositorUseOverlay] = mShaders[CompositorShader].getUniformLocation("UseOverlay");
+            mShaderLocs[CompositorUseColorCorrection] = mShaders[CompositorShader].getUniformLocation("UseColorCorrection");
+            mShaderLocs[CompositorColorCorrection] = mShaders[CompositorShader].getUniformLocation("ColorCorrection");
+            ShaderProgram::unbind();
+        }
     }
 }
 
@@ -2848,9 +3136,51 @@ void sgct::Engine::waitForAllWindowsInSwapGroupToOpen()
 }
 
 /*!
-    This functions updates the frustum of all viewports on demand. However if the viewport is tracked this is done on the fly.
+    This functions updates the frustum of all viewports on demand. However if the viewport is tracked this is done every frame in updateTrackedFrustums.
 */
 void sgct::Engine::updateFrustums()
+{
+    sgct_core::SGCTProjectionSolver solver;
+    solveFrustums(solver, false);
+}
+
+/*!
+    Reloads the planar projection and projection plane of this node's viewports from the config file and updates the frustums.
+    Slaves that received their configuration from the master (-distributeConfig) request it from the master again.
+    Other changes to the configuration, including the viewport position and size, require a restart.
+
+    \returns false if the config file couldn't be read
+*/
+bool sgct::Engine::reloadConfiguration()
+{
+    if( mConfig == NULL || mThisNode == NULL )
+        return false;
+
+    int nodeId = sgct_core::ClusterManager::instance()->getThisNodeId();
+    bool receiveConfig = sgct_core::ConfigDistributor::instance()->isEnabled() &&
+        sgct_core::ClusterManager::instance()->getNumberOfNodes() > 1 && !mNetworkConnections->isComputerServer();
+    if( receiveConfig )
+    {
+        tinyxml2::XMLDocument xmlDoc;
+        if( !sgct_core::ConfigDistributor::instance()->receive(nodeId, xmlDoc) || !mConfig->reloadViewports(nodeId, xmlDoc) )
+            return false;
+    }
+    else if( !mConfig->reloadViewports(nodeId) )
+        return false;
+
+    updateFrustums();
+    return true;
+}
+
+/*!
+    Updates the frustums of all tracked viewports for all eyes and cube faces in one batch.
+*/
+void sgct::Engine::updateTrackedFrustums()
+{
+    solveFrustums(mTrackedProjectionSolver, true);
+}
+
+void sgct::Engine::solveFrustums(sgct_core::SGCTProjectionSolver & solver, bool tracked)
 {
     SGCTWindow * win;
     sgct_core::Viewport * vp;
@@ -2858,51 +3188,29 @@ void sgct::Engine::updateFrustums()
     if (mThisNode == NULL)
         return;
 
+    solver.clear();
+
     for(size_t w=0; w < mThisNode->getNumberOfWindows(); w++)
     {
         win = mThisNode->getWindowPtr(w);
         for (unsigned int i = 0; i < win->getNumberOfViewports(); i++)
         {
             vp = win->getViewport(i);
-            if (!vp->isTracked()) //if not tracked update, otherwise this is done on the fly
+            if (vp->isTracked() == tracked)
             {
-                if (vp->hasSubViewports())
-                {
-                    vp->getNonLinearProjectionPtr()->updateFrustums(
-                        sgct_core::Frustum::MonoEye,
-                        mNearClippingPlaneDist,
-                        mFarClippingPlaneDist);
-
-                    vp->getNonLinearProjectionPtr()->updateFrustums(
-                        sgct_core::Frustum::StereoLeftEye,
-                        mNearClippingPlaneDist,
-                        mFarClippingPlaneDist);
-
-                    vp->getNonLinearProjectionPtr()->updateFrustums(
-                        sgct_core::Frustum::StereoRightEye,
-                        mNearClippingPlaneDist,
-                        mFarClippingPlaneDist);
-                }
-                else
+                for (int eye = sgct_core::Frustum::MonoEye; eye <= sgct_core::Frustum::StereoRightEye; eye++)
                 {
-                    vp->calculateFrustum(
-                        sgct_core::Frustum::MonoEye,
-                        mNearClippingPlaneDist,
-                        mFarClippingPlaneDist);
-
-                    vp->calculateFrustum(
-                        sgct_core::Frustum::StereoLeftEye,
-                        mNearClippingPlaneDist,
-                        mFarClippingPlaneDist);
-
-                    vp->calculateFrustum(
-                        sgct_core::Frustum::StereoRightEye,
-                        mNearClippingPlaneDist,
-                        mFarClippingPlaneDist);
+                    sgct_core::Frustum::FrustumMode fm = static_cast<sgct_core::Frustum::FrustumMode>(eye);
+                    if (vp->hasSubViewports())
+                        solver.addNonLinearProjection(vp->getNonLinearProjectionPtr(), fm);
+                    else
+                        solver.addViewport(vp, fm);
                 }
             }
         }
     }
+
+    solver.solve(mNearClippingPlaneDist, mFarClippingPlaneDist);
 }
 
 /*!
@@ -3011,6 +3319,65 @@ void sgct::Engine::parseArguments( std::vector<std::string>& arg )
             arg.erase(arg.begin() + i);
             arg.erase(arg.begin() + i);
         }
+        else if( arg[i] == "-trace" && arg.size() > (i+1) )
+        {
+            std::string tmpStr = arg[i+1];
+            tmpStr.erase( remove( tmpStr.begin(), tmpStr.end(), '\"' ), tmpStr.end() );
+            std::size_t lastPos = tmpStr.length() - 1;
+
+            const char last = tmpStr.at( lastPos );
+            if( last == '\\' || last == '/' )
+                tmpStr.erase( lastPos );
+
+            mTracePath.assign( tmpStr );
+
+            arg.erase(arg.begin() + i);
+            arg.erase(arg.begin() + i);
+        }
+        else if( arg[i] == "-clusterStats" && arg.size() > (i+1) )
+        {
+            mClusterStatsFilename.assign( arg[i+1] );
+            arg.erase(arg.begin() + i);
+            arg.erase(arg.begin() + i);
+        }
+        else if( arg[i] == "-trackingRecord" && arg.size() > (i+1) )
+        {
+            sgct_core::ClusterManager::instance()->getTrackingManagerPtr()->setRecordFile( arg[i+1] );
+            arg.erase(arg.begin() + i);
+            arg.erase(arg.begin() + i);
+        }
+        else if( arg[i] == "-trackingReplay" && arg.size() > (i+1) )
+        {
+            sgct_core::ClusterManager::instance()->getTrackingManagerPtr()->setReplayFile( arg[i+1] );
+            arg.erase(arg.begin() + i);
+            arg.erase(arg.begin() + i);
+        }
+        else if( arg[i] == "--Ignore-Config-Cache" )
+        {
+            sgct_core::ReadConfig::setUseCache(false);
+            arg.erase(arg.begin() + i);
+        }
+        else if( arg[i] == "--Watch-Config" )
+        {
+            mWatchConfig = true;
+            arg.erase(arg.begin() + i);
+        }
+        else if( arg[i] == "-distributeConfig" && arg.size() > (i+1) )
+        {
+            sgct_core::ConfigDistributor::instance()->setCacheDirectory( arg[i+1] );
+            arg.erase(arg.begin() + i);
+            arg.erase(arg.begin() + i);
+        }
+        else if( arg[i] == "--Tracking-Replay-Fast" )
+        {
+            sgct_core::ClusterManager::instance()->getTrackingManagerPtr()->setReplayRealTime(false);
+            arg.erase(arg.begin() + i);
+        }
+        else if( arg[i] == "--Tracking-Replay-Loop" )
+        {
+            sgct_core::ClusterManager::instance()->getTrackingManagerPtr()->setReplayLoop(true);
+            arg.erase(arg.begin() + i);
+        }
         else if( arg[i] == "-notify" && arg.size() > (i+1) )
         {
             int tmpi = -1;
@@ -3312,7 +3679,16 @@ void sgct::Engine::setCleanUpFunction(sgct_cppxeleven::function<void(void)> fn)
  <Cluster masterAddress="127.0.0.1" externalControlPort="20500">
  \endcode
  
- All TCP messages must be separated by carriage return (CR) followed by a newline (NL). Look at this [tutorial](https://c-student.itn.liu.se/wiki/develop:sgcttutorials:externalguicsharp) for more info.
+ All TCP messages must be separated by carriage return (CR) followed by a newline (NL).
+
+ Several clients can be connected at the same time by setting the number of clients with externalControlClients:
+ \code
+ <Cluster masterAddress="127.0.0.1" externalControlPort="20500" externalControlClients="8">
+ \endcode
+ The clients can then also send length-prefixed binary messages and browsers can connect with WebSockets
+ (ws://<master>:20500), see sgct_core::ExternalControlServer. Messages sent with sendMessageToExternalControl go to all clients.
+
+ Look at this [tutorial](https://c-student.itn.liu.se/wiki/develop:sgcttutorials:externalguicsharp) for more info.
  
  */
 void sgct::Engine::setExternalControlCallback(void(*fnPtr)(const char *, int))
@@ -4196,6 +4572,12 @@ void sgct::Engine::invokeUpdateCallbackForExternalControl(bool connected)
  */
 void sgct::Engine::invokeDecodeCallbackForDataTransfer(void * receivedData, int receivedlength, int packageId, int clientId)
 {
+    if (sgct_core::ConfigDistributor::isPackageId(packageId))
+    {
+        sgct_core::ConfigDistributor::instance()->decode(reinterpret_cast<const char *>(receivedData), receivedlength, packageId, clientId);
+        return;
+    }
+
     if (mDataTransferDecodeCallbackFnPtr != SGCT_NULL_PTR && receivedlength > 0)
         mDataTransferDecodeCallbackFnPtr(receivedData, receivedlength, packageId, clientId);
 }
@@ -4214,7 +4596,7 @@ void sgct::Engine::invokeUpdateCallbackForDataTransfer(bool connected, int clien
  */
 void sgct::Engine::invokeAcknowledgeCallbackForDataTransfer(int packageId, int clientId)
 {
-    if (mDataTransferAcknowledgeCallbackFnPtr != SGCT_NULL_PTR)
+    if (mDataTransferAcknowledgeCallbackFnPtr != SGCT_NULL_PTR && !sgct_core::ConfigDistributor::isPackageId(packageId))
         mDataTransferAcknowledgeCallbackFnPtr(packageId, clientId);
 }
 
@@ -4243,7 +4625,9 @@ void sgct::Engine::invokeScreenShotCallback2(unsigned char * data, std::size_t w
 */
 void sgct::Engine::sendMessageToExternalControl(const void * data, int length)
 {
-    if( mNetworkConnections->getExternalControlPtr() != NULL )
+    if( mNetworkConnections->getExternalControlServerPtr() != NULL )
+        mNetworkConnections->getExternalControlServerPtr()->sendData( data, length );
+    else if( mNetworkConnections->getExternalControlPtr() != NULL )
         mNetworkConnections->getExternalControlPtr()->sendData( data, length );
 }
 
@@ -4288,7 +4672,9 @@ void sgct::Engine::transferDataToNode(const void * data, int length, int package
 */
 void sgct::Engine::sendMessageToExternalControl(const std::string& msg)
 {
-    if( mNetworkConnections->getExternalControlPtr() != NULL )
+    if( mNetworkConnections->getExternalControlServerPtr() != NULL )
+        mNetworkConnections->getExternalControlServerPtr()->sendData( msg.c_str(), static_cast<int>(msg.size()) );
+    else if( mNetworkConnections->getExternalControlPtr() != NULL )
         mNetworkConnections->getExternalControlPtr()->sendData( (void *)msg.c_str(), static_cast<int>(msg.size()) );
 }
 
@@ -4297,6 +4683,9 @@ void sgct::Engine::sendMessageToExternalControl(const std::string& msg)
 */
 bool sgct::Engine::isExternalControlConnected()
 {
+    if( mNetworkConnections->getExternalControlServerPtr() != NULL )
+        return mNetworkConnections->getExternalControlServerPtr()->isConnected();
+
     return (mNetworkConnections->getExternalControlPtr() != NULL && mNetworkConnections->getExternalControlPtr()->isConnected());
 }
 
@@ -4305,7 +4694,9 @@ bool sgct::Engine::isExternalControlConnected()
 */
 void sgct::Engine::setExternalControlBufferSize(unsigned int newSize)
 {
-    if( mNetworkConnections->getExternalControlPtr() != NULL )
+    if( mNetworkConnections->getExternalControlServerPtr() != NULL )
+        mNetworkConnections->getExternalControlServerPtr()->setMaxMessageSize(newSize);
+    else if( mNetworkConnections->getExternalControlPtr() != NULL )
         mNetworkConnections->getExternalControlPtr()->setBufferSize(newSize);
 }
 
@@ -4359,6 +4750,291 @@ void sgct::Engine::updateDrawBufferResolutions()
     }
 }
 
+/*!
+    Lets the resolution scaler decide the scale of the render resolution on the master. The slowest node gates the
+    whole cluster so the largest draw or gpu time of the latest frame statistics of all nodes is used.
+*/
+void sgct::Engine::updateResolutionScale()
+{
+    sgct_core::ClusterStatistics * clusterStats = sgct_core::ClusterStatistics::instance();
+    std::vector<int> nodeIds = clusterStats->getNodeIds();
+
+    float frameTime = 0.0f;
+    for (std::size_t i = 0; i < nodeIds.size(); i++)
+    {
+        sgct_core::ClusterStatistics::Sample sample;
+        if (clusterStats->getLatestSample(nodeIds[i], sample))
+        {
+            float nodeTime = sample.values[sgct_core::ClusterStatistics::DrawTime] > sample.values[sgct_core::ClusterStatistics::GpuTime] ?
+                sample.values[sgct_core::ClusterStatistics::DrawTime] :
+                sample.values[sgct_core::ClusterStatistics::GpuTime];
+            frameTime = nodeTime > frameTime ? nodeTime : frameTime;
+        }
+    }
+
+    if (mResolutionScaler.update(frameTime))
+    {
+        mResolutionScale.setVal(mResolutionScaler.getScale());
+        MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Engine: Render resolution scale set to %.2f (frame time %.2f ms, budget %.2f ms).\n",
+            mResolutionScaler.getScale(), frameTime * 1000.0f, mResolutionScaler.getBudget() * 1000.0f);
+    }
+}
+
+/*!
+    Plans the render graph again if the state of any window that it depends on has changed since it was planned.
+*/
+void sgct::Engine::updateRenderGraph()
+{
+    std::vector<int> state;
+    state.push_back(SGCTSettings::instance()->useFBO() ? 1 : 0);
+    state.push_back(SGCTSettings::instance()->getUseTextureAliasing() ? 1 : 0);
+
+    for (std::size_t i = 0; i < mThisNode->getNumberOfWindows(); i++)
+    {
+        SGCTWindow * win = getWindowPtr(i);
+        int x, y;
+        win->getFinalFBODimensions(x, y);
+
+        state.push_back(win->isVisible() ? 1 : 0);
+        state.push_back(win->isRenderingWhileHidden() ? 1 : 0);
+        state.push_back(static_cast<int>(win->getStereoMode()));
+        state.push_back(x);
+        state.push_back(y);
+        state.push_back(static_cast<int>(win->getColorBitDepth()));
+        state.push_back(win->usePostFX() ? static_cast<int>(win->updatePostFXGraph().getNumberOfPoolBuffers()) : -1);
+        state.push_back(win->getCallDraw3DFunction() ? 1 : 0);
+        for (std::size_t j = 0; j < win->getNumberOfViewports(); j++)
+            state.push_back((win->getViewport(j)->isEnabled() ? 2 : 0) + (win->getViewport(j)->hasSubViewports() ? 1 : 0));
+    }
+
+    if (mRenderGraph.isCompiled() && state == mRenderGraphState)
+        return;
+
+    mRenderGraphState = state;
+    buildRenderGraph();
+    mRenderGraph.compile();
+    aliasTransientTextures();
+
+    unsigned int numberOfTransientTextures = 0;
+    for (std::size_t i = 0; i < mRenderGraph.getNumberOfResources(); i++)
+        if (mRenderGraph.getResource(i).slot != sgct_core::RenderGraph::NoSlot)
+            numberOfTransientTextures++;
+
+    MessageHandler::instance()->print(MessageHandler::NOTIFY_DEBUG, "Engine: Render graph planned with %u passes (%u culled), %u transient textures use %u textures.\n",
+        static_cast<unsigned int>(mRenderGraph.getOrder().size()),
+        static_cast<unsigned int>(mRenderGraph.getNumberOfPasses() - mRenderGraph.getOrder().size()),
+        numberOfTransientTextures,
+        static_cast<unsigned int>(mRenderGraph.getNumberOfSlots()));
+}
+
+/*!
+    Adds the passes that render a frame on this node to the render graph. Every window renders the cubemaps of its
+    non-linear viewports and then its viewports, once per eye, to its framebuffer textures which are then rendered to
+    the screen after all windows have been rendered. The post effect textures are transient as they are only used while
+    the window is rendered. Cubemaps of disabled viewports and the passes of windows that are neither visible nor rendered
+    while hidden are culled.
+*/
+void sgct::Engine::buildRenderGraph()
+{
+    mRenderGraph.clear();
+
+    bool useFBO = SGCTSettings::instance()->useFBO();
+    bool aliasing = useFBO && SGCTSettings::instance()->getUseTextureAliasing();
+    std::vector<std::size_t> leftTargets;
+    std::vector<std::size_t> rightTargets;
+    std::vector<std::size_t> windowDrawBufferIndices;
+    std::size_t drawBufferIndex = 0;
+
+    for (std::size_t i = 0; i < mThisNode->getNumberOfWindows(); i++)
+    {
+        SGCTWindow * win = getWindowPtr(i);
+        SGCTWindow::StereoMode sm = win->getStereoMode();
+        int x, y;
+        win->getFinalFBODimensions(x, y);
+        int format = static_cast<int>(win->getColorBitDepth());
+
+        //the output is used outside of the graph if the window is rendered directly to the back buffer or while hidden
+        bool sideEffect = (win->isVisible() && !useFBO) || (!win->isVisible() && win->isRenderingWhileHidden());
+
+        std::size_t left = mRenderGraph.addResource("leftEye", false, x, y, format, i, LeftEye);
+        //side-by-side and top-bottom stereo modes render both eyes to the left texture
+        std::size_t right = (sm != SGCTWindow::No_Stereo && sm < SGCTWindow::Side_By_Side_Stereo) ?
+            mRenderGraph.addResource("rightEye", false, x, y, format, i, RightEye) : left;
+
+        std::vector<std::size_t> transients;
+        if (useFBO && win->usePostFX())
+        {
+            unsigned int numberOfPoolBuffers = win->updatePostFXGraph().getNumberOfPoolBuffers();
+            transients.push_back(mRenderGraph.addResource("postFXSource", aliasing, x, y, format, i, Intermediate));
+            if (numberOfPoolBuffers > 0)
+                transients.push_back(mRenderGraph.addResource("postFXPool0", aliasing, x, y, format, i, FX1));
+            if (numberOfPoolBuffers > 1)
+                transients.push_back(mRenderGraph.addResource("postFXPool1", aliasing, x, y, format, i, FX2));
+        }
+
+        std::vector<std::size_t> cubemaps(win->getNumberOfViewports(), 0);
+        for (std::size_t j = 0; j < win->getNumberOfViewports(); j++)
+            if (win->getViewport(j)->hasSubViewports())
+            {
+                int cubeRes = win->getViewport(j)->getNonLinearProjectionPtr()->getCubemapResolution();
+                cubemaps[j] = mRenderGraph.addResource("cubemap", false, cubeRes, cubeRes, format, i, -1);
+            }
+
+        //every window and every non-linear projection has its own draw buffer index, the right eye uses the same ones
+        std::size_t firstDrawBufferIndexInWindow = drawBufferIndex;
+        std::size_t numberOfEyes = sm == SGCTWindow::No_Stereo ? 1 : 2;
+        for (std::size_t eye = 0; eye < numberOfEyes; eye++)
+        {
+            bool rightEye = eye == 1;
+            drawBufferIndex = firstDrawBufferIndexInWindow;
+
+            for (std::size_t j = 0; j < win->getNumberOfViewports(); j++)
+                if (win->getViewport(j)->hasSubViewports())
+                {
+                    std::size_t pass = mRenderGraph.addPass(sgct_core::RenderGraph::CubemapPass, i, j, rightEye, drawBufferIndex++, false);
+                    mRenderGraph.write(pass, cubemaps[j]);
+                }
+
+            std::size_t pass = mRenderGraph.addPass(sgct_core::RenderGraph::ViewportPass, i, 0, rightEye, drawBufferIndex++, sideEffect);
+            for (std::size_t j = 0; j < win->getNumberOfViewports(); j++)
+                if (win->getViewport(j)->hasSubViewports() && win->getViewport(j)->isEnabled() && win->getCallDraw3DFunction())
+                    mRenderGraph.read(pass, cubemaps[j]);
+
+            //the right eye of split screen stereo is rendered next to what the left eye rendered
+            std::size_t target = rightEye ? right : left;
+            if (rightEye && target == left)
+                mRenderGraph.read(pass, left);
+            mRenderGraph.write(pass, target);
+
+            for (std::size_t j = 0; j < transients.size(); j++)
+            {
+                mRenderGraph.read(pass, transients[j]);
+                mRenderGraph.write(pass, transients[j]);
+            }
+        }
+
+        leftTargets.push_back(left);
+        rightTargets.push_back(right);
+        windowDrawBufferIndices.push_back(drawBufferIndex - 1);
+    }
+
+    if (!useFBO)
+        return;
+
+    for (std::size_t i = 0; i < mThisNode->getNumberOfWindows(); i++)
+        if (getWindowPtr(i)->isVisible())
+        {
+            std::size_t pass = mRenderGraph.addPass(sgct_core::RenderGraph::ScreenPass, i, 0, false, windowDrawBufferIndices[i], true);
+            mRenderGraph.read(pass, leftTargets[i]);
+            if (rightTargets[i] != leftTargets[i])
+                mRenderGraph.read(pass, rightTargets[i]);
+            mRenderGraph.write(pass, mRenderGraph.addResource("backBuffer", false, 0, 0, 0, i, -1));
+        }
+}
+
+/*!
+    Lets the windows use the textures of the first window in each slot of the render graph. Textures that no longer share
+    a slot are released first so that the owners have textures of their own.
+*/
+void sgct::Engine::aliasTransientTextures()
+{
+    if (!SGCTSettings::instance()->useFBO())
+        return;
+
+    for (std::size_t i = 0; i < mThisNode->getNumberOfWindows(); i++)
+    {
+        getWindowPtr(i)->releaseFrameBufferTextureAlias(Intermediate);
+        getWindowPtr(i)->releaseFrameBufferTextureAlias(FX1);
+        getWindowPtr(i)->releaseFrameBufferTextureAlias(FX2);
+    }
+
+    for (std::size_t i = 0; i < mRenderGraph.getNumberOfResources(); i++)
+    {
+        const sgct_core::RenderGraph::Resource & res = mRenderGraph.getResource(i);
+        if (res.slot == sgct_core::RenderGraph::NoSlot || mRenderGraph.getSlotOwner(res.slot) == i)
+            continue;
+
+        const sgct_core::RenderGraph::Resource & owner = mRenderGraph.getResource(mRenderGraph.getSlotOwner(res.slot));
+        unsigned int texture = getWindowPtr(owner.window)->getFrameBufferTexture(owner.texture);
+        getWindowPtr(res.window)->setFrameBufferTextureAlias(res.texture, texture);
+
+        MessageHandler::instance()->print(MessageHandler::NOTIFY_DEBUG, "Engine: Window %u uses the %s texture of window %u.\n",
+            static_cast<unsigned int>(res.window), res.name.c_str(), static_cast<unsigned int>(owner.window));
+    }
+}
+
+/*!
+    Renders a pass planned by the render graph.
+*/
+void sgct::Engine::renderPass(const sgct_core::RenderGraph::Pass & pass)
+{
+    mThisNode->setCurrentWindowIndex(pass.window);
+    SGCTWindow * win = getCurrentWindowPtr();
+    SGCTWindow::StereoMode sm = win->getStereoMode();
+    mCurrentDrawBufferIndex = pass.drawBufferIndex;
+
+    if (pass.type == sgct_core::RenderGraph::ScreenPass)
+    {
+#ifdef __SGCT_RENDER_LOOP_DEBUG__
+        MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Render-Loop: Rendering FBO quad\n");
+#endif
+        FrameTrace::Scope scope("renderToScreen", "window", static_cast<int>(pass.window));
+        mRenderingOffScreen = false;
+        (this->*mInternalRenderFBOFn)();
+        return;
+    }
+
+    if( !mRenderingOffScreen )
+        win->makeOpenGLContextCurrent( SGCTWindow::Window_Context );
+
+    if (pass.type == sgct_core::RenderGraph::CubemapPass)
+    {
+#ifdef __SGCT_RENDER_LOOP_DEBUG__
+        MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Render-Loop: Rendering sub-viewports\n");
+#endif
+        FrameTrace::Scope cubemapScope("nonLinearCubemap", "viewport", static_cast<int>(pass.viewport));
+        mCurrentRenderTarget = NonLinearBuffer;
+        mCurrentViewportIndex[MainViewport] = pass.viewport;
+
+        sgct_core::NonLinearProjection * nonLinearProjPtr = win->getViewport(pass.viewport)->getNonLinearProjectionPtr();
+        mCurrentOffScreenBuffer = nonLinearProjPtr->getOffScreenBuffer();
+        nonLinearProjPtr->setAlpha(win->getAlpha() ? 0.0f : 1.0f);
+
+        if (pass.rightEye)
+            mCurrentFrustumMode = sgct_core::Frustum::StereoRightEye;
+        else if (sm == SGCTWindow::No_Stereo)
+            mCurrentFrustumMode = win->getViewport(pass.viewport)->getEye(); //for mono viewports frustum mode can be selected by user or xml
+        else
+            mCurrentFrustumMode = sgct_core::Frustum::StereoLeftEye;
+
+        nonLinearProjPtr->renderCubemap(&mCurrentViewportIndex[SubViewport]);
+    }
+    else
+    {
+#ifdef __SGCT_RENDER_LOOP_DEBUG__
+        MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Render-Loop: Rendering\n");
+#endif
+        FrameTrace::Scope windowScope("renderWindow", "window", static_cast<int>(pass.window));
+        mCurrentRenderTarget = WindowBuffer;
+        mCurrentOffScreenBuffer = win->getFBOPtr();
+
+        if (pass.rightEye)
+        {
+            mCurrentFrustumMode = sgct_core::Frustum::StereoRightEye;
+            //use a single texture for side-by-side and top-bottom stereo modes
+            sm >= SGCTWindow::Side_By_Side_Stereo ?
+                renderViewports(LeftEye) :
+                renderViewports(RightEye);
+        }
+        else
+        {
+            //if any stereo type (except passive) then set frustum mode to left eye
+            mCurrentFrustumMode = sm == SGCTWindow::No_Stereo ? sgct_core::Frustum::MonoEye : sgct_core::Frustum::StereoLeftEye;
+            renderViewports(LeftEye);
+        }
+    }
+}
+
 /*!
     Checks the keyboard if the specified key has been pressed.
     \param winIndex specifies which window to poll
@@ -4584,6 +5260,14 @@ std::size_t sgct::Engine::getNumberOfDrawBuffers()
     return mDrawBufferResolutions.size();
 }
 
+/*!
+\returns the scale of the windows' render resolution, which is below one when dynamic resolution scaling has lowered it
+*/
+float sgct::Engine::getResolutionScale()
+{
+    return mResolutionScale.getVal();
+}
+
 /*!
 \returns the active FBO buffer index.
 */
@@ -4600,6 +5284,19 @@ const sgct::Engine::RenderTarget & sgct::Engine::getCurrentRenderTarget()
     return mCurrentRenderTarget;
 }
 
+/*!
+Get if the draw callback renders all faces of a cube map in one layered pass (see SGCTSettings::setUseLayeredCubemapRendering).
+\returns true if the application should render to all enabled faces using the CubeFaces uniform block
+*/
+bool sgct::Engine::isRenderingLayeredCubemap()
+{
+    if (mCurrentRenderTarget != NonLinearBuffer)
+        return false;
+
+    sgct_core::Viewport* vp = getCurrentWindowPtr()->getViewport(mCurrentViewportIndex[MainViewport]);
+    return vp->hasSubViewports() && vp->getNonLinearProjectionPtr()->isLayered();
+}
+
 /*!
 \returns the active off screen buffer. If no buffer is active NULL is returned. 
 */
@@ -4620,6 +5317,47 @@ const int * sgct::Engine::getCurrentViewportPixelCoords()
         return mCurrentViewportCoords;
 }
 
+/*!
+Set up a culler with the frustum of the active viewport, eye and cube face (only valid inside in the draw callback function).
+\param culler the culler to set up
+\param useModelMatrix if true the scene transform is included so volumes are tested in model space, otherwise in world space
+*/
+void sgct::Engine::getCurrentFrustumCuller(FrustumCuller & culler, bool useModelMatrix)
+{
+    culler.setMatrix(useModelMatrix ? getCurrentModelViewProjectionMatrix() : getCurrentViewProjectionMatrix());
+}
+
+/*!
+Set up a culler with the union of the frustums of all enabled cube faces of the active non linear projection for the active eye
+(only valid inside in the draw callback function). The result can be reused for all cube faces so a scene only needs to be culled once per eye.
+If the active viewport is not a non linear projection this is the same as getCurrentFrustumCuller.
+\param culler the culler to set up
+\param useModelMatrix if true the scene transform is included so volumes are tested in model space, otherwise in world space
+*/
+void sgct::Engine::getCurrentCubemapFrustumCuller(FrustumCuller & culler, bool useModelMatrix)
+{
+    sgct_core::Viewport* vp = getCurrentWindowPtr()->getViewport(mCurrentViewportIndex[MainViewport]);
+    if (!vp->hasSubViewports())
+    {
+        getCurrentFrustumCuller(culler, useModelMatrix);
+        return;
+    }
+
+    const glm::mat4 & modelMatrix = sgct_core::ClusterManager::instance()->getSceneTransform();
+    sgct_core::NonLinearProjection * nonLinearProjPtr = vp->getNonLinearProjectionPtr();
+
+    culler.clear();
+    for (std::size_t side = 0; side < 6; side++)
+    {
+        sgct_core::BaseViewport * subVp = nonLinearProjPtr->getSubViewportPtr(side);
+        if (subVp->isEnabled())
+        {
+            const glm::mat4 & viewProjection = subVp->getProjection(mCurrentFrustumMode)->getViewProjectionMatrix();
+            culler.addMatrix(useModelMatrix ? viewProjection * modelMatrix : viewProjection);
+        }
+    }
+}
+
 /*!
 Get if wireframe rendering is enabled
 \returns true if wireframe is enabled otherwise false
@@ -4656,7 +5394,16 @@ void sgct::Engine::outputHelpMessage()
 {
     fprintf( stderr, "\nParameters:\n------------------------------------\n\
 \n-config <filename.xml>           \n\tSet xml confiuration file\n\
+\n--Ignore-Config-Cache            \n\tAlways parse the xml config instead of using\n\tthe compiled config cache\n\
+\n--Watch-Config                   \n\tReload the viewports on all nodes when the\n\tmaster's config file changes (set on the master)\n\
+\n-distributeConfig <directory>    \n\tReceive the node configuration and the files it\n\treferences from the master and cache the files\n\tin the directory (set on all nodes)\n\
 \n-logPath <filepath>              \n\tSet log file path\n\
+\n-trace <filepath>                \n\tRecord frame timings to a Chrome trace file\n\tin the given directory\n\
+\n-clusterStats <filename>         \n\tSave the frame statistics of all nodes on exit\n\t(master only, .csv for the history,\n\totherwise a json summary)\n\
+\n-trackingRecord <filename>       \n\tRecord all tracking reports to a binary file\n\t(master only)\n\
+\n-trackingReplay <filename>       \n\tReplay tracking data from a recording\n\tinstead of connecting to VRPN\n\
+\n--Tracking-Replay-Fast           \n\tReplay the tracking recording as fast as possible\n\
+\n--Tracking-Replay-Loop           \n\tRestart the tracking replay at the end of the recording\n\
 \n--help                           \n\tDisplay help message and exit\n\
 \n-local <integer>                 \n\tForce node in configuration to localhost\n\t(index starts at 0)\n\
 \n--client                         \n\tRun the application as client\n\t(only available when running as local)\n\
@@ -0,0 +1,1069 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#if !(_MSC_VER >= 1400) //if not visual studio 2005 or later
+    #define _WIN32_WINNT 0x501
+#endif
+
+#ifdef __WIN32__
+    #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+    #define SGCT_ERRNO WSAGetLastError()
+    #define SGCT_WOULD_BLOCK(err) ((err) == WSAEWOULDBLOCK)
+#else //Use BSD sockets
+    #include <sys/types.h>
+    #include <sys/socket.h>
+    #include <sys/select.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
+    #include <arpa/inet.h>
+    #include <netdb.h>
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #define SOCKET_ERROR (-1)
+    #define INVALID_SOCKET (SGCT_SOCKET)(~0)
+    #define SGCT_ERRNO errno
+    #define SGCT_WOULD_BLOCK(err) ((err) == EAGAIN || (err) == EWOULDBLOCK || (err) == EINTR)
+#endif
+
+#include <sgct/ExternalControlServer.h>
+#include <sgct/MessageHandler.h>
+#include <string.h>
+#include <ctype.h>
+#include <algorithm>
+
+#ifdef MSG_NOSIGNAL
+    #define SGCT_SEND_FLAGS MSG_NOSIGNAL //don't raise SIGPIPE when a client has gone
+#else
+    #define SGCT_SEND_FLAGS 0
+#endif
+
+//bytes read from a client each time it is ready so that one client can't starve the others
+#define EXTERNAL_CONTROL_READ_SIZE 65536
+//milliseconds between checks for messages queued by other threads and for shutdown
+#define EXTERNAL_CONTROL_POLL_INTERVAL 5
+//milliseconds to wait for a WebSocket handshake before a new client gets the greeting
+#define EXTERNAL_CONTROL_GREETING_DELAY 100
+
+const char sgct_core::ExternalControlServer::FrameStart;
+const std::size_t sgct_core::ExternalControlServer::FrameHeaderSize;
+
+namespace
+{
+    enum WebSocketOpcode { Continuation = 0x0, Text = 0x1, Binary = 0x2, Close = 0x8, Ping = 0x9, Pong = 0xA };
+    enum WebSocketStatus { NormalClosure = 1000, ProtocolError = 1002, MessageTooBig = 1009 };
+
+    const char WebSocketGUID[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+    uint32_t rotateLeft(uint32_t value, int bits)
+    {
+        return (value << bits) | (value >> (32 - bits));
+    }
+
+    //SHA-1 as used by the WebSocket handshake
+    void sha1(const std::string & message, unsigned char digest[20])
+    {
+        uint32_t h[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+
+        std::string data(message);
+        uint64_t bitLength = static_cast<uint64_t>(message.size()) * 8;
+        data += static_cast<char>(0x80);
+        while (data.size() % 64 != 56)
+            data += static_cast<char>(0);
+        for (int i = 7; i >= 0; i--)
+            data += static_cast<char>((bitLength >> (i * 8)) & 0xFF);
+
+        for (std::size_t chunk = 0; chunk < data.size(); chunk += 64)
+        {
+            uint32_t w[80];
+            for (int i = 0; i < 16; i++)
+            {
+                const unsigned char * p = reinterpret_cast<const unsigned char *>(&data[chunk + i * 4]);
+                w[i] = (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) | (static_cast<uint32_t>(p[2]) << 8) | p[3];
+            }
+            for (int i = 16; i < 80; i++)
+                w[i] = rotateLeft(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+            uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+            for (int i = 0; i < 80; i++)
+            {
+                uint32_t f, k;
+                if (i < 20)      { f = (b & c) | (~b & d); k = 0x5A827999; }
+                else if (i < 40) { f = b ^ c ^ d; k = 0x6ED9EBA1; }
+                else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+                else             { f = b ^ c ^ d; k = 0xCA62C1D6; }
+
+                uint32_t temp = rotateLeft(a, 5) + f + e + k + w[i];
+                e = d;
+                d = c;
+                c = rotateLeft(b, 30);
+                b = a;
+                a = temp;
+            }
+
+            h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+        }
+
+        for (int i = 0; i < 20; i++)
+            digest[i] = static_cast<unsigned char>((h[i / 4] >> (24 - (i % 4) * 8)) & 0xFF);
+    }
+
+    std::string base64(const unsigned char * data, std::size_t length)
+    {
+        const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string result;
+        for (std::size_t i = 0; i < length; i += 3)
+        {
+            uint32_t n = static_cast<uint32_t>(data[i]) << 16;
+            if (i + 1 < length) n |= static_cast<uint32_t>(data[i + 1]) << 8;
+            if (i + 2 < length) n |= data[i + 2];
+
+            result += table[(n >> 18) & 0x3F];
+            result += table[(n >> 12) & 0x3F];
+            result += i + 1 < length ? table[(n >> 6) & 0x3F] : '=';
+            result += i + 2 < length ? table[n & 0x3F] : '=';
+        }
+        return result;
+    }
+
+    //! \returns the value of a header field, the name is compared case insensitively
+    bool getHeaderField(const std::string & request, const std::string & name, std::string & value)
+    {
+        std::size_t lineStart = request.find("\r\n");
+        while (lineStart != std::string::npos)
+        {
+            lineStart += 2;
+            std::size_t lineEnd = request.find("\r\n", lineStart);
+            if (lineEnd == std::string::npos)
+                lineEnd = request.size();
+
+            std::size_t colon = request.find(':', lineStart);
+            if (colon != std::string::npos && colon < lineEnd && colon - lineStart == name.size())
+            {
+                bool match = true;
+                for (std::size_t i = 0; i < name.size() && match; i++)
+                    match = tolower(static_cast<unsigned char>(request[lineStart + i])) == tolower(static_cast<unsigned char>(name[i]));
+
+                if (match)
+                {
+                    std::size_t valueStart = request.find_first_not_of(" \t", colon + 1);
+                    std::size_t valueEnd = request.find_last_not_of(" \t", lineEnd - 1);
+                    value = valueStart != std::string::npos && valueStart <= valueEnd && valueEnd < lineEnd ?
+                        request.substr(valueStart, valueEnd - valueStart + 1) : std::string();
+                    return true;
+                }
+            }
+
+            lineStart = lineEnd < request.size() ? lineEnd : std::string::npos;
+        }
+        return false;
+    }
+
+    //! \returns true if a comma separated header value contains the token, compared case insensitively
+    bool hasToken(const std::string & value, const char * token)
+    {
+        std::string lower(value);
+        std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+        std::size_t tokenLength = strlen(token);
+
+        for (std::size_t pos = lower.find(token); pos != std::string::npos; pos = lower.find(token, pos + 1))
+        {
+            bool start = pos == 0 || lower[pos - 1] == ',' || lower[pos - 1] == ' ';
+            bool end = pos + tokenLength == lower.size() || lower[pos + tokenLength] == ',' || lower[pos + tokenLength] == ' ';
+            if (start && end)
+                return true;
+        }
+        return false;
+    }
+}
+
+sgct_core::ExternalControlServer::ExternalControlServer()
+{
+    mDecoderCallbackFn = SGCT_NULL_PTR;
+    mUpdateCallbackFn = SGCT_NULL_PTR;
+
+    mListenSocket = INVALID_SOCKET;
+    mThread = NULL;
+    mTerminate = false;
+    mNumberOfClients = 0;
+    mMaxClients = 16;
+    mMaxMessageSize = 1024 * 1024;
+    mMaxQueuedSize = 1024 * 1024;
+    mNextId = 0;
+}
+
+sgct_core::ExternalControlServer::~ExternalControlServer()
+{
+    close();
+}
+
+/*!
+Starts listening for clients. The network API must be initialized.
+@param    port    The port to listen on
+\returns true if the server is listening
+*/
+bool sgct_core::ExternalControlServer::init(const std::string & port)
+{
+    mPort = port;
+
+    struct addrinfo *result = NULL, hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+    hints.ai_flags = AI_PASSIVE;
+
+    if (getaddrinfo(NULL, port.c_str(), &hints, &result) != 0)
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ExternalControlServer: Failed to parse hints for port %s.\n", port.c_str());
+        return false;
+    }
+
+    mListenSocket = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+    bool success = mListenSocket != INVALID_SOCKET;
+
+    if (success)
+    {
+        int flag = 1;
+        setsockopt(mListenSocket, SOL_SOCKET, SO_REUSEADDR, (char*)&flag, sizeof(int));
+
+        success = bind(mListenSocket, result->ai_addr, (int)result->ai_addrlen) != SOCKET_ERROR &&
+            listen(mListenSocket, SOMAXCONN) != SOCKET_ERROR &&
+            setNonBlocking(mListenSocket);
+    }
+
+    freeaddrinfo(result);
+
+    if (!success)
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ExternalControlServer: Failed to listen on port %s! Error: %d\n", port.c_str(), SGCT_ERRNO);
+        closeSocket(mListenSocket);
+        mListenSocket = INVALID_SOCKET;
+        return false;
+    }
+
+    mTerminate = false;
+    mThread = new (std::nothrow) std::thread(&sgct_core::ExternalControlServer::run, this);
+    if (mThread == NULL)
+    {
+        closeSocket(mListenSocket);
+        mListenSocket = INVALID_SOCKET;
+        return false;
+    }
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "ExternalControlServer: Listening for up to %u clients on port %s.\n", mMaxClients, port.c_str());
+    return true;
+}
+
+/*!
+Stops the server thread and disconnects all clients.
+*/
+void sgct_core::ExternalControlServer::close()
+{
+    mTerminate = true;
+    if (mThread != NULL)
+    {
+        mThread->join();
+        delete mThread;
+        mThread = NULL;
+    }
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    for (std::size_t i = 0; i < mClients.size(); i++)
+    {
+        closeSocket(mClients[i]->socket);
+        delete mClients[i];
+    }
+    mClients.clear();
+    mNumberOfClients = 0;
+    lock.unlock();
+
+    closeSocket(mListenSocket);
+    mListenSocket = INVALID_SOCKET;
+}
+
+/*!
+Set the function that is called on the server thread for every received message. The arguments are the message,
+its length and the id of the client. ASCII lines are null terminated without the line break.
+*/
+void sgct_core::ExternalControlServer::setDecodeFunction(sgct_cppxeleven::function<void (const char *, int, int)> callback)
+{
+    mDecoderCallbackFn = callback;
+}
+
+/*!
+Set the function that is called on the server thread when a client connects or disconnects. The argument is true if
+any client is connected.
+*/
+void sgct_core::ExternalControlServer::setUpdateFunction(sgct_cppxeleven::function<void (bool)> callback)
+{
+    mUpdateCallbackFn = callback;
+}
+
+/*!
+Set the number of clients that can be connected at the same time, further clients wait until one disconnects.
+Must be set before init.
+*/
+void sgct_core::ExternalControlServer::setMaxClients(unsigned int count)
+{
+    mMaxClients = count > 0 ? count : 1;
+}
+
+/*!
+Set the largest message in bytes, a client that sends a longer line or frame is disconnected.
+*/
+void sgct_core::ExternalControlServer::setMaxMessageSize(uint32_t size)
+{
+    mMaxMessageSize = size;
+}
+
+/*!
+Set the number of bytes that can be queued for a client before it isn't read from anymore. A client with four times
+as many queued bytes is disconnected.
+*/
+void sgct_core::ExternalControlServer::setMaxQueuedSize(uint32_t size)
+{
+    mMaxQueuedSize = size;
+}
+
+/*!
+Sends data to all connected clients. The data is queued if it can't be sent right away.
+*/
+void sgct_core::ExternalControlServer::sendData(const void * data, int length)
+{
+    if (length <= 0)
+        return;
+
+    //clients that haven't been identified may still be doing a WebSocket handshake
+    std::unique_lock<std::mutex> lock(mMutex);
+    for (std::size_t i = 0; i < mClients.size(); i++)
+        if (mClients[i]->identified && !mClients[i]->closing)
+        {
+            queueMessage(mClients[i], reinterpret_cast<const char *>(data), static_cast<std::size_t>(length));
+            flush(mClients[i]);
+        }
+}
+
+/*!
+Sends data to one client. The data is queued if it can't be sent right away.
+\returns false if the client isn't connected
+*/
+bool sgct_core::ExternalControlServer::sendData(int clientId, const void * data, int length)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    for (std::size_t i = 0; i < mClients.size(); i++)
+        if (mClients[i]->id == clientId && mClients[i]->identified && !mClients[i]->closing)
+        {
+            if (length > 0)
+            {
+                queueMessage(mClients[i], reinterpret_cast<const char *>(data), static_cast<std::size_t>(length));
+                flush(mClients[i]);
+            }
+            return true;
+        }
+
+    return false;
+}
+
+//! \returns the number of connected clients
+unsigned int sgct_core::ExternalControlServer::getNumberOfClients()
+{
+    return mNumberOfClients;
+}
+
+//! \returns true if any client is connected
+bool sgct_core::ExternalControlServer::isConnected()
+{
+    return mNumberOfClients > 0;
+}
+
+void sgct_core::ExternalControlServer::run()
+{
+    while (!mTerminate)
+    {
+        fd_set readSet;
+        fd_set writeSet;
+        FD_ZERO(&readSet);
+        FD_ZERO(&writeSet);
+        SGCT_SOCKET maxSocket = 0;
+
+        if (mClients.size() < mMaxClients)
+        {
+            FD_SET(mListenSocket, &readSet);
+            maxSocket = mListenSocket;
+        }
+
+        std::unique_lock<std::mutex> lock(mMutex);
+        for (std::size_t i = 0; i < mClients.size(); i++)
+        {
+            Client * client = mClients[i];
+            if (!client->paused)
+                FD_SET(client->socket, &readSet);
+            if (client->outputOffset < client->output.size())
+                FD_SET(client->socket, &writeSet);
+            if (client->socket > maxSocket)
+                maxSocket = client->socket;
+        }
+        lock.unlock();
+
+        //the timeout lets messages queued by other threads be flushed and shutdown be noticed
+        struct timeval timeout;
+        timeout.tv_sec = 0;
+        timeout.tv_usec = EXTERNAL_CONTROL_POLL_INTERVAL * 1000;
+
+        int ready = select(static_cast<int>(maxSocket) + 1, &readSet, &writeSet, NULL, &timeout);
+        if (ready == SOCKET_ERROR)
+        {
+            int err = SGCT_ERRNO;
+            if (!SGCT_WOULD_BLOCK(err))
+                sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ExternalControlServer: Select failed! Error: %d\n", err);
+            continue;
+        }
+
+        if (ready > 0 && FD_ISSET(mListenSocket, &readSet))
+            acceptClients();
+
+        //clients that haven't sent anything get the greeting, browsers would have started the handshake
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < mClients.size(); i++)
+            if (!mClients[i]->identified && mClients[i]->input.empty() && now >= mClients[i]->greetingTime)
+            {
+                lock.lock();
+                identify(mClients[i]);
+                flush(mClients[i]);
+                lock.unlock();
+            }
+
+        if (ready > 0)
+        {
+            //only this thread adds and removes clients so they can be iterated without the lock
+            for (std::size_t i = 0; i < mClients.size(); i++)
+            {
+                Client * client = mClients[i];
+                if (FD_ISSET(client->socket, &readSet) && !readClient(client))
+                    client->closing = true;
+
+                if (FD_ISSET(client->socket, &writeSet))
+                {
+                    lock.lock();
+                    flush(client);
+                    lock.unlock();
+                }
+            }
+        }
+
+        removeClosedClients();
+    }
+}
+
+void sgct_core::ExternalControlServer::acceptClients()
+{
+    while (mClients.size() < mMaxClients)
+    {
+        SGCT_SOCKET s = accept(mListenSocket, NULL, NULL);
+        if (s == INVALID_SOCKET)
+            break;
+
+        int flag = 1;
+        setsockopt(s, IPPROTO_TCP, TCP_NODELAY, (char *)&flag, sizeof(int));
+#if defined(SO_NOSIGPIPE)
+        setsockopt(s, SOL_SOCKET, SO_NOSIGPIPE, (char *)&flag, sizeof(int));
+#endif
+        if (!setNonBlocking(s))
+        {
+            closeSocket(s);
+            continue;
+        }
+
+        Client * client = new Client();
+        client->socket = s;
+        client->id = mNextId++;
+        client->identified = false;
+        client->greetingTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(EXTERNAL_CONTROL_GREETING_DELAY);
+        client->binary = false;
+        client->webSocket = false;
+        client->webSocketText = true;
+        client->fragmentOpcode = 0;
+        client->paused = false;
+        client->closing = false;
+        client->scanOffset = 0;
+        client->outputOffset = 0;
+
+        std::unique_lock<std::mutex> lock(mMutex);
+        mClients.push_back(client);
+        mNumberOfClients = static_cast<unsigned int>(mClients.size());
+        lock.unlock();
+
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "ExternalControlServer: Client %d connected (%u connected).\n", client->id, mNumberOfClients.load());
+
+        if (mUpdateCallbackFn != SGCT_NULL_PTR)
+            mUpdateCallbackFn(true);
+    }
+}
+
+/*!
+\returns false if the client has disconnected
+*/
+bool sgct_core::ExternalControlServer::readClient(Client * client)
+{
+    std::size_t size = client->input.size();
+    client->input.resize(size + EXTERNAL_CONTROL_READ_SIZE);
+
+    _ssize_t iResult = recv(client->socket, &client->input[size], EXTERNAL_CONTROL_READ_SIZE, 0);
+    if (iResult == SOCKET_ERROR)
+    {
+        client->input.resize(size);
+        return SGCT_WOULD_BLOCK(SGCT_ERRNO);
+    }
+
+    client->input.resize(size + static_cast<std::size_t>(iResult));
+    if (iResult == 0)
+        return false;
+
+    parseInput(client);
+    return true;
+}
+
+/*!
+Extracts all complete messages and removes them from the input.
+*/
+void sgct_core::ExternalControlServer::parseInput(Client * client)
+{
+    std::vector<char> & input = client->input;
+    std::size_t pos = 0;
+
+    if (!client->identified)
+    {
+        //browsers start with the handshake, anything else is a stream client that gets the greeting first
+        const char get[] = "GET ";
+        std::size_t compared = std::min(input.size(), sizeof(get) - 1);
+        bool handshake = strncmp(&input[0], get, compared) == 0;
+
+        if (handshake && !parseHandshake(client, pos))
+            return;
+
+        std::unique_lock<std::mutex> lock(mMutex);
+        if (!handshake)
+            identify(client);
+        else
+            client->identified = true;
+    }
+
+    if (!client->closing)
+        pos = client->webSocket ? parseWebSocket(client, pos) : parseStream(client, pos);
+
+    input.erase(input.begin(), input.begin() + pos);
+    client->scanOffset = client->scanOffset > pos ? client->scanOffset - pos : 0;
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    flush(client);
+}
+
+/*!
+Extracts ASCII lines and binary frames. Only the bytes received since the last call are scanned for line breaks.
+@param    pos    Offset of the first message in the input
+\returns the offset after the last complete message
+*/
+std::size_t sgct_core::ExternalControlServer::parseStream(Client * client, std::size_t pos)
+{
+    std::vector<char> & input = client->input;
+
+    while (pos < input.size() && !client->closing)
+    {
+        if (input[pos] == FrameStart)
+        {
+            if (input.size() - pos < FrameHeaderSize)
+                break;
+
+            const unsigned char * header = reinterpret_cast<const unsigned char *>(&input[pos + 1]);
+            uint32_t length = (static_cast<uint32_t>(header[0]) << 24) | (static_cast<uint32_t>(header[1]) << 16) |
+                (static_cast<uint32_t>(header[2]) << 8) | static_cast<uint32_t>(header[3]);
+
+            if (length > mMaxMessageSize)
+            {
+                sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "ExternalControlServer: Frame of %u bytes from client %d is too large, disconnecting.\n", length, client->id);
+                client->closing = true;
+                break;
+            }
+
+            if (input.size() - pos - FrameHeaderSize < length)
+                break;
+
+            client->binary = true;
+            dispatch(client, length > 0 ? &input[pos + FrameHeaderSize] : NULL, length, false);
+            pos += FrameHeaderSize + length;
+            client->scanOffset = pos;
+        }
+        else
+        {
+            std::size_t start = std::max(pos, client->scanOffset);
+            const char * begin = &input[0] + start;
+            const char * end = &input[0] + input.size();
+            const char * lineBreak = std::find(begin, end, '\n');
+
+            if (std::find(begin, lineBreak, 24) != lineBreak || std::find(begin, lineBreak, 27) != lineBreak) //cancel or escape
+            {
+                client->closing = true;
+                break;
+            }
+
+            if (lineBreak == end)
+            {
+                client->scanOffset = input.size();
+                if (input.size() - pos > mMaxMessageSize)
+                {
+                    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "ExternalControlServer: Line from client %d is too long, disconnecting.\n", client->id);
+                    client->closing = true;
+                }
+                break;
+            }
+
+            std::size_t lineEnd = static_cast<std::size_t>(lineBreak - &input[0]);
+            std::size_t next = lineEnd + 1;
+            if (lineEnd > pos && input[lineEnd - 1] == '\r')
+                lineEnd--;
+
+            if (isCloseCommand(&input[pos], lineEnd - pos))
+            {
+                client->closing = true;
+                break;
+            }
+
+            //pass the line null terminated in place of the line break
+            input[lineEnd] = '\0';
+            dispatch(client, &input[pos], lineEnd - pos, false);
+
+            std::unique_lock<std::mutex> lock(mMutex);
+            queue(client, "OK\r\n", 4);
+            lock.unlock();
+
+            pos = next;
+            client->scanOffset = pos;
+        }
+    }
+
+    return pos;
+}
+
+/*!
+Answers a WebSocket opening handshake once the whole request has been received.
+@param    pos    Set to the end of the request
+\returns false if the request isn't complete yet
+*/
+bool sgct_core::ExternalControlServer::parseHandshake(Client * client, std::size_t & pos)
+{
+    std::vector<char> & input = client->input;
+
+    //only the new bytes and the three before them can complete the end of the request
+    const char requestEnd[] = "\r\n\r\n";
+    std::size_t start = client->scanOffset > 3 ? client->scanOffset - 3 : 0;
+    std::vector<char>::iterator found = std::search(input.begin() + start, input.end(), requestEnd, requestEnd + 4);
+    if (found == input.end())
+    {
+        client->scanOffset = input.size();
+        if (input.size() > mMaxMessageSize)
+            client->closing = true;
+        return false;
+    }
+
+    pos = static_cast<std::size_t>(found - input.begin()) + 4;
+    client->scanOffset = pos;
+    std::string request(input.begin(), input.begin() + pos);
+
+    std::string upgrade;
+    std::string connection;
+    std::string key;
+    std::string version;
+    bool valid = getHeaderField(request, "Upgrade", upgrade) && hasToken(upgrade, "websocket") &&
+        getHeaderField(request, "Connection", connection) && hasToken(connection, "upgrade") &&
+        getHeaderField(request, "Sec-WebSocket-Key", key) && !key.empty();
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (!valid)
+    {
+        const char response[] = "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        queue(client, response, sizeof(response) - 1);
+        client->closing = true;
+        lock.unlock();
+
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "ExternalControlServer: Client %d sent an HTTP request that isn't a WebSocket upgrade.\n", client->id);
+        return true;
+    }
+
+    unsigned char digest[20];
+    sha1(key + WebSocketGUID, digest);
+
+    std::string response("HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Accept: ");
+    response += base64(digest, sizeof(digest));
+    response += "\r\n\r\n";
+    queue(client, response.c_str(), response.size());
+    client->webSocket = true;
+    lock.unlock();
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "ExternalControlServer: Client %d upgraded to WebSocket.\n", client->id);
+    return true;
+}
+
+/*!
+Extracts WebSocket frames. Frames are unmasked in the receive buffer and unfragmented messages are passed to the
+callback from there.
+@param    pos    Offset of the first frame in the input
+\returns the offset after the last complete frame
+*/
+std::size_t sgct_core::ExternalControlServer::parseWebSocket(Client * client, std::size_t pos)
+{
+    std::vector<char> & input = client->input;
+
+    while (input.size() - pos >= 2 && !client->closing)
+    {
+        const unsigned char * header = reinterpret_cast<const unsigned char *>(&input[pos]);
+        bool fin = (header[0] & 0x80) != 0;
+        unsigned char opcode = header[0] & 0x0F;
+        bool masked = (header[1] & 0x80) != 0;
+        uint64_t length = header[1] & 0x7F;
+
+        std::size_t headerSize = 2;
+        if (length == 126)
+            headerSize += 2;
+        else if (length == 127)
+            headerSize += 8;
+        headerSize += 4; //clients must mask their frames
+
+        if (input.size() - pos < headerSize)
+            break;
+
+        if (length == 126)
+            length = (static_cast<uint64_t>(header[2]) << 8) | header[3];
+        else if (length == 127)
+        {
+            length = 0;
+            for (int i = 0; i < 8; i++)
+                length = (length << 8) | header[2 + i];
+        }
+
+        if ((header[0] & 0x70) != 0 || !masked)
+        {
+            closeWebSocket(client, ProtocolError);
+            break;
+        }
+
+        bool control = (opcode & 0x08) != 0;
+        if (control && (!fin || length > 125))
+        {
+            closeWebSocket(client, ProtocolError);
+            break;
+        }
+
+        uint64_t messageSize = length + (opcode == Continuation ? client->fragments.size() : 0);
+        if (messageSize > mMaxMessageSize)
+        {
+            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "ExternalControlServer: WebSocket message from client %d is too large, disconnecting.\n", client->id);
+            closeWebSocket(client, MessageTooBig);
+            break;
+        }
+
+        if (input.size() - pos - headerSize < length)
+            break;
+
+        const unsigned char * mask = header + headerSize - 4;
+        char * payload = &input[pos + headerSize];
+        std::size_t payloadSize = static_cast<std::size_t>(length);
+        for (std::size_t i = 0; i < payloadSize; i++)
+            payload[i] ^= mask[i & 3];
+
+        pos += headerSize + payloadSize;
+
+        switch (opcode)
+        {
+        case Text:
+        case Binary:
+            if (client->fragmentOpcode != 0)
+            {
+                closeWebSocket(client, ProtocolError);
+                break;
+            }
+
+            client->webSocketText = opcode == Text;
+            if (fin)
+                dispatch(client, payload, payloadSize, opcode == Text);
+            else
+            {
+                client->fragmentOpcode = opcode;
+                client->fragments.assign(payload, payload + payloadSize);
+            }
+            break;
+
+        case Continuation:
+            if (client->fragmentOpcode == 0)
+            {
+                closeWebSocket(client, ProtocolError);
+                break;
+            }
+
+            client->fragments.insert(client->fragments.end(), payload, payload + payloadSize);
+            if (fin)
+            {
+                bool text = client->fragmentOpcode == Text;
+                if (text)
+                    client->fragments.push_back('\0');
+                dispatch(client, client->fragments.empty() ? NULL : &client->fragments[0], client->fragments.size() - (text ? 1 : 0), false);
+                client->fragments.clear();
+                client->fragmentOpcode = 0;
+            }
+            break;
+
+        case Ping:
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                queueWebSocketFrame(client, Pong, payload, payloadSize);
+            }
+            break;
+
+        case Pong:
+            break;
+
+        case Close:
+            {
+                //echo the status code and close
+                std::unique_lock<std::mutex> lock(mMutex);
+                queueWebSocketFrame(client, Close, payload, payloadSize >= 2 ? 2 : 0);
+                client->closing = true;
+            }
+            break;
+
+        default:
+            closeWebSocket(client, ProtocolError);
+            break;
+        }
+    }
+
+    return pos;
+}
+
+void sgct_core::ExternalControlServer::closeWebSocket(Client * client, unsigned short code)
+{
+    char status[2] = { static_cast<char>((code >> 8) & 0xFF), static_cast<char>(code & 0xFF) };
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    queueWebSocketFrame(client, Close, status, 2);
+    client->closing = true;
+}
+
+/*!
+Marks a client that isn't using WebSockets as identified and sends the greeting. Must be called with the mutex locked.
+*/
+void sgct_core::ExternalControlServer::identify(Client * client)
+{
+    const char greeting[] = "Connected to SGCT!\r\n";
+    queue(client, greeting, sizeof(greeting) - 1);
+    client->identified = true;
+}
+
+/*!
+Passes a message to the callback.
+@param    nullTerminate    Temporarily null terminates the message in the receive buffer, used for WebSocket text
+*/
+void sgct_core::ExternalControlServer::dispatch(Client * client, const char * data, std::size_t length, bool nullTerminate)
+{
+    if (mDecoderCallbackFn == SGCT_NULL_PTR || length == 0)
+        return;
+
+    if (!nullTerminate)
+    {
+        mDecoderCallbackFn(data, static_cast<int>(length), client->id);
+        return;
+    }
+
+    //the byte after the payload belongs to the next frame, or is past the end of the received data
+    std::vector<char> & input = client->input;
+    std::size_t offset = static_cast<std::size_t>(data - &input[0]);
+    if (offset + length < input.size())
+    {
+        char next = input[offset + length];
+        input[offset + length] = '\0';
+        mDecoderCallbackFn(&input[offset], static_cast<int>(length), client->id);
+        input[offset + length] = next;
+    }
+    else
+    {
+        input.push_back('\0');
+        mDecoderCallbackFn(&input[offset], static_cast<int>(length), client->id);
+        input.pop_back();
+    }
+}
+
+/*!
+Appends data to the output of a client. Must be called with the mutex locked.
+*/
+void sgct_core::ExternalControlServer::queue(Client * client, const char * data, std::size_t length)
+{
+    client->output.insert(client->output.end(), data, data + length);
+}
+
+/*!
+Appends a message to the output of a client, framed the way the client sends its messages. Must be called with the mutex locked.
+*/
+void sgct_core::ExternalControlServer::queueMessage(Client * client, const char * data, std::size_t length)
+{
+    if (client->webSocket)
+        queueWebSocketFrame(client, client->webSocketText ? Text : Binary, data, length);
+    else if (client->binary)
+    {
+        char header[FrameHeaderSize];
+        header[0] = FrameStart;
+        header[1] = static_cast<char>((length >> 24) & 0xFF);
+        header[2] = static_cast<char>((length >> 16) & 0xFF);
+        header[3] = static_cast<char>((length >> 8) & 0xFF);
+        header[4] = static_cast<char>(length & 0xFF);
+        queue(client, header, FrameHeaderSize);
+        queue(client, data, length);
+    }
+    else
+        queue(client, data, length);
+}
+
+/*!
+Appends an unmasked WebSocket frame to the output of a client. Must be called with the mutex locked.
+*/
+void sgct_core::ExternalControlServer::queueWebSocketFrame(Client * client, unsigned char opcode, const char * data, std::size_t length)
+{
+    char header[10];
+    std::size_t headerSize = 2;
+    header[0] = static_cast<char>(0x80 | opcode);
+    if (length < 126)
+        header[1] = static_cast<char>(length);
+    else if (length <= 0xFFFF)
+    {
+        header[1] = 126;
+        header[2] = static_cast<char>((length >> 8) & 0xFF);
+        header[3] = static_cast<char>(length & 0xFF);
+        headerSize = 4;
+    }
+    else
+    {
+        header[1] = 127;
+        uint64_t length64 = static_cast<uint64_t>(length);
+        for (int i = 0; i < 8; i++)
+            header[2 + i] = static_cast<char>((length64 >> (56 - i * 8)) & 0xFF);
+        headerSize = 10;
+    }
+
+    queue(client, header, headerSize);
+    queue(client, data, length);
+}
+
+/*!
+Sends as much of the output as the socket accepts and updates the backpressure state. Must be called with the mutex locked.
+*/
+void sgct_core::ExternalControlServer::flush(Client * client)
+{
+    while (client->outputOffset < client->output.size())
+    {
+        _ssize_t sent = send(client->socket, &client->output[client->outputOffset],
+            static_cast<int>(client->output.size() - client->outputOffset), SGCT_SEND_FLAGS);
+
+        if (sent == SOCKET_ERROR)
+        {
+            if (!SGCT_WOULD_BLOCK(SGCT_ERRNO))
+                client->closing = true;
+            break;
+        }
+        client->outputOffset += static_cast<std::size_t>(sent);
+    }
+
+    //drop the sent bytes once they are a large part of the buffer so that appending stays cheap
+    if (client->outputOffset == client->output.size())
+    {
+        client->output.clear();
+        client->outputOffset = 0;
+    }
+    else if (client->outputOffset > client->output.size() / 2)
+    {
+        client->output.erase(client->output.begin(), client->output.begin() + client->outputOffset);
+        client->outputOffset = 0;
+    }
+
+    std::size_t queued = client->output.size() - client->outputOffset;
+    if (queued > static_cast<std::size_t>(mMaxQueuedSize) * 4)
+        client->closing = true;
+    else if (queued > mMaxQueuedSize)
+        client->paused = true;
+    else if (queued <= mMaxQueuedSize / 2)
+        client->paused = false;
+}
+
+void sgct_core::ExternalControlServer::removeClosedClients()
+{
+    std::vector<Client *> closed;
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    for (std::size_t i = 0; i < mClients.size(); )
+        if (mClients[i]->closing)
+        {
+            closed.push_back(mClients[i]);
+            mClients.erase(mClients.begin() + i);
+        }
+        else
+            i++;
+    mNumberOfClients = static_cast<unsigned int>(mClients.size());
+    lock.unlock();
+
+    for (std::size_t i = 0; i < closed.size(); i++)
+    {
+        std::size_t queued = closed[i]->output.size() - closed[i]->outputOffset;
+        if (queued > static_cast<std::size_t>(mMaxQueuedSize) * 4)
+            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "ExternalControlServer: Client %d doesn't read its messages (%u bytes queued), disconnecting.\n",
+                closed[i]->id, static_cast<unsigned int>(queued));
+
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "ExternalControlServer: Client %d disconnected (%u connected).\n", closed[i]->id, mNumberOfClients.load());
+
+        closeSocket(closed[i]->socket);
+        delete closed[i];
+
+        if (mUpdateCallbackFn != SGCT_NULL_PTR)
+            mUpdateCallbackFn(isConnected());
+    }
+}
+
+bool sgct_core::ExternalControlServer::isCloseCommand(const char * line, std::size_t length)
+{
+    const char * commands[] = { "logout", "close", "exit", "quit" };
+    for (std::size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++)
+        if (length == strlen(commands[i]) && strncmp(line, commands[i], length) == 0)
+            return true;
+    return false;
+}
+
+bool sgct_core::ExternalControlServer::setNonBlocking(SGCT_SOCKET s)
+{
+#ifdef __WIN32__
+    u_long mode = 1;
+    return ioctlsocket(s, FIONBIO, &mode) == 0;
+#else
+    int flags = fcntl(s, F_GETFL, 0);
+    return flags != -1 && fcntl(s, F_SETFL, flags | O_NONBLOCK) != -1;
+#endif
+}
+
+void sgct_core::ExternalControlServer::closeSocket(SGCT_SOCKET s)
+{
+    if (s == INVALID_SOCKET)
+        return;
+
+#ifdef __WIN32__
+    shutdown(s, SD_BOTH);
+    closesocket(s);
+#else
+    shutdown(s, SHUT_RDWR);
+    ::close(s);
+#endif
+}
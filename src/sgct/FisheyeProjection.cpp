@@ -9,6 +9,7 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <sgct/SGCTSettings.h>
 #include <sgct/Engine.h>
 #include <sgct/MessageHandler.h>
+#include <sgct/FrameTrace.h>
 #include <sgct/shaders/SGCTInternalFisheyeShaders.h>
 #include <sgct/shaders/SGCTInternalFisheyeShaders_modern.h>
 #include <sgct/shaders/SGCTInternalFisheyeShaders_cubic.h>
@@ -42,6 +43,10 @@ sgct_core::FisheyeProjection::FisheyeProjection()
 
     mOffAxis = false;
     mIgnoreAspectRatio = false;
+    mAdaptiveFaces = false;
+    mCoverageValid = false;
+    mFixedCoverageOffsets = 0;
+    mNextCoverageOffset = 0;
     mMethod = FourFaceCube;
 
     mCubemapLoc = -1;
@@ -86,7 +91,11 @@ void sgct_core::FisheyeProjection::renderCubemap(std::size_t * subViewPortIndex)
         setOffset(-sgct::Engine::instance()->getDefaultUserPtr()->getEyeSeparation() / mDiameter, 0.0f);
     else if (sgct::Engine::instance()->getCurrentFrustumMode() == Frustum::StereoRightEye)
         setOffset(sgct::Engine::instance()->getDefaultUserPtr()->getEyeSeparation() / mDiameter, 0.0f);
-    (this->*mInternalRenderCubemapFn)(subViewPortIndex);
+
+    if (mLayered)
+        renderLayeredCubemap(subViewPortIndex);
+    else
+        (this->*mInternalRenderCubemapFn)(subViewPortIndex);
 }
 
 /*!
@@ -150,9 +159,7 @@ Base of fisheye is the XY-plane. This function is normally used in fisheye stere
 void sgct_core::FisheyeProjection::setOffset(const glm::vec3 & offset)
 {
     mOffset = offset;
-    mTotalOffset = mBaseOffset + mOffset;
-
-    mOffAxis = (glm::length(mTotalOffset) > 0.0f ? true : false);
+    updateOffset();
 }
 
 /*!
@@ -164,9 +171,7 @@ void sgct_core::FisheyeProjection::setOffset(float x, float y, float z)
     mOffset.x = x;
     mOffset.y = y;
     mOffset.z = z;
-
-    mTotalOffset = mBaseOffset + mOffset;
-    mOffAxis = (glm::length(mTotalOffset) > 0.0f ? true : false);
+    updateOffset();
 }
 
 /*!
@@ -177,9 +182,7 @@ These values are set from the XML config.
 void sgct_core::FisheyeProjection::setBaseOffset(const glm::vec3 & offset)
 {
     mBaseOffset = offset;
-    mTotalOffset = mBaseOffset + mOffset;
-
-    mOffAxis = (glm::length(mTotalOffset) > 0.0f ? true : false);
+    updateOffset();
 }
 
 /*!
@@ -190,6 +193,16 @@ void sgct_core::FisheyeProjection::setIgnoreAspectRatio(bool state)
     mIgnoreAspectRatio = state;
 }
 
+/*!
+Only render the parts of the cube faces that are used by the fisheye. Faces that are not used at all
+(for example when the fisheye is cropped) are skipped and the viewports of partially used faces are
+shrunk to the used area. Must be set before the projection is initialized.
+*/
+void sgct_core::FisheyeProjection::setUseAdaptiveFaces(bool state)
+{
+    mAdaptiveFaces = state;
+}
+
 /*!
 Get the lens offset for off-axis projection.
 
@@ -392,6 +405,248 @@ void sgct_core::FisheyeProjection::initViewports()
             mSubViewports[i].getProjectionPlane()->setCoordinate(sgct_core::SGCTProjectionPlane::UpperRight, glm::vec3(rotMat * upperRight));
         }//end for
     }//end if
+
+    storeFaceLayout();
+
+    if (mAdaptiveFaces)
+    {
+        //the stereo eye offsets are known in advance so include them directly
+        mCoverageOffsets.clear();
+        mCoverageOffsets.push_back(mTotalOffset);
+        if (mStereo || mPreferedMonoFrustumMode != Frustum::MonoEye)
+        {
+            glm::vec3 eyeOffset(sgct::Engine::instance()->getDefaultUserPtr()->getEyeSeparation() / mDiameter, 0.0f, 0.0f);
+            mCoverageOffsets.push_back(mBaseOffset - eyeOffset);
+            mCoverageOffsets.push_back(mBaseOffset + eyeOffset);
+        }
+        mFixedCoverageOffsets = mCoverageOffsets.size();
+        mNextCoverageOffset = mFixedCoverageOffsets;
+
+        calculateFaceCoverage(mMethod, mFOV, mCropFactors, &mCoverageOffsets[0], mCoverageOffsets.size(), 512, mCoverageRects);
+        mCoverageValid = true;
+        applyFaceCoverage();
+    }
+}
+
+/*!
+Calculates which part of each cube face that is sampled by the fisheye shader. The calculation is done on the CPU
+by sampling the cropped fisheye on a regular grid and is conservative, every used texel is included.
+The tilt doesn't affect the result since it is applied to the cube and not to the cube map lookup.
+
+@param method the rendering method (after it has been adjusted to the field of view)
+@param fov the fisheye field of view in degrees
+@param cropFactors the crop factors indexed by FisheyeCropSide
+@param offsets the lens offsets to include, the result is the union of all offsets
+@param numberOfOffsets the number of lens offsets
+@param samples the number of samples along each side of the fisheye
+@param faceRects six rectangles (xmin, ymin, xmax, ymax) in normalized face coordinates, unused faces get xmax < xmin
+*/
+void sgct_core::FisheyeProjection::calculateFaceCoverage(FisheyeMethod method, float fov, const float * cropFactors,
+    const glm::vec3 * offsets, std::size_t numberOfOffsets, int samples, glm::vec4 * faceRects)
+{
+    for (std::size_t i = 0; i < 6; i++)
+        faceRects[i] = glm::vec4(1.0f, 1.0f, 0.0f, 0.0f);
+
+    samples = std::max(samples, 2);
+    const float halfFov = glm::radians(fov / 2.0f);
+    const float angle45Factor = 0.7071067812f;
+
+    float uMin = cropFactors[CropLeft];
+    float uMax = 1.0f - cropFactors[CropRight];
+    float vMin = cropFactors[CropBottom];
+    float vMax = 1.0f - cropFactors[CropTop];
+    float step = std::max(uMax - uMin, vMax - vMin) / static_cast<float>(samples - 1);
+
+    //the largest angle between a point and its closest sample, scaled by the largest rate of change
+    //of the face coordinates (at the face corners) and by how close the lens offset brings the eye to the sphere
+    float maxOffset = 0.0f;
+    for (std::size_t i = 0; i < numberOfOffsets; i++)
+        maxOffset = std::max(maxOffset, glm::length(offsets[i]));
+    maxOffset = std::min(maxOffset, 0.9f);
+    float padding = 2.0f * (2.0f * sqrtf(2.0f) * step * halfFov) / (1.0f - maxOffset);
+
+    //one sample spacing outside the fisheye circle is clamped to the circle so that the edge is included
+    float maxRadius = 1.0f + 2.0f * sqrtf(2.0f) * step;
+
+    for (int j = 0; j < samples; j++)
+        for (int i = 0; i < samples; i++)
+        {
+            float s = 2.0f * (glm::mix(uMin, uMax, static_cast<float>(i) / static_cast<float>(samples - 1)) - 0.5f);
+            float t = 2.0f * (glm::mix(vMin, vMax, static_cast<float>(j) / static_cast<float>(samples - 1)) - 0.5f);
+            float r = sqrtf(s*s + t*t);
+            if (r > maxRadius)
+                continue;
+
+            float phi = std::min(r, 1.0f) * halfFov;
+            float theta = atan2f(s, t);
+
+            for (std::size_t k = 0; k < numberOfOffsets; k++)
+            {
+                float x = sinf(phi) * sinf(theta) - offsets[k].x;
+                float y = -sinf(phi) * cosf(theta) - offsets[k].y;
+                float z = cosf(phi) - offsets[k].z;
+
+                //same transform as in the fisheye shader
+                glm::vec3 dir = (method == FourFaceCube) ?
+                    glm::vec3(angle45Factor*x + angle45Factor*z, y, -angle45Factor*x + angle45Factor*z) :
+                    glm::vec3(angle45Factor*x - angle45Factor*y, angle45Factor*x + angle45Factor*y, z);
+
+                //major axis and face coordinates according to the OpenGL cube map specification, ordered +X, -X, +Y, -Y, +Z, -Z
+                float ma[] = { dir.x, -dir.x, dir.y, -dir.y, dir.z, -dir.z };
+                float sc[] = { -dir.z, dir.z, dir.x, dir.x, dir.x, -dir.x };
+                float tc[] = { -dir.y, -dir.y, dir.z, -dir.z, -dir.y, -dir.y };
+
+                for (std::size_t face = 0; face < 6; face++)
+                {
+                    if (ma[face] <= 0.0f)
+                        continue;
+
+                    //include samples just outside the face so that thin slivers are not missed
+                    float fs = 0.5f * (sc[face] / ma[face] + 1.0f);
+                    float ft = 0.5f * (tc[face] / ma[face] + 1.0f);
+                    if (fs < -padding || fs > 1.0f + padding || ft < -padding || ft > 1.0f + padding)
+                        continue;
+
+                    glm::vec4 & rect = faceRects[face];
+                    rect.x = std::min(rect.x, fs - padding);
+                    rect.y = std::min(rect.y, ft - padding);
+                    rect.z = std::max(rect.z, fs + padding);
+                    rect.w = std::max(rect.w, ft + padding);
+                }
+            }
+        }
+
+    for (std::size_t i = 0; i < 6; i++)
+    {
+        if (faceRects[i].z < faceRects[i].x)
+            continue;
+
+        faceRects[i] = glm::clamp(faceRects[i], glm::vec4(0.0f), glm::vec4(1.0f));
+        //the clamped rect may be degenerate if only the padding reached into the face
+        if (faceRects[i].z <= faceRects[i].x || faceRects[i].w <= faceRects[i].y)
+            faceRects[i] = glm::vec4(1.0f, 1.0f, 0.0f, 0.0f);
+    }
+}
+
+void sgct_core::FisheyeProjection::storeFaceLayout()
+{
+    for (std::size_t i = 0; i < 6; i++)
+    {
+        FaceLayout & layout = mFaceLayouts[i];
+        layout.enabled = mSubViewports[i].isEnabled();
+        layout.pos = glm::vec2(mSubViewports[i].getX(), mSubViewports[i].getY());
+        layout.size = glm::vec2(mSubViewports[i].getXSize(), mSubViewports[i].getYSize());
+        for (std::size_t j = 0; j < 3; j++)
+            layout.corners[j] = mSubViewports[i].getProjectionPlane()->getCoordinate(static_cast<SGCTProjectionPlane::ProjectionPlaneCorner>(j));
+    }
+}
+
+void sgct_core::FisheyeProjection::updateOffset()
+{
+    mTotalOffset = mBaseOffset + mOffset;
+    mOffAxis = (glm::length(mTotalOffset) > 0.0f ? true : false);
+
+    if (mAdaptiveFaces && mCoverageValid)
+        addCoverageOffset(mTotalOffset);
+}
+
+/*!
+Adds the coverage of a lens offset to the coverage of the offsets seen so far and shrinks the face viewports to it.
+Offsets within a small tolerance of one of the most recent offsets are already covered, so alternating stereo eyes
+and a lens offset that stays put cost nothing while an offset that changes every frame costs one calculation for a
+single offset per frame. The coverage only grows, which is conservative.
+*/
+void sgct_core::FisheyeProjection::addCoverageOffset(const glm::vec3 & offset)
+{
+    //an offset change this small moves the sampled area by less than the padding of the coverage
+    const float tolerance = 1e-4f;
+    const std::size_t maxOffsets = 8;
+
+    for (std::size_t i = 0; i < mCoverageOffsets.size(); i++)
+        if (glm::length(mCoverageOffsets[i] - offset) < tolerance)
+            return;
+
+    if (mCoverageOffsets.size() < maxOffsets)
+        mCoverageOffsets.push_back(offset);
+    else
+    {
+        mCoverageOffsets[mNextCoverageOffset] = offset;
+        mNextCoverageOffset = mNextCoverageOffset + 1 < maxOffsets ? mNextCoverageOffset + 1 : mFixedCoverageOffsets;
+    }
+
+    glm::vec4 faceRects[6];
+    calculateFaceCoverage(mMethod, mFOV, mCropFactors, &offset, 1, 512, faceRects);
+
+    bool grown = false;
+    for (std::size_t i = 0; i < 6; i++)
+    {
+        if (faceRects[i].z < faceRects[i].x)
+            continue;
+
+        glm::vec4 & rect = mCoverageRects[i];
+        glm::vec4 merged = rect.z < rect.x ? faceRects[i] :
+            glm::vec4(glm::min(glm::vec2(rect.x, rect.y), glm::vec2(faceRects[i].x, faceRects[i].y)),
+                glm::max(glm::vec2(rect.z, rect.w), glm::vec2(faceRects[i].z, faceRects[i].w)));
+        grown = grown || merged != rect;
+        rect = merged;
+    }
+
+    if (grown)
+        applyFaceCoverage();
+}
+
+/*!
+Shrinks the face viewports to the area used by the fisheye for all lens offsets seen so far.
+*/
+void sgct_core::FisheyeProjection::applyFaceCoverage()
+{
+    const glm::vec4 * faceRects = mCoverageRects;
+
+    float res = static_cast<float>(mCubemapResolution);
+    for (std::size_t i = 0; i < 6; i++)
+    {
+        const FaceLayout & layout = mFaceLayouts[i];
+
+        //pad by two texels for the texture filtering, snap to the texel grid and keep within the original viewport
+        float x0 = std::max(floorf(faceRects[i].x * res - 2.0f) / res, layout.pos.x);
+        float y0 = std::max(floorf(faceRects[i].y * res - 2.0f) / res, layout.pos.y);
+        float x1 = std::min(ceilf(faceRects[i].z * res + 2.0f) / res, layout.pos.x + layout.size.x);
+        float y1 = std::min(ceilf(faceRects[i].w * res + 2.0f) / res, layout.pos.y + layout.size.y);
+
+        if (!layout.enabled || faceRects[i].z < faceRects[i].x || x1 <= x0 || y1 <= y0)
+        {
+            mSubViewports[i].setEnabled(false);
+            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG,
+                "FisheyeProjection: Cube face %u is not used.\n", static_cast<unsigned int>(i));
+            continue;
+        }
+
+        mSubViewports[i].setEnabled(true);
+        mSubViewports[i].setPos(x0, y0);
+        mSubViewports[i].setSize(x1 - x0, y1 - y0);
+
+        //interpolate the projection plane to match the new viewport
+        glm::vec3 xAxis = layout.corners[SGCTProjectionPlane::UpperRight] - layout.corners[SGCTProjectionPlane::UpperLeft];
+        glm::vec3 yAxis = layout.corners[SGCTProjectionPlane::UpperLeft] - layout.corners[SGCTProjectionPlane::LowerLeft];
+        float u0 = (x0 - layout.pos.x) / layout.size.x;
+        float u1 = (x1 - layout.pos.x) / layout.size.x;
+        float v0 = (y0 - layout.pos.y) / layout.size.y;
+        float v1 = (y1 - layout.pos.y) / layout.size.y;
+        SGCTProjectionPlane * plane = mSubViewports[i].getProjectionPlane();
+        plane->setCoordinate(SGCTProjectionPlane::LowerLeft, layout.corners[SGCTProjectionPlane::LowerLeft] + u0 * xAxis + v0 * yAxis);
+        plane->setCoordinate(SGCTProjectionPlane::UpperLeft, layout.corners[SGCTProjectionPlane::LowerLeft] + u0 * xAxis + v1 * yAxis);
+        plane->setCoordinate(SGCTProjectionPlane::UpperRight, layout.corners[SGCTProjectionPlane::LowerLeft] + u1 * xAxis + v1 * yAxis);
+
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG,
+            "FisheyeProjection: Cube face %u uses %.1f%% of its pixels.\n", static_cast<unsigned int>(i), (x1 - x0) * (y1 - y0) * 100.0f);
+    }
+
+    //the projection planes have changed
+    float nearPlane = sgct::Engine::mInstance->mNearClippingPlaneDist;
+    float farPlane = sgct::Engine::mInstance->mFarClippingPlaneDist;
+    updateFrustums(Frustum::MonoEye, nearPlane, farPlane);
+    updateFrustums(Frustum::StereoLeftEye, nearPlane, farPlane);
+    updateFrustums(Frustum::StereoRightEye, nearPlane, farPlane);
 }
 
 void sgct_core::FisheyeProjection::initShaders()
@@ -877,6 +1132,8 @@ void sgct_core::FisheyeProjection::updateGeomerty(const float & width, const flo
 
 void sgct_core::FisheyeProjection::drawCubeFace(const std::size_t & face)
 {
+    sgct::FrameTrace::Scope scope("cubeFace", "face", static_cast<int>(face));
+
     glLineWidth(1.0);
     sgct::Engine::instance()->getWireframe() ? glPolygonMode(GL_FRONT_AND_BACK, GL_LINE) : glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
@@ -1189,7 +1446,11 @@ void sgct_core::FisheyeProjection::renderCubemapInternal(std::size_t * subViewPo
                 mCubeMapFBO_Ptr->attachCubeMapDepthTexture(mTextures[CubeMapDepth], faceIndex);
 
                 glViewport(0, 0, mCubemapResolution, mCubemapResolution);
-                glScissor(0, 0, mCubemapResolution, mCubemapResolution);
+                //only the used part of the face needs depth correction
+                if (mAdaptiveFaces)
+                    glScissor(mVpCoords[0], mVpCoords[1], mVpCoords[2], mVpCoords[3]);
+                else
+                    glScissor(0, 0, mCubemapResolution, mCubemapResolution);
                 glEnable(GL_SCISSOR_TEST);
 
                 sgct::Engine::mInstance->mClearBufferFnPtr();
@@ -1274,7 +1535,11 @@ void sgct_core::FisheyeProjection::renderCubemapInternalFixedPipeline(std::size_
                 mCubeMapFBO_Ptr->attachCubeMapDepthTexture(mTextures[CubeMapDepth], faceIndex);
 
                 glViewport(0, 0, mCubemapResolution, mCubemapResolution);
-                glScissor(0, 0, mCubemapResolution, mCubemapResolution);
+                //only the used part of the face needs depth correction
+                if (mAdaptiveFaces)
+                    glScissor(mVpCoords[0], mVpCoords[1], mVpCoords[2], mVpCoords[3]);
+                else
+                    glScissor(0, 0, mCubemapResolution, mCubemapResolution);
 
                 glPushAttrib(GL_ALL_ATTRIB_BITS);
                 glEnable(GL_SCISSOR_TEST);
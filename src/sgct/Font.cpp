@@ -9,6 +9,50 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <sgct/Font.h>
 #include <sgct/Engine.h>
 #include <sgct/MessageHandler.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <sstream>
+#include <chrono>
+
+const std::size_t sgct_text::Font::MaxCachedTexts;
+
+namespace
+{
+	//glyphs are handed over from the warmup thread in batches so that the render thread can use them early
+	const std::size_t PrewarmBatchSize = 32;
+
+	//the version is part of the magic, a file written in another byte order is detected by the marker
+	const char GlyphCacheMagic[8] = { 'S', 'G', 'C', 'T', 'G', 'C', '0', '1' };
+	const uint32_t GlyphCacheByteOrder = 0x01020304;
+
+	template<class T> void appendValue(std::vector<char> & buffer, T value)
+	{
+		const char * p = reinterpret_cast<const char *>(&value);
+		buffer.insert(buffer.end(), p, p + sizeof(T));
+	}
+
+	template<class T> bool readValue(const std::vector<char> & buffer, std::size_t & offset, T & value)
+	{
+		if (offset + sizeof(T) > buffer.size())
+			return false;
+		memcpy(&value, &buffer[offset], sizeof(T));
+		offset += sizeof(T);
+		return true;
+	}
+}
+
+/*!
+Default constructor for a rasterized glyph.
+*/
+sgct_text::RasterGlyph::RasterGlyph()
+{
+	mChar = 0;
+	mHasBitmap = false;
+	mWidth = 0;
+	mHeight = 0;
+	mDistToNextChar = 0.0f;
+}
 
 /*!
 Default constructor for font face data.
@@ -16,7 +60,7 @@ Default constructor for font face data.
 sgct_text::FontFaceData::FontFaceData()
 {
 	mTexId = GL_FALSE;
-	mDistToNextChar = 0.0f;
+	mGlyph = NULL;
 	mInterpolated = false;
 }
 
@@ -33,6 +77,13 @@ sgct_text::Font::Font( const std::string & fontName, float height ) :
 	mListId = GL_FALSE;
 	mVAO = GL_FALSE;
     mVBO = GL_FALSE;
+	mUseCounter = 0;
+	mCacheChanged = false;
+	mPrewarmThread = NULL;
+	mAbortPrewarm = false;
+	mPrewarmRunning = false;
+	mHasPrewarmedGlyphs = false;
+	mLookup = sgct_cppxeleven::bind(&sgct_text::Font::lookupGlyph, this, sgct_cppxeleven::placeholders::_1);
 }
 
 /*!
@@ -49,40 +100,19 @@ before creating any textures for the font
 @param    face    The truetype face pointer
 @param    name    FontName of the font that's being created
 @aram    height    Font height in pixels
+@param    path    The font file, needed to rasterize glyphs on the warmup thread
 */
-void sgct_text::Font::init(FT_Library lib, FT_Face face, const std::string & name, unsigned int height )
+void sgct_text::Font::init(FT_Library lib, FT_Face face, const std::string & name, unsigned int height, const std::string & path )
 {
 	mFTLibrary = lib;
+	mPath = path;
 	mStrokeSize = 1;
 	mFace = face;
 	mName = name;
 	mHeight = static_cast<float>( height );
 
-	//setup geomerty
-	if (sgct::Engine::instance()->isOGLPipelineFixed())
-	{
-		mListId = glGenLists(1);
-		sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Font: Generating display list: %u\n", mListId);
-
-		//So now we can create the display list
-		glNewList(mListId, GL_COMPILE);
-
-		glBegin(GL_QUADS);
-		glTexCoord2f(0.0f, 0.0f);
-		glVertex3f(0.0f, 1.0f, 0.0f);
-
-		glTexCoord2f(0.0f, 1.0f);
-		glVertex3f(0.0f, 0.0f, 0.0f);
-
-		glTexCoord2f(1.0f, 1.0f);
-		glVertex3f(1.0f, 0.0f, 0.0f);
-
-		glTexCoord2f(1.0f, 0.0f);
-		glVertex3f(1.0f, 1.0f, 0.0f);
-		glEnd();
-		glEndList();
-	}
-	else
+	//setup the vertex buffer for texts that are not cached, the fixed pipeline draws from client memory
+	if (!sgct::Engine::instance()->isOGLPipelineFixed())
 	{
 		glGenVertexArrays(1, &mVAO);
 		glGenBuffers(1, &mVBO);
@@ -90,64 +120,16 @@ void sgct_text::Font::init(FT_Library lib, FT_Face face, const std::string & nam
 		sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Font: Generating VAO: %u\n", mVAO);
 		sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Font: Generating VBO: %u\n", mVBO);
 
-		std::vector<float> coords;
-		coords.push_back(0.0f);
-		coords.push_back(1.0f);
-		coords.push_back(0.0f);
-		coords.push_back(0.0f);
-
-		coords.push_back(1.0f);
-		coords.push_back(1.0f);
-		coords.push_back(1.0f);
-		coords.push_back(0.0f);
-
-		coords.push_back(0.0f); //s
-		coords.push_back(0.0f); //t
-		coords.push_back(0.0f); //x
-		coords.push_back(1.0f); //y
-
-		coords.push_back(1.0f);
-		coords.push_back(0.0f);
-		coords.push_back(1.0f);
-		coords.push_back(1.0f);
-
-		glBindVertexArray(mVAO);
-		glBindBuffer(GL_ARRAY_BUFFER, mVBO);
-		glBufferData(GL_ARRAY_BUFFER, coords.size() * sizeof(float), &coords[0], GL_STATIC_DRAW);
-
-		glEnableVertexAttribArray(0);
-		glEnableVertexAttribArray(1);
-
-		glVertexAttribPointer(
-			0,                  // attribute 0. No particular reason for 0, but must match the layout in the shader.
-			2,                  // size
-			GL_FLOAT,           // type
-			GL_FALSE,           // normalized?
-			4 * sizeof(float),    // stride
-			reinterpret_cast<void*>(0) // array buffer offset
-			);
-
-		glVertexAttribPointer(
-			1,                  // attribute 1
-			2,                  // size
-			GL_FLOAT,           // type
-			GL_FALSE,           // normalized?
-			4 * sizeof(float),    // stride
-			reinterpret_cast<void*>(8) // array buffer offset
-			);
-
-		//unbind
-		glBindVertexArray(0);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		setupVertexArray(mVAO, mVBO);
 	}
 }
 
 /*!
-Counts the number of textures used by this font.
+Counts the number of glyphs loaded by this font.
 */
 std::size_t sgct_text::Font::getNumberOfLoadedChars()
 {
-	return mFontFaceDataMap.size();
+	return mGlyphs.size();
 }
 
 /*!
@@ -173,69 +155,248 @@ Cleans up memory used by the Font
 */
 void sgct_text::Font::clean()
 {
-	if (mFontFaceDataMap.size() > 0)
+	//keep the glyphs that were rasterized so far and write them to the cache before the atlas is cleared
+	stopPrewarm();
+	mergePrewarmedGlyphs();
+	saveGlyphCache();
+
+	if (!sgct::Engine::instance()->isOGLPipelineFixed())
 	{
-		if (sgct::Engine::instance()->isOGLPipelineFixed())
-		{
-			if (mListId != GL_FALSE)
-				glDeleteLists(mListId, 1);
-		}
-		else
+		if (mVAO != GL_FALSE)
+			glDeleteVertexArrays(1, &mVAO);
+		if (mVBO != GL_FALSE)
+			glDeleteBuffers(1, &mVBO);
+		mVAO = GL_FALSE;
+		mVBO = GL_FALSE;
+	}
+
+	for (std::map<std::wstring, CachedText>::iterator it = mTextCache.begin(); it != mTextCache.end(); ++it)
+		deleteCachedText(it->second);
+	mTextCache.clear();
+
+	if (!mPageTextures.empty())
+		glDeleteTextures(static_cast<GLsizei>(mPageTextures.size()), &mPageTextures[0]);
+	mPageTextures.clear();
+	mPageInterpolated.clear();
+	mAtlas.clear();
+
+	//clear data
+	for (std::size_t i = 0; i < mGlyphs.size(); i++)
+		if (mGlyphs[i].mGlyph != NULL)
+			FT_Done_Glyph(mGlyphs[i].mGlyph);
+	
+	mGlyphs.clear();
+	mGlyphIndices.clear();
+	FT_Done_Face(mFace);
+}
+
+sgct_text::FontFaceData * sgct_text::Font::getFontFaceData(wchar_t c)
+{
+	if (mHasPrewarmedGlyphs)
+		mergePrewarmedGlyphs();
+
+	sgct_cppxeleven::unordered_map<wchar_t, std::size_t>::iterator it = mGlyphIndices.find(c);
+	if (it != mGlyphIndices.end())
+		return &mGlyphs[it->second];
+
+	createCharacter(c);
+	return &mGlyphs[mGlyphIndices[c]];
+}
+
+const sgct_text::GlyphMetrics * sgct_text::Font::lookupGlyph(wchar_t c)
+{
+	return getFontFaceData(c);
+}
+
+/*!
+Draws the lines with the origin at the top left of the first line. The shader, its uniforms and the
+transform must be set up by the caller.
+@param    lines          The lines of the text
+@param    mode           The alignment of the lines
+@param    interpolate    If the atlas should use linear interpolation, used when the text is drawn in 3D
+*/
+void sgct_text::Font::drawText(const std::vector<std::wstring> & lines, TextAlignMode mode, bool interpolate)
+{
+	CachedText & ct = getCachedText(lines, mode);
+	if (ct.mesh.mBatches.empty())
+		return;
+
+	//glyphs created by the layout are uploaded before drawing
+	updateTextures();
+
+	glActiveTexture(GL_TEXTURE0);
+
+	bool fixedPipeline = sgct::Engine::instance()->isOGLPipelineFixed();
+	if (fixedPipeline)
+	{
+		glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glTexCoordPointer(2, GL_FLOAT, TextMesh::FloatsPerVertex * sizeof(float), &ct.mesh.mVertices[0]);
+		glVertexPointer(2, GL_FLOAT, TextMesh::FloatsPerVertex * sizeof(float), &ct.mesh.mVertices[2]);
+	}
+	else if (ct.vao != GL_FALSE)
+		glBindVertexArray(ct.vao);
+	else
+	{
+		glBindVertexArray(mVAO);
+		glBindBuffer(GL_ARRAY_BUFFER, mVBO);
+		glBufferData(GL_ARRAY_BUFFER, ct.mesh.mVertices.size() * sizeof(float), &ct.mesh.mVertices[0], GL_STREAM_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	for (std::size_t i = 0; i < ct.mesh.mBatches.size(); i++)
+	{
+		const TextBatch & batch = ct.mesh.mBatches[i];
+		glBindTexture(GL_TEXTURE_2D, mPageTextures[batch.page]);
+
+		//use linear interpolation in 3D and nearest in 2D
+		if (mPageInterpolated[batch.page] != interpolate)
 		{
-			if (mVAO != GL_FALSE)
-				glDeleteVertexArrays(1, &mVAO);
-			if (mVBO != GL_FALSE)
-				glDeleteBuffers(1, &mVBO);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, interpolate ? GL_LINEAR : GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, interpolate ? GL_LINEAR : GL_NEAREST);
+			mPageInterpolated[batch.page] = interpolate;
 		}
 
+		glDrawArrays(GL_TRIANGLES, batch.first, batch.count);
+	}
 
-		//clear data
-		for (auto& n : mFontFaceDataMap)
+	if (fixedPipeline)
+		glPopClientAttrib();
+	else
+		glBindVertexArray(0);
+}
+
+/*!
+Returns the laid out text from the cache or lays it out. Texts that are drawn more than once get their own
+vertex buffer, the least recently used text is removed when the cache is full.
+*/
+sgct_text::Font::CachedText & sgct_text::Font::getCachedText(const std::vector<std::wstring> & lines, TextAlignMode mode)
+{
+	std::wstring key(1, static_cast<wchar_t>(L'0' + mode));
+	for (std::size_t i = 0; i < lines.size(); i++)
+	{
+		key += L'\n';
+		key += lines[i];
+	}
+
+	mUseCounter++;
+
+	std::map<std::wstring, CachedText>::iterator it = mTextCache.find(key);
+	if (it != mTextCache.end())
+	{
+		CachedText & ct = it->second;
+		ct.uses++;
+		ct.lastUse = mUseCounter;
+
+		//static text, keep it on the gpu
+		if (ct.uses == 2 && ct.vao == GL_FALSE && !ct.mesh.mVertices.empty() && !sgct::Engine::instance()->isOGLPipelineFixed())
 		{
-			glDeleteTextures(1, &(n.second.mTexId));
-			FT_Done_Glyph(n.second.mGlyph);
+			glGenVertexArrays(1, &ct.vao);
+			glGenBuffers(1, &ct.vbo);
+			glBindBuffer(GL_ARRAY_BUFFER, ct.vbo);
+			glBufferData(GL_ARRAY_BUFFER, ct.mesh.mVertices.size() * sizeof(float), &ct.mesh.mVertices[0], GL_STATIC_DRAW);
+			setupVertexArray(ct.vao, ct.vbo);
 		}
+
+		return ct;
 	}
-	
-	mFontFaceDataMap.clear();
-	FT_Done_Face(mFace);
+
+	if (mTextCache.size() >= MaxCachedTexts)
+	{
+		std::map<std::wstring, CachedText>::iterator oldest = mTextCache.begin();
+		for (std::map<std::wstring, CachedText>::iterator cit = mTextCache.begin(); cit != mTextCache.end(); ++cit)
+			if (cit->second.lastUse < oldest->second.lastUse)
+				oldest = cit;
+
+		deleteCachedText(oldest->second);
+		mTextCache.erase(oldest);
+	}
+
+	CachedText & ct = mTextCache[key];
+	ct.vao = GL_FALSE;
+	ct.vbo = GL_FALSE;
+	ct.uses = 1;
+	ct.lastUse = mUseCounter;
+	layoutText(lines, mode, mHeight * 1.59f, mLookup, ct.mesh);
+
+	return ct;
 }
 
-sgct_text::FontFaceData * sgct_text::Font::getFontFaceData(wchar_t c)
+void sgct_text::Font::deleteCachedText(CachedText & ct)
 {
-	if (mFontFaceDataMap.count(c) == 0) //check if c does not exist in map
-		createCharacter(c);
-	
-	return &mFontFaceDataMap[c];
+	if (ct.vao != GL_FALSE)
+		glDeleteVertexArrays(1, &ct.vao);
+	if (ct.vbo != GL_FALSE)
+		glDeleteBuffers(1, &ct.vbo);
+	ct.vao = GL_FALSE;
+	ct.vbo = GL_FALSE;
+}
+
+void sgct_text::Font::setupVertexArray(unsigned int vao, unsigned int vbo)
+{
+	glBindVertexArray(vao);
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
+
+	glVertexAttribPointer(
+		0,                  // attribute 0. No particular reason for 0, but must match the layout in the shader.
+		2,                  // size
+		GL_FLOAT,           // type
+		GL_FALSE,           // normalized?
+		4 * sizeof(float),    // stride
+		reinterpret_cast<void*>(0) // array buffer offset
+		);
+
+	glVertexAttribPointer(
+		1,                  // attribute 1
+		2,                  // size
+		GL_FLOAT,           // type
+		GL_FALSE,           // normalized?
+		4 * sizeof(float),    // stride
+		reinterpret_cast<void*>(8) // array buffer offset
+		);
+
+	//unbind
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void sgct_text::Font::createCharacter(wchar_t c)
 {
-	FontFaceData ffd;
-	
-	//create glyph
-	if (createGlyph(c, &ffd))
-	{
-		mFontFaceDataMap[c] = ffd;
-	}
+	RasterGlyph rg;
+	FT_Glyph glyph = NULL;
+
+	//a failed glyph is stored as well so that it is only tried once
+	rasterizeGlyph(mFTLibrary, mFace, mStrokeSize, c, rg, &glyph);
+	addGlyph(rg, glyph);
 }
 
-bool sgct_text::Font::createGlyph(wchar_t c, FontFaceData * FFDPtr)
+/*!
+Rasterizes a glyph and its stroke. Only uses the library and face that are passed so that it can be called from
+the warmup thread with its own face.
+@param    glyph    Set to the freetype glyph if not NULL, otherwise the glyph is released
+*/
+bool sgct_text::Font::rasterizeGlyph(FT_Library lib, FT_Face face, FT_Fixed strokeSize, wchar_t c, RasterGlyph & rg, FT_Glyph * glyph) const
 {
+	rg.mChar = c;
+
 	//Load the Glyph for our character.
 	/*
 	Hints:
 	http://www.freetype.org/freetype2/docs/reference/ft2-base_interface.html#FT_LOAD_XXX
 	*/
 
-	FT_UInt char_index = FT_Get_Char_Index(mFace, static_cast<FT_ULong>(c));
+	FT_UInt char_index = FT_Get_Char_Index(face, static_cast<FT_ULong>(c));
 	if (char_index == 0)
 	{
-		std::string mName;                // Holds the font name
 		sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Font %s: Missing face for char %u!\n", mName.c_str(), static_cast<unsigned int>(c));
 	}
 
-	if (FT_Load_Glyph(mFace, char_index, FT_LOAD_FORCE_AUTOHINT))
+	if (FT_Load_Glyph(face, char_index, FT_LOAD_FORCE_AUTOHINT))
 	{
 		sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Font %s: FT_Load_Glyph failed for char %u!\n", mName.c_str(), static_cast<unsigned int>(c));
 		return false;
@@ -247,56 +408,436 @@ bool sgct_text::Font::createGlyph(wchar_t c, FontFaceData * FFDPtr)
 
 	//load pixel data
 	GlyphData gd;
-	if (!getPixelData(mFace, width, height, &pixels, &gd))
+	if (!getPixelData(lib, strokeSize, face, width, height, &pixels, &gd))
 	{
 		sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Font %s: FT_Get_Glyph failed for char %u.\n", mName.c_str(), static_cast<unsigned int>(c));
 		return false;
 	}
 
-	//create texture
-	if (char_index > 0) //skip null
-		FFDPtr->mTexId = generateTexture(width, height, pixels);
-	else
-		FFDPtr->mTexId = GL_FALSE;
-
-	//With the texture created, we don't need to expanded data anymore
+	//skip null and empty glyphs
+	rg.mHasBitmap = char_index > 0 && width > 0 && height > 0;
+	rg.mWidth = width;
+	rg.mHeight = height;
+	if (rg.mHasBitmap)
+		rg.mPixels.assign(pixels, pixels + static_cast<std::size_t>(width) * height * GlyphAtlas::Channels);
 	delete[] pixels;
 
 	//setup geometry data
-	FFDPtr->mPos.x = static_cast<float>(gd.mBitmapGlyph->left);
-	FFDPtr->mPos.y = static_cast<float>(gd.mBitmapGlyph->top - gd.mBitmapPtr->rows);
-	FFDPtr->mSize.x = static_cast<float>(width);
-	FFDPtr->mSize.y = static_cast<float>(height);
+	rg.mPos.x = static_cast<float>(gd.mBitmapGlyph->left);
+	rg.mPos.y = static_cast<float>(gd.mBitmapGlyph->top - gd.mBitmapPtr->rows);
+	rg.mDistToNextChar = static_cast<float>(face->glyph->advance.x >> 6);
 
 	//delete the stroke glyph
 	FT_Stroker_Done(gd.mStroker);
 	FT_Done_Glyph(gd.mStrokeGlyph);
-	
+
 	// Can't delete them while they are used, delete when font is cleaned
-	FFDPtr->mGlyph = gd.mGlyph;
-	FFDPtr->mDistToNextChar = static_cast<float>(mFace->glyph->advance.x >> 6);
+	if (glyph != NULL)
+		*glyph = gd.mGlyph;
+	else
+		FT_Done_Glyph(gd.mGlyph);
+
+	return true;
+}
+
+/*!
+Packs a rasterized glyph into the atlas and adds its metrics. The texture is updated before the next draw.
+*/
+void sgct_text::Font::addGlyph(const RasterGlyph & rg, FT_Glyph glyph)
+{
+	FontFaceData ffd;
+	ffd.mGlyph = glyph;
+	ffd.mPos = rg.mPos;
+	ffd.mSize.x = static_cast<float>(rg.mWidth);
+	ffd.mSize.y = static_cast<float>(rg.mHeight);
+	ffd.mDistToNextChar = rg.mDistToNextChar;
+
+	GlyphAtlas::Region region;
+	if (rg.mHasBitmap && !rg.mPixels.empty() && mAtlas.insert(rg.mWidth, rg.mHeight, &rg.mPixels[0], region))
+	{
+		float pageSize = static_cast<float>(mAtlas.getPage(region.page).size);
+		ffd.mPage = region.page;
+		ffd.mTexCoordMin = glm::vec2(static_cast<float>(region.x) / pageSize, static_cast<float>(region.y) / pageSize);
+		ffd.mTexCoordMax = glm::vec2(static_cast<float>(region.x + region.width) / pageSize, static_cast<float>(region.y + region.height) / pageSize);
+		ffd.mTexId = region.page < mPageTextures.size() ? mPageTextures[region.page] : GL_FALSE;
+	}
+
+	mGlyphIndices[rg.mChar] = mGlyphs.size();
+	mGlyphs.push_back(ffd);
+	mCacheChanged = true;
+}
+
+/*!
+Rasterizes a range of characters on a worker thread, see prewarm(const std::wstring &).
+*/
+void sgct_text::Font::prewarm(wchar_t first, wchar_t last)
+{
+	std::wstring characters;
+	for (unsigned int c = static_cast<unsigned int>(first); c <= static_cast<unsigned int>(last); c++)
+		characters += static_cast<wchar_t>(c);
+	prewarm(characters);
+}
+
+/*!
+Rasterizes the characters that are not loaded yet on a worker thread with its own freetype face. The glyphs are
+added to the atlas by the render thread the next time the font is used, a character that is printed before the
+worker reaches it is rasterized as usual. A previous warmup is completed first.
+@param    characters    The characters to rasterize
+*/
+void sgct_text::Font::prewarm(const std::wstring & characters)
+{
+	if (mPath.empty())
+	{
+		sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "Font %s: Can't prewarm glyphs since the font file is unknown.\n", mName.c_str());
+		return;
+	}
+
+	if (mPrewarmThread != NULL)
+	{
+		mPrewarmThread->join();
+		delete mPrewarmThread;
+		mPrewarmThread = NULL;
+	}
+	mergePrewarmedGlyphs();
+
+	std::wstring missing;
+	for (std::size_t i = 0; i < characters.size(); i++)
+		if (mGlyphIndices.find(characters[i]) == mGlyphIndices.end())
+			missing += characters[i];
+
+	if (missing.empty())
+		return;
+
+	sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Font %s: Prewarming %u glyphs.\n", mName.c_str(), static_cast<unsigned int>(missing.size()));
+
+	mAbortPrewarm = false;
+	mPrewarmRunning = true;
+	mPrewarmThread = new (std::nothrow) std::thread(&sgct_text::Font::prewarmLoop, this, missing, mStrokeSize);
+	if (mPrewarmThread == NULL)
+	{
+		mPrewarmRunning = false;
+		sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Font %s: Failed to start the glyph warmup thread.\n", mName.c_str());
+	}
+}
+
+/*!
+\returns true while the warmup thread is rasterizing glyphs
+*/
+bool sgct_text::Font::isPrewarming()
+{
+	return mPrewarmRunning;
+}
+
+void sgct_text::Font::prewarmLoop(std::wstring characters, FT_Fixed strokeSize)
+{
+	//freetype faces can't be shared between threads so the worker opens the font file once more
+	FT_Library lib = NULL;
+	FT_Face face = NULL;
+	FT_F26Dot6 size = static_cast<FT_F26Dot6>(mHeight) << 6;
+
+	if (FT_Init_FreeType(&lib) != 0 ||
+		FT_New_Face(lib, mPath.c_str(), 0, &face) != 0 ||
+		FT_Set_Char_Size(face, size, size, 96, 96) != 0)
+	{
+		sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "Font %s: Failed to open '%s' for glyph warmup.\n", mName.c_str(), mPath.c_str());
+	}
+	else
+	{
+		std::vector<RasterGlyph> batch;
+		for (std::size_t i = 0; i < characters.size() && !mAbortPrewarm; i++)
+		{
+			batch.push_back(RasterGlyph());
+			rasterizeGlyph(lib, face, strokeSize, characters[i], batch.back(), NULL);
+
+			if (batch.size() == PrewarmBatchSize || i + 1 == characters.size())
+			{
+				std::unique_lock<std::mutex> lock(mPrewarmMutex);
+				mPrewarmedGlyphs.insert(mPrewarmedGlyphs.end(), batch.begin(), batch.end());
+				mHasPrewarmedGlyphs = true;
+				lock.unlock();
+
+				batch.clear();
+			}
+		}
+	}
+
+	if (face != NULL)
+		FT_Done_Face(face);
+	if (lib != NULL)
+		FT_Done_FreeType(lib);
+
+	mPrewarmRunning = false;
+}
+
+/*!
+Adds the glyphs that the warmup thread has rasterized so far, characters that were created meanwhile are skipped.
+*/
+void sgct_text::Font::mergePrewarmedGlyphs()
+{
+	std::vector<RasterGlyph> glyphs;
+
+	std::unique_lock<std::mutex> lock(mPrewarmMutex);
+	glyphs.swap(mPrewarmedGlyphs);
+	mHasPrewarmedGlyphs = false;
+	lock.unlock();
+
+	for (std::size_t i = 0; i < glyphs.size(); i++)
+		if (mGlyphIndices.find(glyphs[i].mChar) == mGlyphIndices.end())
+			addGlyph(glyphs[i], NULL);
+}
+
+void sgct_text::Font::stopPrewarm()
+{
+	if (mPrewarmThread != NULL)
+	{
+		mAbortPrewarm = true;
+		mPrewarmThread->join();
+		delete mPrewarmThread;
+		mPrewarmThread = NULL;
+	}
+}
+
+/*!
+Loads rasterized glyphs from a cache file written by saveGlyphCache and remembers the file so that new glyphs are
+written to it when the font is cleaned. The file name should identify the font file and its height, see
+FontManager::setGlyphCacheDirectory. A file written with another stroke size is ignored.
+@param    filename    The cache file
+\returns true if the glyphs were loaded
+*/
+bool sgct_text::Font::loadGlyphCache(const std::string & filename)
+{
+	mCacheFilename = filename;
+
+	FILE * file = NULL;
+#if (_MSC_VER >= 1400) //visual studio 2005 or later
+	if (fopen_s(&file, filename.c_str(), "rb") != 0)
+		file = NULL;
+#else
+	file = fopen(filename.c_str(), "rb");
+#endif
+	if (file == NULL)
+	{
+		sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Font %s: No glyph cache found at '%s'.\n", mName.c_str(), filename.c_str());
+		return false;
+	}
+
+	std::vector<char> data;
+	char chunk[4096];
+	std::size_t read;
+	while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+		data.insert(data.end(), chunk, chunk + read);
+	fclose(file);
+
+	std::size_t offset = sizeof(GlyphCacheMagic);
+	uint32_t byteOrder = 0;
+	int32_t strokeSize = 0;
+	uint32_t count = 0;
+	bool valid = data.size() >= sizeof(GlyphCacheMagic) &&
+		memcmp(&data[0], GlyphCacheMagic, sizeof(GlyphCacheMagic)) == 0 &&
+		readValue(data, offset, byteOrder) && byteOrder == GlyphCacheByteOrder &&
+		readValue(data, offset, strokeSize) &&
+		readValue(data, offset, count);
+
+	if (valid && strokeSize != static_cast<int32_t>(mStrokeSize))
+	{
+		sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Font %s: Ignoring glyph cache '%s' with stroke size %d.\n", mName.c_str(), filename.c_str(), strokeSize);
+		return false;
+	}
+
+	std::vector<RasterGlyph> glyphs;
+	for (uint32_t i = 0; valid && i < count; i++)
+	{
+		RasterGlyph rg;
+		uint32_t c = 0;
+		uint8_t hasBitmap = 0;
+		int32_t width = 0;
+		int32_t height = 0;
+
+		valid = readValue(data, offset, c) &&
+			readValue(data, offset, hasBitmap) &&
+			readValue(data, offset, width) &&
+			readValue(data, offset, height) &&
+			readValue(data, offset, rg.mPos.x) &&
+			readValue(data, offset, rg.mPos.y) &&
+			readValue(data, offset, rg.mDistToNextChar) &&
+			width >= 0 && height >= 0 && width <= 0xFFFF && height <= 0xFFFF;
+
+		if (valid && hasBitmap != 0)
+		{
+			std::size_t size = static_cast<std::size_t>(width) * height * GlyphAtlas::Channels;
+			valid = offset + size <= data.size();
+			if (valid)
+			{
+				rg.mPixels.assign(data.begin() + offset, data.begin() + offset + size);
+				offset += size;
+			}
+		}
+
+		rg.mChar = static_cast<wchar_t>(c);
+		rg.mHasBitmap = hasBitmap != 0;
+		rg.mWidth = width;
+		rg.mHeight = height;
+		glyphs.push_back(rg);
+	}
+
+	if (!valid)
+	{
+		sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "Font %s: Glyph cache '%s' is invalid and will be replaced.\n", mName.c_str(), filename.c_str());
+		mCacheChanged = true;
+		return false;
+	}
+
+	bool wasEmpty = mGlyphs.empty();
+	for (std::size_t i = 0; i < glyphs.size(); i++)
+		if (mGlyphIndices.find(glyphs[i].mChar) == mGlyphIndices.end())
+			addGlyph(glyphs[i], NULL);
 
+	//nothing new to write unless the font already had glyphs that are not in the file
+	if (wasEmpty)
+		mCacheChanged = false;
+
+	sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Font %s: Loaded %u glyphs from cache '%s'.\n", mName.c_str(), count, filename.c_str());
 	return true;
 }
 
-unsigned int sgct_text::Font::generateTexture(int width, int height, unsigned char * data)
+/*!
+Writes the metrics and bitmaps of all loaded glyphs to the cache file given to loadGlyphCache if glyphs were added
+since it was loaded. The file is written under a temporary name and renamed so that other nodes sharing the cache
+never read a partial file.
+\returns true if the cache is up to date
+*/
+bool sgct_text::Font::saveGlyphCache()
+{
+	if (mCacheFilename.empty() || !mCacheChanged)
+		return true;
+
+	std::vector<char> buffer(GlyphCacheMagic, GlyphCacheMagic + sizeof(GlyphCacheMagic));
+	appendValue(buffer, GlyphCacheByteOrder);
+	appendValue(buffer, static_cast<int32_t>(mStrokeSize));
+	appendValue(buffer, static_cast<uint32_t>(mGlyphIndices.size()));
+
+	for (sgct_cppxeleven::unordered_map<wchar_t, std::size_t>::const_iterator it = mGlyphIndices.begin(); it != mGlyphIndices.end(); ++it)
+	{
+		const FontFaceData & ffd = mGlyphs[it->second];
+		bool hasBitmap = ffd.mPage != GlyphMetrics::NoPage;
+		int32_t width = static_cast<int32_t>(ffd.mSize.x);
+		int32_t height = static_cast<int32_t>(ffd.mSize.y);
+
+		appendValue(buffer, static_cast<uint32_t>(it->first));
+		appendValue(buffer, static_cast<uint8_t>(hasBitmap ? 1 : 0));
+		appendValue(buffer, width);
+		appendValue(buffer, height);
+		appendValue(buffer, ffd.mPos.x);
+		appendValue(buffer, ffd.mPos.y);
+		appendValue(buffer, ffd.mDistToNextChar);
+
+		if (hasBitmap)
+		{
+			//the page sizes are powers of two so the texture coordinates map back to exact pixels
+			const GlyphAtlas::Page & p = mAtlas.getPage(ffd.mPage);
+			int x = static_cast<int>(ffd.mTexCoordMin.x * static_cast<float>(p.size) + 0.5f);
+			int y = static_cast<int>(ffd.mTexCoordMin.y * static_cast<float>(p.size) + 0.5f);
+			for (int row = 0; row < height; row++)
+			{
+				const unsigned char * src = &p.pixels[(static_cast<std::size_t>(y + row) * p.size + x) * GlyphAtlas::Channels];
+				buffer.insert(buffer.end(), src, src + static_cast<std::size_t>(width) * GlyphAtlas::Channels);
+			}
+		}
+	}
+
+	//the cache directory can be shared between nodes, so the temporary file must be unique to this writer
+	std::stringstream ss;
+	ss << mCacheFilename << "." << std::chrono::high_resolution_clock::now().time_since_epoch().count() << ".tmp";
+	std::string tmpFilename = ss.str();
+	FILE * file = NULL;
+#if (_MSC_VER >= 1400) //visual studio 2005 or later
+	if (fopen_s(&file, tmpFilename.c_str(), "wb") != 0)
+		file = NULL;
+#else
+	file = fopen(tmpFilename.c_str(), "wb");
+#endif
+	if (file == NULL)
+	{
+		sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "Font %s: Failed to write glyph cache '%s'.\n", mName.c_str(), tmpFilename.c_str());
+		return false;
+	}
+
+	bool success = fwrite(&buffer[0], 1, buffer.size(), file) == buffer.size();
+	success = fclose(file) == 0 && success;
+
+	if (success && rename(tmpFilename.c_str(), mCacheFilename.c_str()) != 0)
+	{
+		//rename doesn't replace existing files on windows
+		remove(mCacheFilename.c_str());
+		success = rename(tmpFilename.c_str(), mCacheFilename.c_str()) == 0;
+	}
+
+	if (!success)
+	{
+		remove(tmpFilename.c_str());
+		sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "Font %s: Failed to write glyph cache '%s'.\n", mName.c_str(), mCacheFilename.c_str());
+		return false;
+	}
+
+	mCacheChanged = false;
+	sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Font %s: Wrote %u glyphs to cache '%s'.\n", mName.c_str(), static_cast<unsigned int>(mGlyphIndices.size()), mCacheFilename.c_str());
+	return true;
+}
+
+/*!
+Creates textures for new atlas pages and uploads the rows of the pages that changed.
+*/
+void sgct_text::Font::updateTextures()
+{
+	bool fixedPipeline = sgct::Engine::instance()->isOGLPipelineFixed();
+
+	for (unsigned int page = 0; page < mAtlas.getNumberOfPages(); page++)
+	{
+		if (!mAtlas.isDirty(page))
+			continue;
+
+		const GlyphAtlas::Page & p = mAtlas.getPage(page);
+		if (page >= mPageTextures.size())
+		{
+			mPageTextures.push_back(generateTexture(p.size));
+			mPageInterpolated.push_back(false);
+
+			//glyphs that were packed before the texture existed
+			for (std::size_t i = 0; i < mGlyphs.size(); i++)
+				if (mGlyphs[i].mPage == page)
+					mGlyphs[i].mTexId = mPageTextures[page];
+		}
+		else
+			glBindTexture(GL_TEXTURE_2D, mPageTextures[page]);
+
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, p.dirtyMinY, p.size, p.dirtyMaxY - p.dirtyMinY,
+			fixedPipeline ? GL_LUMINANCE_ALPHA : GL_RG, GL_UNSIGNED_BYTE,
+			&p.pixels[static_cast<std::size_t>(p.dirtyMinY) * p.size * GlyphAtlas::Channels]);
+
+		mAtlas.clearDirty(page);
+	}
+}
+
+/*!
+Creates an empty atlas page texture and leaves it bound.
+*/
+unsigned int sgct_text::Font::generateTexture(int size)
 {
 	unsigned int tex;
 	glGenTextures(1, &tex);
 	glBindTexture(GL_TEXTURE_2D, tex);
 
-	/*
-	SGCT2 change: Use non-power-of-two textures for better quality
-	*/
 	glPixelStorei(GL_PACK_ALIGNMENT, 1);
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
+	//the atlas is updated with new glyphs so it can't be compressed
 	if (sgct::Engine::instance()->isOGLPipelineFixed())
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_COMPRESSED_LUMINANCE_ALPHA, width, height,
-			0, GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, data);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE8_ALPHA8, size, size,
+			0, GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, NULL);
 	else
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_COMPRESSED_RG, width, height,
-			0, GL_RG, GL_UNSIGNED_BYTE, data);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RG8, size, size,
+			0, GL_RG, GL_UNSIGNED_BYTE, NULL);
 
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
@@ -309,7 +850,7 @@ unsigned int sgct_text::Font::generateTexture(int width, int height, unsigned ch
 	return tex;
 }
 
-bool sgct_text::Font::getPixelData(FT_Face face, int & width, int & height, unsigned char ** pixels, GlyphData * gd)
+bool sgct_text::Font::getPixelData(FT_Library lib, FT_Fixed strokeSize, FT_Face face, int & width, int & height, unsigned char ** pixels, GlyphData * gd)
 {
 	//Move the face's glyph into a Glyph object.
 	if (FT_Get_Glyph(face->glyph, &(gd->mGlyph)) || FT_Get_Glyph(face->glyph, &(gd->mStrokeGlyph)))
@@ -318,10 +859,10 @@ bool sgct_text::Font::getPixelData(FT_Face face, int & width, int & height, unsi
 	}
 
 	gd->mStroker = NULL;
-	FT_Error error = FT_Stroker_New(mFTLibrary, &(gd->mStroker));
+	FT_Error error = FT_Stroker_New(lib, &(gd->mStroker));
 	if (!error)
 	{
-		FT_Stroker_Set(gd->mStroker, 64 * mStrokeSize,
+		FT_Stroker_Set(gd->mStroker, 64 * strokeSize,
 			FT_STROKER_LINECAP_ROUND,
 			FT_STROKER_LINEJOIN_ROUND,
 			0);
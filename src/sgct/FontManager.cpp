@@ -16,6 +16,15 @@ For conditions of distribution and use, see copyright notice in sgct.h
 
 #include <algorithm>
 #include <stdio.h>
+#include <stdint.h>
+#include <sstream>
+#include <iomanip>
+
+#ifdef __WIN32__
+    #include <direct.h>
+#else
+    #include <sys/stat.h>
+#endif
 
 const static std::string Font_Vert_Shader = "\
 **glsl_version**\n\
@@ -175,6 +184,29 @@ void sgct_text::FontManager::setDrawInScreenSpace( bool state )
     mDrawInScreenSpace = state;
 }
 
+/*!
+Set the directory where rasterized glyphs are cached between runs. Fonts that are created afterwards load their
+glyphs from the cache and write new glyphs back when they are cleaned. The cache files are named after the hash of
+the font file and the font height so the directory can be shared between nodes.
+@param    path    The cache directory, an empty path disables the cache
+*/
+void sgct_text::FontManager::setGlyphCacheDirectory( const std::string & path )
+{
+    mGlyphCacheDirectory = path;
+    std::replace(mGlyphCacheDirectory.begin(), mGlyphCacheDirectory.end(), '\\', '/');
+    while (mGlyphCacheDirectory.size() > 1 && mGlyphCacheDirectory[mGlyphCacheDirectory.size() - 1] == '/')
+        mGlyphCacheDirectory.erase(mGlyphCacheDirectory.size() - 1);
+
+    if (mGlyphCacheDirectory.empty())
+        return;
+
+#ifdef __WIN32__
+    _mkdir(mGlyphCacheDirectory.c_str());
+#else
+    mkdir(mGlyphCacheDirectory.c_str(), 0755);
+#endif
+}
+
 std::size_t sgct_text::FontManager::getTotalNumberOfLoadedChars()
 {
 	std::size_t counter = 0;
@@ -224,6 +256,24 @@ sgct_text::Font * sgct_text::FontManager::getFont( const std::string & fontName,
 	return mFontMap[fontName][height];
 }
 
+/*!
+Creates the font if needed and rasterizes a range of characters on a worker thread so that printing them later
+doesn't stall the frame.
+@param    fontName    Name of the font
+@param    height    Height in pixels for the font
+@param    first    First character of the range
+@param    last    Last character of the range
+@return    Pointer to the font face, NULL if not found
+*/
+sgct_text::Font * sgct_text::FontManager::prewarmFont( const std::string & fontName, unsigned int height, wchar_t first, wchar_t last )
+{
+    Font * font = getFont(fontName, height);
+    if( font != NULL )
+        font->prewarm(first, last);
+
+    return font;
+}
+
 /*!
 Get the SGCT default font face that is loaded into memory.
 @param    height    Height in  pixels for the font
@@ -277,7 +327,10 @@ sgct_text::Font * sgct_text::FontManager::createFont( const std::string & fontNa
 
 	// Create the font when all error tests are done
 	Font * newFont = new Font();
-	newFont->init( mFTLibrary, mFace, fontName, height );
+	newFont->init( mFTLibrary, mFace, fontName, height, it->second );
+
+	if( !mGlyphCacheDirectory.empty() )
+		newFont->loadGlyphCache( getGlyphCacheFilename( it->second, height ) );
 
 	static bool shaderCreated = false;
 
@@ -324,3 +377,44 @@ sgct_text::Font * sgct_text::FontManager::createFont( const std::string & fontNa
 	mFontMap[fontName][height] = newFont;
 	return newFont;
 }
+
+/*!
+\returns the glyph cache file for a font file and height, named after a hash of the content of the font file
+*/
+std::string sgct_text::FontManager::getGlyphCacheFilename( const std::string & path, unsigned int height )
+{
+	std::map<std::string, std::string>::iterator it = mFontHashes.find( path );
+	if( it == mFontHashes.end() )
+	{
+		//FNV-1a
+		uint64_t hash = 14695981039346656037ULL;
+
+		FILE * file = NULL;
+#if (_MSC_VER >= 1400) //visual studio 2005 or later
+		if( fopen_s(&file, path.c_str(), "rb") != 0 )
+			file = NULL;
+#else
+		file = fopen(path.c_str(), "rb");
+#endif
+		if( file != NULL )
+		{
+			unsigned char chunk[4096];
+			std::size_t read;
+			while( (read = fread(chunk, 1, sizeof(chunk), file)) > 0 )
+				for( std::size_t i = 0; i < read; i++ )
+				{
+					hash ^= chunk[i];
+					hash *= 1099511628211ULL;
+				}
+			fclose(file);
+		}
+
+		std::stringstream ss;
+		ss << std::hex << std::setw(16) << std::setfill('0') << hash;
+		it = mFontHashes.insert( std::pair<std::string, std::string>( path, ss.str() ) ).first;
+	}
+
+	std::stringstream ss;
+	ss << mGlyphCacheDirectory << "/" << it->second << "_" << height << ".glyphs";
+	return ss.str();
+}
@@ -0,0 +1,429 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#include <sgct/FrameTrace.h>
+#include <sgct/MessageHandler.h>
+#include <sgct/helpers/SGCTThreadRing.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <fstream>
+#include <map>
+
+sgct::FrameTrace * sgct::FrameTrace::mInstance = NULL;
+
+namespace
+{
+    //number of events in each thread's ring, must be a power of two
+    const std::size_t gTraceRingSize = 16384;
+    //the writer thread wakes up at least this often
+    const int gTraceWriteInterval = 100; //ms
+    //incremented for each trace so that threads don't reuse rings of a stopped trace
+    std::atomic<unsigned int> gTraceGeneration(0);
+
+    const char * gSyncFrameEventName = "syncFrame";
+
+    //parses the number following key in a line written by the trace
+    bool parseValue(const std::string & line, const char * key, double & value, std::size_t * pos = NULL)
+    {
+        std::size_t keyPos = line.find(key);
+        if (keyPos == std::string::npos)
+            return false;
+
+        keyPos += strlen(key);
+        value = strtod(line.c_str() + keyPos, NULL);
+        if (pos != NULL)
+            *pos = keyPos;
+        return true;
+    }
+}
+
+struct sgct::FrameTrace::Event
+{
+    const char * name;
+    const char * argName;
+    int arg;
+    unsigned int frame;
+    double start;
+    double duration;
+    char phase;
+};
+
+/*!
+Ring of the events of one recording thread, drained by the writer thread.
+*/
+struct sgct::FrameTrace::EventRing : public sgct_helpers::ThreadRing<Event>
+{
+    EventRing(unsigned int threadIndex) : sgct_helpers::ThreadRing<Event>(gTraceRingSize), mThreadIndex(threadIndex) {}
+
+    unsigned int mThreadIndex;
+};
+
+sgct::FrameTrace::Scope::Scope(const char * name, const char * argName, int arg)
+{
+    mActive = FrameTrace::instance()->isEnabled();
+    if (mActive)
+    {
+        mName = name;
+        mArgName = argName;
+        mArg = arg;
+        mStart = FrameTrace::getTime();
+    }
+}
+
+sgct::FrameTrace::Scope::~Scope()
+{
+    if (mActive)
+        FrameTrace::instance()->addEvent(mName, mStart, FrameTrace::getTime() - mStart, mArgName, mArg);
+}
+
+sgct::FrameTrace::FrameTrace()
+{
+    mEnabled = false;
+    mRunning = false;
+    mFrameNumber = 0;
+    mGeneration = 0;
+    mNodeId = 0;
+    mWriterThread = NULL;
+    mNumberOfThreads = 0;
+    mFile = NULL;
+}
+
+sgct::FrameTrace::~FrameTrace()
+{
+    stop();
+}
+
+/*!
+Starts recording to a new trace file. The node id is used as process id so that the events of different nodes
+end up on separate tracks when the files are merged.
+
+\returns true if the file could be created
+*/
+bool sgct::FrameTrace::start(const std::string & filename, int nodeId)
+{
+    stop();
+
+#if (_MSC_VER >= 1400) //visual studio 2005 or later
+    if (fopen_s(&mFile, filename.c_str(), "w") != 0)
+        mFile = NULL;
+#else
+    mFile = fopen(filename.c_str(), "w");
+#endif
+
+    if (mFile == NULL)
+    {
+        MessageHandler::instance()->print(MessageHandler::NOTIFY_ERROR, "FrameTrace: Failed to create trace file '%s'!\n", filename.c_str());
+        return false;
+    }
+
+    mNodeId = nodeId < 0 ? 0 : nodeId;
+    mNumberOfThreads = 0;
+    mGeneration = ++gTraceGeneration;
+
+    fprintf(mFile, "{\"traceEvents\":[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,\"args\":{\"name\":\"node %d\"}}",
+        mNodeId, mNodeId);
+
+    mRunning = true;
+    mWriterThread = new (std::nothrow) std::thread(&sgct::FrameTrace::writeLoop, this);
+    mEnabled = (mWriterThread != NULL);
+
+    MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "FrameTrace: Recording to '%s'.\n", filename.c_str());
+    return mEnabled;
+}
+
+/*!
+Stops recording, writes all pending events and closes the trace file.
+*/
+void sgct::FrameTrace::stop()
+{
+    mEnabled = false;
+
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mRunning = false;
+    }
+    mCondition.notify_all();
+
+    if (mWriterThread)
+    {
+        mWriterThread->join();
+        delete mWriterThread;
+        mWriterThread = NULL;
+    }
+
+    if (mFile != NULL)
+    {
+        fprintf(mFile, "\n],\"displayTimeUnit\":\"ms\"}\n");
+        fclose(mFile);
+        mFile = NULL;
+    }
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mRings.clear();
+}
+
+/*!
+Set the sync frame number that new events are tagged with. Also records a marker event that mergeFiles uses to
+align the timelines of the nodes. Called by the Engine once per frame when the frame is synchronized.
+*/
+void sgct::FrameTrace::setFrameNumber(unsigned int frame)
+{
+    mFrameNumber = frame;
+
+    if (!mEnabled)
+        return;
+
+    Event e;
+    e.name = gSyncFrameEventName;
+    e.argName = NULL;
+    e.arg = 0;
+    e.frame = frame;
+    e.start = getTime();
+    e.duration = 0.0;
+    e.phase = 'i';
+    push(e);
+}
+
+/*!
+Records a completed event.
+
+\param name the name of the event, must outlive the trace
+\param startTime the start time in microseconds, see getTime
+\param duration the duration in microseconds
+\param argName the name of an optional integer argument like a window or viewport index, must outlive the trace
+\param arg the value of the argument
+*/
+void sgct::FrameTrace::addEvent(const char * name, double startTime, double duration, const char * argName, int arg)
+{
+    if (!mEnabled)
+        return;
+
+    Event e;
+    e.name = name;
+    e.argName = argName;
+    e.arg = arg;
+    e.frame = mFrameNumber;
+    e.start = startTime;
+    e.duration = duration;
+    e.phase = 'X';
+    push(e);
+}
+
+/*!
+\returns a monotonic time stamp in microseconds
+*/
+double sgct::FrameTrace::getTime()
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void sgct::FrameTrace::push(const Event & e)
+{
+    std::shared_ptr<EventRing> ring = getThreadRing();
+
+    if (ring->getFreeSpace() == 0)
+    {
+        //never stall the render loop, the writer reports the dropped events
+        ring->drop();
+        return;
+    }
+
+    const unsigned long long head = ring->getHead();
+    ring->write(head, &e, 1);
+    ring->publish(head + 1);
+}
+
+std::shared_ptr<sgct::FrameTrace::EventRing> sgct::FrameTrace::getThreadRing()
+{
+    static thread_local sgct_helpers::ThreadRingOwner<EventRing> owner;
+
+    if (!owner.hasRing(mGeneration))
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        owner.setRing(std::make_shared<EventRing>(mNumberOfThreads++), mGeneration);
+        mRings.push_back(owner.getRing());
+    }
+
+    return owner.getRing();
+}
+
+void sgct::FrameTrace::writeLoop()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true)
+    {
+        if (mRunning)
+            mCondition.wait_for(lock, std::chrono::milliseconds(gTraceWriteInterval));
+        bool running = mRunning;
+
+        writeEvents();
+
+        if (!running)
+            break;
+    }
+}
+
+//called from the writer thread with mMutex locked
+void sgct::FrameTrace::writeEvents()
+{
+    char buffer[512];
+
+    std::vector< std::shared_ptr<EventRing> >::iterator it = mRings.begin();
+    while (it != mRings.end())
+    {
+        EventRing * ring = it->get();
+        bool abandoned = ring->isAbandoned();
+        unsigned long long tail = ring->getTail();
+        const unsigned long long head = ring->getPublishedHead();
+
+        if (tail == 0 && head > 0)
+        {
+            fprintf(mFile, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}",
+                mNodeId, ring->mThreadIndex, ring->mThreadIndex);
+        }
+
+        mLine.clear();
+        for (; tail < head; tail++)
+        {
+            const Event & e = ring->at(tail);
+
+            int length;
+            if (e.phase == 'i')
+            {
+                length = snprintf(buffer, sizeof(buffer),
+                    ",\n{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"p\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f,\"args\":{\"frame\":%u}}",
+                    e.name, mNodeId, ring->mThreadIndex, e.start, e.frame);
+            }
+            else if (e.argName != NULL)
+            {
+                length = snprintf(buffer, sizeof(buffer),
+                    ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%u,\"%s\":%d}}",
+                    e.name, mNodeId, ring->mThreadIndex, e.start, e.duration, e.frame, e.argName, e.arg);
+            }
+            else
+            {
+                length = snprintf(buffer, sizeof(buffer),
+                    ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%u}}",
+                    e.name, mNodeId, ring->mThreadIndex, e.start, e.duration, e.frame);
+            }
+
+            if (length > 0)
+                mLine.append(buffer, static_cast<std::size_t>(length) < sizeof(buffer) ? static_cast<std::size_t>(length) : sizeof(buffer) - 1);
+        }
+        ring->release(tail);
+
+        unsigned int dropped = ring->takeDropped();
+        if (dropped > 0)
+        {
+            snprintf(buffer, sizeof(buffer),
+                ",\n{\"name\":\"droppedEvents\",\"ph\":\"i\",\"s\":\"t\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f,\"args\":{\"count\":%u}}",
+                mNodeId, ring->mThreadIndex, getTime(), dropped);
+            mLine.append(buffer);
+        }
+
+        fwrite(mLine.c_str(), 1, mLine.size(), mFile);
+
+        if (abandoned)
+            it = mRings.erase(it);
+        else
+            ++it;
+    }
+
+    fflush(mFile);
+}
+
+/*!
+Merges the trace files of several nodes into one file. The time stamps of each file are shifted so that the first
+sync frame found in both the first file and the other file starts at the same time.
+
+\returns false if a file could not be read or written
+*/
+bool sgct::FrameTrace::mergeFiles(const std::vector<std::string> & inputs, const std::string & output)
+{
+    std::map<unsigned int, double> referenceFrames;
+    std::vector< std::vector<std::string> > events(inputs.size());
+    std::vector<double> offsets(inputs.size(), 0.0);
+
+    for (std::size_t i = 0; i < inputs.size(); i++)
+    {
+        std::ifstream file(inputs[i].c_str());
+        if (!file.is_open())
+        {
+            MessageHandler::instance()->print(MessageHandler::NOTIFY_ERROR, "FrameTrace: Failed to open '%s'!\n", inputs[i].c_str());
+            return false;
+        }
+
+        bool aligned = (i == 0);
+        std::string line;
+        while (std::getline(file, line))
+        {
+            //events are written one per line followed by a comma
+            std::size_t begin = line.find('{');
+            if (begin == std::string::npos || line.compare(begin, 15, "{\"traceEvents\":") == 0)
+                continue;
+            line.erase(0, begin);
+            while (!line.empty() && (line[line.size() - 1] == ',' || line[line.size() - 1] == '\r'))
+                line.erase(line.size() - 1);
+
+            if (line.find(gSyncFrameEventName) != std::string::npos)
+            {
+                double frame, ts;
+                if (parseValue(line, "\"frame\":", frame) && parseValue(line, "\"ts\":", ts))
+                {
+                    unsigned int frameNumber = static_cast<unsigned int>(frame);
+                    if (i == 0)
+                        referenceFrames[frameNumber] = ts;
+                    else if (!aligned && referenceFrames.count(frameNumber) > 0)
+                    {
+                        offsets[i] = referenceFrames[frameNumber] - ts;
+                        aligned = true;
+                    }
+                }
+            }
+
+            events[i].push_back(line);
+        }
+
+        if (!aligned)
+            MessageHandler::instance()->print(MessageHandler::NOTIFY_WARNING, "FrameTrace: No common sync frame in '%s', the file is not aligned.\n", inputs[i].c_str());
+    }
+
+    std::ofstream out(output.c_str());
+    if (!out.is_open())
+    {
+        MessageHandler::instance()->print(MessageHandler::NOTIFY_ERROR, "FrameTrace: Failed to create '%s'!\n", output.c_str());
+        return false;
+    }
+
+    out << "{\"traceEvents\":[\n";
+    bool first = true;
+    char buffer[64];
+    for (std::size_t i = 0; i < events.size(); i++)
+        for (std::size_t j = 0; j < events[i].size(); j++)
+        {
+            std::string & line = events[i][j];
+            double ts;
+            std::size_t pos;
+            if (offsets[i] != 0.0 && parseValue(line, "\"ts\":", ts, &pos))
+            {
+                std::size_t end = line.find_first_of(",}", pos);
+                snprintf(buffer, sizeof(buffer), "%.3f", ts + offsets[i]);
+                line.replace(pos, end - pos, buffer);
+            }
+
+            //skip the closing bracket of the input files
+            if (line[0] != '{' || line.find("\"ph\"") == std::string::npos)
+                continue;
+
+            out << (first ? "" : ",\n") << line;
+            first = false;
+        }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    return true;
+}
@@ -0,0 +1,243 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#include <sgct/FrustumCuller.h>
+#include <sgct/helpers/SGCTSIMD.h>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+
+using namespace sgct_helpers;
+
+namespace
+{
+    //number of set bits in a four bit lane mask
+    const unsigned int gLaneBitCount[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+}
+
+sgct::FrustumCuller::FrustumCuller()
+{
+    ;
+}
+
+/*!
+Removes all frustums. A culler without frustums reports every volume as visible.
+*/
+void sgct::FrustumCuller::clear()
+{
+    mPlanes.clear();
+}
+
+/*!
+Replaces all frustums with the frustum of the given matrix.
+
+\param mvp the view projection matrix to test world space volumes or the model view projection matrix to test object space volumes
+*/
+void sgct::FrustumCuller::setMatrix(const glm::mat4 & mvp)
+{
+    clear();
+    addMatrix(mvp);
+}
+
+/*!
+Adds the frustum of the given matrix. Volumes are visible if they intersect any of the added frustums.
+*/
+void sgct::FrustumCuller::addMatrix(const glm::mat4 & mvp)
+{
+    //Gribb & Hartmann: the planes are the sums and differences of the last row and the other rows
+    glm::vec4 row[4];
+    for (int i = 0; i < 4; i++)
+        row[i] = glm::vec4(mvp[0][i], mvp[1][i], mvp[2][i], mvp[3][i]);
+
+    glm::vec4 planes[NumberOfPlanes] =
+    {
+        row[3] + row[0], //left
+        row[3] - row[0], //right
+        row[3] + row[1], //bottom
+        row[3] - row[1], //top
+        row[3] + row[2], //near
+        row[3] - row[2]  //far
+    };
+
+    for (std::size_t i = 0; i < NumberOfPlanes; i++)
+    {
+        float length = glm::length(glm::vec3(planes[i]));
+        if (length > 0.0f)
+            planes[i] /= length;
+
+        mPlanes.push_back(planes[i].x);
+        mPlanes.push_back(planes[i].y);
+        mPlanes.push_back(planes[i].z);
+        mPlanes.push_back(planes[i].w);
+        mPlanes.push_back(fabsf(planes[i].x));
+        mPlanes.push_back(fabsf(planes[i].y));
+        mPlanes.push_back(fabsf(planes[i].z));
+    }
+}
+
+/*!
+\returns true if the sphere intersects any of the frustums
+*/
+bool sgct::FrustumCuller::isSphereVisible(const glm::vec3 & center, float radius) const
+{
+    if (mPlanes.empty())
+        return true;
+
+    for (std::size_t f = 0; f < mPlanes.size(); f += PlaneDataSize)
+    {
+        const float * p = &mPlanes[f];
+        bool inside = true;
+        for (std::size_t i = 0; i < NumberOfPlanes && inside; i++, p += NumberOfComponents)
+            inside = (p[NormalX] * center.x + p[NormalY] * center.y + p[NormalZ] * center.z + p[Distance] + radius) >= 0.0f;
+
+        if (inside)
+            return true;
+    }
+
+    return false;
+}
+
+/*!
+\returns true if the axis aligned box intersects any of the frustums
+*/
+bool sgct::FrustumCuller::isBoxVisible(const glm::vec3 & minCorner, const glm::vec3 & maxCorner) const
+{
+    if (mPlanes.empty())
+        return true;
+
+    glm::vec3 center = (minCorner + maxCorner) * 0.5f;
+    glm::vec3 extent = (maxCorner - minCorner) * 0.5f;
+
+    for (std::size_t f = 0; f < mPlanes.size(); f += PlaneDataSize)
+    {
+        const float * p = &mPlanes[f];
+        bool inside = true;
+        for (std::size_t i = 0; i < NumberOfPlanes && inside; i++, p += NumberOfComponents)
+            inside = (p[NormalX] * center.x + p[NormalY] * center.y + p[NormalZ] * center.z + p[Distance] +
+                p[AbsNormalX] * extent.x + p[AbsNormalY] * extent.y + p[AbsNormalZ] * extent.z) >= 0.0f;
+
+        if (inside)
+            return true;
+    }
+
+    return false;
+}
+
+/*!
+Tests an array of bounding spheres.
+
+\param spheres the spheres where xyz is the center and w is the radius
+\param count the number of spheres
+\param visibility the resulting bitset, one bit per sphere, use isVisible to read it
+\returns the number of visible spheres
+*/
+std::size_t sgct::FrustumCuller::cullSpheres(const glm::vec4 * spheres, std::size_t count, std::vector<unsigned int> & visibility) const
+{
+    visibility.assign((count + 31) / 32, mPlanes.empty() ? 0xFFFFFFFFu : 0u);
+    if (mPlanes.empty())
+        return count;
+
+    std::size_t numberOfVisible = 0;
+    const Lanes zero(0.0f);
+    glm::vec4 tail[4];
+
+    for (std::size_t i = 0; i < count; i += 4)
+    {
+        std::size_t n = std::min<std::size_t>(4, count - i);
+        const glm::vec4 * s = spheres + i;
+        if (n < 4)
+        {
+            for (std::size_t j = 0; j < 4; j++)
+                tail[j] = spheres[i + std::min(j, n - 1)];
+            s = tail;
+        }
+
+        Lanes x, y, z, r;
+        lanesTranspose(glm::value_ptr(s[0]), glm::value_ptr(s[1]), glm::value_ptr(s[2]), glm::value_ptr(s[3]), x, y, z, r);
+
+        unsigned int visibleMask = 0;
+        for (std::size_t f = 0; f < mPlanes.size() && visibleMask != 0xF; f += PlaneDataSize)
+        {
+            const float * p = &mPlanes[f];
+            unsigned int insideMask = 0xF;
+            for (std::size_t j = 0; j < NumberOfPlanes && insideMask != 0; j++, p += NumberOfComponents)
+            {
+                Lanes dist = x * Lanes(p[NormalX]) + y * Lanes(p[NormalY]) + z * Lanes(p[NormalZ]) + Lanes(p[Distance]) + r;
+                insideMask &= lanesGreaterEqualMask(dist, zero);
+            }
+            visibleMask |= insideMask;
+        }
+
+        visibleMask &= (1u << n) - 1u;
+        visibility[i >> 5] |= visibleMask << (i & 31);
+        numberOfVisible += gLaneBitCount[visibleMask];
+    }
+
+    return numberOfVisible;
+}
+
+/*!
+Tests an array of axis aligned bounding boxes.
+
+\param minCorners the minimum corners of the boxes
+\param maxCorners the maximum corners of the boxes
+\param count the number of boxes
+\param visibility the resulting bitset, one bit per box, use isVisible to read it
+\returns the number of visible boxes
+*/
+std::size_t sgct::FrustumCuller::cullBoxes(const glm::vec3 * minCorners, const glm::vec3 * maxCorners, std::size_t count, std::vector<unsigned int> & visibility) const
+{
+    visibility.assign((count + 31) / 32, mPlanes.empty() ? 0xFFFFFFFFu : 0u);
+    if (mPlanes.empty())
+        return count;
+
+    std::size_t numberOfVisible = 0;
+    const Lanes zero(0.0f);
+    float center[3][4];
+    float extent[3][4];
+
+    for (std::size_t i = 0; i < count; i += 4)
+    {
+        std::size_t n = std::min<std::size_t>(4, count - i);
+        for (std::size_t j = 0; j < 4; j++)
+        {
+            std::size_t index = i + std::min(j, n - 1);
+            for (int k = 0; k < 3; k++)
+            {
+                center[k][j] = (minCorners[index][k] + maxCorners[index][k]) * 0.5f;
+                extent[k][j] = (maxCorners[index][k] - minCorners[index][k]) * 0.5f;
+            }
+        }
+
+        Lanes cx = Lanes::load(center[0]);
+        Lanes cy = Lanes::load(center[1]);
+        Lanes cz = Lanes::load(center[2]);
+        Lanes ex = Lanes::load(extent[0]);
+        Lanes ey = Lanes::load(extent[1]);
+        Lanes ez = Lanes::load(extent[2]);
+
+        unsigned int visibleMask = 0;
+        for (std::size_t f = 0; f < mPlanes.size() && visibleMask != 0xF; f += PlaneDataSize)
+        {
+            const float * p = &mPlanes[f];
+            unsigned int insideMask = 0xF;
+            for (std::size_t j = 0; j < NumberOfPlanes && insideMask != 0; j++, p += NumberOfComponents)
+            {
+                //distance from the plane to the box corner furthest along the plane normal
+                Lanes dist = cx * Lanes(p[NormalX]) + cy * Lanes(p[NormalY]) + cz * Lanes(p[NormalZ]) + Lanes(p[Distance]) +
+                    ex * Lanes(p[AbsNormalX]) + ey * Lanes(p[AbsNormalY]) + ez * Lanes(p[AbsNormalZ]);
+                insideMask &= lanesGreaterEqualMask(dist, zero);
+            }
+            visibleMask |= insideMask;
+        }
+
+        visibleMask &= (1u << n) - 1u;
+        visibility[i >> 5] |= visibleMask << (i & 31);
+        numberOfVisible += gLaneBitCount[visibleMask];
+    }
+
+    return numberOfVisible;
+}
@@ -0,0 +1,218 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#include <sgct/GlyphAtlas.h>
+#include <string.h>
+
+const int sgct_text::GlyphAtlas::Channels;
+
+/*!
+@param    pageSize    Width and height of the pages in pixels, larger pages are added for glyphs that don't fit
+@param    padding     Number of empty pixels between glyphs so that they don't bleed into each other when interpolated
+*/
+sgct_text::GlyphAtlas::GlyphAtlas(int pageSize, int padding)
+{
+    mPageSize = pageSize;
+    mPadding = padding;
+}
+
+/*!
+Packs a glyph into the atlas and copies its pixels, a new page is added if it doesn't fit in any page.
+@param    width     Width of the glyph in pixels
+@param    height    Height of the glyph in pixels
+@param    pixels    Glyph pixels with Channels bytes per pixel, rows from top to bottom
+@param    region    Set to the location of the glyph
+*/
+bool sgct_text::GlyphAtlas::insert(int width, int height, const unsigned char * pixels, Region & region)
+{
+    if (width < 0 || height < 0)
+        return false;
+
+    //each glyph owns the padding to its left and above it
+    int paddedWidth = width + mPadding;
+    int paddedHeight = height + mPadding;
+
+    int x = 0;
+    int y = 0;
+    std::size_t index = 0;
+    unsigned int page = 0;
+    bool found = false;
+    for (; page < mPages.size() && !found; page++)
+        found = findPosition(page, paddedWidth, paddedHeight, x, y, index);
+
+    if (found)
+        page--;
+    else
+    {
+        int size = mPageSize;
+        while (size < paddedWidth || size < paddedHeight)
+            size *= 2;
+
+        addPage(size);
+        page = static_cast<unsigned int>(mPages.size() - 1);
+        if (!findPosition(page, paddedWidth, paddedHeight, x, y, index))
+            return false;
+    }
+
+    addSkylineLevel(page, index, x, y, paddedWidth, paddedHeight);
+
+    region.page = page;
+    region.x = x + mPadding;
+    region.y = y + mPadding;
+    region.width = width;
+    region.height = height;
+
+    Page & p = mPages[page];
+    if (pixels != NULL)
+        for (int row = 0; row < height; row++)
+            memcpy(&p.pixels[(static_cast<std::size_t>(region.y + row) * p.size + region.x) * Channels],
+                pixels + static_cast<std::size_t>(row) * width * Channels,
+                static_cast<std::size_t>(width) * Channels);
+
+    if (height > 0)
+    {
+        if (p.dirtyMaxY <= p.dirtyMinY)
+        {
+            p.dirtyMinY = region.y;
+            p.dirtyMaxY = region.y + height;
+        }
+        else
+        {
+            p.dirtyMinY = region.y < p.dirtyMinY ? region.y : p.dirtyMinY;
+            p.dirtyMaxY = region.y + height > p.dirtyMaxY ? region.y + height : p.dirtyMaxY;
+        }
+    }
+
+    return true;
+}
+
+/*!
+Removes all pages.
+*/
+void sgct_text::GlyphAtlas::clear()
+{
+    mPages.clear();
+    mSkylines.clear();
+}
+
+/*!
+Marks the page as uploaded.
+*/
+void sgct_text::GlyphAtlas::clearDirty(unsigned int page)
+{
+    mPages[page].dirtyMinY = 0;
+    mPages[page].dirtyMaxY = 0;
+}
+
+void sgct_text::GlyphAtlas::addPage(int size)
+{
+    Page p;
+    p.size = size;
+    p.pixels.assign(static_cast<std::size_t>(size) * size * Channels, 0);
+    p.dirtyMinY = 0;
+    p.dirtyMaxY = size; //upload the whole page when the texture is created
+    mPages.push_back(p);
+
+    SkylineNode node;
+    node.x = 0;
+    node.y = 0;
+    node.width = size;
+    mSkylines.push_back(std::vector<SkylineNode>(1, node));
+}
+
+/*!
+Finds the position where the top of the rectangle is as low as possible, ties are broken by the narrowest skyline segment.
+*/
+bool sgct_text::GlyphAtlas::findPosition(unsigned int page, int width, int height, int & x, int & y, std::size_t & index)
+{
+    const std::vector<SkylineNode> & skyline = mSkylines[page];
+    int bestBottom = -1;
+    int bestWidth = 0;
+
+    for (std::size_t i = 0; i < skyline.size(); i++)
+    {
+        int top = fit(page, i, width, height);
+        if (top < 0)
+            continue;
+
+        int bottom = top + height;
+        if (bestBottom < 0 || bottom < bestBottom || (bottom == bestBottom && skyline[i].width < bestWidth))
+        {
+            bestBottom = bottom;
+            bestWidth = skyline[i].width;
+            x = skyline[i].x;
+            y = top;
+            index = i;
+        }
+    }
+
+    return bestBottom >= 0;
+}
+
+/*!
+\returns the top of the rectangle if it is placed at the skyline node or -1 if it doesn't fit
+*/
+int sgct_text::GlyphAtlas::fit(unsigned int page, std::size_t index, int width, int height)
+{
+    const std::vector<SkylineNode> & skyline = mSkylines[page];
+    int size = mPages[page].size;
+
+    if (skyline[index].x + width > size)
+        return -1;
+
+    int y = skyline[index].y;
+    int widthLeft = width;
+    for (std::size_t i = index; widthLeft > 0; i++)
+    {
+        if (i >= skyline.size())
+            return -1;
+        if (skyline[i].y > y)
+            y = skyline[i].y;
+        if (y + height > size)
+            return -1;
+        widthLeft -= skyline[i].width;
+    }
+
+    return y;
+}
+
+void sgct_text::GlyphAtlas::addSkylineLevel(unsigned int page, std::size_t index, int x, int y, int width, int height)
+{
+    std::vector<SkylineNode> & skyline = mSkylines[page];
+
+    SkylineNode node;
+    node.x = x;
+    node.y = y + height;
+    node.width = width;
+    skyline.insert(skyline.begin() + index, node);
+
+    //shrink or remove the nodes that are covered by the new node
+    for (std::size_t i = index + 1; i < skyline.size(); )
+    {
+        int shrink = skyline[i - 1].x + skyline[i - 1].width - skyline[i].x;
+        if (shrink <= 0)
+            break;
+
+        skyline[i].x += shrink;
+        skyline[i].width -= shrink;
+        if (skyline[i].width > 0)
+            break;
+        skyline.erase(skyline.begin() + i);
+    }
+
+    //merge neighbours at the same height
+    for (std::size_t i = 0; i + 1 < skyline.size(); )
+    {
+        if (skyline[i].y == skyline[i + 1].y)
+        {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+        }
+        else
+            i++;
+    }
+}
@@ -0,0 +1,185 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#include <sgct/MaskCombiner.h>
+#include <sgct/Image.h>
+#include <sgct/MessageHandler.h>
+#include <string.h>
+#include <math.h>
+
+namespace
+{
+    float readChannel(sgct_core::Image * img, std::size_t x, std::size_t y, std::size_t channel)
+    {
+        const unsigned char * p = img->getSampleAt(x, y) + channel * img->getBytesPerChannel();
+        if (img->getBytesPerChannel() == 2)
+        {
+            unsigned short val;
+            memcpy(&val, p, sizeof(unsigned short));
+            return static_cast<float>(val) / 65535.0f;
+        }
+
+        return static_cast<float>(p[0]) / 255.0f;
+    }
+
+    /*
+        Luminance images are gray and images without alpha are opaque
+    */
+    glm::vec4 readTexel(sgct_core::Image * img, std::size_t x, std::size_t y)
+    {
+        switch (img->getChannels())
+        {
+        case 1:
+        {
+            float l = readChannel(img, x, y, 0);
+            return glm::vec4(l, l, l, 1.0f);
+        }
+        case 2:
+        {
+            float l = readChannel(img, x, y, 0);
+            return glm::vec4(l, l, l, readChannel(img, x, y, 1));
+        }
+        default:
+        {
+            bool bgr = img->getPreferBGRImport();
+            return glm::vec4(
+                readChannel(img, x, y, bgr ? 2 : 0),
+                readChannel(img, x, y, 1),
+                readChannel(img, x, y, bgr ? 0 : 2),
+                img->getChannels() == 4 ? readChannel(img, x, y, 3) : 1.0f);
+        }
+        }
+    }
+
+    void writeChannel(unsigned char * p, std::size_t bpc, float val)
+    {
+        val = val < 0.0f ? 0.0f : (val > 1.0f ? 1.0f : val);
+        if (bpc == 2)
+        {
+            unsigned short tmp = static_cast<unsigned short>(val * 65535.0f + 0.5f);
+            memcpy(p, &tmp, sizeof(unsigned short));
+        }
+        else
+            p[0] = static_cast<unsigned char>(val * 255.0f + 0.5f);
+    }
+}
+
+/*!
+Samples a mask image with bilinear interpolation and clamping at the edges like the mask textures.
+
+@param img the 8 or 16 bit mask image with one to four channels
+@param s horizontal texture coordinate in [0, 1]
+@param t vertical texture coordinate in [0, 1], 0 is the first row of the image
+\returns the normalized RGBA color
+*/
+glm::vec4 sgct_core::MaskCombiner::readSample(Image * img, float s, float t)
+{
+    float x = s * static_cast<float>(img->getWidth()) - 0.5f;
+    float y = t * static_cast<float>(img->getHeight()) - 0.5f;
+    float maxX = static_cast<float>(img->getWidth() - 1);
+    float maxY = static_cast<float>(img->getHeight() - 1);
+    x = x < 0.0f ? 0.0f : (x > maxX ? maxX : x);
+    y = y < 0.0f ? 0.0f : (y > maxY ? maxY : y);
+
+    std::size_t x0 = static_cast<std::size_t>(floorf(x));
+    std::size_t y0 = static_cast<std::size_t>(floorf(y));
+    std::size_t x1 = x0 + 1 < img->getWidth() ? x0 + 1 : x0;
+    std::size_t y1 = y0 + 1 < img->getHeight() ? y0 + 1 : y0;
+    float fx = x - static_cast<float>(x0);
+    float fy = y - static_cast<float>(y0);
+
+    glm::vec4 top = glm::mix(readTexel(img, x0, y0), readTexel(img, x1, y0), fx);
+    glm::vec4 bottom = glm::mix(readTexel(img, x0, y1), readTexel(img, x1, y1), fx);
+    return glm::mix(top, bottom, fy);
+}
+
+/*!
+\returns the factor the color is multiplied with in rgb and the black level that is added after that in alpha
+*/
+glm::vec4 sgct_core::MaskCombiner::combineSamples(const glm::vec4 & blend, const glm::vec4 & blackLevel)
+{
+    glm::vec3 factor = glm::vec3(blend) * (glm::vec3(1.0f) - glm::vec3(blackLevel));
+    float level = (blackLevel.r + blackLevel.g + blackLevel.b) / 3.0f;
+    return glm::vec4(factor, level * blackLevel.a);
+}
+
+/*!
+Creates the combined BGRA mask image. The combined image has the resolution of the blend mask, or of the
+black level mask if there is no blend mask, and the other mask is resampled if the resolutions differ.
+A missing blend mask is white and a missing black level mask is black. The combined image has 16 bits per
+channel if any of the masks has, so that smooth 16 bit blends don't band.
+
+\returns the combined image that the caller owns or NULL if there are no masks or they are in an unsupported format
+*/
+sgct_core::Image * sgct_core::MaskCombiner::combine(Image * blendMask, Image * blackLevelMask)
+{
+    Image * masks[] = { blendMask, blackLevelMask };
+    for (std::size_t i = 0; i < 2; i++)
+        if (masks[i] != NULL && (masks[i]->getData() == NULL || masks[i]->getChannels() < 1 || masks[i]->getChannels() > 4 ||
+            masks[i]->getBytesPerChannel() < 1 || masks[i]->getBytesPerChannel() > 2))
+        {
+            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "MaskCombiner: Unsupported format of mask '%s'!\n",
+                masks[i]->getFilename());
+            return NULL;
+        }
+
+    Image * base = blendMask != NULL ? blendMask : blackLevelMask;
+    if (base == NULL)
+        return NULL;
+
+    std::size_t width = base->getWidth();
+    std::size_t height = base->getHeight();
+    std::size_t bpc = 1;
+    for (std::size_t i = 0; i < 2; i++)
+        if (masks[i] != NULL && masks[i]->getBytesPerChannel() == 2)
+            bpc = 2;
+
+    Image * combined = new Image();
+    combined->setSize(width, height);
+    combined->setChannels(4);
+    combined->setBytesPerChannel(bpc);
+    if (!combined->allocateOrResizeData())
+    {
+        delete combined;
+        return NULL;
+    }
+
+    bool gray = true;
+    for (std::size_t y = 0; y < height; y++)
+    {
+        float t = (static_cast<float>(y) + 0.5f) / static_cast<float>(height);
+        for (std::size_t x = 0; x < width; x++)
+        {
+            float s = (static_cast<float>(x) + 0.5f) / static_cast<float>(width);
+
+            glm::vec4 blend(1.0f);
+            if (blendMask != NULL)
+                blend = blendMask == base ? readTexel(blendMask, x, y) : readSample(blendMask, s, t);
+
+            glm::vec4 blackLevel(0.0f);
+            if (blackLevelMask != NULL)
+            {
+                blackLevel = blackLevelMask == base ? readTexel(blackLevelMask, x, y) : readSample(blackLevelMask, s, t);
+                if (fabsf(blackLevel.r - blackLevel.g) > 0.5f / 255.0f || fabsf(blackLevel.r - blackLevel.b) > 0.5f / 255.0f)
+                    gray = false;
+            }
+
+            glm::vec4 c = combineSamples(blend, blackLevel);
+            unsigned char * p = combined->getSampleAt(x, y);
+            writeChannel(p, bpc, c.b);
+            writeChannel(p + bpc, bpc, c.g);
+            writeChannel(p + 2 * bpc, bpc, c.r);
+            writeChannel(p + 3 * bpc, bpc, c.a);
+        }
+    }
+
+    if (!gray)
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING,
+            "MaskCombiner: Black level mask '%s' isn't gray, the mean of its color channels is used.\n", blackLevelMask->getFilename());
+
+    return combined;
+}
@@ -10,15 +10,87 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <sgct/ClusterManager.h>
 #include <sgct/SGCTMutexManager.h>
 #include <sgct/helpers/SGCTPortedFunctions.h>
+#include <sgct/helpers/SGCTThreadRing.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <iostream>
 #include <sstream>
 #include <string.h>
 #include <time.h>
+#include <algorithm>
+#include <chrono>
 
 sgct::MessageHandler * sgct::MessageHandler::mInstance = NULL;
 
+namespace
+{
+    //size in bytes of each thread's async ring, must be a power of two
+    const std::size_t gAsyncRingSize = 128 * 1024;
+    //the log thread wakes up at least this often to write pending messages
+    const int gAsyncFlushInterval = 100; //ms
+    //size of the fixed part of a forwarded record: node id, level, frame, message id, count and text length
+    const std::size_t gForwardRecordHeaderSize = 6 * sizeof(uint32_t);
+
+    //FNV-1a hash of the format string identifies a message independent of its arguments
+    unsigned int messageIdFromFormat(const char * fmt)
+    {
+        unsigned int hash = 2166136261u;
+        for (const unsigned char * c = reinterpret_cast<const unsigned char *>(fmt); *c != '\0'; c++)
+        {
+            hash ^= *c;
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    double getSteadyTime()
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void appendUInt32(std::vector<char> & buffer, uint32_t value)
+    {
+        const char * p = reinterpret_cast<const char *>(&value);
+        buffer.insert(buffer.end(), p, p + sizeof(uint32_t));
+    }
+
+    uint32_t readUInt32(const char * data)
+    {
+        uint32_t value;
+        memcpy(&value, data, sizeof(uint32_t));
+        return value;
+    }
+
+    //incremented for each MessageHandler so that threads don't reuse rings of a destroyed instance
+    std::atomic<unsigned int> gAsyncGeneration(0);
+    //set on the log thread
+    thread_local bool gIsAsyncLogThread = false;
+}
+
+/*!
+Byte ring of a thread's messages, each record is a header followed by the text. The owning thread appends records and the log thread consumes them.
+*/
+struct sgct::MessageHandler::AsyncRing : public sgct_helpers::ThreadRing<char>
+{
+    struct Header
+    {
+        unsigned long long sequence;
+        long long time;
+        std::size_t length;
+    };
+
+    AsyncRing() : sgct_helpers::ThreadRing<char>(gAsyncRingSize) {}
+};
+
+struct sgct::MessageHandler::AsyncRecord
+{
+    unsigned long long sequence;
+    time_t time;
+    std::string text;
+
+    bool operator<(const AsyncRecord & rhs) const { return sequence < rhs.sequence; }
+};
+
 sgct::MessageHandler::MessageHandler(void)
 {
     mMaxMessageSize = 2048;
@@ -58,11 +130,30 @@ sgct::MessageHandler::MessageHandler(void)
     mLogToCallback = false;
     mMessageCallback = SGCT_NULL_PTR;
 
+    mAsyncThread = NULL;
+    mLogAsync = false;
+    mAsyncRunning = false;
+    mOverflowPolicy = DropMessages;
+    mAsyncSequence = 0;
+    mAsyncPasses = 0;
+    mAsyncGeneration = ++gAsyncGeneration;
+    mAsyncFile = NULL;
+    mAsyncFileSize = 0;
+    mMaxLogFileSize = 0;
+    mMaxLogFiles = 0;
+
+    mForwardRateLimit = 10;
+    mForwardFrame = 0;
+
     setLogPath(NULL);
 }
 
 sgct::MessageHandler::~MessageHandler(void)
 {
+    //writes all pending messages before the callback is removed
+    setLogAsync(false);
+    mAsyncRings.clear();
+
     mMessageCallback = SGCT_NULL_PTR;
 
     if(mParseBuffer)
@@ -81,18 +172,125 @@ sgct::MessageHandler::~MessageHandler(void)
     mRecBuffer.clear();
 }
 
+/*!
+Decodes a batch of forwarded messages from a slave. The records are aggregated by text and printed by printForwardedMessages.
+*/
 void sgct::MessageHandler::decode(const char * receivedData, int receivedlength, int clientIndex)
 {
     SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::DataSyncMutex );
-        mRecBuffer.clear();
-        mRecBuffer.insert(mRecBuffer.end(), receivedData, receivedData + receivedlength);
-        mRecBuffer.push_back('\0');
-        print("\n[client %d]: %s [end]\n", clientIndex, &mRecBuffer[0]);
+    
+    std::size_t pos = 0;
+    const std::size_t length = receivedlength > 0 ? static_cast<std::size_t>(receivedlength) : 0;
+    while (pos + gForwardRecordHeaderSize <= length)
+    {
+        const char * record = receivedData + pos;
+        int nodeId = static_cast<int>(readUInt32(record));
+        int level = static_cast<int>(readUInt32(record + 4));
+        unsigned int frame = readUInt32(record + 8);
+        unsigned int count = readUInt32(record + 16);
+        std::size_t textLength = readUInt32(record + 20);
+
+        pos += gForwardRecordHeaderSize;
+        if (pos + textLength > length)
+        {
+            fprintf(stderr, "MessageHandler: Corrupt message batch from client %d!\n", clientIndex);
+            break;
+        }
+
+        std::string text(receivedData + pos, textLength);
+        pos += textLength;
+
+        std::map<std::string, ForwardAggregate>::iterator it = mAggregates.find(text);
+        if (it == mAggregates.end())
+        {
+            ForwardAggregate aggregate;
+            aggregate.level = level;
+            aggregate.firstFrame = frame;
+            aggregate.count = 0;
+            it = mAggregates.insert(std::make_pair(text, aggregate)).first;
+            mAggregateOrder.push_back(text);
+        }
+
+        it->second.count += count;
+        it->second.nodes.insert(nodeId);
+        if (frame < it->second.firstFrame)
+            it->second.firstFrame = frame;
+    }
+    
     SGCTMutexManager::instance()->unlockMutex( SGCTMutexManager::DataSyncMutex );
 }
 
-void sgct::MessageHandler::printv(const char *fmt, va_list ap)
+/*!
+Prints the messages received from the slaves since the last call. Messages reported by several nodes are printed once
+as "N nodes reported X". Called by the master once per frame when all slaves have acknowledged the frame.
+*/
+void sgct::MessageHandler::printForwardedMessages()
 {
+    std::vector<std::string> order;
+    std::map<std::string, ForwardAggregate> aggregates;
+
+    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::DataSyncMutex );
+    order.swap(mAggregateOrder);
+    aggregates.swap(mAggregates);
+    SGCTMutexManager::instance()->unlockMutex( SGCTMutexManager::DataSyncMutex );
+
+    for (std::size_t i = 0; i < order.size(); i++)
+    {
+        const ForwardAggregate & aggregate = aggregates[order[i]];
+        if (aggregate.level > getNotifyLevel())
+            continue;
+
+        //the suffix goes before the line break of the message
+        std::string text = order[i];
+        while (!text.empty() && (text[text.size() - 1] == '\n' || text[text.size() - 1] == '\r'))
+            text.erase(text.size() - 1);
+
+        std::stringstream suffix;
+        if (aggregate.count > aggregate.nodes.size())
+            suffix << " (" << aggregate.count << " times)";
+
+        if (aggregate.nodes.size() == 1)
+        {
+            print("[node %d, frame %u]: %s%s\n", *aggregate.nodes.begin(), aggregate.firstFrame, text.c_str(), suffix.str().c_str());
+        }
+        else
+        {
+            std::stringstream nodes;
+            for (std::set<int>::const_iterator it = aggregate.nodes.begin(); it != aggregate.nodes.end(); ++it)
+                nodes << (it == aggregate.nodes.begin() ? "" : ",") << *it;
+
+            print("%u nodes reported [nodes %s, frame %u]: %s%s\n", static_cast<unsigned int>(aggregate.nodes.size()),
+                nodes.str().c_str(), aggregate.firstFrame, text.c_str(), suffix.str().c_str());
+        }
+    }
+}
+
+void sgct::MessageHandler::printv(NotifyLevel nl, const char *fmt, va_list ap)
+{
+    if (mLogAsync)
+    {
+        //format on the calling thread since the arguments may not outlive the call
+        static thread_local std::vector<char> formatBuffer(256);
+
+        va_list apCopy;
+        va_copy(apCopy, ap);
+        int length = vsnprintf(&formatBuffer[0], formatBuffer.size(), fmt, apCopy);
+        va_end(apCopy);
+
+        if (length < 0)
+            return;
+
+        if (static_cast<std::size_t>(length) >= formatBuffer.size())
+        {
+            formatBuffer.resize(static_cast<std::size_t>(length) + 1);
+            vsnprintf(&formatBuffer[0], formatBuffer.size(), fmt, ap);
+        }
+
+        pushAsync(&formatBuffer[0], static_cast<std::size_t>(length));
+        forwardMessage(nl, fmt, &formatBuffer[0]);
+        return;
+    }
+
     //prevent writing to console simultaneously
     SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::ConsoleMutex );
 
@@ -157,7 +355,7 @@ void sgct::MessageHandler::printv(const char *fmt, va_list ap)
     SGCTMutexManager::instance()->unlockMutex( SGCTMutexManager::ConsoleMutex );
 
     //if client send to server
-    sendMessageToServer(mParseBuffer);
+    forwardMessage(nl, fmt, mParseBuffer);
 }
 
 void sgct::MessageHandler::logToFile(const char * buffer)
@@ -223,6 +421,7 @@ void sgct::MessageHandler::setLogPath(const char * path, int nodeId)
         ss << tmpBuff << ".txt";
 #endif
 
+    std::unique_lock<std::mutex> lock(mAsyncMutex);
     mFilename.assign(ss.str());
 }
 
@@ -239,7 +438,8 @@ void sgct::MessageHandler::print(const char *fmt, ...)
 
     va_list        ap;        // Pointer To List Of Arguments
     va_start(ap, fmt);    // Parses The String For Variables
-    printv(fmt, ap);
+    //messages without a notify level are always printed
+    printv(NOTIFY_ERROR, fmt, ap);
     va_end(ap);
 }
 
@@ -258,7 +458,7 @@ void sgct::MessageHandler::print(NotifyLevel nl, const char *fmt, ...)
 
     va_list        ap;        // Pointer To List Of Arguments
     va_start(ap, fmt);    // Parses The String For Variables
-    printv(fmt, ap);
+    printv(nl, fmt, ap);
     va_end(ap);
 }
 
@@ -381,7 +581,7 @@ void sgct::MessageHandler::printDebug(NotifyLevel nl, const char *fmt, ...)
 
     va_list ap;
     va_start(ap, fmt);    // Parses The String For Variables
-    printv(fmt, ap);
+    printv(nl, fmt, ap);
     va_end(ap);
 #endif
 }
@@ -404,13 +604,13 @@ void sgct::MessageHandler::printIndent(NotifyLevel nl, unsigned int indentation,
 
         const char *fmtIndented = fmtComplete.c_str();
         va_start(ap, fmt);    // Parses The String For Variables
-        printv(fmtIndented, ap);
+        printv(nl, fmtIndented, ap);
         va_end(ap);
     }
     else
     {
         va_start(ap, fmt);    // Parses The String For Variables
-        printv(fmt, ap);
+        printv(nl, fmt, ap);
         va_end(ap);
     }
 }
@@ -420,18 +620,520 @@ void sgct::MessageHandler::sendMessageToServer(const char * str)
     if( str == NULL)
         return;
 
-    //if client send to server
-    if(!mLocal)
+    forwardMessage(NOTIFY_ERROR, str, str);
+}
+
+/*!
+Queues a message for the master if this is a client. Messages with the same format string are identified by the same
+message id. Repeats within a frame are counted instead of queued and at most the rate limit of messages per id and
+second are sent, the rest are counted and reported when the second has passed.
+*/
+void sgct::MessageHandler::forwardMessage(NotifyLevel nl, const char * fmt, const char * str)
+{
+    if (mLocal || fmt == NULL || str == NULL)
+        return;
+
+    unsigned int messageId = messageIdFromFormat(fmt);
+    double now = getSteadyTime();
+
+    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::DataSyncMutex );
+
+    bool queued = false;
+    for (std::size_t i = 0; i < mForwardRecords.size() && !queued; i++)
+        if (mForwardRecords[i].messageId == messageId)
+        {
+            mForwardRecords[i].count++;
+            queued = true;
+        }
+
+    if (!queued)
+    {
+        std::map<unsigned int, ForwardRate>::iterator it = mForwardRates.find(messageId);
+        if (it == mForwardRates.end())
+        {
+            ForwardRate rate;
+            rate.windowStart = now;
+            rate.sent = 0;
+            rate.suppressed = 0;
+            it = mForwardRates.insert(std::make_pair(messageId, rate)).first;
+        }
+
+        ForwardRate & rate = it->second;
+        if (rate.sent < mForwardRateLimit)
+        {
+            rate.sent++;
+
+            ForwardRecord record;
+            record.messageId = messageId;
+            record.level = nl;
+            record.frame = mForwardFrame;
+            record.count = 1;
+            record.text.assign(str);
+            mForwardRecords.push_back(record);
+        }
+        else
+        {
+            rate.suppressed++;
+            rate.level = nl;
+            rate.lastText.assign(str);
+        }
+    }
+
+    SGCTMutexManager::instance()->unlockMutex( SGCTMutexManager::DataSyncMutex );
+}
+
+/*!
+Serializes the queued messages into the batch that is sent to the master with the acknowledge of the given frame.
+Messages that don't fit in maxSize bytes are kept for the next frame.
+
+\param prefix optional data that is placed between the header and the messages
+*/
+void sgct::MessageHandler::buildForwardBatch(int frame, std::size_t maxSize, const char * prefix, std::size_t prefixSize)
+{
+    if (mLocal)
     {
         SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::DataSyncMutex );
-        if(mBuffer.empty())
-            mBuffer.insert(mBuffer.begin(), headerSpace, headerSpace+sgct_core::SGCTNetwork::mHeaderSize);
-        mBuffer.insert(mBuffer.end(), str, str + strlen(str));
+        mBuffer.clear();
+        mBuffer.insert(mBuffer.begin(), headerSpace, headerSpace + sgct_core::SGCTNetwork::mHeaderSize);
+        if (prefix != NULL)
+            mBuffer.insert(mBuffer.end(), prefix, prefix + prefixSize);
         SGCTMutexManager::instance()->unlockMutex( SGCTMutexManager::DataSyncMutex );
+        return;
+    }
+
+    const int nodeId = sgct_core::ClusterManager::instance()->getThisNodeId();
+    double now = getSteadyTime();
+
+    SGCTMutexManager::instance()->lockMutex( SGCTMutexManager::DataSyncMutex );
+
+    mForwardFrame = static_cast<unsigned int>(frame);
+
+    //report the messages suppressed by the rate limit when their window has passed
+    std::map<unsigned int, ForwardRate>::iterator it = mForwardRates.begin();
+    while (it != mForwardRates.end())
+    {
+        ForwardRate & rate = it->second;
+        if (now - rate.windowStart < 1.0)
+        {
+            ++it;
+            continue;
+        }
+
+        if (rate.suppressed > 0)
+        {
+            ForwardRecord record;
+            record.messageId = it->first;
+            record.level = rate.level;
+            record.frame = mForwardFrame;
+            record.count = rate.suppressed;
+            record.text.swap(rate.lastText);
+            mForwardRecords.push_back(record);
+        }
+
+        //forget ids that are no longer logged
+        if (rate.sent == 0 && rate.suppressed == 0)
+        {
+            mForwardRates.erase(it++);
+        }
+        else
+        {
+            rate.windowStart = now;
+            rate.sent = 0;
+            rate.suppressed = 0;
+            ++it;
+        }
+    }
+
+    mBuffer.clear();
+    mBuffer.insert(mBuffer.begin(), headerSpace, headerSpace + sgct_core::SGCTNetwork::mHeaderSize);
+    if (prefix != NULL)
+        mBuffer.insert(mBuffer.end(), prefix, prefix + prefixSize);
+
+    std::size_t numberOfSent = 0;
+    for (; numberOfSent < mForwardRecords.size(); numberOfSent++)
+    {
+        const ForwardRecord & record = mForwardRecords[numberOfSent];
+        if (mBuffer.size() + gForwardRecordHeaderSize + record.text.size() > maxSize)
+            break;
+
+        appendUInt32(mBuffer, static_cast<uint32_t>(nodeId));
+        appendUInt32(mBuffer, static_cast<uint32_t>(record.level));
+        appendUInt32(mBuffer, record.frame);
+        appendUInt32(mBuffer, record.messageId);
+        appendUInt32(mBuffer, record.count);
+        appendUInt32(mBuffer, static_cast<uint32_t>(record.text.size()));
+        mBuffer.insert(mBuffer.end(), record.text.begin(), record.text.end());
     }
+
+    //a single message larger than the buffer is dropped
+    if (numberOfSent == 0 && !mForwardRecords.empty())
+        numberOfSent = 1;
+
+    mForwardRecords.erase(mForwardRecords.begin(), mForwardRecords.begin() + numberOfSent);
+
+    SGCTMutexManager::instance()->unlockMutex( SGCTMutexManager::DataSyncMutex );
+}
+
+/*!
+Set the maximum number of messages with the same format string that a client sends to the master per second. Further
+messages are counted and reported as one message. The default is 10.
+*/
+void sgct::MessageHandler::setForwardRateLimit(unsigned int maxMessagesPerSecond)
+{
+    mForwardRateLimit = maxMessagesPerSecond;
 }
 
 void sgct::MessageHandler::setSendFeedbackToServer(bool state)
 {
     mLocal.store(!state);
 }
+
+/*!
+Enables asynchronous logging. Messages are then formatted on the calling thread and copied into a lock-free
+ring owned by that thread. A background thread merges the rings in message order and writes them in batches to the
+console, to a log file that is kept open, and to the log callback. The callback is therefore invoked from the log
+thread in async mode.
+
+Disabling async logging writes all pending messages before returning.
+*/
+void sgct::MessageHandler::setLogAsync( bool state )
+{
+    if (state == mLogAsync.load())
+        return;
+
+    if (state)
+    {
+        mAsyncRunning = true;
+        mAsyncThread = new (std::nothrow) std::thread(&sgct::MessageHandler::asyncLoop, this);
+        mLogAsync = (mAsyncThread != NULL);
+    }
+    else
+    {
+        mLogAsync = false;
+        {
+            std::unique_lock<std::mutex> lock(mAsyncMutex);
+            mAsyncRunning = false;
+        }
+        mAsyncCondition.notify_all();
+
+        if (mAsyncThread)
+        {
+            mAsyncThread->join();
+            delete mAsyncThread;
+            mAsyncThread = NULL;
+        }
+
+        closeAsyncFile();
+    }
+}
+
+/*!
+Get if asynchronous logging is enabled
+*/
+bool sgct::MessageHandler::getLogAsync()
+{
+    return mLogAsync.load();
+}
+
+/*!
+Set what happens when a thread logs faster than the log thread can write in async mode. The default is to drop the
+new messages, which never stalls the calling thread. The number of dropped messages is written to the log.
+*/
+void sgct::MessageHandler::setAsyncOverflowPolicy( OverflowPolicy policy )
+{
+    mOverflowPolicy = policy;
+}
+
+/*!
+Set size based rotation of the log file in async mode. When the file would grow beyond maxFileSize bytes it is
+renamed to <log>.1, older files are shifted to <log>.2 and so on and at most maxNumberOfFiles old files are kept.
+A max size of zero disables rotation, which is the default.
+*/
+void sgct::MessageHandler::setLogFileRotation(std::size_t maxFileSize, unsigned int maxNumberOfFiles)
+{
+    std::unique_lock<std::mutex> lock(mAsyncMutex);
+    mMaxLogFileSize = maxFileSize;
+    mMaxLogFiles = maxNumberOfFiles;
+}
+
+/*!
+Blocks until all messages logged before the call have been written. Does nothing if async logging is disabled.
+*/
+void sgct::MessageHandler::flush()
+{
+    if (!mLogAsync || gIsAsyncLogThread)
+        return;
+
+    std::unique_lock<std::mutex> lock(mAsyncMutex);
+    //the current pass might have missed the latest messages so wait for the next one to complete
+    unsigned long long target = mAsyncPasses + 2;
+    while (mAsyncPasses < target && mAsyncRunning)
+    {
+        //wake the log thread for every pass instead of waiting for the flush interval
+        mAsyncCondition.notify_all();
+        mAsyncDoneCondition.wait(lock);
+    }
+}
+
+std::shared_ptr<sgct::MessageHandler::AsyncRing> sgct::MessageHandler::getThreadRing()
+{
+    static thread_local sgct_helpers::ThreadRingOwner<AsyncRing> owner;
+
+    if (!owner.hasRing(mAsyncGeneration))
+    {
+        owner.setRing(std::make_shared<AsyncRing>(), mAsyncGeneration);
+
+        std::unique_lock<std::mutex> lock(mAsyncMutex);
+        mAsyncRings.push_back(owner.getRing());
+    }
+
+    return owner.getRing();
+}
+
+void sgct::MessageHandler::pushAsync(const char * str, std::size_t length)
+{
+    std::shared_ptr<AsyncRing> ring = getThreadRing();
+
+    AsyncRing::Header header;
+    header.sequence = mAsyncSequence++;
+    header.time = static_cast<long long>(time(NULL));
+    //messages larger than the ring are truncated
+    header.length = (std::min)(length, gAsyncRingSize - sizeof(AsyncRing::Header));
+
+    const std::size_t recordSize = sizeof(AsyncRing::Header) + header.length;
+    const unsigned long long head = ring->getHead();
+
+    //the log thread must never wait for itself, for example when the log callback prints
+    bool block = mOverflowPolicy == BlockUntilSpace && !gIsAsyncLogThread;
+
+    while (ring->getFreeSpace() < recordSize)
+    {
+        if (!block || !mAsyncRunning)
+        {
+            ring->drop();
+            return;
+        }
+
+        mAsyncCondition.notify_one();
+        std::this_thread::yield();
+    }
+
+    ring->write(head, reinterpret_cast<const char *>(&header), sizeof(AsyncRing::Header));
+    ring->write(head + sizeof(AsyncRing::Header), str, header.length);
+    ring->publish(head + recordSize);
+
+    //wake the log thread early if the ring is filling up
+    if (ring->getUsedSpace() > gAsyncRingSize / 2)
+        mAsyncCondition.notify_one();
+}
+
+void sgct::MessageHandler::asyncLoop()
+{
+    gIsAsyncLogThread = true;
+
+    std::vector<AsyncRecord> records;
+    unsigned int dropped = 0;
+
+    std::unique_lock<std::mutex> lock(mAsyncMutex);
+    while (true)
+    {
+        bool running = mAsyncRunning;
+        if (running)
+            mAsyncCondition.wait_for(lock, std::chrono::milliseconds(gAsyncFlushInterval));
+        running = mAsyncRunning;
+
+        drainAsyncRings(records, dropped);
+
+        lock.unlock();
+        writeAsyncRecords(records, dropped);
+        lock.lock();
+
+        mAsyncPasses++;
+        mAsyncDoneCondition.notify_all();
+
+        if (!running)
+            break;
+    }
+}
+
+//called with mAsyncMutex locked
+void sgct::MessageHandler::drainAsyncRings(std::vector<AsyncRecord> & records, unsigned int & dropped)
+{
+    records.clear();
+    dropped = 0;
+
+    std::vector< std::shared_ptr<AsyncRing> >::iterator it = mAsyncRings.begin();
+    while (it != mAsyncRings.end())
+    {
+        AsyncRing * ring = it->get();
+        //read the abandoned flag first so that no record is missed after the thread exits
+        bool abandoned = ring->isAbandoned();
+        unsigned long long tail = ring->getTail();
+        const unsigned long long head = ring->getPublishedHead();
+
+        while (tail < head)
+        {
+            AsyncRing::Header header;
+            ring->read(tail, reinterpret_cast<char *>(&header), sizeof(AsyncRing::Header));
+
+            AsyncRecord record;
+            record.sequence = header.sequence;
+            record.time = static_cast<time_t>(header.time);
+            record.text.resize(header.length);
+            if (header.length > 0)
+                ring->read(tail + sizeof(AsyncRing::Header), &record.text[0], header.length);
+            records.push_back(record);
+
+            tail += sizeof(AsyncRing::Header) + header.length;
+        }
+
+        ring->release(tail);
+        dropped += ring->takeDropped();
+
+        if (abandoned)
+            it = mAsyncRings.erase(it);
+        else
+            ++it;
+    }
+
+    if (mLogToFile && mAsyncFilename != mFilename)
+    {
+        closeAsyncFile();
+        mAsyncFilename = mFilename;
+    }
+
+    //merge the threads' messages in the order they were logged
+    std::sort(records.begin(), records.end());
+}
+
+void sgct::MessageHandler::writeAsyncRecords(std::vector<AsyncRecord> & records, unsigned int dropped)
+{
+    if (records.empty() && dropped == 0)
+        return;
+
+    std::string batch;
+    char timeBuffer[TIME_BUFFER_SIZE] = { 0 };
+    time_t lastTime = 0;
+    bool showTime = getShowTime();
+
+    if (dropped > 0)
+    {
+        AsyncRecord record;
+        record.sequence = 0;
+        record.time = time(NULL);
+        std::stringstream ss;
+        ss << "MessageHandler: " << dropped << " messages dropped since the log buffer was full!\n";
+        record.text = ss.str();
+        records.push_back(record);
+    }
+
+    for (std::size_t i = 0; i < records.size(); i++)
+    {
+        if (showTime)
+        {
+            if (records[i].time != lastTime || i == 0)
+            {
+                lastTime = records[i].time;
+#if (_MSC_VER >= 1400) //visual studio 2005 or later
+                struct tm timeInfo;
+                if (localtime_s(&timeInfo, &lastTime) == 0)
+                    strftime(timeBuffer, TIME_BUFFER_SIZE, "%X", &timeInfo);
+#else
+                struct tm timeInfo;
+                if (localtime_r(&lastTime, &timeInfo) != NULL)
+                    strftime(timeBuffer, TIME_BUFFER_SIZE, "%X", &timeInfo);
+#endif
+            }
+
+            records[i].text.insert(0, std::string(timeBuffer) + "| ");
+        }
+
+        batch.append(records[i].text);
+    }
+
+    if (mLogToConsole)
+    {
+        SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::ConsoleMutex);
+        std::cerr << batch;
+        SGCTMutexManager::instance()->unlockMutex(SGCTMutexManager::ConsoleMutex);
+    }
+
+    if (mLogToFile)
+        writeAsyncFile(batch);
+
+    if (mLogToCallback && mMessageCallback != SGCT_NULL_PTR)
+        for (std::size_t i = 0; i < records.size(); i++)
+            mMessageCallback(records[i].text.c_str());
+}
+
+//only called from the log thread
+void sgct::MessageHandler::writeAsyncFile(const std::string & batch)
+{
+    std::size_t maxFileSize;
+    unsigned int maxFiles;
+    std::string filename;
+    {
+        std::unique_lock<std::mutex> lock(mAsyncMutex);
+        maxFileSize = mMaxLogFileSize;
+        maxFiles = mMaxLogFiles;
+        filename = mAsyncFilename;
+    }
+
+    if (filename.empty())
+        return;
+
+    if (mAsyncFile != NULL && maxFileSize > 0 && mAsyncFileSize > 0 && mAsyncFileSize + batch.size() > maxFileSize)
+    {
+        closeAsyncFile();
+
+        std::stringstream ss;
+        ss << filename << "." << maxFiles;
+        remove(ss.str().c_str());
+
+        for (unsigned int i = maxFiles; i > 1; i--)
+        {
+            std::stringstream from, to;
+            from << filename << "." << (i - 1);
+            to << filename << "." << i;
+            rename(from.str().c_str(), to.str().c_str());
+        }
+
+        if (maxFiles > 0)
+            rename(filename.c_str(), (filename + ".1").c_str());
+        else
+            remove(filename.c_str());
+    }
+
+    if (mAsyncFile == NULL)
+    {
+#if (_MSC_VER >= 1400) //visual studio 2005 or later
+        if (fopen_s(&mAsyncFile, filename.c_str(), "a") != 0)
+            mAsyncFile = NULL;
+#else
+        mAsyncFile = fopen(filename.c_str(), "a");
+#endif
+        if (mAsyncFile == NULL)
+        {
+            std::cerr << "Failed to open '" << filename << "'!" << std::endl;
+            return;
+        }
+
+        fseek(mAsyncFile, 0, SEEK_END);
+        long pos = ftell(mAsyncFile);
+        mAsyncFileSize = pos > 0 ? static_cast<std::size_t>(pos) : 0;
+    }
+
+    fwrite(batch.c_str(), 1, batch.size(), mAsyncFile);
+    fflush(mAsyncFile);
+    mAsyncFileSize += batch.size();
+}
+
+void sgct::MessageHandler::closeAsyncFile()
+{
+    if (mAsyncFile != NULL)
+    {
+        fclose(mAsyncFile);
+        mAsyncFile = NULL;
+    }
+    mAsyncFileSize = 0;
+}
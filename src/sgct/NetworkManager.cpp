@@ -15,6 +15,7 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <sgct/MessageHandler.h>
 #include <sgct/ClusterManager.h>
 #include <sgct/SharedData.h>
+#include <sgct/ClusterStatistics.h>
 #include <sgct/Engine.h>
 #include <algorithm>
 
@@ -75,6 +76,7 @@ sgct_core::NetworkManager::NetworkManager(NetworkMode nm)
     mIsServer = true;
 
     mExternalControlConnection = NULL;
+    mExternalControlServer = NULL;
 
     mCompress = false;
     mCompressionLevel = Z_BEST_SPEED;
@@ -226,7 +228,7 @@ bool sgct_core::NetworkManager::init()
                 else //bind
                 {
                     sgct_cppxeleven::function< void(const char*, int, int) > callback;
-                    callback = sgct_cppxeleven::bind(&sgct::MessageHandler::decode, sgct::MessageHandler::instance(),
+                    callback = sgct_cppxeleven::bind(&sgct_core::ClusterStatistics::decode, sgct_core::ClusterStatistics::instance(),
                         sgct_cppxeleven::placeholders::_1,
                         sgct_cppxeleven::placeholders::_2,
                         sgct_cppxeleven::placeholders::_3);
@@ -256,7 +258,35 @@ bool sgct_core::NetworkManager::init()
     }
 
     //add connection for external communication
-    if( mIsServer )
+    if( mIsServer && ClusterManager::instance()->getExternalControlMaxClients() > 0 )
+    {
+        if( !ClusterManager::instance()->getExternalControlPort().empty() )
+        {
+            mExternalControlServer = new ExternalControlServer();
+            mExternalControlServer->setMaxClients( ClusterManager::instance()->getExternalControlMaxClients() );
+
+            sgct_cppxeleven::function< void(const char*, int, int) > callback;
+            callback = sgct_cppxeleven::bind(&sgct::Engine::invokeDecodeCallbackForExternalControl, sgct::Engine::instance(),
+                sgct_cppxeleven::placeholders::_1,
+                sgct_cppxeleven::placeholders::_2,
+                sgct_cppxeleven::placeholders::_3);
+            mExternalControlServer->setDecodeFunction(callback);
+
+            sgct_cppxeleven::function< void(bool) > updateCallback;
+            updateCallback = sgct_cppxeleven::bind(&sgct::Engine::invokeUpdateCallbackForExternalControl, sgct::Engine::instance(),
+                sgct_cppxeleven::placeholders::_1);
+            mExternalControlServer->setUpdateFunction(updateCallback);
+
+            if( !mExternalControlServer->init( ClusterManager::instance()->getExternalControlPort() ) )
+            {
+                delete mExternalControlServer;
+                mExternalControlServer = NULL;
+            }
+        }
+        else
+            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "NetworkManager: No port set for external control!\n");
+    }
+    else if( mIsServer )
     {
         if(addConnection( ClusterManager::instance()->getExternalControlPort(),
             "127.0.0.1",
@@ -375,6 +405,14 @@ sgct_core::SGCTNetwork * sgct_core::NetworkManager::getExternalControlPtr()
     return mExternalControlConnection;
 }
 
+/*!
+    \returns the multi-client external control server or NULL if the single connection is used
+*/
+sgct_core::ExternalControlServer * sgct_core::NetworkManager::getExternalControlServerPtr()
+{
+    return mExternalControlServer;
+}
+
 void sgct_core::NetworkManager::transferData(const void * data, int length, int packageId)
 {
     char * buffer = NULL;
@@ -744,6 +782,13 @@ void sgct_core::NetworkManager::close()
     //release condition variables
     gCond.notify_all();
 
+    if( mExternalControlServer != NULL )
+    {
+        mExternalControlServer->close();
+        delete mExternalControlServer;
+        mExternalControlServer = NULL;
+    }
+
     //signal to terminate
     for(unsigned int i=0; i < mNetworkConnections.size(); i++)
         if(mNetworkConnections[i] != NULL)
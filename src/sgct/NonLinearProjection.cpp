@@ -10,6 +10,7 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <sgct/SGCTSettings.h>
 #include <sgct/Engine.h>
 #include <sgct/MessageHandler.h>
+#include <sgct/FrameTrace.h>
 #include <algorithm>
 
 sgct_core::NonLinearProjection::NonLinearProjection()
@@ -27,6 +28,9 @@ sgct_core::NonLinearProjection::NonLinearProjection()
     mVAO = GL_FALSE;
     mSamples = 1;
 
+    mLayered = false;
+    mCubeFacesUBO = GL_FALSE;
+
     mClearColor.r = 0.3f;
     mClearColor.g = 0.3f;
     mClearColor.b = 0.3f;
@@ -75,6 +79,12 @@ sgct_core::NonLinearProjection::~NonLinearProjection()
         mVAO = GL_FALSE;
     }
 
+    if (mCubeFacesUBO)
+    {
+        glDeleteBuffers(1, &mCubeFacesUBO);
+        mCubeFacesUBO = GL_FALSE;
+    }
+
     mShader.deleteProgram();
     mDepthCorrectionShader.deleteProgram();
 }
@@ -92,6 +102,7 @@ void sgct_core::NonLinearProjection::init(int internalTextureFormat, unsigned in
     initViewports();
     initTextures();
     initFBO();
+    initLayeredRendering();
     initVBO();
     initShaders();
 }
@@ -436,6 +447,131 @@ void sgct_core::NonLinearProjection::setupViewport(const std::size_t & face)
         mVpCoords[3]);
 }
 
+/*!
+Sets up the cube map textures and the uniform buffer needed to render all faces in one pass if layered rendering is requested and supported.
+*/
+void sgct_core::NonLinearProjection::initLayeredRendering()
+{
+    mLayered = false;
+    if (!sgct::SGCTSettings::instance()->getUseLayeredCubemapRendering())
+        return;
+
+    //the depth textures are converted face by face and layered multisample cube maps don't exist
+    if (sgct::Engine::instance()->isOGLPipelineFixed() || mCubeMapFBO_Ptr->isMultiSampled() || sgct::SGCTSettings::instance()->useDepthTexture())
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING,
+            "NonLinearProjection: Layered cube map rendering requires the programmable pipeline without MSAA and depth textures. Rendering one face at a time.\n");
+        return;
+    }
+
+    //all attachments of a layered FBO must be layered so the depth render buffer is replaced by a cube map
+    if (mTextures[CubeMapColor] == GL_FALSE)
+        generateCubeMap(CubeMapColor, mTextureInternalFormat, mTextureFormat, mTextureType);
+    if (mTextures[CubeMapDepth] == GL_FALSE)
+        generateCubeMap(CubeMapDepth, GL_DEPTH_COMPONENT32, GL_DEPTH_COMPONENT, GL_FLOAT);
+
+    glGenBuffers(1, &mCubeFacesUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, mCubeFacesUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(CubeFacesBlock), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    if (sgct::Engine::checkForOGLErrors())
+    {
+        mLayered = true;
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "NonLinearProjection: Layered cube map rendering enabled (UBO id: %d).\n", mCubeFacesUBO);
+    }
+    else
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "NonLinearProjection: Error occured while setting up layered cube map rendering!\n");
+}
+
+/*!
+Render all enabled faces of the cube map with a single call to the draw callback. The face matrices are uploaded to the CubeFaces uniform block
+and the cube map is attached as a layered target. The current viewport is set to the first enabled face.
+*/
+void sgct_core::NonLinearProjection::renderLayeredCubemap(std::size_t * subViewPortIndex)
+{
+    sgct::FrameTrace::Scope scope("cubeFacesLayered");
+
+    Frustum::FrustumMode frustumMode = sgct::Engine::instance()->getCurrentFrustumMode();
+    const glm::mat4 & sceneTransform = sgct::Engine::instance()->getModelMatrix();
+
+    CubeFacesBlock block;
+    BaseViewport * firstVp = NULL;
+    for (std::size_t i = 0; i < 6; i++)
+    {
+        BaseViewport * vp = &mSubViewports[i];
+        SGCTProjection * proj = vp->getProjection(frustumMode);
+
+        //all layers share one full face viewport, so the frustums of partially used faces
+        //are mapped to their part of the face (the rest of the face is never sampled)
+        glm::mat4 faceTransform(1.0f);
+        faceTransform[0][0] = vp->getXSize();
+        faceTransform[1][1] = vp->getYSize();
+        faceTransform[3][0] = 2.0f * vp->getX() + vp->getXSize() - 1.0f;
+        faceTransform[3][1] = 2.0f * vp->getY() + vp->getYSize() - 1.0f;
+
+        block.faceMVP[i] = faceTransform * proj->getViewProjectionMatrix() * sceneTransform;
+        block.faceMV[i] = proj->getViewMatrix() * sceneTransform;
+        block.faceEnabled[i] = glm::ivec4(vp->isEnabled() ? 1 : 0);
+
+        if (vp->isEnabled() && firstVp == NULL)
+        {
+            firstVp = vp;
+            *subViewPortIndex = i;
+        }
+    }
+
+    if (firstVp == NULL)
+        return;
+
+    glBindBuffer(GL_UNIFORM_BUFFER, mCubeFacesUBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(CubeFacesBlock), &block);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, sgct::SGCTSettings::instance()->getLayeredCubemapUniformBlockBinding(), mCubeFacesUBO);
+
+    //bind & attach buffer
+    mCubeMapFBO_Ptr->bind(); //osg seems to unbind FBO when rendering with osg FBO cameras
+    mCubeMapFBO_Ptr->attachLayeredTexture(mTextures[CubeMapColor]);
+    if (sgct::SGCTSettings::instance()->useNormalTexture())
+        mCubeMapFBO_Ptr->attachLayeredTexture(mTextures[CubeMapNormals], GL_COLOR_ATTACHMENT1);
+    if (sgct::SGCTSettings::instance()->usePositionTexture())
+        mCubeMapFBO_Ptr->attachLayeredTexture(mTextures[CubeMapPositions], GL_COLOR_ATTACHMENT2);
+    mCubeMapFBO_Ptr->attachLayeredDepthTexture(mTextures[CubeMapDepth]);
+
+    sgct::Engine::mInstance->getCurrentWindowPtr()->setCurrentViewport(firstVp);
+
+    glLineWidth(1.0);
+    sgct::Engine::instance()->getWireframe() ? glPolygonMode(GL_FRONT_AND_BACK, GL_LINE) : glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+
+    //reset depth function (to opengl default)
+    glDepthFunc(GL_LESS);
+
+    mVpCoords[0] = 0;
+    mVpCoords[1] = 0;
+    mVpCoords[2] = mCubemapResolution;
+    mVpCoords[3] = mCubemapResolution;
+    glViewport(0, 0, mCubemapResolution, mCubemapResolution);
+    glScissor(0, 0, mCubemapResolution, mCubemapResolution);
+
+    //clears all layers
+    glEnable(GL_SCISSOR_TEST);
+    if (sgct::Engine::mInstance->mClearBufferFnPtr != SGCT_NULL_PTR)
+        sgct::Engine::mInstance->mClearBufferFnPtr();
+    else
+    {
+        const float * colorPtr = sgct::Engine::instance()->getClearColor();
+        glClearColor(colorPtr[0], colorPtr[1], colorPtr[2], colorPtr[3]);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    }
+    glDisable(GL_SCISSOR_TEST);
+
+    //render
+    sgct::Engine::mInstance->mDrawFnPtr();
+
+    //restore polygon mode
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+}
+
 void sgct_core::NonLinearProjection::generateMap(TextureIndex ti, int internalFormat, unsigned int format, unsigned int type)
 {
     if (mTextures[ti] != GL_FALSE)
@@ -374,6 +374,23 @@ void sgct_core::OffScreenBuffer::attachCubeMapDepthTexture(unsigned int texId, u
     glFramebufferTexture2D( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, texId, 0);
 }
 
+/*!
+Attach all layers of a cube map or array texture. The layer is selected with gl_Layer in a geometry shader
+(or the vertex shader if supported). All attachments must be layered when this is used.
+
+@param texId GL id of the texture to attach
+@param attachment the gl attachment enum in the form of GL_COLOR_ATTACHMENTi
+*/
+void sgct_core::OffScreenBuffer::attachLayeredTexture(unsigned int texId, GLenum attachment)
+{
+    glFramebufferTexture(GL_FRAMEBUFFER, attachment, texId, 0);
+}
+
+void sgct_core::OffScreenBuffer::attachLayeredDepthTexture(unsigned int texId)
+{
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texId, 0);
+}
+
 /*!
 @returns the opengl internal texture format of the color buffer 
 */
@@ -11,8 +11,15 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <sgct/SGCTWindow.h>
 #include <sgct/Engine.h>
 #include <sgct/PostFX.h>
+#include <sgct/PostFXGraph.h>
+#include <sgct/shaders/SGCTInternalShaders.h>
+#include <sgct/shaders/SGCTInternalShaders_modern.h>
+#include <sgct/helpers/SGCTStringFunctions.h>
+#include <fstream>
+#include <sstream>
 
 bool sgct::PostFX::mDeleted = false;
+sgct::ShaderProgram * sgct::PostFX::mCurrentShaderProgram = NULL;
 
 /*!
     Default constructor (doesn't require an OpenGL context)
@@ -27,6 +34,9 @@ sgct::PostFX::PostFX()
 
     mXSize = 1;
     mYSize = 1;
+
+    mEnabled = true;
+    mPerPixel = false;
 }
 
 /*!
@@ -63,6 +73,48 @@ bool sgct::PostFX::init( const std::string & name, const std::string & vertShade
     return true;
 }
 
+/*!
+    Creates a pass that only computes the color of each pixel from the color of the same pixel in the input, such as color grading,
+    tone mapping or vignetting. The effect source defines the function
+
+    \code
+    vec4 effect(vec4 color, vec2 uv)
+    \endcode
+
+    without any version directive, which gets the input color and texture coordinate and returns the output color. Consecutive per-pixel
+    passes are fused into a single shader and rendered in one full-screen pass, so any uniforms they declare must have unique names.
+    As the fused shader is a different program, uniform locations must be looked up in the update function using getCurrentShaderProgram.
+
+    \returns true if the shader was created successfully
+*/
+bool sgct::PostFX::initPerPixel( const std::string & name, const std::string & effectSrc, ShaderProgram::ShaderSourceType srcType )
+{
+    if( srcType == ShaderProgram::SHADER_SRC_FILE )
+    {
+        std::ifstream file( effectSrc.c_str() );
+        if( !file.is_open() )
+        {
+            MessageHandler::instance()->print( MessageHandler::NOTIFY_ERROR, "PostFX: Pass '%s' failed to open effect file '%s'.\n", name.c_str(), effectSrc.c_str() );
+            return false;
+        }
+
+        std::stringstream ss;
+        ss << file.rdbuf();
+        mEffectSrc = ss.str();
+    }
+    else
+        mEffectSrc = effectSrc;
+
+    bool fixedPipeline = sgct::Engine::instance()->isOGLPipelineFixed();
+    std::string vertShader = fixedPipeline ? sgct_core::shaders::Overlay_Vert_Shader : sgct_core::shaders_modern::Overlay_Vert_Shader;
+    std::string fragShader = sgct_core::PostFXGraph::generateFragmentShader( std::vector<std::string>(1, mEffectSrc), fixedPipeline );
+    sgct_helpers::findAndReplace( vertShader, "**glsl_version**", sgct::Engine::instance()->getGLSLVersion() );
+    sgct_helpers::findAndReplace( fragShader, "**glsl_version**", sgct::Engine::instance()->getGLSLVersion() );
+
+    mPerPixel = true;
+    return init( name, vertShader, fragShader, ShaderProgram::SHADER_SRC_STRING );
+}
+
 void sgct::PostFX::destroy()
 {
     MessageHandler::instance()->print( MessageHandler::NOTIFY_INFO, "PostFX: Pass '%s' destroying shader and texture...\n", mName.c_str() );
@@ -86,6 +138,32 @@ void sgct::PostFX::render()
         (this->*mRenderFn)();
 }
 
+/*!
+    Calls the update uniforms function with the shader program that renders this pass bound
+*/
+void sgct::PostFX::updateUniforms()
+{
+    if( mUpdateFn != NULL )
+        mUpdateFn();
+}
+
+/*!
+    Set if this pass should be rendered, a disabled pass is left out of the chain and its input is passed on to the next pass
+*/
+void sgct::PostFX::setEnabled( bool state )
+{
+    mEnabled = state;
+}
+
+/*!
+    \returns the shader program that renders the current pass, which is the fused program for per-pixel passes rendered together.
+    Only valid in the update uniforms function.
+*/
+sgct::ShaderProgram * sgct::PostFX::getCurrentShaderProgram()
+{
+    return mCurrentShaderProgram;
+}
+
 void sgct::PostFX::setUpdateUniformsFunction( void(*fnPtr)() )
 {
     mUpdateFn = fnPtr;
@@ -101,6 +179,42 @@ void sgct::PostFX::setOutputTexture( unsigned int outputTex )
     mOutputTexture = outputTex;
 }
 
+/*!
+    Renders several per-pixel passes of a window in one full-screen pass with a fused shader program (see sgct_core::PostFXGraph).
+    The update uniforms functions of the passes are called in order with the fused program bound.
+*/
+void sgct::PostFX::renderFused( ShaderProgram * program, SGCTWindow * win, const std::vector<std::size_t> & passes, unsigned int inputTex, unsigned int outputTex )
+{
+    for( std::size_t i = 0; i < passes.size(); i++ )
+    {
+        win->getPostFXPtr( passes[i] )->setInputTexture( inputTex );
+        win->getPostFXPtr( passes[i] )->setOutputTexture( outputTex );
+    }
+
+    //bind target FBO
+    win->mFinalFBO_Ptr->attachColorTexture( outputTex );
+
+    glViewport(0, 0, win->getXFramebufferResolution(), win->getYFramebufferResolution());
+    
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, inputTex );
+
+    program->bind();
+
+    mCurrentShaderProgram = program;
+    for( std::size_t i = 0; i < passes.size(); i++ )
+        win->getPostFXPtr( passes[i] )->updateUniforms();
+
+    win->bindVAO();
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    win->unbindVAO();
+
+    ShaderProgram::unbind();
+}
+
 void sgct::PostFX::internalRender()
 {
     sgct::SGCTWindow * win = sgct_core::ClusterManager::instance()->getThisNodePtr()->getCurrentWindowPtr();
@@ -122,8 +236,8 @@ void sgct::PostFX::internalRender()
 
     mShaderProgram.bind();
 
-    if( mUpdateFn != NULL )
-        mUpdateFn();
+    mCurrentShaderProgram = &mShaderProgram;
+    updateUniforms();
 
     win->bindVAO();
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -159,8 +273,8 @@ void sgct::PostFX::internalRenderFixedPipeline()
 
     mShaderProgram.bind();
 
-    if( mUpdateFn != NULL )
-        mUpdateFn();
+    mCurrentShaderProgram = &mShaderProgram;
+    updateUniforms();
 
     glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
 
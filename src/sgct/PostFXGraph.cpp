@@ -0,0 +1,146 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#include <sgct/PostFXGraph.h>
+#include <sstream>
+
+sgct_core::PostFXGraph::PostFXGraph()
+{
+    mFXAA = false;
+    mFuse = false;
+    mValid = false;
+    mNumberOfPoolBuffers = 0;
+}
+
+/*!
+Rebuilds the stages if the passes or settings differ from the last call.
+
+@param passes the post effect passes of the window in the order they were added
+@param fxaa if FXAA is applied after the passes
+@param fuse if consecutive per-pixel passes should be fused into one stage
+\returns true if the stages were rebuilt
+*/
+bool sgct_core::PostFXGraph::update(const std::vector<Pass> & passes, bool fxaa, bool fuse)
+{
+    bool changed = !mValid || fxaa != mFXAA || fuse != mFuse || passes.size() != mPasses.size();
+    for (std::size_t i = 0; i < passes.size() && !changed; i++)
+        changed = passes[i].enabled != mPasses[i].enabled || passes[i].perPixel != mPasses[i].perPixel;
+
+    if (!changed)
+        return false;
+
+    mPasses = passes;
+    mFXAA = fxaa;
+    mFuse = fuse;
+    build();
+    mValid = true;
+    return true;
+}
+
+/*!
+Removes all stages, the next update rebuilds them.
+*/
+void sgct_core::PostFXGraph::clear()
+{
+    mPasses.clear();
+    mStages.clear();
+    mNumberOfPoolBuffers = 0;
+    mValid = false;
+}
+
+void sgct_core::PostFXGraph::build()
+{
+    mStages.clear();
+
+    bool fusing = false; //the last stage is open for more per-pixel passes
+    for (std::size_t i = 0; i < mPasses.size(); i++)
+    {
+        if (!mPasses[i].enabled)
+            continue;
+
+        if (fusing && mPasses[i].perPixel)
+            mStages.back().passes.push_back(i);
+        else
+        {
+            Stage stage;
+            stage.passes.push_back(i);
+            stage.fxaa = false;
+            mStages.push_back(stage);
+        }
+
+        fusing = mFuse && mPasses[i].perPixel;
+    }
+
+    //FXAA samples the neighbourhood so it always gets its own stage
+    if (mFXAA || mStages.empty())
+    {
+        Stage stage;
+        stage.fxaa = mFXAA;
+        mStages.push_back(stage);
+    }
+
+    for (std::size_t i = 0; i < mStages.size(); i++)
+    {
+        mStages[i].input = i == 0 ? SourceBuffer : mStages[i - 1].output;
+        if (i == mStages.size() - 1)
+            mStages[i].output = TargetBuffer;
+        else
+            mStages[i].output = i % 2 == 0 ? PoolBuffer0 : PoolBuffer1;
+    }
+
+    mNumberOfPoolBuffers = static_cast<unsigned int>(mStages.size() > 2 ? 2 : mStages.size() - 1);
+}
+
+/*!
+\returns a key that identifies the passes of a stage, used to cache the shaders of fused stages
+*/
+std::string sgct_core::PostFXGraph::getStageKey(const Stage & stage)
+{
+    std::stringstream ss;
+    for (std::size_t i = 0; i < stage.passes.size(); i++)
+        ss << (i == 0 ? "" : ",") << stage.passes[i];
+    return ss.str();
+}
+
+/*!
+Generates the fragment shader of per-pixel passes. Each effect source defines the function
+
+\code
+vec4 effect(vec4 color, vec2 uv)
+\endcode
+
+that returns the color of the pass given the output of the previous pass and the texture coordinate.
+The effects are renamed with the preprocessor so that their functions don't collide, but any uniforms
+they declare must have unique names. The GLSL version is left as **glsl_version**.
+
+@param effects the sources of the effects in the order they are applied
+@param fixedPipeline if the shader is for the fixed pipeline (GLSL 1.2) instead of GLSL 3.3+
+*/
+std::string sgct_core::PostFXGraph::generateFragmentShader(const std::vector<std::string> & effects, bool fixedPipeline)
+{
+    std::stringstream ss;
+    ss << "**glsl_version**\n\n";
+    if (fixedPipeline)
+        ss << "uniform sampler2D Tex;\n\n";
+    else
+        ss << "in vec2 UV;\nout vec4 Color;\n\nuniform sampler2D Tex;\n\n";
+
+    for (std::size_t i = 0; i < effects.size(); i++)
+        ss << "#define effect sgct_effect" << i << "\n" << effects[i] << "\n#undef effect\n\n";
+
+    ss << "void main()\n{\n";
+    if (fixedPipeline)
+        ss << "    vec2 uv = gl_TexCoord[0].st;\n    vec4 color = texture2D(Tex, uv);\n";
+    else
+        ss << "    vec2 uv = UV;\n    vec4 color = texture(Tex, uv);\n";
+
+    for (std::size_t i = 0; i < effects.size(); i++)
+        ss << "    color = sgct_effect" << i << "(color, uv);\n";
+
+    ss << (fixedPipeline ? "    gl_FragColor = color;\n" : "    Color = color;\n") << "}\n";
+    return ss.str();
+}
@@ -18,6 +18,9 @@
 #include <algorithm>
 #include <sstream>
 
+//compiled configurations are cached next to the xml file
+static bool sUseConfigCache = true;
+
 const std::string DefaultSingleConfiguration = "            \
 <?xml version=\"1.0\" ?>                                    \
 <Cluster masterAddress=\"localhost\">                       \
@@ -44,6 +47,9 @@ const std::string DefaultSingleConfiguration = "            \
 sgct_core::ReadConfig::ReadConfig( const std::string filename )
 {
     valid = false;
+    mNodesDeferred = false;
+    mSourceSize = 0;
+    mSourceHash = 0;
     
     if( filename.empty() )
     {
@@ -151,6 +157,19 @@ bool sgct_core::ReadConfig::replaceEnvVars( const std::string &filename )
     return true;
 }
 
+/*!
+Set if XML configurations should be compiled to a cache file next to the XML that is used by all nodes
+as long as the XML doesn't change. Enabled by default.
+*/
+void sgct_core::ReadConfig::setUseCache(bool state)
+{
+    sUseConfigCache = state;
+}
+
+/*
+    Reads the shared parts of the configuration and the node attributes. The windows and viewports
+    are read by readNodeConfiguration once it is known which node this is.
+*/
 bool sgct_core::ReadConfig::readAndParseXMLFile()
 {
     if (xmlFileName.empty())
@@ -158,9 +177,54 @@ bool sgct_core::ReadConfig::readAndParseXMLFile()
         mErrorMsg.assign("No XML file set!");
         return false;
     }
-    
+
+    if( !loadCompiledConfig(mCompiledConfig) )
+        return false;
+
+    CompiledConfig::getSourceHash(xmlFileName, mSourceSize, mSourceHash);
+
+    tinyxml2::XMLDocument xmlDoc;
+    mCompiledConfig.extractShared(xmlDoc);
+    mNodesDeferred = true;
+
+    return readAndParseXML(xmlDoc);
+}
+
+/*
+    Opens the cached compiled configuration if it is up to date, otherwise the XML is parsed and compiled.
+    A compiled configuration can also be used directly as configuration file.
+*/
+bool sgct_core::ReadConfig::loadCompiledConfig(CompiledConfig & config)
+{
+    std::string extension(".sgctc");
+    if( xmlFileName.size() > extension.size() &&
+        xmlFileName.compare(xmlFileName.size() - extension.size(), extension.size(), extension) == 0 )
+    {
+        if( config.open(xmlFileName, "") )
+            return true;
+
+        mErrorMsg.assign("Failed to open compiled configuration");
+        return false;
+    }
+
+    std::string cacheFilename = CompiledConfig::getCacheFilename(xmlFileName);
+    if( sUseConfigCache && config.open(cacheFilename, xmlFileName) )
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "ReadConfig: Using compiled config '%s'.\n", cacheFilename.c_str());
+        return true;
+    }
+
+    //the hash is computed from the same contents that are parsed so that an edit in between isn't missed
+    std::string contents;
+    uint32_t sourceHash;
     tinyxml2::XMLDocument xmlDoc;
-    if( xmlDoc.LoadFile(xmlFileName.c_str()) != tinyxml2::XML_NO_ERROR )
+    if( !CompiledConfig::readSource(xmlFileName, contents, sourceHash) )
+    {
+        mErrorMsg.assign("File not found");
+        return false;
+    }
+
+    if( xmlDoc.Parse(contents.c_str(), contents.size()) != tinyxml2::XML_NO_ERROR )
     {
         std::stringstream ss;
         if (xmlDoc.GetErrorStr1() && xmlDoc.GetErrorStr2())
@@ -174,8 +238,175 @@ bool sgct_core::ReadConfig::readAndParseXMLFile()
         mErrorMsg = ss.str();
         return false;
     }
-    else
-        return readAndParseXML(xmlDoc);
+
+    if( !config.compile(xmlDoc, static_cast<uint64_t>(contents.size()), sourceHash) )
+    {
+        mErrorMsg.assign("Cannot find XML root!");
+        return false;
+    }
+
+    if( sUseConfigCache && !config.save(cacheFilename) )
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "ReadConfig: Failed to write compiled config '%s'.\n", cacheFilename.c_str());
+
+    return true;
+}
+
+/*!
+Reads the windows and viewports of this node. Only the node's own section of the configuration is extracted.
+Does nothing if the whole configuration was already read.
+*/
+bool sgct_core::ReadConfig::readNodeConfiguration(int nodeIndex)
+{
+    if( !mNodesDeferred )
+        return true;
+
+    tinyxml2::XMLDocument xmlDoc;
+    if( nodeIndex < 0 || !mCompiledConfig.extractNode(xmlDoc, static_cast<unsigned int>(nodeIndex)) )
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ReadConfig: Node %d not found in config file '%s'!\n", nodeIndex, xmlFileName.c_str());
+        return false;
+    }
+
+    return readNodeConfiguration(nodeIndex, xmlDoc);
+}
+
+/*!
+Reads the windows and viewports of this node from a document that holds only the node's section of the
+configuration, for example one that was received from the master.
+*/
+bool sgct_core::ReadConfig::readNodeConfiguration(int nodeIndex, tinyxml2::XMLDocument & xmlDoc)
+{
+    if( !mNodesDeferred )
+        return true;
+    mNodesDeferred = false;
+    mCompiledConfig.close();
+
+    SGCTNode * nodePtr = nodeIndex >= 0 ? ClusterManager::instance()->getNodePtr(static_cast<std::size_t>(nodeIndex)) : NULL;
+    tinyxml2::XMLElement * nodeElement = xmlDoc.FirstChildElement("Cluster") != NULL ? xmlDoc.FirstChildElement("Cluster")->FirstChildElement("Node") : NULL;
+    if( nodePtr == NULL || nodeElement == NULL )
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ReadConfig: Node %d not found in config file '%s'!\n", nodeIndex, xmlFileName.c_str());
+        return false;
+    }
+
+    if( !readAndParseNode(nodeElement, *nodePtr) )
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ReadConfig: Error occured while reading config file '%s'\nError: %s\n", xmlFileName.c_str(), mErrorMsg.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+/*!
+Extracts the sections of the first nodes of the configuration into documents with a Cluster root and the single Node element.
+The configuration is loaded once for all nodes.
+
+\param xmlDocs the document of each node, node i is extracted into xmlDocs[i]
+*/
+bool sgct_core::ReadConfig::getNodeDocuments(std::vector<tinyxml2::XMLDocument *> & xmlDocs)
+{
+    if( xmlFileName.empty() )
+        return false;
+
+    CompiledConfig config;
+    if( !loadCompiledConfig(config) )
+        return false;
+
+    for( std::size_t i = 0; i < xmlDocs.size(); i++ )
+        if( !config.extractNode(*xmlDocs[i], static_cast<unsigned int>(i)) )
+        {
+            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ReadConfig: Node %u not found in config file '%s'!\n", static_cast<unsigned int>(i), xmlFileName.c_str());
+            return false;
+        }
+
+    return true;
+}
+
+/*!
+Reads the config file again and applies the planar projection and projection plane of all viewports of the node.
+Other settings, including the viewport position and size, and changes to the number of windows or viewports, require a restart.
+*/
+bool sgct_core::ReadConfig::reloadViewports(int nodeIndex)
+{
+    if( xmlFileName.empty() )
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "ReadConfig: The default configuration can't be reloaded!\n");
+        return false;
+    }
+
+    CompiledConfig config;
+    if( !loadCompiledConfig(config) )
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ReadConfig: Error occured while reloading config file '%s'\nError: %s\n", xmlFileName.c_str(), mErrorMsg.c_str());
+        return false;
+    }
+    CompiledConfig::getSourceHash(xmlFileName, mSourceSize, mSourceHash);
+
+    tinyxml2::XMLDocument xmlDoc;
+    if( nodeIndex < 0 || !config.extractNode(xmlDoc, static_cast<unsigned int>(nodeIndex)) )
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ReadConfig: Node %d not found in config file '%s'!\n", nodeIndex, xmlFileName.c_str());
+        return false;
+    }
+
+    return reloadViewports(nodeIndex, xmlDoc);
+}
+
+/*!
+Applies the planar projection and projection plane of all viewports of the node from a document that holds only the
+node's section of the configuration, for example one that was received from the master.
+*/
+bool sgct_core::ReadConfig::reloadViewports(int nodeIndex, tinyxml2::XMLDocument & xmlDoc)
+{
+    SGCTNode * nodePtr = nodeIndex >= 0 ? ClusterManager::instance()->getNodePtr(static_cast<std::size_t>(nodeIndex)) : NULL;
+    tinyxml2::XMLElement * nodeElement = xmlDoc.FirstChildElement("Cluster") != NULL ? xmlDoc.FirstChildElement("Cluster")->FirstChildElement("Node") : NULL;
+    if( nodePtr == NULL || nodeElement == NULL )
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ReadConfig: Node %d not found in config file '%s'!\n", nodeIndex, xmlFileName.c_str());
+        return false;
+    }
+
+    bool structureChanged = false;
+    std::size_t winIndex = 0;
+    tinyxml2::XMLElement * winElement = nodeElement->FirstChildElement("Window");
+    for( ; winElement != NULL && winIndex < nodePtr->getNumberOfWindows(); winElement = winElement->NextSiblingElement("Window"), winIndex++ )
+    {
+        //viewports of mpcdi windows are defined in the mpcdi file
+        if( winElement->Attribute("mpcdi") != NULL )
+            continue;
+
+        sgct::SGCTWindow * winPtr = nodePtr->getWindowPtr(winIndex);
+        std::size_t vpIndex = 0;
+        tinyxml2::XMLElement * vpElement = winElement->FirstChildElement("Viewport");
+        for( ; vpElement != NULL && vpIndex < winPtr->getNumberOfViewports(); vpElement = vpElement->NextSiblingElement("Viewport"), vpIndex++ )
+            winPtr->getViewport(vpIndex)->reconfigure(vpElement);
+
+        if( vpElement != NULL || vpIndex != winPtr->getNumberOfViewports() )
+            structureChanged = true;
+    }
+
+    if( winElement != NULL || winIndex != nodePtr->getNumberOfWindows() )
+        structureChanged = true;
+
+    if( structureChanged )
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING, "ReadConfig: The number of windows or viewports in '%s' has changed, restart to apply all changes.\n", xmlFileName.c_str());
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_INFO, "ReadConfig: Viewports reloaded from '%s'.\n", xmlFileName.c_str());
+    return true;
+}
+
+/*!
+\param hash is set to the CRC-32 of the config file
+\returns true if the config file was modified since it was read
+*/
+bool sgct_core::ReadConfig::hasSourceChanged(uint32_t & hash)
+{
+    uint64_t size;
+    if( xmlFileName.empty() || !CompiledConfig::getSourceHash(xmlFileName, size, hash) )
+        return false;
+
+    return size != mSourceSize || hash != mSourceHash;
 }
 
 bool sgct_core::ReadConfig::readAndParseXMLString()
@@ -232,6 +463,15 @@ bool sgct_core::ReadConfig::readAndParseXML(tinyxml2::XMLDocument& xmlDoc)
         std::string tmpStr( XMLroot->Attribute( "externalControlPort" ) );
         ClusterManager::instance()->setExternalControlPort(tmpStr);
     }
+
+    if( XMLroot->Attribute( "externalControlClients" ) != NULL )
+    {
+        unsigned int tmpUI = 0;
+        if( XMLroot->QueryUnsignedAttribute( "externalControlClients", &tmpUI ) == tinyxml2::XML_NO_ERROR )
+            ClusterManager::instance()->setExternalControlMaxClients(tmpUI);
+        else
+            sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ReadConfig: Failed to parse external control client count from XML!\n");
+    }
     
     if( XMLroot->Attribute( "firmSync" ) != NULL )
     {
@@ -318,164 +558,8 @@ bool sgct_core::ReadConfig::readAndParseXML(tinyxml2::XMLDocument& xmlDoc)
             if( element[0]->Attribute("swapLock") != NULL )
                 tmpNode.setUseSwapGroups( strcmp( element[0]->Attribute("swapLock"), "true" ) == 0 ? true : false );
             
-            element[1] = element[0]->FirstChildElement();
-            while( element[1] != NULL )
-            {
-                val[1] = element[1]->Value();
-                if( strcmp("Window", val[1]) == 0 )
-                {
-                    sgct::SGCTWindow tmpWin( static_cast<int>(tmpNode.getNumberOfWindows()) );
-                    
-                    if( element[1]->Attribute("name") != NULL )
-                        tmpWin.setName( element[1]->Attribute("name") );
-
-                    if (element[1]->Attribute("tags") != NULL)
-                        tmpWin.setTags(element[1]->Attribute("tags"));
-
-                    if (element[1]->Attribute("bufferBitDepth") != NULL)
-                        tmpWin.setColorBitDepth(getBufferColorBitDepth(element[1]->Attribute("bufferBitDepth")));
-
-                    if (element[1]->Attribute("preferBGR") != NULL)
-                        tmpWin.setPreferBGR(strcmp(element[1]->Attribute("preferBGR"), "true") == 0);
-                        
-                    //compability with older versions
-                    if (element[1]->Attribute("fullScreen") != NULL)
-                        tmpWin.setWindowMode(strcmp(element[1]->Attribute("fullScreen"), "true") == 0);
-
-                    if( element[1]->Attribute("fullscreen") != NULL )
-                        tmpWin.setWindowMode( strcmp( element[1]->Attribute("fullscreen"), "true" ) == 0 );
-                    
-                    if( element[1]->Attribute("floating") != NULL )
-                        tmpWin.setFloating( strcmp( element[1]->Attribute("floating"), "true" ) == 0 );
-
-                    if (element[1]->Attribute("alwaysRender") != NULL)
-                        tmpWin.setRenderWhileHidden(strcmp(element[1]->Attribute("alwaysRender"), "true") == 0);
-
-                    if (element[1]->Attribute("hidden") != NULL)
-                        tmpWin.setVisibility(!(strcmp(element[1]->Attribute("hidden"), "true") == 0));
-
-                    if (element[1]->Attribute("dbuffered") != NULL)
-                        tmpWin.setDoubleBuffered(strcmp(element[1]->Attribute("dbuffered"), "true") == 0);
-
-                    float gamma = 0.0f;
-                    if (element[1]->QueryFloatAttribute("gamma", &gamma) == tinyxml2::XML_NO_ERROR && gamma > 0.1f)
-                        tmpWin.setGamma(gamma);
-
-                    float contrast = -1.0f;
-                    if (element[1]->QueryFloatAttribute("contrast", &contrast) == tinyxml2::XML_NO_ERROR && contrast > 0.0f)
-                        tmpWin.setContrast(contrast);
-
-                    float brightness = -1.0f;
-                    if (element[1]->QueryFloatAttribute("brightness", &brightness) == tinyxml2::XML_NO_ERROR && brightness > 0.0f)
-                        tmpWin.setBrightness(brightness);
-                    
-                    int tmpSamples = 0;
-                    //compability with older versions
-                    if( element[1]->QueryIntAttribute("numberOfSamples", &tmpSamples ) == tinyxml2::XML_NO_ERROR && tmpSamples <= 128)
-                        tmpWin.setNumberOfAASamples(tmpSamples);
-                    else if( element[1]->QueryIntAttribute("msaa", &tmpSamples ) == tinyxml2::XML_NO_ERROR && tmpSamples <= 128)
-                        tmpWin.setNumberOfAASamples(tmpSamples);
-                    else if (element[1]->QueryIntAttribute("MSAA", &tmpSamples) == tinyxml2::XML_NO_ERROR && tmpSamples <= 128)
-                        tmpWin.setNumberOfAASamples(tmpSamples);
-                    
-                    if (element[1]->Attribute("alpha") != NULL)
-                        tmpWin.setAlpha(strcmp(element[1]->Attribute("alpha"), "true") == 0 ? true : false);
-                    
-                    if( element[1]->Attribute("fxaa") != NULL )
-                        tmpWin.setUseFXAA( strcmp( element[1]->Attribute("fxaa"), "true" ) == 0 ? true : false );
-                    
-                    if( element[1]->Attribute("FXAA") != NULL )
-                        tmpWin.setUseFXAA( strcmp( element[1]->Attribute("FXAA"), "true" ) == 0 ? true : false );
-                    
-                    if( element[1]->Attribute("decorated") != NULL )
-                        tmpWin.setWindowDecoration( strcmp( element[1]->Attribute("decorated"), "true" ) == 0 ? true : false);
-                    
-                    if( element[1]->Attribute("border") != NULL )
-                        tmpWin.setWindowDecoration( strcmp( element[1]->Attribute("border"), "true" ) == 0 ? true : false);
-
-                    if (element[1]->Attribute("draw2D") != NULL)
-                        tmpWin.setCallDraw2DFunction(strcmp(element[1]->Attribute("draw2D"), "true") == 0 ? true : false);
-
-                    if (element[1]->Attribute("draw3D") != NULL)
-                        tmpWin.setCallDraw3DFunction(strcmp(element[1]->Attribute("draw3D"), "true") == 0 ? true : false);
-
-                    if (element[1]->Attribute("copyPreviousWindowToCurrentWindow") != NULL)
-                        tmpWin.setCopyPreviousWindowToCurrentWindow(strcmp(element[1]->Attribute("copyPreviousWindowToCurrentWindow"), "true") == 0 ? true : false);
-                    
-                    int tmpMonitorIndex = 0;
-                    if( element[1]->QueryIntAttribute("monitor", &tmpMonitorIndex ) == tinyxml2::XML_NO_ERROR)
-                        tmpWin.setFullScreenMonitorIndex( tmpMonitorIndex );
-                    
-                    if( element[1]->Attribute("mpcdi") != NULL ) {
-                    	sgct_core::SGCTMpcdi mpcdiHandler(mErrorMsg);
-						std::string pathToMpcdiFile;
-						size_t lastSlashPos = xmlFileName.find_last_of("/");
-						if (lastSlashPos != std::string::npos)
-						    pathToMpcdiFile = xmlFileName.substr(0, lastSlashPos) + "/";
-						pathToMpcdiFile += element[1]->Attribute("mpcdi");
-						//replace all backslashes with slashes
-						std::replace(pathToMpcdiFile.begin(), pathToMpcdiFile.end(), '\\', '/');
-                        if( !mpcdiHandler.parseConfiguration(pathToMpcdiFile, tmpNode, tmpWin) ) {
-                            return false;
-                        }
-                    }
-
-                    element[2] = element[1]->FirstChildElement();
-                    while( element[2] != NULL )
-                    {
-                        val[2] = element[2]->Value();
-                        int tmpWinData[2];
-                        memset(tmpWinData,0,4);
-                        
-                        if( strcmp("Stereo", val[2]) == 0 )
-                        {
-                            tmpWin.setStereoMode( getStereoType( element[2]->Attribute("type") ) );
-                        }
-                        else if( strcmp("Pos", val[2]) == 0 )
-                        {
-                            if( element[2]->QueryIntAttribute("x", &tmpWinData[0] ) == tinyxml2::XML_NO_ERROR &&
-                               element[2]->QueryIntAttribute("y", &tmpWinData[1] ) == tinyxml2::XML_NO_ERROR )
-                                tmpWin.setWindowPosition(tmpWinData[0],tmpWinData[1]);
-                            else
-                                sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ReadConfig: Failed to parse window position from XML!\n");
-                        }
-                        else if( strcmp("Size", val[2]) == 0 )
-                        {
-                            if( element[2]->QueryIntAttribute("x", &tmpWinData[0] ) == tinyxml2::XML_NO_ERROR &&
-                               element[2]->QueryIntAttribute("y", &tmpWinData[1] ) == tinyxml2::XML_NO_ERROR )
-                                tmpWin.initWindowResolution(tmpWinData[0],tmpWinData[1]);
-                            else
-                                sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ReadConfig: Failed to parse window resolution from XML!\n");
-                        }
-                        else if( strcmp("Res", val[2]) == 0 )
-                        {
-                            if( element[2]->QueryIntAttribute("x", &tmpWinData[0] ) == tinyxml2::XML_NO_ERROR &&
-                               element[2]->QueryIntAttribute("y", &tmpWinData[1] ) == tinyxml2::XML_NO_ERROR )
-                            {
-                                tmpWin.setFramebufferResolution(tmpWinData[0],tmpWinData[1]);
-                                tmpWin.setFixResolution(true);
-                            }
-                            else
-                                sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ReadConfig: Failed to parse frame buffer resolution from XML!\n");
-                        }
-                        else if(strcmp("Viewport", val[2]) == 0)
-                        {
-                            Viewport * vpPtr = new sgct_core::Viewport();
-                            vpPtr->configure(element[2]);
-                            tmpWin.addViewport(vpPtr);
-                        }
-                        
-                        //iterate
-                        element[2] = element[2]->NextSiblingElement();
-                    }
-                    
-                    tmpNode.addWindow( tmpWin );
-                }//end window
-                
-                //iterate
-                element[1] = element[1]->NextSiblingElement();
-                
-            }//end while
+            if( !readAndParseNode(element[0], tmpNode) )
+                return false;
             
             ClusterManager::instance()->addNode(tmpNode);
         }//end if node
@@ -612,6 +696,25 @@ bool sgct_core::ReadConfig::readAndParseXML(tinyxml2::XMLDocument& xmlDoc)
         else if( strcmp("Tracker", val[0]) == 0 && element[0]->Attribute("name") != NULL )
         {
             ClusterManager::instance()->getTrackingManagerPtr()->addTracker( std::string(element[0]->Attribute("name")) );
+
+            bool eventSampling;
+            if( element[0]->QueryBoolAttribute("eventSampling", &eventSampling) == tinyxml2::XML_NO_ERROR )
+                ClusterManager::instance()->getTrackingManagerPtr()->setEventDrivenSampling( eventSampling );
+
+            if( element[0]->Attribute("prediction") != NULL )
+            {
+                float extraLatency = 0.0f;
+                element[0]->QueryFloatAttribute("predictionLatency", &extraLatency);
+
+                sgct::SGCTTrackingDevice::PredictionMode mode = sgct::SGCTTrackingDevice::NoPrediction;
+                if( strcmp("velocity", element[0]->Attribute("prediction")) == 0 )
+                    mode = sgct::SGCTTrackingDevice::ConstantVelocity;
+                else if( strcmp("acceleration", element[0]->Attribute("prediction")) == 0 )
+                    mode = sgct::SGCTTrackingDevice::ConstantAcceleration;
+
+                //latency is given in milliseconds
+                ClusterManager::instance()->getTrackingManagerPtr()->setPrediction( mode, static_cast<double>(extraLatency) / 1000.0 );
+            }
             
             element[1] = element[0]->FirstChildElement();
             while( element[1] != NULL )
@@ -804,6 +907,181 @@ bool sgct_core::ReadConfig::readAndParseXML(tinyxml2::XMLDocument& xmlDoc)
     return true;
 }
 
+/*!
+Reads the windows and viewports of a node element.
+*/
+bool sgct_core::ReadConfig::readAndParseNode(tinyxml2::XMLElement * nodeElement, SGCTNode & node)
+{
+    tinyxml2::XMLElement* element[MAX_XML_DEPTH];
+    for(unsigned int i=0; i < MAX_XML_DEPTH; i++)
+        element[i] = NULL;
+    const char * val[MAX_XML_DEPTH];
+    element[0] = nodeElement;
+
+    element[1] = element[0]->FirstChildElement();
+    while( element[1] != NULL )
+    {
+        val[1] = element[1]->Value();
+        if( strcmp("Window", val[1]) == 0 )
+        {
+            sgct::SGCTWindow tmpWin( static_cast<int>(node.getNumberOfWindows()) );
+            
+            if( element[1]->Attribute("name") != NULL )
+                tmpWin.setName( element[1]->Attribute("name") );
+
+            if (element[1]->Attribute("tags") != NULL)
+                tmpWin.setTags(element[1]->Attribute("tags"));
+
+            if (element[1]->Attribute("bufferBitDepth") != NULL)
+                tmpWin.setColorBitDepth(getBufferColorBitDepth(element[1]->Attribute("bufferBitDepth")));
+
+            if (element[1]->Attribute("preferBGR") != NULL)
+                tmpWin.setPreferBGR(strcmp(element[1]->Attribute("preferBGR"), "true") == 0);
+                
+            //compability with older versions
+            if (element[1]->Attribute("fullScreen") != NULL)
+                tmpWin.setWindowMode(strcmp(element[1]->Attribute("fullScreen"), "true") == 0);
+
+            if( element[1]->Attribute("fullscreen") != NULL )
+                tmpWin.setWindowMode( strcmp( element[1]->Attribute("fullscreen"), "true" ) == 0 );
+            
+            if( element[1]->Attribute("floating") != NULL )
+                tmpWin.setFloating( strcmp( element[1]->Attribute("floating"), "true" ) == 0 );
+
+            if (element[1]->Attribute("alwaysRender") != NULL)
+                tmpWin.setRenderWhileHidden(strcmp(element[1]->Attribute("alwaysRender"), "true") == 0);
+
+            if (element[1]->Attribute("hidden") != NULL)
+                tmpWin.setVisibility(!(strcmp(element[1]->Attribute("hidden"), "true") == 0));
+
+            if (element[1]->Attribute("dbuffered") != NULL)
+                tmpWin.setDoubleBuffered(strcmp(element[1]->Attribute("dbuffered"), "true") == 0);
+
+            float gamma = 0.0f;
+            if (element[1]->QueryFloatAttribute("gamma", &gamma) == tinyxml2::XML_NO_ERROR && gamma > 0.1f)
+                tmpWin.setGamma(gamma);
+
+            float contrast = -1.0f;
+            if (element[1]->QueryFloatAttribute("contrast", &contrast) == tinyxml2::XML_NO_ERROR && contrast > 0.0f)
+                tmpWin.setContrast(contrast);
+
+            float brightness = -1.0f;
+            if (element[1]->QueryFloatAttribute("brightness", &brightness) == tinyxml2::XML_NO_ERROR && brightness > 0.0f)
+                tmpWin.setBrightness(brightness);
+            
+            int tmpSamples = 0;
+            //compability with older versions
+            if( element[1]->QueryIntAttribute("numberOfSamples", &tmpSamples ) == tinyxml2::XML_NO_ERROR && tmpSamples <= 128)
+                tmpWin.setNumberOfAASamples(tmpSamples);
+            else if( element[1]->QueryIntAttribute("msaa", &tmpSamples ) == tinyxml2::XML_NO_ERROR && tmpSamples <= 128)
+                tmpWin.setNumberOfAASamples(tmpSamples);
+            else if (element[1]->QueryIntAttribute("MSAA", &tmpSamples) == tinyxml2::XML_NO_ERROR && tmpSamples <= 128)
+                tmpWin.setNumberOfAASamples(tmpSamples);
+            
+            if (element[1]->Attribute("alpha") != NULL)
+                tmpWin.setAlpha(strcmp(element[1]->Attribute("alpha"), "true") == 0 ? true : false);
+            
+            if( element[1]->Attribute("fxaa") != NULL )
+                tmpWin.setUseFXAA( strcmp( element[1]->Attribute("fxaa"), "true" ) == 0 ? true : false );
+            
+            if( element[1]->Attribute("FXAA") != NULL )
+                tmpWin.setUseFXAA( strcmp( element[1]->Attribute("FXAA"), "true" ) == 0 ? true : false );
+            
+            if( element[1]->Attribute("decorated") != NULL )
+                tmpWin.setWindowDecoration( strcmp( element[1]->Attribute("decorated"), "true" ) == 0 ? true : false);
+            
+            if( element[1]->Attribute("border") != NULL )
+                tmpWin.setWindowDecoration( strcmp( element[1]->Attribute("border"), "true" ) == 0 ? true : false);
+
+            if (element[1]->Attribute("draw2D") != NULL)
+                tmpWin.setCallDraw2DFunction(strcmp(element[1]->Attribute("draw2D"), "true") == 0 ? true : false);
+
+            if (element[1]->Attribute("draw3D") != NULL)
+                tmpWin.setCallDraw3DFunction(strcmp(element[1]->Attribute("draw3D"), "true") == 0 ? true : false);
+
+            if (element[1]->Attribute("copyPreviousWindowToCurrentWindow") != NULL)
+                tmpWin.setCopyPreviousWindowToCurrentWindow(strcmp(element[1]->Attribute("copyPreviousWindowToCurrentWindow"), "true") == 0 ? true : false);
+            
+            int tmpMonitorIndex = 0;
+            if( element[1]->QueryIntAttribute("monitor", &tmpMonitorIndex ) == tinyxml2::XML_NO_ERROR)
+                tmpWin.setFullScreenMonitorIndex( tmpMonitorIndex );
+            
+            if( element[1]->Attribute("mpcdi") != NULL ) {
+            	sgct_core::SGCTMpcdi mpcdiHandler(mErrorMsg);
+						std::string pathToMpcdiFile;
+						size_t lastSlashPos = xmlFileName.find_last_of("/");
+						const char * mpcdiAttribute = element[1]->Attribute("mpcdi");
+						bool absolutePath = mpcdiAttribute[0] == '/' || mpcdiAttribute[0] == '\\' || (mpcdiAttribute[0] != '\0' && mpcdiAttribute[1] == ':');
+						if (lastSlashPos != std::string::npos && !absolutePath)
+						    pathToMpcdiFile = xmlFileName.substr(0, lastSlashPos) + "/";
+						pathToMpcdiFile += element[1]->Attribute("mpcdi");
+						//replace all backslashes with slashes
+						std::replace(pathToMpcdiFile.begin(), pathToMpcdiFile.end(), '\\', '/');
+                if( !mpcdiHandler.parseConfiguration(pathToMpcdiFile, node, tmpWin) ) {
+                    return false;
+                }
+            }
+
+            element[2] = element[1]->FirstChildElement();
+            while( element[2] != NULL )
+            {
+                val[2] = element[2]->Value();
+                int tmpWinData[2];
+                memset(tmpWinData,0,4);
+                
+                if( strcmp("Stereo", val[2]) == 0 )
+                {
+                    tmpWin.setStereoMode( getStereoType( element[2]->Attribute("type") ) );
+                }
+                else if( strcmp("Pos", val[2]) == 0 )
+                {
+                    if( element[2]->QueryIntAttribute("x", &tmpWinData[0] ) == tinyxml2::XML_NO_ERROR &&
+                       element[2]->QueryIntAttribute("y", &tmpWinData[1] ) == tinyxml2::XML_NO_ERROR )
+                        tmpWin.setWindowPosition(tmpWinData[0],tmpWinData[1]);
+                    else
+                        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ReadConfig: Failed to parse window position from XML!\n");
+                }
+                else if( strcmp("Size", val[2]) == 0 )
+                {
+                    if( element[2]->QueryIntAttribute("x", &tmpWinData[0] ) == tinyxml2::XML_NO_ERROR &&
+                       element[2]->QueryIntAttribute("y", &tmpWinData[1] ) == tinyxml2::XML_NO_ERROR )
+                        tmpWin.initWindowResolution(tmpWinData[0],tmpWinData[1]);
+                    else
+                        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ReadConfig: Failed to parse window resolution from XML!\n");
+                }
+                else if( strcmp("Res", val[2]) == 0 )
+                {
+                    if( element[2]->QueryIntAttribute("x", &tmpWinData[0] ) == tinyxml2::XML_NO_ERROR &&
+                       element[2]->QueryIntAttribute("y", &tmpWinData[1] ) == tinyxml2::XML_NO_ERROR )
+                    {
+                        tmpWin.setFramebufferResolution(tmpWinData[0],tmpWinData[1]);
+                        tmpWin.setFixResolution(true);
+                    }
+                    else
+                        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "ReadConfig: Failed to parse frame buffer resolution from XML!\n");
+                }
+                else if(strcmp("Viewport", val[2]) == 0)
+                {
+                    Viewport * vpPtr = new sgct_core::Viewport();
+                    vpPtr->configure(element[2]);
+                    tmpWin.addViewport(vpPtr);
+                }
+                
+                //iterate
+                element[2] = element[2]->NextSiblingElement();
+            }
+            
+            node.addWindow( tmpWin );
+        }//end window
+        
+        //iterate
+        element[1] = element[1]->NextSiblingElement();
+        
+    }//end while
+    
+    return true;
+}
+
 sgct::SGCTWindow::StereoMode sgct_core::ReadConfig::getStereoType( std::string type )
 {
     std::transform(type.begin(), type.end(), type.begin(), ::tolower);
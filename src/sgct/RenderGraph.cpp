@@ -0,0 +1,247 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#include <sgct/RenderGraph.h>
+#include <algorithm>
+#include <set>
+
+const std::size_t sgct_core::RenderGraph::NoSlot = static_cast<std::size_t>(-1);
+
+sgct_core::RenderGraph::RenderGraph()
+{
+    mCompiled = false;
+}
+
+/*!
+Adds a resource that the passes can read and write.
+@param    transient    Set if the resource is only used within the frame so that it can share memory with other transient resources of the same size and format
+@param    window       Window that the resource belongs to
+@param    texture      Framebuffer texture index of the window or -1 if the window doesn't own the resource
+\returns the index of the resource
+*/
+std::size_t sgct_core::RenderGraph::addResource(const std::string & name, bool transient, int width, int height, int format, std::size_t window, int texture)
+{
+    Resource res;
+    res.name = name;
+    res.transient = transient;
+    res.width = width;
+    res.height = height;
+    res.format = format;
+    res.window = window;
+    res.texture = texture;
+    res.slot = NoSlot;
+    mResources.push_back(res);
+    mCompiled = false;
+
+    return mResources.size() - 1;
+}
+
+/*!
+Adds a pass, passes that don't depend on each other are executed in the order they are added.
+@param    sideEffect    Set if the pass writes to something outside of the graph, such passes are never culled
+\returns the index of the pass
+*/
+std::size_t sgct_core::RenderGraph::addPass(PassType type, std::size_t window, std::size_t viewport, bool rightEye, std::size_t drawBufferIndex, bool sideEffect)
+{
+    Pass pass;
+    pass.type = type;
+    pass.window = window;
+    pass.viewport = viewport;
+    pass.rightEye = rightEye;
+    pass.drawBufferIndex = drawBufferIndex;
+    pass.sideEffect = sideEffect;
+    mPasses.push_back(pass);
+    mCompiled = false;
+
+    return mPasses.size() - 1;
+}
+
+void sgct_core::RenderGraph::read(std::size_t pass, std::size_t resource)
+{
+    mPasses[pass].reads.push_back(resource);
+    mCompiled = false;
+}
+
+void sgct_core::RenderGraph::write(std::size_t pass, std::size_t resource)
+{
+    mPasses[pass].writes.push_back(resource);
+    mCompiled = false;
+}
+
+/*!
+Culls the unused passes, computes the execution order and assigns the memory slots of the transient resources.
+*/
+void sgct_core::RenderGraph::compile()
+{
+    cull();
+    sort();
+    assignSlots();
+    mCompiled = true;
+}
+
+/*!
+Removes all passes and resources.
+*/
+void sgct_core::RenderGraph::clear()
+{
+    mResources.clear();
+    mPasses.clear();
+    mLive.clear();
+    mOrder.clear();
+    mSlotOwners.clear();
+    mCompiled = false;
+}
+
+/*!
+A pass is live if it has side effects or if a live pass reads something it writes. Producers are always added
+before their consumers so a single sweep from the last pass is enough.
+*/
+void sgct_core::RenderGraph::cull()
+{
+    //the passes that wrote the version of each resource that a pass reads
+    std::vector< std::vector<std::size_t> > producers(mPasses.size());
+    std::vector<std::size_t> lastWriter(mResources.size(), mPasses.size());
+    for (std::size_t p = 0; p < mPasses.size(); p++)
+    {
+        for (std::size_t i = 0; i < mPasses[p].reads.size(); i++)
+            if (lastWriter[mPasses[p].reads[i]] < mPasses.size())
+                producers[p].push_back(lastWriter[mPasses[p].reads[i]]);
+        for (std::size_t i = 0; i < mPasses[p].writes.size(); i++)
+            lastWriter[mPasses[p].writes[i]] = p;
+    }
+
+    mLive.assign(mPasses.size(), false);
+    for (std::size_t p = mPasses.size(); p-- > 0; )
+    {
+        if (mPasses[p].sideEffect)
+            mLive[p] = true;
+        if (mLive[p])
+            for (std::size_t i = 0; i < producers[p].size(); i++)
+                mLive[producers[p][i]] = true;
+    }
+}
+
+/*!
+Orders the live passes topologically. Among the passes that are ready the one added first is picked so the order
+only differs from the order the passes were added in where the dependencies allow it.
+*/
+void sgct_core::RenderGraph::sort()
+{
+    std::vector< std::vector<std::size_t> > dependents(mPasses.size());
+    std::vector<std::size_t> numberOfDependencies(mPasses.size(), 0);
+    std::vector<std::size_t> lastWriter(mResources.size(), mPasses.size());
+    std::vector< std::vector<std::size_t> > readers(mResources.size()); //readers since the last write
+
+    for (std::size_t p = 0; p < mPasses.size(); p++)
+    {
+        if (!mLive[p])
+            continue;
+
+        std::vector<std::size_t> dependencies;
+        for (std::size_t i = 0; i < mPasses[p].reads.size(); i++)
+        {
+            std::size_t r = mPasses[p].reads[i];
+            if (lastWriter[r] < mPasses.size())
+                dependencies.push_back(lastWriter[r]);
+        }
+        for (std::size_t i = 0; i < mPasses[p].writes.size(); i++)
+        {
+            std::size_t r = mPasses[p].writes[i];
+            if (lastWriter[r] < mPasses.size())
+                dependencies.push_back(lastWriter[r]);
+            dependencies.insert(dependencies.end(), readers[r].begin(), readers[r].end());
+        }
+
+        for (std::size_t i = 0; i < mPasses[p].reads.size(); i++)
+            readers[mPasses[p].reads[i]].push_back(p);
+        for (std::size_t i = 0; i < mPasses[p].writes.size(); i++)
+        {
+            lastWriter[mPasses[p].writes[i]] = p;
+            readers[mPasses[p].writes[i]].clear();
+        }
+
+        std::sort(dependencies.begin(), dependencies.end());
+        dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+        for (std::size_t i = 0; i < dependencies.size(); i++)
+            if (dependencies[i] != p)
+            {
+                dependents[dependencies[i]].push_back(p);
+                numberOfDependencies[p]++;
+            }
+    }
+
+    std::set<std::size_t> ready;
+    for (std::size_t p = 0; p < mPasses.size(); p++)
+        if (mLive[p] && numberOfDependencies[p] == 0)
+            ready.insert(p);
+
+    mOrder.clear();
+    while (!ready.empty())
+    {
+        std::size_t p = *ready.begin();
+        ready.erase(ready.begin());
+        mOrder.push_back(p);
+
+        for (std::size_t i = 0; i < dependents[p].size(); i++)
+            if (--numberOfDependencies[dependents[p][i]] == 0)
+                ready.insert(dependents[p][i]);
+    }
+}
+
+/*!
+Places the transient resources in memory slots. A resource lives from the first to the last executed pass that
+uses it and gets the slot of a resource with the same size and format whose lifetime has ended, or a new slot.
+*/
+void sgct_core::RenderGraph::assignSlots()
+{
+    std::vector<std::size_t> firstUse(mResources.size(), mOrder.size());
+    std::vector<std::size_t> lastUse(mResources.size(), 0);
+    std::vector<std::size_t> byFirstUse;
+
+    for (std::size_t i = 0; i < mOrder.size(); i++)
+    {
+        const Pass & pass = mPasses[mOrder[i]];
+        for (std::size_t j = 0; j < pass.reads.size() + pass.writes.size(); j++)
+        {
+            std::size_t r = j < pass.reads.size() ? pass.reads[j] : pass.writes[j - pass.reads.size()];
+            if (firstUse[r] == mOrder.size())
+            {
+                firstUse[r] = i;
+                byFirstUse.push_back(r);
+            }
+            lastUse[r] = i;
+        }
+    }
+
+    mSlotOwners.clear();
+    std::vector<std::size_t> slotLastUse;
+    for (std::size_t r = 0; r < mResources.size(); r++)
+        mResources[r].slot = NoSlot;
+
+    for (std::size_t i = 0; i < byFirstUse.size(); i++)
+    {
+        Resource & res = mResources[byFirstUse[i]];
+        if (!res.transient)
+            continue;
+
+        for (std::size_t s = 0; s < mSlotOwners.size() && res.slot == NoSlot; s++)
+        {
+            const Resource & owner = mResources[mSlotOwners[s]];
+            if (slotLastUse[s] < firstUse[byFirstUse[i]] &&
+                owner.width == res.width && owner.height == res.height && owner.format == res.format)
+                res.slot = s;
+        }
+
+        if (res.slot == NoSlot)
+        {
+            res.slot = mSlotOwners.size();
+            mSlotOwners.push_back(byFirstUse[i]);
+            slotLastUse.push_back(0);
+        }
+        slotLastUse[res.slot] = lastUse[byFirstUse[i]];
+    }
+}
@@ -0,0 +1,159 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#include <sgct/ResolutionScaler.h>
+#include <math.h>
+
+const unsigned int sgct_core::ResolutionScaler::CoolDownFrames;
+const unsigned int sgct_core::ResolutionScaler::LowerFrames;
+const unsigned int sgct_core::ResolutionScaler::RaiseFrames;
+
+//weight of the latest frame time in the smoothed frame time
+static const float SmoothingFactor = 0.25f;
+
+sgct_core::ResolutionScaler::ResolutionScaler()
+{
+    mBudget = 1.0f / 60.0f;
+    mMinScale = 0.5f;
+    mMaxScale = 1.0f;
+    mLowerThreshold = 0.7f;
+    mUpperThreshold = 0.9f;
+    mStep = 0.05f;
+    reset();
+}
+
+/*!
+Set the frame time that the cluster should stay within, for example the refresh period of the displays.
+*/
+void sgct_core::ResolutionScaler::setBudget(float seconds)
+{
+    mBudget = seconds;
+}
+
+/*!
+Set the range of the scale, the scale is clamped to the new range.
+*/
+void sgct_core::ResolutionScaler::setScaleLimits(float minScale, float maxScale)
+{
+    mMinScale = minScale;
+    mMaxScale = maxScale < minScale ? minScale : maxScale;
+    mScale = mScale < mMinScale ? mMinScale : (mScale > mMaxScale ? mMaxScale : mScale);
+}
+
+/*!
+@param    lower    Fraction of the budget that the frame time must stay below before the scale is raised
+@param    upper    Fraction of the budget that makes the scale be lowered when the frame time goes above it
+*/
+void sgct_core::ResolutionScaler::setThresholds(float lower, float upper)
+{
+    mLowerThreshold = lower;
+    mUpperThreshold = upper < lower ? lower : upper;
+}
+
+/*!
+Set the step that the scale is quantized to.
+*/
+void sgct_core::ResolutionScaler::setStep(float step)
+{
+    mStep = step;
+}
+
+/*!
+Sets the scale to the maximum and forgets the frame times.
+*/
+void sgct_core::ResolutionScaler::reset()
+{
+    mScale = mMaxScale;
+    mSmoothedFrameTime = 0.0f;
+    mHasFrameTime = false;
+    mCoolDown = 0;
+    mFramesBelow = 0;
+    mFramesAbove = 0;
+    mMinLoadAbove = 0.0f;
+}
+
+/*!
+Adds the frame time of the last frame, on a cluster the frame time of the slowest node.
+\returns true if the scale was changed
+*/
+bool sgct_core::ResolutionScaler::update(float frameTime)
+{
+    if (mBudget <= 0.0f || frameTime <= 0.0f)
+        return false;
+
+    if (mHasFrameTime)
+        mSmoothedFrameTime += SmoothingFactor * (frameTime - mSmoothedFrameTime);
+    else
+        mSmoothedFrameTime = frameTime;
+    mHasFrameTime = true;
+
+    //the first frames after a change may still have been rendered at the old scale
+    if (mCoolDown > 0)
+    {
+        mCoolDown--;
+        return false;
+    }
+
+    float load = mSmoothedFrameTime / mBudget;
+    float frameLoad = frameTime / mBudget;
+    //the frame time is assumed to be proportional to the number of pixels, the square of the scale
+    float targetLoad = 0.5f * (mLowerThreshold + mUpperThreshold);
+
+    //the overload must last, the smoothed frame time stays above the threshold for a while after a large hitch
+    if (frameLoad > mUpperThreshold)
+    {
+        mFramesBelow = 0;
+        mMinLoadAbove = mFramesAbove == 0 ? frameLoad : fminf(mMinLoadAbove, frameLoad);
+        if (++mFramesAbove < LowerFrames)
+            return false;
+
+        mFramesAbove = 0;
+        float scale = quantize(mScale * sqrtf(targetLoad / mMinLoadAbove));
+        if (scale >= mScale)
+            scale = mScale - mStep;
+        return setScale(scale);
+    }
+
+    mFramesAbove = 0;
+    if (load < mLowerThreshold)
+    {
+        if (++mFramesBelow < RaiseFrames)
+            return false;
+
+        mFramesBelow = 0;
+        float scale = quantize(mScale + mStep);
+        float predictedLoad = load * (scale * scale) / (mScale * mScale);
+        if (predictedLoad > targetLoad)
+            return false;
+        return setScale(scale);
+    }
+
+    mFramesBelow = 0;
+    return false;
+}
+
+float sgct_core::ResolutionScaler::quantize(float scale) const
+{
+    if (mStep <= 0.0f)
+        return scale;
+
+    //rounded down so that a lowered scale is never above what the frame time calls for
+    return floorf(scale / mStep + 1.0e-3f) * mStep;
+}
+
+bool sgct_core::ResolutionScaler::setScale(float scale)
+{
+    scale = scale < mMinScale ? mMinScale : (scale > mMaxScale ? mMaxScale : scale);
+    if (fabsf(scale - mScale) < 1.0e-4f)
+        return false;
+
+    mScale = scale;
+    mCoolDown = CoolDownFrames;
+    //start over so that the smoothed time isn't dragged by the frames of the old scale
+    mHasFrameTime = false;
+    return true;
+}
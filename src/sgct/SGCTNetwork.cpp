@@ -38,6 +38,7 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <sgct/SharedData.h>
 #include <sgct/MessageHandler.h>
 #include <sgct/ClusterManager.h>
+#include <sgct/ClusterStatistics.h>
 #include <sgct/Engine.h>
 
 #ifndef SGCT_DONT_USE_EXTERNAL
@@ -459,6 +460,11 @@ void sgct_core::SGCTNetwork::pushClientMessage()
     int currentFrame = iterateFrameCounter();
     unsigned char *p = (unsigned char *)&currentFrame;
 
+    //the frame statistics of this node are followed by the console messages of this frame
+    char statsSample[ClusterStatistics::EncodedSampleSize];
+    ClusterStatistics::instance()->encodeLocalSample(statsSample);
+    sgct::MessageHandler::instance()->buildForwardBatch(currentFrame, mBufferSize, statsSample, ClusterStatistics::EncodedSampleSize);
+
     if(sgct::MessageHandler::instance()->getDataSize() > mHeaderSize)
     {
         sgct::SGCTMutexManager::instance()->lockMutex(sgct::SGCTMutexManager::DataSyncMutex);
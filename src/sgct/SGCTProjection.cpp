@@ -83,4 +83,14 @@ void sgct_core::SGCTProjection::calculateProjection(glm::vec3 base, SGCTProjecti
         mFrustum.getFar());
 
     mViewProjectionMatrix = mProjectionMatrix * mViewMatrix;
-}
\ No newline at end of file
+}
+
+/*!
+Set the matrices directly, used by SGCTProjectionSolver when projections are calculated in batches.
+*/
+void sgct_core::SGCTProjection::setMatrices(const glm::mat4 & viewMatrix, const glm::mat4 & projectionMatrix, const glm::mat4 & viewProjectionMatrix)
+{
+    mViewMatrix = viewMatrix;
+    mProjectionMatrix = projectionMatrix;
+    mViewProjectionMatrix = viewProjectionMatrix;
+}
@@ -0,0 +1,208 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#include <sgct/SGCTProjectionSolver.h>
+#include <sgct/SGCTProjection.h>
+#include <sgct/BaseViewport.h>
+#include <sgct/NonLinearProjection.h>
+#include <sgct/SGCTUser.h>
+#include <sgct/helpers/SGCTSIMD.h>
+
+using namespace sgct_helpers;
+
+sgct_core::SGCTProjectionSolver::SGCTProjectionSolver()
+{
+    ;
+}
+
+/*!
+Removes all queued projections
+*/
+void sgct_core::SGCTProjectionSolver::clear()
+{
+    mTargets.clear();
+    for (int i = 0; i < NumberOfInputs; i++)
+        mInput[i].clear();
+}
+
+/*!
+Queue the projection of a viewport for the given eye. Equivalent to BaseViewport::calculateFrustum.
+*/
+void sgct_core::SGCTProjectionSolver::addViewport(BaseViewport * vp, Frustum::FrustumMode frustumMode)
+{
+    add(vp->getProjection(frustumMode), vp, frustumMode, false);
+}
+
+/*!
+Queue the symmetric projection of a viewport for the given eye. Equivalent to BaseViewport::calculateNonLinearFrustum.
+*/
+void sgct_core::SGCTProjectionSolver::addNonLinearViewport(BaseViewport * vp, Frustum::FrustumMode frustumMode)
+{
+    add(vp->getProjection(frustumMode), vp, frustumMode, true);
+}
+
+/*!
+Queue all enabled cube faces of a non linear projection for the given eye. Equivalent to NonLinearProjection::updateFrustums.
+*/
+void sgct_core::SGCTProjectionSolver::addNonLinearProjection(NonLinearProjection * nlp, Frustum::FrustumMode frustumMode)
+{
+    for (std::size_t side = 0; side < 6; side++)
+    {
+        BaseViewport * vp = nlp->getSubViewportPtr(side);
+        if (vp->isEnabled())
+            addNonLinearViewport(vp, frustumMode);
+    }
+}
+
+void sgct_core::SGCTProjectionSolver::add(SGCTProjection * target, BaseViewport * vp, Frustum::FrustumMode frustumMode, bool nonLinear)
+{
+    SGCTUser * user = vp->getUser();
+    glm::vec3 base = nonLinear ? user->getPos() : user->getPos(frustumMode);
+    glm::vec3 offset = nonLinear ? (user->getPos(frustumMode) - base) : glm::vec3(0.0f);
+
+    const SGCTProjectionPlane * plane = vp->getProjectionPlane();
+    const glm::vec3 * ll = plane->getCoordinatePtr(SGCTProjectionPlane::LowerLeft);
+    const glm::vec3 * ul = plane->getCoordinatePtr(SGCTProjectionPlane::UpperLeft);
+    const glm::vec3 * ur = plane->getCoordinatePtr(SGCTProjectionPlane::UpperRight);
+
+    const float values[NumberOfInputs] = {
+        base.x, base.y, base.z,
+        offset.x, offset.y, offset.z,
+        ll->x, ll->y, ll->z,
+        ul->x, ul->y, ul->z,
+        ur->x, ur->y, ur->z };
+
+    mTargets.push_back(target);
+    for (int i = 0; i < NumberOfInputs; i++)
+        mInput[i].push_back(values[i]);
+}
+
+/*!
+Calculate all queued projections and store the results in their SGCTProjection objects.
+The queue is kept so that the same set of projections can be solved again.
+*/
+void sgct_core::SGCTProjectionSolver::solve(float near_clipping_plane, float far_clipping_plane)
+{
+    const std::size_t count = mTargets.size();
+    if (count == 0)
+        return;
+
+    //pad to a multiple of four lanes by repeating the last projection
+    const std::size_t paddedCount = (count + 3) & ~static_cast<std::size_t>(3);
+    for (int i = 0; i < NumberOfInputs; i++)
+        mInput[i].resize(paddedCount, mInput[i][count - 1]);
+    for (int i = 0; i < NumberOfOutputs; i++)
+        mOutput[i].resize(paddedCount);
+
+    const Lanes nearPlane(near_clipping_plane);
+
+    for (std::size_t i = 0; i < paddedCount; i += 4)
+    {
+        Vec3Lanes base = { Lanes::load(&mInput[EyeX][i]), Lanes::load(&mInput[EyeY][i]), Lanes::load(&mInput[EyeZ][i]) };
+        Vec3Lanes offset = { Lanes::load(&mInput[OffsetX][i]), Lanes::load(&mInput[OffsetY][i]), Lanes::load(&mInput[OffsetZ][i]) };
+        Vec3Lanes ll = { Lanes::load(&mInput[LowerLeftX][i]), Lanes::load(&mInput[LowerLeftY][i]), Lanes::load(&mInput[LowerLeftZ][i]) };
+        Vec3Lanes ul = { Lanes::load(&mInput[UpperLeftX][i]), Lanes::load(&mInput[UpperLeftY][i]), Lanes::load(&mInput[UpperLeftZ][i]) };
+        Vec3Lanes ur = { Lanes::load(&mInput[UpperRightX][i]), Lanes::load(&mInput[UpperRightY][i]), Lanes::load(&mInput[UpperRightZ][i]) };
+
+        //calculate viewplane's internal coordinate system bases
+        Vec3Lanes plane_x = sub(ur, ul);
+        Vec3Lanes plane_y = sub(ul, ll);
+        Vec3Lanes plane_z = cross(plane_x, plane_y);
+
+        plane_x = normalize(plane_x);
+        plane_y = normalize(plane_y);
+        plane_z = normalize(plane_z);
+
+        //invert the direction cosine matrix (columns are the plane bases)
+        Vec3Lanes row0 = cross(plane_y, plane_z);
+        Vec3Lanes row1 = cross(plane_z, plane_x);
+        Vec3Lanes row2 = cross(plane_x, plane_y);
+        Lanes invDet = Lanes(1.0f) / dot(plane_x, row0);
+        row0.x = row0.x * invDet; row0.y = row0.y * invDet; row0.z = row0.z * invDet;
+        row1.x = row1.x * invDet; row1.y = row1.y * invDet; row1.z = row1.z * invDet;
+        row2.x = row2.x * invDet; row2.y = row2.y * invDet; row2.z = row2.z * invDet;
+
+        //transform corners and eye into the view plane's coordinate system
+        Lanes llX = dot(row0, ll);
+        Lanes llY = dot(row1, ll);
+        Lanes llZ = dot(row2, ll);
+        Lanes urX = dot(row0, ur);
+        Lanes urY = dot(row1, ur);
+        Lanes eyeX = dot(row0, base);
+        Lanes eyeY = dot(row1, base);
+        Lanes eyeZ = dot(row2, base);
+
+        //nearFactor = near clipping plane / focus plane dist
+        Lanes nearFactor = lanesAbs(nearPlane / (llZ - eyeZ));
+
+        ((llX - eyeX) * nearFactor).store(&mOutput[Left][i]);
+        ((urX - eyeX) * nearFactor).store(&mOutput[Right][i]);
+        ((llY - eyeY) * nearFactor).store(&mOutput[Bottom][i]);
+        ((urY - eyeY) * nearFactor).store(&mOutput[Top][i]);
+
+        row0.x.store(&mOutput[View00][i]); row0.y.store(&mOutput[View01][i]); row0.z.store(&mOutput[View02][i]);
+        row1.x.store(&mOutput[View10][i]); row1.y.store(&mOutput[View11][i]); row1.z.store(&mOutput[View12][i]);
+        row2.x.store(&mOutput[View20][i]); row2.y.store(&mOutput[View21][i]); row2.z.store(&mOutput[View22][i]);
+
+        //translation = DCM_inv * -(base + offset)
+        Vec3Lanes translation = { Lanes(0.0f) - (base.x + offset.x), Lanes(0.0f) - (base.y + offset.y), Lanes(0.0f) - (base.z + offset.z) };
+        dot(row0, translation).store(&mOutput[ViewTX][i]);
+        dot(row1, translation).store(&mOutput[ViewTY][i]);
+        dot(row2, translation).store(&mOutput[ViewTZ][i]);
+    }
+
+    //scatter the results, the projection matrix is sparse so the view projection matrix is built directly
+    const float n = near_clipping_plane;
+    const float f = far_clipping_plane;
+    const float e = -(f + n) / (f - n);
+    const float g = -(2.0f * f * n) / (f - n);
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        const float l = mOutput[Left][i];
+        const float r = mOutput[Right][i];
+        const float b = mOutput[Bottom][i];
+        const float t = mOutput[Top][i];
+
+        const float a = (2.0f * n) / (r - l);
+        const float bb = (2.0f * n) / (t - b);
+        const float c = (r + l) / (r - l);
+        const float d = (t + b) / (t - b);
+
+        glm::mat4 view(
+            mOutput[View00][i], mOutput[View10][i], mOutput[View20][i], 0.0f,
+            mOutput[View01][i], mOutput[View11][i], mOutput[View21][i], 0.0f,
+            mOutput[View02][i], mOutput[View12][i], mOutput[View22][i], 0.0f,
+            mOutput[ViewTX][i], mOutput[ViewTY][i], mOutput[ViewTZ][i], 1.0f);
+
+        glm::mat4 projection(0.0f);
+        projection[0][0] = a;
+        projection[1][1] = bb;
+        projection[2][0] = c;
+        projection[2][1] = d;
+        projection[2][2] = e;
+        projection[2][3] = -1.0f;
+        projection[3][2] = g;
+
+        glm::mat4 viewProjection;
+        for (int col = 0; col < 4; col++)
+        {
+            const float x = view[col][0];
+            const float y = view[col][1];
+            const float z = view[col][2];
+            const float w = view[col][3];
+            viewProjection[col] = glm::vec4(a * x + c * z, bb * y + d * z, e * z + g * w, -z);
+        }
+
+        mTargets[i]->getFrustum()->set(l, r, b, t, n, f);
+        mTargets[i]->setMatrices(view, projection, viewProjection);
+    }
+
+    //remove padding
+    for (int i = 0; i < NumberOfInputs; i++)
+        mInput[i].resize(count);
+}
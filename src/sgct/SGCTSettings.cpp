@@ -32,6 +32,13 @@ sgct::SGCTSettings::SGCTSettings()
     mUseRLE                        = false;
     mTryMaintainAspectRatio        = true;
     mExportWarpingMeshes        = false;
+    mUseLayeredCubemapRendering    = false;
+    mUseSinglePassCompositor    = false;
+    mUseTextureAliasing            = true;
+    mUseDynamicResolution        = false;
+    mDynamicResolutionBudget    = 0.0f;
+    mMinResolutionScale            = 0.5f;
+    mLayeredCubemapUniformBlockBinding = 0;
 
     mSwapInterval = 1;
     mRefreshRate = 0;
@@ -133,6 +140,23 @@ void sgct::SGCTSettings::configure(tinyxml2::XMLElement * element)
 
             if (subElement->Attribute("exportWarpingMeshes") != NULL)
                 sgct::SGCTSettings::instance()->setExportWarpingMeshes(strcmp(subElement->Attribute("exportWarpingMeshes"), "true") == 0 ? true : false);
+
+            if (subElement->Attribute("singlePassCompositor") != NULL)
+                sgct::SGCTSettings::instance()->setUseSinglePassCompositor(strcmp(subElement->Attribute("singlePassCompositor"), "true") == 0 ? true : false);
+
+            if (subElement->Attribute("textureAliasing") != NULL)
+                sgct::SGCTSettings::instance()->setUseTextureAliasing(strcmp(subElement->Attribute("textureAliasing"), "true") == 0 ? true : false);
+
+            if (subElement->Attribute("dynamicResolution") != NULL)
+                sgct::SGCTSettings::instance()->setUseDynamicResolution(strcmp(subElement->Attribute("dynamicResolution"), "true") == 0 ? true : false);
+
+            float frameBudget = 0.0f;
+            if (subElement->QueryFloatAttribute("frameBudget", &frameBudget) == tinyxml2::XML_NO_ERROR)
+                sgct::SGCTSettings::instance()->setDynamicResolutionBudget(frameBudget / 1000.0f);
+
+            float minScale = 0.0f;
+            if (subElement->QueryFloatAttribute("minResolutionScale", &minScale) == tinyxml2::XML_NO_ERROR)
+                sgct::SGCTSettings::instance()->setMinResolutionScale(minScale);
         }
         else if (strcmp("OSDText", val) == 0)
         {
@@ -699,6 +723,150 @@ const int    sgct::SGCTSettings::getBufferFloatPrecisionAsGLint() const
     return mCurrentBufferFloatPrecision == Float_16Bit ? GL_RGB16F : GL_RGB32F;
 }
 
+/*!
+Set if the cube maps of non linear projections (fisheye, spherical mirror and spout) should be rendered in a single layered pass.
+The draw callback is then called once per eye instead of once per cube face, and the application must render to all enabled faces
+itself, typically using a geometry shader that writes gl_Layer, or instancing with gl_Layer in the vertex shader. The face matrices
+are available in this uniform block at the binding point set by setLayeredCubemapUniformBlockBinding:
+
+\code
+layout(std140) uniform CubeFaces
+{
+    mat4 faceMVP[6]; //projection * view * scene transform
+    mat4 faceMV[6]; //view * scene transform
+    ivec4 faceEnabled[6]; //x is 1 if the face should be rendered
+};
+\endcode
+
+Layered rendering is not used with MSAA, depth textures or the fixed pipeline; the faces are then rendered one at a time as usual.
+Use Engine::isRenderingLayeredCubemap in the draw callback to find out which mode is active. Must be set before Engine::init.
+*/
+void sgct::SGCTSettings::setUseLayeredCubemapRendering(bool state)
+{
+    mUseLayeredCubemapRendering = state;
+}
+
+/*!
+Set the uniform buffer binding point of the CubeFaces uniform block used in layered cube map rendering. Default is 0.
+*/
+void sgct::SGCTSettings::setLayeredCubemapUniformBlockBinding(unsigned int binding)
+{
+    mLayeredCubemapUniformBlockBinding = binding;
+}
+
+/*!
+Get if layered cube map rendering is requested
+*/
+const bool sgct::SGCTSettings::getUseLayeredCubemapRendering() const
+{
+    return mUseLayeredCubemapRendering;
+}
+
+/*!
+Get the uniform buffer binding point of the CubeFaces uniform block used in layered cube map rendering
+*/
+const unsigned int sgct::SGCTSettings::getLayeredCubemapUniformBlockBinding() const
+{
+    return mLayeredCubemapUniformBlockBinding;
+}
+
+/*!
+Set if each viewport and eye should be composited to the window in a single shader pass. The blend and black level masks
+are then pre-multiplied into one texture when they are loaded (see sgct_core::MaskCombiner), and the overlay and the window's
+gamma, contrast and brightness are applied in the same pass instead of drawing the overlay to the framebuffer texture, making
+separate blended passes for the masks and setting the monitor's gamma ramp.
+
+The compositor is used for mono and active stereo windows that render to an FBO with the programmable pipeline, other
+windows use the separate passes. Overlays are drawn on top of the draw2D callback's output and are not part of the captured
+framebuffer texture in this mode. Must be set before Engine::init, or in the configuration with
+<Display singlePassCompositor="true" /> in the Settings element.
+*/
+void sgct::SGCTSettings::setUseSinglePassCompositor(bool state)
+{
+    mUseSinglePassCompositor = state;
+}
+
+/*!
+Get if the single pass compositor is used
+*/
+const bool sgct::SGCTSettings::getUseSinglePassCompositor() const
+{
+    return mUseSinglePassCompositor;
+}
+
+/*!
+Set if windows with the same framebuffer size and color format should share the textures that are only used while the
+window is rendered, the post effect source and pool textures. The render graph gives the textures of one window to the
+others as their lifetimes never overlap. Disable this if the draw or postDraw callbacks read the current draw texture
+of a window after another window has been rendered, or in the configuration with <Display textureAliasing="false" />
+in the Settings element.
+*/
+void sgct::SGCTSettings::setUseTextureAliasing(bool state)
+{
+    mUseTextureAliasing = state;
+}
+
+/*!
+Get if transient framebuffer textures are shared between windows
+*/
+const bool sgct::SGCTSettings::getUseTextureAliasing() const
+{
+    return mUseTextureAliasing;
+}
+
+/*!
+Set if the render resolution of the windows' FBOs should follow the frame time. The master lowers the scale of the
+resolution when the slowest node's draw or GPU time gets close to the frame budget and raises it again when there is
+headroom, see sgct_core::ResolutionScaler. The scale is synchronized so that all nodes render at the same scale.
+Cubemaps of non-linear projections keep their resolution. Must be set before Engine::init, or in the configuration
+with <Display dynamicResolution="true" frameBudget="16.6" minResolutionScale="0.5" /> in the Settings element.
+*/
+void sgct::SGCTSettings::setUseDynamicResolution(bool state)
+{
+    mUseDynamicResolution = state;
+}
+
+/*!
+Set the frame time in seconds that dynamic resolution scaling aims to stay within. If zero (default) the refresh rate
+hint is used, or 60 Hz if no hint is set.
+*/
+void sgct::SGCTSettings::setDynamicResolutionBudget(float seconds)
+{
+    mDynamicResolutionBudget = seconds;
+}
+
+/*!
+Set the lowest scale of the render resolution that dynamic resolution scaling may use (default 0.5).
+*/
+void sgct::SGCTSettings::setMinResolutionScale(float scale)
+{
+    mMinResolutionScale = scale;
+}
+
+/*!
+Get if dynamic resolution scaling is used
+*/
+const bool sgct::SGCTSettings::getUseDynamicResolution() const
+{
+    return mUseDynamicResolution;
+}
+
+/*!
+Get the frame time budget of dynamic resolution scaling in seconds, zero if it is derived from the refresh rate
+*/
+const float sgct::SGCTSettings::getDynamicResolutionBudget() const
+{
+    return mDynamicResolutionBudget;
+}
+
+/*!
+Get the lowest scale of the render resolution
+*/
+const float sgct::SGCTSettings::getMinResolutionScale() const
+{
+    return mMinResolutionScale;
+}
+
 /*!
 Get the default MSAA setting
 */
@@ -41,6 +41,10 @@ sgct::SGCTTrackingDevice::SGCTTrackingDevice(size_t parentIndex, std::string nam
     mAnalogTime[0] = 0.0;
     mAnalogTime[1] = 0.0;
     mSensorId = -1;
+
+    PoseHistory history;
+    history.count = 0;
+    mPoseHistory.set(history);
 }
 
 /*!
@@ -137,8 +141,18 @@ void sgct::SGCTTrackingDevice::setNumberOfAxes(size_t numOfAxes)
     }
 }
 
-void sgct::SGCTTrackingDevice::setSensorTransform(glm::dvec3 vec, glm::dquat rot)
+/*!
+Set the sensor pose of a new tracker report
+
+\param vec the scaled sensor position
+\param rot the sensor rotation
+\param time the time stamp of the report, if negative the current time is used
+*/
+void sgct::SGCTTrackingDevice::setSensorTransform(glm::dvec3 vec, glm::dquat rot, double time)
 {
+    if (time < 0.0)
+        time = sgct::Engine::getTime();
+
     sgct::SGCTTracker * parent = sgct_core::ClusterManager::instance()->getTrackingManagerPtr()->getTrackerPtr(mParentIndex);
 
     if (parent == NULL)
@@ -184,12 +198,30 @@ void sgct::SGCTTrackingDevice::setSensorTransform(glm::dvec3 vec, glm::dquat rot
     glm::vec4 worldSensorPos = glm::transpose(systemTransformMatrix) * glm::vec4( sensorPos, 1.0f);
     mWorldTransform[CURRENT] = glm::translate(glm::mat4(1.0f), glm::vec3(worldSensorPos)) * worldSensorRot;*/
 
+    glm::mat4 deviceTransform = mDeviceTransformMatrix;
+
     SGCTMutexManager::instance()->unlockMutex(SGCTMutexManager::TrackingMutex);
 
-    setTrackerTimeStamp();
+    setTrackerTimeStamp(time);
+
+    //publish the sample for prediction, only the sampling thread writes so it's safe to modify a copy
+    PoseHistory history = mPoseHistory.get();
+    history.samples[2] = history.samples[1];
+    history.samples[1] = history.samples[0];
+    history.samples[0].position = vec;
+    history.samples[0].rotation = rot;
+    history.samples[0].systemTransform = systemTransformMatrix;
+    history.samples[0].deviceTransform = deviceTransform;
+    history.samples[0].time = time;
+    if (history.count < 3)
+        history.count++;
+    mPoseHistory.set(history);
 }
 
-void sgct::SGCTTrackingDevice::setButtonVal(const bool val, size_t index)
+/*!
+Set the state of a button, if the time is negative the current time is used as time stamp
+*/
+void sgct::SGCTTrackingDevice::setButtonVal(const bool val, size_t index, double time)
 {
     if( index < mNumberOfButtons )
     {
@@ -199,11 +231,14 @@ void sgct::SGCTTrackingDevice::setButtonVal(const bool val, size_t index)
         mButtons[index] = val;
         SGCTMutexManager::instance()->unlockMutex(SGCTMutexManager::TrackingMutex);
 
-        setButtonTimeStamp(index);
+        setButtonTimeStamp(index, time < 0.0 ? sgct::Engine::getTime() : time);
     }
 }
 
-void sgct::SGCTTrackingDevice::setAnalogVal(const double * array, size_t size)
+/*!
+Set the analog values, if the time is negative the current time is used as time stamp
+*/
+void sgct::SGCTTrackingDevice::setAnalogVal(const double * array, size_t size, double time)
 {
     SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex);
     for (size_t i = 0; i < size; i++)
@@ -216,7 +251,7 @@ void sgct::SGCTTrackingDevice::setAnalogVal(const double * array, size_t size)
     }
     SGCTMutexManager::instance()->unlockMutex(SGCTMutexManager::TrackingMutex);
 
-    setAnalogTimeStamp();
+    setAnalogTimeStamp(time < 0.0 ? sgct::Engine::getTime() : time);
 }
 
 /*!
@@ -440,6 +475,89 @@ glm::dvec3 sgct::SGCTTrackingDevice::getSensorPosition(DataLoc i)
     return tmpVec;
 }
 
+/*!
+Extrapolates the sensor pose from the latest samples without locking the tracking mutex. Samples older
+than 100 ms are not extrapolated and the extrapolation is limited to 100 ms.
+
+\param time the time, as given by sgct::Engine::getTime, when the pose will be visible, for example the expected swap time
+\param mode constant velocity uses the two latest samples, constant acceleration uses three
+\returns the predicted transform matrix in world coordinates
+*/
+glm::mat4 sgct::SGCTTrackingDevice::getPredictedWorldTransform(double time, PredictionMode mode)
+{
+    const double maxPrediction = 0.1;
+
+    PoseHistory history = mPoseHistory.get();
+    if (history.count == 0)
+        return getWorldTransform();
+
+    const PoseSample & s0 = history.samples[0];
+    glm::dvec3 position = s0.position;
+    glm::dquat rotation = s0.rotation;
+
+    double dt = time - s0.time;
+    double dt01 = history.count > 1 ? s0.time - history.samples[1].time : 0.0;
+    if (mode != NoPrediction && dt > 0.0 && dt < maxPrediction && dt01 > 0.0)
+    {
+        const PoseSample & s1 = history.samples[1];
+
+        glm::dvec3 velocity = (s0.position - s1.position) / dt01;
+        glm::dvec3 angularVelocity = getAngularVelocity(s1.rotation, s0.rotation, dt01);
+
+        glm::dvec3 deltaPos = velocity * dt;
+        glm::dvec3 deltaRot = angularVelocity * dt;
+
+        double dt12 = history.count > 2 ? s1.time - history.samples[2].time : 0.0;
+        if (mode == ConstantAcceleration && dt12 > 0.0)
+        {
+            const PoseSample & s2 = history.samples[2];
+            double dtMid = 0.5 * (dt01 + dt12);
+
+            glm::dvec3 acceleration = (velocity - (s1.position - s2.position) / dt12) / dtMid;
+            glm::dvec3 angularAcceleration = (angularVelocity - getAngularVelocity(s2.rotation, s1.rotation, dt12)) / dtMid;
+
+            //the velocities are the averages between the samples, a half sample interval behind the latest one
+            deltaPos += 0.5 * acceleration * dt * (dt + dt01);
+            deltaRot += 0.5 * angularAcceleration * dt * (dt + dt01);
+        }
+
+        position += deltaPos;
+
+        double angle = glm::length(deltaRot);
+        if (angle > 1e-9)
+            rotation = glm::normalize(glm::angleAxis(angle, deltaRot / angle) * rotation);
+    }
+
+    glm::quat sensorRot(
+        static_cast<float>(rotation.w),
+        static_cast<float>(rotation.x),
+        static_cast<float>(rotation.y),
+        static_cast<float>(rotation.z));
+
+    return s0.systemTransform *
+        glm::translate(glm::mat4(1.0f), glm::vec3(position)) *
+        glm::mat4_cast(sensorRot) *
+        s0.deviceTransform;
+}
+
+/*!
+\returns the angular velocity vector (axis times radians per second) that rotates from to to in dt seconds
+*/
+glm::dvec3 sgct::SGCTTrackingDevice::getAngularVelocity(const glm::dquat & from, const glm::dquat & to, double dt)
+{
+    //use the shortest path
+    glm::dquat fromShortest = glm::dot(from, to) < 0.0 ? -from : from;
+    glm::dquat delta = to * glm::conjugate(fromShortest);
+
+    double w = delta.w < -1.0 ? -1.0 : (delta.w > 1.0 ? 1.0 : delta.w);
+    double angle = 2.0 * acos(w);
+    double s = sqrt(1.0 - w * w);
+    if (s < 1e-9 || dt <= 0.0)
+        return glm::dvec3(0.0);
+
+    return glm::dvec3(delta.x, delta.y, delta.z) / s * (angle / dt);
+}
+
 bool sgct::SGCTTrackingDevice::isEnabled()
 {
     bool tmpVal;
@@ -453,30 +571,30 @@ bool sgct::SGCTTrackingDevice::isEnabled()
     return tmpVal;
 }
 
-void sgct::SGCTTrackingDevice::setTrackerTimeStamp()
+void sgct::SGCTTrackingDevice::setTrackerTimeStamp(double time)
 {
     SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex);
     //swap
     mTrackerTime[1] = mTrackerTime[0];
-    mTrackerTime[0] = sgct::Engine::getTime();
+    mTrackerTime[0] = time;
     SGCTMutexManager::instance()->unlockMutex(SGCTMutexManager::TrackingMutex);
 }
 
-void sgct::SGCTTrackingDevice::setAnalogTimeStamp()
+void sgct::SGCTTrackingDevice::setAnalogTimeStamp(double time)
 {
     SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex);
     //swap
     mAnalogTime[1] = mAnalogTime[0];
-    mAnalogTime[0] = sgct::Engine::getTime();
+    mAnalogTime[0] = time;
     SGCTMutexManager::instance()->unlockMutex(SGCTMutexManager::TrackingMutex);
 }
 
-void sgct::SGCTTrackingDevice::setButtonTimeStamp(size_t index)
+void sgct::SGCTTrackingDevice::setButtonTimeStamp(size_t index, double time)
 {
     SGCTMutexManager::instance()->lockMutex(SGCTMutexManager::TrackingMutex);
     //swap
     mButtonTime[index + mNumberOfButtons] = mButtonTime[index];
-    mButtonTime[index] = sgct::Engine::getTime();
+    mButtonTime[index] = time;
     SGCTMutexManager::instance()->unlockMutex(SGCTMutexManager::TrackingMutex);
 }
 
@@ -10,6 +10,7 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include "../include/vrpn/vrpn_Tracker.h"
 #include "../include/vrpn/vrpn_Button.h"
 #include "../include/vrpn/vrpn_Analog.h"
+#include "../include/vrpn/vrpn_Connection.h"
 
 #include <sgct/SGCTTracker.h>
 #include <sgct/ClusterManager.h>
@@ -19,6 +20,8 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <glm/gtc/type_ptr.hpp>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/euler_angles.hpp>
+#include <atomic>
+#include <algorithm>
 
 struct VRPNPointer
 {
@@ -34,11 +37,17 @@ struct VRPNTracker
 
 std::vector<VRPNTracker> gTrackers;
 
+//number of received VRPN reports, used by the event driven sampling to detect if a wait returned without data
+std::atomic<unsigned int> gNumberOfReports(0);
+
 void VRPN_CALLBACK update_tracker_cb(void *userdata, const vrpn_TRACKERCB t );
 void VRPN_CALLBACK update_button_cb(void *userdata, const vrpn_BUTTONCB b );
 void VRPN_CALLBACK update_analog_cb(void * userdata, const vrpn_ANALOGCB a );
 
 void samplingLoop(void *arg);
+void eventSamplingLoop(void *arg);
+void replayLoop(void *arg);
+size_t getDeviceIndex(sgct::SGCTTrackingDevice * devicePtr);
 
 sgct::SGCTTrackingManager::SGCTTrackingManager()
 {
@@ -48,6 +57,15 @@ sgct::SGCTTrackingManager::SGCTTrackingManager()
     mSamplingThread = NULL;
     mSamplingTime = 0.0;
     mRunning = true;
+    mEventDrivenSampling = false;
+
+    mPredictionMode = SGCTTrackingDevice::NoPrediction;
+    mPredictionExtraLatency = 0.0;
+    mSwapLatency = 0.0;
+    mLastUpdateTime = 0.0;
+
+    mReplayRealTime = true;
+    mReplayLoop = false;
 }
 
 bool sgct::SGCTTrackingManager::isRunning()
@@ -139,7 +157,15 @@ void sgct::SGCTTrackingManager::startSampling()
         setHeadTracker(mHeadUser->getHeadTrackerName(),
             mHeadUser->getHeadTrackerDeviceName());
 
-        mSamplingThread = new std::thread( samplingLoop, this );
+        if( !mRecordFilename.empty() && !isReplaying() )
+            mRecorder.start( mRecordFilename );
+
+        if( isReplaying() )
+            mSamplingThread = new std::thread( replayLoop, this );
+        else if( mEventDrivenSampling )
+            mSamplingThread = new std::thread( eventSamplingLoop, this );
+        else
+            mSamplingThread = new std::thread( samplingLoop, this );
     }
 }
 
@@ -148,15 +174,16 @@ void sgct::SGCTTrackingManager::startSampling()
 */
 void sgct::SGCTTrackingManager::updateTrackingDevices()
 {
-    for(size_t i=0; i<mTrackers.size(); i++)
-        for(size_t j=0; j<mTrackers[i]->getNumberOfDevices(); j++)
-        {
-            SGCTTrackingDevice * tdPtr = mTrackers[i]->getDevicePtr(j);
-            if( tdPtr->isEnabled() && tdPtr == mHead && mHeadUser != NULL)
-            {
-                mHeadUser->setTransform(tdPtr->getWorldTransform());
-            }
-        }
+    mLastUpdateTime = sgct::Engine::getTime();
+
+    if( mHead != NULL && mHeadUser != NULL && mHead->isEnabled() )
+    {
+        if( mPredictionMode != SGCTTrackingDevice::NoPrediction )
+            mHeadUser->setTransform(mHead->getPredictedWorldTransform(
+                mLastUpdateTime + mSwapLatency + mPredictionExtraLatency, mPredictionMode));
+        else
+            mHeadUser->setTransform(mHead->getWorldTransform());
+    }
 }
 
 void sgct::SGCTTrackingManager::addTracker(std::string name)
@@ -203,7 +230,7 @@ void sgct::SGCTTrackingManager::addSensorToCurrentDevice(const char * address, i
     {
         devicePtr->setSensorId( id );
 
-        if( retVal.second && (*ptr).mSensorDevice == NULL)
+        if( retVal.second && (*ptr).mSensorDevice == NULL && !isReplaying() )
         {
             MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Tracking: Connecting to sensor '%s'...\n", address);
             (*ptr).mSensorDevice = new vrpn_Tracker_Remote( address );
@@ -230,7 +257,11 @@ void sgct::SGCTTrackingManager::addButtonsToCurrentDevice(const char * address,
     VRPNPointer * ptr = &gTrackers.back().mDevices.back();
     SGCTTrackingDevice * devicePtr = mTrackers.back()->getLastDevicePtr();
 
-    if( (*ptr).mButtonDevice == NULL && devicePtr != NULL)
+    if( isReplaying() && devicePtr != NULL )
+    {
+        devicePtr->setNumberOfButtons( numOfButtons );
+    }
+    else if( (*ptr).mButtonDevice == NULL && devicePtr != NULL)
     {
         MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Tracking: Connecting to buttons '%s' on device %s...\n",
                     address, devicePtr->getName().c_str());
@@ -259,7 +290,11 @@ void sgct::SGCTTrackingManager::addAnalogsToCurrentDevice(const char * address,
     VRPNPointer * ptr = &gTrackers.back().mDevices.back();
     SGCTTrackingDevice * devicePtr = mTrackers.back()->getLastDevicePtr();
 
-    if( (*ptr).mAnalogDevice == NULL && devicePtr != NULL)
+    if( isReplaying() && devicePtr != NULL )
+    {
+        devicePtr->setNumberOfAxes( numOfAxes );
+    }
+    else if( (*ptr).mAnalogDevice == NULL && devicePtr != NULL)
     {
         MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Tracking: Connecting to analogs '%s' on device %s...\n",
                 address, devicePtr->getName().c_str());
@@ -336,6 +371,119 @@ void samplingLoop(void *arg)
     }
 }
 
+/*
+    Waits for data on the VRPN connections instead of sleeping. The first connection is waited on
+    and the remaining ones are polled, in most setups all devices share one connection.
+*/
+void eventSamplingLoop(void *arg)
+{
+    sgct::SGCTTrackingManager * tmPtr =
+        reinterpret_cast<sgct::SGCTTrackingManager *>(arg);
+
+    std::vector<vrpn_Connection *> connections;
+    for(size_t i=0; i<gTrackers.size(); i++)
+        for(size_t j=0; j<gTrackers[i].mDevices.size(); j++)
+        {
+            vrpn_BaseClass * devices[3] = {
+                gTrackers[i].mDevices[j].mSensorDevice,
+                gTrackers[i].mDevices[j].mAnalogDevice,
+                gTrackers[i].mDevices[j].mButtonDevice };
+
+            for(size_t k=0; k<3; k++)
+                if( devices[k] != NULL && devices[k]->connectionPtr() != NULL &&
+                    std::find(connections.begin(), connections.end(), devices[k]->connectionPtr()) == connections.end() )
+                    connections.push_back( devices[k]->connectionPtr() );
+        }
+
+    double t;
+    bool running = true;
+
+    while(running)
+    {
+        t = sgct::Engine::getTime();
+        unsigned int reports = gNumberOfReports.load();
+
+        //wait at most 2 ms for data so that a stop request is noticed
+        timeval timeout;
+        timeout.tv_sec = 0;
+        timeout.tv_usec = 2000;
+        if( !connections.empty() )
+            connections[0]->mainloop(&timeout);
+
+        for(size_t i=0; i<tmPtr->getNumberOfTrackers(); i++)
+        {
+            sgct::SGCTTracker * trackerPtr = tmPtr->getTrackerPtr(i);
+
+            if( trackerPtr != NULL )
+            {
+                for(size_t j=0; j<trackerPtr->getNumberOfDevices(); j++)
+                {
+                    if( trackerPtr->getDevicePtr(j)->isEnabled() )
+                    {
+                        if( gTrackers[i].mDevices[j].mSensorDevice != NULL )
+                            gTrackers[i].mDevices[j].mSensorDevice->mainloop();
+
+                        if( gTrackers[i].mDevices[j].mAnalogDevice != NULL )
+                            gTrackers[i].mDevices[j].mAnalogDevice->mainloop();
+
+                        if( gTrackers[i].mDevices[j].mButtonDevice != NULL )
+                            gTrackers[i].mDevices[j].mButtonDevice->mainloop();
+                    }
+                }
+            }
+        }
+
+        running = tmPtr->isRunning();
+
+        tmPtr->setSamplingTime(sgct::Engine::getTime() - t);
+
+        //the wait returns immediately while a connection is being established, don't eat the CPU then
+        if( gNumberOfReports.load() == reports && sgct::Engine::getTime() - t < 0.0005 )
+            vrpn_SleepMsecs(1);
+    }
+}
+
+/*
+    Applies the records of a replay to the devices instead of reading VRPN.
+*/
+void replayLoop(void *arg)
+{
+    sgct::SGCTTrackingManager * tmPtr =
+        reinterpret_cast<sgct::SGCTTrackingManager *>(arg);
+    sgct::SGCTTrackingPlayer * playerPtr = tmPtr->getPlayerPtr();
+
+    double startTime = sgct::Engine::getTime();
+    playerPtr->setTimeOffset(startTime);
+
+    double t;
+    bool running = true;
+
+    while(running)
+    {
+        t = sgct::Engine::getTime();
+
+        if( tmPtr->isReplayRealTime() )
+            playerPtr->playUntil(t - startTime);
+        else
+            playerPtr->playNext();
+
+        if( playerPtr->isAtEnd() && tmPtr->isReplayLooping() )
+        {
+            //keep the time stamps increasing over the restart
+            startTime = tmPtr->isReplayRealTime() ? sgct::Engine::getTime() : startTime + playerPtr->getTime();
+            playerPtr->setTimeOffset(startTime);
+            playerPtr->rewind();
+        }
+
+        running = tmPtr->isRunning();
+
+        tmPtr->setSamplingTime(sgct::Engine::getTime() - t);
+
+        if( tmPtr->isReplayRealTime() || playerPtr->isAtEnd() )
+            vrpn_SleepMsecs(1);
+    }
+}
+
 sgct::SGCTTracker * sgct::SGCTTrackingManager::getLastTrackerPtr()
 {
     return mTrackers.size() > 0 ? mTrackers.back() : NULL;
@@ -368,6 +516,81 @@ void sgct::SGCTTrackingManager::setEnabled(bool state)
     }
 }
 
+/*!
+Set if the sampling thread should wait for data on the VRPN connection sockets instead of polling every millisecond.
+Reports are then handled as soon as they arrive. Must be set before the sampling is started.
+*/
+void sgct::SGCTTrackingManager::setEventDrivenSampling(bool state)
+{
+    mEventDrivenSampling = state;
+}
+
+/*!
+Set if the head pose should be extrapolated to the time when the frame is expected to be shown,
+which is the measured time until the buffer swap plus the extra latency.
+
+\param mode the prediction mode
+\param extraLatency additional time in seconds, for example the latency of the display
+*/
+void sgct::SGCTTrackingManager::setPrediction(SGCTTrackingDevice::PredictionMode mode, double extraLatency)
+{
+    mPredictionMode = mode;
+    mPredictionExtraLatency = extraLatency;
+}
+
+/*!
+Called by the engine after the buffer swap to measure the time from the head tracking update to the swap.
+*/
+void sgct::SGCTTrackingManager::setSwapTime(double t)
+{
+    if( mLastUpdateTime <= 0.0 || t < mLastUpdateTime )
+        return;
+
+    //smooth the latency to avoid jitter in the prediction
+    double latency = t - mLastUpdateTime;
+    mSwapLatency = mSwapLatency <= 0.0 ? latency : mSwapLatency + 0.1 * (latency - mSwapLatency);
+}
+
+/*!
+Set a file to record all VRPN reports to. The recording starts with the sampling, use getRecorderPtr()
+to start and stop recordings at runtime.
+*/
+void sgct::SGCTTrackingManager::setRecordFile(const std::string & filename)
+{
+    mRecordFilename = filename;
+}
+
+/*!
+Replay tracking data from a recording instead of reading VRPN. Must be set before the configuration is
+read to avoid connecting to the VRPN servers.
+
+\returns false if the recording couldn't be opened
+*/
+bool sgct::SGCTTrackingManager::setReplayFile(const std::string & filename)
+{
+    if( !mPlayer.open(filename) )
+        return false;
+
+    MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Tracking: Replaying tracking data from '%s'.\n", filename.c_str());
+    return true;
+}
+
+/*!
+Set if the replay should follow the recorded timing (default) or apply the records as fast as possible.
+*/
+void sgct::SGCTTrackingManager::setReplayRealTime(bool state)
+{
+    mReplayRealTime = state;
+}
+
+/*!
+Set if the replay should restart when the end of the recording is reached.
+*/
+void sgct::SGCTTrackingManager::setReplayLoop(bool state)
+{
+    mReplayLoop = state;
+}
+
 void sgct::SGCTTrackingManager::setSamplingTime(double t)
 {
 #ifdef __SGCT_TRACKING_MUTEX_DEBUG__
@@ -408,7 +631,13 @@ void VRPN_CALLBACK update_tracker_cb(void *userdata, const vrpn_TRACKERCB info)
 
     glm::dquat rotation(info.quat[3], info.quat[0], info.quat[1], info.quat[2]);
 
-    devicePtr->setSensorTransform(posVec, rotation);
+    double time = sgct::Engine::getTime();
+    devicePtr->setSensorTransform(posVec, rotation, time);
+    gNumberOfReports++;
+
+    sgct::SGCTTrackingRecorder * recorderPtr = sgct_core::ClusterManager::instance()->getTrackingManagerPtr()->getRecorderPtr();
+    if( recorderPtr->isRecording() )
+        recorderPtr->recordSensor(devicePtr->getParentIndex(), info.sensor, info.pos, info.quat, time);
 }
 
 void VRPN_CALLBACK update_button_cb(void *userdata, const vrpn_BUTTONCB b )
@@ -418,14 +647,37 @@ void VRPN_CALLBACK update_button_cb(void *userdata, const vrpn_BUTTONCB b )
 
     //fprintf(stderr, "Button: %d, state: %d\n", b.button, b.state);
 
+    double time = sgct::Engine::getTime();
     b.state == 0 ?
-        devicePtr->setButtonVal( false, b.button) :
-        devicePtr->setButtonVal( true, b.button);
+        devicePtr->setButtonVal( false, b.button, time) :
+        devicePtr->setButtonVal( true, b.button, time);
+    gNumberOfReports++;
+
+    sgct::SGCTTrackingRecorder * recorderPtr = sgct_core::ClusterManager::instance()->getTrackingManagerPtr()->getRecorderPtr();
+    if( recorderPtr->isRecording() )
+        recorderPtr->recordButton(devicePtr->getParentIndex(), getDeviceIndex(devicePtr), b.button, b.state, time);
 }
 
 void VRPN_CALLBACK update_analog_cb(void* userdata, const vrpn_ANALOGCB a )
 {
     sgct::SGCTTrackingDevice * tdPtr =
         reinterpret_cast<sgct::SGCTTrackingDevice *>(userdata);
-    tdPtr->setAnalogVal( a.channel, static_cast<size_t>(a.num_channel));
+    double time = sgct::Engine::getTime();
+    tdPtr->setAnalogVal( a.channel, static_cast<size_t>(a.num_channel), time);
+    gNumberOfReports++;
+
+    sgct::SGCTTrackingRecorder * recorderPtr = sgct_core::ClusterManager::instance()->getTrackingManagerPtr()->getRecorderPtr();
+    if( recorderPtr->isRecording() )
+        recorderPtr->recordAnalog(tdPtr->getParentIndex(), getDeviceIndex(tdPtr), a.channel, static_cast<size_t>(a.num_channel), time);
+}
+
+size_t getDeviceIndex(sgct::SGCTTrackingDevice * devicePtr)
+{
+    sgct::SGCTTracker * trackerPtr = sgct_core::ClusterManager::instance()->getTrackingManagerPtr()->getTrackerPtr(devicePtr->getParentIndex());
+    if( trackerPtr != NULL )
+        for(size_t i=0; i<trackerPtr->getNumberOfDevices(); i++)
+            if( trackerPtr->getDevicePtr(i) == devicePtr )
+                return i;
+
+    return 0;
 }
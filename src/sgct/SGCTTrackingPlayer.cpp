@@ -0,0 +1,230 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#include <sgct/SGCTTrackingPlayer.h>
+#include <sgct/SGCTTrackingManager.h>
+#include <sgct/ClusterManager.h>
+#include <sgct/MessageHandler.h>
+#include <stdint.h>
+#include <string.h>
+
+//VRPN limits the number of analog channels to 128
+#define MAX_RECORD_VALUES 128
+
+sgct::SGCTTrackingPlayer::SGCTTrackingPlayer()
+{
+    mFile = NULL;
+    mHasPending = false;
+    mEndOfFile = true;
+    mTimeOffset = 0.0;
+    mTime = 0.0;
+}
+
+sgct::SGCTTrackingPlayer::~SGCTTrackingPlayer()
+{
+    close();
+}
+
+/*!
+Opens a recording and checks its header.
+
+\returns false if the file couldn't be opened or isn't a tracking recording
+*/
+bool sgct::SGCTTrackingPlayer::open(const std::string & filename)
+{
+    close();
+
+#if (_MSC_VER >= 1400) //visual studio 2005 or later
+    if( fopen_s(&mFile, filename.c_str(), "rb") != 0 )
+        mFile = NULL;
+#else
+    mFile = fopen(filename.c_str(), "rb");
+#endif
+
+    if( mFile == NULL )
+    {
+        MessageHandler::instance()->print(MessageHandler::NOTIFY_ERROR, "SGCTTrackingPlayer: Failed to open '%s'!\n", filename.c_str());
+        return false;
+    }
+
+    char header[SGCTTrackingRecorder::HeaderSize];
+    if( fread(header, 1, SGCTTrackingRecorder::HeaderSize, mFile) != SGCTTrackingRecorder::HeaderSize ||
+        memcmp(header, "SGCTTRK", 7) != 0 ||
+        static_cast<unsigned char>(header[7]) != SGCTTrackingRecorder::FormatVersion )
+    {
+        MessageHandler::instance()->print(MessageHandler::NOTIFY_ERROR, "SGCTTrackingPlayer: '%s' is not a supported tracking recording!\n", filename.c_str());
+        close();
+        return false;
+    }
+
+    mFilename = filename;
+    mHasPending = false;
+    mEndOfFile = false;
+    mTime = 0.0;
+    return true;
+}
+
+void sgct::SGCTTrackingPlayer::close()
+{
+    if( mFile != NULL )
+    {
+        fclose(mFile);
+        mFile = NULL;
+    }
+
+    mHasPending = false;
+    mEndOfFile = true;
+}
+
+/*!
+Restarts the replay from the first record
+*/
+void sgct::SGCTTrackingPlayer::rewind()
+{
+    if( mFile == NULL )
+        return;
+
+    fseek(mFile, static_cast<long>(SGCTTrackingRecorder::HeaderSize), SEEK_SET);
+    mHasPending = false;
+    mEndOfFile = false;
+    mTime = 0.0;
+}
+
+/*!
+Reads the next record without applying it.
+
+\returns false at the end of the recording or if the record is corrupt
+*/
+bool sgct::SGCTTrackingPlayer::readRecord(SGCTTrackingRecorder::Record & record)
+{
+    if( mHasPending )
+    {
+        record = mPending;
+        mHasPending = false;
+        return true;
+    }
+
+    if( mFile == NULL || mEndOfFile )
+        return false;
+
+    unsigned char header[SGCTTrackingRecorder::RecordHeaderSize];
+    if( fread(header, 1, SGCTTrackingRecorder::RecordHeaderSize, mFile) != SGCTTrackingRecorder::RecordHeaderSize )
+    {
+        mEndOfFile = true;
+        return false;
+    }
+
+    uint16_t tracker;
+    int32_t device;
+    uint32_t count;
+    memcpy(&tracker, header + 2, 2);
+    memcpy(&device, header + 4, 4);
+    memcpy(&count, header + 8, 4);
+    memcpy(&record.time, header + 16, 8);
+
+    if( header[0] > SGCTTrackingRecorder::AnalogRecord || count > MAX_RECORD_VALUES )
+    {
+        MessageHandler::instance()->print(MessageHandler::NOTIFY_ERROR, "SGCTTrackingPlayer: Corrupt record in '%s'!\n", mFilename.c_str());
+        mEndOfFile = true;
+        return false;
+    }
+
+    record.type = static_cast<SGCTTrackingRecorder::RecordType>(header[0]);
+    record.tracker = tracker;
+    record.device = device;
+    record.values.resize(count);
+    if( count > 0 && fread(&record.values[0], sizeof(double), count, mFile) != count )
+    {
+        mEndOfFile = true;
+        return false;
+    }
+
+    return true;
+}
+
+/*!
+Applies the next record to its device.
+
+\returns false at the end of the recording
+*/
+bool sgct::SGCTTrackingPlayer::playNext()
+{
+    SGCTTrackingRecorder::Record record;
+    if( !readRecord(record) )
+        return false;
+
+    apply(record);
+    return true;
+}
+
+/*!
+Applies all records up to the given time in the recording.
+
+\param time seconds since the start of the recording
+\returns the number of applied records
+*/
+size_t sgct::SGCTTrackingPlayer::playUntil(double time)
+{
+    size_t played = 0;
+    while( readRecord(mPending) )
+    {
+        if( mPending.time > time )
+        {
+            mHasPending = true;
+            break;
+        }
+
+        apply(mPending);
+        played++;
+    }
+
+    return played;
+}
+
+void sgct::SGCTTrackingPlayer::apply(const SGCTTrackingRecorder::Record & record)
+{
+    mTime = record.time;
+
+    SGCTTracker * trackerPtr = sgct_core::ClusterManager::instance()->getTrackingManagerPtr()->getTrackerPtr(record.tracker);
+    if( trackerPtr == NULL )
+        return;
+
+    double time = record.time + mTimeOffset;
+
+    switch( record.type )
+    {
+    case SGCTTrackingRecorder::SensorRecord:
+        if( record.values.size() == 7 )
+        {
+            SGCTTrackingDevice * devicePtr = trackerPtr->getDevicePtrBySensorId(record.device);
+            if( devicePtr != NULL )
+                devicePtr->setSensorTransform(
+                    glm::dvec3(record.values[0], record.values[1], record.values[2]) * trackerPtr->getScale(),
+                    glm::dquat(record.values[6], record.values[3], record.values[4], record.values[5]),
+                    time);
+        }
+        break;
+
+    case SGCTTrackingRecorder::ButtonRecord:
+        if( record.values.size() == 2 && record.device >= 0 )
+        {
+            SGCTTrackingDevice * devicePtr = trackerPtr->getDevicePtr(static_cast<size_t>(record.device));
+            if( devicePtr != NULL && record.values[0] >= 0.0 )
+                devicePtr->setButtonVal(record.values[1] != 0.0, static_cast<size_t>(record.values[0]), time);
+        }
+        break;
+
+    case SGCTTrackingRecorder::AnalogRecord:
+        if( record.device >= 0 )
+        {
+            SGCTTrackingDevice * devicePtr = trackerPtr->getDevicePtr(static_cast<size_t>(record.device));
+            if( devicePtr != NULL && !record.values.empty() )
+                devicePtr->setAnalogVal(&record.values[0], record.values.size(), time);
+        }
+        break;
+    }
+}
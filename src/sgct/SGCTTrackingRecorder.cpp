@@ -0,0 +1,145 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#include <sgct/SGCTTrackingRecorder.h>
+#include <sgct/MessageHandler.h>
+#include <sgct/Engine.h>
+#include <stdint.h>
+#include <string.h>
+
+const unsigned char sgct::SGCTTrackingRecorder::FormatVersion;
+const size_t sgct::SGCTTrackingRecorder::HeaderSize;
+const size_t sgct::SGCTTrackingRecorder::RecordHeaderSize;
+
+sgct::SGCTTrackingRecorder::SGCTTrackingRecorder()
+{
+    mRecording = false;
+    mFile = NULL;
+    mStartTime = 0.0;
+    mNumberOfRecords = 0;
+}
+
+sgct::SGCTTrackingRecorder::~SGCTTrackingRecorder()
+{
+    stop();
+}
+
+/*!
+Starts recording to a file, an existing file is overwritten.
+
+\returns false if the file couldn't be created
+*/
+bool sgct::SGCTTrackingRecorder::start(const std::string & filename)
+{
+    stop();
+
+    std::unique_lock<std::mutex> lock(mMutex);
+
+#if (_MSC_VER >= 1400) //visual studio 2005 or later
+    if( fopen_s(&mFile, filename.c_str(), "wb") != 0 )
+        mFile = NULL;
+#else
+    mFile = fopen(filename.c_str(), "wb");
+#endif
+
+    if( mFile == NULL )
+    {
+        lock.unlock();
+        MessageHandler::instance()->print(MessageHandler::NOTIFY_ERROR, "SGCTTrackingRecorder: Failed to create '%s'!\n", filename.c_str());
+        return false;
+    }
+
+    //reports are small, let the file buffer them
+    setvbuf(mFile, NULL, _IOFBF, 64 * 1024);
+
+    char header[HeaderSize] = { 'S', 'G', 'C', 'T', 'T', 'R', 'K', static_cast<char>(FormatVersion) };
+    fwrite(header, 1, HeaderSize, mFile);
+
+    mStartTime = sgct::Engine::getTime();
+    mNumberOfRecords = 0;
+    mRecording = true;
+
+    lock.unlock();
+    MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "SGCTTrackingRecorder: Recording tracking data to '%s'.\n", filename.c_str());
+    return true;
+}
+
+/*!
+Stops the recording and closes the file
+*/
+void sgct::SGCTTrackingRecorder::stop()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    mRecording = false;
+    if( mFile == NULL )
+        return;
+
+    fclose(mFile);
+    mFile = NULL;
+    unsigned long long records = mNumberOfRecords;
+
+    lock.unlock();
+    MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "SGCTTrackingRecorder: Recorded %llu tracking reports.\n", records);
+}
+
+/*!
+Records a sensor report.
+
+\param pos the position as received from VRPN, not scaled
+\param quat the rotation as received from VRPN (x, y, z, w)
+\param time the arrival time of the report
+*/
+void sgct::SGCTTrackingRecorder::recordSensor(size_t trackerIndex, int sensorId, const double * pos, const double * quat, double time)
+{
+    double values[7] = { pos[0], pos[1], pos[2], quat[0], quat[1], quat[2], quat[3] };
+    write(SensorRecord, trackerIndex, sensorId, values, 7, time);
+}
+
+/*!
+Records a button report.
+*/
+void sgct::SGCTTrackingRecorder::recordButton(size_t trackerIndex, size_t deviceIndex, int button, int state, double time)
+{
+    double values[2] = { static_cast<double>(button), static_cast<double>(state) };
+    write(ButtonRecord, trackerIndex, static_cast<int>(deviceIndex), values, 2, time);
+}
+
+/*!
+Records an analog report with all its channels.
+*/
+void sgct::SGCTTrackingRecorder::recordAnalog(size_t trackerIndex, size_t deviceIndex, const double * values, size_t count, double time)
+{
+    write(AnalogRecord, trackerIndex, static_cast<int>(deviceIndex), values, count, time);
+}
+
+void sgct::SGCTTrackingRecorder::write(RecordType type, size_t trackerIndex, int device, const double * values, size_t count, double time)
+{
+    unsigned char header[RecordHeaderSize];
+    memset(header, 0, RecordHeaderSize);
+
+    uint16_t tracker = static_cast<uint16_t>(trackerIndex);
+    int32_t deviceVal = static_cast<int32_t>(device);
+    uint32_t countVal = static_cast<uint32_t>(count);
+
+    header[0] = static_cast<unsigned char>(type);
+    memcpy(header + 2, &tracker, 2);
+    memcpy(header + 4, &deviceVal, 4);
+    memcpy(header + 8, &countVal, 4);
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    if( mFile == NULL )
+        return;
+
+    double relTime = time - mStartTime;
+    memcpy(header + 16, &relTime, 8);
+
+    fwrite(header, 1, RecordHeaderSize, mFile);
+    if( count > 0 )
+        fwrite(values, sizeof(double), count, mFile);
+    mNumberOfRecords++;
+}
@@ -9,6 +9,7 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <sgct/Engine.h>
 #include <sgct/TextureManager.h>
 #include <sgct/MessageHandler.h>
+#include <sgct/FrameTrace.h>
 #include <sgct/ClusterManager.h>
 #include <sgct/SGCTSettings.h>
 #include <sgct/shaders/SGCTInternalShaders.h>
@@ -60,6 +61,7 @@ sgct::SGCTWindow::SGCTWindow(int id)
     mAllowCapture = true;
     mUseFXAA = SGCTSettings::instance()->getDefaultFXAAState();
     mUsePostFX = false;
+    mFusePostFX = true;
     mFocused = false;
     mIconified = false;
     mPreferBGR = true; //BGR is native on GPU
@@ -85,8 +87,9 @@ sgct::SGCTWindow::SGCTWindow(int id)
     mScale[0] = 0.0f;
     mScale[1] = 0.0f;
     mMonitorIndex = 0;
-    mFramebufferResolution[0] = 512;
-    mFramebufferResolution[1] = 256;
+    mResolutionScale = 1.0f;
+    mResolutionScaleChanged = false;
+    setUnscaledFramebufferResolution(512, 256);
     mAspectRatio = 1.0f;
     mGamma = 1.0f;
     mContrast = 1.0f;
@@ -129,7 +132,10 @@ sgct::SGCTWindow::SGCTWindow(int id)
 
     //FBO targets init
     for(int i=0; i<NUMBER_OF_TEXTURES; i++)
+    {
         mFrameBufferTextures[i] = GL_FALSE;
+        mAliasedTextures[i] = false;
+    }
 
     //pointers
     mMonitor = NULL;
@@ -232,6 +238,12 @@ void sgct::SGCTWindow::close()
         mPostFXPasses[i].destroy();
     mPostFXPasses.clear();
 
+    for (std::map<std::string, sgct::ShaderProgram>::iterator it = mFusedPostFXPrograms.begin(); it != mFusedPostFXPrograms.end(); ++it)
+        it->second.deleteProgram();
+    mFusedPostFXPrograms.clear();
+    mPostFXStagePrograms.clear();
+    mPostFXGraph.clear();
+
     MessageHandler::instance()->print(MessageHandler::NOTIFY_INFO, "Deleting screen capture data for window %d...\n", mId);
     for (int i = 0; i < 2; i++)
         if( mScreenCapture[i] )
@@ -251,13 +263,7 @@ void sgct::SGCTWindow::close()
         mFinalFBO_Ptr = NULL;
 
         for(unsigned int i=0; i<NUMBER_OF_TEXTURES; i++)
-        {
-            if( mFrameBufferTextures[i] != GL_FALSE )
-            {
-                glDeleteTextures(1, &mFrameBufferTextures[i]);
-                mFrameBufferTextures[i] = GL_FALSE;
-            }
-        }
+            deleteFrameBufferTexture(i);
     }
 
     if( mVBO )
@@ -376,7 +382,7 @@ void sgct::SGCTWindow::initContextSpecificOGL()
     for (std::size_t j = 0; j < getNumberOfViewports(); j++)
     {
         sgct_core::Viewport * vpPtr = getViewport(j);
-        vpPtr->loadData();
+        vpPtr->loadData(getAspectRatio());
         if (vpPtr->hasBlendMaskTexture())
             numberOfMasks++;
 
@@ -543,6 +549,7 @@ void sgct::SGCTWindow::swap(bool takeScreenshot)
         
         if (takeScreenshot)
         {
+            FrameTrace::Scope scope("capture", "window", mId);
             if (sgct::SGCTSettings::instance()->getCaptureFromBackBuffer() && mDoubleBuffered)
             {
                 if (mScreenCapture[0] != NULL)
@@ -608,8 +615,7 @@ void sgct::SGCTWindow::updateResolutions() {
         mHasPendingWindowRes = false;
     }
     if (mHasPendingFramebufferRes) {
-        mFramebufferResolution[0] = mPendingFramebufferRes[0];
-        mFramebufferResolution[1] = mPendingFramebufferRes[1];
+        setUnscaledFramebufferResolution(mPendingFramebufferRes[0], mPendingFramebufferRes[1]);
 
         MessageHandler::instance()->print(MessageHandler::NOTIFY_DEBUG,
             "SGCTWindow: Framebuffer resolution changed to %dx%d for window %d...\n",
@@ -653,23 +659,21 @@ void sgct::SGCTWindow::initWindowResolution(const int x, const int y)
     mIsWindowResSet = true;
 
     if( !mUseFixResolution )
-    {
-        mFramebufferResolution[0] = x;
-        mFramebufferResolution[1] = y;
-    }
+        setUnscaledFramebufferResolution(x, y);
 }
 
 /*
-\returns true if frame buffer is resized and window is visible.
+\returns true if frame buffer is resized and window is visible or if the resolution scale has changed.
 */
 bool sgct::SGCTWindow::update()
 {
-    if (mVisible && isWindowResized())
+    if ((mVisible && isWindowResized()) || mResolutionScaleChanged)
     {
         makeOpenGLContextCurrent(Window_Context);
 
         //resize FBOs
         resizeFBOs();
+        mResolutionScaleChanged = false;
 
         //resize PBOs
         for (int i = 0; i < 2; i++)
@@ -1046,10 +1050,7 @@ bool sgct::SGCTWindow::openWindow(GLFWwindow* share, size_t lastWindowIdx)
         mScale[0] = static_cast<float>(buffer_width) / static_cast<float>(mWindowRes[0]);
         mScale[1] = static_cast<float>(buffer_height) / static_cast<float>(mWindowRes[1]);
         if (!mUseFixResolution)
-        {
-            mFramebufferResolution[0] = buffer_width;
-            mFramebufferResolution[1] = buffer_height;
-        }
+            setUnscaledFramebufferResolution(buffer_width, buffer_height);
         
         /*
          Verified that sizes are set correctly
@@ -1372,14 +1373,16 @@ void sgct::SGCTWindow::createTextures()
                 generateTexture(i, mFramebufferResolution[0], mFramebufferResolution[1], DepthTexture, true );
             break;
 
+        //pool textures of the post effect chain, also resized if they were needed before passes were disabled
         case Engine::FX1:
-            if( !mPostFXPasses.empty() )
+            if( updatePostFXGraph().getNumberOfPoolBuffers() > 0 || mFrameBufferTextures[i] != GL_FALSE )
                 generateTexture(i, mFramebufferResolution[0], mFramebufferResolution[1], ColorTexture, true);
             break;
 
         case Engine::FX2:
-            if( mPostFXPasses.size() > 1 )
+            if( updatePostFXGraph().getNumberOfPoolBuffers() > 1 || mFrameBufferTextures[i] != GL_FALSE )
                 generateTexture(i, mFramebufferResolution[0], mFramebufferResolution[1], ColorTexture, true);
+            break;
 
         case Engine::Intermediate:
             if( mUsePostFX )
@@ -1414,11 +1417,7 @@ void sgct::SGCTWindow::createTextures()
 void sgct::SGCTWindow::generateTexture(unsigned int id, const int xSize, const int ySize, const sgct::SGCTWindow::TextureType type, const bool interpolate)
 {
     //clean up if needed
-    if( mFrameBufferTextures[id] != GL_FALSE )
-    {
-        glDeleteTextures(1, &mFrameBufferTextures[ id ]);
-        mFrameBufferTextures[id] = GL_FALSE;
-    }
+    deleteFrameBufferTexture(id);
 
     glGenTextures(1, &mFrameBufferTextures[id]);
     glBindTexture(GL_TEXTURE_2D, mFrameBufferTextures[id]);
@@ -1727,22 +1726,126 @@ void sgct::SGCTWindow::addPostFX( sgct::PostFX & fx )
     mPostFXPasses.push_back( fx );
 }
 
+/*!
+    Splits the post effect passes into stages again if passes have been added, enabled or disabled, or FXAA has been toggled.
+    \returns the post effect stages of this window
+*/
+const sgct_core::PostFXGraph & sgct::SGCTWindow::updatePostFXGraph()
+{
+    mPostFXPassStates.resize(mPostFXPasses.size());
+    for (std::size_t i = 0; i < mPostFXPasses.size(); i++)
+    {
+        mPostFXPassStates[i].enabled = mPostFXPasses[i].isEnabled();
+        mPostFXPassStates[i].perPixel = mPostFXPasses[i].isPerPixel();
+    }
+
+    if (mPostFXGraph.update(mPostFXPassStates, mUseFXAA, mFusePostFX && !Engine::instance()->isOGLPipelineFixed()))
+    {
+        mPostFXStagePrograms.assign(mPostFXGraph.getStages().size(), NULL);
+        MessageHandler::instance()->print(MessageHandler::NOTIFY_DEBUG, "SGCTWindow %d: Post effect chain of %u passes is rendered in %u stages using %u pool textures.\n",
+            mId, static_cast<unsigned int>(mPostFXPasses.size()), static_cast<unsigned int>(mPostFXGraph.getStages().size()), mPostFXGraph.getNumberOfPoolBuffers());
+    }
+
+    return mPostFXGraph;
+}
+
+/*!
+    Creates the shader program of a fused post effect stage the first time it is used. If the program can't be created
+    fusion is disabled for this window so that the next updatePostFXGraph renders the passes one at a time.
+    \returns the fused program of the stage or NULL if it couldn't be created
+*/
+sgct::ShaderProgram * sgct::SGCTWindow::getFusedPostFXProgram(std::size_t stageIndex)
+{
+    if (mPostFXStagePrograms[stageIndex] != NULL)
+        return mPostFXStagePrograms[stageIndex];
+
+    const sgct_core::PostFXGraph::Stage & stage = mPostFXGraph.getStages()[stageIndex];
+    std::string key = sgct_core::PostFXGraph::getStageKey(stage);
+
+    std::map<std::string, sgct::ShaderProgram>::iterator it = mFusedPostFXPrograms.find(key);
+    if (it != mFusedPostFXPrograms.end())
+    {
+        mPostFXStagePrograms[stageIndex] = &it->second;
+        return &it->second;
+    }
+
+    std::string name("FusedPostFX");
+    std::vector<std::string> effects;
+    for (std::size_t i = 0; i < stage.passes.size(); i++)
+    {
+        name += "_" + mPostFXPasses[stage.passes[i]].getName();
+        effects.push_back(mPostFXPasses[stage.passes[i]].getEffectSource());
+    }
+
+    std::string vertShader = sgct_core::shaders_modern::Overlay_Vert_Shader;
+    std::string fragShader = sgct_core::PostFXGraph::generateFragmentShader(effects, false);
+    sgct_helpers::findAndReplace(vertShader, "**glsl_version**", Engine::instance()->getGLSLVersion());
+    sgct_helpers::findAndReplace(fragShader, "**glsl_version**", Engine::instance()->getGLSLVersion());
+
+    sgct::ShaderProgram & program = mFusedPostFXPrograms[key];
+    program.setName(name);
+    if (!program.addShaderSrc(vertShader, GL_VERTEX_SHADER, ShaderProgram::SHADER_SRC_STRING) ||
+        !program.addShaderSrc(fragShader, GL_FRAGMENT_SHADER, ShaderProgram::SHADER_SRC_STRING) ||
+        !program.createAndLinkProgram())
+    {
+        MessageHandler::instance()->print(MessageHandler::NOTIFY_ERROR, "SGCTWindow %d: Failed to create fused post effect shader '%s', rendering the passes separately.\n",
+            mId, name.c_str());
+        program.deleteProgram();
+        mFusedPostFXPrograms.erase(key);
+        mFusePostFX = false;
+        return NULL;
+    }
+
+    MessageHandler::instance()->print(MessageHandler::NOTIFY_DEBUG, "SGCTWindow %d: Created fused post effect shader '%s'.\n", mId, name.c_str());
+    mPostFXStagePrograms[stageIndex] = &program;
+    return &program;
+}
+
+/*!
+    Uses a framebuffer texture of another window with the same size and format instead of this window's own. The render
+    graph only does this for textures that aren't used outside of the passes of a window, the own texture is deleted.
+*/
+void sgct::SGCTWindow::setFrameBufferTextureAlias(unsigned int index, unsigned int texture)
+{
+    deleteFrameBufferTexture(index);
+    mFrameBufferTextures[index] = texture;
+    mAliasedTextures[index] = texture != GL_FALSE;
+}
+
+/*!
+    Stops using the texture of another window, the window's own texture is created the next time it is needed.
+*/
+void sgct::SGCTWindow::releaseFrameBufferTextureAlias(unsigned int index)
+{
+    if( mAliasedTextures[index] )
+    {
+        mFrameBufferTextures[index] = GL_FALSE;
+        mAliasedTextures[index] = false;
+    }
+}
+
+/*!
+    Deletes a framebuffer texture unless it is owned by another window.
+*/
+void sgct::SGCTWindow::deleteFrameBufferTexture(unsigned int index)
+{
+    if( mFrameBufferTextures[index] != GL_FALSE && !mAliasedTextures[index] )
+        glDeleteTextures(1, &mFrameBufferTextures[index]);
+
+    mFrameBufferTextures[index] = GL_FALSE;
+    mAliasedTextures[index] = false;
+}
+
 /*!
     This function resizes the FBOs when the window is resized to achive 1:1 pixel-texel mapping.
 */
 void sgct::SGCTWindow::resizeFBOs()
 {
-    if(!mUseFixResolution && SGCTSettings::instance()->useFBO())
+    if((!mUseFixResolution || mResolutionScaleChanged) && SGCTSettings::instance()->useFBO())
     {
         makeOpenGLContextCurrent( Shared_Context );
         for(unsigned int i=0; i<NUMBER_OF_TEXTURES; i++)
-        {
-            if( mFrameBufferTextures[i] != GL_FALSE )
-            {
-                glDeleteTextures(1, &mFrameBufferTextures[i]);
-                mFrameBufferTextures[i] = GL_FALSE;
-            }
-        }
+            deleteFrameBufferTexture(i);
         createTextures();
 
         mFinalFBO_Ptr->resizeFBO(mFramebufferResolution[0],
@@ -1870,7 +1973,10 @@ void sgct::SGCTWindow::setStereoMode( StereoMode sm )
         mUseRightEyeTexture = false;
 
     if( mWindowHandle )
+    {
         loadShaders();
+        updateTransferCurve(); //the compositor may have taken over or handed back the color correction
+    }
 }
 
 /*!
@@ -1980,12 +2086,16 @@ void sgct::SGCTWindow::updateTransferCurve()
     ramp.green = green;
     ramp.blue = blue;
 
-    float gamma_exp = 1.0f / mGamma;
+    //the single pass compositor applies the color correction in its shader
+    bool identity = usesSinglePassCompositor();
+    float gamma_exp = identity ? 1.0f : 1.0f / mGamma;
+    float contrast = identity ? 1.0f : mContrast;
+    float brightness = identity ? 1.0f : mBrightness;
 
     for (unsigned int i = 0; i < ramp.size; i++)
     {
-        float c = ((static_cast<float>(i)/255.0f) - 0.5f) * mContrast + 0.5f;
-        float b = c + (mBrightness - 1.0f);
+        float c = ((static_cast<float>(i)/255.0f) - 0.5f) * contrast + 0.5f;
+        float b = c + (brightness - 1.0f);
         float g = powf(b, gamma_exp);
 
         //transform back
@@ -2077,7 +2187,7 @@ const bool & sgct::SGCTWindow::getAlpha() const
 }
 
 /*!
-Set monitor gamma (works only if fullscreen)
+Set monitor gamma (works only if fullscreen unless the single pass compositor is used)
 */
 void sgct::SGCTWindow::setGamma(float gamma)
 {
@@ -2094,7 +2204,7 @@ const float & sgct::SGCTWindow::getGamma() const
 }
 
 /*!
-Set monitor contrast in range [0.5, 1.5] (works only if fullscreen)
+Set monitor contrast in range [0.5, 1.5] (works only if fullscreen unless the single pass compositor is used)
 */
 void sgct::SGCTWindow::setContrast(float contrast)
 {
@@ -2111,7 +2221,7 @@ const float & sgct::SGCTWindow::getContrast() const
 }
 
 /*!
-Set monitor brightness in range [0.5, 1.5] (works only if fullscreen)
+Set monitor brightness in range [0.5, 1.5] (works only if fullscreen unless the single pass compositor is used)
 */
 void sgct::SGCTWindow::setBrightness(float brightness)
 {
@@ -2135,6 +2245,15 @@ sgct::SGCTWindow::ColorBitDepth sgct::SGCTWindow::getColorBitDepth() const
     return mBufferColorBitDepth;
 }
 
+/*!
+\returns true if the viewports of this window are composited in a single shader pass per viewport and eye (see SGCTSettings::setUseSinglePassCompositor)
+*/
+bool sgct::SGCTWindow::usesSinglePassCompositor() const
+{
+    return SGCTSettings::instance()->getUseSinglePassCompositor() && SGCTSettings::instance()->useFBO() &&
+        (mStereoMode == No_Stereo || mStereoMode == Active_Stereo);
+}
+
 /*!
 Set if BGR(A) or RGB(A) rendering should be used. Default is BGR(A), which is usually the native order on GPU hardware.
 This setting affects the screencapture which will return the prefered color order.
@@ -2152,6 +2271,36 @@ void sgct::SGCTWindow::setAllowCapture(bool state)
     mAllowCapture = state;
 }
 
+/*!
+Set the scale of the frame buffer resolution relative to the window's own frame buffer resolution, also for fixed
+resolution windows. The FBOs are resized in the next call to update and the frame buffer textures are stretched to
+the window so screen captures from textures get the scaled resolution. Used by dynamic resolution scaling, see
+SGCTSettings::setUseDynamicResolution.
+*/
+void sgct::SGCTWindow::setResolutionScale(float scale)
+{
+    if (scale == mResolutionScale)
+        return;
+
+    mResolutionScale = scale;
+    setUnscaledFramebufferResolution(mUnscaledFramebufferResolution[0], mUnscaledFramebufferResolution[1]);
+    mResolutionScaleChanged = true;
+}
+
+/*!
+Sets the frame buffer resolution before the resolution scale is applied.
+*/
+void sgct::SGCTWindow::setUnscaledFramebufferResolution(int x, int y)
+{
+    mUnscaledFramebufferResolution[0] = x;
+    mUnscaledFramebufferResolution[1] = y;
+
+    int scaledX = static_cast<int>(static_cast<float>(x) * mResolutionScale + 0.5f);
+    int scaledY = static_cast<int>(static_cast<float>(y) * mResolutionScale + 0.5f);
+    mFramebufferResolution[0] = scaledX > 0 ? scaledX : 1;
+    mFramebufferResolution[1] = scaledY > 0 ? scaledY : 1;
+}
+
 /*!
 Get if buffer is rendered using BGR(A) or RGB(A).
 */
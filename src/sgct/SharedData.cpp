@@ -23,12 +23,19 @@ using namespace sgct;
 #define DEFAULT_SIZE 1024
 
 SharedData * SharedData::mInstance = NULL;
+const unsigned int SharedData::ReservedFieldId;
+const unsigned int SharedData::ResolutionScaleFieldId;
+const unsigned int SharedData::ConfigHashFieldId;
 
 SharedData::SharedData()
 {
     mEncodeFn = NULL;
     mDecodeFn = NULL;
 
+    mFieldSchemaHash = 0;
+    mFieldDirtyTracking = true;
+    mFieldSchemaErrorReported = false;
+
     // use a compression buffer twice as large
     // to fit huffman tree + data which can be
     // larger than original data in some cases.
@@ -129,6 +136,434 @@ void SharedData::setDecodeFunction(void(*fnPtr)(void))
     mDecodeFn = fnPtr;
 }
 
+/*!
+Registers a shared object with a unique id. Registered fields are synchronized every frame without encode and
+decode callbacks and the same fields must be registered on all nodes. Fields are encoded in id order before
+the data written by the encode callback. If a field with the same id exists it is replaced.
+
+\code{.cpp}
+sgct::SharedDouble curr_time(0.0);
+sgct::SharedObject<glm::mat4> xform;
+
+sgct::SharedData::instance()->addField(0, &curr_time);
+sgct::SharedData::instance()->addField(1, &xform);
+\endcode
+*/
+void SharedData::addField(unsigned int id, SharedFloat * sf)
+{
+    addFieldDescriptor(id, sf, sizeof(float), &SharedData::appendFieldValue<SharedFloat, float>, &SharedData::setFieldValue<SharedFloat, float>);
+}
+
+void SharedData::addField(unsigned int id, SharedDouble * sd)
+{
+    addFieldDescriptor(id, sd, sizeof(double), &SharedData::appendFieldValue<SharedDouble, double>, &SharedData::setFieldValue<SharedDouble, double>);
+}
+
+void SharedData::addField(unsigned int id, SharedInt64 * si)
+{
+    addFieldDescriptor(id, si, sizeof(int64_t), &SharedData::appendFieldValue<SharedInt64, int64_t>, &SharedData::setFieldValue<SharedInt64, int64_t>);
+}
+
+void SharedData::addField(unsigned int id, SharedInt32 * si)
+{
+    addFieldDescriptor(id, si, sizeof(int32_t), &SharedData::appendFieldValue<SharedInt32, int32_t>, &SharedData::setFieldValue<SharedInt32, int32_t>);
+}
+
+void SharedData::addField(unsigned int id, SharedInt16 * si)
+{
+    addFieldDescriptor(id, si, sizeof(int16_t), &SharedData::appendFieldValue<SharedInt16, int16_t>, &SharedData::setFieldValue<SharedInt16, int16_t>);
+}
+
+void SharedData::addField(unsigned int id, SharedInt8 * si)
+{
+    addFieldDescriptor(id, si, sizeof(int8_t), &SharedData::appendFieldValue<SharedInt8, int8_t>, &SharedData::setFieldValue<SharedInt8, int8_t>);
+}
+
+void SharedData::addField(unsigned int id, SharedUInt64 * si)
+{
+    addFieldDescriptor(id, si, sizeof(uint64_t), &SharedData::appendFieldValue<SharedUInt64, uint64_t>, &SharedData::setFieldValue<SharedUInt64, uint64_t>);
+}
+
+void SharedData::addField(unsigned int id, SharedUInt32 * si)
+{
+    addFieldDescriptor(id, si, sizeof(uint32_t), &SharedData::appendFieldValue<SharedUInt32, uint32_t>, &SharedData::setFieldValue<SharedUInt32, uint32_t>);
+}
+
+void SharedData::addField(unsigned int id, SharedUInt16 * si)
+{
+    addFieldDescriptor(id, si, sizeof(uint16_t), &SharedData::appendFieldValue<SharedUInt16, uint16_t>, &SharedData::setFieldValue<SharedUInt16, uint16_t>);
+}
+
+void SharedData::addField(unsigned int id, SharedUInt8 * si)
+{
+    addFieldDescriptor(id, si, sizeof(uint8_t), &SharedData::appendFieldValue<SharedUInt8, uint8_t>, &SharedData::setFieldValue<SharedUInt8, uint8_t>);
+}
+
+void SharedData::addField(unsigned int id, SharedUChar * suc)
+{
+    addFieldDescriptor(id, suc, sizeof(unsigned char), &SharedData::appendFieldValue<SharedUChar, unsigned char>, &SharedData::setFieldValue<SharedUChar, unsigned char>);
+}
+
+void SharedData::addField(unsigned int id, SharedBool * sb)
+{
+    addFieldDescriptor(id, sb, sizeof(bool), &SharedData::appendFieldValue<SharedBool, bool>, &SharedData::setFieldValue<SharedBool, bool>);
+}
+
+void SharedData::addField(unsigned int id, SharedString * ss)
+{
+    addFieldDescriptor(id, ss, 0, &SharedData::appendFieldString, &SharedData::setFieldString);
+}
+
+void SharedData::addField(unsigned int id, SharedWString * ss)
+{
+    addFieldDescriptor(id, ss, 0, &SharedData::appendFieldWString, &SharedData::setFieldWString);
+}
+
+/*!
+Unregisters the field with the given id. Fields with reserved ids can't be removed.
+*/
+void SharedData::removeField(unsigned int id)
+{
+    if (id >= ReservedFieldId)
+    {
+        MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "SharedData: Field id %u is reserved by SGCT and can't be removed!\n", id);
+        return;
+    }
+
+    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    for (std::size_t i = 0; i < mFields.size(); i++)
+        if (mFields[i].id == id)
+        {
+            mFields.erase(mFields.begin() + i);
+            break;
+        }
+    updateFieldSchema();
+    SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+}
+
+/*!
+Unregisters all fields except the ones used by SGCT.
+*/
+void SharedData::clearFields()
+{
+    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    std::size_t index = 0;
+    while (index < mFields.size() && mFields[index].id < ReservedFieldId)
+        index++;
+    mFields.erase(mFields.begin(), mFields.begin() + index);
+    updateFieldSchema();
+    SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+}
+
+/*!
+Set if registered fields that haven't changed since the last frame should be skipped (default enabled). If disabled all fields are sent every frame.
+*/
+void SharedData::setFieldDirtyTracking(bool state)
+{
+    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+    mFieldDirtyTracking = state;
+    for (std::size_t i = 0; i < mFields.size(); i++)
+        mFields[i].hasLastValue = false;
+    SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+}
+
+/*!
+Adds a field registered by the application, ids from ReservedFieldId and up are rejected.
+*/
+void SharedData::addFieldDescriptor(unsigned int id, void * field, uint32_t size, FieldAppendFn appendFn, FieldSetFn setFn)
+{
+    if (id >= ReservedFieldId)
+    {
+        MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "SharedData: Field id %u is reserved by SGCT, use an id below %u!\n", id, ReservedFieldId);
+        return;
+    }
+
+    insertFieldDescriptor(id, field, size, appendFn, setFn);
+}
+
+/*!
+Registers a field used by SGCT itself, called by the engine.
+*/
+void SharedData::addReservedField(unsigned int id, SharedFloat * sf)
+{
+    insertFieldDescriptor(id, sf, sizeof(float), &SharedData::appendFieldValue<SharedFloat, float>, &SharedData::setFieldValue<SharedFloat, float>);
+}
+
+/*!
+Registers a field used by SGCT itself, called by the engine.
+*/
+void SharedData::addReservedField(unsigned int id, SharedUInt32 * si)
+{
+    insertFieldDescriptor(id, si, sizeof(uint32_t), &SharedData::appendFieldValue<SharedUInt32, uint32_t>, &SharedData::setFieldValue<SharedUInt32, uint32_t>);
+}
+
+void SharedData::insertFieldDescriptor(unsigned int id, void * field, uint32_t size, FieldAppendFn appendFn, FieldSetFn setFn)
+{
+    FieldDescriptor fd;
+    fd.id = id;
+    fd.field = field;
+    fd.size = size;
+    fd.appendFn = appendFn;
+    fd.setFn = setFn;
+    fd.hasLastValue = false;
+
+    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+
+    //keep the table sorted by id so that the registration order doesn't matter
+    std::size_t index = 0;
+    while (index < mFields.size() && mFields[index].id < id)
+        index++;
+
+    if (index < mFields.size() && mFields[index].id == id)
+        mFields[index] = fd;
+    else
+        mFields.insert(mFields.begin() + index, fd);
+
+    updateFieldSchema();
+    SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+}
+
+/*!
+Must be called with the DataSyncMutex locked. The schema hash lets the slaves detect if they registered other fields than the master.
+*/
+void SharedData::updateFieldSchema()
+{
+    //FNV-1a
+    uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < mFields.size(); i++)
+    {
+        uint32_t values[2] = { static_cast<uint32_t>(mFields[i].id), mFields[i].size };
+        const unsigned char * p = reinterpret_cast<const unsigned char *>(values);
+        for (std::size_t j = 0; j < sizeof(values); j++)
+        {
+            hash ^= p[j];
+            hash *= 16777619u;
+        }
+        mFields[i].hasLastValue = false;
+    }
+
+    mFieldSchemaHash = hash;
+    mFieldSchemaErrorReported = false;
+}
+
+/*!
+Encodes the registered fields as: number of fields, schema hash, block size, a bitmask of the fields
+that are included and the values of the included fields. The header is written even if no fields are
+registered so that the slaves can detect that their fields don't match the master's.
+*/
+void SharedData::encodeFields()
+{
+    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+
+    std::size_t numberOfFields = mFields.size();
+    std::vector<unsigned char> & storage = *currentStorage;
+
+    //reserve the header and the bitmask, they are filled in when the changed fields are known
+    std::size_t headerPos = storage.size();
+    std::size_t maskSize = (numberOfFields + 7) / 8;
+    storage.resize(headerPos + 3 * sizeof(uint32_t) + maskSize);
+    std::size_t dataPos = storage.size();
+
+    //write all fields, PODs that are adjacent in memory are copied at once
+    mFieldOffsets.resize(numberOfFields + 1);
+    std::size_t i = 0;
+    while (i < numberOfFields)
+    {
+        if (mFields[i].appendFn == NULL)
+        {
+            unsigned char * start = static_cast<unsigned char *>(mFields[i].field);
+            std::size_t runSize = 0;
+            while (i < numberOfFields && mFields[i].appendFn == NULL && static_cast<unsigned char *>(mFields[i].field) == start + runSize)
+            {
+                mFieldOffsets[i] = static_cast<uint32_t>(storage.size() + runSize);
+                runSize += mFields[i].size;
+                i++;
+            }
+            storage.insert(storage.end(), start, start + runSize);
+        }
+        else
+        {
+            mFieldOffsets[i] = static_cast<uint32_t>(storage.size());
+            mFields[i].appendFn(mFields[i].field, storage);
+            i++;
+        }
+    }
+    mFieldOffsets[numberOfFields] = static_cast<uint32_t>(storage.size());
+
+    //drop the fields that haven't changed since the last frame by moving the changed ones down
+    mFieldMask.assign(maskSize, 0);
+    std::size_t writePos = dataPos;
+    for (i = 0; i < numberOfFields; i++)
+    {
+        FieldDescriptor & fd = mFields[i];
+        const unsigned char * value = &storage[0] + mFieldOffsets[i];
+        uint32_t length = mFieldOffsets[i + 1] - mFieldOffsets[i];
+
+        bool dirty = !mFieldDirtyTracking || !fd.hasLastValue || fd.lastValue.size() != length ||
+            (length > 0 && memcmp(&fd.lastValue[0], value, length) != 0);
+        if (!dirty)
+            continue;
+
+        mFieldMask[i >> 3] |= static_cast<unsigned char>(1u << (i & 7));
+        if (mFieldDirtyTracking)
+        {
+            fd.lastValue.assign(value, value + length);
+            fd.hasLastValue = true;
+        }
+
+        if (writePos != mFieldOffsets[i] && length > 0)
+            memmove(&storage[writePos], value, length);
+        writePos += length;
+    }
+    storage.resize(writePos);
+
+    uint32_t header[3] = { static_cast<uint32_t>(numberOfFields), mFieldSchemaHash, static_cast<uint32_t>(writePos - dataPos + maskSize) };
+    memcpy(&storage[headerPos], header, sizeof(header));
+    if (maskSize > 0)
+        memcpy(&storage[headerPos + sizeof(header)], &mFieldMask[0], maskSize);
+
+    SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+}
+
+void SharedData::decodeFields()
+{
+    SGCTMutexManager::instance()->lockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+
+    std::size_t numberOfFields = mFields.size();
+    uint32_t header[3];
+    if (dataBlock.size() < pos + sizeof(header))
+    {
+        SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+        MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "SharedData: Received data without a field header!\n");
+        return;
+    }
+
+    memcpy(header, &dataBlock[pos], sizeof(header));
+    pos += sizeof(header);
+
+    std::size_t maskSize = (numberOfFields + 7) / 8;
+    std::size_t available = dataBlock.size() - pos;
+    if (header[0] != numberOfFields || header[1] != mFieldSchemaHash || header[2] > available || header[2] < maskSize)
+    {
+        bool report = !mFieldSchemaErrorReported;
+        mFieldSchemaErrorReported = true;
+        pos += header[2] > available ? static_cast<unsigned int>(available) : header[2];
+        SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+
+        //the message handler locks the data sync mutex on slaves
+        if (report)
+            MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR,
+                "SharedData: The registered fields (%u) don't match the fields of the master (%u), skipping them!\n",
+                static_cast<unsigned int>(numberOfFields), header[0]);
+        return;
+    }
+
+    const unsigned char * mask = dataBlock.data() + pos;
+    const unsigned char * data = mask + maskSize;
+    uint32_t remaining = header[2] - static_cast<uint32_t>(maskSize);
+
+    bool valid = true;
+    unsigned int id = 0;
+    std::size_t i = 0;
+    while (i < numberOfFields && valid)
+    {
+        if (!(mask[i >> 3] & (1u << (i & 7))))
+        {
+            i++;
+            continue;
+        }
+
+        id = mFields[i].id;
+        uint32_t consumed = 0;
+        if (mFields[i].setFn == NULL)
+        {
+            //changed PODs that are adjacent in memory are scattered with one copy
+            unsigned char * start = static_cast<unsigned char *>(mFields[i].field);
+            while (i < numberOfFields && mFields[i].setFn == NULL && (mask[i >> 3] & (1u << (i & 7))) &&
+                static_cast<unsigned char *>(mFields[i].field) == start + consumed)
+            {
+                consumed += mFields[i].size;
+                i++;
+            }
+
+            valid = consumed <= remaining;
+            if (valid)
+                memcpy(start, data, consumed);
+        }
+        else
+        {
+            valid = remaining >= mFields[i].size;
+            if (valid)
+            {
+                consumed = mFields[i].setFn(mFields[i].field, data, remaining);
+                valid = consumed > 0 && consumed <= remaining;
+            }
+            i++;
+        }
+
+        if (valid)
+        {
+            data += consumed;
+            remaining -= consumed;
+        }
+    }
+
+    pos += header[2];
+    SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
+
+    if (!valid)
+        MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_ERROR, "SharedData: Failed to decode field %u!\n", id);
+}
+
+void SharedData::appendFieldString(void * field, std::vector<unsigned char> & buffer)
+{
+    std::string tmpStr( static_cast<SharedString *>(field)->getVal() );
+    uint32_t length = static_cast<uint32_t>(tmpStr.size());
+    unsigned char *p = reinterpret_cast<unsigned char *>(&length);
+    buffer.insert(buffer.end(), p, p + sizeof(uint32_t));
+    buffer.insert(buffer.end(), tmpStr.data(), tmpStr.data() + length);
+}
+
+uint32_t SharedData::setFieldString(void * field, const unsigned char * data, uint32_t length)
+{
+    uint32_t strLength;
+    if (length < sizeof(uint32_t))
+        return 0;
+    memcpy(&strLength, data, sizeof(uint32_t));
+    if (strLength > length - sizeof(uint32_t))
+        return 0;
+
+    static_cast<SharedString *>(field)->setVal(std::string(reinterpret_cast<const char *>(data + sizeof(uint32_t)), strLength));
+    return static_cast<uint32_t>(sizeof(uint32_t) + strLength);
+}
+
+void SharedData::appendFieldWString(void * field, std::vector<unsigned char> & buffer)
+{
+    std::wstring tmpStr( static_cast<SharedWString *>(field)->getVal() );
+    uint32_t length = static_cast<uint32_t>(tmpStr.size());
+    unsigned char *p = reinterpret_cast<unsigned char *>(&length);
+    buffer.insert(buffer.end(), p, p + sizeof(uint32_t));
+    p = length > 0 ? reinterpret_cast<unsigned char *>(&tmpStr[0]) : NULL;
+    if (p)
+        buffer.insert(buffer.end(), p, p + length * sizeof(wchar_t));
+}
+
+uint32_t SharedData::setFieldWString(void * field, const unsigned char * data, uint32_t length)
+{
+    uint32_t strLength;
+    if (length < sizeof(uint32_t))
+        return 0;
+    memcpy(&strLength, data, sizeof(uint32_t));
+    if (static_cast<uint64_t>(strLength) * sizeof(wchar_t) > length - sizeof(uint32_t))
+        return 0;
+
+    std::wstring tmpStr(strLength, L'\0');
+    if (strLength > 0)
+        memcpy(&tmpStr[0], data + sizeof(uint32_t), strLength * sizeof(wchar_t));
+    static_cast<SharedWString *>(field)->setVal(tmpStr);
+    return static_cast<uint32_t>(sizeof(uint32_t) + strLength * sizeof(wchar_t));
+}
+
 /*!
 This fuction is called internally by SGCT and shouldn't be used by the user.
 */
@@ -149,6 +584,8 @@ void SharedData::decode(const char * receivedData, int receivedlength, int clien
 
     SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
 
+    decodeFields();
+
     if( mDecodeFn != NULL )
         mDecodeFn();
 }
@@ -179,6 +616,8 @@ void SharedData::encode()
 
     SGCTMutexManager::instance()->unlockMutex( sgct::SGCTMutexManager::DataSyncMutex );
 
+    encodeFields();
+
     if( mEncodeFn != NULL )
         mEncodeFn();
 
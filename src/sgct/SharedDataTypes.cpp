@@ -8,1894 +8,1289 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <sgct/SharedDataTypes.h>
 #include <sgct/SGCTMutexManager.h>
 
+namespace
+{
+    //read-modify-write operations that std::atomic lacks for some types, retried until no other thread interfered
+    template <class T>
+    void atomicAdd(std::atomic<T> & atom, T val)
+    {
+        T expected = atom.load(std::memory_order_relaxed);
+        while (!atom.compare_exchange_weak(expected, static_cast<T>(expected + val), std::memory_order_acq_rel, std::memory_order_relaxed))
+            ;
+    }
+
+    template <class T>
+    void atomicMultiply(std::atomic<T> & atom, T val)
+    {
+        T expected = atom.load(std::memory_order_relaxed);
+        while (!atom.compare_exchange_weak(expected, static_cast<T>(expected * val), std::memory_order_acq_rel, std::memory_order_relaxed))
+            ;
+    }
+
+    template <class T>
+    void atomicDivide(std::atomic<T> & atom, T val)
+    {
+        T expected = atom.load(std::memory_order_relaxed);
+        while (!atom.compare_exchange_weak(expected, static_cast<T>(expected / val), std::memory_order_acq_rel, std::memory_order_relaxed))
+            ;
+    }
+}
+
 sgct::SharedFloat::SharedFloat()
+    : mVal(0.0f)
 {
-    mVal = 0.0f;
+    ;
 }
 
 sgct::SharedFloat::SharedFloat(float val)
+    : mVal(val)
 {
-    mVal = val;
+    ;
 }
 
 sgct::SharedFloat::SharedFloat(const SharedFloat & sf)
+    : mVal(sf.mVal.load(std::memory_order_acquire))
 {
-    mVal = sf.mVal;
+    ;
 }
 
 float sgct::SharedFloat::getVal()
 {
-    float tmpVal;
-
-    mMutex.lock();
-    tmpVal = mVal;
-    mMutex.unlock();
-
-    return tmpVal;
+    return mVal.load(std::memory_order_acquire);
 }
 
 void sgct::SharedFloat::setVal(float val)
 {
-    mMutex.lock();
-    mVal = val;
-    mMutex.unlock();
+    mVal.store(val, std::memory_order_release);
 }
 
 void sgct::SharedFloat::operator=(const SharedFloat & sf)
 {
-    mMutex.lock();
-    mVal = sf.mVal;
-    mMutex.unlock();
+    mVal.store(sf.mVal.load(std::memory_order_acquire), std::memory_order_release);
 }
 
 void sgct::SharedFloat::operator=(const float & val)
 {
-    mMutex.lock();
-    mVal = val;
-    mMutex.unlock();
+    mVal.store(val, std::memory_order_release);
 }
 
 void sgct::SharedFloat::operator+=(const float & val)
 {
-    mMutex.lock();
-    mVal += val;
-    mMutex.unlock();
+    atomicAdd(mVal, val);
 }
 
 void sgct::SharedFloat::operator-=(const float & val)
 {
-    mMutex.lock();
-    mVal -= val;
-    mMutex.unlock();
+    atomicAdd(mVal, -val);
 }
 
 void sgct::SharedFloat::operator*=(const float & val)
 {
-    mMutex.lock();
-    mVal *= val;
-    mMutex.unlock();
+    atomicMultiply(mVal, val);
 }
 
 void sgct::SharedFloat::operator/=(const float & val)
 {
-    mMutex.lock();
-    mVal /= val;
-    mMutex.unlock();
+    atomicDivide(mVal, val);
 }
 
 void sgct::SharedFloat::operator++(int)
 {
-    mMutex.lock();
-    mVal += 1.0f;
-    mMutex.unlock();
+    atomicAdd(mVal, 1.0f);
 }
 
 void sgct::SharedFloat::operator--(int)
 {
-    mMutex.lock();
-    mVal -= 1.0f;
-    mMutex.unlock();
+    atomicAdd(mVal, -1.0f);
 }
 
 bool sgct::SharedFloat::operator<(const float & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal < val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) < val;
 }
 
 bool sgct::SharedFloat::operator<=(const float & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal <= val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) <= val;
 }
 
 bool sgct::SharedFloat::operator>(const float & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal > val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) > val;
 }
 
 bool sgct::SharedFloat::operator>=(const float & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal >= val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) >= val;
 }
 
 bool sgct::SharedFloat::operator==(const float & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal == val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) == val;
 }
 
 bool sgct::SharedFloat::operator!=(const float & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal != val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) != val;
 }
 
 float sgct::SharedFloat::operator+(const float & val)
 {
-    float tmpF;
-    mMutex.lock();
-    tmpF = (mVal + val);
-    mMutex.unlock();
-    return tmpF;
+    return static_cast<float>(mVal.load(std::memory_order_acquire) + val);
 }
 
 float sgct::SharedFloat::operator-(const float & val)
 {
-    float tmpF;
-    mMutex.lock();
-    tmpF = (mVal - val);
-    mMutex.unlock();
-    return tmpF;
+    return static_cast<float>(mVal.load(std::memory_order_acquire) - val);
 }
 
 float sgct::SharedFloat::operator*(const float & val)
 {
-    float tmpF;
-    mMutex.lock();
-    tmpF = (mVal * val);
-    mMutex.unlock();
-    return tmpF;
+    return static_cast<float>(mVal.load(std::memory_order_acquire) * val);
 }
 
 float sgct::SharedFloat::operator/(const float & val)
 {
-    float tmpF;
-    mMutex.lock();
-    tmpF = (mVal / val);
-    mMutex.unlock();
-    return tmpF;
+    return static_cast<float>(mVal.load(std::memory_order_acquire) / val);
 }
 
 sgct::SharedDouble::SharedDouble()
+    : mVal(0.0)
 {
-    mVal = 0.0;
+    ;
 }
 
 sgct::SharedDouble::SharedDouble(double val)
+    : mVal(val)
 {
-    mVal = val;
+    ;
 }
 
-sgct::SharedDouble::SharedDouble( const SharedDouble & sd )
+sgct::SharedDouble::SharedDouble(const SharedDouble & sd)
+    : mVal(sd.mVal.load(std::memory_order_acquire))
 {
-    mVal = sd.mVal;
+    ;
 }
 
 double sgct::SharedDouble::getVal()
 {
-    double tmpVal;
-
-    mMutex.lock();
-    tmpVal = mVal;
-    mMutex.unlock();
-
-    return tmpVal;
+    return mVal.load(std::memory_order_acquire);
 }
 
 void sgct::SharedDouble::setVal(double val)
 {
-    mMutex.lock();
-    mVal = val;
-    mMutex.unlock();
+    mVal.store(val, std::memory_order_release);
 }
 
 void sgct::SharedDouble::operator=(const SharedDouble & sd)
 {
-    mMutex.lock();
-    mVal = sd.mVal;
-    mMutex.unlock();
+    mVal.store(sd.mVal.load(std::memory_order_acquire), std::memory_order_release);
 }
 
-void sgct::SharedDouble::operator=( const double & val )
+void sgct::SharedDouble::operator=(const double & val)
 {
-    mMutex.lock();
-    mVal = val;
-    mMutex.unlock();
+    mVal.store(val, std::memory_order_release);
 }
 
-void sgct::SharedDouble::operator+=( const double & val )
+void sgct::SharedDouble::operator+=(const double & val)
 {
-    mMutex.lock();
-    mVal += val;
-    mMutex.unlock();
+    atomicAdd(mVal, val);
 }
 
-void sgct::SharedDouble::operator-=( const double & val )
+void sgct::SharedDouble::operator-=(const double & val)
 {
-    mMutex.lock();
-    mVal -= val;
-    mMutex.unlock();
+    atomicAdd(mVal, -val);
 }
 
-void sgct::SharedDouble::operator*=( const double & val )
+void sgct::SharedDouble::operator*=(const double & val)
 {
-    mMutex.lock();
-    mVal *= val;
-    mMutex.unlock();
+    atomicMultiply(mVal, val);
 }
 
-void sgct::SharedDouble::operator/=( const double & val )
+void sgct::SharedDouble::operator/=(const double & val)
 {
-    mMutex.lock();
-    mVal /= val;
-    mMutex.unlock();
+    atomicDivide(mVal, val);
 }
 
 void sgct::SharedDouble::operator++(int)
 {
-    mMutex.lock();
-    mVal += 1.0;
-    mMutex.unlock();
+    atomicAdd(mVal, 1.0);
 }
 
 void sgct::SharedDouble::operator--(int)
 {
-    mMutex.lock();
-    mVal -= 1.0;
-    mMutex.unlock();
+    atomicAdd(mVal, -1.0);
 }
 
-bool sgct::SharedDouble::operator<( const double & val )
+bool sgct::SharedDouble::operator<(const double & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal < val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) < val;
 }
 
-bool sgct::SharedDouble::operator<=( const double & val )
+bool sgct::SharedDouble::operator<=(const double & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal <= val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) <= val;
 }
 
-bool sgct::SharedDouble::operator>( const double & val )
+bool sgct::SharedDouble::operator>(const double & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal > val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) > val;
 }
 
-bool sgct::SharedDouble::operator>=( const double & val )
+bool sgct::SharedDouble::operator>=(const double & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal >= val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) >= val;
 }
 
-bool sgct::SharedDouble::operator==( const double & val )
+bool sgct::SharedDouble::operator==(const double & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal == val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) == val;
 }
 
-bool sgct::SharedDouble::operator!=( const double & val )
+bool sgct::SharedDouble::operator!=(const double & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal != val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) != val;
 }
 
-double sgct::SharedDouble::operator+( const double & val )
+double sgct::SharedDouble::operator+(const double & val)
 {
-    double tmpD;
-    mMutex.lock();
-    tmpD = (mVal + val);
-    mMutex.unlock();
-    return tmpD;
+    return static_cast<double>(mVal.load(std::memory_order_acquire) + val);
 }
 
-double sgct::SharedDouble::operator-( const double & val )
+double sgct::SharedDouble::operator-(const double & val)
 {
-    double tmpD;
-    mMutex.lock();
-    tmpD = (mVal - val);
-    mMutex.unlock();
-    return tmpD;
+    return static_cast<double>(mVal.load(std::memory_order_acquire) - val);
 }
 
-double sgct::SharedDouble::operator*( const double & val )
+double sgct::SharedDouble::operator*(const double & val)
 {
-    double tmpD;
-    mMutex.lock();
-    tmpD = (mVal * val);
-    mMutex.unlock();
-    return tmpD;
+    return static_cast<double>(mVal.load(std::memory_order_acquire) * val);
 }
 
-double sgct::SharedDouble::operator/( const double & val )
+double sgct::SharedDouble::operator/(const double & val)
 {
-    double tmpD;
-    mMutex.lock();
-    tmpD = (mVal / val);
-    mMutex.unlock();
-    return tmpD;
+    return static_cast<double>(mVal.load(std::memory_order_acquire) / val);
 }
 
 sgct::SharedInt64::SharedInt64()
+    : mVal(0)
 {
-    mVal = 0;
+    ;
 }
 
 sgct::SharedInt64::SharedInt64(int64_t val)
+    : mVal(val)
 {
-    mVal = val;
+    ;
 }
 
-sgct::SharedInt64::SharedInt64(const SharedInt64 & sf)
+sgct::SharedInt64::SharedInt64(const SharedInt64 & si)
+    : mVal(si.mVal.load(std::memory_order_acquire))
 {
-    mVal = sf.mVal;
+    ;
 }
 
 int64_t sgct::SharedInt64::getVal()
 {
-    int64_t tmpVal;
-
-    mMutex.lock();
-    tmpVal = mVal;
-    mMutex.unlock();
-
-    return tmpVal;
+    return mVal.load(std::memory_order_acquire);
 }
 
 void sgct::SharedInt64::setVal(int64_t val)
 {
-    mMutex.lock();
-    mVal = val;
-    mMutex.unlock();
+    mVal.store(val, std::memory_order_release);
 }
 
-void sgct::SharedInt64::operator=(const SharedInt64 & sf)
+void sgct::SharedInt64::operator=(const SharedInt64 & si)
 {
-    mMutex.lock();
-    mVal = sf.mVal;
-    mMutex.unlock();
+    mVal.store(si.mVal.load(std::memory_order_acquire), std::memory_order_release);
 }
 
 void sgct::SharedInt64::operator=(const int64_t & val)
 {
-    mMutex.lock();
-    mVal = val;
-    mMutex.unlock();
+    mVal.store(val, std::memory_order_release);
 }
 
 void sgct::SharedInt64::operator+=(const int64_t & val)
 {
-    mMutex.lock();
-    mVal += val;
-    mMutex.unlock();
+    mVal.fetch_add(val, std::memory_order_acq_rel);
 }
 
 void sgct::SharedInt64::operator-=(const int64_t & val)
 {
-    mMutex.lock();
-    mVal -= val;
-    mMutex.unlock();
+    mVal.fetch_sub(val, std::memory_order_acq_rel);
 }
 
 void sgct::SharedInt64::operator*=(const int64_t & val)
 {
-    mMutex.lock();
-    mVal *= val;
-    mMutex.unlock();
+    atomicMultiply(mVal, val);
 }
 
 void sgct::SharedInt64::operator/=(const int64_t & val)
 {
-    mMutex.lock();
-    mVal /= val;
-    mMutex.unlock();
+    atomicDivide(mVal, val);
 }
 
 void sgct::SharedInt64::operator++(int)
 {
-    mMutex.lock();
-    mVal++;
-    mMutex.unlock();
+    mVal.fetch_add(1, std::memory_order_acq_rel);
 }
 
 void sgct::SharedInt64::operator--(int)
 {
-    mMutex.lock();
-    mVal--;
-    mMutex.unlock();
+    mVal.fetch_sub(1, std::memory_order_acq_rel);
 }
 
 bool sgct::SharedInt64::operator<(const int64_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal < val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) < val;
 }
 
 bool sgct::SharedInt64::operator<=(const int64_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal <= val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) <= val;
 }
 
 bool sgct::SharedInt64::operator>(const int64_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal > val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) > val;
 }
 
 bool sgct::SharedInt64::operator>=(const int64_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal >= val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) >= val;
 }
 
 bool sgct::SharedInt64::operator==(const int64_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal == val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) == val;
 }
 
 bool sgct::SharedInt64::operator!=(const int64_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal != val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) != val;
 }
 
 int64_t sgct::SharedInt64::operator+(const int64_t & val)
 {
-    int64_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal + val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<int64_t>(mVal.load(std::memory_order_acquire) + val);
 }
 
 int64_t sgct::SharedInt64::operator-(const int64_t & val)
 {
-    int64_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal - val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<int64_t>(mVal.load(std::memory_order_acquire) - val);
 }
 
 int64_t sgct::SharedInt64::operator*(const int64_t & val)
 {
-    int64_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal * val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<int64_t>(mVal.load(std::memory_order_acquire) * val);
 }
 
 int64_t sgct::SharedInt64::operator/(const int64_t & val)
 {
-    int64_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal / val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<int64_t>(mVal.load(std::memory_order_acquire) / val);
 }
 
 sgct::SharedInt32::SharedInt32()
+    : mVal(0)
 {
-    mVal = 0;
+    ;
 }
 
 sgct::SharedInt32::SharedInt32(int32_t val)
+    : mVal(val)
 {
-    mVal = val;
+    ;
 }
 
-sgct::SharedInt32::SharedInt32(const SharedInt32 & sf)
+sgct::SharedInt32::SharedInt32(const SharedInt32 & si)
+    : mVal(si.mVal.load(std::memory_order_acquire))
 {
-    mVal = sf.mVal;
+    ;
 }
 
 int32_t sgct::SharedInt32::getVal()
 {
-    int32_t tmpVal;
-
-    mMutex.lock();
-    tmpVal = mVal;
-    mMutex.unlock();
-
-    return tmpVal;
+    return mVal.load(std::memory_order_acquire);
 }
 
 void sgct::SharedInt32::setVal(int32_t val)
 {
-    mMutex.lock();
-    mVal = val;
-    mMutex.unlock();
+    mVal.store(val, std::memory_order_release);
 }
 
-void sgct::SharedInt32::operator=(const SharedInt32 & sf)
+void sgct::SharedInt32::operator=(const SharedInt32 & si)
 {
-    mMutex.lock();
-    mVal = sf.mVal;
-    mMutex.unlock();
+    mVal.store(si.mVal.load(std::memory_order_acquire), std::memory_order_release);
 }
 
 void sgct::SharedInt32::operator=(const int32_t & val)
 {
-    mMutex.lock();
-    mVal = val;
-    mMutex.unlock();
+    mVal.store(val, std::memory_order_release);
 }
 
 void sgct::SharedInt32::operator+=(const int32_t & val)
 {
-    mMutex.lock();
-    mVal += val;
-    mMutex.unlock();
+    mVal.fetch_add(val, std::memory_order_acq_rel);
 }
 
 void sgct::SharedInt32::operator-=(const int32_t & val)
 {
-    mMutex.lock();
-    mVal -= val;
-    mMutex.unlock();
+    mVal.fetch_sub(val, std::memory_order_acq_rel);
 }
 
 void sgct::SharedInt32::operator*=(const int32_t & val)
 {
-    mMutex.lock();
-    mVal *= val;
-    mMutex.unlock();
+    atomicMultiply(mVal, val);
 }
 
 void sgct::SharedInt32::operator/=(const int32_t & val)
 {
-    mMutex.lock();
-    mVal /= val;
-    mMutex.unlock();
+    atomicDivide(mVal, val);
 }
 
 void sgct::SharedInt32::operator++(int)
 {
-    mMutex.lock();
-    mVal++;
-    mMutex.unlock();
+    mVal.fetch_add(1, std::memory_order_acq_rel);
 }
 
 void sgct::SharedInt32::operator--(int)
 {
-    mMutex.lock();
-    mVal--;
-    mMutex.unlock();
+    mVal.fetch_sub(1, std::memory_order_acq_rel);
 }
 
 bool sgct::SharedInt32::operator<(const int32_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal < val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) < val;
 }
 
 bool sgct::SharedInt32::operator<=(const int32_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal <= val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) <= val;
 }
 
 bool sgct::SharedInt32::operator>(const int32_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal > val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) > val;
 }
 
 bool sgct::SharedInt32::operator>=(const int32_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal >= val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) >= val;
 }
 
 bool sgct::SharedInt32::operator==(const int32_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal == val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) == val;
 }
 
 bool sgct::SharedInt32::operator!=(const int32_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal != val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) != val;
 }
 
 int32_t sgct::SharedInt32::operator+(const int32_t & val)
 {
-    int32_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal + val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<int32_t>(mVal.load(std::memory_order_acquire) + val);
 }
 
 int32_t sgct::SharedInt32::operator-(const int32_t & val)
 {
-    int32_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal - val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<int32_t>(mVal.load(std::memory_order_acquire) - val);
 }
 
 int32_t sgct::SharedInt32::operator*(const int32_t & val)
 {
-    int32_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal * val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<int32_t>(mVal.load(std::memory_order_acquire) * val);
 }
 
 int32_t sgct::SharedInt32::operator/(const int32_t & val)
 {
-    int32_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal / val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<int32_t>(mVal.load(std::memory_order_acquire) / val);
 }
 
 sgct::SharedInt16::SharedInt16()
+    : mVal(0)
 {
-    mVal = 0;
+    ;
 }
 
 sgct::SharedInt16::SharedInt16(int16_t val)
+    : mVal(val)
 {
-    mVal = val;
+    ;
 }
 
-sgct::SharedInt16::SharedInt16(const SharedInt16 & sf)
+sgct::SharedInt16::SharedInt16(const SharedInt16 & si)
+    : mVal(si.mVal.load(std::memory_order_acquire))
 {
-    mVal = sf.mVal;
+    ;
 }
 
 int16_t sgct::SharedInt16::getVal()
 {
-    int16_t tmpVal;
-
-    mMutex.lock();
-    tmpVal = mVal;
-    mMutex.unlock();
-
-    return tmpVal;
+    return mVal.load(std::memory_order_acquire);
 }
 
 void sgct::SharedInt16::setVal(int16_t val)
 {
-    mMutex.lock();
-    mVal = val;
-    mMutex.unlock();
+    mVal.store(val, std::memory_order_release);
 }
 
-void sgct::SharedInt16::operator=(const SharedInt16 & sf)
+void sgct::SharedInt16::operator=(const SharedInt16 & si)
 {
-    mMutex.lock();
-    mVal = sf.mVal;
-    mMutex.unlock();
+    mVal.store(si.mVal.load(std::memory_order_acquire), std::memory_order_release);
 }
 
 void sgct::SharedInt16::operator=(const int16_t & val)
 {
-    mMutex.lock();
-    mVal = val;
-    mMutex.unlock();
+    mVal.store(val, std::memory_order_release);
 }
 
 void sgct::SharedInt16::operator+=(const int16_t & val)
 {
-    mMutex.lock();
-    mVal += val;
-    mMutex.unlock();
+    mVal.fetch_add(val, std::memory_order_acq_rel);
 }
 
 void sgct::SharedInt16::operator-=(const int16_t & val)
 {
-    mMutex.lock();
-    mVal -= val;
-    mMutex.unlock();
+    mVal.fetch_sub(val, std::memory_order_acq_rel);
 }
 
 void sgct::SharedInt16::operator*=(const int16_t & val)
 {
-    mMutex.lock();
-    mVal *= val;
-    mMutex.unlock();
+    atomicMultiply(mVal, val);
 }
 
 void sgct::SharedInt16::operator/=(const int16_t & val)
 {
-    mMutex.lock();
-    mVal /= val;
-    mMutex.unlock();
+    atomicDivide(mVal, val);
 }
 
 void sgct::SharedInt16::operator++(int)
 {
-    mMutex.lock();
-    mVal++;
-    mMutex.unlock();
+    mVal.fetch_add(1, std::memory_order_acq_rel);
 }
 
 void sgct::SharedInt16::operator--(int)
 {
-    mMutex.lock();
-    mVal--;
-    mMutex.unlock();
+    mVal.fetch_sub(1, std::memory_order_acq_rel);
 }
 
 bool sgct::SharedInt16::operator<(const int16_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal < val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) < val;
 }
 
 bool sgct::SharedInt16::operator<=(const int16_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal <= val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) <= val;
 }
 
 bool sgct::SharedInt16::operator>(const int16_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal > val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) > val;
 }
 
 bool sgct::SharedInt16::operator>=(const int16_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal >= val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) >= val;
 }
 
 bool sgct::SharedInt16::operator==(const int16_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal == val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) == val;
 }
 
 bool sgct::SharedInt16::operator!=(const int16_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal != val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) != val;
 }
 
 int16_t sgct::SharedInt16::operator+(const int16_t & val)
 {
-    int16_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal + val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<int16_t>(mVal.load(std::memory_order_acquire) + val);
 }
 
 int16_t sgct::SharedInt16::operator-(const int16_t & val)
 {
-    int16_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal - val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<int16_t>(mVal.load(std::memory_order_acquire) - val);
 }
 
 int16_t sgct::SharedInt16::operator*(const int16_t & val)
 {
-    int16_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal * val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<int16_t>(mVal.load(std::memory_order_acquire) * val);
 }
 
 int16_t sgct::SharedInt16::operator/(const int16_t & val)
 {
-    int16_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal / val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<int16_t>(mVal.load(std::memory_order_acquire) / val);
 }
 
 sgct::SharedInt8::SharedInt8()
+    : mVal(0)
 {
-    mVal = 0;
+    ;
 }
 
 sgct::SharedInt8::SharedInt8(int8_t val)
+    : mVal(val)
 {
-    mVal = val;
+    ;
 }
 
-sgct::SharedInt8::SharedInt8(const SharedInt8 & sf)
+sgct::SharedInt8::SharedInt8(const SharedInt8 & si)
+    : mVal(si.mVal.load(std::memory_order_acquire))
 {
-    mVal = sf.mVal;
+    ;
 }
 
 int8_t sgct::SharedInt8::getVal()
 {
-    int8_t tmpVal;
-
-    mMutex.lock();
-    tmpVal = mVal;
-    mMutex.unlock();
-
-    return tmpVal;
+    return mVal.load(std::memory_order_acquire);
 }
 
 void sgct::SharedInt8::setVal(int8_t val)
 {
-    mMutex.lock();
-    mVal = val;
-    mMutex.unlock();
+    mVal.store(val, std::memory_order_release);
 }
 
-void sgct::SharedInt8::operator=(const SharedInt8 & sf)
+void sgct::SharedInt8::operator=(const SharedInt8 & si)
 {
-    mMutex.lock();
-    mVal = sf.mVal;
-    mMutex.unlock();
+    mVal.store(si.mVal.load(std::memory_order_acquire), std::memory_order_release);
 }
 
 void sgct::SharedInt8::operator=(const int8_t & val)
 {
-    mMutex.lock();
-    mVal = val;
-    mMutex.unlock();
+    mVal.store(val, std::memory_order_release);
 }
 
 void sgct::SharedInt8::operator+=(const int8_t & val)
 {
-    mMutex.lock();
-    mVal += val;
-    mMutex.unlock();
+    mVal.fetch_add(val, std::memory_order_acq_rel);
 }
 
 void sgct::SharedInt8::operator-=(const int8_t & val)
 {
-    mMutex.lock();
-    mVal -= val;
-    mMutex.unlock();
+    mVal.fetch_sub(val, std::memory_order_acq_rel);
 }
 
 void sgct::SharedInt8::operator*=(const int8_t & val)
 {
-    mMutex.lock();
-    mVal *= val;
-    mMutex.unlock();
+    atomicMultiply(mVal, val);
 }
 
 void sgct::SharedInt8::operator/=(const int8_t & val)
 {
-    mMutex.lock();
-    mVal /= val;
-    mMutex.unlock();
+    atomicDivide(mVal, val);
 }
 
 void sgct::SharedInt8::operator++(int)
 {
-    mMutex.lock();
-    mVal++;
-    mMutex.unlock();
+    mVal.fetch_add(1, std::memory_order_acq_rel);
 }
 
 void sgct::SharedInt8::operator--(int)
 {
-    mMutex.lock();
-    mVal--;
-    mMutex.unlock();
+    mVal.fetch_sub(1, std::memory_order_acq_rel);
 }
 
 bool sgct::SharedInt8::operator<(const int8_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal < val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) < val;
 }
 
 bool sgct::SharedInt8::operator<=(const int8_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal <= val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) <= val;
 }
 
 bool sgct::SharedInt8::operator>(const int8_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal > val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) > val;
 }
 
 bool sgct::SharedInt8::operator>=(const int8_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal >= val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) >= val;
 }
 
 bool sgct::SharedInt8::operator==(const int8_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal == val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) == val;
 }
 
 bool sgct::SharedInt8::operator!=(const int8_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal != val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) != val;
 }
 
 int8_t sgct::SharedInt8::operator+(const int8_t & val)
 {
-    int8_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal + val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<int8_t>(mVal.load(std::memory_order_acquire) + val);
 }
 
 int8_t sgct::SharedInt8::operator-(const int8_t & val)
 {
-    int8_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal - val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<int8_t>(mVal.load(std::memory_order_acquire) - val);
 }
 
 int8_t sgct::SharedInt8::operator*(const int8_t & val)
 {
-    int8_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal * val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<int8_t>(mVal.load(std::memory_order_acquire) * val);
 }
 
 int8_t sgct::SharedInt8::operator/(const int8_t & val)
 {
-    int8_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal / val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<int8_t>(mVal.load(std::memory_order_acquire) / val);
 }
 
 sgct::SharedUInt64::SharedUInt64()
+    : mVal(0)
 {
-    mVal = 0;
+    ;
 }
 
 sgct::SharedUInt64::SharedUInt64(uint64_t val)
+    : mVal(val)
 {
-    mVal = val;
+    ;
 }
 
-sgct::SharedUInt64::SharedUInt64(const SharedUInt64 & sf)
+sgct::SharedUInt64::SharedUInt64(const SharedUInt64 & si)
+    : mVal(si.mVal.load(std::memory_order_acquire))
 {
-    mVal = sf.mVal;
+    ;
 }
 
 uint64_t sgct::SharedUInt64::getVal()
 {
-    uint64_t tmpVal;
-
-    mMutex.lock();
-    tmpVal = mVal;
-    mMutex.unlock();
-
-    return tmpVal;
+    return mVal.load(std::memory_order_acquire);
 }
 
 void sgct::SharedUInt64::setVal(uint64_t val)
 {
-    mMutex.lock();
-    mVal = val;
-    mMutex.unlock();
+    mVal.store(val, std::memory_order_release);
 }
 
-void sgct::SharedUInt64::operator=(const SharedUInt64 & sf)
+void sgct::SharedUInt64::operator=(const SharedUInt64 & si)
 {
-    mMutex.lock();
-    mVal = sf.mVal;
-    mMutex.unlock();
+    mVal.store(si.mVal.load(std::memory_order_acquire), std::memory_order_release);
 }
 
 void sgct::SharedUInt64::operator=(const uint64_t & val)
 {
-    mMutex.lock();
-    mVal = val;
-    mMutex.unlock();
+    mVal.store(val, std::memory_order_release);
 }
 
 void sgct::SharedUInt64::operator+=(const uint64_t & val)
 {
-    mMutex.lock();
-    mVal += val;
-    mMutex.unlock();
+    mVal.fetch_add(val, std::memory_order_acq_rel);
 }
 
 void sgct::SharedUInt64::operator-=(const uint64_t & val)
 {
-    mMutex.lock();
-    mVal -= val;
-    mMutex.unlock();
+    mVal.fetch_sub(val, std::memory_order_acq_rel);
 }
 
 void sgct::SharedUInt64::operator*=(const uint64_t & val)
 {
-    mMutex.lock();
-    mVal *= val;
-    mMutex.unlock();
+    atomicMultiply(mVal, val);
 }
 
 void sgct::SharedUInt64::operator/=(const uint64_t & val)
 {
-    mMutex.lock();
-    mVal /= val;
-    mMutex.unlock();
+    atomicDivide(mVal, val);
 }
 
 void sgct::SharedUInt64::operator++(int)
 {
-    mMutex.lock();
-    mVal++;
-    mMutex.unlock();
+    mVal.fetch_add(1, std::memory_order_acq_rel);
 }
 
 void sgct::SharedUInt64::operator--(int)
 {
-    mMutex.lock();
-    mVal--;
-    mMutex.unlock();
+    mVal.fetch_sub(1, std::memory_order_acq_rel);
 }
 
 bool sgct::SharedUInt64::operator<(const uint64_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal < val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) < val;
 }
 
 bool sgct::SharedUInt64::operator<=(const uint64_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal <= val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) <= val;
 }
 
 bool sgct::SharedUInt64::operator>(const uint64_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal > val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) > val;
 }
 
 bool sgct::SharedUInt64::operator>=(const uint64_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal >= val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) >= val;
 }
 
 bool sgct::SharedUInt64::operator==(const uint64_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal == val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) == val;
 }
 
 bool sgct::SharedUInt64::operator!=(const uint64_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal != val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) != val;
 }
 
 uint64_t sgct::SharedUInt64::operator+(const uint64_t & val)
 {
-    uint64_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal + val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<uint64_t>(mVal.load(std::memory_order_acquire) + val);
 }
 
 uint64_t sgct::SharedUInt64::operator-(const uint64_t & val)
 {
-    uint64_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal - val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<uint64_t>(mVal.load(std::memory_order_acquire) - val);
 }
 
 uint64_t sgct::SharedUInt64::operator*(const uint64_t & val)
 {
-    uint64_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal * val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<uint64_t>(mVal.load(std::memory_order_acquire) * val);
 }
 
 uint64_t sgct::SharedUInt64::operator/(const uint64_t & val)
 {
-    uint64_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal / val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<uint64_t>(mVal.load(std::memory_order_acquire) / val);
 }
 
 sgct::SharedUInt32::SharedUInt32()
+    : mVal(0)
 {
-    mVal = 0;
+    ;
 }
 
 sgct::SharedUInt32::SharedUInt32(uint32_t val)
+    : mVal(val)
 {
-    mVal = val;
+    ;
 }
 
-sgct::SharedUInt32::SharedUInt32(const SharedUInt32 & sf)
+sgct::SharedUInt32::SharedUInt32(const SharedUInt32 & si)
+    : mVal(si.mVal.load(std::memory_order_acquire))
 {
-    mVal = sf.mVal;
+    ;
 }
 
 uint32_t sgct::SharedUInt32::getVal()
 {
-    uint32_t tmpVal;
-
-    mMutex.lock();
-    tmpVal = mVal;
-    mMutex.unlock();
-
-    return tmpVal;
+    return mVal.load(std::memory_order_acquire);
 }
 
 void sgct::SharedUInt32::setVal(uint32_t val)
 {
-    mMutex.lock();
-    mVal = val;
-    mMutex.unlock();
+    mVal.store(val, std::memory_order_release);
 }
 
-void sgct::SharedUInt32::operator=(const SharedUInt32 & sf)
+void sgct::SharedUInt32::operator=(const SharedUInt32 & si)
 {
-    mMutex.lock();
-    mVal = sf.mVal;
-    mMutex.unlock();
+    mVal.store(si.mVal.load(std::memory_order_acquire), std::memory_order_release);
 }
 
 void sgct::SharedUInt32::operator=(const uint32_t & val)
 {
-    mMutex.lock();
-    mVal = val;
-    mMutex.unlock();
+    mVal.store(val, std::memory_order_release);
 }
 
 void sgct::SharedUInt32::operator+=(const uint32_t & val)
 {
-    mMutex.lock();
-    mVal += val;
-    mMutex.unlock();
+    mVal.fetch_add(val, std::memory_order_acq_rel);
 }
 
 void sgct::SharedUInt32::operator-=(const uint32_t & val)
 {
-    mMutex.lock();
-    mVal -= val;
-    mMutex.unlock();
+    mVal.fetch_sub(val, std::memory_order_acq_rel);
 }
 
 void sgct::SharedUInt32::operator*=(const uint32_t & val)
 {
-    mMutex.lock();
-    mVal *= val;
-    mMutex.unlock();
+    atomicMultiply(mVal, val);
 }
 
 void sgct::SharedUInt32::operator/=(const uint32_t & val)
 {
-    mMutex.lock();
-    mVal /= val;
-    mMutex.unlock();
+    atomicDivide(mVal, val);
 }
 
 void sgct::SharedUInt32::operator++(int)
 {
-    mMutex.lock();
-    mVal++;
-    mMutex.unlock();
+    mVal.fetch_add(1, std::memory_order_acq_rel);
 }
 
 void sgct::SharedUInt32::operator--(int)
 {
-    mMutex.lock();
-    mVal--;
-    mMutex.unlock();
+    mVal.fetch_sub(1, std::memory_order_acq_rel);
 }
 
 bool sgct::SharedUInt32::operator<(const uint32_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal < val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) < val;
 }
 
 bool sgct::SharedUInt32::operator<=(const uint32_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal <= val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) <= val;
 }
 
 bool sgct::SharedUInt32::operator>(const uint32_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal > val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) > val;
 }
 
 bool sgct::SharedUInt32::operator>=(const uint32_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal >= val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) >= val;
 }
 
 bool sgct::SharedUInt32::operator==(const uint32_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal == val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) == val;
 }
 
 bool sgct::SharedUInt32::operator!=(const uint32_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal != val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) != val;
 }
 
 uint32_t sgct::SharedUInt32::operator+(const uint32_t & val)
 {
-    uint32_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal + val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<uint32_t>(mVal.load(std::memory_order_acquire) + val);
 }
 
 uint32_t sgct::SharedUInt32::operator-(const uint32_t & val)
 {
-    uint32_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal - val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<uint32_t>(mVal.load(std::memory_order_acquire) - val);
 }
 
 uint32_t sgct::SharedUInt32::operator*(const uint32_t & val)
 {
-    uint32_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal * val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<uint32_t>(mVal.load(std::memory_order_acquire) * val);
 }
 
 uint32_t sgct::SharedUInt32::operator/(const uint32_t & val)
 {
-    uint32_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal / val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<uint32_t>(mVal.load(std::memory_order_acquire) / val);
 }
 
 sgct::SharedUInt16::SharedUInt16()
+    : mVal(0)
 {
-    mVal = 0;
+    ;
 }
 
 sgct::SharedUInt16::SharedUInt16(uint16_t val)
+    : mVal(val)
 {
-    mVal = val;
+    ;
 }
 
-sgct::SharedUInt16::SharedUInt16(const SharedUInt16 & sf)
+sgct::SharedUInt16::SharedUInt16(const SharedUInt16 & si)
+    : mVal(si.mVal.load(std::memory_order_acquire))
 {
-    mVal = sf.mVal;
+    ;
 }
 
 uint16_t sgct::SharedUInt16::getVal()
 {
-    uint16_t tmpVal;
-
-    mMutex.lock();
-    tmpVal = mVal;
-    mMutex.unlock();
-
-    return tmpVal;
+    return mVal.load(std::memory_order_acquire);
 }
 
 void sgct::SharedUInt16::setVal(uint16_t val)
 {
-    mMutex.lock();
-    mVal = val;
-    mMutex.unlock();
+    mVal.store(val, std::memory_order_release);
 }
 
-void sgct::SharedUInt16::operator=(const SharedUInt16 & sf)
+void sgct::SharedUInt16::operator=(const SharedUInt16 & si)
 {
-    mMutex.lock();
-    mVal = sf.mVal;
-    mMutex.unlock();
+    mVal.store(si.mVal.load(std::memory_order_acquire), std::memory_order_release);
 }
 
 void sgct::SharedUInt16::operator=(const uint16_t & val)
 {
-    mMutex.lock();
-    mVal = val;
-    mMutex.unlock();
+    mVal.store(val, std::memory_order_release);
 }
 
 void sgct::SharedUInt16::operator+=(const uint16_t & val)
 {
-    mMutex.lock();
-    mVal += val;
-    mMutex.unlock();
+    mVal.fetch_add(val, std::memory_order_acq_rel);
 }
 
 void sgct::SharedUInt16::operator-=(const uint16_t & val)
 {
-    mMutex.lock();
-    mVal -= val;
-    mMutex.unlock();
+    mVal.fetch_sub(val, std::memory_order_acq_rel);
 }
 
 void sgct::SharedUInt16::operator*=(const uint16_t & val)
 {
-    mMutex.lock();
-    mVal *= val;
-    mMutex.unlock();
+    atomicMultiply(mVal, val);
 }
 
 void sgct::SharedUInt16::operator/=(const uint16_t & val)
 {
-    mMutex.lock();
-    mVal /= val;
-    mMutex.unlock();
+    atomicDivide(mVal, val);
 }
 
 void sgct::SharedUInt16::operator++(int)
 {
-    mMutex.lock();
-    mVal++;
-    mMutex.unlock();
+    mVal.fetch_add(1, std::memory_order_acq_rel);
 }
 
 void sgct::SharedUInt16::operator--(int)
 {
-    mMutex.lock();
-    mVal--;
-    mMutex.unlock();
+    mVal.fetch_sub(1, std::memory_order_acq_rel);
 }
 
 bool sgct::SharedUInt16::operator<(const uint16_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal < val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) < val;
 }
 
 bool sgct::SharedUInt16::operator<=(const uint16_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal <= val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) <= val;
 }
 
 bool sgct::SharedUInt16::operator>(const uint16_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal > val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) > val;
 }
 
 bool sgct::SharedUInt16::operator>=(const uint16_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal >= val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) >= val;
 }
 
 bool sgct::SharedUInt16::operator==(const uint16_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal == val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) == val;
 }
 
 bool sgct::SharedUInt16::operator!=(const uint16_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal != val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) != val;
 }
 
 uint16_t sgct::SharedUInt16::operator+(const uint16_t & val)
 {
-    uint16_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal + val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<uint16_t>(mVal.load(std::memory_order_acquire) + val);
 }
 
 uint16_t sgct::SharedUInt16::operator-(const uint16_t & val)
 {
-    uint16_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal - val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<uint16_t>(mVal.load(std::memory_order_acquire) - val);
 }
 
 uint16_t sgct::SharedUInt16::operator*(const uint16_t & val)
 {
-    uint16_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal * val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<uint16_t>(mVal.load(std::memory_order_acquire) * val);
 }
 
 uint16_t sgct::SharedUInt16::operator/(const uint16_t & val)
 {
-    uint16_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal / val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<uint16_t>(mVal.load(std::memory_order_acquire) / val);
 }
 
 sgct::SharedUInt8::SharedUInt8()
+    : mVal(0)
 {
-    mVal = 0;
+    ;
 }
 
 sgct::SharedUInt8::SharedUInt8(uint8_t val)
+    : mVal(val)
 {
-    mVal = val;
+    ;
 }
 
-sgct::SharedUInt8::SharedUInt8(const SharedUInt8 & sf)
+sgct::SharedUInt8::SharedUInt8(const SharedUInt8 & si)
+    : mVal(si.mVal.load(std::memory_order_acquire))
 {
-    mVal = sf.mVal;
+    ;
 }
 
 uint8_t sgct::SharedUInt8::getVal()
 {
-    uint8_t tmpVal;
-
-    mMutex.lock();
-    tmpVal = mVal;
-    mMutex.unlock();
-
-    return tmpVal;
+    return mVal.load(std::memory_order_acquire);
 }
 
 void sgct::SharedUInt8::setVal(uint8_t val)
 {
-    mMutex.lock();
-    mVal = val;
-    mMutex.unlock();
+    mVal.store(val, std::memory_order_release);
 }
 
-void sgct::SharedUInt8::operator=(const SharedUInt8 & sf)
+void sgct::SharedUInt8::operator=(const SharedUInt8 & si)
 {
-    mMutex.lock();
-    mVal = sf.mVal;
-    mMutex.unlock();
+    mVal.store(si.mVal.load(std::memory_order_acquire), std::memory_order_release);
 }
 
 void sgct::SharedUInt8::operator=(const uint8_t & val)
 {
-    mMutex.lock();
-    mVal = val;
-    mMutex.unlock();
+    mVal.store(val, std::memory_order_release);
 }
 
 void sgct::SharedUInt8::operator+=(const uint8_t & val)
 {
-    mMutex.lock();
-    mVal += val;
-    mMutex.unlock();
+    mVal.fetch_add(val, std::memory_order_acq_rel);
 }
 
 void sgct::SharedUInt8::operator-=(const uint8_t & val)
 {
-    mMutex.lock();
-    mVal -= val;
-    mMutex.unlock();
+    mVal.fetch_sub(val, std::memory_order_acq_rel);
 }
 
 void sgct::SharedUInt8::operator*=(const uint8_t & val)
 {
-    mMutex.lock();
-    mVal *= val;
-    mMutex.unlock();
+    atomicMultiply(mVal, val);
 }
 
 void sgct::SharedUInt8::operator/=(const uint8_t & val)
 {
-    mMutex.lock();
-    mVal /= val;
-    mMutex.unlock();
+    atomicDivide(mVal, val);
 }
 
 void sgct::SharedUInt8::operator++(int)
 {
-    mMutex.lock();
-    mVal++;
-    mMutex.unlock();
+    mVal.fetch_add(1, std::memory_order_acq_rel);
 }
 
 void sgct::SharedUInt8::operator--(int)
 {
-    mMutex.lock();
-    mVal--;
-    mMutex.unlock();
+    mVal.fetch_sub(1, std::memory_order_acq_rel);
 }
 
 bool sgct::SharedUInt8::operator<(const uint8_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal < val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) < val;
 }
 
 bool sgct::SharedUInt8::operator<=(const uint8_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal <= val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) <= val;
 }
 
 bool sgct::SharedUInt8::operator>(const uint8_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal > val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) > val;
 }
 
 bool sgct::SharedUInt8::operator>=(const uint8_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal >= val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) >= val;
 }
 
 bool sgct::SharedUInt8::operator==(const uint8_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal == val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) == val;
 }
 
 bool sgct::SharedUInt8::operator!=(const uint8_t & val)
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal != val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) != val;
 }
 
 uint8_t sgct::SharedUInt8::operator+(const uint8_t & val)
 {
-    uint8_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal + val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<uint8_t>(mVal.load(std::memory_order_acquire) + val);
 }
 
 uint8_t sgct::SharedUInt8::operator-(const uint8_t & val)
 {
-    uint8_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal - val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<uint8_t>(mVal.load(std::memory_order_acquire) - val);
 }
 
 uint8_t sgct::SharedUInt8::operator*(const uint8_t & val)
 {
-    uint8_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal * val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<uint8_t>(mVal.load(std::memory_order_acquire) * val);
 }
 
 uint8_t sgct::SharedUInt8::operator/(const uint8_t & val)
 {
-    uint8_t tmpI;
-    mMutex.lock();
-    tmpI = (mVal / val);
-    mMutex.unlock();
-    return tmpI;
+    return static_cast<uint8_t>(mVal.load(std::memory_order_acquire) / val);
 }
 
 sgct::SharedUChar::SharedUChar()
+    : mVal(0)
 {
-    mVal = 0;
+    ;
 }
 
 sgct::SharedUChar::SharedUChar(unsigned char val)
+    : mVal(val)
 {
-    mVal = val;
+    ;
 }
 
 unsigned char sgct::SharedUChar::getVal()
 {
-    unsigned char tmpVal;
-
-    mMutex.lock();
-    tmpVal = mVal;
-    mMutex.unlock();
-
-    return tmpVal;
+    return mVal.load(std::memory_order_acquire);
 }
 
 void sgct::SharedUChar::setVal(unsigned char val)
 {
-    mMutex.lock();
-    mVal = val;
-    mMutex.unlock();
+    mVal.store(val, std::memory_order_release);
 }
 
 sgct::SharedBool::SharedBool()
+    : mVal(false)
 {
-    mVal = false;
+    ;
 }
 
 sgct::SharedBool::SharedBool(bool val)
+    : mVal(val)
 {
-    mVal = val;
+    ;
 }
 
 sgct::SharedBool::SharedBool( const SharedBool & sd )
+    : mVal(sd.mVal.load(std::memory_order_acquire))
 {
-    mVal = sd.mVal;
+    ;
 }
 
 bool sgct::SharedBool::getVal()
 {
-    bool tmpVal;
-
-    mMutex.lock();
-    tmpVal = mVal;
-    mMutex.unlock();
-
-    return tmpVal;
+    return mVal.load(std::memory_order_acquire);
 }
 
 void sgct::SharedBool::setVal(bool val)
 {
-    mMutex.lock();
-    mVal = val;
-    mMutex.unlock();
+    mVal.store(val, std::memory_order_release);
 }
 
 void sgct::SharedBool::toggle()
 {
-    mMutex.lock();
-    mVal = !mVal;
-    mMutex.unlock();
+    bool expected = mVal.load(std::memory_order_relaxed);
+    while (!mVal.compare_exchange_weak(expected, !expected, std::memory_order_acq_rel, std::memory_order_relaxed))
+        ;
 }
 
 void sgct::SharedBool::operator=( const bool & val )
 {
-    mMutex.lock();
-    mVal = val;
-    mMutex.unlock();
+    mVal.store(val, std::memory_order_release);
 }
 
 void sgct::SharedBool::operator=(const SharedBool & sb)
 {
-    mMutex.lock();
-    mVal = sb.mVal;
-    mMutex.unlock();
+    mVal.store(sb.mVal.load(std::memory_order_acquire), std::memory_order_release);
 }
 
 bool sgct::SharedBool::operator==( const bool & val )
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal == val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) == val;
 }
 
 bool sgct::SharedBool::operator!=( const bool & val )
 {
-    bool tmpB;
-    mMutex.lock();
-    tmpB = (mVal != val);
-    mMutex.unlock();
-    return tmpB;
+    return mVal.load(std::memory_order_acquire) != val;
 }
 
 sgct::SharedString::SharedString()
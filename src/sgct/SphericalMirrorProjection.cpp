@@ -9,6 +9,7 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <sgct/SGCTSettings.h>
 #include <sgct/Engine.h>
 #include <sgct/MessageHandler.h>
+#include <sgct/FrameTrace.h>
 #include <sgct/shaders/SGCTInternalSphericalProjectionShaders.h>
 #include <sgct/shaders/SGCTInternalSphericalProjectionShaders_modern.h>
 #include <sgct/helpers/SGCTStringFunctions.h>
@@ -55,7 +56,19 @@ Render the enabled faces of the cubemap
 */
 void sgct_core::SphericalMirrorProjection::renderCubemap(std::size_t * subViewPortIndex)
 {
-    (this->*mInternalRenderCubemapFn)(subViewPortIndex);
+    if (mLayered)
+    {
+        renderLayeredCubemap(subViewPortIndex);
+        sgct_core::OffScreenBuffer::unBind();
+
+        //the mirror meshes sample separate face textures
+        for (std::size_t i = 0; i < 6; i++)
+            if (mSubViewports[i].isEnabled())
+                glCopyImageSubData(mTextures[CubeMapColor], GL_TEXTURE_CUBE_MAP, 0, 0, 0, static_cast<GLint>(i),
+                    mTextures[CubeFaceRight + i], GL_TEXTURE_2D, 0, 0, 0, 0, mCubemapResolution, mCubemapResolution, 1);
+    }
+    else
+        (this->*mInternalRenderCubemapFn)(subViewPortIndex);
 }
 
 /*!
@@ -108,12 +121,14 @@ void sgct_core::SphericalMirrorProjection::initTextures()
 
 void sgct_core::SphericalMirrorProjection::initVBO()
 {
-    if (Viewport * vp = dynamic_cast<Viewport*>(sgct::Engine::instance()->getCurrentWindowPtr()->getCurrentViewport()))
+    sgct::SGCTWindow * winPtr = sgct::Engine::instance()->getCurrentWindowPtr();
+    if (Viewport * vp = dynamic_cast<Viewport*>(winPtr->getCurrentViewport()))
     {
         for (int i = 0; i < LAST_MESH; i++)
             mMeshes[i].readAndGenerateMesh(
                 mMeshPaths[i],
-                vp);
+                vp,
+                winPtr->getAspectRatio());
     }
 }
 
@@ -240,6 +255,8 @@ void sgct_core::SphericalMirrorProjection::initShaders()
 
 void sgct_core::SphericalMirrorProjection::drawCubeFace(const std::size_t & face)
 {
+    sgct::FrameTrace::Scope scope("cubeFace", "face", static_cast<int>(face));
+
     glLineWidth(1.0);
     sgct::Engine::instance()->getWireframe() ? glPolygonMode(GL_FRONT_AND_BACK, GL_LINE) : glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
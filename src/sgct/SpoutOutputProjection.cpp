@@ -9,6 +9,7 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <sgct/SGCTSettings.h>
 #include <sgct/Engine.h>
 #include <sgct/MessageHandler.h>
+#include <sgct/FrameTrace.h>
 #include <sgct/shaders/SGCTInternalFisheyeShaders.h>
 #include <sgct/shaders/SGCTInternalFisheyeShaders_modern.h>
 #include <sgct/shaders/SGCTInternalFisheyeShaders_cubic.h>
@@ -123,7 +124,24 @@ Render the enabled faces of the cubemap
 */
 void sgct_core::SpoutOutputProjection::renderCubemap(std::size_t * subViewPortIndex)
 {
-    (this->*mInternalRenderCubemapFn)(subViewPortIndex);
+    if (mLayered)
+    {
+        renderLayeredCubemap(subViewPortIndex);
+
+        if (spoutMappingType == Mapping::Cubemap)
+        {
+            mCubeMapFBO_Ptr->unBind();
+            for (std::size_t i = 0; i < 6; i++)
+                if (mSubViewports[i].isEnabled() && handle[i])
+                {
+                    glBindTexture(GL_TEXTURE_2D, 0);
+                    glCopyImageSubData(mTextures[CubeMapColor], GL_TEXTURE_CUBE_MAP, 0, 0, 0, static_cast<GLint>(i),
+                        spoutTexture[i], GL_TEXTURE_2D, 0, 0, 0, 0, spoutMappingWidth, spoutMappingHeight, 1);
+                }
+        }
+    }
+    else
+        (this->*mInternalRenderCubemapFn)(subViewPortIndex);
 }
 
 
@@ -336,6 +354,10 @@ void sgct_core::SpoutOutputProjection::initViewports()
 		mSubViewports[i].getProjectionPlane()->setCoordinate(sgct_core::SGCTProjectionPlane::LowerLeft, glm::vec3(rotMat * lowerLeft));
 		mSubViewports[i].getProjectionPlane()->setCoordinate(sgct_core::SGCTProjectionPlane::UpperLeft, glm::vec3(rotMat * upperLeft));
 		mSubViewports[i].getProjectionPlane()->setCoordinate(sgct_core::SGCTProjectionPlane::UpperRight, glm::vec3(rotMat * upperRight));
+
+		//faces without a spout channel are never rendered
+		if (!spoutEnabled[i])
+			mSubViewports[i].setEnabled(false);
 	}
 }
 
@@ -629,6 +651,8 @@ void sgct_core::SpoutOutputProjection::updateGeomerty(const float & width, const
 
 void sgct_core::SpoutOutputProjection::drawCubeFace(const std::size_t & face)
 {
+    sgct::FrameTrace::Scope scope("cubeFace", "face", static_cast<int>(face));
+
     glLineWidth(1.0);
     sgct::Engine::instance()->getWireframe() ? glPolygonMode(GL_FRONT_AND_BACK, GL_LINE) : glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
@@ -0,0 +1,94 @@
+/*************************************************************************
+Copyright (c) 2012-2015 Miroslav Andel
+All rights reserved.
+
+For conditions of distribution and use, see copyright notice in sgct.h
+*************************************************************************/
+
+#include <sgct/TextLayout.h>
+
+const unsigned int sgct_text::GlyphMetrics::NoPage;
+const unsigned int sgct_text::TextMesh::FloatsPerVertex;
+
+sgct_text::GlyphMetrics::GlyphMetrics()
+{
+    mDistToNextChar = 0.0f;
+    mPage = NoPage;
+}
+
+/*!
+\returns the width of a line in pixels, the advance of all characters except the last one plus the width of the last one
+*/
+float sgct_text::getLineWidth(const std::wstring & line, const GlyphLookup & lookup)
+{
+    if (line.empty())
+        return 0.0f;
+
+    float lineWidth = 0.0f;
+    for (std::size_t j = 0; j < line.length() - 1; ++j)
+        lineWidth += lookup(line[j])->mDistToNextChar;
+    lineWidth += lookup(line[line.length() - 1])->mSize.x;
+
+    return lineWidth;
+}
+
+/*!
+Builds two triangles per visible character. The first line starts at the origin and each following line
+is lineHeight pixels further down.
+*/
+void sgct_text::layoutText(const std::vector<std::wstring> & lines, TextAlignMode mode, float lineHeight, const GlyphLookup & lookup, TextMesh & mesh)
+{
+    std::vector< std::vector<float> > pages;
+
+    for (std::size_t i = 0; i < lines.size(); i++)
+    {
+        glm::vec2 offset(0.0f, -lineHeight * static_cast<float>(i));
+
+        if (mode == TOP_CENTER)
+            offset.x -= getLineWidth(lines[i], lookup) / 2.0f;
+        else if (mode == TOP_RIGHT)
+            offset.x -= getLineWidth(lines[i], lookup);
+
+        for (std::size_t j = 0; j < lines[i].length(); j++)
+        {
+            const GlyphMetrics * gm = lookup(lines[i][j]);
+
+            if (gm->mPage != GlyphMetrics::NoPage && gm->mSize.x > 0.0f && gm->mSize.y > 0.0f)
+            {
+                if (gm->mPage >= pages.size())
+                    pages.resize(gm->mPage + 1);
+
+                float x0 = offset.x + gm->mPos.x;
+                float y0 = offset.y + gm->mPos.y;
+                float x1 = x0 + gm->mSize.x;
+                float y1 = y0 + gm->mSize.y;
+
+                //the bitmap rows are stored from the top so the top of the quad uses the min t coordinate
+                const float quad[] = {
+                    gm->mTexCoordMin.x, gm->mTexCoordMin.y, x0, y1,
+                    gm->mTexCoordMin.x, gm->mTexCoordMax.y, x0, y0,
+                    gm->mTexCoordMax.x, gm->mTexCoordMin.y, x1, y1,
+                    gm->mTexCoordMax.x, gm->mTexCoordMin.y, x1, y1,
+                    gm->mTexCoordMin.x, gm->mTexCoordMax.y, x0, y0,
+                    gm->mTexCoordMax.x, gm->mTexCoordMax.y, x1, y0 };
+
+                pages[gm->mPage].insert(pages[gm->mPage].end(), quad, quad + 6 * TextMesh::FloatsPerVertex);
+            }
+
+            offset.x += gm->mDistToNextChar;
+        }
+    }
+
+    mesh.mVertices.clear();
+    mesh.mBatches.clear();
+    for (std::size_t p = 0; p < pages.size(); p++)
+        if (!pages[p].empty())
+        {
+            TextBatch batch;
+            batch.page = static_cast<unsigned int>(p);
+            batch.first = mesh.getNumberOfVertices();
+            batch.count = static_cast<unsigned int>(pages[p].size() / TextMesh::FloatsPerVertex);
+            mesh.mBatches.push_back(batch);
+            mesh.mVertices.insert(mesh.mVertices.end(), pages[p].begin(), pages[p].end());
+        }
+}
@@ -308,6 +308,48 @@ bool sgct::TextureManager::loadUnManagedTexture(unsigned int & texID, const std:
     return true;
 }
 
+/*!
+Load a unmanged texture from an already decoded image. Note that this type of textures doesn't auto destruct.
+\param texID the openGL texture id
+\param imgPtr pointer to image object
+\param interpolate set to true for using interpolation (bi-linear filtering)
+\param mipmapLevels is the number of mipmap levels that will be generated, setting this value to 1 or less disables mipmaps
+\return true if texture loaded successfully
+*/
+bool sgct::TextureManager::loadUnManagedTexture(unsigned int & texID, sgct_core::Image * imgPtr, bool interpolate, int mipmapLevels)
+{
+    if (!imgPtr)
+    {
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "TextureManager: Cannot create unmanaged texture from invalid image!\n");
+        return false;
+    }
+    
+    unsigned int tmpTexID = GL_FALSE;
+    mInterpolate = interpolate;
+    mMipmapLevels = mipmapLevels;
+
+    if (texID != GL_FALSE)
+    {
+        glDeleteTextures(1, &texID);
+        texID = GL_FALSE;
+    }
+
+    if (imgPtr->getData() != NULL)
+    {
+        if (!uploadImage(imgPtr, &tmpTexID))
+            return false;
+
+        sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "TextureManager: Unmanaged texture created from image [id=%d]\n", tmpTexID);
+    }
+    else //image data not valid
+    {
+        return false;
+    }
+
+    texID = tmpTexID;
+    return true;
+}
+
 /*!
 returns true if texture will be uploaded
 */
@@ -14,6 +14,10 @@ For conditions of distribution and use, see copyright notice in sgct.h
 #include <sgct/FisheyeProjection.h>
 #include <sgct/SphericalMirrorProjection.h>
 #include <sgct/SpoutOutputProjection.h>
+#include <sgct/Image.h>
+#include <sgct/MaskCombiner.h>
+#include <sgct/SGCTSettings.h>
+#include <sgct/Engine.h>
 //#include <glm/gtc/matrix_transform.hpp>
 
 
@@ -52,6 +56,14 @@ sgct_core::Viewport::~Viewport()
     if (mBlackLevelMaskTextureIndex)
         glDeleteTextures(1, &mBlackLevelMaskTextureIndex);
 
+    if (mCombinedMaskTextureIndex)
+        glDeleteTextures(1, &mCombinedMaskTextureIndex);
+
+    delete mOverlayImage;
+    delete mBlendMaskImage;
+    delete mBlackLevelMaskImage;
+    delete mCombinedMaskImage;
+
     delete mMpcdiWarpMeshData;
 }
 
@@ -153,6 +165,53 @@ void sgct_core::Viewport::configure(tinyxml2::XMLElement * element)
     }
 }
 
+/*!
+Applies the planar projection and projection plane of a viewport element to an existing viewport.
+Changes to the position or size are rejected with a warning since the correction mesh and the mask geometry are
+built from them when the window is initialized. Textures, correction meshes and non linear projections are not reloaded.
+*/
+void sgct_core::Viewport::reconfigure(tinyxml2::XMLElement * element)
+{
+    if (element->Attribute("tracked") != NULL)
+        setTracked(strcmp(element->Attribute("tracked"), "true") == 0 ? true : false);
+
+    const char * val;
+    tinyxml2::XMLElement * subElement = element->FirstChildElement();
+    while (subElement != NULL)
+    {
+        val = subElement->Value();
+        float fTmp[2];
+
+        if (strcmp("Pos", val) == 0)
+        {
+            if (subElement->QueryFloatAttribute("x", &fTmp[0]) == tinyxml2::XML_NO_ERROR &&
+                subElement->QueryFloatAttribute("y", &fTmp[1]) == tinyxml2::XML_NO_ERROR &&
+                (fTmp[0] != getX() || fTmp[1] != getY()))
+                sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING,
+                    "Viewport: The position of viewport '%s' can't be reloaded, restart to apply it.\n", mName.c_str());
+        }
+        else if (strcmp("Size", val) == 0)
+        {
+            if (subElement->QueryFloatAttribute("x", &fTmp[0]) == tinyxml2::XML_NO_ERROR &&
+                subElement->QueryFloatAttribute("y", &fTmp[1]) == tinyxml2::XML_NO_ERROR &&
+                (fTmp[0] != getXSize() || fTmp[1] != getYSize()))
+                sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_WARNING,
+                    "Viewport: The size of viewport '%s' can't be reloaded, restart to apply it.\n", mName.c_str());
+        }
+        else if (strcmp("PlanarProjection", val) == 0 && !hasSubViewports())
+        {
+            parsePlanarProjection(subElement);
+        }
+        else if ((strcmp("Viewplane", val) == 0 || strcmp("Projectionplane", val) == 0) && !hasSubViewports())
+        {
+            mProjectionPlane.configure(subElement, mUnTransformedViewPlaneCoords);
+        }
+
+        //iterate
+        subElement = subElement->NextSiblingElement();
+    }
+}
+
 void sgct_core::Viewport::parseFloatFromAttribute(tinyxml2::XMLElement* element,
                                                   const std::string tag,
                                                   float& target)
@@ -307,6 +366,14 @@ void sgct_core::Viewport::reset(float x, float y, float xSize, float ySize)
     mOverlayTextureIndex = GL_FALSE;
     mBlendMaskTextureIndex = GL_FALSE;
     mBlackLevelMaskTextureIndex = GL_FALSE;
+    mCombinedMaskTextureIndex = GL_FALSE;
+    mOverlayImage = NULL;
+    mBlendMaskImage = NULL;
+    mBlackLevelMaskImage = NULL;
+    mCombinedMaskImage = NULL;
+    mCPUDataLoaded = false;
+    mImageLoadTime = 0.0;
+    mMeshLoadTime = 0.0;
     mTracked = false;
     mEnabled = true;
     mName.assign("NoName");
@@ -413,6 +480,9 @@ void sgct_core::Viewport::parseFisheyeProjection(tinyxml2::XMLElement * element)
         fishProj->setInterpolationMode(
             strcmp(element->Attribute("interpolation"), "cubic") == 0 ? NonLinearProjection::Cubic : NonLinearProjection::Linear);
 
+    if (element->Attribute("adaptiveFaces") != NULL)
+        fishProj->setUseAdaptiveFaces(strcmp(element->Attribute("adaptiveFaces"), "true") == 0);
+
     float tilt;
     if (element->QueryFloatAttribute("tilt", &tilt) == tinyxml2::XML_NO_ERROR)
     {
@@ -695,28 +765,93 @@ void sgct_core::Viewport::setTracked(bool state)
     mTracked = state;
 }
 
-void sgct_core::Viewport::loadData()
+/*!
+Decodes the overlay and mask images and parses the correction mesh. No OpenGL calls are made so this
+function can be called from a worker thread for several viewports in parallel. The data is uploaded to the GPU by loadData.
+
+@param windowAspectRatio the aspect ratio of the window that this viewport belongs to
+*/
+void sgct_core::Viewport::loadCPUData(float windowAspectRatio)
 {
-    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Viewport: loading GPU data for '%s'\n", mName.c_str());
-        
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Viewport: loading CPU data for '%s'\n", mName.c_str());
+
+    double t0 = sgct::Engine::getTime();
+
     if( mOverlayFilename.size() > 0 )
-        sgct::TextureManager::instance()->loadUnManagedTexture(mOverlayTextureIndex, mOverlayFilename, true, 1);
+        mOverlayImage = loadImage(mOverlayFilename);
 
     if ( mBlendMaskFilename.size() > 0 )
-        sgct::TextureManager::instance()->loadUnManagedTexture(mBlendMaskTextureIndex, mBlendMaskFilename, true, 1);
+        mBlendMaskImage = loadImage(mBlendMaskFilename);
 
     if ( mBlackLevelMaskFilename.size() > 0)
-        sgct::TextureManager::instance()->loadUnManagedTexture(mBlackLevelMaskTextureIndex, mBlackLevelMaskFilename, true, 1);
+        mBlackLevelMaskImage = loadImage(mBlackLevelMaskFilename);
+
+    if (sgct::SGCTSettings::instance()->getUseSinglePassCompositor() && (mBlendMaskImage != NULL || mBlackLevelMaskImage != NULL))
+        mCombinedMaskImage = MaskCombiner::combine(mBlendMaskImage, mBlackLevelMaskImage);
+
+    double t1 = sgct::Engine::getTime();
 
     if ( mMpcdiWarpMeshData != nullptr )
     {
-        mCorrectionMesh = mCM.readAndGenerateMesh("mesh.mpcdi", this, CorrectionMesh::parseHint("mpcdi"));
+        mCorrectionMesh = mCM.readMesh("mesh.mpcdi", this, windowAspectRatio, CorrectionMesh::parseHint("mpcdi"));
     }
     else
     {
         //load default if mMeshFilename is empty
-        mCorrectionMesh = mCM.readAndGenerateMesh(mMeshFilename, this, CorrectionMesh::parseHint(mMeshHint));
+        mCorrectionMesh = mCM.readMesh(mMeshFilename, this, windowAspectRatio, CorrectionMesh::parseHint(mMeshHint));
     }
+
+    double t2 = sgct::Engine::getTime();
+    mImageLoadTime = t1 - t0;
+    mMeshLoadTime = t2 - t1;
+    mCPUDataLoaded = true;
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Viewport: CPU data for '%s' loaded in %.2f ms (images: %.2f ms, mesh: %.2f ms)\n",
+        mName.c_str(), (t2 - t0) * 1000.0, mImageLoadTime * 1000.0, mMeshLoadTime * 1000.0);
+}
+
+/*!
+Uploads overlay and mask textures and the correction mesh to the GPU. Must be called with the window's context current.
+If loadCPUData hasn't been called in advance then the data is read here.
+
+@param windowAspectRatio the aspect ratio of the window that this viewport belongs to
+*/
+void sgct_core::Viewport::loadData(float windowAspectRatio)
+{
+    if (!mCPUDataLoaded)
+        loadCPUData(windowAspectRatio);
+
+    sgct::MessageHandler::instance()->print(sgct::MessageHandler::NOTIFY_DEBUG, "Viewport: loading GPU data for '%s'\n", mName.c_str());
+        
+    uploadImage(mOverlayTextureIndex, &mOverlayImage);
+    uploadImage(mBlendMaskTextureIndex, &mBlendMaskImage);
+    uploadImage(mBlackLevelMaskTextureIndex, &mBlackLevelMaskImage);
+    uploadImage(mCombinedMaskTextureIndex, &mCombinedMaskImage);
+
+    mCM.uploadMesh(this);
+    mCPUDataLoaded = false;
+}
+
+sgct_core::Image * sgct_core::Viewport::loadImage(const std::string & filename)
+{
+    Image * img = new Image();
+    if (!img->load(filename))
+    {
+        delete img;
+        return NULL;
+    }
+
+    return img;
+}
+
+void sgct_core::Viewport::uploadImage(unsigned int & texID, Image ** imgPtr)
+{
+    if (*imgPtr == NULL)
+        return;
+
+    sgct::TextureManager::instance()->loadUnManagedTexture(texID, *imgPtr, true, 1);
+    delete *imgPtr;
+    *imgPtr = NULL;
 }
 
 /*!
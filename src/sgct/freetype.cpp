@@ -167,36 +167,16 @@ wchar_t * parseArgList(va_list args, const wchar_t *format)
 	return buffer;
 }
 
-float getLineWidth(sgct_text::Font * ft_font, const std::wstring & line)
-{
-	FontFaceData * ffdPtr;
-	
-	//figure out width
-	float lineWidth = 0.0f;
-	for (size_t j = 0; j < line.length() - 1; ++j)
-	{
-		auto c = line.c_str()[j];
-		ffdPtr = ft_font->getFontFaceData(c);
-		lineWidth += ffdPtr->mDistToNextChar;
-	}
-	//add last char width
-	auto c = line.c_str()[line.length() - 1];
-	ffdPtr = ft_font->getFontFaceData(c);
-	lineWidth += ffdPtr->mSize.x;
-
-	return lineWidth;
-}
-
 void render2d(const std::vector<std::wstring> & lines, sgct_text::Font * ft_font, const TextAlignMode & mode, const float & x, const float & y, const glm::vec4 & color)
 {
-	FontFaceData * ffdPtr;
-	float h = ft_font->getHeight() * 1.59f;
-	
 	if (sgct::Engine::instance()->isOGLPipelineFixed())
 	{
 		glPushAttrib(GL_LIST_BIT | GL_CURRENT_BIT | GL_ENABLE_BIT | GL_TRANSFORM_BIT);
 		pushScreenCoordinateMatrix();
 		glMatrixMode(GL_MODELVIEW);
+		glPushMatrix();
+		glLoadIdentity();
+		glTranslatef(x, y, 0.0f);
 		glDisable(GL_LIGHTING);
 		glActiveTexture(GL_TEXTURE0); //Open Scene Graph or the user may have changed the active texture
 		glEnable(GL_TEXTURE_2D);
@@ -208,53 +188,21 @@ void render2d(const std::vector<std::wstring> & lines, sgct_text::Font * ft_font
 		glUniform4f(FontManager::instance()->getColLoc(), color.r, color.g, color.b, color.a);
 		glm::vec4 strokeColor = FontManager::instance()->getStrokeColor();
 		glUniform4f(FontManager::instance()->getStkLoc(), strokeColor.r, strokeColor.g, strokeColor.b, strokeColor.a);
+		glUniform1i(FontManager::instance()->getTexLoc(), 0);
 
-		for (size_t i = 0; i<lines.size(); ++i)
-		{
-			glm::vec3 offset(x, y - h*static_cast<float>(i), 0.0f);
-			
-			if (mode == TOP_CENTER)
-				offset.x -= getLineWidth(ft_font, lines[i]) / 2.0f;
-			else if(mode == TOP_RIGHT)
-				offset.x -= getLineWidth(ft_font, lines[i]);
-
-			for (size_t j = 0; j < lines[i].length(); ++j)
-			{
-				auto c = lines[i].c_str()[j];
-				ffdPtr = ft_font->getFontFaceData(c);
-
-				glPushMatrix();
-				glLoadIdentity();
-				glTranslatef(offset.x + ffdPtr->mPos.x, offset.y + ffdPtr->mPos.y, offset.z);
-				glScalef(ffdPtr->mSize.x, ffdPtr->mSize.y, 1.0f);
-
-				glBindTexture(GL_TEXTURE_2D, ffdPtr->mTexId);
-				//disable interpolation for 2D rendering
-				if (ffdPtr->mInterpolated)
-				{
-					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-					ffdPtr->mInterpolated = false;
-				}
-				glUniform1i(FontManager::instance()->getTexLoc(), 0);
-
-				glCallList(ft_font->getDisplayList());
-				glPopMatrix();
-
-				//iterate
-				offset += glm::vec3(ffdPtr->mDistToNextChar, 0.0f, 0.0f);
-			}
-		}
+		//disable interpolation for 2D rendering
+		ft_font->drawText(lines, mode, false);
 
 		sgct::ShaderProgram::unbind();
 
+		glPopMatrix();
 		pop_projection_matrix();
 		glPopAttrib();
 	}
 	else
 	{
 		setupViewport();
-		glm::mat4 projectionMat(setupOrthoMat());
+		glm::mat4 mvp = glm::translate(setupOrthoMat(), glm::vec3(x, y, 0.0f));
 
 		glDisable(GL_DEPTH_TEST);
 		glEnable(GL_BLEND);
@@ -262,63 +210,24 @@ void render2d(const std::vector<std::wstring> & lines, sgct_text::Font * ft_font
 
 		FontManager::instance()->getShader().bind();
 
-		glBindVertexArray(ft_font->getVAO());
-
-		glActiveTexture(GL_TEXTURE0);
-
 		glUniform4f(FontManager::instance()->getColLoc(), color.r, color.g, color.b, color.a);
 		glm::vec4 strokeColor = FontManager::instance()->getStrokeColor();
 		glUniform4f(FontManager::instance()->getStkLoc(), strokeColor.r, strokeColor.g, strokeColor.b, strokeColor.a);
+		glUniform1i(FontManager::instance()->getTexLoc(), 0);
+		glUniformMatrix4fv(FontManager::instance()->getMVPLoc(), 1, GL_FALSE, &mvp[0][0]);
+
+		//disable interpolation for 2D rendering
+		ft_font->drawText(lines, mode, false);
 
-		for (size_t i = 0; i<lines.size(); i++)
-		{
-			glm::vec3 offset(x, y - h*static_cast<float>(i), 0.0f);
-			glm::mat4 trans;
-			glm::mat4 scale;
-
-			if (mode == TOP_CENTER)
-				offset.x -= getLineWidth(ft_font, lines[i]) / 2.0f;
-			else if (mode == TOP_RIGHT)
-				offset.x -= getLineWidth(ft_font, lines[i]);
-
-			for (size_t j = 0; j < lines[i].length(); j++)
-			{
-				auto c = lines[i].c_str()[j];
-				ffdPtr = ft_font->getFontFaceData(c);
-
-				trans = glm::translate(projectionMat, glm::vec3(offset.x + ffdPtr->mPos.x, offset.y + ffdPtr->mPos.y, offset.z));
-				scale = glm::scale(trans, glm::vec3(ffdPtr->mSize.x, ffdPtr->mSize.y, 1.0f));
-
-				glBindTexture(GL_TEXTURE_2D, ffdPtr->mTexId);
-				//disable interpolation for 2D rendering
-				if (ffdPtr->mInterpolated)
-				{
-					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-					ffdPtr->mInterpolated = false;
-				}
-				glUniform1i(FontManager::instance()->getTexLoc(), 0);
-
-				glUniformMatrix4fv(FontManager::instance()->getMVPLoc(), 1, GL_FALSE, &scale[0][0]);
-
-				glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-				//iterate
-				offset += glm::vec3(ffdPtr->mDistToNextChar, 0.0f, 0.0f);
-			}//end for chars
-		}//end for lines
-
-		 //unbind
-		glBindVertexArray(0);
 		sgct::ShaderProgram::unbind();
 	}
 }
 
 void render3d(const std::vector<std::wstring> & lines, sgct_text::Font * ft_font, const TextAlignMode & mode, const glm::mat4 & mvp, const glm::vec4 & color)
 {
-	FontFaceData * ffdPtr;
-	float h = ft_font->getHeight() * 1.59f;
-	
+	float textScale = 1.0f / ft_font->getHeight();
+	glm::mat4 textScaleMat = glm::scale(mvp, glm::vec3(textScale));
+
 	if (sgct::Engine::instance()->isOGLPipelineFixed())
 	{
 		glPushAttrib(GL_LIST_BIT | GL_CURRENT_BIT | GL_ENABLE_BIT | GL_TRANSFORM_BIT);
@@ -329,9 +238,6 @@ void render3d(const std::vector<std::wstring> & lines, sgct_text::Font * ft_font
 		glActiveTexture(GL_TEXTURE0);
 		glEnable(GL_TEXTURE_2D);
 
-		float textScale = 1.0f / ft_font->getHeight();
-		glm::mat4 textScaleMat = glm::scale(mvp, glm::vec3(textScale));
-
 		//clear sgct projection
 		glMatrixMode(GL_PROJECTION);
 		glPushMatrix();
@@ -339,49 +245,16 @@ void render3d(const std::vector<std::wstring> & lines, sgct_text::Font * ft_font
 
 		glMatrixMode(GL_MODELVIEW);
 		glPushMatrix();
+		glLoadMatrixf( glm::value_ptr(textScaleMat) );
 
 		FontManager::instance()->getShader().bind();
 		glUniform4f(FontManager::instance()->getColLoc(), color.r, color.g, color.b, color.a);
 		glm::vec4 strokeColor = FontManager::instance()->getStrokeColor();
 		glUniform4f(FontManager::instance()->getStkLoc(), strokeColor.r, strokeColor.g, strokeColor.b, strokeColor.a);
+		glUniform1i( FontManager::instance()->getTexLoc(), 0);
 
-		for (size_t i = 0; i<lines.size(); i++)
-		{
-			glm::vec3 offset(0.0f, -h*static_cast<float>(i), 0.0f);
-			glm::mat4 trans;
-			glm::mat4 scale;
-
-			if (mode == TOP_CENTER)
-				offset.x -= getLineWidth(ft_font, lines[i]) / 2.0f;
-			else if (mode == TOP_RIGHT)
-				offset.x -= getLineWidth(ft_font, lines[i]);
-			
-			for (size_t j = 0; j < lines[i].length(); j++)
-			{
-				auto c = lines[i].c_str()[j];
-				ffdPtr = ft_font->getFontFaceData(c);
-
-				trans = glm::translate(textScaleMat, glm::vec3(offset.x + ffdPtr->mPos.x, offset.y + ffdPtr->mPos.y, offset.z));
-				scale = glm::scale(trans, glm::vec3(ffdPtr->mSize.x, ffdPtr->mSize.y, 1.0f));
-
-				glLoadMatrixf( glm::value_ptr(scale) );
-
-				glBindTexture(GL_TEXTURE_2D, ffdPtr->mTexId);
-				//use linear interpolation in 3D
-				if (!ffdPtr->mInterpolated)
-				{
-					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-					ffdPtr->mInterpolated = true;
-				}
-
-				glUniform1i( FontManager::instance()->getTexLoc(), 0);
-				glCallList(ft_font->getDisplayList());
-
-				//iterate
-				offset += glm::vec3(ffdPtr->mDistToNextChar, 0.0f, 0.0f);
-			}
-		}
+		//use linear interpolation in 3D
+		ft_font->drawText(lines, mode, true);
 
 		sgct::ShaderProgram::unbind();
 		glPopMatrix();
@@ -396,56 +269,15 @@ void render3d(const std::vector<std::wstring> & lines, sgct_text::Font * ft_font
 
 		FontManager::instance()->getShader().bind();
 
-		glBindVertexArray(ft_font->getVAO());
-		glActiveTexture(GL_TEXTURE0);
-
 		glUniform4f(FontManager::instance()->getColLoc(), color.r, color.g, color.b, color.a);
 		glm::vec4 strokeColor = FontManager::instance()->getStrokeColor();
 		glUniform4f(FontManager::instance()->getStkLoc(), strokeColor.r, strokeColor.g, strokeColor.b, strokeColor.a);
+		glUniform1i( FontManager::instance()->getTexLoc(), 0);
+		glUniformMatrix4fv( FontManager::instance()->getMVPLoc(), 1, GL_FALSE, &textScaleMat[0][0]);
+
+		//use linear interpolation in 3D
+		ft_font->drawText(lines, mode, true);
 
-		float textScale = 1.0f / ft_font->getHeight();
-		glm::mat4 textScaleMat = glm::scale(mvp, glm::vec3(textScale));
-
-		for (size_t i = 0; i<lines.size(); i++)
-		{
-			glm::vec3 offset(0.0f, -h*static_cast<float>(i), 0.0f);
-			glm::mat4 trans;
-			glm::mat4 scale;
-
-			if (mode == TOP_CENTER)
-				offset.x -= getLineWidth(ft_font, lines[i]) / 2.0f;
-			else if (mode == TOP_RIGHT)
-				offset.x -= getLineWidth(ft_font, lines[i]);
-
-			for (size_t j = 0; j < lines[i].length(); j++)
-			{
-				auto c = lines[i].c_str()[j];
-				ffdPtr = ft_font->getFontFaceData(c);
-
-				trans = glm::translate(textScaleMat, glm::vec3(offset.x + ffdPtr->mPos.x, offset.y + ffdPtr->mPos.y, offset.z));
-				scale = glm::scale(trans, glm::vec3(ffdPtr->mSize.x, ffdPtr->mSize.y, 1.0f));
-
-				glBindTexture(GL_TEXTURE_2D, ffdPtr->mTexId);
-				//use linear interpolation in 3D
-				if (!ffdPtr->mInterpolated)
-				{
-					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-					ffdPtr->mInterpolated = true;
-				}
-
-				glUniform1i( FontManager::instance()->getTexLoc(), 0);
-				glUniformMatrix4fv( FontManager::instance()->getMVPLoc(), 1, GL_FALSE, &scale[0][0]);
-				
-				glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-				//iterate
-				offset += glm::vec3(ffdPtr->mDistToNextChar, 0.0f, 0.0f);
-			}//end for chars
-		}//end for lines
-
-		 //unbind
-		glBindVertexArray(0);
 		sgct::ShaderProgram::unbind();
 	}
 }